@@ -0,0 +1,226 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkBufferAllocator_h
+#define __itkBufferAllocator_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+#include "itkMultiThreader.h"
+#include "itkSimpleFastMutexLock.h"
+#include <complex>
+
+namespace itk
+{
+/** \class BufferAllocator
+ * \brief Allocates the raw memory of image pixel buffers.
+ *
+ * BufferAllocator is the allocation policy used by ImportImageContainer
+ * (and therefore by Image::Allocate()) when one is set.  The default
+ * implementation returns buffers aligned to Alignment bytes (64 by
+ * default, a cache line and the widest SIMD register on current
+ * hardware).
+ *
+ * When FirstTouch is on, large buffers are touched once per page by
+ * MultiThreader::GetGlobalDefaultNumberOfThreads() threads right after
+ * allocation, thread i touching the i-th contiguous slab of the buffer.
+ * On systems with a first-touch NUMA page placement policy, this places
+ * each slab on the memory node of the thread that touched it, matching
+ * the way ImageSource splits the output region along its outermost axis
+ * for ThreadedGenerateData().
+ *
+ * Subclasses can override Allocate() and Deallocate() to use other
+ * memory sources (e.g. NUMA-interleaved or huge-page memory) or to
+ * recycle buffers, see PooledBufferAllocator.
+ *
+ * The allocator does not construct the elements; ImportImageContainer
+ * constructs them unless BufferElementTraits reports that the element
+ * type is trivially constructible.
+ *
+ * By default no allocator is set and ImportImageContainer uses new[]
+ * and delete[].  A process-wide allocator is installed with
+ * SetGlobalDefault().
+ *
+ * \sa ImportImageContainer
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT BufferAllocator:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef BufferAllocator            Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(BufferAllocator, Object);
+
+  /** Set/Get the alignment in bytes of the allocated buffers.  Must be a
+   * power of two.  Defaults to 64. */
+  itkSetMacro(Alignment, SizeValueType);
+  itkGetConstMacro(Alignment, SizeValueType);
+
+  /** Set/Get whether large buffers are first touched in parallel.
+   * Defaults to on. */
+  itkSetMacro(FirstTouch, bool);
+  itkGetConstMacro(FirstTouch, bool);
+  itkBooleanMacro(FirstTouch);
+
+  /** Allocate numberOfBytes bytes of uninitialized memory.  Throws a
+   * MemoryAllocationError on failure. */
+  virtual void * Allocate(SizeValueType numberOfBytes);
+
+  /** Release memory returned by Allocate().  numberOfBytes is the size
+   * that was passed to Allocate(). */
+  virtual void Deallocate(void *buffer, SizeValueType numberOfBytes);
+
+  /** Set/Get the allocator used by newly created ImportImageContainer
+   * objects.  NULL (the default) selects new[] and delete[]. */
+  static void SetGlobalDefault(BufferAllocator *allocator);
+
+  static BufferAllocator * GetGlobalDefault();
+
+protected:
+  BufferAllocator();
+  ~BufferAllocator() {}
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+  /** Touch one byte per page of the buffer, the i-th slab from the i-th
+   * thread.  The threader is created on first use and reused; concurrent
+   * first touches through the same allocator are serialized. */
+  void FirstTouchBuffer(void *buffer, SizeValueType numberOfBytes);
+
+private:
+  BufferAllocator(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  static ITK_THREAD_RETURN_TYPE FirstTouchCallback(void *arg);
+
+  SizeValueType m_Alignment;
+  bool          m_FirstTouch;
+
+  MultiThreader::Pointer m_FirstTouchThreader;
+  SimpleFastMutexLock    m_FirstTouchLock;
+
+  static Pointer m_GlobalDefault;
+};
+
+template< typename TValueType, unsigned int VLength > class FixedArray;
+template< typename T, unsigned int NVectorDimension > class Vector;
+template< typename T, unsigned int NVectorDimension > class CovariantVector;
+template< typename TCoordRep, unsigned int NPointDimension > class Point;
+template< typename TComponent > class RGBPixel;
+template< typename TComponent > class RGBAPixel;
+template< typename TComponent, unsigned int NDimension > class SymmetricSecondRankTensor;
+template< typename TComponent > class DiffusionTensor3D;
+
+/** \class BufferElementTraits
+ * \brief Tells whether the elements of a pixel buffer need to be
+ * constructed and destroyed.
+ *
+ * IsTriviallyConstructible is true for types that hold no resources and
+ * whose constructor at most zeroes the value, so that a buffer of them
+ * can be used without running constructors or destructors.  The
+ * fundamental types and the fixed size ITK pixel types built on them are
+ * marked as such; all other types default to false.
+ *
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+template< typename T >
+struct BufferElementTraits {
+  itkStaticConstMacro(IsTriviallyConstructible, bool, false);
+};
+
+#define itkBufferElementTraitsTrivialMacro(T)                  \
+  template< >                                                  \
+  struct BufferElementTraits< T > {                            \
+    itkStaticConstMacro(IsTriviallyConstructible, bool, true); \
+  }
+
+itkBufferElementTraitsTrivialMacro(bool);
+itkBufferElementTraitsTrivialMacro(char);
+itkBufferElementTraitsTrivialMacro(signed char);
+itkBufferElementTraitsTrivialMacro(unsigned char);
+itkBufferElementTraitsTrivialMacro(short);
+itkBufferElementTraitsTrivialMacro(unsigned short);
+itkBufferElementTraitsTrivialMacro(int);
+itkBufferElementTraitsTrivialMacro(unsigned int);
+itkBufferElementTraitsTrivialMacro(long);
+itkBufferElementTraitsTrivialMacro(unsigned long);
+itkBufferElementTraitsTrivialMacro(long long);
+itkBufferElementTraitsTrivialMacro(unsigned long long);
+itkBufferElementTraitsTrivialMacro(float);
+itkBufferElementTraitsTrivialMacro(double);
+itkBufferElementTraitsTrivialMacro(long double);
+
+#undef itkBufferElementTraitsTrivialMacro
+
+template< typename TComponent >
+struct BufferElementTraits< std::complex< TComponent > > {
+  itkStaticConstMacro(IsTriviallyConstructible, bool,
+                      BufferElementTraits< TComponent >::IsTriviallyConstructible);
+};
+template< typename TComponent >
+struct BufferElementTraits< RGBPixel< TComponent > > {
+  itkStaticConstMacro(IsTriviallyConstructible, bool,
+                      BufferElementTraits< TComponent >::IsTriviallyConstructible);
+};
+template< typename TComponent >
+struct BufferElementTraits< RGBAPixel< TComponent > > {
+  itkStaticConstMacro(IsTriviallyConstructible, bool,
+                      BufferElementTraits< TComponent >::IsTriviallyConstructible);
+};
+template< typename TComponent >
+struct BufferElementTraits< DiffusionTensor3D< TComponent > > {
+  itkStaticConstMacro(IsTriviallyConstructible, bool,
+                      BufferElementTraits< TComponent >::IsTriviallyConstructible);
+};
+template< typename TComponent, unsigned int VLength >
+struct BufferElementTraits< FixedArray< TComponent, VLength > > {
+  itkStaticConstMacro(IsTriviallyConstructible, bool,
+                      BufferElementTraits< TComponent >::IsTriviallyConstructible);
+};
+template< typename TComponent, unsigned int VLength >
+struct BufferElementTraits< Vector< TComponent, VLength > > {
+  itkStaticConstMacro(IsTriviallyConstructible, bool,
+                      BufferElementTraits< TComponent >::IsTriviallyConstructible);
+};
+template< typename TComponent, unsigned int VLength >
+struct BufferElementTraits< CovariantVector< TComponent, VLength > > {
+  itkStaticConstMacro(IsTriviallyConstructible, bool,
+                      BufferElementTraits< TComponent >::IsTriviallyConstructible);
+};
+template< typename TComponent, unsigned int VLength >
+struct BufferElementTraits< Point< TComponent, VLength > > {
+  itkStaticConstMacro(IsTriviallyConstructible, bool,
+                      BufferElementTraits< TComponent >::IsTriviallyConstructible);
+};
+template< typename TComponent, unsigned int VLength >
+struct BufferElementTraits< SymmetricSecondRankTensor< TComponent, VLength > > {
+  itkStaticConstMacro(IsTriviallyConstructible, bool,
+                      BufferElementTraits< TComponent >::IsTriviallyConstructible);
+};
+} // end namespace itk
+
+#endif
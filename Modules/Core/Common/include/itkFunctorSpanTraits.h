@@ -0,0 +1,77 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkFunctorSpanTraits_h
+#define __itkFunctorSpanTraits_h
+
+#include "itkMacro.h"
+
+namespace itk
+{
+template< class TPixel, unsigned int VImageDimension > class Image;
+
+/** \class FunctorSpanTraits
+ * \brief Tells whether a pixel functor also processes runs of pixels.
+ *
+ * UnaryFunctorImageFilter and BinaryFunctorImageFilter process images
+ * whose pixels are stored contiguously scanline by scanline, calling the
+ * per-pixel operator of the functor in a loop over raw pointers that the
+ * compiler can vectorize.  A functor for which HasSpanOperator is true
+ * replaces that loop with its own operator over a whole scanline,
+ *
+ * \code
+ * void operator()(const TInput *in, TOutput *out, SizeValueType n) const;
+ * void operator()(const TInput1 *in1, const TInput2 *in2, TOutput *out,
+ *                 SizeValueType n) const;
+ * \endcode
+ *
+ * for unary and binary functors respectively.  It must give the same
+ * values as the per-pixel operator, and be safe when out is one of the
+ * inputs, for in-place filters.
+ *
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+template< typename TFunction >
+struct FunctorSpanTraits {
+  itkStaticConstMacro(HasSpanOperator, bool, false);
+};
+
+/** \class ImageSpanTraits
+ * \brief Tells whether the scanlines of an image type are contiguous runs
+ * of pixels in its buffer.
+ *
+ * IsContiguous is true for Image, whose buffer holds the pixels
+ * themselves; it is false for the image types whose pixels are computed
+ * from, or scattered in, their buffer, such as image adaptors and
+ * VectorImage.
+ *
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+template< typename TImage >
+struct ImageSpanTraits {
+  itkStaticConstMacro(IsContiguous, bool, false);
+};
+
+template< class TPixel, unsigned int VImageDimension >
+struct ImageSpanTraits< Image< TPixel, VImageDimension > > {
+  itkStaticConstMacro(IsContiguous, bool, true);
+};
+} // end namespace itk
+
+#endif
@@ -33,6 +33,8 @@
 
 namespace itk
 {
+class WorkStealingScheduler;
+
 /** \class ImageSource
  *  \brief Base class for all process objects that output image data.
  *
@@ -53,6 +55,16 @@ namespace itk
  * ProcessObject::ReleaseDataBeforeUpdateFlagOn().  A user may want to
  * set this flag to limit peak memory usage during a pipeline update.
  *
+ * By default the output requested region is split into one piece per
+ * thread.  When DynamicMultiThreading is on, the region is instead split
+ * into NumberOfPiecesPerThread pieces per thread, which the threads take
+ * from a WorkStealingScheduler; a thread that runs out of pieces steals
+ * pieces from the others.  This balances the load for filters whose cost
+ * per pixel varies across the image.  ThreadedGenerateData() is then
+ * called several times per thread, each time with the same threadId, so
+ * only filters that accumulate (rather than assign) their per-thread
+ * results should enable this mode.
+ *
  * \ingroup DataSources
  * \ingroup ITKCommon
  *
@@ -209,9 +221,23 @@ public:
   using Superclass::MakeOutput;
   virtual ProcessObject::DataObjectPointer MakeOutput(ProcessObject::DataObjectPointerArraySizeType idx);
 
+  /** Set/Get whether the default GenerateData() hands out many small
+   * pieces of the output region to the threads on demand, instead of one
+   * piece per thread.  Off by default. */
+  itkSetMacro(DynamicMultiThreading, bool);
+  itkGetConstMacro(DynamicMultiThreading, bool);
+  itkBooleanMacro(DynamicMultiThreading);
+
+  /** Set/Get the number of pieces per thread the output region is split
+   * into when DynamicMultiThreading is on.  The actual number of pieces
+   * may be smaller, see SplitRequestedRegion().  Defaults to 8. */
+  itkSetClampMacro(NumberOfPiecesPerThread, unsigned int, 1, NumericTraits< unsigned int >::max());
+  itkGetConstMacro(NumberOfPiecesPerThread, unsigned int);
+
 protected:
   ImageSource();
-  virtual ~ImageSource() {}
+  virtual ~ImageSource();
+  void PrintSelf(std::ostream & os, Indent indent) const;
 
   /** A version of GenerateData() specific for image processing
    * filters.  This implementation will split the processing across
@@ -300,6 +326,11 @@ protected:
    * control to ThreadedGenerateData(). */
   static ITK_THREAD_RETURN_TYPE ThreaderCallback(void *arg);
 
+  /** Static function used as a "callback" by the MultiThreader when
+   * DynamicMultiThreading is on.  Each thread repeatedly takes a piece
+   * from the scheduler and calls ThreadedGenerateData() on it. */
+  static ITK_THREAD_RETURN_TYPE DynamicThreaderCallback(void *arg);
+
   /** Internal structure used for passing image data into the threading library
     */
   struct ThreadStruct {
@@ -308,6 +339,13 @@ protected:
 private:
   ImageSource(const Self &);    //purposely not implemented
   void operator=(const Self &); //purposely not implemented
+
+  bool         m_DynamicMultiThreading;
+  unsigned int m_NumberOfPiecesPerThread;
+
+  /** Created on the first update with DynamicMultiThreading on, so that
+   * the other filters do not carry its per-thread ranges. */
+  WorkStealingScheduler *m_PieceScheduler;
 };
 } // end namespace itk
 
@@ -30,6 +30,7 @@
 #include "itkImageSource.h"
 
 #include "itkOutputDataObjectIterator.h"
+#include "itkWorkStealingScheduler.h"
 
 #include "vnl/vnl_math.h"
 
@@ -40,7 +41,10 @@ namespace itk
  */
 template< class TOutputImage >
 ImageSource< TOutputImage >
-::ImageSource()
+::ImageSource():
+  m_DynamicMultiThreading(false),
+  m_NumberOfPiecesPerThread(8),
+  m_PieceScheduler(0)
 {
   // Create the output. We use static_cast<> here because we know the default
   // output must be of type TOutputImage
@@ -55,6 +59,13 @@ ImageSource< TOutputImage >
   this->ReleaseDataBeforeUpdateFlagOff();
 }
 
+template< class TOutputImage >
+ImageSource< TOutputImage >
+::~ImageSource()
+{
+  delete m_PieceScheduler;
+}
+
 /**
  *
  */
@@ -270,7 +281,24 @@ ImageSource< TOutputImage >
   str.Filter = this;
 
   this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
-  this->GetMultiThreader()->SetSingleMethod(this->ThreaderCallback, &str);
+  if ( m_DynamicMultiThreading )
+    {
+    // find out how many pieces the requested region can be split into
+    const ThreadIdType numberOfThreads = this->GetMultiThreader()->GetNumberOfThreads();
+    OutputImageRegionType splitRegion;
+    const unsigned int numberOfPieces =
+      this->SplitRequestedRegion(0, numberOfThreads * m_NumberOfPiecesPerThread, splitRegion);
+    if ( m_PieceScheduler == 0 )
+      {
+      m_PieceScheduler = new WorkStealingScheduler;
+      }
+    m_PieceScheduler->Initialize(numberOfPieces, numberOfThreads);
+    this->GetMultiThreader()->SetSingleMethod(this->DynamicThreaderCallback, &str);
+    }
+  else
+    {
+    this->GetMultiThreader()->SetSingleMethod(this->ThreaderCallback, &str);
+    }
 
   // multithread the execution
   this->GetMultiThreader()->SingleMethodExecute();
@@ -337,6 +365,49 @@ ImageSource< TOutputImage >
 
   return ITK_THREAD_RETURN_VALUE;
 }
+
+// Callback routine used by the threading library when dynamic
+// multi-threading is on. This routine calls ThreadedGenerateData for
+// each piece the scheduler hands out to this thread.
+template< class TOutputImage >
+ITK_THREAD_RETURN_TYPE
+ImageSource< TOutputImage >
+::DynamicThreaderCallback(void *arg)
+{
+  ThreadStruct *str;
+  ThreadIdType  threadId;
+
+  threadId = ( (MultiThreader::ThreadInfoStruct *)( arg ) )->ThreadID;
+
+  str = (ThreadStruct *)( ( (MultiThreader::ThreadInfoStruct *)( arg ) )->UserData );
+
+  WorkStealingScheduler & scheduler = *str->Filter->m_PieceScheduler;
+  const unsigned int numberOfPieces =
+    static_cast< unsigned int >( scheduler.GetNumberOfPieces() );
+
+  typename TOutputImage::RegionType splitRegion;
+  SizeValueType piece;
+  while ( scheduler.GetNextPiece(threadId, piece) )
+    {
+    str->Filter->SplitRequestedRegion(static_cast< unsigned int >( piece ),
+                                      numberOfPieces, splitRegion);
+    str->Filter->ThreadedGenerateData(splitRegion, threadId);
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< class TOutputImage >
+void
+ImageSource< TOutputImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "DynamicMultiThreading: "
+     << ( m_DynamicMultiThreading ? "On" : "Off" ) << std::endl;
+  os << indent << "NumberOfPiecesPerThread: " << m_NumberOfPiecesPerThread << std::endl;
+}
 } // end namespace itk
 
 #endif
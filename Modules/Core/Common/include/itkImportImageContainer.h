@@ -20,6 +20,7 @@
 
 #include "itkObject.h"
 #include "itkObjectFactory.h"
+#include "itkBufferAllocator.h"
 #include <utility>
 
 namespace itk
@@ -36,6 +37,14 @@ namespace itk
  *
  * \tparam TElement The element type stored in the container.
  *
+ * Memory is obtained with new[] unless an Allocator is set, which is
+ * initialized to BufferAllocator::GetGlobalDefault() at construction
+ * time.  With an allocator, the buffer is aligned as specified by the
+ * allocator, and elements are only constructed (and destroyed) when
+ * BufferElementTraits< TElement > reports that they are not trivially
+ * constructible, so that the pages of large buffers are first written by
+ * the threads that produce the pixels.
+ *
  * \ingroup ImageObjects
  * \ingroup IOFilters
  * \ingroup ITKCommon
@@ -131,6 +140,16 @@ public:
   itkSetMacro(ContainerManageMemory, bool);
   itkGetConstMacro(ContainerManageMemory, bool);
   itkBooleanMacro(ContainerManageMemory);
+
+  /** Set/Get the allocator used for subsequent allocations.  NULL selects
+   * new[] and delete[].  A buffer is always released by the allocator
+   * that provided it. */
+  itkSetObjectMacro(Allocator, BufferAllocator);
+  itkGetObjectMacro(Allocator, BufferAllocator);
+
+  /** Get the allocator that provided the current buffer, NULL when the
+   * buffer was obtained with new[] or imported. */
+  itkGetObjectMacro(BufferAllocator, BufferAllocator);
 protected:
   ImportImageContainer();
   virtual ~ImportImageContainer();
@@ -169,10 +188,18 @@ private:
   ImportImageContainer(const Self &); //purposely not implemented
   void operator=(const Self &);       //purposely not implemented
 
+  /** Record that m_ImportPointer was returned by AllocateElements(). */
+  void TakeOwnershipOfAllocatedElements();
+
   TElement *         m_ImportPointer;
   TElementIdentifier m_Size;
   TElementIdentifier m_Capacity;
   bool               m_ContainerManageMemory;
+
+  /** Allocator for subsequent allocations, and allocator that provided
+   * the current buffer (NULL for new[] or imported memory). */
+  BufferAllocator::Pointer m_Allocator;
+  BufferAllocator::Pointer m_BufferAllocator;
 };
 } // end namespace itk
 
@@ -32,6 +32,7 @@
 #include <cstring>
 #include <stdlib.h>
 #include <string.h>
+#include <new>
 
 namespace itk
 {
@@ -43,6 +44,7 @@ ImportImageContainer< TElementIdentifier, TElement >
   m_ContainerManageMemory = true;
   m_Capacity = 0;
   m_Size = 0;
+  m_Allocator = BufferAllocator::GetGlobalDefault();
 }
 
 template< typename TElementIdentifier, typename TElement >
@@ -78,6 +80,7 @@ ImportImageContainer< TElementIdentifier, TElement >
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
+      this->TakeOwnershipOfAllocatedElements();
       this->Modified();
       }
     else
@@ -92,6 +95,7 @@ ImportImageContainer< TElementIdentifier, TElement >
     m_Capacity = size;
     m_Size = size;
     m_ContainerManageMemory = true;
+    this->TakeOwnershipOfAllocatedElements();
     this->Modified();
     }
 }
@@ -119,6 +123,7 @@ ImportImageContainer< TElementIdentifier, TElement >
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
+      this->TakeOwnershipOfAllocatedElements();
 
       this->Modified();
       }
@@ -176,6 +181,28 @@ TElement *ImportImageContainer< TElementIdentifier, TElement >
   // does not do this by default.
   TElement *data;
 
+  if ( m_Allocator )
+    {
+    const SizeValueType maximumSize =
+      static_cast< SizeValueType >( -1 ) / static_cast< SizeValueType >( sizeof( TElement ) );
+    if ( static_cast< SizeValueType >( size ) != size || static_cast< SizeValueType >( size ) > maximumSize )
+      {
+      throw MemoryAllocationError(__FILE__, __LINE__,
+                                  "Image size in bytes overflows the allocator size type.",
+                                  ITK_LOCATION);
+      }
+    data = static_cast< TElement * >(
+      m_Allocator->Allocate( static_cast< SizeValueType >( size ) * sizeof( TElement ) ) );
+    if ( !BufferElementTraits< TElement >::IsTriviallyConstructible )
+      {
+      for ( ElementIdentifier i = 0; i < size; i++ )
+        {
+        new ( data + i ) TElement;
+        }
+      }
+    return data;
+    }
+
   try
     {
     data = new TElement[size];
@@ -202,13 +229,37 @@ void ImportImageContainer< TElementIdentifier, TElement >
   // Encapsulate all image memory deallocation here
   if ( m_ImportPointer && m_ContainerManageMemory )
     {
-    delete[] m_ImportPointer;
+    if ( m_BufferAllocator )
+      {
+      if ( !BufferElementTraits< TElement >::IsTriviallyConstructible )
+        {
+        for ( ElementIdentifier i = 0; i < m_Capacity; i++ )
+          {
+          m_ImportPointer[i].~TElement();
+          }
+        }
+      m_BufferAllocator->Deallocate( m_ImportPointer, m_Capacity * sizeof( TElement ) );
+      }
+    else
+      {
+      delete[] m_ImportPointer;
+      }
     }
   m_ImportPointer = 0;
+  m_BufferAllocator = 0;
   m_Capacity = 0;
   m_Size = 0;
 }
 
+template< typename TElementIdentifier, typename TElement >
+void ImportImageContainer< TElementIdentifier, TElement >
+::TakeOwnershipOfAllocatedElements()
+{
+  // AllocateElements() used the current allocator, which is therefore
+  // also the one to release the buffer.
+  m_BufferAllocator = m_Allocator;
+}
+
 template< typename TElementIdentifier, typename TElement >
 void
 ImportImageContainer< TElementIdentifier, TElement >
@@ -221,6 +272,7 @@ ImportImageContainer< TElementIdentifier, TElement >
      << ( m_ContainerManageMemory ? "true" : "false" ) << std::endl;
   os << indent << "Size: " << m_Size << std::endl;
   os << indent << "Capacity: " << m_Capacity << std::endl;
+  os << indent << "Allocator: " << m_Allocator.GetPointer() << std::endl;
 }
 } // end namespace itk
 
@@ -0,0 +1,127 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkMemoryMappedBufferAllocator_h
+#define __itkMemoryMappedBufferAllocator_h
+
+#include "itkBufferAllocator.h"
+#include "itkSimpleFastMutexLock.h"
+#include <map>
+#include <string>
+
+namespace itk
+{
+/** \class MemoryMappedBufferAllocator
+ * \brief BufferAllocator that maps buffers from a file instead of
+ * allocating them.
+ *
+ * Allocate(n) maps the n bytes of FileName that start at FileOffset,
+ * and Deallocate() unmaps them.  A buffer allocated this way holds the
+ * bytes of the file without reading them: pages are loaded on first
+ * access, and are shared through the page cache with every other
+ * mapping of the same file, e.g. by other processes working on the same
+ * volume.
+ *
+ * The mapping is copy-on-write: the buffer can be modified, in place
+ * filters included, and modified pages become private to the process;
+ * the file is never changed.
+ *
+ * ImageFileReader uses this allocator to map the pixel buffer of images
+ * whose pixels are stored in the file exactly as in memory, see
+ * ImageFileReader::SetUseMemoryMapping().
+ *
+ * An empty buffer, which cannot be mapped, is obtained from
+ * Superclass::Allocate().
+ *
+ * \sa BufferAllocator ImportImageContainer
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT MemoryMappedBufferAllocator:public BufferAllocator
+{
+public:
+  /** Standard class typedefs. */
+  typedef MemoryMappedBufferAllocator Self;
+  typedef BufferAllocator             Superclass;
+  typedef SmartPointer< Self >        Pointer;
+  typedef SmartPointer< const Self >  ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MemoryMappedBufferAllocator, BufferAllocator);
+
+  /** Set/Get the file that buffers are mapped from. */
+  itkSetStringMacro(FileName);
+  itkGetStringMacro(FileName);
+
+  /** Set/Get the position in the file of the first byte of a buffer.
+   * It does not need to be aligned to a page, but a buffer is only as
+   * aligned as the offset is, so the offset must be a multiple of
+   * Alignment.  Defaults to 0. */
+  itkSetMacro(FileOffset, SizeValueType);
+  itkGetConstMacro(FileOffset, SizeValueType);
+
+  /** Map numberOfBytes bytes of the file.  Throws an ExceptionObject
+   * when FileOffset is not a multiple of Alignment, or when the file
+   * cannot be mapped or is too short. */
+  virtual void * Allocate(SizeValueType numberOfBytes);
+
+  /** Unmap a buffer returned by Allocate(). */
+  virtual void Deallocate(void *buffer, SizeValueType numberOfBytes);
+
+  /** Number of buffers currently mapped. */
+  SizeValueType GetNumberOfMappedBuffers() const;
+
+protected:
+  MemoryMappedBufferAllocator();
+  ~MemoryMappedBufferAllocator() {}
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  MemoryMappedBufferAllocator(const Self &); //purposely not implemented
+  void operator=(const Self &);              //purposely not implemented
+
+  /** The mapping that holds a buffer, which starts at the page boundary
+   * preceding the buffer. */
+  struct Mapping {
+    void *Address;
+    SizeValueType Length;
+  };
+
+  typedef std::map< void *, Mapping > MappingMapType;
+
+  /** Platform specific mapping of length bytes at the page aligned
+   * offset, and its release.  MapFile returns NULL and sets
+   * errorMessage on failure. */
+  void * MapFile(SizeValueType offset, SizeValueType length, std::string & errorMessage) const;
+
+  static void UnmapFile(const Mapping & mapping);
+
+  /** Granularity of the file offsets of a mapping. */
+  static SizeValueType GetMappingGranularity();
+
+  std::string   m_FileName;
+  SizeValueType m_FileOffset;
+
+  MappingMapType              m_Mappings;
+  mutable SimpleFastMutexLock m_Mutex;
+};
+} // end namespace itk
+
+#endif
@@ -30,6 +30,7 @@
 
 #include "itkMutexLock.h"
 #include "itkThreadSupport.h"
+#include "itkThreadPool.h"
 #include "itkIntTypes.h"
 
 namespace itk
@@ -47,6 +48,14 @@ namespace itk
  * If ITK_USE_PTHREADS is defined, then
  * pthread_create() will be used to create multiple threads (on
  * a sun, for example).
+ *
+ * When UseThreadPool is on, SingleMethodExecute() hands its work to the
+ * process-wide ThreadPool instead of creating and joining new threads on
+ * every call.  It is off by default; the global default can be changed
+ * with SetGlobalDefaultUseThreadPool() or the ITK_USE_THREADPOOL
+ * environment variable (1, ON, YES or TRUE enable it).
+ *
+ * \sa ThreadPool
  * \ingroup ITKCommon
  */
 
@@ -89,6 +98,20 @@ public:
 
   static ThreadIdType  GetGlobalDefaultNumberOfThreads();
 
+  /** Set/Get whether SingleMethodExecute() runs on the persistent
+   * ThreadPool rather than on freshly created threads.  Initialized to
+   * GetGlobalDefaultUseThreadPool() at construction time. */
+  itkSetMacro(UseThreadPool, bool);
+  itkGetConstMacro(UseThreadPool, bool);
+  itkBooleanMacro(UseThreadPool);
+
+  /** Set/Get the value which is used to initialize UseThreadPool in the
+   * constructor.  Unless set explicitly, it is read once from the
+   * ITK_USE_THREADPOOL environment variable and defaults to false. */
+  static void SetGlobalDefaultUseThreadPool(bool use);
+
+  static bool GetGlobalDefaultUseThreadPool();
+
   /** Execute the SingleMethod (as define by SetSingleMethod) using
    * m_NumberOfThreads threads. As a side effect the m_NumberOfThreads will be
    * checked against the current m_GlobalMaximumNumberOfThreads and clamped if
@@ -168,6 +191,9 @@ private:
   ThreadProcessIDType m_SpawnedThreadProcessID[ITK_MAX_THREADS];
   ThreadInfoStruct    m_SpawnedThreadInfoArray[ITK_MAX_THREADS];
 
+  /** Jobs handed to the ThreadPool by SingleMethodExecute(). */
+  ThreadPool::ThreadJob m_ThreadJobArray[ITK_MAX_THREADS];
+
   /** Internal storage of the data. */
   void *m_SingleData;
   void *m_MultipleData[ITK_MAX_THREADS];
@@ -185,6 +211,14 @@ private:
    */
   static ThreadIdType m_GlobalDefaultNumberOfThreads;
 
+  /** Global variable defining the default UseThreadPool value, and whether
+   *  it has been initialized from the environment or set explicitly. */
+  static bool m_GlobalDefaultUseThreadPool;
+  static bool m_GlobalDefaultUseThreadPoolIsInitialized;
+
+  /** Whether SingleMethodExecute() dispatches onto the ThreadPool. */
+  bool m_UseThreadPool;
+
   /**  Platform specific number of threads */
   static ThreadIdType  GetGlobalDefaultNumberOfThreadsByPlatform();
 
@@ -220,6 +254,12 @@ private:
    * already has a routine to do this. */
   void WaitForSingleMethodThread(ThreadProcessIDType);
 
+  /** Run the prescribed SingleMethod for the given thread index, either
+   * on the ThreadPool or on a new thread, and wait for it respectively.
+   * These select between the two mechanisms based on m_UseThreadPool. */
+  void DispatchSingleMethod(ThreadIdType threadIndex, ThreadProcessIDType *processId);
+  void WaitForSingleMethod(ThreadIdType threadIndex, ThreadProcessIDType *processId);
+
   /** Friends of Multithreader.
    * ProcessObject is a friend so that it can call PrintSelf() on its
    * Multithreader. */
@@ -0,0 +1,149 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkPooledBufferAllocator_h
+#define __itkPooledBufferAllocator_h
+
+#include "itkBufferAllocator.h"
+#include "itkSimpleFastMutexLock.h"
+#include <list>
+
+namespace itk
+{
+/** \class PooledBufferAllocator
+ * \brief BufferAllocator that keeps released buffers for reuse.
+ *
+ * Pipelines that are updated repeatedly, or that release the data of
+ * their intermediate images (DataObject::ReleaseDataFlagOn()), allocate
+ * and free buffers of the same sizes over and over.  For large images
+ * each new buffer costs a page fault per page.  PooledBufferAllocator
+ * keeps the buffers returned to it by Deallocate() and hands them out
+ * again from Allocate(), so that the pages are only faulted in once.
+ *
+ * Requests are rounded up to a size bucket of the form m * 2^k, with m
+ * between 8 and 15, which wastes at most 12.5% of a buffer and lets
+ * slightly different image sizes share buffers.  A request is served by
+ * a held buffer of the same bucket, or by Superclass::Allocate() when
+ * there is none.
+ *
+ * The pool holds at most MaximumNumberOfBytesHeld bytes (1 GiB by
+ * default).  When a returned buffer would exceed that limit, the least
+ * recently returned buffers are freed first; a buffer larger than the
+ * limit is freed immediately.  Clear() frees all held buffers.
+ *
+ * Recycled buffers are not cleared and hold the pixel values of their
+ * previous use.
+ *
+ * Allocate() and Deallocate() may be called from several threads.
+ *
+ * To use the pool for all images of a process:
+ * \code
+ * itk::PooledBufferAllocator::Pointer pool = itk::PooledBufferAllocator::New();
+ * itk::BufferAllocator::SetGlobalDefault(pool);
+ * \endcode
+ *
+ * \sa BufferAllocator ImportImageContainer
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT PooledBufferAllocator:public BufferAllocator
+{
+public:
+  /** Standard class typedefs. */
+  typedef PooledBufferAllocator      Self;
+  typedef BufferAllocator            Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(PooledBufferAllocator, BufferAllocator);
+
+  /** Return a held buffer of the bucket of numberOfBytes, or allocate a
+   * new one. */
+  virtual void * Allocate(SizeValueType numberOfBytes);
+
+  /** Return the buffer to the pool. */
+  virtual void Deallocate(void *buffer, SizeValueType numberOfBytes);
+
+  /** Set/Get the maximum number of bytes held by the pool.  Lowering the
+   * limit frees held buffers as needed. */
+  void SetMaximumNumberOfBytesHeld(SizeValueType numberOfBytes);
+
+  SizeValueType GetMaximumNumberOfBytesHeld() const;
+
+  /** Number of bytes and number of buffers currently held by the
+   * pool. */
+  SizeValueType GetNumberOfBytesHeld() const;
+
+  SizeValueType GetNumberOfBuffersHeld() const;
+
+  /** Number of Allocate() calls served from the pool (hits) and by a new
+   * allocation (misses) since construction or ResetStatistics(). */
+  SizeValueType GetNumberOfHits() const;
+
+  SizeValueType GetNumberOfMisses() const;
+
+  /** Reset the hit and miss counts. */
+  void ResetStatistics();
+
+  /** Free all held buffers. */
+  void Clear();
+
+  /** Size of the bucket that numberOfBytes is rounded up to. */
+  static SizeValueType GetBucketSize(SizeValueType numberOfBytes);
+
+protected:
+  PooledBufferAllocator();
+  ~PooledBufferAllocator();
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  PooledBufferAllocator(const Self &); //purposely not implemented
+  void operator=(const Self &);        //purposely not implemented
+
+  struct HeldBuffer {
+    void *Buffer;
+    SizeValueType NumberOfBytes;
+  };
+
+  /** Held buffers, most recently returned first. */
+  typedef std::list< HeldBuffer > HeldBufferListType;
+
+  /** Move held buffers, least recently returned first, to released
+   * until at most numberOfBytes bytes are held.  Must be called with the
+   * lock held. */
+  void ReleaseHeldBuffers(SizeValueType numberOfBytes, HeldBufferListType & released);
+
+  /** Free the buffers with Superclass::Deallocate().  Called without the
+   * lock so that other threads are not blocked while memory is returned
+   * to the system. */
+  void FreeBuffers(HeldBufferListType & buffers);
+
+  HeldBufferListType m_HeldBuffers;
+  SizeValueType      m_NumberOfBytesHeld;
+  SizeValueType      m_MaximumNumberOfBytesHeld;
+  SizeValueType      m_NumberOfHits;
+  SizeValueType      m_NumberOfMisses;
+
+  mutable SimpleFastMutexLock m_Mutex;
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,159 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkThreadPool_h
+#define __itkThreadPool_h
+
+#include "itkConditionVariable.h"
+#include "itkIntTypes.h"
+#include <deque>
+#include <vector>
+
+namespace itk
+{
+/** \class ThreadPool
+ * \brief Process-wide set of persistent worker threads.
+ *
+ * ThreadPool keeps a number of worker threads alive for the lifetime of
+ * the process so that repeated calls to
+ * MultiThreader::SingleMethodExecute() do not pay the cost of creating
+ * and joining operating system threads.  Work is handed to the pool as
+ * ThreadJob records, which are executed in FIFO order by the first idle
+ * worker.
+ *
+ * The pool is elastic: whenever a job is queued and no idle worker is
+ * available to pick it up, a new worker is started.  This guarantees that
+ * nested dispatch (a job that itself calls SingleMethodExecute()) cannot
+ * deadlock.  SetNumberOfThreads() can be used to start workers ahead of
+ * time, and Shutdown() waits for queued jobs, then stops and joins all
+ * workers.  The pool restarts transparently on the next AddWork().
+ *
+ * On Linux and Windows the workers can optionally be pinned to a single
+ * processor each (worker i runs on processor i modulo the number of
+ * processors), see SetUseCPUAffinity().
+ *
+ * The pool is accessed through GetInstance().  Like the other
+ * threading primitives it is a LightObject, so creating it does not
+ * advance the global modified time.
+ *
+ * The process-wide instance is never destroyed.  Joining the workers from
+ * a static destructor at exit can deadlock (on Windows the loader lock is
+ * held while static objects are destroyed) and races with the destruction
+ * of other static objects, so the idle workers are simply left to the
+ * operating system when the process exits.  Applications that need the
+ * workers joined, for instance before unloading ITK, call Shutdown().
+ *
+ * \sa MultiThreader
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ThreadPool:public LightObject
+{
+public:
+  /** Standard class typedefs. */
+  typedef ThreadPool                 Self;
+  typedef LightObject                Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ThreadPool, LightObject);
+
+  /** Return the process-wide thread pool, creating it on first use. */
+  static Pointer GetInstance();
+
+  /** A unit of work executed by one of the workers.  The storage is owned
+   * by the caller and must remain valid until WaitForJob() returns.
+   * Completed is managed by the pool. */
+  struct ThreadJob {
+    ThreadFunctionType ThreadFunction;
+    void *UserData;
+    bool Completed;
+  };
+
+  /** Queue a job for execution and return immediately. */
+  void AddWork(ThreadJob *job);
+
+  /** Block until the given job has been executed. */
+  void WaitForJob(ThreadJob *job);
+
+  /** Set/Get the number of worker threads kept alive.  Increasing the
+   * number starts the additional workers immediately; decreasing it
+   * shuts the pool down and restarts it with the requested size. */
+  void SetNumberOfThreads(ThreadIdType numberOfThreads);
+
+  ThreadIdType GetNumberOfThreads() const;
+
+  /** Set/Get whether workers are pinned to a single processor.  Only
+   * affects workers started afterwards; call Shutdown() to re-pin a
+   * running pool.  Ignored on platforms without affinity support. */
+  void SetUseCPUAffinity(bool useCPUAffinity)
+  {
+    m_UseCPUAffinity = useCPUAffinity;
+  }
+  bool GetUseCPUAffinity() const
+  {
+    return m_UseCPUAffinity;
+  }
+  void UseCPUAffinityOn()
+  {
+    this->SetUseCPUAffinity(true);
+  }
+  void UseCPUAffinityOff()
+  {
+    this->SetUseCPUAffinity(false);
+  }
+
+  /** Wait for all queued jobs to complete, then stop and join every
+   * worker.  Must not be called from within a job. */
+  void Shutdown();
+
+protected:
+  ThreadPool();
+  ~ThreadPool();
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  ThreadPool(const Self &);     //purposely not implemented
+  void operator=(const Self &); //purposely not implemented
+
+  /** Start one worker thread.  Called with m_Mutex held. */
+  void StartWorker();
+
+  /** Platform specific thread creation and joining. */
+  ThreadProcessIDType CreateWorkerThread(ThreadIdType workerIndex);
+  void JoinWorkerThread(ThreadProcessIDType threadHandle);
+
+  /** Main loop executed by every worker. */
+  static ITK_THREAD_RETURN_TYPE WorkerMain(void *arg);
+
+  std::deque< ThreadJob * >          m_JobQueue;
+  std::vector< ThreadProcessIDType > m_Workers;
+
+  ThreadIdType m_NumberOfIdleThreads;
+  bool         m_Terminating;
+  bool         m_UseCPUAffinity;
+
+  mutable SimpleMutexLock    m_Mutex;
+  ConditionVariable::Pointer m_WorkAvailable;
+  ConditionVariable::Pointer m_JobCompleted;
+
+  /** Deliberately leaked, see the class documentation. */
+  static Self *m_Instance;
+};
+}  // end namespace itk
+#endif
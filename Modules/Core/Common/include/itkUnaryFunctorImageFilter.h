@@ -20,6 +20,7 @@
 
 #include "itkInPlaceImageFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkFunctorSpanTraits.h"
 
 namespace itk
 {
@@ -35,6 +36,10 @@ namespace itk
  * UnaryFunctorImageFilter (like the CastImageFilter) can be used
  * to promote a 2D image to a 3D image, etc.
  *
+ * When the input and output are Images of the same dimension, the
+ * pixels are processed scanline by scanline over raw pointers, with the
+ * span operator of the functor when FunctorSpanTraits reports one.
+ *
  * \sa BinaryFunctorImageFilter TernaryFunctorImageFilter
  *
  * \ingroup   IntensityImageFilters     MultiThreaded
@@ -126,6 +131,50 @@ private:
   UnaryFunctorImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);          //purposely not implemented
 
+  typedef ImageToImageFilterDetail::BooleanDispatch<
+    ImageSpanTraits< TInputImage >::IsContiguous
+    && ImageSpanTraits< TOutputImage >::IsContiguous
+    && (unsigned int)InputImageType::ImageDimension == (unsigned int)OutputImageType::ImageDimension >
+  ScanlineDispatchType;
+  typedef ImageToImageFilterDetail::BooleanDispatch<
+    FunctorSpanTraits< FunctorType >::HasSpanOperator > SpanDispatchType;
+
+  /** Process the region scanline by scanline.  Returns false when the
+   * images or regions do not allow it. */
+  bool ThreadedGenerateScanlines(const ImageToImageFilterDetail::BooleanDispatch< false > &,
+                                 const InputImageRegionType &,
+                                 const OutputImageRegionType &,
+                                 ThreadIdType)
+  {
+    return false;
+  }
+
+  bool ThreadedGenerateScanlines(const ImageToImageFilterDetail::BooleanDispatch< true > &,
+                                 const InputImageRegionType & inputRegionForThread,
+                                 const OutputImageRegionType & outputRegionForThread,
+                                 ThreadIdType threadId);
+
+  static void ProcessScanline(const ImageToImageFilterDetail::BooleanDispatch< true > &,
+                              FunctorType & functor,
+                              const InputImagePixelType *in,
+                              OutputImagePixelType *out,
+                              SizeValueType n)
+  {
+    functor(in, out, n);
+  }
+
+  static void ProcessScanline(const ImageToImageFilterDetail::BooleanDispatch< false > &,
+                              FunctorType & functor,
+                              const InputImagePixelType *in,
+                              OutputImagePixelType *out,
+                              SizeValueType n)
+  {
+    for ( SizeValueType i = 0; i < n; ++i )
+      {
+      out[i] = functor(in[i]);
+      }
+  }
+
   FunctorType m_Functor;
 };
 } // end namespace itk
@@ -20,6 +20,7 @@
 
 #include "itkUnaryFunctorImageFilter.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkProgressReporter.h"
 
 namespace itk
@@ -161,6 +162,12 @@ UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
 
   this->CallCopyOutputRegionToInputRegion(inputRegionForThread, outputRegionForThread);
 
+  if ( this->ThreadedGenerateScanlines(ScanlineDispatchType(), inputRegionForThread,
+                                       outputRegionForThread, threadId) )
+    {
+    return;
+    }
+
   // Define the iterators
   ImageRegionConstIterator< TInputImage > inputIt(inputPtr, inputRegionForThread);
   ImageRegionIterator< TOutputImage >     outputIt(outputPtr, outputRegionForThread);
@@ -178,6 +185,63 @@ UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
     progress.CompletedPixel();  // potential exception thrown here
     }
 }
+
+template< class TInputImage, class TOutputImage, class TFunction  >
+bool
+UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
+::ThreadedGenerateScanlines(const ImageToImageFilterDetail::BooleanDispatch< true > &,
+                            const InputImageRegionType & inputRegionForThread,
+                            const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId)
+{
+  if ( inputRegionForThread.GetSize() != outputRegionForThread.GetSize() )
+    {
+    return false;
+    }
+
+  InputImagePointer  inputPtr = this->GetInput();
+  OutputImagePointer outputPtr = this->GetOutput(0);
+
+  const SizeValueType lineLength = outputRegionForThread.GetSize(0);
+  if ( lineLength == 0 )
+    {
+    return true;
+    }
+  const SizeValueType numberOfLines = outputRegionForThread.GetNumberOfPixels() / lineLength;
+
+  ProgressReporter progress(this, threadId, numberOfLines);
+
+  // a local copy of the functor cannot alias the output buffer, which
+  // lets the compiler keep its state in registers
+  FunctorType functor = m_Functor;
+
+  // walk the first pixel of each scanline
+  OutputImageRegionType lineStarts = outputRegionForThread;
+  lineStarts.SetSize(0, 1);
+  ImageRegionConstIteratorWithIndex< TOutputImage > lineIt(outputPtr, lineStarts);
+
+  typename InputImageType::OffsetType inputOffset;
+  for ( unsigned int d = 0; d < InputImageType::ImageDimension; ++d )
+    {
+    inputOffset[d] = inputRegionForThread.GetIndex(d) - outputRegionForThread.GetIndex(d);
+    }
+
+  for ( lineIt.GoToBegin(); !lineIt.IsAtEnd(); ++lineIt )
+    {
+    const typename OutputImageType::IndexType & outputIndex = lineIt.GetIndex();
+    typename InputImageType::IndexType          inputIndex;
+    for ( unsigned int d = 0; d < InputImageType::ImageDimension; ++d )
+      {
+      inputIndex[d] = outputIndex[d] + inputOffset[d];
+      }
+    ProcessScanline(SpanDispatchType(), functor,
+                    inputPtr->GetBufferPointer() + inputPtr->ComputeOffset(inputIndex),
+                    outputPtr->GetBufferPointer() + outputPtr->ComputeOffset(outputIndex),
+                    lineLength);
+    progress.CompletedPixel();  // potential exception thrown here
+    }
+  return true;
+}
 } // end namespace itk
 
 #endif
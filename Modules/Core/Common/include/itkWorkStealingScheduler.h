@@ -0,0 +1,96 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkWorkStealingScheduler_h
+#define __itkWorkStealingScheduler_h
+
+#include "itkSimpleFastMutexLock.h"
+#include "itkIntTypes.h"
+
+namespace itk
+{
+/** \class WorkStealingScheduler
+ * \brief Hands out work pieces to threads, letting idle threads steal
+ * pieces from busy ones.
+ *
+ * The pieces 0, 1, ..., N-1 are initially dealt out to the threads as
+ * contiguous, equally sized ranges, so that neighboring pieces (and thus
+ * neighboring memory) tend to be processed by the same thread.  Each
+ * thread takes pieces from the front of its own range.  Once its range is
+ * exhausted, a thread steals the back half of the remaining range of
+ * another thread.  Every piece is handed out exactly once.
+ *
+ * Each range is protected by its own lock, which is only contended when
+ * a thread steals, so the per-piece overhead stays small as long as the
+ * pieces are not tiny.
+ *
+ * WorkStealingScheduler is not a subclass of Object and is designed to be
+ * a member of the class running the threads.
+ *
+ * \sa ImageSource::SetDynamicMultiThreading()
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT WorkStealingScheduler
+{
+public:
+  /** Standard class typedefs. */
+  typedef WorkStealingScheduler Self;
+
+  WorkStealingScheduler();
+  ~WorkStealingScheduler() {}
+
+  /** Distribute numberOfPieces pieces among numberOfThreads threads.
+   * Must not be called while threads are requesting pieces. */
+  void Initialize(SizeValueType numberOfPieces, ThreadIdType numberOfThreads);
+
+  /** Get the next piece for the given thread.  Returns false once all
+   * pieces have been handed out. */
+  bool GetNextPiece(ThreadIdType threadId, SizeValueType & piece);
+
+  /** Number of pieces passed to Initialize(). */
+  SizeValueType GetNumberOfPieces() const
+  {
+    return m_NumberOfPieces;
+  }
+
+  /** Number of pieces that were taken from another thread since the last
+   * Initialize(). */
+  SizeValueType GetNumberOfStolenPieces() const;
+
+private:
+  WorkStealingScheduler(const Self &); //purposely not implemented
+  void operator=(const Self &);        //purposely not implemented
+
+  /** Half open range [Begin, End) of pieces still owned by one thread. */
+  struct PieceRange {
+    SizeValueType       Begin;
+    SizeValueType       End;
+    SizeValueType       Stolen;
+    SimpleFastMutexLock Lock;
+  };
+
+  /** Move part of another thread's range into the range of threadId.
+   * Returns false if no other thread has pieces left. */
+  bool Steal(ThreadIdType threadId);
+
+  PieceRange    m_Ranges[ITK_MAX_THREADS];
+  SizeValueType m_NumberOfPieces;
+  ThreadIdType  m_NumberOfThreads;
+};
+} // end namespace itk
+
+#endif
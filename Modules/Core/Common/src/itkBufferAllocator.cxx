@@ -0,0 +1,191 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkBufferAllocator.h"
+#include "itkMacro.h"
+
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+#if defined( _WIN32 )
+#include <malloc.h>
+#endif
+
+namespace itk
+{
+namespace
+{
+// Buffers smaller than this are not worth the thread start-up cost of
+// the parallel first touch.
+const SizeValueType FirstTouchMinimumNumberOfBytes = 4 * 1024 * 1024;
+
+// Touching one byte every 4096 bytes reaches every page for all common
+// page sizes.
+const SizeValueType FirstTouchStride = 4096;
+
+struct FirstTouchStruct {
+  char *Buffer;
+  SizeValueType NumberOfBytes;
+};
+}
+
+BufferAllocator::Pointer BufferAllocator::m_GlobalDefault;
+
+BufferAllocator
+::BufferAllocator():
+  m_Alignment(64),
+  m_FirstTouch(true)
+{}
+
+void
+BufferAllocator
+::SetGlobalDefault(BufferAllocator *allocator)
+{
+  m_GlobalDefault = allocator;
+}
+
+BufferAllocator *
+BufferAllocator
+::GetGlobalDefault()
+{
+  return m_GlobalDefault.GetPointer();
+}
+
+void *
+BufferAllocator
+::Allocate(SizeValueType numberOfBytes)
+{
+  SizeValueType alignment = m_Alignment;
+
+  if ( alignment & ( alignment - 1 ) )
+    {
+    itkExceptionMacro(<< "Alignment " << alignment << " is not a power of two.");
+    }
+  // posix_memalign requires a multiple of sizeof(void *)
+  if ( alignment < sizeof( void * ) )
+    {
+    alignment = sizeof( void * );
+    }
+  // Never return a null pointer for an empty buffer.
+  if ( numberOfBytes == 0 )
+    {
+    numberOfBytes = 1;
+    }
+
+  void *buffer = 0;
+#if defined( _WIN32 )
+  buffer = _aligned_malloc(numberOfBytes, alignment);
+#else
+  if ( posix_memalign(&buffer, alignment, numberOfBytes) != 0 )
+    {
+    buffer = 0;
+    }
+#endif
+  if ( !buffer )
+    {
+    // We cannot construct an error string here because we may be out
+    // of memory.  Do not use the exception macro.
+    throw MemoryAllocationError(__FILE__, __LINE__,
+                                "Failed to allocate memory for image.",
+                                ITK_LOCATION);
+    }
+
+  if ( m_FirstTouch && numberOfBytes >= FirstTouchMinimumNumberOfBytes )
+    {
+    this->FirstTouchBuffer(buffer, numberOfBytes);
+    }
+
+  return buffer;
+}
+
+void
+BufferAllocator
+::Deallocate(void *buffer, SizeValueType itkNotUsed(numberOfBytes))
+{
+#if defined( _WIN32 )
+  _aligned_free(buffer);
+#else
+  free(buffer);
+#endif
+}
+
+void
+BufferAllocator
+::FirstTouchBuffer(void *buffer, SizeValueType numberOfBytes)
+{
+  if ( MultiThreader::GetGlobalDefaultNumberOfThreads() < 2 )
+    {
+    return;
+    }
+
+  FirstTouchStruct str;
+  str.Buffer = static_cast< char * >( buffer );
+  str.NumberOfBytes = numberOfBytes;
+
+  // A MultiThreader runs one method at a time.
+  m_FirstTouchLock.Lock();
+  try
+    {
+    if ( m_FirstTouchThreader.IsNull() )
+      {
+      m_FirstTouchThreader = MultiThreader::New();
+      }
+    m_FirstTouchThreader->SetNumberOfThreads( MultiThreader::GetGlobalDefaultNumberOfThreads() );
+    m_FirstTouchThreader->SetSingleMethod(Self::FirstTouchCallback, &str);
+    m_FirstTouchThreader->SingleMethodExecute();
+    }
+  catch ( ... )
+    {
+    m_FirstTouchLock.Unlock();
+    throw;
+    }
+  m_FirstTouchLock.Unlock();
+}
+
+ITK_THREAD_RETURN_TYPE
+BufferAllocator
+::FirstTouchCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info =
+    static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  const FirstTouchStruct *str = static_cast< const FirstTouchStruct * >( info->UserData );
+
+  // Same contiguous, equally sized slabs as an outermost axis split of
+  // the region by ImageSource::SplitRequestedRegion().
+  const SizeValueType slab =
+    ( str->NumberOfBytes + info->NumberOfThreads - 1 ) / info->NumberOfThreads;
+  const SizeValueType begin = slab * info->ThreadID;
+  const SizeValueType end = std::min(begin + slab, str->NumberOfBytes);
+
+  for ( SizeValueType i = begin; i < end; i += FirstTouchStride )
+    {
+    str->Buffer[i] = 0;
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void
+BufferAllocator
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Alignment: " << m_Alignment << std::endl;
+  os << indent << "FirstTouch: " << ( m_FirstTouch ? "On" : "Off" ) << std::endl;
+}
+} // end namespace itk
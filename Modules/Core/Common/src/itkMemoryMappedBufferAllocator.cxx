@@ -0,0 +1,232 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMemoryMappedBufferAllocator.h"
+#include "itkMutexLockHolder.h"
+
+#if defined( _WIN32 )
+#include "itkWindows.h"
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace itk
+{
+MemoryMappedBufferAllocator
+::MemoryMappedBufferAllocator():
+  m_FileOffset(0)
+{}
+
+void *
+MemoryMappedBufferAllocator
+::Allocate(SizeValueType numberOfBytes)
+{
+  if ( numberOfBytes == 0 )
+    {
+    return Superclass::Allocate(numberOfBytes);
+    }
+
+  const SizeValueType alignment = this->GetAlignment();
+  if ( alignment > 1 && m_FileOffset % alignment != 0 )
+    {
+    itkExceptionMacro(<< "Cannot map " << m_FileName << " at offset " << m_FileOffset
+                      << ", which is not a multiple of the alignment " << alignment);
+    }
+
+  // Mappings start at a multiple of the granularity.
+  const SizeValueType delta = m_FileOffset % GetMappingGranularity();
+
+  Mapping     mapping;
+  std::string errorMessage;
+  mapping.Length = numberOfBytes + delta;
+  mapping.Address = this->MapFile(m_FileOffset - delta, mapping.Length, errorMessage);
+  if ( !mapping.Address )
+    {
+    itkExceptionMacro(<< "Cannot map " << numberOfBytes << " bytes at offset "
+                      << m_FileOffset << " of " << m_FileName << ": " << errorMessage);
+    }
+
+  void *buffer = static_cast< char * >( mapping.Address ) + delta;
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  m_Mappings[buffer] = mapping;
+  return buffer;
+}
+
+void
+MemoryMappedBufferAllocator
+::Deallocate(void *buffer, SizeValueType numberOfBytes)
+{
+  Mapping mapping;
+  bool    mapped = false;
+    {
+    MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+
+    MappingMapType::iterator it = m_Mappings.find(buffer);
+    if ( it != m_Mappings.end() )
+      {
+      mapping = it->second;
+      mapped = true;
+      m_Mappings.erase(it);
+      }
+    }
+
+  if ( mapped )
+    {
+    UnmapFile(mapping);
+    }
+  else
+    {
+    Superclass::Deallocate(buffer, numberOfBytes);
+    }
+}
+
+SizeValueType
+MemoryMappedBufferAllocator
+::GetNumberOfMappedBuffers() const
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  return static_cast< SizeValueType >( m_Mappings.size() );
+}
+
+#if defined( _WIN32 )
+
+void *
+MemoryMappedBufferAllocator
+::MapFile(SizeValueType offset, SizeValueType length, std::string & errorMessage) const
+{
+  HANDLE file = CreateFileA(m_FileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if ( file == INVALID_HANDLE_VALUE )
+    {
+    errorMessage = "the file cannot be opened";
+    return NULL;
+    }
+
+  LARGE_INTEGER fileSize;
+  if ( !GetFileSizeEx(file, &fileSize)
+       || static_cast< SizeValueType >( fileSize.QuadPart ) < offset + length )
+    {
+    CloseHandle(file);
+    errorMessage = "the file is too short";
+    return NULL;
+    }
+
+  // The view keeps the file mapping open once the handles are closed.
+  HANDLE fileMapping = CreateFileMapping(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+  void *address = NULL;
+  if ( fileMapping != NULL )
+    {
+    address = MapViewOfFile( fileMapping, FILE_MAP_COPY,
+                             static_cast< DWORD >( static_cast< ::itk::uint64_t >( offset ) >> 32 ),
+                             static_cast< DWORD >( offset & 0xffffffff ),
+                             static_cast< SIZE_T >( length ) );
+    CloseHandle(fileMapping);
+    }
+  CloseHandle(file);
+
+  if ( address == NULL )
+    {
+    errorMessage = "the file cannot be mapped";
+    }
+  return address;
+}
+
+void
+MemoryMappedBufferAllocator
+::UnmapFile(const Mapping & mapping)
+{
+  UnmapViewOfFile(mapping.Address);
+}
+
+SizeValueType
+MemoryMappedBufferAllocator
+::GetMappingGranularity()
+{
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  return static_cast< SizeValueType >( systemInfo.dwAllocationGranularity );
+}
+
+#else
+
+void *
+MemoryMappedBufferAllocator
+::MapFile(SizeValueType offset, SizeValueType length, std::string & errorMessage) const
+{
+  const int file = open(m_FileName.c_str(), O_RDONLY);
+  if ( file < 0 )
+    {
+    errorMessage = strerror(errno);
+    return NULL;
+    }
+
+  struct stat fileStatus;
+  if ( fstat(file, &fileStatus) != 0
+       || static_cast< SizeValueType >( fileStatus.st_size ) < offset + length )
+    {
+    close(file);
+    errorMessage = "the file is too short";
+    return NULL;
+    }
+
+  // The mapping keeps the file open once the descriptor is closed.
+  void *address = mmap( NULL, static_cast< size_t >( length ),
+                        PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                        file, static_cast< off_t >( offset ) );
+  if ( address == MAP_FAILED )
+    {
+    errorMessage = strerror(errno);
+    address = NULL;
+    }
+  close(file);
+  return address;
+}
+
+void
+MemoryMappedBufferAllocator
+::UnmapFile(const Mapping & mapping)
+{
+  munmap( mapping.Address, static_cast< size_t >( mapping.Length ) );
+}
+
+SizeValueType
+MemoryMappedBufferAllocator
+::GetMappingGranularity()
+{
+  return static_cast< SizeValueType >( sysconf(_SC_PAGESIZE) );
+}
+
+#endif
+
+void
+MemoryMappedBufferAllocator
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "FileOffset: " << m_FileOffset << std::endl;
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  os << indent << "NumberOfMappedBuffers: " << m_Mappings.size() << std::endl;
+}
+} // end namespace itk
@@ -48,6 +48,35 @@ ThreadIdType MultiThreader:: m_GlobalMaximumNumberOfThreads = ITK_MAX_THREADS;
 // => Not initialized.
 ThreadIdType MultiThreader:: m_GlobalDefaultNumberOfThreads = 0;
 
+// Initialize static members that control the global default use of the
+// thread pool : not initialized, read from the environment on first use.
+bool MultiThreader:: m_GlobalDefaultUseThreadPool = false;
+bool MultiThreader:: m_GlobalDefaultUseThreadPoolIsInitialized = false;
+
+void MultiThreader::SetGlobalDefaultUseThreadPool(bool use)
+{
+  m_GlobalDefaultUseThreadPool = use;
+  m_GlobalDefaultUseThreadPoolIsInitialized = true;
+}
+
+bool MultiThreader::GetGlobalDefaultUseThreadPool()
+{
+  if ( !m_GlobalDefaultUseThreadPoolIsInitialized )
+    {
+    itksys_stl::string itkUseThreadPoolEnv;
+    if ( itksys::SystemTools::GetEnv("ITK_USE_THREADPOOL", itkUseThreadPoolEnv) )
+      {
+      itkUseThreadPoolEnv = itksys::SystemTools::UpperCase(itkUseThreadPoolEnv);
+      m_GlobalDefaultUseThreadPool = ( itkUseThreadPoolEnv == "1"
+                                       || itkUseThreadPoolEnv == "ON"
+                                       || itkUseThreadPoolEnv == "YES"
+                                       || itkUseThreadPoolEnv == "TRUE" );
+      }
+    m_GlobalDefaultUseThreadPoolIsInitialized = true;
+    }
+  return m_GlobalDefaultUseThreadPool;
+}
+
 void MultiThreader::SetGlobalMaximumNumberOfThreads(ThreadIdType val)
 {
   m_GlobalMaximumNumberOfThreads = val;
@@ -196,11 +225,16 @@ MultiThreader::MultiThreader()
     m_SpawnedThreadActiveFlag[i]            = 0;
     m_SpawnedThreadActiveFlagLock[i]        = 0;
     m_SpawnedThreadInfoArray[i].ThreadID    = i;
+
+    m_ThreadJobArray[i].ThreadFunction      = 0;
+    m_ThreadJobArray[i].UserData            = 0;
+    m_ThreadJobArray[i].Completed           = true;
     }
 
   m_SingleMethod = 0;
   m_SingleData = 0;
   m_NumberOfThreads = this->GetGlobalDefaultNumberOfThreads();
+  m_UseThreadPool = this->GetGlobalDefaultUseThreadPool();
 }
 
 MultiThreader::~MultiThreader()
@@ -264,8 +298,7 @@ void MultiThreader::SingleMethodExecute()
       m_ThreadInfoArray[thread_loop].NumberOfThreads = m_NumberOfThreads;
       m_ThreadInfoArray[thread_loop].ThreadFunction = m_SingleMethod;
 
-      process_id[thread_loop] =
-        this->DispatchSingleMethodThread(&m_ThreadInfoArray[thread_loop]);
+      this->DispatchSingleMethod(thread_loop, &process_id[thread_loop]);
       }
     }
   catch ( std::exception & e )
@@ -300,7 +333,7 @@ void MultiThreader::SingleMethodExecute()
       {
       try
         {
-        this->WaitForSingleMethodThread(process_id[thread_loop]);
+        this->WaitForSingleMethod(thread_loop, &process_id[thread_loop]);
         }
       catch ( ... )
               {}
@@ -329,7 +362,7 @@ void MultiThreader::SingleMethodExecute()
     {
     try
       {
-      this->WaitForSingleMethodThread(process_id[thread_loop]);
+      this->WaitForSingleMethod(thread_loop, &process_id[thread_loop]);
       if ( m_ThreadInfoArray[thread_loop].ThreadExitCode
            != ThreadInfoStruct::SUCCESS )
         {
@@ -360,6 +393,38 @@ void MultiThreader::SingleMethodExecute()
       }
     }
 }
+
+void
+MultiThreader
+::DispatchSingleMethod(ThreadIdType threadIndex, ThreadProcessIDType *processId)
+{
+  if ( m_UseThreadPool )
+    {
+    ThreadPool::ThreadJob & job = m_ThreadJobArray[threadIndex];
+    job.ThreadFunction = this->SingleMethodProxy;
+    job.UserData = reinterpret_cast< void * >( &m_ThreadInfoArray[threadIndex] );
+    ThreadPool::GetInstance()->AddWork(&job);
+    }
+  else
+    {
+    *processId = this->DispatchSingleMethodThread(&m_ThreadInfoArray[threadIndex]);
+    }
+}
+
+void
+MultiThreader
+::WaitForSingleMethod(ThreadIdType threadIndex, ThreadProcessIDType *processId)
+{
+  if ( m_UseThreadPool )
+    {
+    ThreadPool::GetInstance()->WaitForJob(&m_ThreadJobArray[threadIndex]);
+    }
+  else
+    {
+    this->WaitForSingleMethodThread(*processId);
+    }
+}
+
 ITK_THREAD_RETURN_TYPE
 MultiThreader
 ::SingleMethodProxy(void *arg)
@@ -407,6 +472,7 @@ void MultiThreader::PrintSelf(std::ostream & os, Indent indent) const
      << m_GlobalMaximumNumberOfThreads << std::endl;
   os << indent << "Global Default Number Of Threads: "
      << m_GlobalDefaultNumberOfThreads << std::endl;
+  os << indent << "Use Thread Pool: " << ( m_UseThreadPool ? "On" : "Off" ) << std::endl;
 }
 
 
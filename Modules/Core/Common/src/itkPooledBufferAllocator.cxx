@@ -0,0 +1,230 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkPooledBufferAllocator.h"
+#include "itkMutexLockHolder.h"
+
+namespace itk
+{
+PooledBufferAllocator
+::PooledBufferAllocator():
+  m_NumberOfBytesHeld(0),
+  m_MaximumNumberOfBytesHeld(1024 * 1024 * 1024),
+  m_NumberOfHits(0),
+  m_NumberOfMisses(0)
+{}
+
+PooledBufferAllocator
+::~PooledBufferAllocator()
+{
+  this->Clear();
+}
+
+SizeValueType
+PooledBufferAllocator
+::GetBucketSize(SizeValueType numberOfBytes)
+{
+  if ( numberOfBytes < 16 )
+    {
+    return numberOfBytes;
+    }
+
+  // Keep the four most significant bits and round up the others.
+  SizeValueType step = 1;
+  for ( SizeValueType n = numberOfBytes >> 4; n > 0; n >>= 1 )
+    {
+    step <<= 1;
+    }
+  const SizeValueType bucketSize = ( numberOfBytes + step - 1 ) & ~( step - 1 );
+
+  // On overflow, do not round.
+  return bucketSize < numberOfBytes ? numberOfBytes : bucketSize;
+}
+
+void *
+PooledBufferAllocator
+::Allocate(SizeValueType numberOfBytes)
+{
+  const SizeValueType bucketSize = GetBucketSize(numberOfBytes);
+
+    {
+    MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+
+    for ( HeldBufferListType::iterator it = m_HeldBuffers.begin(); it != m_HeldBuffers.end(); ++it )
+      {
+      if ( it->NumberOfBytes == bucketSize )
+        {
+        void *buffer = it->Buffer;
+        m_NumberOfBytesHeld -= bucketSize;
+        m_HeldBuffers.erase(it);
+        ++m_NumberOfHits;
+        return buffer;
+        }
+      }
+    ++m_NumberOfMisses;
+    }
+
+  return Superclass::Allocate(bucketSize);
+}
+
+void
+PooledBufferAllocator
+::Deallocate(void *buffer, SizeValueType numberOfBytes)
+{
+  const SizeValueType bucketSize = GetBucketSize(numberOfBytes);
+
+  HeldBufferListType released;
+    {
+    MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+
+    if ( bucketSize <= m_MaximumNumberOfBytesHeld )
+      {
+      this->ReleaseHeldBuffers(m_MaximumNumberOfBytesHeld - bucketSize, released);
+
+      HeldBuffer held;
+      held.Buffer = buffer;
+      held.NumberOfBytes = bucketSize;
+      m_HeldBuffers.push_front(held);
+      m_NumberOfBytesHeld += bucketSize;
+      buffer = 0;
+      }
+    }
+
+  // Free outside of the lock.
+  this->FreeBuffers(released);
+  if ( buffer )
+    {
+    Superclass::Deallocate(buffer, bucketSize);
+    }
+}
+
+void
+PooledBufferAllocator
+::SetMaximumNumberOfBytesHeld(SizeValueType numberOfBytes)
+{
+  HeldBufferListType released;
+    {
+    MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+
+    if ( m_MaximumNumberOfBytesHeld == numberOfBytes )
+      {
+      return;
+      }
+    m_MaximumNumberOfBytesHeld = numberOfBytes;
+    this->ReleaseHeldBuffers(numberOfBytes, released);
+    }
+  this->FreeBuffers(released);
+  this->Modified();
+}
+
+SizeValueType
+PooledBufferAllocator
+::GetMaximumNumberOfBytesHeld() const
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  return m_MaximumNumberOfBytesHeld;
+}
+
+SizeValueType
+PooledBufferAllocator
+::GetNumberOfBytesHeld() const
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  return m_NumberOfBytesHeld;
+}
+
+SizeValueType
+PooledBufferAllocator
+::GetNumberOfBuffersHeld() const
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  return static_cast< SizeValueType >( m_HeldBuffers.size() );
+}
+
+SizeValueType
+PooledBufferAllocator
+::GetNumberOfHits() const
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  return m_NumberOfHits;
+}
+
+SizeValueType
+PooledBufferAllocator
+::GetNumberOfMisses() const
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  return m_NumberOfMisses;
+}
+
+void
+PooledBufferAllocator
+::ResetStatistics()
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  m_NumberOfHits = 0;
+  m_NumberOfMisses = 0;
+}
+
+void
+PooledBufferAllocator
+::Clear()
+{
+  HeldBufferListType released;
+    {
+    MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+    this->ReleaseHeldBuffers(0, released);
+    }
+  this->FreeBuffers(released);
+}
+
+void
+PooledBufferAllocator
+::ReleaseHeldBuffers(SizeValueType numberOfBytes, HeldBufferListType & released)
+{
+  while ( m_NumberOfBytesHeld > numberOfBytes )
+    {
+    m_NumberOfBytesHeld -= m_HeldBuffers.back().NumberOfBytes;
+    released.splice(released.end(), m_HeldBuffers, --m_HeldBuffers.end());
+    }
+}
+
+void
+PooledBufferAllocator
+::FreeBuffers(HeldBufferListType & buffers)
+{
+  for ( HeldBufferListType::iterator it = buffers.begin(); it != buffers.end(); ++it )
+    {
+    Superclass::Deallocate(it->Buffer, it->NumberOfBytes);
+    }
+  buffers.clear();
+}
+
+void
+PooledBufferAllocator
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  os << indent << "MaximumNumberOfBytesHeld: " << m_MaximumNumberOfBytesHeld << std::endl;
+  os << indent << "NumberOfBytesHeld: " << m_NumberOfBytesHeld << std::endl;
+  os << indent << "NumberOfBuffersHeld: " << m_HeldBuffers.size() << std::endl;
+  os << indent << "NumberOfHits: " << m_NumberOfHits << std::endl;
+  os << indent << "NumberOfMisses: " << m_NumberOfMisses << std::endl;
+}
+} // end namespace itk
@@ -0,0 +1,237 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkThreadPool.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkMutexLockHolder.h"
+
+#if defined(ITK_USE_PTHREADS)
+#include "itkThreadPoolPThreads.cxx"
+#elif defined(ITK_USE_WIN32_THREADS)
+#include "itkThreadPoolWinThreads.cxx"
+#else
+#include "itkThreadPoolNoThreads.cxx"
+#endif
+
+namespace itk
+{
+namespace
+{
+// Guards the creation of the process-wide instance.
+SimpleFastMutexLock threadPoolInstanceLock;
+}
+
+ThreadPool *ThreadPool::m_Instance = 0;
+
+ThreadPool::Pointer
+ThreadPool
+::GetInstance()
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(threadPoolInstanceLock);
+
+  if ( m_Instance == 0 )
+    {
+    // The reference count from new is never released, so that no worker
+    // is joined from a static destructor.
+    m_Instance = new ThreadPool;
+    }
+  return m_Instance;
+}
+
+ThreadPool
+::ThreadPool():
+  m_NumberOfIdleThreads(0),
+  m_Terminating(false),
+  m_UseCPUAffinity(false)
+{
+  m_WorkAvailable = ConditionVariable::New();
+  m_JobCompleted = ConditionVariable::New();
+}
+
+ThreadPool
+::~ThreadPool()
+{
+  this->Shutdown();
+}
+
+void
+ThreadPool
+::AddWork(ThreadJob *job)
+{
+  m_Mutex.Lock();
+  job->Completed = false;
+  m_JobQueue.push_back(job);
+
+  // Grow the pool when no idle worker is left to pick up the job, so
+  // that jobs dispatching further jobs never wait on each other.
+  if ( m_JobQueue.size() > m_NumberOfIdleThreads )
+    {
+    try
+      {
+      this->StartWorker();
+      }
+    catch ( ... )
+      {
+      m_JobQueue.pop_back();
+      job->Completed = true;
+      m_Mutex.Unlock();
+      throw;
+      }
+    }
+  m_WorkAvailable->Signal();
+  m_Mutex.Unlock();
+}
+
+void
+ThreadPool
+::WaitForJob(ThreadJob *job)
+{
+  m_Mutex.Lock();
+  while ( !job->Completed )
+    {
+    m_JobCompleted->Wait(&m_Mutex);
+    }
+  m_Mutex.Unlock();
+}
+
+void
+ThreadPool
+::SetNumberOfThreads(ThreadIdType numberOfThreads)
+{
+  if ( numberOfThreads < this->GetNumberOfThreads() )
+    {
+    this->Shutdown();
+    }
+
+  m_Mutex.Lock();
+  try
+    {
+    while ( m_Workers.size() < numberOfThreads )
+      {
+      this->StartWorker();
+      }
+    }
+  catch ( ... )
+    {
+    m_Mutex.Unlock();
+    throw;
+    }
+  m_Mutex.Unlock();
+}
+
+ThreadIdType
+ThreadPool
+::GetNumberOfThreads() const
+{
+  m_Mutex.Lock();
+  const ThreadIdType numberOfThreads = static_cast< ThreadIdType >( m_Workers.size() );
+  m_Mutex.Unlock();
+  return numberOfThreads;
+}
+
+void
+ThreadPool
+::Shutdown()
+{
+  std::vector< ThreadProcessIDType > workers;
+
+  m_Mutex.Lock();
+  m_Terminating = true;
+  m_WorkAvailable->Broadcast();
+  workers.swap(m_Workers);
+  m_Mutex.Unlock();
+
+  // Workers only exit once the queue is empty, so every job queued before
+  // the shutdown still runs to completion.
+  for ( std::vector< ThreadProcessIDType >::iterator it = workers.begin();
+        it != workers.end(); ++it )
+    {
+    this->JoinWorkerThread(*it);
+    }
+
+  m_Mutex.Lock();
+  m_Terminating = false;
+  m_Mutex.Unlock();
+}
+
+void
+ThreadPool
+::StartWorker()
+{
+  const ThreadIdType workerIndex = static_cast< ThreadIdType >( m_Workers.size() );
+
+  m_Workers.push_back( this->CreateWorkerThread(workerIndex) );
+}
+
+ITK_THREAD_RETURN_TYPE
+ThreadPool
+::WorkerMain(void *arg)
+{
+  ThreadPool *pool = reinterpret_cast< ThreadPool * >( arg );
+
+  pool->m_Mutex.Lock();
+  while ( true )
+    {
+    while ( pool->m_JobQueue.empty() && !pool->m_Terminating )
+      {
+      ++pool->m_NumberOfIdleThreads;
+      pool->m_WorkAvailable->Wait(&pool->m_Mutex);
+      --pool->m_NumberOfIdleThreads;
+      }
+    if ( pool->m_JobQueue.empty() )
+      {
+      break;
+      }
+
+    ThreadJob *job = pool->m_JobQueue.front();
+    pool->m_JobQueue.pop_front();
+    pool->m_Mutex.Unlock();
+
+    // Jobs are expected to handle their own exceptions (as
+    // MultiThreader::SingleMethodProxy does); anything escaping here
+    // must not take the worker down with it.
+    try
+      {
+      ( *job->ThreadFunction )( job->UserData );
+      }
+    catch ( ... )
+      {
+      }
+
+    pool->m_Mutex.Lock();
+    job->Completed = true;
+    pool->m_JobCompleted->Broadcast();
+    }
+  pool->m_Mutex.Unlock();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void
+ThreadPool
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  m_Mutex.Lock();
+  os << indent << "Number Of Threads: " << m_Workers.size() << std::endl;
+  os << indent << "Number Of Idle Threads: " << m_NumberOfIdleThreads << std::endl;
+  os << indent << "Number Of Queued Jobs: " << m_JobQueue.size() << std::endl;
+  m_Mutex.Unlock();
+  os << indent << "Use CPU Affinity: " << ( m_UseCPUAffinity ? "On" : "Off" ) << std::endl;
+}
+} // end namespace itk
@@ -0,0 +1,82 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkThreadPool.h"
+#include "itkObjectFactory.h"
+#include <unistd.h>
+#include <sched.h>
+
+namespace itk
+{
+extern "C"
+{
+typedef void *( *ThreadPoolWorkerFunctionType )(void *);
+}
+
+ThreadProcessIDType
+ThreadPool
+::CreateWorkerThread(ThreadIdType workerIndex)
+{
+  pthread_attr_t attr;
+  pthread_t      threadHandle;
+
+  pthread_attr_init(&attr);
+#if !defined( __CYGWIN__ )
+  pthread_attr_setscope(&attr, PTHREAD_SCOPE_SYSTEM);
+#endif
+
+  const int threadError =
+    pthread_create( &threadHandle, &attr,
+                    reinterpret_cast< ThreadPoolWorkerFunctionType >( &ThreadPool::WorkerMain ),
+                    reinterpret_cast< void * >( this ) );
+  pthread_attr_destroy(&attr);
+  if ( threadError != 0 )
+    {
+    itkExceptionMacro(<< "Unable to create a thread.  pthread_create() returned "
+                      << threadError);
+    }
+
+#if defined( __linux__ ) && defined( CPU_SET )
+  if ( m_UseCPUAffinity )
+    {
+    const long numberOfProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+    if ( numberOfProcessors > 0 )
+      {
+      cpu_set_t cpuSet;
+      CPU_ZERO(&cpuSet);
+      CPU_SET(workerIndex % numberOfProcessors, &cpuSet);
+      // Failing to pin is not fatal, the worker simply floats.
+      pthread_setaffinity_np(threadHandle, sizeof( cpu_set_t ), &cpuSet);
+      }
+    }
+#else
+  (void)workerIndex;
+#endif
+
+  return threadHandle;
+}
+
+void
+ThreadPool
+::JoinWorkerThread(ThreadProcessIDType threadHandle)
+{
+  if ( pthread_join(threadHandle, 0) )
+    {
+    itkExceptionMacro(<< "Unable to join thread.");
+    }
+}
+} // end namespace itk
@@ -0,0 +1,59 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkThreadPool.h"
+#include "itkObjectFactory.h"
+
+#include "itkWindows.h"
+#include <process.h>
+
+namespace itk
+{
+ThreadProcessIDType
+ThreadPool
+::CreateWorkerThread(ThreadIdType workerIndex)
+{
+  // Using _beginthreadex on a PC
+  DWORD  threadId;
+  HANDLE threadHandle = (HANDLE)_beginthreadex(0, 0,
+                                               ( unsigned int (__stdcall *)(void *) ) &ThreadPool::WorkerMain,
+                                               ( (void *)this ), 0, (unsigned int *)&threadId);
+  if ( threadHandle == NULL )
+    {
+    itkExceptionMacro("Error in thread creation !!!");
+    }
+
+  if ( m_UseCPUAffinity )
+    {
+    SYSTEM_INFO sysInfo;
+    GetSystemInfo(&sysInfo);
+    const DWORD processor = workerIndex % sysInfo.dwNumberOfProcessors;
+    // Failing to pin is not fatal, the worker simply floats.
+    SetThreadAffinityMask(threadHandle, static_cast< DWORD_PTR >( 1 ) << processor);
+    }
+
+  return threadHandle;
+}
+
+void
+ThreadPool
+::JoinWorkerThread(ThreadProcessIDType threadHandle)
+{
+  WaitForSingleObject(threadHandle, INFINITE);
+  CloseHandle(threadHandle);
+}
+} // end namespace itk
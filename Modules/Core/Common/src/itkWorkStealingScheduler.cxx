@@ -0,0 +1,148 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkWorkStealingScheduler.h"
+#include "itkMutexLockHolder.h"
+
+namespace itk
+{
+WorkStealingScheduler
+::WorkStealingScheduler():
+  m_NumberOfPieces(0),
+  m_NumberOfThreads(0)
+{
+  for ( ThreadIdType i = 0; i < ITK_MAX_THREADS; i++ )
+    {
+    m_Ranges[i].Begin = 0;
+    m_Ranges[i].End = 0;
+    m_Ranges[i].Stolen = 0;
+    }
+}
+
+void
+WorkStealingScheduler
+::Initialize(SizeValueType numberOfPieces, ThreadIdType numberOfThreads)
+{
+  if ( numberOfThreads < 1 )
+    {
+    numberOfThreads = 1;
+    }
+  if ( numberOfThreads > ITK_MAX_THREADS )
+    {
+    numberOfThreads = ITK_MAX_THREADS;
+    }
+
+  m_NumberOfPieces = numberOfPieces;
+  m_NumberOfThreads = numberOfThreads;
+
+  // Deal out contiguous ranges, the first (numberOfPieces % numberOfThreads)
+  // threads getting one extra piece.
+  const SizeValueType piecesPerThread = numberOfPieces / numberOfThreads;
+  const SizeValueType remainder = numberOfPieces % numberOfThreads;
+
+  SizeValueType begin = 0;
+  for ( ThreadIdType i = 0; i < ITK_MAX_THREADS; i++ )
+    {
+    MutexLockHolder< SimpleFastMutexLock > holder(m_Ranges[i].Lock);
+    SizeValueType count = 0;
+    if ( i < numberOfThreads )
+      {
+      count = piecesPerThread + ( i < remainder ? 1 : 0 );
+      }
+    m_Ranges[i].Begin = begin;
+    m_Ranges[i].End = begin + count;
+    m_Ranges[i].Stolen = 0;
+    begin += count;
+    }
+}
+
+bool
+WorkStealingScheduler
+::GetNextPiece(ThreadIdType threadId, SizeValueType & piece)
+{
+  if ( threadId >= m_NumberOfThreads )
+    {
+    return false;
+    }
+
+  PieceRange & range = m_Ranges[threadId];
+  while ( true )
+    {
+      {
+      MutexLockHolder< SimpleFastMutexLock > holder(range.Lock);
+      if ( range.Begin < range.End )
+        {
+        piece = range.Begin++;
+        return true;
+        }
+      }
+    if ( !this->Steal(threadId) )
+      {
+      return false;
+      }
+    }
+}
+
+bool
+WorkStealingScheduler
+::Steal(ThreadIdType threadId)
+{
+  // Visit the other threads starting with the next one, so that the
+  // thieves spread out over the victims.
+  for ( ThreadIdType offset = 1; offset < m_NumberOfThreads; offset++ )
+    {
+    PieceRange & victim = m_Ranges[( threadId + offset ) % m_NumberOfThreads];
+    SizeValueType begin;
+    SizeValueType end;
+      {
+      MutexLockHolder< SimpleFastMutexLock > holder(victim.Lock);
+      if ( victim.Begin >= victim.End )
+        {
+        continue;
+        }
+      const SizeValueType remaining = victim.End - victim.Begin;
+      // Take the back half, rounding up so a single remaining piece can
+      // be stolen as well.
+      end = victim.End;
+      begin = victim.End - ( remaining + 1 ) / 2;
+      victim.End = begin;
+      }
+
+    PieceRange & range = m_Ranges[threadId];
+    MutexLockHolder< SimpleFastMutexLock > holder(range.Lock);
+    range.Begin = begin;
+    range.End = end;
+    range.Stolen += end - begin;
+    return true;
+    }
+  return false;
+}
+
+SizeValueType
+WorkStealingScheduler
+::GetNumberOfStolenPieces() const
+{
+  SizeValueType stolen = 0;
+
+  for ( ThreadIdType i = 0; i < m_NumberOfThreads; i++ )
+    {
+    MutexLockHolder< const SimpleFastMutexLock > holder(m_Ranges[i].Lock);
+    stolen += m_Ranges[i].Stolen;
+    }
+  return stolen;
+}
+} // end namespace itk
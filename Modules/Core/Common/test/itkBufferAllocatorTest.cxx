@@ -0,0 +1,170 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkBufferAllocator.h"
+#include "itkImage.h"
+#include "itkRGBAPixel.h"
+#include "itkVariableLengthVector.h"
+
+namespace
+{
+// Counts constructions and destructions, and is therefore not
+// trivially constructible.
+class BufferAllocatorTestElement
+{
+public:
+  BufferAllocatorTestElement():m_Value(7) { ++m_NumberOfLiveElements; }
+  BufferAllocatorTestElement(const BufferAllocatorTestElement & other):m_Value(other.m_Value)
+  { ++m_NumberOfLiveElements; }
+  ~BufferAllocatorTestElement() { --m_NumberOfLiveElements; }
+
+  int        m_Value;
+  static int m_NumberOfLiveElements;
+};
+
+int BufferAllocatorTestElement::m_NumberOfLiveElements = 0;
+
+template< class TImage >
+bool IsAligned(TImage *image, itk::SizeValueType alignment)
+{
+  const size_t address = reinterpret_cast< size_t >( image->GetBufferPointer() );
+  if ( address % alignment != 0 )
+    {
+    std::cerr << "Buffer " << image->GetBufferPointer() << " is not aligned to "
+              << alignment << " bytes" << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+int itkBufferAllocatorTest(int, char *[])
+{
+  if ( itk::BufferAllocator::GetGlobalDefault() != 0 )
+    {
+    std::cerr << "Expected no global default allocator" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if ( !itk::BufferElementTraits< float >::IsTriviallyConstructible
+       || !itk::BufferElementTraits< itk::RGBAPixel< unsigned char > >::IsTriviallyConstructible
+       || itk::BufferElementTraits< itk::VariableLengthVector< float > >::IsTriviallyConstructible
+       || itk::BufferElementTraits< BufferAllocatorTestElement >::IsTriviallyConstructible )
+    {
+    std::cerr << "Unexpected BufferElementTraits" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itk::BufferAllocator::Pointer allocator = itk::BufferAllocator::New();
+  allocator->SetAlignment(128);
+  allocator->Print(std::cout);
+  itk::BufferAllocator::SetGlobalDefault(allocator);
+
+  typedef itk::Image< float, 3 > FloatImageType;
+  FloatImageType::SizeType size;
+  size.Fill(200);
+  FloatImageType::RegionType region(size);
+
+  // large enough to be touched in parallel
+  FloatImageType::Pointer floatImage = FloatImageType::New();
+  floatImage->SetRegions(region);
+  floatImage->Allocate();
+  if ( !IsAligned( floatImage.GetPointer(), 128 ) )
+    {
+    return EXIT_FAILURE;
+    }
+  floatImage->FillBuffer(1.5f);
+
+  // growing the buffer keeps the contents and the alignment
+  FloatImageType::PixelContainer *container = floatImage->GetPixelContainer();
+  container->Reserve( container->Size() * 2 );
+  if ( !IsAligned( floatImage.GetPointer(), 128 ) || ( *container )[10] != 1.5f )
+    {
+    std::cerr << "Reserve() did not preserve the buffer" << std::endl;
+    return EXIT_FAILURE;
+    }
+  container->Reserve( container->Size() / 2 );
+  container->Squeeze();
+  if ( !IsAligned( floatImage.GetPointer(), 128 ) || ( *container )[10] != 1.5f )
+    {
+    std::cerr << "Squeeze() did not preserve the buffer" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // memory imported with new[] is released with delete[], even when an
+  // allocator is set
+  container->SetImportPointer(new float[10], 10, true);
+  container->Initialize();
+
+  typedef itk::Image< itk::RGBAPixel< unsigned char >, 2 > RGBAImageType;
+  RGBAImageType::Pointer rgbaImage = RGBAImageType::New();
+  RGBAImageType::SizeType rgbaSize;
+  rgbaSize.Fill(17);
+  rgbaImage->SetRegions(rgbaSize);
+  rgbaImage->Allocate();
+  if ( !IsAligned( rgbaImage.GetPointer(), 128 ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // non-trivial elements are constructed and destroyed
+  typedef itk::Image< BufferAllocatorTestElement, 2 > ElementImageType;
+  ElementImageType::SizeType elementSize;
+  elementSize.Fill(10);
+  {
+  ElementImageType::Pointer elementImage = ElementImageType::New();
+  elementImage->SetRegions(elementSize);
+  elementImage->Allocate();
+  if ( BufferAllocatorTestElement::m_NumberOfLiveElements != 100
+       || elementImage->GetPixelContainer()->GetBufferPointer()[42].m_Value != 7 )
+    {
+    std::cerr << "Elements were not constructed: "
+              << BufferAllocatorTestElement::m_NumberOfLiveElements << std::endl;
+    return EXIT_FAILURE;
+    }
+  elementImage->GetPixelContainer()->Print(std::cout);
+  }
+  if ( BufferAllocatorTestElement::m_NumberOfLiveElements != 0 )
+    {
+    std::cerr << "Elements were not destroyed: "
+              << BufferAllocatorTestElement::m_NumberOfLiveElements << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // the allocator rejects alignments that are not a power of two
+  allocator->SetAlignment(48);
+  bool caught = false;
+  try
+    {
+    allocator->Allocate(10);
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cout << "Caught expected exception: " << e.GetDescription() << std::endl;
+    caught = true;
+    }
+  if ( !caught )
+    {
+    std::cerr << "Invalid alignment was accepted" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itk::BufferAllocator::SetGlobalDefault(0);
+
+  std::cout << "[TEST PASSED]" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,203 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageSource.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkWorkStealingScheduler.h"
+
+namespace itk
+{
+/** Source that increments every pixel of the region it is asked to
+ * generate, with a cost that grows along the last axis. */
+template< class TOutputImage >
+class DynamicMultiThreadingTestSource:public ImageSource< TOutputImage >
+{
+public:
+  typedef DynamicMultiThreadingTestSource Self;
+  typedef ImageSource< TOutputImage >     Superclass;
+  typedef SmartPointer< Self >            Pointer;
+  typedef SmartPointer< const Self >      ConstPointer;
+
+  itkNewMacro(Self);
+  itkTypeMacro(DynamicMultiThreadingTestSource, ImageSource);
+
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+  unsigned int GetNumberOfThreadedCalls() const
+  {
+    return m_NumberOfThreadedCalls;
+  }
+
+protected:
+  DynamicMultiThreadingTestSource():m_NumberOfThreadedCalls(0) {}
+
+  void GenerateOutputInformation()
+  {
+    typename TOutputImage::SizeType size;
+    size.Fill(32);
+    typename TOutputImage::RegionType region;
+    region.SetSize(size);
+    this->GetOutput()->SetLargestPossibleRegion(region);
+  }
+
+  void BeforeThreadedGenerateData()
+  {
+    this->GetOutput()->FillBuffer(0);
+    m_NumberOfThreadedCalls = 0;
+  }
+
+  void ThreadedGenerateData(const OutputImageRegionType & region, ThreadIdType)
+  {
+    const unsigned int lastAxis = TOutputImage::ImageDimension - 1;
+
+    ImageRegionIterator< TOutputImage > it(this->GetOutput(), region);
+    double sum = 0.0;
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      for ( IndexValueType i = 0; i < it.GetIndex()[lastAxis] * 10; i++ )
+        {
+        sum += vcl_sqrt( static_cast< double >( i ) );
+        }
+      it.Set( it.Get() + ( sum >= 0.0 ? 1 : 0 ) );
+      }
+
+    m_Lock.Lock();
+    ++m_NumberOfThreadedCalls;
+    m_Lock.Unlock();
+  }
+
+private:
+  SimpleFastMutexLock m_Lock;
+  unsigned int        m_NumberOfThreadedCalls;
+};
+}
+
+namespace
+{
+template< class TImage >
+bool EveryPixelGeneratedOnce(const TImage *image)
+{
+  itk::ImageRegionConstIterator< TImage > it( image, image->GetLargestPossibleRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != 1 )
+      {
+      std::cerr << "Pixel " << it.GetIndex() << " was generated "
+                << it.Get() << " times" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkImageSourceDynamicMultiThreadingTest(int, char *[])
+{
+  typedef itk::Image< int, 3 >                                ImageType;
+  typedef itk::DynamicMultiThreadingTestSource< ImageType > SourceType;
+
+  const itk::ThreadIdType numberOfThreads = 4;
+
+  SourceType::Pointer source = SourceType::New();
+  source->SetNumberOfThreads(numberOfThreads);
+
+  // Static splitting: one piece per thread.
+  source->Update();
+  if ( !EveryPixelGeneratedOnce( source->GetOutput() ) )
+    {
+    return EXIT_FAILURE;
+    }
+  if ( source->GetNumberOfThreadedCalls() != numberOfThreads )
+    {
+    std::cerr << "Expected " << numberOfThreads << " ThreadedGenerateData calls, got "
+              << source->GetNumberOfThreadedCalls() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Dynamic splitting: many pieces handed out on demand.
+  source->DynamicMultiThreadingOn();
+  source->SetNumberOfPiecesPerThread(4);
+  source->Modified();
+  source->Update();
+  if ( !EveryPixelGeneratedOnce( source->GetOutput() ) )
+    {
+    return EXIT_FAILURE;
+    }
+  if ( source->GetNumberOfThreadedCalls() != numberOfThreads * 4 )
+    {
+    std::cerr << "Expected " << numberOfThreads * 4 << " ThreadedGenerateData calls, got "
+              << source->GetNumberOfThreadedCalls() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // More pieces than slices along the split axis.
+  source->SetNumberOfPiecesPerThread(100);
+  source->Modified();
+  source->Update();
+  if ( !EveryPixelGeneratedOnce( source->GetOutput() ) )
+    {
+    return EXIT_FAILURE;
+    }
+  if ( source->GetNumberOfThreadedCalls() != 32 )
+    {
+    std::cerr << "Expected 32 ThreadedGenerateData calls, got "
+              << source->GetNumberOfThreadedCalls() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  source->Print(std::cout);
+
+  // The scheduler hands out every piece exactly once, and idle threads
+  // steal from busy ones.
+  itk::WorkStealingScheduler scheduler;
+  scheduler.Initialize(10, 3);
+  std::vector< unsigned int > handedOut(10, 0);
+  itk::SizeValueType piece;
+  // thread 0 drains its own range and then steals everything else
+  while ( scheduler.GetNextPiece(0, piece) )
+    {
+    ++handedOut[piece];
+    }
+  if ( scheduler.GetNextPiece(1, piece) || scheduler.GetNextPiece(2, piece) )
+    {
+    std::cerr << "Scheduler handed out a piece after exhaustion" << std::endl;
+    return EXIT_FAILURE;
+    }
+  for ( unsigned int i = 0; i < handedOut.size(); i++ )
+    {
+    if ( handedOut[i] != 1 )
+      {
+      std::cerr << "Piece " << i << " handed out " << handedOut[i] << " times" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  if ( scheduler.GetNumberOfStolenPieces() != 6 )
+    {
+    std::cerr << "Expected 6 stolen pieces, got " << scheduler.GetNumberOfStolenPieces() << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( scheduler.GetNextPiece(numberOfThreads + 1, piece) )
+    {
+    std::cerr << "Scheduler handed out a piece to an unknown thread" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "[TEST PASSED]" << std::endl;
+  return EXIT_SUCCESS;
+}
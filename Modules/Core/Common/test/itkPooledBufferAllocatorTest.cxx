@@ -0,0 +1,199 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkPooledBufferAllocator.h"
+#include "itkImage.h"
+#include "itkMultiThreader.h"
+
+namespace
+{
+bool CheckStatistics(const itk::PooledBufferAllocator *pool,
+                     itk::SizeValueType hits, itk::SizeValueType misses,
+                     itk::SizeValueType buffersHeld)
+{
+  if ( pool->GetNumberOfHits() != hits
+       || pool->GetNumberOfMisses() != misses
+       || pool->GetNumberOfBuffersHeld() != buffersHeld )
+    {
+    std::cerr << "Expected " << hits << " hits, " << misses << " misses and "
+              << buffersHeld << " buffers held, got "
+              << pool->GetNumberOfHits() << ", " << pool->GetNumberOfMisses()
+              << " and " << pool->GetNumberOfBuffersHeld() << std::endl;
+    return false;
+    }
+  return true;
+}
+
+ITK_THREAD_RETURN_TYPE AllocateAndReleaseCallback(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct *info =
+    static_cast< itk::MultiThreader::ThreadInfoStruct * >( arg );
+  itk::PooledBufferAllocator *pool =
+    static_cast< itk::PooledBufferAllocator * >( info->UserData );
+
+  for ( unsigned int i = 0; i < 1000; ++i )
+    {
+    const itk::SizeValueType numberOfBytes = 1000 + 100 * ( ( i + info->ThreadID ) % 5 );
+    char *buffer = static_cast< char * >( pool->Allocate(numberOfBytes) );
+    buffer[0] = buffer[numberOfBytes - 1] = static_cast< char >( info->ThreadID );
+    pool->Deallocate(buffer, numberOfBytes);
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+}
+
+int itkPooledBufferAllocatorTest(int, char *[])
+{
+  // Buckets keep the four most significant bits.
+  const itk::SizeValueType sizes[][2] = {
+      { 0, 0 }, { 15, 15 }, { 16, 16 }, { 17, 18 }, { 31, 32 },
+      { 1000, 1024 }, { 1025, 1152 }, { 4097, 4608 }
+  };
+  for ( unsigned int i = 0; i < sizeof( sizes ) / sizeof( sizes[0] ); ++i )
+    {
+    if ( itk::PooledBufferAllocator::GetBucketSize(sizes[i][0]) != sizes[i][1] )
+      {
+      std::cerr << "Bucket size of " << sizes[i][0] << " is "
+                << itk::PooledBufferAllocator::GetBucketSize(sizes[i][0])
+                << ", expected " << sizes[i][1] << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  itk::PooledBufferAllocator::Pointer pool = itk::PooledBufferAllocator::New();
+  itk::BufferAllocator::SetGlobalDefault(pool);
+
+  typedef itk::Image< float, 3 > ImageType;
+  ImageType::SizeType size;
+  size.Fill(64);
+  ImageType::RegionType region(size);
+  const itk::SizeValueType imageBytes = region.GetNumberOfPixels() * sizeof( float );
+
+  // Releasing the data of an image returns its buffer to the pool, and
+  // the next image of the same size reuses it.
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  float *firstBuffer = image->GetBufferPointer();
+  if ( !CheckStatistics(pool, 0, 1, 0) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  image->ReleaseData();
+  if ( !CheckStatistics(pool, 0, 1, 1) || pool->GetNumberOfBytesHeld() != imageBytes )
+    {
+    return EXIT_FAILURE;
+    }
+
+  for ( unsigned int i = 0; i < 5; ++i )
+    {
+    image->SetRegions(region);
+    image->Allocate();
+    if ( image->GetBufferPointer() != firstBuffer )
+      {
+      std::cerr << "Buffer was not reused" << std::endl;
+      return EXIT_FAILURE;
+      }
+    image->FillBuffer(i);
+    image->ReleaseData();
+    }
+  if ( !CheckStatistics(pool, 5, 1, 1) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Two images alive at the same time need two buffers.
+  ImageType::Pointer image1 = ImageType::New();
+  image1->SetRegions(region);
+  image1->Allocate();
+  ImageType::Pointer image2 = ImageType::New();
+  image2->SetRegions(region);
+  image2->Allocate();
+  if ( !CheckStatistics(pool, 6, 2, 0) )
+    {
+    return EXIT_FAILURE;
+    }
+  image1 = 0;
+  image2 = 0;
+  if ( !CheckStatistics(pool, 6, 2, 2) || pool->GetNumberOfBytesHeld() != 2 * imageBytes )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Lowering the limit frees the least recently returned buffers, and
+  // buffers above the limit are not kept.
+  pool->SetMaximumNumberOfBytesHeld(imageBytes);
+  if ( !CheckStatistics(pool, 6, 2, 1) )
+    {
+    return EXIT_FAILURE;
+    }
+  pool->SetMaximumNumberOfBytesHeld(imageBytes / 2);
+  if ( !CheckStatistics(pool, 6, 2, 0) || pool->GetNumberOfBytesHeld() != 0 )
+    {
+    return EXIT_FAILURE;
+    }
+  image->SetRegions(region);
+  image->Allocate();
+  image->ReleaseData();
+  if ( !CheckStatistics(pool, 6, 3, 0) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Different sizes in the same bucket share buffers.
+  pool->SetMaximumNumberOfBytesHeld(1024 * 1024);
+  pool->ResetStatistics();
+  pool->Deallocate(pool->Allocate(1000), 1000);
+  pool->Deallocate(pool->Allocate(1020), 1020);
+  pool->Deallocate(pool->Allocate(1100), 1100);
+  if ( !CheckStatistics(pool, 1, 2, 2) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Concurrent use.
+  pool->Clear();
+  pool->ResetStatistics();
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads(4);
+  threader->SetSingleMethod(AllocateAndReleaseCallback, pool.GetPointer());
+  threader->SingleMethodExecute();
+  const itk::SizeValueType numberOfCalls = 1000 * threader->GetNumberOfThreads();
+  if ( pool->GetNumberOfHits() + pool->GetNumberOfMisses() != numberOfCalls
+       || pool->GetNumberOfMisses() > 5 * threader->GetNumberOfThreads() )
+    {
+    std::cerr << "Unexpected statistics after concurrent use: "
+              << pool->GetNumberOfHits() << " hits, "
+              << pool->GetNumberOfMisses() << " misses" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  pool->Print(std::cout);
+
+  itk::BufferAllocator::SetGlobalDefault(0);
+  image = 0;
+  pool->Clear();
+  if ( pool->GetNumberOfBytesHeld() != 0 )
+    {
+    std::cerr << "Clear() did not free the held buffers" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,239 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkThreadPool.h"
+#include "itkMultiThreader.h"
+
+namespace
+{
+
+class ThreadPoolTestUserData
+{
+public:
+  itk::SimpleMutexLock m_Mutex;
+  unsigned int         m_Counter;
+  unsigned int         m_Visited[ITK_MAX_THREADS];
+
+  ThreadPoolTestUserData()
+  {
+    this->Reset();
+  }
+
+  void Reset()
+  {
+    m_Counter = 0;
+    for ( unsigned int i = 0; i < ITK_MAX_THREADS; i++ )
+      {
+      m_Visited[i] = 0;
+      }
+  }
+};
+
+ITK_THREAD_RETURN_TYPE ThreadPoolTestJob( void *ptr )
+{
+  ThreadPoolTestUserData *data = static_cast< ThreadPoolTestUserData * >( ptr );
+
+  data->m_Mutex.Lock();
+  ++data->m_Counter;
+  data->m_Mutex.Unlock();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+ITK_THREAD_RETURN_TYPE ThreadPoolTestSingleMethod( void *ptr )
+{
+  itk::MultiThreader::ThreadInfoStruct *info = static_cast< itk::MultiThreader::ThreadInfoStruct * >( ptr );
+  ThreadPoolTestUserData *data = static_cast< ThreadPoolTestUserData * >( info->UserData );
+
+  data->m_Mutex.Lock();
+  ++data->m_Counter;
+  ++data->m_Visited[info->ThreadID];
+  data->m_Mutex.Unlock();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+// Each thread starts a nested SingleMethodExecute, which must not deadlock
+// on the shared pool.
+ITK_THREAD_RETURN_TYPE ThreadPoolTestNestedMethod( void *ptr )
+{
+  itk::MultiThreader::ThreadInfoStruct *info = static_cast< itk::MultiThreader::ThreadInfoStruct * >( ptr );
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads( info->NumberOfThreads );
+  threader->SetSingleMethod( ThreadPoolTestSingleMethod, info->UserData );
+  threader->SingleMethodExecute();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+ITK_THREAD_RETURN_TYPE ThreadPoolTestThrowingMethod( void *ptr )
+{
+  itk::MultiThreader::ThreadInfoStruct *info = static_cast< itk::MultiThreader::ThreadInfoStruct * >( ptr );
+
+  if ( info->ThreadID == info->NumberOfThreads - 1 )
+    {
+    itkGenericExceptionMacro( "Expected exception from thread " << info->ThreadID );
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+bool CheckSingleMethodExecute( itk::MultiThreader *threader, ThreadPoolTestUserData & data,
+                               const char *description )
+{
+  const itk::ThreadIdType numberOfThreads = threader->GetNumberOfThreads();
+
+  data.Reset();
+  threader->SetSingleMethod( ThreadPoolTestSingleMethod, &data );
+  threader->SingleMethodExecute();
+
+  bool passed = ( data.m_Counter == numberOfThreads );
+  for ( itk::ThreadIdType i = 0; i < numberOfThreads; i++ )
+    {
+    passed &= ( data.m_Visited[i] == 1 );
+    }
+  if ( !passed )
+    {
+    std::cerr << "SingleMethodExecute " << description << " visited "
+              << data.m_Counter << " threads instead of " << numberOfThreads << std::endl;
+    }
+  return passed;
+}
+
+}
+
+int itkThreadPoolTest(int argc, char *argv[])
+{
+  itk::ThreadIdType numberOfThreads = 4;
+  if ( argc > 1 )
+    {
+    numberOfThreads = ::atoi( argv[1] );
+    }
+
+  bool passed = true;
+
+  ThreadPoolTestUserData data;
+
+  try
+    {
+    itk::ThreadPool::Pointer pool = itk::ThreadPool::GetInstance();
+    if ( pool != itk::ThreadPool::GetInstance() )
+      {
+      std::cerr << "GetInstance() does not return a unique instance" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // Pre-start the workers and exercise the raw job interface.
+    pool->UseCPUAffinityOn();
+    pool->SetNumberOfThreads( numberOfThreads );
+    if ( pool->GetNumberOfThreads() != numberOfThreads )
+      {
+      std::cerr << "Expected " << numberOfThreads << " workers, got "
+                << pool->GetNumberOfThreads() << std::endl;
+      passed = false;
+      }
+
+    const unsigned int numberOfJobs = 100;
+    std::vector< itk::ThreadPool::ThreadJob > jobs( numberOfJobs );
+    for ( unsigned int i = 0; i < numberOfJobs; i++ )
+      {
+      jobs[i].ThreadFunction = ThreadPoolTestJob;
+      jobs[i].UserData = &data;
+      pool->AddWork( &jobs[i] );
+      }
+    for ( unsigned int i = 0; i < numberOfJobs; i++ )
+      {
+      pool->WaitForJob( &jobs[i] );
+      }
+    if ( data.m_Counter != numberOfJobs )
+      {
+      std::cerr << "Executed " << data.m_Counter << " jobs instead of " << numberOfJobs << std::endl;
+      passed = false;
+      }
+
+    // SingleMethodExecute with and without the pool.
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    threader->SetNumberOfThreads( numberOfThreads );
+
+    threader->UseThreadPoolOn();
+    passed &= CheckSingleMethodExecute( threader, data, "with thread pool" );
+    threader->UseThreadPoolOff();
+    passed &= CheckSingleMethodExecute( threader, data, "without thread pool" );
+
+    // Shrinking and shutting down the pool; it must restart on demand.
+    pool->UseCPUAffinityOff();
+    pool->SetNumberOfThreads( 1 );
+    pool->Shutdown();
+    if ( pool->GetNumberOfThreads() != 0 )
+      {
+      std::cerr << "Shutdown() left " << pool->GetNumberOfThreads() << " workers" << std::endl;
+      passed = false;
+      }
+    threader->UseThreadPoolOn();
+    passed &= CheckSingleMethodExecute( threader, data, "after shutdown" );
+
+    // Nested dispatch grows the pool instead of deadlocking.
+    data.Reset();
+    threader->SetSingleMethod( ThreadPoolTestNestedMethod, &data );
+    threader->SingleMethodExecute();
+    if ( data.m_Counter != numberOfThreads * numberOfThreads )
+      {
+      std::cerr << "Nested SingleMethodExecute visited " << data.m_Counter
+                << " threads instead of " << numberOfThreads * numberOfThreads << std::endl;
+      passed = false;
+      }
+
+    pool->Print( std::cout );
+    threader->Print( std::cout );
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Exceptions thrown by pooled threads are reported to the caller.
+  if ( numberOfThreads > 1 )
+    {
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    threader->SetNumberOfThreads( numberOfThreads );
+    threader->UseThreadPoolOn();
+    threader->SetSingleMethod( ThreadPoolTestThrowingMethod, &data );
+    try
+      {
+      threader->SingleMethodExecute();
+      std::cerr << "Exception from a pooled thread was not propagated" << std::endl;
+      passed = false;
+      }
+    catch ( itk::ExceptionObject & e )
+      {
+      std::cout << "Caught expected exception: " << e.GetDescription() << std::endl;
+      }
+    }
+
+  itk::ThreadPool::GetInstance()->Shutdown();
+
+  if ( !passed )
+    {
+    std::cout << "[TEST FAILED]" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "[TEST PASSED]" << std::endl;
+  return EXIT_SUCCESS;
+}
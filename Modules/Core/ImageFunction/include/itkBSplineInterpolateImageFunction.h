@@ -285,6 +285,25 @@ public:
     CovariantVectorType & deriv,
     ThreadIdType threadID) const;
 
+  /** Evaluate the function at an array of ContinuousIndex positions.
+   *
+   * Gives the same values as EvaluateAtContinuousIndex(). The working
+   * space is allocated once per batch, and cubic splines in 2D and 3D
+   * are evaluated with fixed size weights read directly from the
+   * coefficient buffer. */
+  virtual void EvaluateAtContinuousIndices(const ContinuousIndexType *indices,
+                                           OutputType *values,
+                                           SizeValueType n) const;
+
+  /** Evaluate the function and its derivative at an array of
+   * ContinuousIndex positions, as EvaluateValueAndDerivativeAtContinuousIndex()
+   * does for a single position. */
+  void EvaluateValueAndDerivativeAtContinuousIndices(
+    const ContinuousIndexType *indices,
+    OutputType *values,
+    CovariantVectorType *derivatives,
+    SizeValueType n) const;
+
   /** Get/Sets the Spline Order, supports 0th - 5th order splines. The default
    *  is a 3rd order spline. */
   void SetSplineOrder(unsigned int SplineOrder);
@@ -393,6 +412,44 @@ private:
   void ApplyMirrorBoundaryConditions(vnl_matrix< long > & evaluateIndex,
                                      unsigned int splineOrder) const;
 
+  struct DispatchBase {};
+  template< unsigned int >
+  struct Dispatch: public DispatchBase {};
+
+  /** Determine the cubic spline weights, the derivative weights when
+   * derivativeWeights is not NULL, and the coefficient buffer offsets of
+   * the region of support of x along dimension n. Same arithmetic as
+   * DetermineRegionOfSupport(), SetInterpolationWeights(),
+   * SetDerivativeWeights() and ApplyMirrorBoundaryConditions(). */
+  void DetermineCubicSupport(unsigned int n,
+                             double x,
+                             double *weights,
+                             double *derivativeWeights,
+                             OffsetValueType *offsets) const;
+
+  /** Batch evaluation of cubic splines, returning false when the
+   * dimension has no fixed size implementation. */
+  bool EvaluateCubicAtContinuousIndices(const DispatchBase &,
+                                        const ContinuousIndexType *,
+                                        OutputType *,
+                                        CovariantVectorType *,
+                                        SizeValueType) const
+  {
+    return false;
+  }
+
+  bool EvaluateCubicAtContinuousIndices(const Dispatch< 2 > &,
+                                        const ContinuousIndexType *indices,
+                                        OutputType *values,
+                                        CovariantVectorType *derivatives,
+                                        SizeValueType n) const;
+
+  bool EvaluateCubicAtContinuousIndices(const Dispatch< 3 > &,
+                                        const ContinuousIndexType *indices,
+                                        OutputType *values,
+                                        CovariantVectorType *derivatives,
+                                        SizeValueType n) const;
+
   Iterator m_CIterator;                                    // Iterator for
                                                            // traversing spline
                                                            // coefficients.
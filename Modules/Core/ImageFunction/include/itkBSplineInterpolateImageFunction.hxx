@@ -385,6 +385,269 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
 #endif
 }
 
+template< class TImageType, class TCoordRep, class TCoefficientType >
+void
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::EvaluateAtContinuousIndices(const ContinuousIndexType *indices,
+                              OutputType *values,
+                              SizeValueType n) const
+{
+  if ( m_SplineOrder == 3
+       && this->EvaluateCubicAtContinuousIndices(Dispatch< ImageDimension >(),
+                                                 indices, values, NULL, n) )
+    {
+    return;
+    }
+
+  vnl_matrix< long >   evaluateIndex( ImageDimension, ( m_SplineOrder + 1 ) );
+  vnl_matrix< double > weights( ImageDimension, ( m_SplineOrder + 1 ) );
+  for ( SizeValueType i = 0; i < n; ++i )
+    {
+    values[i] = this->EvaluateAtContinuousIndexInternal(indices[i],
+                                                        evaluateIndex,
+                                                        weights);
+    }
+}
+
+template< class TImageType, class TCoordRep, class TCoefficientType >
+void
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::EvaluateValueAndDerivativeAtContinuousIndices(const ContinuousIndexType *indices,
+                                                OutputType *values,
+                                                CovariantVectorType *derivatives,
+                                                SizeValueType n) const
+{
+  if ( m_SplineOrder == 3
+       && this->EvaluateCubicAtContinuousIndices(Dispatch< ImageDimension >(),
+                                                 indices, values, derivatives, n) )
+    {
+    return;
+    }
+
+  vnl_matrix< long >   evaluateIndex( ImageDimension, ( m_SplineOrder + 1 ) );
+  vnl_matrix< double > weights( ImageDimension, ( m_SplineOrder + 1 ) );
+  vnl_matrix< double > weightsDerivative( ImageDimension, ( m_SplineOrder + 1 ) );
+  for ( SizeValueType i = 0; i < n; ++i )
+    {
+    this->EvaluateValueAndDerivativeAtContinuousIndexInternal(indices[i],
+                                                              values[i],
+                                                              derivatives[i],
+                                                              evaluateIndex,
+                                                              weights,
+                                                              weightsDerivative);
+    }
+}
+
+template< class TImageType, class TCoordRep, class TCoefficientType >
+void
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::DetermineCubicSupport(unsigned int n,
+                        double x,
+                        double *weights,
+                        double *derivativeWeights,
+                        OffsetValueType *offsets) const
+{
+  long evaluateIndex[4];
+  long indx = (long)vcl_floor( (float)x ) - 1;
+
+  for ( unsigned int k = 0; k < 4; k++ )
+    {
+    evaluateIndex[k] = indx++;
+    }
+
+  double w = x - (double)evaluateIndex[1];
+  weights[3] = ( 1.0 / 6.0 ) * w * w * w;
+  weights[0] = ( 1.0 / 6.0 ) + 0.5 * w * ( w - 1.0 ) - weights[3];
+  weights[2] = w + weights[0] - 2.0 * weights[3];
+  weights[1] = 1.0 - weights[0] - weights[2] - weights[3];
+
+  if ( derivativeWeights )
+    {
+    w = x + 0.5 - (double)evaluateIndex[2];
+    const double w2 = 0.75 - w * w;
+    const double w3 = 0.5 * ( w - w2 + 1.0 );
+    const double w1 = 1.0 - w2 - w3;
+
+    derivativeWeights[0] = 0.0 - w1;
+    derivativeWeights[1] = w1 - w2;
+    derivativeWeights[2] = w2 - w3;
+    derivativeWeights[3] = w3;
+    }
+
+  // Mirror boundary conditions, then offsets into the coefficient buffer.
+  const IndexValueType startIndex = this->GetStartIndex()[n];
+  const IndexValueType endIndex = this->GetEndIndex()[n];
+  const IndexValueType bufferStart =
+    m_Coefficients->GetBufferedRegion().GetIndex()[n];
+  const OffsetValueType stride =
+    ( n == 0 ) ? 1 : m_Coefficients->GetOffsetTable()[n];
+
+  for ( unsigned int k = 0; k < 4; k++ )
+    {
+    if ( m_DataLength[n] == 1 )
+      {
+      evaluateIndex[k] = startIndex;
+      }
+    else
+      {
+      if ( evaluateIndex[k] < startIndex )
+        {
+        evaluateIndex[k] = startIndex + ( startIndex - evaluateIndex[k] );
+        }
+      if ( evaluateIndex[k] >= endIndex )
+        {
+        evaluateIndex[k] = endIndex - ( evaluateIndex[k] - endIndex );
+        }
+      }
+    offsets[k] = ( evaluateIndex[k] - bufferStart ) * stride;
+    }
+}
+
+template< class TImageType, class TCoordRep, class TCoefficientType >
+bool
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::EvaluateCubicAtContinuousIndices(const Dispatch< 2 > &,
+                                   const ContinuousIndexType *indices,
+                                   OutputType *values,
+                                   CovariantVectorType *derivatives,
+                                   SizeValueType n) const
+{
+  const CoefficientDataType *coefficients = m_Coefficients->GetBufferPointer();
+  const typename InputImageType::SpacingType spacing =
+    this->GetInputImage()->GetSpacing();
+
+  double          weights[2][4];
+  double          weightsDerivative[2][4];
+  OffsetValueType offsets[2][4];
+
+  for ( SizeValueType i = 0; i < n; ++i )
+    {
+    const ContinuousIndexType & x = indices[i];
+    if ( derivatives == NULL )
+      {
+      this->DetermineCubicSupport(0, x[0], weights[0], NULL, offsets[0]);
+      this->DetermineCubicSupport(1, x[1], weights[1], NULL, offsets[1]);
+
+      // The points of the interpolation cube are visited with the first
+      // dimension varying fastest, as m_PointsToIndex orders them.
+      double interpolated = 0.0;
+      for ( unsigned int k1 = 0; k1 < 4; k1++ )
+        {
+        const CoefficientDataType *line = coefficients + offsets[1][k1];
+        for ( unsigned int k0 = 0; k0 < 4; k0++ )
+          {
+          interpolated += ( weights[0][k0] * weights[1][k1] ) * line[offsets[0][k0]];
+          }
+        }
+      values[i] = interpolated;
+      continue;
+      }
+
+    this->DetermineCubicSupport(0, x[0], weights[0], weightsDerivative[0], offsets[0]);
+    this->DetermineCubicSupport(1, x[1], weights[1], weightsDerivative[1], offsets[1]);
+
+    OutputType          value = 0.0;
+    CovariantVectorType derivativeValue;
+    derivativeValue[0] = 0.0;
+    derivativeValue[1] = 0.0;
+    for ( unsigned int k1 = 0; k1 < 4; k1++ )
+      {
+      const CoefficientDataType *line = coefficients + offsets[1][k1];
+      for ( unsigned int k0 = 0; k0 < 4; k0++ )
+        {
+        const double tmpV = line[offsets[0][k0]];
+        value += ( weights[0][k0] * weights[1][k1] ) * tmpV;
+        derivativeValue[0] += ( weightsDerivative[0][k0] * weights[1][k1] ) * tmpV;
+        derivativeValue[1] += tmpV * ( weights[0][k0] * weightsDerivative[1][k1] );
+        }
+      }
+    derivativeValue[0] /= spacing[0];
+    derivativeValue[1] /= spacing[1];
+    values[i] = value;
+    derivatives[i] = derivativeValue;
+    }
+  return true;
+}
+
+template< class TImageType, class TCoordRep, class TCoefficientType >
+bool
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::EvaluateCubicAtContinuousIndices(const Dispatch< 3 > &,
+                                   const ContinuousIndexType *indices,
+                                   OutputType *values,
+                                   CovariantVectorType *derivatives,
+                                   SizeValueType n) const
+{
+  const CoefficientDataType *coefficients = m_Coefficients->GetBufferPointer();
+  const typename InputImageType::SpacingType spacing =
+    this->GetInputImage()->GetSpacing();
+
+  double          weights[3][4];
+  double          weightsDerivative[3][4];
+  OffsetValueType offsets[3][4];
+
+  for ( SizeValueType i = 0; i < n; ++i )
+    {
+    const ContinuousIndexType & x = indices[i];
+    if ( derivatives == NULL )
+      {
+      this->DetermineCubicSupport(0, x[0], weights[0], NULL, offsets[0]);
+      this->DetermineCubicSupport(1, x[1], weights[1], NULL, offsets[1]);
+      this->DetermineCubicSupport(2, x[2], weights[2], NULL, offsets[2]);
+
+      double interpolated = 0.0;
+      for ( unsigned int k2 = 0; k2 < 4; k2++ )
+        {
+        for ( unsigned int k1 = 0; k1 < 4; k1++ )
+          {
+          const CoefficientDataType *line = coefficients + offsets[2][k2] + offsets[1][k1];
+          for ( unsigned int k0 = 0; k0 < 4; k0++ )
+            {
+            interpolated += ( ( weights[0][k0] * weights[1][k1] ) * weights[2][k2] )
+                            * line[offsets[0][k0]];
+            }
+          }
+        }
+      values[i] = interpolated;
+      continue;
+      }
+
+    this->DetermineCubicSupport(0, x[0], weights[0], weightsDerivative[0], offsets[0]);
+    this->DetermineCubicSupport(1, x[1], weights[1], weightsDerivative[1], offsets[1]);
+    this->DetermineCubicSupport(2, x[2], weights[2], weightsDerivative[2], offsets[2]);
+
+    OutputType          value = 0.0;
+    CovariantVectorType derivativeValue;
+    derivativeValue[0] = 0.0;
+    derivativeValue[1] = 0.0;
+    derivativeValue[2] = 0.0;
+    for ( unsigned int k2 = 0; k2 < 4; k2++ )
+      {
+      for ( unsigned int k1 = 0; k1 < 4; k1++ )
+        {
+        const CoefficientDataType *line = coefficients + offsets[2][k2] + offsets[1][k1];
+        for ( unsigned int k0 = 0; k0 < 4; k0++ )
+          {
+          const double tmpV = line[offsets[0][k0]];
+          value += ( ( weights[0][k0] * weights[1][k1] ) * weights[2][k2] ) * tmpV;
+          derivativeValue[0] +=
+            ( ( weightsDerivative[0][k0] * weights[1][k1] ) * weights[2][k2] ) * tmpV;
+          derivativeValue[1] +=
+            tmpV * ( ( weights[0][k0] * weightsDerivative[1][k1] ) * weights[2][k2] );
+          derivativeValue[2] +=
+            tmpV * ( ( weights[0][k0] * weights[1][k1] ) * weightsDerivative[2][k2] );
+          }
+        }
+      }
+    derivativeValue[0] /= spacing[0];
+    derivativeValue[1] /= spacing[1];
+    derivativeValue[2] /= spacing[2];
+    values[i] = value;
+    derivatives[i] = derivativeValue;
+    }
+  return true;
+}
+
 template< class TImageType, class TCoordRep, class TCoefficientType >
 void
 BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
@@ -708,7 +971,7 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
       {
       for ( unsigned int k = 0; k <= splineOrder; k++ )
         {
-        evaluateIndex[n][k] = 0;
+        evaluateIndex[n][k] = startIndex[n];
         }
       }
     else
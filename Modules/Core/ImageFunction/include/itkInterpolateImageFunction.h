@@ -110,6 +110,25 @@ public:
   virtual OutputType EvaluateAtContinuousIndex(
     const ContinuousIndexType & index) const = 0;
 
+  /** Interpolate the image at an array of continuous index positions
+   *
+   * Stores the interpolated image intensity at indices[i] in values[i]
+   * for the n given positions. No bounds checking is done.
+   * The points are assumed to lie within the image buffer.
+   *
+   * The default implementation calls EvaluateAtContinuousIndex() for
+   * each position. Subclasses override this method to perform the
+   * per-call setup once per batch rather than once per position. */
+  virtual void EvaluateAtContinuousIndices(const ContinuousIndexType *indices,
+                                           OutputType *values,
+                                           SizeValueType n) const
+  {
+    for ( SizeValueType i = 0; i < n; ++i )
+      {
+      values[i] = this->EvaluateAtContinuousIndex(indices[i]);
+      }
+  }
+
   /** Interpolate the image at an index position.
    *
    * Simply returns the image value at the
@@ -19,6 +19,7 @@
 #define __itkLinearInterpolateImageFunction_h
 
 #include "itkInterpolateImageFunction.h"
+#include "itkFunctorSpanTraits.h"
 
 namespace itk
 {
@@ -97,6 +98,19 @@ public:
     return this->EvaluateOptimized(Dispatch< ImageDimension >(), index);
   }
 
+  /** Evaluate the function at an array of ContinuousIndex positions
+   *
+   * Gives the same values as EvaluateAtContinuousIndex(). For 2D and 3D
+   * images of type Image, the neighbors are read directly from the pixel
+   * buffer and the boundary tests are replaced by clamping, so that the
+   * loop over the positions does not branch on the pixel values. */
+  virtual void EvaluateAtContinuousIndices(const ContinuousIndexType *indices,
+                                           OutputType *values,
+                                           SizeValueType n) const
+  {
+    this->EvaluateBatch(Dispatch< BatchDimension >(), indices, values, n);
+  }
+
 protected:
   LinearInterpolateImageFunction();
   ~LinearInterpolateImageFunction();
@@ -113,6 +127,108 @@ private:
   template< unsigned int >
   struct Dispatch: public DispatchBase {};
 
+  /** Dimension selecting the batch implementation: ImageDimension when the
+   * pixels are stored contiguously, 0 (the generic loop) otherwise. */
+  itkStaticConstMacro(BatchDimension, unsigned int,
+                      ( ImageSpanTraits< TInputImage >::IsContiguous ? ImageDimension : 0 ));
+
+  inline void EvaluateBatch(const DispatchBase &,
+                            const ContinuousIndexType *indices,
+                            OutputType *values,
+                            SizeValueType n) const
+  {
+    for ( SizeValueType i = 0; i < n; ++i )
+      {
+      values[i] = this->EvaluateOptimized(Dispatch< ImageDimension >(), indices[i]);
+      }
+  }
+
+  /** Clamp the lower neighbor of the position x to the buffer along dimension
+   * dim, and compute the distance of x to it and the buffer offset of the
+   * upper neighbor relative to the lower one. The distance is 0 and the
+   * offset is 0 in the cases where EvaluateOptimized() ignores the upper
+   * neighbor, so that both neighbors can always be blended. */
+  inline OffsetValueType ClampBatchNeighbor(unsigned int dim,
+                                            double x,
+                                            OffsetValueType stride,
+                                            double & distance,
+                                            OffsetValueType & step) const
+  {
+    IndexValueType base = Math::Floor< IndexValueType >(x);
+    base = ( base < this->m_StartIndex[dim] ) ? this->m_StartIndex[dim] : base;
+    distance = x - static_cast< double >( base );
+    distance = ( distance > 0. ) ? distance : 0.;
+    step = ( base < this->m_EndIndex[dim] ) ? stride : 0;
+    return ( base - this->m_StartIndex[dim] ) * stride;
+  }
+
+  inline void EvaluateBatch(const Dispatch< 2 > &,
+                            const ContinuousIndexType *indices,
+                            OutputType *values,
+                            SizeValueType n) const
+  {
+    const InputImageType * const  image = this->GetInputImage();
+    const InputPixelType * const  buffer = image->GetBufferPointer();
+    const OffsetValueType * const offsetTable = image->GetOffsetTable();
+
+    for ( SizeValueType i = 0; i < n; ++i )
+      {
+      double          distance0, distance1;
+      OffsetValueType step0, step1;
+      const InputPixelType *p = buffer
+        + this->ClampBatchNeighbor(0, indices[i][0], 1, distance0, step0)
+        + this->ClampBatchNeighbor(1, indices[i][1], offsetTable[1], distance1, step1);
+
+      const RealType val00 = p[0];
+      const RealType val10 = p[step0];
+      const RealType val01 = p[step1];
+      const RealType val11 = p[step0 + step1];
+
+      const RealType valx0 = val00 + ( val10 - val00 ) * distance0;
+      const RealType valx1 = val01 + ( val11 - val01 ) * distance0;
+
+      values[i] = static_cast< OutputType >( valx0 + ( valx1 - valx0 ) * distance1 );
+      }
+  }
+
+  inline void EvaluateBatch(const Dispatch< 3 > &,
+                            const ContinuousIndexType *indices,
+                            OutputType *values,
+                            SizeValueType n) const
+  {
+    const InputImageType * const  image = this->GetInputImage();
+    const InputPixelType * const  buffer = image->GetBufferPointer();
+    const OffsetValueType * const offsetTable = image->GetOffsetTable();
+
+    for ( SizeValueType i = 0; i < n; ++i )
+      {
+      double          distance0, distance1, distance2;
+      OffsetValueType step0, step1, step2;
+      const InputPixelType *p = buffer
+        + this->ClampBatchNeighbor(0, indices[i][0], 1, distance0, step0)
+        + this->ClampBatchNeighbor(1, indices[i][1], offsetTable[1], distance1, step1)
+        + this->ClampBatchNeighbor(2, indices[i][2], offsetTable[2], distance2, step2);
+
+      const RealType val000 = p[0];
+      const RealType val100 = p[step0];
+      const RealType val010 = p[step1];
+      const RealType val110 = p[step0 + step1];
+      const RealType val001 = p[step2];
+      const RealType val101 = p[step0 + step2];
+      const RealType val011 = p[step1 + step2];
+      const RealType val111 = p[step0 + step1 + step2];
+
+      const RealType valx00 = val000 + ( val100 - val000 ) * distance0;
+      const RealType valx10 = val010 + ( val110 - val010 ) * distance0;
+      const RealType valx01 = val001 + ( val101 - val001 ) * distance0;
+      const RealType valx11 = val011 + ( val111 - val011 ) * distance0;
+      const RealType valxx0 = valx00 + ( valx10 - valx00 ) * distance1;
+      const RealType valxx1 = valx01 + ( valx11 - valx01 ) * distance1;
+
+      values[i] = static_cast< OutputType >( valxx0 + ( valxx1 - valxx0 ) * distance2 );
+      }
+  }
+
   inline OutputType EvaluateOptimized(const Dispatch< 0 > &,
                                       const ContinuousIndexType & ) const
   {
@@ -303,6 +303,12 @@ public:
   virtual OutputType EvaluateAtContinuousIndex(
     const ContinuousIndexType & index) const;
 
+  /** Evaluate the function at an array of ContinuousIndex positions,
+   * using a single neighborhood iterator for the whole batch. */
+  virtual void EvaluateAtContinuousIndices(const ContinuousIndexType *indices,
+                                           OutputType *values,
+                                           SizeValueType n) const;
+
 protected:
   WindowedSincInterpolateImageFunction();
   virtual ~WindowedSincInterpolateImageFunction();
@@ -317,6 +323,11 @@ private:
   typedef ConstNeighborhoodIterator<
     ImageType, TBoundaryCondition > IteratorType;
 
+  /** Evaluate the function at a ContinuousIndex position, moving the
+   * given neighborhood iterator to it. */
+  OutputType EvaluateAtContinuousIndex(IteratorType & nit,
+                                       const ContinuousIndexType & index) const;
+
   // Constant to store twice the radius
   static const unsigned int m_WindowSize;
 
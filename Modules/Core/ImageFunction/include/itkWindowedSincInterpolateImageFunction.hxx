@@ -194,6 +194,49 @@ WindowedSincInterpolateImageFunction< TInputImage, VRadius,
                                       TWindowFunction, TBoundaryCondition, TCoordRep >
 ::EvaluateAtContinuousIndex(
   const ContinuousIndexType & index) const
+{
+  // Position the neighborhood at the index of interest
+  Size< ImageDimension > radius;
+  radius.Fill(VRadius);
+  IteratorType nit = IteratorType( radius, this->GetInputImage(),
+                                   this->GetInputImage()->GetBufferedRegion() );
+
+  return this->EvaluateAtContinuousIndex(nit, index);
+}
+
+/** Evaluate at an array of continuous index positions */
+template< class TInputImage, unsigned int VRadius,
+          class TWindowFunction, class TBoundaryCondition, class TCoordRep >
+void
+WindowedSincInterpolateImageFunction< TInputImage, VRadius,
+                                      TWindowFunction, TBoundaryCondition, TCoordRep >
+::EvaluateAtContinuousIndices(const ContinuousIndexType *indices,
+                              OutputType *values,
+                              SizeValueType n) const
+{
+  // The neighborhood iterator is set up once and moved to each position.
+  Size< ImageDimension > radius;
+  radius.Fill(VRadius);
+  IteratorType nit = IteratorType( radius, this->GetInputImage(),
+                                   this->GetInputImage()->GetBufferedRegion() );
+
+  for ( SizeValueType i = 0; i < n; ++i )
+    {
+    values[i] = this->EvaluateAtContinuousIndex(nit, indices[i]);
+    }
+}
+
+/** Evaluate at a continuous index position with a given iterator */
+template< class TInputImage, unsigned int VRadius,
+          class TWindowFunction, class TBoundaryCondition, class TCoordRep >
+typename WindowedSincInterpolateImageFunction< TInputImage, VRadius,
+                                               TWindowFunction, TBoundaryCondition, TCoordRep >
+::OutputType
+WindowedSincInterpolateImageFunction< TInputImage, VRadius,
+                                      TWindowFunction, TBoundaryCondition, TCoordRep >
+::EvaluateAtContinuousIndex(
+  IteratorType & nit,
+  const ContinuousIndexType & index) const
 {
   unsigned int dim;
   IndexType    baseIndex;
@@ -209,11 +252,6 @@ WindowedSincInterpolateImageFunction< TInputImage, VRadius,
 
   // cout << "Sampling at index " << index << " discrete " << baseIndex << endl;
 
-  // Position the neighborhood at the index of interest
-  Size< ImageDimension > radius;
-  radius.Fill(VRadius);
-  IteratorType nit = IteratorType( radius, this->GetInputImage(),
-                                   this->GetInputImage()->GetBufferedRegion() );
   nit.SetLocation(baseIndex);
 
   // Compute the sinc function for each dimension
@@ -0,0 +1,225 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <iostream>
+#include <vector>
+
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkBSplineInterpolateImageFunction.h"
+#include "itkWindowedSincInterpolateImageFunction.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+namespace
+{
+typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+
+template< class TImage >
+typename TImage::Pointer
+MakeBatchTestImage()
+{
+  typedef typename TImage::RegionType RegionType;
+  typename RegionType::IndexType start;
+  typename RegionType::SizeType  size;
+  for ( unsigned int d = 0; d < TImage::ImageDimension; d++ )
+    {
+    start[d] = 3 - static_cast< int >( d );
+    size[d] = 7 + d;
+    }
+  // a dimension of a single pixel along the last axis in 3D exercises the
+  // degenerate boundary conditions.
+  if ( TImage::ImageDimension == 3 )
+    {
+    size[2] = 1;
+    }
+
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions( RegionType(start, size) );
+  image->Allocate();
+
+  typename TImage::SpacingType spacing;
+  for ( unsigned int d = 0; d < TImage::ImageDimension; d++ )
+    {
+    spacing[d] = 0.5 + d;
+    }
+  image->SetSpacing(spacing);
+
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(12345);
+  itk::ImageRegionIterator< TImage > it( image, image->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    it.Set( static_cast< typename TImage::PixelType >( generator->GetIntegerVariate(999) / 10.0 ) );
+    }
+  return image;
+}
+
+/** Positions covering the buffer, including integer positions, the
+ * buffer boundaries and the half pixel margins outside the buffer. */
+template< class TContinuousIndex, class TImage >
+std::vector< TContinuousIndex >
+MakeBatchTestIndices(const TImage *image)
+{
+  const typename TImage::RegionType region = image->GetBufferedRegion();
+
+  std::vector< TContinuousIndex > indices;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(54321);
+  for ( unsigned int i = 0; i < 500; i++ )
+    {
+    TContinuousIndex index;
+    for ( unsigned int d = 0; d < TImage::ImageDimension; d++ )
+      {
+      const double low = region.GetIndex()[d] - 0.5;
+      const double extent = region.GetSize()[d];
+      const unsigned int r = generator->GetIntegerVariate(999);
+      double x = low + extent * r / 999.0;
+      if ( i % 7 == 0 )
+        {
+        x = region.GetIndex()[d] + static_cast< int >( r % region.GetSize()[d] );
+        }
+      else if ( i % 11 == 0 )
+        {
+        x = region.GetIndex()[d] + region.GetSize()[d] - 1;
+        }
+      index[d] = x;
+      }
+    indices.push_back(index);
+    }
+  return indices;
+}
+
+template< class TInterpolator >
+bool
+TestBatchValues(TInterpolator *interpolator, const char *name)
+{
+  typedef typename TInterpolator::ContinuousIndexType ContinuousIndexType;
+  typedef typename TInterpolator::OutputType          OutputType;
+
+  const std::vector< ContinuousIndexType > indices =
+    MakeBatchTestIndices< ContinuousIndexType >( interpolator->GetInputImage() );
+
+  std::vector< OutputType > values( indices.size() );
+  interpolator->EvaluateAtContinuousIndices( &indices[0], &values[0], indices.size() );
+
+  for ( unsigned int i = 0; i < indices.size(); i++ )
+    {
+    const OutputType expected = interpolator->EvaluateAtContinuousIndex(indices[i]);
+    if ( values[i] != expected )
+      {
+      std::cerr << name << ": batch value " << values[i]
+                << " differs from " << expected
+                << " at " << indices[i] << std::endl;
+      return false;
+      }
+    }
+  std::cout << name << ": " << indices.size() << " positions ok" << std::endl;
+  return true;
+}
+
+template< class TImage >
+bool
+TestBSplineBatch(unsigned int splineOrder)
+{
+  typedef itk::BSplineInterpolateImageFunction< TImage, double > InterpolatorType;
+  typedef typename InterpolatorType::ContinuousIndexType         ContinuousIndexType;
+  typedef typename InterpolatorType::OutputType                  OutputType;
+  typedef typename InterpolatorType::CovariantVectorType         CovariantVectorType;
+
+  typename TImage::Pointer image = MakeBatchTestImage< TImage >();
+  typename InterpolatorType::Pointer interpolator = InterpolatorType::New();
+  interpolator->SetSplineOrder(splineOrder);
+  interpolator->SetInputImage(image);
+
+  if ( !TestBatchValues(interpolator.GetPointer(), "BSpline") )
+    {
+    return false;
+    }
+
+  const std::vector< ContinuousIndexType > indices =
+    MakeBatchTestIndices< ContinuousIndexType >( image.GetPointer() );
+  std::vector< OutputType >          values( indices.size() );
+  std::vector< CovariantVectorType > derivatives( indices.size() );
+  interpolator->EvaluateValueAndDerivativeAtContinuousIndices( &indices[0], &values[0],
+                                                               &derivatives[0], indices.size() );
+  for ( unsigned int i = 0; i < indices.size(); i++ )
+    {
+    OutputType          value;
+    CovariantVectorType derivative;
+    interpolator->EvaluateValueAndDerivativeAtContinuousIndex(indices[i], value, derivative);
+    if ( values[i] != value || derivatives[i] != derivative )
+      {
+      std::cerr << "BSpline order " << splineOrder << ": batch value and derivative "
+                << values[i] << " " << derivatives[i] << " differ from "
+                << value << " " << derivative << " at " << indices[i] << std::endl;
+      return false;
+      }
+    }
+  std::cout << "BSpline order " << splineOrder << " derivatives ok" << std::endl;
+  return true;
+}
+
+template< class TImage >
+bool
+TestLinearBatch()
+{
+  typedef itk::LinearInterpolateImageFunction< TImage, double > InterpolatorType;
+
+  typename TImage::Pointer image = MakeBatchTestImage< TImage >();
+  typename InterpolatorType::Pointer interpolator = InterpolatorType::New();
+  interpolator->SetInputImage(image);
+
+  return TestBatchValues(interpolator.GetPointer(), "Linear");
+}
+}
+
+int itkInterpolateImageFunctionBatchTest( int, char* [] )
+{
+  typedef itk::Image< float, 1 >         Image1DType;
+  typedef itk::Image< float, 2 >         Image2DType;
+  typedef itk::Image< unsigned char, 3 > Image3DType;
+
+  bool pass = true;
+
+  pass &= TestLinearBatch< Image1DType >();
+  pass &= TestLinearBatch< Image2DType >();
+  pass &= TestLinearBatch< Image3DType >();
+
+  pass &= TestBSplineBatch< Image2DType >(3);
+  pass &= TestBSplineBatch< Image3DType >(3);
+  pass &= TestBSplineBatch< Image2DType >(2);
+  pass &= TestBSplineBatch< Image1DType >(3);
+
+  typedef itk::Function::HammingWindowFunction< 2 >   WindowFunctionType;
+  typedef itk::ZeroFluxNeumannBoundaryCondition< Image2DType > BoundaryConditionType;
+  typedef itk::WindowedSincInterpolateImageFunction< Image2DType, 2,
+                                                     WindowFunctionType,
+                                                     BoundaryConditionType > SincInterpolatorType;
+  Image2DType::Pointer image = MakeBatchTestImage< Image2DType >();
+  SincInterpolatorType::Pointer sinc = SincInterpolatorType::New();
+  sinc->SetInputImage(image);
+  pass &= TestBatchValues(sinc.GetPointer(), "WindowedSinc");
+
+  if ( !pass )
+    {
+    std::cerr << "Test failed." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -231,6 +231,16 @@ public:
   virtual void TransformPoint( const InputPointType & inputPoint, OutputPointType & outputPoint,
     WeightsType & weights, ParameterIndexArrayType & indices, bool & inside ) const;
 
+  /**
+   * Transform points evenly spaced along a line.  Consecutive points whose
+   * continuous grid indices agree in dimensions 1 to N-1, as along the
+   * scanlines of an image aligned with the control point grid, share the
+   * correlation of those weights with the coefficients of each grid
+   * column, so only the weights along dimension 0 are evaluated per point.
+   */
+  virtual void TransformPointsAlongLine( const InputPointType *points, OutputPointType *outputs,
+    SizeValueType n ) const;
+
   virtual void ComputeJacobianWithRespectToParameters( const InputPointType &, JacobianType & ) const;
 
   /** Return the number of parameters that completely define the Transfom */
@@ -21,6 +21,7 @@
 #include "itkBSplineTransform.h"
 
 #include "itkContinuousIndex.h"
+#include "itkBSplineKernelFunction.h"
 #include "itkImageRegionIterator.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
 
@@ -582,6 +583,144 @@ BSplineTransform<TScalarType, NDimensions, VSplineOrder>
     }
 }
 
+template <class TScalarType, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+BSplineTransform<TScalarType, NDimensions, VSplineOrder>
+::TransformPointsAlongLine( const InputPointType *points, OutputPointType *outputs,
+  SizeValueType n ) const
+{
+  const ImageType *coefficientImage = this->m_CoefficientImages[0];
+  if( !coefficientImage->GetBufferPointer() )
+    {
+    Superclass::TransformPointsAlongLine( points, outputs, n );
+    return;
+    }
+
+  const unsigned int supportLength = SplineOrder + 1;
+  unsigned int       rowSupportSize = 1;
+  for( unsigned int d = 1; d < SpaceDimension; d++ )
+    {
+    rowSupportSize *= supportLength;
+    }
+
+  const RegionType &     bufferedRegion = coefficientImage->GetBufferedRegion();
+  const IndexValueType   firstGridColumn = bufferedRegion.GetIndex()[0];
+  const SizeValueType    numberOfColumns = bufferedRegion.GetSize()[0];
+  const OffsetValueType *offsetTable = coefficientImage->GetOffsetTable();
+
+  const ParametersValueType *coefficients[SpaceDimension];
+  for( unsigned int j = 0; j < SpaceDimension; j++ )
+    {
+    coefficients[j] = this->m_CoefficientImages[j]->GetBufferPointer();
+    }
+
+  // The weights of dimensions 1 to N-1 and the buffer offsets of their
+  // support are shared by the points of a grid row; the correlation of
+  // each grid column with them is computed on first use within the row.
+  std::vector<double>          rowWeights( rowSupportSize );
+  std::vector<OffsetValueType> rowOffsets( rowSupportSize );
+  std::vector<ScalarType>      columnSums( numberOfColumns * SpaceDimension );
+  std::vector<SizeValueType>   columnRow( numberOfColumns, 0 );
+  SizeValueType                row = 0;
+  ContinuousIndexType          rowIndex;
+
+  typedef BSplineKernelFunction<SplineOrder> KernelType;
+  typename KernelType::Pointer kernel = KernelType::New();
+
+  double    weights1D[SpaceDimension][SplineOrder + 1];
+  IndexType startIndex;
+  for( SizeValueType i = 0; i < n; i++ )
+    {
+    ContinuousIndexType index;
+    coefficientImage->TransformPhysicalPointToContinuousIndex( points[i], index );
+
+    // NOTE: if the support region does not lie totally within the grid
+    // we assume zero displacement and return the input point
+    if( !this->InsideValidRegion( index ) )
+      {
+      outputs[i] = points[i];
+      continue;
+      }
+
+    bool sameRow = ( row != 0 );
+    for( unsigned int d = 1; d < SpaceDimension && sameRow; d++ )
+      {
+      sameRow = ( index[d] == rowIndex[d] );
+      }
+
+    // Same support and weights as BSplineInterpolationWeightFunction
+    for( unsigned int d = 0; d < ( sameRow ? 1 : SpaceDimension ); d++ )
+      {
+      startIndex[d] = Math::Floor<IndexValueType>( index[d]
+        - static_cast<double>( SplineOrder - 1 ) / 2.0 );
+      double x = index[d] - static_cast<double>( startIndex[d] );
+      for( unsigned int k = 0; k <= SplineOrder; k++ )
+        {
+        weights1D[d][k] = kernel->Evaluate( x );
+        x -= 1.0;
+        }
+      }
+
+    if( !sameRow )
+      {
+      ++row;
+      rowIndex = index;
+
+      IndexType rowStart = startIndex;
+      rowStart[0] = firstGridColumn;
+      const OffsetValueType rowOffset = coefficientImage->ComputeOffset( rowStart );
+      for( unsigned int m = 0; m < rowSupportSize; m++ )
+        {
+        double          weight = 1.0;
+        OffsetValueType offset = rowOffset;
+        unsigned int    remainder = m;
+        for( unsigned int d = 1; d < SpaceDimension; d++ )
+          {
+          const unsigned int k = remainder % supportLength;
+          remainder /= supportLength;
+          weight *= weights1D[d][k];
+          offset += k * offsetTable[d];
+          }
+        rowWeights[m] = weight;
+        rowOffsets[m] = offset;
+        }
+      }
+
+    OutputPointType & outputPoint = outputs[i];
+    outputPoint.Fill( NumericTraits<ScalarType>::Zero );
+
+    const SizeValueType firstColumn = startIndex[0] - firstGridColumn;
+    for( unsigned int k = 0; k <= SplineOrder; k++ )
+      {
+      const SizeValueType column = firstColumn + k;
+      ScalarType *        columnSum = &columnSums[column * SpaceDimension];
+      if( columnRow[column] != row )
+        {
+        for( unsigned int j = 0; j < SpaceDimension; j++ )
+          {
+          const ParametersValueType *columnCoefficients = coefficients[j] + column;
+          double                     sum = 0.0;
+          for( unsigned int m = 0; m < rowSupportSize; m++ )
+            {
+            sum += rowWeights[m] * columnCoefficients[rowOffsets[m]];
+            }
+          columnSum[j] = static_cast<ScalarType>( sum );
+          }
+        columnRow[column] = row;
+        }
+      for( unsigned int j = 0; j < SpaceDimension; j++ )
+        {
+        outputPoint[j] += static_cast<ScalarType>( weights1D[0][k] * columnSum[j] );
+        }
+      }
+
+    for( unsigned int j = 0; j < SpaceDimension; j++ )
+      {
+      outputPoint[j] += points[i][j];
+      }
+    }
+}
+
 // Compute the Jacobian in one position
 template <class TScalarType, unsigned int NDimensions, unsigned int VSplineOrder>
 void
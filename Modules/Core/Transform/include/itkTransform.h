@@ -79,17 +79,17 @@ namespace itk
 template <class TScalarType,
           unsigned int NInputDimensions = 3,
           unsigned int NOutputDimensions = 3>
-class ITK_EXPORT Transform : public TransformBase
+class ITK_EXPORT Transform : public TransformBaseTemplate<TScalarType>
 {
 public:
   /** Standard class typedefs. */
-  typedef Transform                Self;
-  typedef TransformBase            Superclass;
+  typedef Transform                           Self;
+  typedef TransformBaseTemplate<TScalarType>  Superclass;
   typedef SmartPointer<Self>       Pointer;
   typedef SmartPointer<const Self> ConstPointer;
 
   /** Run-time type information (and related methods). */
-  itkTypeMacro(Transform, TransformBase);
+  itkTypeMacro(Transform, TransformBaseTemplate);
 
   /** Dimension of the domain space. */
   itkStaticConstMacro(InputSpaceDimension, unsigned int, NInputDimensions);
@@ -180,7 +180,10 @@ public:
                  itkGetStaticConstMacro(InputSpaceDimension)>
   DirectionChangeMatrix;
 
-  typedef Superclass::NumberOfParametersType    NumberOfParametersType;
+  typedef typename Superclass::NumberOfParametersType NumberOfParametersType;
+
+  /** Transform category type. */
+  typedef typename Superclass::TransformCategoryType TransformCategoryType;
 
   /**  Method to transform a point.
    * \warning This method must be thread-safe. See, e.g., its use
@@ -188,6 +191,17 @@ public:
    */
   virtual OutputPointType TransformPoint(const InputPointType  &) const = 0;
 
+  /** Method to transform \c n points that are evenly spaced along a line,
+   * such as the physical points of an image scanline, writing the results
+   * to \c outputs.  The default calls TransformPoint() for each point.
+   * Transforms with spatially varying parameters may override it to reuse
+   * work between neighboring points; overrides must give the same results
+   * as TransformPoint() up to floating point rounding.
+   * \warning This method must be thread-safe. */
+  virtual void TransformPointsAlongLine(const InputPointType *points,
+                                        OutputPointType *outputs,
+                                        SizeValueType n) const;
+
   /**  Method to transform a vector. */
   virtual OutputVectorType  TransformVector(const InputVectorType &) const
   {
@@ -435,12 +449,12 @@ public:
    */
   virtual TransformCategoryType GetTransformCategory() const
   {
-    return None;
+    return Self::None;
   }
 
   virtual bool IsLinear() const
   {
-    return ( this->GetTransformCategory() == Linear );
+    return ( this->GetTransformCategory() == Self::Linear );
   }
 
 
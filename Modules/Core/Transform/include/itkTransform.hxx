@@ -161,6 +161,23 @@ Transform<TScalarType, NInputDimensions, NOutputDimensions>
   this->Modified();
 }
 
+/**
+ * Transform points along a line
+ */
+template <class TScalarType,
+          unsigned int NInputDimensions,
+          unsigned int NOutputDimensions>
+void
+Transform<TScalarType, NInputDimensions, NOutputDimensions>
+::TransformPointsAlongLine( const InputPointType *points, OutputPointType *outputs,
+                            SizeValueType n ) const
+{
+  for( SizeValueType i = 0; i < n; i++ )
+    {
+    outputs[i] = this->TransformPoint( points[i] );
+    }
+}
+
 /**
  * Transform vector
  */
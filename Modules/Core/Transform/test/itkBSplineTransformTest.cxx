@@ -780,6 +780,93 @@ int itkBSplineTransformTest3()
   return EXIT_SUCCESS;
 }
 
+template <unsigned int VDimension, unsigned int VSplineOrder>
+int itkBSplineTransformTest4()
+{
+
+  // This function tests that TransformPointsAlongLine matches
+  // TransformPoint along and across the control point grid
+
+  typedef itk::BSplineTransform<double, VDimension, VSplineOrder> TransformType;
+  typedef typename TransformType::ParametersType                 ParametersType;
+  typedef typename TransformType::InputPointType                 PointType;
+
+  typename TransformType::OriginType origin;
+  origin.Fill( 0.0 );
+  typename TransformType::PhysicalDimensionsType dimensions;
+  dimensions.Fill( 100 );
+  typename TransformType::MeshSizeType meshSize;
+  meshSize.Fill( 7 );
+  typename TransformType::DirectionType direction;
+  direction.SetIdentity();
+
+  typename TransformType::Pointer transform = TransformType::New();
+  transform->SetTransformDomainOrigin( origin );
+  transform->SetTransformDomainPhysicalDimensions( dimensions );
+  transform->SetTransformDomainMeshSize( meshSize );
+  transform->SetTransformDomainDirection( direction );
+
+  ParametersType parameters( transform->GetNumberOfParameters() );
+  for( unsigned int i = 0; i < parameters.Size(); i++ )
+    {
+    parameters[i] = 5.0 * vcl_sin( 0.37 * i );
+    }
+  transform->SetParametersByValue( parameters );
+
+  // Lines along dimension 0, partly outside of the valid region, along
+  // the last dimension, and oblique
+  const unsigned int numberOfPoints = 150;
+  double             starts[3] = { -10.0, 3.0, -5.0 };
+  double             steps[3] = { 0.8, 0.6, 0.7 };
+  for( unsigned int line = 0; line < 3; line++ )
+    {
+    std::vector<PointType> points( numberOfPoints );
+    std::vector<PointType> outputs( numberOfPoints );
+    for( unsigned int i = 0; i < numberOfPoints; i++ )
+      {
+      for( unsigned int d = 0; d < VDimension; d++ )
+        {
+        points[i][d] = 37.5 + 11.0 * d;
+        }
+      if( line == 0 )
+        {
+        points[i][0] = starts[line] + i * steps[line];
+        }
+      else if( line == 1 )
+        {
+        points[i][VDimension - 1] = starts[line] + i * steps[line];
+        }
+      else
+        {
+        for( unsigned int d = 0; d < VDimension; d++ )
+          {
+          points[i][d] = starts[line] + i * steps[line] * ( 1.0 - 0.2 * d );
+          }
+        }
+      }
+
+    transform->TransformPointsAlongLine( &points[0], &outputs[0], numberOfPoints );
+    for( unsigned int i = 0; i < numberOfPoints; i++ )
+      {
+      const PointType expected = transform->TransformPoint( points[i] );
+      for( unsigned int d = 0; d < VDimension; d++ )
+        {
+        if( vcl_fabs( outputs[i][d] - expected[d] ) > 1e-9 )
+          {
+          std::cout << "TransformPointsAlongLine on line " << line << " gives "
+                    << outputs[i] << " for " << points[i] << " instead of "
+                    << expected << std::endl;
+          std::cout << "Test failed." << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
+
 int itkBSplineTransformTest(int, char * [] )
 {
   bool failed;
@@ -802,5 +889,17 @@ int itkBSplineTransformTest(int, char * [] )
     return EXIT_FAILURE;
     }
 
+  failed = itkBSplineTransformTest4<3, 3>();
+  if( failed )
+    {
+    return EXIT_FAILURE;
+    }
+
+  failed = itkBSplineTransformTest4<2, 2>();
+  if( failed )
+    {
+    return EXIT_FAILURE;
+    }
+
   return EXIT_SUCCESS;
 }
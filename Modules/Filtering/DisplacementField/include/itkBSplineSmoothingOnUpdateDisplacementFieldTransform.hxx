@@ -117,18 +117,8 @@ BSplineSmoothingOnUpdateDisplacementFieldTransform<TScalar, NDimensions>
     {
     itkDebugMacro( "Smooothing the update field." );
 
-    DisplacementVectorType *updateFieldPointer = reinterpret_cast<DisplacementVectorType *>( const_cast<DerivativeType &>(update).data_block() );
-
-    typename ImporterType::Pointer importer = ImporterType::New();
-    importer->SetImportPointer( updateFieldPointer, numberOfPixels, importFilterWillReleaseMemory );
-    importer->SetRegion( displacementField->GetBufferedRegion() );
-    importer->SetOrigin( displacementField->GetOrigin() );
-    importer->SetSpacing( displacementField->GetSpacing() );
-    importer->SetDirection( identity );
-
-    DisplacementFieldPointer updateField = importer->GetOutput();
-    updateField->Update();
-    updateField->DisconnectPipeline();
+    DisplacementFieldPointer updateField = Superclass::template GetDerivativeAsField<DisplacementFieldType>( update,
+      displacementField->GetBufferedRegion(), displacementField->GetOrigin(), displacementField->GetSpacing(), identity );
 
     DisplacementFieldPointer updateSmoothField = this->BSplineSmoothDisplacementField( updateField, this->m_NumberOfControlPointsForTheUpdateField );
 
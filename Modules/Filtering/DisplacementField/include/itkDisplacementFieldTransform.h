@@ -64,6 +64,8 @@ namespace itk
  * in conjunction with the \c ImageVectorOptimizerParametersHelper class. This
  * allows access of the displacement field image as if it were an itkArray,
  * allowing transparent use with other classes.
+ * The parameters hold \c TScalar values, so a float transform is optimized
+ * in single precision without copying its field.
  * \warning The \c SetParameters
  * method will copy the passed parameters, which can be costly since
  * displacement fields are dense and thus potentially very large.
@@ -204,6 +206,15 @@ public:
   virtual OutputPointType TransformPoint( const InputPointType& thisPoint )
   const;
 
+  /** Method to transform points evenly spaced along a line.  When the
+   * interpolator is a VectorLinearInterpolateImageFunction and the points
+   * lie on the grid of the displacement field, as for the scanlines of an
+   * image sharing that grid, the displacements are read directly at the
+   * pixel indices of the points. */
+  virtual void TransformPointsAlongLine( const InputPointType *points,
+                                         OutputPointType *outputs,
+                                         SizeValueType n ) const;
+
   /**  Method to transform a vector. */
   using Superclass::TransformVector;
   virtual OutputVectorType TransformVector(const InputVectorType &) const
@@ -376,6 +387,34 @@ public:
 
   virtual void UpdateTransformParameters( const DerivativeType & update, ScalarType factor = 1.0 );
 
+  /** Return a field of type \c TField with the given geometry that shares
+   * the memory of \c derivative, which must hold as many \c ScalarType
+   * components as the field. No copy is made, so the field must not
+   * outlive \c derivative, and changes to the field change \c derivative. */
+  template< class TField >
+  static typename TField::Pointer
+  GetDerivativeAsField( const DerivativeType & derivative,
+                        const typename TField::RegionType & region,
+                        const typename TField::PointType & origin,
+                        const typename TField::SpacingType & spacing,
+                        const typename TField::DirectionType & direction )
+  {
+    typedef typename TField::PixelType FieldPixelType;
+
+    typename TField::Pointer field = TField::New();
+    field->SetRegions( region );
+    field->SetOrigin( origin );
+    field->SetSpacing( spacing );
+    field->SetDirection( direction );
+
+    const bool containerWillReleaseMemory = false;
+    FieldPixelType *derivativePointer =
+      reinterpret_cast<FieldPixelType *>( const_cast<DerivativeType &>( derivative ).data_block() );
+    field->GetPixelContainer()->SetImportPointer( derivativePointer, region.GetNumberOfPixels(),
+                                                  containerWillReleaseMemory );
+    return field;
+  }
+
   /** Return an inverse of this transform. */
   bool GetInverse( Self *inverse ) const;
 
@@ -115,6 +115,81 @@ DisplacementFieldTransform<TScalar, NDimensions>
   return outputPoint;
 }
 
+/**
+ * Transform points along a line
+ */
+template <class TScalar, unsigned int NDimensions>
+void
+DisplacementFieldTransform<TScalar, NDimensions>
+::TransformPointsAlongLine( const InputPointType *points,
+                            OutputPointType *outputs,
+                            SizeValueType n ) const
+{
+  if( !this->m_DisplacementField )
+    {
+    itkExceptionMacro( "No displacement field is specified." );
+    }
+  if( n == 0 )
+    {
+    return;
+    }
+
+  // Linear interpolation at a pixel index returns the pixel value, so
+  // points on the grid of the displacement field only need a lookup.
+  // Being evenly spaced, all points are on the grid when the first one
+  // is and the steps between the end points are whole pixels.
+  typedef VectorLinearInterpolateImageFunction<DisplacementFieldType, ScalarType>
+    LinearInterpolatorType;
+  const double gridTolerance = 1e-6;
+
+  bool onGrid = dynamic_cast<const LinearInterpolatorType *>(
+      this->m_Interpolator.GetPointer() ) != NULL;
+  IndexType                                index;
+  typename DisplacementFieldType::OffsetType step;
+  index.Fill( 0 );
+  step.Fill( 0 );
+  if( onGrid )
+    {
+    typename InterpolatorType::ContinuousIndexType first;
+    typename InterpolatorType::ContinuousIndexType last;
+    typename InterpolatorType::PointType           point;
+    point.CastFrom( points[0] );
+    this->m_DisplacementField->TransformPhysicalPointToContinuousIndex( point, first );
+    point.CastFrom( points[n - 1] );
+    this->m_DisplacementField->TransformPhysicalPointToContinuousIndex( point, last );
+    for( unsigned int d = 0; d < NDimensions && onGrid; d++ )
+      {
+      index[d] = Math::Round<IndexValueType>( first[d] );
+      if( n > 1 )
+        {
+        const double length = last[d] - first[d];
+        step[d] = Math::Round<OffsetValueType>( length / static_cast<double>( n - 1 ) );
+        onGrid = vnl_math_abs( length - static_cast<double>( step[d] * ( n - 1 ) ) )
+          <= gridTolerance;
+        }
+      onGrid = onGrid
+        && vnl_math_abs( first[d] - static_cast<double>( index[d] ) ) <= gridTolerance;
+      }
+    }
+  if( !onGrid )
+    {
+    Superclass::TransformPointsAlongLine( points, outputs, n );
+    return;
+    }
+
+  // Out-of-bounds points are returned with zero displacement
+  const RegionType & bufferedRegion = this->m_DisplacementField->GetBufferedRegion();
+  for( SizeValueType i = 0; i < n; i++ )
+    {
+    outputs[i].CastFrom( points[i] );
+    if( bufferedRegion.IsInside( index ) )
+      {
+      outputs[i] += this->m_DisplacementField->GetPixel( index );
+      }
+    index += step;
+    }
+}
+
 /**
  * return an inverse transformation
  */
@@ -72,18 +72,9 @@ GaussianSmoothingOnUpdateDisplacementFieldTransform<TScalar, NDimensions>
     {
     itkDebugMacro( "Smooothing the update field." );
 
-    DisplacementVectorType *updateFieldPointer = reinterpret_cast<DisplacementVectorType *>( const_cast<DerivativeType &>(update).data_block() );
-
-    typename ImporterType::Pointer importer = ImporterType::New();
-    importer->SetImportPointer( updateFieldPointer, numberOfPixels, importFilterWillReleaseMemory );
-    importer->SetRegion( displacementField->GetBufferedRegion() );
-    importer->SetOrigin( displacementField->GetOrigin() );
-    importer->SetSpacing( displacementField->GetSpacing() );
-    importer->SetDirection( displacementField->GetDirection() );
-
-    DisplacementFieldPointer updateField = importer->GetOutput();
-    updateField->Update();
-    updateField->DisconnectPipeline();
+    DisplacementFieldPointer updateField = Superclass::template GetDerivativeAsField<DisplacementFieldType>( update,
+      displacementField->GetBufferedRegion(), displacementField->GetOrigin(), displacementField->GetSpacing(),
+      displacementField->GetDirection() );
 
     DisplacementFieldPointer smoothedField = this->GaussianSmoothDisplacementField( updateField, this->m_GaussianSmoothingVarianceForTheUpdateField );
 
@@ -73,18 +73,9 @@ GaussianSmoothingOnUpdateTimeVaryingVelocityFieldTransform<TScalar, NDimensions>
     {
     itkDebugMacro( "Smooothing the update field." );
 
-    DisplacementVectorType *updateFieldPointer = reinterpret_cast<DisplacementVectorType *>( const_cast<DerivativeType &>(update).data_block() );
-
-    typename ImporterType::Pointer importer = ImporterType::New();
-    importer->SetImportPointer( updateFieldPointer, numberOfPixels, importFilterWillReleaseMemory );
-    importer->SetRegion( velocityField->GetBufferedRegion() );
-    importer->SetOrigin( velocityField->GetOrigin() );
-    importer->SetSpacing( velocityField->GetSpacing() );
-    importer->SetDirection( velocityField->GetDirection() );
-
-    TimeVaryingVelocityFieldPointer updateField = importer->GetOutput();
-    updateField->Update();
-    updateField->DisconnectPipeline();
+    TimeVaryingVelocityFieldPointer updateField =
+      Superclass::template GetDerivativeAsField<TimeVaryingVelocityFieldType>( update, velocityField->GetBufferedRegion(),
+      velocityField->GetOrigin(), velocityField->GetSpacing(), velocityField->GetDirection() );
 
     TimeVaryingVelocityFieldPointer updateSmoothField = this->GaussianSmoothTimeVaryingVelocityField( updateField,
       this->m_GaussianSpatialSmoothingVarianceForTheUpdateField, this->m_GaussianTemporalSmoothingVarianceForTheUpdateField );
@@ -55,6 +55,10 @@ namespace itk
  * KernelBased spline, therefore a large memory consumption, long computation
  * time and high precision for the inverse estimation.
  *
+ * The kernel-base spline is computed once, before the threads start, and the
+ * output region is then split among the threads, each of which evaluates the
+ * spline over its own part of the output.
+ *
  * This filter expects both the input and output images to be of pixel type
  * Vector.
  *
@@ -179,10 +183,16 @@ protected:
   void PrintSelf(std::ostream & os, Indent indent) const;
 
   /**
-   * GenerateData() computes the internal KernelBase spline and resamples
-   * the displacement field.
+   * BeforeThreadedGenerateData() computes the internal KernelBase spline.
+   */
+  void BeforeThreadedGenerateData();
+
+  /**
+   * ThreadedGenerateData() resamples the displacement field over the output
+   * region of one thread by evaluating the KernelBase spline.
    */
-  void GenerateData();
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId);
 
   /** Subsample the input displacement field and generate the
    *  landmarks for the kernel base spline
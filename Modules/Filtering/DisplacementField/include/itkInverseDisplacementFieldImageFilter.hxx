@@ -206,32 +206,37 @@ InverseDisplacementFieldImageFilter< TInputImage, TOutputImage >
 }
 
 /**
- * GenerateData
+ * BeforeThreadedGenerateData
  */
 template< class TInputImage, class TOutputImage >
 void
 InverseDisplacementFieldImageFilter< TInputImage, TOutputImage >
-::GenerateData()
+::BeforeThreadedGenerateData()
 {
   // First subsample the input displacement field in order to create
   // the KernelBased spline.
   this->PrepareKernelBaseSpline();
+}
 
+/**
+ * ThreadedGenerateData
+ */
+template< class TInputImage, class TOutputImage >
+void
+InverseDisplacementFieldImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
   itkDebugMacro(<< "Actually executing");
 
   // Get the output pointers
   OutputImageType *outputPtr = this->GetOutput();
 
-  outputPtr->SetBufferedRegion( outputPtr->GetRequestedRegion() );
-  outputPtr->Allocate();
-
   // Create an iterator that will walk the output region for this thread.
   typedef ImageRegionIteratorWithIndex<
     TOutputImage > OutputIterator;
 
-  OutputImageRegionType region = outputPtr->GetRequestedRegion();
-
-  OutputIterator outIt(outputPtr, region);
+  OutputIterator outIt(outputPtr, outputRegionForThread);
 
   // Define a few indices that will be used to translate from an input pixel
   // to an output pixel
@@ -243,11 +248,12 @@ InverseDisplacementFieldImageFilter< TInputImage, TOutputImage >
   InputPointType outputPoint;    // Coordinates of current output pixel
 
   // Support for progress methods/callbacks
-  ProgressReporter progress(this, 0, region.GetNumberOfPixels(), 10);
+  ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels(), 10);
 
   outIt.GoToBegin();
 
-  // Walk the output region
+  // Walk the output region.  TransformPoint() only reads the kernel
+  // transform, so it is shared by all the threads.
   while ( !outIt.IsAtEnd() )
     {
     // Determine the index of the current output pixel
@@ -269,8 +275,6 @@ InverseDisplacementFieldImageFilter< TInputImage, TOutputImage >
     ++outIt;
     progress.CompletedPixel();
     }
-
-  return;
 }
 
 /**
@@ -43,6 +43,11 @@ namespace itk
  *
  * This method was discussed in the users-list during February 2004.
  *
+ * The first guess is computed before the threads start.  The refinement of
+ * each pixel only depends on the input field and on the first guess at that
+ * pixel, so the output region is split among the threads, each of which uses
+ * its own interpolator of the input field.
+ *
  * \author  Corinne Mattmann
  *
  * \ingroup ITKDisplacementField
@@ -74,6 +79,7 @@ public:
   typedef typename InputImageType::SpacingType     InputImageSpacingType;
   typedef TOutputImage                             OutputImageType;
   typedef typename OutputImageType::Pointer        OutputImagePointer;
+  typedef typename OutputImageType::RegionType     OutputImageRegionType;
   typedef typename OutputImageType::PixelType      OutputImagePixelType;
   typedef typename OutputImageType::PointType      OutputImagePointType;
   typedef typename OutputImageType::IndexType      OutputImageIndexType;
@@ -113,8 +119,16 @@ protected:
 
   void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Time the whole execution of the filter. */
   void GenerateData();
 
+  /** Compute the first guess of the inverse field into the output. */
+  void BeforeThreadedGenerateData();
+
+  /** Refine the first guess over the output region of one thread. */
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId);
+
   unsigned int m_NumberOfIterations;
 
   double m_StopValue;
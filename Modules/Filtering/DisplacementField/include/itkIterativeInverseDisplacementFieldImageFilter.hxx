@@ -38,11 +38,21 @@ template< class TInputImage, class TOutputImage >
 void IterativeInverseDisplacementFieldImageFilter< TInputImage, TOutputImage >
 ::GenerateData()
 {
-  const unsigned int ImageDimension = InputImageType::ImageDimension;
-  TimeType           time;
+  TimeType time;
 
   time.Start(); //time measurement
 
+  Superclass::GenerateData();
+
+  time.Stop();
+  m_Time = time.GetMean();
+}
+
+//----------------------------------------------------------------------------
+template< class TInputImage, class TOutputImage >
+void IterativeInverseDisplacementFieldImageFilter< TInputImage, TOutputImage >
+::BeforeThreadedGenerateData()
+{
   InputImageConstPointer inputPtr = this->GetInput(0);
   OutputImagePointer     outputPtr = this->GetOutput(0);
 
@@ -74,12 +84,6 @@ void IterativeInverseDisplacementFieldImageFilter< TInputImage, TOutputImage >
     ++InputIt;
     }
 
-  outputPtr->SetRegions( inputPtr->GetRequestedRegion() );
-  outputPtr->SetOrigin( inputPtr->GetOrigin() );
-  outputPtr->SetSpacing( inputPtr->GetSpacing() );
-  outputPtr->SetDirection( inputPtr->GetDirection() );
-  outputPtr->Allocate();
-
   typename VectorWarperType::Pointer vectorWarper = VectorWarperType::New();
   typename FieldInterpolatorType::Pointer VectorInterpolator = FieldInterpolatorType::New();
   vectorWarper->SetInput(negField);
@@ -88,160 +92,168 @@ void IterativeInverseDisplacementFieldImageFilter< TInputImage, TOutputImage >
   vectorWarper->SetOutputSpacing( inputPtr->GetSpacing() );
   vectorWarper->SetOutputDirection( inputPtr->GetDirection() );
   vectorWarper->SetDisplacementField(negField);
+  vectorWarper->SetNumberOfThreads( this->GetNumberOfThreads() );
   vectorWarper->GraftOutput(outputPtr);
   vectorWarper->UpdateLargestPossibleRegion();
 
-  // If the number of iterations is zero, just output the first guess
-  // (negative deformable field applied to itself)
+  // The first guess is refined in place by the threads.  If the number of
+  // iterations is zero, it is the output (negative displacement field applied
+  // to itself).
+  this->GraftOutput( vectorWarper->GetOutput() );
+}
+
+//----------------------------------------------------------------------------
+template< class TInputImage, class TOutputImage >
+void IterativeInverseDisplacementFieldImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  const unsigned int ImageDimension = InputImageType::ImageDimension;
+
   if ( m_NumberOfIterations == 0 )
     {
-    this->GraftOutput( vectorWarper->GetOutput() );
+    return;
     }
-  else
+
+  InputImageConstPointer inputPtr = this->GetInput(0);
+  OutputImagePointer     outputPtr = this->GetOutput(0);
+
+  // calculate the inverted field
+  InputImagePointType         mappedPoint, newPoint;
+  OutputImagePointType        point, originalPoint, newRemappedPoint;
+  OutputImageIndexType        index;
+  OutputImagePixelType        displacement, outputValue;
+  FieldInterpolatorOutputType forwardVector;
+  double                      spacing = inputPtr->GetSpacing()[0];
+  double                      smallestError = 0;
+  int                         stillSamePoint;
+
+  ProgressReporter progress( this, threadId,
+                             outputRegionForThread.GetNumberOfPixels() );
+  OutputIterator           OutputIt = OutputIterator( outputPtr, outputRegionForThread );
+
+  // Each thread evaluates the input field with its own interpolator.
+  FieldInterpolatorPointer inputFieldInterpolator = FieldInterpolatorType::New();
+  inputFieldInterpolator->SetInputImage(inputPtr);
+
+  OutputIt.GoToBegin();
+  while ( !OutputIt.IsAtEnd() )
     {
-    // calculate the inverted field
-    InputImagePointType         mappedPoint, newPoint;
-    OutputImagePointType        point, originalPoint, newRemappedPoint;
-    OutputImageIndexType        index;
-    OutputImagePixelType        displacement, outputValue;
-    FieldInterpolatorOutputType forwardVector;
-    double                      spacing = inputPtr->GetSpacing()[0];
-    double                      smallestError = 0;
-    int                         stillSamePoint;
-    InputImageRegionType        region = inputPtr->GetLargestPossibleRegion();
-    unsigned int                numberOfPoints = 1;
-    for ( unsigned int i = 0; i < ImageDimension; i++ )
-      {
-      numberOfPoints *= region.GetSize()[i];
-      }
+    // get the output image index
+    index = OutputIt.GetIndex();
+    outputPtr->TransformIndexToPhysicalPoint(index, originalPoint);
 
-    ProgressReporter progress( this, 0,
-                               inputPtr->GetLargestPossibleRegion().GetNumberOfPixels() );
-    OutputIterator           OutputIt = OutputIterator( outputPtr, outputPtr->GetRequestedRegion() );
-    FieldInterpolatorPointer inputFieldInterpolator = FieldInterpolatorType::New();
-    inputFieldInterpolator->SetInputImage(inputPtr);
+    stillSamePoint = 0;
+    double step = spacing;
 
-    InputIt.GoToBegin();
-    OutputIt.GoToBegin();
-    while ( !OutputIt.IsAtEnd() )
-      {
-      // get the output image index
-      index = OutputIt.GetIndex();
-      outputPtr->TransformIndexToPhysicalPoint(index, originalPoint);
+    // get the required displacement
+    displacement = OutputIt.Get();
 
-      stillSamePoint = 0;
-      double step = spacing;
+    // compute the required input image point
+    for ( unsigned int j = 0; j < ImageDimension; j++ )
+      {
+      mappedPoint[j] = originalPoint[j] + displacement[j];
+      newPoint[j] = mappedPoint[j];
+      }
 
-      // get the required displacement
-      displacement = OutputIt.Get();
+    // calculate the error of the last iteration.  The error of a first guess
+    // outside of the input field is unknown, and must not be taken from the
+    // pixel previously visited by this thread.
+    smallestError = NumericTraits< double >::max();
+    if ( inputFieldInterpolator->IsInsideBuffer(mappedPoint) )
+      {
+      forwardVector = inputFieldInterpolator->Evaluate(mappedPoint);
 
-      // compute the required input image point
+      smallestError = 0;
       for ( unsigned int j = 0; j < ImageDimension; j++ )
         {
-        mappedPoint[j] = originalPoint[j] + displacement[j];
-        newPoint[j] = mappedPoint[j];
+        smallestError += vcl_pow(mappedPoint[j] + forwardVector[j] - originalPoint[j], 2);
         }
+      smallestError = vcl_sqrt(smallestError);
+      }
 
-      // calculate the error of the last iteration
-      if ( inputFieldInterpolator->IsInsideBuffer(mappedPoint) )
-        {
-        forwardVector = inputFieldInterpolator->Evaluate(mappedPoint);
+    // iteration loop
+    for ( unsigned int i = 0; i < m_NumberOfIterations; i++ )
+      {
+      double tmp;
 
-        smallestError = 0;
-        for ( unsigned int j = 0; j < ImageDimension; j++ )
-          {
-          smallestError += vcl_pow(mappedPoint[j] + forwardVector[j] - originalPoint[j], 2);
-          }
-        smallestError = vcl_sqrt(smallestError);
+      if ( stillSamePoint )
+        {
+        step = step / 2;
         }
 
-      // iteration loop
-      for ( unsigned int i = 0; i < m_NumberOfIterations; i++ )
+      for ( unsigned int k = 0; k < ImageDimension; k++ )
         {
-        double tmp;
-
-        if ( stillSamePoint )
-          {
-          step = step / 2;
-          }
-
-        for ( unsigned int k = 0; k < ImageDimension; k++ )
+        mappedPoint[k] += step;
+        if ( inputFieldInterpolator->IsInsideBuffer(mappedPoint) )
           {
-          mappedPoint[k] += step;
-          if ( inputFieldInterpolator->IsInsideBuffer(mappedPoint) )
+          forwardVector = inputFieldInterpolator->Evaluate(mappedPoint);
+          tmp = 0;
+          for ( unsigned int l = 0; l < ImageDimension; l++ )
             {
-            forwardVector = inputFieldInterpolator->Evaluate(mappedPoint);
-            tmp = 0;
-            for ( unsigned int l = 0; l < ImageDimension; l++ )
-              {
-              tmp += vcl_pow(mappedPoint[l] + forwardVector[l] - originalPoint[l], 2);
-              }
-            tmp = vcl_sqrt(tmp);
-            if ( tmp < smallestError )
-              {
-              smallestError = tmp;
-              for ( unsigned int l = 0; l < ImageDimension; l++ )
-                {
-                newPoint[l] = mappedPoint[l];
-                }
-              }
+            tmp += vcl_pow(mappedPoint[l] + forwardVector[l] - originalPoint[l], 2);
             }
-
-          mappedPoint[k] -= 2 * step;
-          if ( inputFieldInterpolator->IsInsideBuffer(mappedPoint) )
+          tmp = vcl_sqrt(tmp);
+          if ( tmp < smallestError )
             {
-            forwardVector = inputFieldInterpolator->Evaluate(mappedPoint);
-            tmp = 0;
+            smallestError = tmp;
             for ( unsigned int l = 0; l < ImageDimension; l++ )
               {
-              tmp += vcl_pow(mappedPoint[l] + forwardVector[l] - originalPoint[l], 2);
-              }
-            tmp = vcl_sqrt(tmp);
-            if ( tmp < smallestError )
-              {
-              smallestError = tmp;
-              for ( unsigned int l = 0; l < ImageDimension; l++ )
-                {
-                newPoint[l] = mappedPoint[l];
-                }
+              newPoint[l] = mappedPoint[l];
               }
             }
+          }
 
-          mappedPoint[k] += step;
-          } //end for loop over image dimension
-
-        stillSamePoint = 1;
-        for ( unsigned int j = 0; j < ImageDimension; j++ )
+        mappedPoint[k] -= 2 * step;
+        if ( inputFieldInterpolator->IsInsideBuffer(mappedPoint) )
           {
-          if ( newPoint[j] != mappedPoint[j] )
+          forwardVector = inputFieldInterpolator->Evaluate(mappedPoint);
+          tmp = 0;
+          for ( unsigned int l = 0; l < ImageDimension; l++ )
+            {
+            tmp += vcl_pow(mappedPoint[l] + forwardVector[l] - originalPoint[l], 2);
+            }
+          tmp = vcl_sqrt(tmp);
+          if ( tmp < smallestError )
             {
-            stillSamePoint = 0;
+            smallestError = tmp;
+            for ( unsigned int l = 0; l < ImageDimension; l++ )
+              {
+              newPoint[l] = mappedPoint[l];
+              }
             }
-          mappedPoint[j] = newPoint[j];
           }
 
-        if ( smallestError < m_StopValue )
+        mappedPoint[k] += step;
+        } //end for loop over image dimension
+
+      stillSamePoint = 1;
+      for ( unsigned int j = 0; j < ImageDimension; j++ )
+        {
+        if ( newPoint[j] != mappedPoint[j] )
           {
-          break;
+          stillSamePoint = 0;
           }
-        } //end iteration loop
+        mappedPoint[j] = newPoint[j];
+        }
 
-      for ( unsigned int k = 0; k < ImageDimension; k++ )
+      if ( smallestError < m_StopValue )
         {
-        outputValue[k] = static_cast< OutputImageValueType >( mappedPoint[k] - originalPoint[k] );
+        break;
         }
+      } //end iteration loop
 
-      OutputIt.Set(outputValue);
+    for ( unsigned int k = 0; k < ImageDimension; k++ )
+      {
+      outputValue[k] = static_cast< OutputImageValueType >( mappedPoint[k] - originalPoint[k] );
+      }
 
-      ++InputIt;
-      ++OutputIt;
+    OutputIt.Set(outputValue);
 
-      progress.CompletedPixel();
-      } //end while loop
-    }   //end else
+    ++OutputIt;
 
-  time.Stop();
-  m_Time = time.GetMean();
+    progress.CompletedPixel();
+    } //end while loop
 }
 
 //----------------------------------------------------------------------------
@@ -112,7 +112,11 @@ public:
   typedef typename TimeVaryingVelocityFieldType::SpacingType          TimeVaryingVelocityFieldSpacingType;
   typedef typename TimeVaryingVelocityFieldType::DirectionType        TimeVaryingVelocityFieldDirectionType;
 
-  typedef VectorInterpolateImageFunction<TimeVaryingVelocityFieldType, ScalarType>  TimeVaryingVelocityFieldInterpolatorType;
+  /** The interpolator evaluates the velocity field at real-valued
+   * coordinates, as required by the integration filter. */
+  typedef typename NumericTraits<ScalarType>::RealType                             InterpolatorCoordRepType;
+  typedef VectorInterpolateImageFunction<TimeVaryingVelocityFieldType, InterpolatorCoordRepType>
+                                                                                    TimeVaryingVelocityFieldInterpolatorType;
   typedef typename TimeVaryingVelocityFieldInterpolatorType::Pointer                TimeVaryingVelocityFieldInterpolatorPointer;
 
   typedef typename TimeVaryingVelocityFieldType::SizeType          SizeType;
@@ -49,7 +49,7 @@ TimeVaryingVelocityFieldTransform<TScalar, NDimensions>
   this->m_Parameters.SetHelper( helper );
 
   typedef VectorLinearInterpolateImageFunction
-    <TimeVaryingVelocityFieldType, ScalarType> DefaultInterpolatorType;
+    <TimeVaryingVelocityFieldType, InterpolatorCoordRepType> DefaultInterpolatorType;
 
   this->m_TimeVaryingVelocityFieldInterpolator = DefaultInterpolatorType::New();
 }
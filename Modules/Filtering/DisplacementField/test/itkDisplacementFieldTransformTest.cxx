@@ -304,6 +304,33 @@ int itkDisplacementFieldTransformTest(int, char *[] )
     return EXIT_FAILURE;
     }
 
+  /* Test transforming points along lines, on and off the field grid,
+   * partly outside of the field */
+  const unsigned int linePoints = 28;
+  const double       lineStarts[3][2] = { { -3.0, 8.0 }, { 5.0, -4.0 }, { -1.5, 2.25 } };
+  const double       lineSteps[3][2] = { { 1.0, 0.0 }, { 0.0, 2.0 }, { 0.75, 0.5 } };
+  for( unsigned int line = 0; line < 3; line++ )
+    {
+    DisplacementTransformType::InputPointType  linePoint[linePoints];
+    DisplacementTransformType::OutputPointType lineOutput[linePoints];
+    for( unsigned int i = 0; i < linePoints; i++ )
+      {
+      linePoint[i][0] = lineStarts[line][0] + i * lineSteps[line][0];
+      linePoint[i][1] = lineStarts[line][1] + i * lineSteps[line][1];
+      }
+    displacementTransform->TransformPointsAlongLine( linePoint, lineOutput, linePoints );
+    for( unsigned int i = 0; i < linePoints; i++ )
+      {
+      deformTruth = displacementTransform->TransformPoint( linePoint[i] );
+      if( !samePoint( lineOutput[i], deformTruth ) )
+        {
+        std::cout << "Failed transforming point " << linePoint[i] << " along line " << line
+                  << ". Should be " << deformTruth << " but is " << lineOutput[i] << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
   DisplacementTransformType::InputVectorType  testVector;
   DisplacementTransformType::OutputVectorType deformVector, deformVectorTruth;
   testVector[0] = 0.5;
@@ -117,6 +117,37 @@ int itkIterativeInverseDisplacementFieldImageFilterTest( int argc, char * argv[]
     return EXIT_FAILURE;
     }
 
+  // The inverse must not depend on the number of threads
+  FilterType::Pointer singleThreadedFilter = FilterType::New();
+  singleThreadedFilter->SetInput( field );
+  singleThreadedFilter->SetNumberOfThreads( 1 );
+
+  try
+    {
+    singleThreadedFilter->UpdateLargestPossibleRegion();
+    }
+  catch( itk::ExceptionObject & excp )
+    {
+    std::cerr << "Exception thrown " << std::endl;
+    std::cerr << excp << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itk::ImageRegionConstIterator< DisplacementFieldType > multiIt( filter->GetOutput(), region );
+  itk::ImageRegionConstIterator< DisplacementFieldType > singleIt( singleThreadedFilter->GetOutput(), region );
+  while( !multiIt.IsAtEnd() )
+    {
+    if( multiIt.Get() != singleIt.Get() )
+      {
+      std::cerr << "Multithreaded and single threaded outputs differ at "
+                << multiIt.GetIndex() << ": " << multiIt.Get() << " != "
+                << singleIt.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    ++multiIt;
+    ++singleIt;
+    }
+
   // Write an image for regression testing
   typedef itk::ImageFileWriter<  DisplacementFieldType  > WriterType;
 
@@ -0,0 +1,282 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkGradientHessianRecursiveGaussianImageFilter_h
+#define __itkGradientHessianRecursiveGaussianImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkRecursiveGaussianImageFilter.h"
+#include "itkCovariantVector.h"
+#include "itkSymmetricSecondRankTensor.h"
+#include "itkSymmetricEigenAnalysis.h"
+#include "itkProgressAccumulator.h"
+
+#include <vector>
+
+namespace itk
+{
+/** \class GradientHessianRecursiveGaussianImageFilter
+ * \brief Computes the smoothed image, the gradient, the Hessian and the
+ * eigenvalues of the Hessian of an image at one scale, sharing the passes of
+ * the recursive Gaussian filters between them.
+ *
+ * The derivatives of the image convolved with a Gaussian are computed by
+ * recursive Gaussian filters of order 0, 1 or 2 along each axis, in the
+ * order of the axes.  The filter computes these passes as a tree: the
+ * result of a pass along an axis is used by all the derivatives that have
+ * the same orders along the previous axes.  In 3D, the six Hessian
+ * components need 15 passes instead of the 18 of
+ * HessianRecursiveGaussianImageFilter, and the smoothed image, the gradient
+ * and the Hessian together need 19 passes instead of 30 for three separate
+ * filters.  The derivatives are then combined into the requested outputs in
+ * one multithreaded traversal.
+ *
+ * The outputs are selected with ComputeSmoothed, ComputeGradient,
+ * ComputeHessian and ComputeEigenValues; the outputs that are not selected
+ * are not allocated.  The eigenvalues are computed from the derivatives
+ * directly, so the Hessian image is not needed to get them.  The gradient
+ * and the Hessian are expressed in the units of the image spacing, as with
+ * GradientRecursiveGaussianImageFilter and
+ * HessianRecursiveGaussianImageFilter.  As with
+ * GradientRecursiveGaussianImageFilter, the gradient is reoriented to the
+ * physical space by the direction of the input image when UseImageDirection
+ * is on, which is the default.  The Hessian is expressed on the image grid,
+ * as with HessianRecursiveGaussianImageFilter; its eigenvalues do not
+ * depend on the direction.
+ *
+ * The derivative images are all kept until they are combined into the
+ * outputs.  The peak memory of this filter is therefore that of the
+ * selected outputs, plus one image of InternalRealType per computed
+ * derivative component (one for the smoothed image, ImageDimension for the
+ * gradient, and ImageDimension * (ImageDimension + 1) / 2 for the Hessian
+ * or its eigenvalues), plus up to ImageDimension - 1 intermediate images of
+ * the passes.  For instance, the Hessian and the eigenvalues of a 3D image
+ * with float outputs need as much memory as 17 float images.
+ *
+ * \sa HessianRecursiveGaussianImageFilter
+ * \sa GradientRecursiveGaussianImageFilter
+ * \sa SymmetricEigenAnalysisImageFilter
+ *
+ * \ingroup GradientFilters
+ * \ingroup ITKImageFeature
+ */
+template< typename TInputImage, typename TOutputValueType = float >
+class ITK_EXPORT GradientHessianRecursiveGaussianImageFilter:
+  public ImageToImageFilter< TInputImage,
+                             Image< TOutputValueType, ::itk::GetImageDimension< TInputImage >::ImageDimension > >
+{
+public:
+  /** Image dimension. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      ::itk::GetImageDimension< TInputImage >::ImageDimension);
+
+  /** Standard class typedefs. */
+  typedef GradientHessianRecursiveGaussianImageFilter                 Self;
+  typedef Image< TOutputValueType,
+                 itkGetStaticConstMacro(ImageDimension) >             SmoothedImageType;
+  typedef ImageToImageFilter< TInputImage, SmoothedImageType >        Superclass;
+  typedef SmartPointer< Self >                                        Pointer;
+  typedef SmartPointer< const Self >                                  ConstPointer;
+
+  /** Run-time type information (and related methods).   */
+  itkTypeMacro(GradientHessianRecursiveGaussianImageFilter, ImageToImageFilter);
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Pixel Type of the input image */
+  typedef TInputImage                                   InputImageType;
+  typedef typename TInputImage::PixelType               PixelType;
+  typedef typename NumericTraits< PixelType >::RealType RealType;
+
+  /** Types of the outputs. */
+  typedef TOutputValueType OutputValueType;
+  typedef CovariantVector< OutputValueType,
+                           itkGetStaticConstMacro(ImageDimension) >           GradientPixelType;
+  typedef Image< GradientPixelType, itkGetStaticConstMacro(ImageDimension) > GradientImageType;
+  typedef SymmetricSecondRankTensor< OutputValueType,
+                                     itkGetStaticConstMacro(ImageDimension) > HessianPixelType;
+  typedef Image< HessianPixelType, itkGetStaticConstMacro(ImageDimension) >  HessianImageType;
+  typedef FixedArray< OutputValueType,
+                      itkGetStaticConstMacro(ImageDimension) >                EigenValuePixelType;
+  typedef Image< EigenValuePixelType,
+                 itkGetStaticConstMacro(ImageDimension) >                     EigenValueImageType;
+
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+  /** Define the image type for internal computations
+      RealType is usually 'double' in NumericTraits.
+      Here we prefer float in order to save memory.  */
+  typedef float InternalRealType;
+  typedef Image< InternalRealType,
+                 itkGetStaticConstMacro(ImageDimension) > RealImageType;
+
+  /** Type of the filters of the first axis, applied to the input. */
+  typedef RecursiveGaussianImageFilter< InputImageType, RealImageType > FirstPassFilterType;
+
+  /** Type of the filters of the other axes. */
+  typedef RecursiveGaussianImageFilter< RealImageType, RealImageType > PassFilterType;
+
+  /** Eigenvalue calculator and ordering of the eigenvalues. */
+  typedef SymmetricEigenAnalysis< HessianPixelType, EigenValuePixelType > EigenAnalysisType;
+  typedef typename EigenAnalysisType::EigenValueOrderType                 EigenValueOrderType;
+
+  typedef typename Superclass::DataObjectPointer        DataObjectPointer;
+  typedef ProcessObject::DataObjectPointerArraySizeType DataObjectPointerArraySizeType;
+
+  /** Set Sigma value. Sigma is measured in the units of image spacing.  */
+  void SetSigma(RealType sigma);
+  RealType GetSigma() const;
+
+  /** Define which normalization factor will be used for the Gaussian
+   *  \sa  RecursiveGaussianImageFilter::SetNormalizeAcrossScale
+   */
+  void SetNormalizeAcrossScale(bool normalizeInScaleSpace);
+  itkGetConstMacro(NormalizeAcrossScale, bool);
+
+  /** Select the outputs to compute.  Only the Hessian is computed by
+   * default. */
+  itkSetMacro(ComputeSmoothed, bool);
+  itkGetConstMacro(ComputeSmoothed, bool);
+  itkBooleanMacro(ComputeSmoothed);
+  itkSetMacro(ComputeGradient, bool);
+  itkGetConstMacro(ComputeGradient, bool);
+  itkBooleanMacro(ComputeGradient);
+  itkSetMacro(ComputeHessian, bool);
+  itkGetConstMacro(ComputeHessian, bool);
+  itkBooleanMacro(ComputeHessian);
+  itkSetMacro(ComputeEigenValues, bool);
+  itkGetConstMacro(ComputeEigenValues, bool);
+  itkBooleanMacro(ComputeEigenValues);
+
+  /** Set/Get whether the gradient is reoriented to the physical space by
+   * the direction of the input image, as in
+   * GradientRecursiveGaussianImageFilter.  The default is On.
+   * \sa GradientRecursiveGaussianImageFilter::SetUseImageDirection() */
+  itkSetMacro(UseImageDirection, bool);
+  itkGetConstMacro(UseImageDirection, bool);
+  itkBooleanMacro(UseImageDirection);
+
+  /** Order the eigenvalues.  Default is to OrderByValue:  lambda_1 <
+   * lambda_2 < .... */
+  void OrderEigenValuesBy(EigenValueOrderType order);
+  itkGetConstMacro(EigenValueOrder, EigenValueOrderType);
+
+  /** Get the outputs.  The smoothed image is the primary output. */
+  SmoothedImageType * GetSmoothedOutput();
+  GradientImageType * GetGradientOutput();
+  HessianImageType * GetHessianOutput();
+  EigenValueImageType * GetEigenValuesOutput();
+
+  /** GradientHessianRecursiveGaussianImageFilter needs all of the input to
+   * produce an output. Therefore, it needs to provide an implementation for
+   * GenerateInputRequestedRegion in order to inform the pipeline execution
+   * model.
+   * \sa ImageToImageFilter::GenerateInputRequestedRegion() */
+  virtual void GenerateInputRequestedRegion()
+  throw( InvalidRequestedRegionError );
+
+  /** Bring the selected outputs up to date.  The primary output is not
+   * buffered when ComputeSmoothed is off, so the filter is updated through
+   * the first selected output instead, which would otherwise execute the
+   * filter again on every update. */
+  virtual void Update();
+  virtual void UpdateLargestPossibleRegion();
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  /** Begin concept checking */
+  itkConceptMacro( InputHasNumericTraitsCheck,
+                   ( Concept::HasNumericTraits< PixelType > ) );
+  itkConceptMacro( OutputValueIsFloatingPointCheck,
+                   ( Concept::IsFloatingPoint< OutputValueType > ) );
+  /** End concept checking */
+#endif
+protected:
+  GradientHessianRecursiveGaussianImageFilter();
+  virtual ~GradientHessianRecursiveGaussianImageFilter() {}
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+  using Superclass::MakeOutput;
+  virtual DataObjectPointer MakeOutput(DataObjectPointerArraySizeType idx);
+
+  /** Allocate the selected outputs only. */
+  void AllocateOutputs();
+
+  /** Compute the derivatives needed by the selected outputs. */
+  void BeforeThreadedGenerateData();
+
+  /** Combine the derivatives into the selected outputs. */
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId);
+
+  /** Release the derivatives. */
+  void AfterThreadedGenerateData();
+
+  // Override since the filter produces the entire dataset
+  void EnlargeOutputRequestedRegion(DataObject *output);
+
+private:
+  GradientHessianRecursiveGaussianImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);                              //purposely not implemented
+
+  /** The first selected output, or the primary output if none is. */
+  DataObject * GetFirstComputedOutput();
+
+  /** Whether the derivatives of a total order are needed. */
+  bool IsOrderNeeded(unsigned int totalOrder) const;
+
+  /** Whether a pass of total order totalOrder along an axis leads to a
+   * needed derivative. */
+  bool IsPassNeeded(unsigned int axis, unsigned int totalOrder) const;
+
+  /** Number of passes needed along the axes from axis, after passes of
+   * total order totalOrder. */
+  unsigned int CountPasses(unsigned int axis, unsigned int totalOrder) const;
+
+  /** Filter the result of the passes along the axes before axis, whose
+   * derivative orders are encoded in code, along axis and the next ones. */
+  void ComputeDerivatives(RealImageType *image, unsigned int axis,
+                          unsigned int totalOrder, unsigned int code,
+                          ProgressAccumulator *progress);
+
+  /** Index in m_Derivatives of the first derivative along an axis.  The
+   * orders of a derivative along the axes are the digits in base 3 of its
+   * index, so the second derivative along the axes a and b has the index
+   * AxisCode(a) + AxisCode(b). */
+  static unsigned int AxisCode(unsigned int axis);
+
+  typename FirstPassFilterType::Pointer m_FirstPassFilters[3];
+  typename PassFilterType::Pointer      m_PassFilters[3];
+
+  std::vector< typename RealImageType::Pointer > m_Derivatives;
+
+  bool                m_NormalizeAcrossScale;
+  bool                m_ComputeSmoothed;
+  bool                m_ComputeGradient;
+  bool                m_ComputeHessian;
+  bool                m_ComputeEigenValues;
+  bool                m_UseImageDirection;
+  EigenValueOrderType m_EigenValueOrder;
+  float               m_PassesProgressWeight;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkGradientHessianRecursiveGaussianImageFilter.hxx"
+#endif
+
+#endif
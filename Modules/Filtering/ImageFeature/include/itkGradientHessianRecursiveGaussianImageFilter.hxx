@@ -0,0 +1,586 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkGradientHessianRecursiveGaussianImageFilter_hxx
+#define __itkGradientHessianRecursiveGaussianImageFilter_hxx
+
+#include "itkGradientHessianRecursiveGaussianImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkProgressReporter.h"
+
+namespace itk
+{
+/**
+ * Constructor
+ */
+template< typename TInputImage, typename TOutputValueType >
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::GradientHessianRecursiveGaussianImageFilter()
+{
+  m_NormalizeAcrossScale = false;
+  m_ComputeSmoothed = false;
+  m_ComputeGradient = false;
+  m_ComputeHessian = true;
+  m_ComputeEigenValues = false;
+  m_UseImageDirection = true;
+  m_EigenValueOrder = EigenAnalysisType::OrderByValue;
+  m_PassesProgressWeight = 0.0f;
+
+  for ( unsigned int order = 0; order < 3; order++ )
+    {
+    m_FirstPassFilters[order] = FirstPassFilterType::New();
+    m_FirstPassFilters[order]->SetOrder( static_cast< typename FirstPassFilterType::OrderEnumType >( order ) );
+    m_FirstPassFilters[order]->SetNormalizeAcrossScale(m_NormalizeAcrossScale);
+    m_FirstPassFilters[order]->InPlaceOff();
+
+    m_PassFilters[order] = PassFilterType::New();
+    m_PassFilters[order]->SetOrder( static_cast< typename PassFilterType::OrderEnumType >( order ) );
+    m_PassFilters[order]->SetNormalizeAcrossScale(m_NormalizeAcrossScale);
+    }
+
+  this->SetNumberOfRequiredOutputs(4);
+  for ( unsigned int i = 1; i < 4; i++ )
+    {
+    this->SetNthOutput( i, this->MakeOutput(i) );
+    }
+
+  this->SetSigma(1.0);
+}
+
+template< typename TInputImage, typename TOutputValueType >
+typename GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >::DataObjectPointer
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::MakeOutput(DataObjectPointerArraySizeType idx)
+{
+  if ( idx == 1 )
+    {
+    return static_cast< DataObject * >( GradientImageType::New().GetPointer() );
+    }
+  if ( idx == 2 )
+    {
+    return static_cast< DataObject * >( HessianImageType::New().GetPointer() );
+    }
+  if ( idx == 3 )
+    {
+    return static_cast< DataObject * >( EigenValueImageType::New().GetPointer() );
+    }
+  return Superclass::MakeOutput(idx);
+}
+
+template< typename TInputImage, typename TOutputValueType >
+typename GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >::SmoothedImageType *
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::GetSmoothedOutput()
+{
+  return this->GetOutput();
+}
+
+template< typename TInputImage, typename TOutputValueType >
+typename GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >::GradientImageType *
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::GetGradientOutput()
+{
+  return dynamic_cast< GradientImageType * >( this->ProcessObject::GetOutput(1) );
+}
+
+template< typename TInputImage, typename TOutputValueType >
+typename GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >::HessianImageType *
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::GetHessianOutput()
+{
+  return dynamic_cast< HessianImageType * >( this->ProcessObject::GetOutput(2) );
+}
+
+template< typename TInputImage, typename TOutputValueType >
+typename GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >::EigenValueImageType *
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::GetEigenValuesOutput()
+{
+  return dynamic_cast< EigenValueImageType * >( this->ProcessObject::GetOutput(3) );
+}
+
+/**
+ * Set value of Sigma
+ */
+template< typename TInputImage, typename TOutputValueType >
+void
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::SetSigma(RealType sigma)
+{
+  for ( unsigned int order = 0; order < 3; order++ )
+    {
+    m_FirstPassFilters[order]->SetSigma(sigma);
+    m_PassFilters[order]->SetSigma(sigma);
+    }
+
+  this->Modified();
+}
+
+template< typename TInputImage, typename TOutputValueType >
+typename GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >::RealType
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::GetSigma() const
+{
+  return m_PassFilters[0]->GetSigma();
+}
+
+/**
+ * Set Normalize Across Scale Space
+ */
+template< typename TInputImage, typename TOutputValueType >
+void
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::SetNormalizeAcrossScale(bool normalize)
+{
+  m_NormalizeAcrossScale = normalize;
+
+  for ( unsigned int order = 0; order < 3; order++ )
+    {
+    m_FirstPassFilters[order]->SetNormalizeAcrossScale(normalize);
+    m_PassFilters[order]->SetNormalizeAcrossScale(normalize);
+    }
+
+  this->Modified();
+}
+
+template< typename TInputImage, typename TOutputValueType >
+void
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::OrderEigenValuesBy(EigenValueOrderType order)
+{
+  if ( m_EigenValueOrder != order )
+    {
+    m_EigenValueOrder = order;
+    this->Modified();
+    }
+}
+
+//
+//
+//
+template< typename TInputImage, typename TOutputValueType >
+void
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::GenerateInputRequestedRegion()
+throw( InvalidRequestedRegionError )
+{
+  // call the superclass' implementation of this method. this should
+  // copy the output requested region to the input requested region
+  Superclass::GenerateInputRequestedRegion();
+
+  // This filter needs all of the input
+  InputImageType *image = const_cast< InputImageType * >( this->GetInput() );
+  if ( image )
+    {
+    image->SetRequestedRegion( image->GetLargestPossibleRegion() );
+    }
+}
+
+//
+//
+//
+template< typename TInputImage, typename TOutputValueType >
+void
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::EnlargeOutputRequestedRegion(DataObject *output)
+{
+  typedef ImageBase< ImageDimension > ImageBaseType;
+  ImageBaseType *out = dynamic_cast< ImageBaseType * >( output );
+
+  if ( out )
+    {
+    out->SetRequestedRegion( out->GetLargestPossibleRegion() );
+    }
+}
+
+template< typename TInputImage, typename TOutputValueType >
+DataObject *
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::GetFirstComputedOutput()
+{
+  const bool computed[4] =
+    { m_ComputeSmoothed, m_ComputeGradient, m_ComputeHessian, m_ComputeEigenValues };
+
+  for ( unsigned int i = 0; i < 4; i++ )
+    {
+    if ( computed[i] )
+      {
+      return this->ProcessObject::GetOutput(i);
+      }
+    }
+  return this->GetPrimaryOutput();
+}
+
+template< typename TInputImage, typename TOutputValueType >
+void
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::Update()
+{
+  this->GetFirstComputedOutput()->Update();
+}
+
+template< typename TInputImage, typename TOutputValueType >
+void
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::UpdateLargestPossibleRegion()
+{
+  this->UpdateOutputInformation();
+  DataObject *output = this->GetFirstComputedOutput();
+  output->SetRequestedRegionToLargestPossibleRegion();
+  output->Update();
+}
+
+template< typename TInputImage, typename TOutputValueType >
+unsigned int
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::AxisCode(unsigned int axis)
+{
+  unsigned int code = 1;
+  for ( unsigned int i = 0; i < axis; i++ )
+    {
+    code *= 3;
+    }
+  return code;
+}
+
+template< typename TInputImage, typename TOutputValueType >
+bool
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::IsOrderNeeded(unsigned int totalOrder) const
+{
+  switch ( totalOrder )
+    {
+    case 0:
+      return m_ComputeSmoothed;
+    case 1:
+      return m_ComputeGradient;
+    case 2:
+      return m_ComputeHessian || m_ComputeEigenValues;
+    default:
+      return false;
+    }
+}
+
+template< typename TInputImage, typename TOutputValueType >
+bool
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::IsPassNeeded(unsigned int axis, unsigned int totalOrder) const
+{
+  // The last pass must reach a needed order, the previous ones must not
+  // exceed all of them.
+  if ( axis == ImageDimension - 1 )
+    {
+    return this->IsOrderNeeded(totalOrder);
+    }
+  for ( unsigned int order = totalOrder; order <= 2; order++ )
+    {
+    if ( this->IsOrderNeeded(order) )
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+template< typename TInputImage, typename TOutputValueType >
+unsigned int
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::CountPasses(unsigned int axis, unsigned int totalOrder) const
+{
+  unsigned int count = 0;
+  if ( axis < ImageDimension )
+    {
+    for ( unsigned int order = 0; order < 3; order++ )
+      {
+      if ( this->IsPassNeeded(axis, totalOrder + order) )
+        {
+        count += 1 + this->CountPasses(axis + 1, totalOrder + order);
+        }
+      }
+    }
+  return count;
+}
+
+template< typename TInputImage, typename TOutputValueType >
+void
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::AllocateOutputs()
+{
+  const bool computed[4] =
+    { m_ComputeSmoothed, m_ComputeGradient, m_ComputeHessian, m_ComputeEigenValues };
+
+  typedef ImageBase< ImageDimension > ImageBaseType;
+  for ( unsigned int i = 0; i < 4; i++ )
+    {
+    ImageBaseType *output = dynamic_cast< ImageBaseType * >( this->ProcessObject::GetOutput(i) );
+    if ( computed[i] )
+      {
+      output->SetBufferedRegion( output->GetRequestedRegion() );
+      output->Allocate();
+      }
+    else
+      {
+      output->ReleaseData();
+      }
+    }
+}
+
+/**
+ * Compute the derivatives with a tree of recursive Gaussian filters
+ */
+template< typename TInputImage, typename TOutputValueType >
+void
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::BeforeThreadedGenerateData()
+{
+  itkDebugMacro(<< "GradientHessianRecursiveGaussianImageFilter generating data ");
+
+  m_Derivatives.clear();
+  m_Derivatives.resize( AxisCode(ImageDimension) );
+
+  // Create a process accumulator for tracking the progress of this
+  // minipipeline.  Each pass and the final combination of the
+  // derivatives contribute equally to the total progress.
+  const unsigned int numberOfPasses = this->CountPasses(0, 0);
+  m_PassesProgressWeight = static_cast< float >( numberOfPasses ) / ( numberOfPasses + 1 );
+
+  ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
+  progress->SetMiniPipelineFilter(this);
+  for ( unsigned int order = 0; order < 3; order++ )
+    {
+    progress->RegisterInternalFilter( m_FirstPassFilters[order], 1.0f / ( numberOfPasses + 1 ) );
+    progress->RegisterInternalFilter( m_PassFilters[order], 1.0f / ( numberOfPasses + 1 ) );
+    }
+
+  if ( numberOfPasses > 0 )
+    {
+    this->ComputeDerivatives(0, 0, 0, 0, progress);
+    }
+}
+
+template< typename TInputImage, typename TOutputValueType >
+void
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::ComputeDerivatives(RealImageType *image, unsigned int axis,
+                     unsigned int totalOrder, unsigned int code,
+                     ProgressAccumulator *progress)
+{
+  if ( axis == ImageDimension )
+    {
+    m_Derivatives[code] = image;
+    return;
+    }
+
+  // The orders of the passes along this axis that lead to a needed
+  // derivative.  The last one may overwrite the image.
+  unsigned int orders[3];
+  unsigned int numberOfOrders = 0;
+  for ( unsigned int order = 0; order < 3; order++ )
+    {
+    if ( this->IsPassNeeded(axis, totalOrder + order) )
+      {
+      orders[numberOfOrders++] = order;
+      }
+    }
+
+  for ( unsigned int i = 0; i < numberOfOrders; i++ )
+    {
+    const unsigned int order = orders[i];
+
+    typename RealImageType::Pointer result;
+    if ( axis == 0 )
+      {
+      FirstPassFilterType *filter = m_FirstPassFilters[order];
+      filter->SetInput( this->GetInput() );
+      filter->SetDirection(axis);
+      filter->SetNumberOfThreads( this->GetNumberOfThreads() );
+      filter->UpdateLargestPossibleRegion();
+      result = filter->GetOutput();
+      filter->SetInput(0);
+      }
+    else
+      {
+      PassFilterType *filter = m_PassFilters[order];
+      filter->SetInput(image);
+      filter->SetDirection(axis);
+      filter->SetInPlace( i == numberOfOrders - 1 );
+      filter->SetNumberOfThreads( this->GetNumberOfThreads() );
+      filter->UpdateLargestPossibleRegion();
+      result = filter->GetOutput();
+      filter->SetInput(0);
+      }
+    // Neither the filter nor its output keeps the pass alive.
+    result->DisconnectPipeline();
+
+    progress->ResetFilterProgressAndKeepAccumulatedProgress();
+
+    this->ComputeDerivatives(result, axis + 1, totalOrder + order,
+                             code + order * AxisCode(axis), progress);
+    }
+}
+
+/**
+ * Combine the derivatives into the outputs
+ */
+template< typename TInputImage, typename TOutputValueType >
+void
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  typedef ImageRegionConstIterator< RealImageType > DerivativeIteratorType;
+
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels(), 100,
+                             m_PassesProgressWeight, 1.0f - m_PassesProgressWeight );
+
+  // Iterators over the derivatives that were computed
+  std::vector< DerivativeIteratorType > derivatives( m_Derivatives.size() );
+  std::vector< unsigned int >           codes;
+  for ( unsigned int code = 0; code < m_Derivatives.size(); code++ )
+    {
+    if ( m_Derivatives[code] )
+      {
+      derivatives[code] = DerivativeIteratorType(m_Derivatives[code], outputRegionForThread);
+      codes.push_back(code);
+      }
+    }
+
+  ImageRegionIterator< SmoothedImageType >   smoothedIt;
+  ImageRegionIterator< GradientImageType >   gradientIt;
+  ImageRegionIterator< HessianImageType >    hessianIt;
+  ImageRegionIterator< EigenValueImageType > eigenValuesIt;
+  if ( m_ComputeSmoothed )
+    {
+    smoothedIt = ImageRegionIterator< SmoothedImageType >(this->GetSmoothedOutput(), outputRegionForThread);
+    }
+  if ( m_ComputeGradient )
+    {
+    gradientIt = ImageRegionIterator< GradientImageType >(this->GetGradientOutput(), outputRegionForThread);
+    }
+  if ( m_ComputeHessian )
+    {
+    hessianIt = ImageRegionIterator< HessianImageType >(this->GetHessianOutput(), outputRegionForThread);
+    }
+  if ( m_ComputeEigenValues )
+    {
+    eigenValuesIt = ImageRegionIterator< EigenValueImageType >(this->GetEigenValuesOutput(), outputRegionForThread);
+    }
+
+  EigenAnalysisType calculator(ImageDimension);
+  if ( m_EigenValueOrder == EigenAnalysisType::OrderByMagnitude )
+    {
+    calculator.SetOrderEigenMagnitudes(true);
+    }
+  else if ( m_EigenValueOrder == EigenAnalysisType::DoNotOrder )
+    {
+    calculator.SetOrderEigenValues(false);
+    }
+
+  // The derivatives are expressed in the units of the image spacing
+  const InputImageType *                       input = this->GetInput();
+  const typename InputImageType::SpacingType & spacing = input->GetSpacing();
+
+  const bool computeSecondOrder = m_ComputeHessian || m_ComputeEigenValues;
+
+  GradientPixelType   gradient;
+  GradientPixelType   orientedGradient;
+  HessianPixelType    hessian;
+  EigenValuePixelType eigenValues;
+
+  SizeValueType numberOfPixels = outputRegionForThread.GetNumberOfPixels();
+  while ( numberOfPixels-- > 0 )
+    {
+    if ( m_ComputeSmoothed )
+      {
+      smoothedIt.Set( static_cast< OutputValueType >( derivatives[0].Get() ) );
+      ++smoothedIt;
+      }
+    if ( m_ComputeGradient )
+      {
+      for ( unsigned int a = 0; a < ImageDimension; a++ )
+        {
+        gradient[a] = static_cast< OutputValueType >( derivatives[AxisCode(a)].Get() / spacing[a] );
+        }
+      if ( m_UseImageDirection )
+        {
+        input->TransformLocalVectorToPhysicalVector(gradient, orientedGradient);
+        gradientIt.Set(orientedGradient);
+        }
+      else
+        {
+        gradientIt.Set(gradient);
+        }
+      ++gradientIt;
+      }
+    if ( computeSecondOrder )
+      {
+      for ( unsigned int a = 0; a < ImageDimension; a++ )
+        {
+        for ( unsigned int b = a; b < ImageDimension; b++ )
+          {
+          hessian(a, b) = static_cast< OutputValueType >(
+            derivatives[AxisCode(a) + AxisCode(b)].Get() / ( spacing[a] * spacing[b] ) );
+          }
+        }
+      if ( m_ComputeHessian )
+        {
+        hessianIt.Set(hessian);
+        ++hessianIt;
+        }
+      if ( m_ComputeEigenValues )
+        {
+        calculator.ComputeEigenValues(hessian, eigenValues);
+        eigenValuesIt.Set(eigenValues);
+        ++eigenValuesIt;
+        }
+      }
+
+    for ( unsigned int i = 0; i < codes.size(); i++ )
+      {
+      ++derivatives[codes[i]];
+      }
+    progress.CompletedPixel();
+    }
+}
+
+template< typename TInputImage, typename TOutputValueType >
+void
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::AfterThreadedGenerateData()
+{
+  // release the memory of the derivatives
+  m_Derivatives.clear();
+}
+
+template< typename TInputImage, typename TOutputValueType >
+void
+GradientHessianRecursiveGaussianImageFilter< TInputImage, TOutputValueType >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Sigma: " << this->GetSigma() << std::endl;
+  os << indent << "NormalizeAcrossScale: " << m_NormalizeAcrossScale << std::endl;
+  os << indent << "ComputeSmoothed: " << m_ComputeSmoothed << std::endl;
+  os << indent << "ComputeGradient: " << m_ComputeGradient << std::endl;
+  os << indent << "ComputeHessian: " << m_ComputeHessian << std::endl;
+  os << indent << "ComputeEigenValues: " << m_ComputeEigenValues << std::endl;
+  os << indent << "UseImageDirection: " << ( m_UseImageDirection ? "On" : "Off" ) << std::endl;
+  os << indent << "EigenValueOrder: " << m_EigenValueOrder << std::endl;
+}
+} // end namespace itk
+
+#endif
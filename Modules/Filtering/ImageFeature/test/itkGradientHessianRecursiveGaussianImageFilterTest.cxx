@@ -0,0 +1,282 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkGradientHessianRecursiveGaussianImageFilter.h"
+#include "itkHessianRecursiveGaussianImageFilter.h"
+#include "itkGradientRecursiveGaussianImageFilter.h"
+#include "itkSmoothingRecursiveGaussianImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkSimpleFilterWatcher.h"
+
+#include <vector>
+
+/*
+ * Compare the outputs of the fused filter with the smoothing, gradient and
+ * Hessian recursive Gaussian filters, and its eigenvalues with the
+ * eigenvalues of its Hessian, for an image with an identity and with an
+ * oblique direction.
+ */
+
+int itkGradientHessianRecursiveGaussianImageFilterTest(int, char* [] )
+{
+  const unsigned int Dimension = 3;
+
+  typedef itk::Image< float, Dimension >                                  ImageType;
+  typedef itk::GradientHessianRecursiveGaussianImageFilter< ImageType, double > FilterType;
+
+  ImageType::SizeType size;
+  size[0] = 24;
+  size[1] = 20;
+  size[2] = 16;
+
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.0;
+  spacing[1] = 0.8;
+  spacing[2] = 1.5;
+
+  ImageType::Pointer inputImage = ImageType::New();
+  inputImage->SetRegions( size );
+  inputImage->SetSpacing( spacing );
+  inputImage->Allocate();
+
+  // An anisotropic blob and a ramp
+  itk::ImageRegionIteratorWithIndex< ImageType > it( inputImage, inputImage->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    const double x = ( index[0] - 11.0 ) / 4.0;
+    const double y = ( index[1] - 9.0 ) / 3.0;
+    const double z = ( index[2] - 7.0 ) / 2.0;
+    it.Set( static_cast< float >( 100.0 * vcl_exp( -0.5 * ( x * x + y * y + z * z + x * y ) ) + index[1] ) );
+    }
+
+  const double sigma = 2.0;
+
+  FilterType::Pointer filter = FilterType::New();
+  itk::SimpleFilterWatcher watcher( filter, "filter" );
+  filter->SetInput( inputImage );
+  filter->SetSigma( sigma );
+  filter->SetNormalizeAcrossScale( true );
+  filter->ComputeSmoothedOn();
+  filter->ComputeGradientOn();
+  filter->ComputeHessianOn();
+  filter->ComputeEigenValuesOn();
+  filter->OrderEigenValuesBy( FilterType::EigenAnalysisType::OrderByMagnitude );
+
+  typedef itk::SmoothingRecursiveGaussianImageFilter< ImageType, ImageType > SmoothingFilterType;
+  SmoothingFilterType::Pointer smoothing = SmoothingFilterType::New();
+  smoothing->SetInput( inputImage );
+  smoothing->SetSigma( sigma );
+
+  typedef itk::GradientRecursiveGaussianImageFilter< ImageType > GradientFilterType;
+  GradientFilterType::Pointer gradient = GradientFilterType::New();
+  gradient->SetInput( inputImage );
+  gradient->SetSigma( sigma );
+  gradient->SetNormalizeAcrossScale( true );
+
+  typedef itk::HessianRecursiveGaussianImageFilter< ImageType > HessianFilterType;
+  HessianFilterType::Pointer hessian = HessianFilterType::New();
+  hessian->SetInput( inputImage );
+  hessian->SetSigma( sigma );
+  hessian->SetNormalizeAcrossScale( true );
+
+  try
+    {
+    filter->Update();
+    smoothing->Update();
+    gradient->Update();
+    hessian->Update();
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << "Exception caught: " << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The passes are applied in different orders on float images
+  const double tolerance = 1.0e-3;
+
+  FilterType::EigenAnalysisType calculator( Dimension );
+  calculator.SetOrderEigenMagnitudes( true );
+
+  double maximumSmoothedError = 0.0;
+  double maximumGradientError = 0.0;
+  double maximumHessianError = 0.0;
+  double maximumEigenValueError = 0.0;
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+
+    maximumSmoothedError = vnl_math_max( maximumSmoothedError,
+      vnl_math_abs( filter->GetSmoothedOutput()->GetPixel( index ) - smoothing->GetOutput()->GetPixel( index ) ) );
+
+    const FilterType::GradientPixelType         g = filter->GetGradientOutput()->GetPixel( index );
+    const GradientFilterType::OutputPixelType   gr = gradient->GetOutput()->GetPixel( index );
+    for ( unsigned int a = 0; a < Dimension; a++ )
+      {
+      maximumGradientError = vnl_math_max( maximumGradientError, vnl_math_abs( g[a] - gr[a] ) );
+      }
+
+    const FilterType::HessianPixelType        h = filter->GetHessianOutput()->GetPixel( index );
+    const HessianFilterType::OutputPixelType  hr = hessian->GetOutput()->GetPixel( index );
+    for ( unsigned int k = 0; k < FilterType::HessianPixelType::Dimension; k++ )
+      {
+      maximumHessianError = vnl_math_max( maximumHessianError, vnl_math_abs( h[k] - hr[k] ) );
+      }
+
+    FilterType::EigenValuePixelType eigenValues;
+    calculator.ComputeEigenValues( h, eigenValues );
+    const FilterType::EigenValuePixelType ev = filter->GetEigenValuesOutput()->GetPixel( index );
+    for ( unsigned int a = 0; a < Dimension; a++ )
+      {
+      maximumEigenValueError = vnl_math_max( maximumEigenValueError, vnl_math_abs( ev[a] - eigenValues[a] ) );
+      }
+    }
+
+  std::cout << "Maximum smoothed image error: " << maximumSmoothedError << std::endl;
+  std::cout << "Maximum gradient error: " << maximumGradientError << std::endl;
+  std::cout << "Maximum Hessian error: " << maximumHessianError << std::endl;
+  std::cout << "Maximum eigenvalue error: " << maximumEigenValueError << std::endl;
+
+  if ( maximumSmoothedError > tolerance || maximumGradientError > tolerance
+       || maximumHessianError > tolerance || maximumEigenValueError > tolerance )
+    {
+    std::cerr << "The fused filter differs from the separate filters." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Only the selected outputs are allocated
+  filter->ComputeSmoothedOff();
+  filter->ComputeGradientOff();
+  filter->ComputeHessianOff();
+  try
+    {
+    filter->Update();
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << "Exception caught: " << e << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( filter->GetHessianOutput()->GetBufferedRegion().GetNumberOfPixels() != 0
+       || filter->GetEigenValuesOutput()->GetBufferedRegion() != inputImage->GetBufferedRegion() )
+    {
+    std::cerr << "Only the eigenvalues should be computed." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Without the smoothed output, an up to date filter is not executed again
+  const unsigned long eigenValuesUpdateTime = filter->GetEigenValuesOutput()->GetUpdateMTime();
+  try
+    {
+    filter->Update();
+    filter->UpdateLargestPossibleRegion();
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << "Exception caught: " << e << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( filter->GetEigenValuesOutput()->GetUpdateMTime() != eigenValuesUpdateTime )
+    {
+    std::cerr << "The up to date filter was executed again." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // With an oblique direction, the gradient is reoriented as by
+  // GradientRecursiveGaussianImageFilter, unless UseImageDirection is off
+  ImageType::DirectionType direction;
+  direction.SetIdentity();
+  const double angle = 0.5;
+  direction[0][0] = vcl_cos( angle );
+  direction[0][1] = -vcl_sin( angle );
+  direction[1][0] = vcl_sin( angle );
+  direction[1][1] = vcl_cos( angle );
+  inputImage->SetDirection( direction );
+
+  filter->ComputeGradientOn();
+  filter->ComputeHessianOn();
+  std::vector< FilterType::GradientPixelType > gridGradients;
+  for ( unsigned int useImageDirection = 0; useImageDirection < 2; useImageDirection++ )
+    {
+    filter->SetUseImageDirection( useImageDirection != 0 );
+    gradient->SetUseImageDirection( useImageDirection != 0 );
+    try
+      {
+      filter->Update();
+      gradient->Update();
+      hessian->Update();
+      }
+    catch ( itk::ExceptionObject & e )
+      {
+      std::cerr << "Exception caught: " << e << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    double maximumOrientedGradientError = 0.0;
+    double maximumOrientedHessianError = 0.0;
+    double maximumGradientRotation = 0.0;
+    size_t pixel = 0;
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      const ImageType::IndexType index = it.GetIndex();
+
+      const FilterType::GradientPixelType       g = filter->GetGradientOutput()->GetPixel( index );
+      const GradientFilterType::OutputPixelType gr = gradient->GetOutput()->GetPixel( index );
+      for ( unsigned int a = 0; a < Dimension; a++ )
+        {
+        maximumOrientedGradientError = vnl_math_max( maximumOrientedGradientError, vnl_math_abs( g[a] - gr[a] ) );
+        }
+      if ( useImageDirection )
+        {
+        maximumGradientRotation = vnl_math_max( maximumGradientRotation,
+                                                ( g - gridGradients[pixel] ).GetNorm() );
+        }
+      else
+        {
+        gridGradients.push_back( g );
+        }
+      ++pixel;
+
+      const FilterType::HessianPixelType       h = filter->GetHessianOutput()->GetPixel( index );
+      const HessianFilterType::OutputPixelType hr = hessian->GetOutput()->GetPixel( index );
+      for ( unsigned int k = 0; k < FilterType::HessianPixelType::Dimension; k++ )
+        {
+        maximumOrientedHessianError = vnl_math_max( maximumOrientedHessianError, vnl_math_abs( h[k] - hr[k] ) );
+        }
+      }
+
+    std::cout << "UseImageDirection " << useImageDirection << ": maximum gradient error "
+              << maximumOrientedGradientError << ", maximum Hessian error "
+              << maximumOrientedHessianError << std::endl;
+    if ( maximumOrientedGradientError > tolerance || maximumOrientedHessianError > tolerance )
+      {
+      std::cerr << "With an oblique direction, the fused filter differs from the separate filters." << std::endl;
+      return EXIT_FAILURE;
+      }
+    if ( useImageDirection && maximumGradientRotation < 0.1 )
+      {
+      std::cerr << "The gradient was not reoriented by the direction." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  filter->Print( std::cout );
+
+  return EXIT_SUCCESS;
+}
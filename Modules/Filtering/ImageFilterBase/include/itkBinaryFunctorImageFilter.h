@@ -20,6 +20,7 @@
 
 #include "itkInPlaceImageFilter.h"
 #include "itkSimpleDataObjectDecorator.h"
+#include "itkFunctorSpanTraits.h"
 
 namespace itk
 {
@@ -36,6 +37,10 @@ namespace itk
  * the pipeline. The SetConstant() and GetConstant() methods are provided as shortcuts
  * to set or get the constant value without manipulating the decorator.
  *
+ * When the inputs and the output are Images, the pixels are processed
+ * scanline by scanline over raw pointers, with the span operator of the
+ * functor when FunctorSpanTraits reports one.
+ *
  * \sa UnaryFunctorImageFilter TernaryFunctorImageFilter
  *
  * \ingroup IntensityImageFilters   MultiThreaded
@@ -192,6 +197,54 @@ private:
   BinaryFunctorImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);           //purposely not implemented
 
+  typedef ImageToImageFilterDetail::BooleanDispatch<
+    ImageSpanTraits< TInputImage1 >::IsContiguous
+    && ImageSpanTraits< TInputImage2 >::IsContiguous
+    && ImageSpanTraits< TOutputImage >::IsContiguous >
+  ScanlineDispatchType;
+  typedef ImageToImageFilterDetail::BooleanDispatch<
+    FunctorSpanTraits< FunctorType >::HasSpanOperator > SpanDispatchType;
+
+  /** Process the region scanline by scanline, a missing input standing
+   * for its constant.  Returns false when the images do not allow it. */
+  bool ThreadedGenerateScanlines(const ImageToImageFilterDetail::BooleanDispatch< false > &,
+                                 const TInputImage1 *,
+                                 const TInputImage2 *,
+                                 const OutputImageRegionType &,
+                                 ThreadIdType)
+  {
+    return false;
+  }
+
+  bool ThreadedGenerateScanlines(const ImageToImageFilterDetail::BooleanDispatch< true > &,
+                                 const TInputImage1 *inputPtr1,
+                                 const TInputImage2 *inputPtr2,
+                                 const OutputImageRegionType & outputRegionForThread,
+                                 ThreadIdType threadId);
+
+  static void ProcessScanline(const ImageToImageFilterDetail::BooleanDispatch< true > &,
+                              FunctorType & functor,
+                              const Input1ImagePixelType *in1,
+                              const Input2ImagePixelType *in2,
+                              OutputImagePixelType *out,
+                              SizeValueType n)
+  {
+    functor(in1, in2, out, n);
+  }
+
+  static void ProcessScanline(const ImageToImageFilterDetail::BooleanDispatch< false > &,
+                              FunctorType & functor,
+                              const Input1ImagePixelType *in1,
+                              const Input2ImagePixelType *in2,
+                              OutputImagePixelType *out,
+                              SizeValueType n)
+  {
+    for ( SizeValueType i = 0; i < n; ++i )
+      {
+      out[i] = functor(in1[i], in2[i]);
+      }
+  }
+
   FunctorType m_Functor;
 };
 } // end namespace itk
@@ -20,7 +20,9 @@
 
 #include "itkBinaryFunctorImageFilter.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkProgressReporter.h"
+#include <vector>
 
 namespace itk
 {
@@ -214,6 +216,13 @@ BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
     dynamic_cast< const TInputImage2 * >( ProcessObject::GetInput(1) );
   OutputImagePointer outputPtr = this->GetOutput(0);
 
+  if ( ( inputPtr1 || inputPtr2 )
+       && this->ThreadedGenerateScanlines(ScanlineDispatchType(), inputPtr1, inputPtr2,
+                                          outputRegionForThread, threadId) )
+    {
+    return;
+    }
+
   if( inputPtr1 && inputPtr2 )
     {
     ImageRegionConstIterator< TInputImage1 > inputIt1(inputPtr1, outputRegionForThread);
@@ -277,6 +286,70 @@ BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
     itkGenericExceptionMacro(<<"At most one of the inputs can be a constant.");
     }
 }
+
+template< class TInputImage1, class TInputImage2, class TOutputImage, class TFunction  >
+bool
+BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
+::ThreadedGenerateScanlines(const ImageToImageFilterDetail::BooleanDispatch< true > &,
+                            const TInputImage1 *inputPtr1,
+                            const TInputImage2 *inputPtr2,
+                            const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId)
+{
+  OutputImagePointer outputPtr = this->GetOutput(0);
+
+  const SizeValueType lineLength = outputRegionForThread.GetSize(0);
+  if ( lineLength == 0 )
+    {
+    return true;
+    }
+  const SizeValueType numberOfLines = outputRegionForThread.GetNumberOfPixels() / lineLength;
+
+  ProgressReporter progress(this, threadId, numberOfLines);
+
+  // a local copy of the functor cannot alias the output buffer, which
+  // lets the compiler keep its state in registers
+  FunctorType functor = m_Functor;
+
+  // a constant is read from a scanline filled with it
+  std::vector< Input1ImagePixelType > constantLine1;
+  std::vector< Input2ImagePixelType > constantLine2;
+  const Input1ImagePixelType *        in1 = 0;
+  const Input2ImagePixelType *        in2 = 0;
+  if ( !inputPtr1 )
+    {
+    constantLine1.assign( lineLength, this->GetConstant1() );
+    in1 = &constantLine1[0];
+    }
+  if ( !inputPtr2 )
+    {
+    constantLine2.assign( lineLength, this->GetConstant2() );
+    in2 = &constantLine2[0];
+    }
+
+  // walk the first pixel of each scanline
+  OutputImageRegionType lineStarts = outputRegionForThread;
+  lineStarts.SetSize(0, 1);
+  ImageRegionConstIteratorWithIndex< TOutputImage > lineIt(outputPtr, lineStarts);
+
+  for ( lineIt.GoToBegin(); !lineIt.IsAtEnd(); ++lineIt )
+    {
+    const typename OutputImageType::IndexType & index = lineIt.GetIndex();
+    if ( inputPtr1 )
+      {
+      in1 = inputPtr1->GetBufferPointer() + inputPtr1->ComputeOffset(index);
+      }
+    if ( inputPtr2 )
+      {
+      in2 = inputPtr2->GetBufferPointer() + inputPtr2->ComputeOffset(index);
+      }
+    ProcessScanline(SpanDispatchType(), functor, in1, in2,
+                    outputPtr->GetBufferPointer() + outputPtr->ComputeOffset(index),
+                    lineLength);
+    progress.CompletedPixel(); // potential exception thrown here
+    }
+  return true;
+}
 } // end namespace itk
 
 #endif
@@ -20,6 +20,7 @@
 
 #include "itkUnaryFunctorImageFilter.h"
 #include "itkProgressReporter.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -82,9 +83,40 @@ public:
   {
     return static_cast< TOutput >( A );
   }
+
+  /** Cast a scanline, see FunctorSpanTraits. */
+  inline void operator()(const TInput *in, TOutput *out, SizeValueType n) const
+  {
+    CastSpan(in, out, n);
+  }
+
+private:
+  template< class TSpanInput, class TSpanOutput >
+  static void CastSpan(const TSpanInput *in, TSpanOutput *out, SizeValueType n)
+  {
+    for ( SizeValueType i = 0; i < n; ++i )
+      {
+      out[i] = static_cast< TSpanOutput >( in[i] );
+      }
+  }
+
+  // the pixels are copied unchanged
+  template< class TSpanPixel >
+  static void CastSpan(const TSpanPixel *in, TSpanPixel *out, SizeValueType n)
+  {
+    if ( in != out )
+      {
+      std::copy(in, in + n, out);
+      }
+  }
 };
 }
 
+template< class TInput, class TOutput >
+struct FunctorSpanTraits< Functor::Cast< TInput, TOutput > > {
+  itkStaticConstMacro(HasSpanOperator, bool, true);
+};
+
 template< class TInputImage, class TOutputImage >
 class ITK_EXPORT CastImageFilter:
   public
@@ -81,9 +81,39 @@ public:
 
     return static_cast< TOutput >( A );
   }
+
+  /** Clamp a scanline, see FunctorSpanTraits.  No value is compared when
+   * TInput is an integer type whose range is contained in the range of
+   * TOutput; floating point infinities are always clamped. */
+  inline void operator()(const TInput *in, TOutput *out, SizeValueType n) const
+  {
+    if ( NumericTraits< TInput >::is_integer
+         && static_cast< double >( NumericTraits< TInput >::NonpositiveMin() )
+         >= static_cast< double >( NumericTraits< TOutput >::NonpositiveMin() )
+         && static_cast< double >( NumericTraits< TInput >::max() )
+         <= static_cast< double >( NumericTraits< TOutput >::max() ) )
+      {
+      for ( SizeValueType i = 0; i < n; ++i )
+        {
+        out[i] = static_cast< TOutput >( in[i] );
+        }
+      }
+    else
+      {
+      for ( SizeValueType i = 0; i < n; ++i )
+        {
+        out[i] = ( *this )( in[i] );
+        }
+      }
+  }
 };
 }
 
+template< class TInput, class TOutput >
+struct FunctorSpanTraits< Functor::Clamp< TInput, TOutput > > {
+  itkStaticConstMacro(HasSpanOperator, bool, true);
+};
+
 template <class TInputImage, class TOutputImage>
 class ITK_EXPORT ClampImageFilter :
     public
@@ -93,6 +93,14 @@ public:
   /** Get Input Image. */
   const TInputImage * GetInputImage(void);
 
+  /** Set/Get the number of adjacent lines filtered together, from 1 to 64.
+   * The lines of a block are read one after the other into interleaved
+   * buffers, so that the recursion runs on all of them at once in loops
+   * that the compiler can vectorize.  A value of 1 filters one line at a
+   * time.  The results do not depend on this value.  Defaults to 8. */
+  itkSetClampMacro(NumberOfLinesPerBlock, unsigned int, 1, 64);
+  itkGetConstMacro(NumberOfLinesPerBlock, unsigned int);
+
 protected:
   RecursiveSeparableImageFilter();
   virtual ~RecursiveSeparableImageFilter() {}
@@ -130,6 +138,14 @@ protected:
   void FilterDataArray(RealType *outs, const RealType *data, RealType *scratch,
                        unsigned int ln);
 
+  /** Apply the Recursive Filter to a block of numberOfLines interleaved
+   * lines: the value of line l at position i is stored at
+   * i * numberOfLines + l.  This computes the same values as
+   * FilterDataArray() on each line.  The arrays "outs", "data" and
+   * "scratch" hold ln * numberOfLines values. */
+  void FilterDataBlock(RealType *outs, const RealType *data, RealType *scratch,
+                       unsigned int ln, unsigned int numberOfLines);
+
 protected:
   /** Causal coefficients that multiply the input data. */
   ScalarRealType m_N0;
@@ -169,6 +185,9 @@ private:
   /** Direction in which the filter is to be applied
    * this should be in the range [0,ImageDimension-1]. */
   unsigned int m_Direction;
+
+  /** Number of adjacent lines filtered together. */
+  unsigned int m_NumberOfLinesPerBlock;
 };
 } // end namespace itk
 
@@ -23,6 +23,7 @@
 #include "itkImageLinearIteratorWithIndex.h"
 #include "itkProgressReporter.h"
 #include <new>
+#include <algorithm>
 
 namespace itk
 {
@@ -31,6 +32,7 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
 ::RecursiveSeparableImageFilter()
 {
   m_Direction = 0;
+  m_NumberOfLinesPerBlock = 8;
   this->SetNumberOfRequiredOutputs(1);
   this->SetNumberOfRequiredInputs(1);
 
@@ -152,6 +154,145 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
     }
 }
 
+/**
+ * Apply Recursive Filter to a block of interleaved lines
+ */
+template< typename TInputImage, typename TOutputImage >
+void
+RecursiveSeparableImageFilter< TInputImage, TOutputImage >
+::FilterDataBlock(RealType *outs, const RealType *data,
+                  RealType *scratch, unsigned int ln, unsigned int numberOfLines)
+{
+  // The coefficients are copied so that the compiler does not reload
+  // them after each store into the arrays.
+  const ScalarRealType n0 = m_N0;
+  const ScalarRealType n1 = m_N1;
+  const ScalarRealType n2 = m_N2;
+  const ScalarRealType n3 = m_N3;
+  const ScalarRealType d1 = m_D1;
+  const ScalarRealType d2 = m_D2;
+  const ScalarRealType d3 = m_D3;
+  const ScalarRealType d4 = m_D4;
+  const ScalarRealType m1 = m_M1;
+  const ScalarRealType m2 = m_M2;
+  const ScalarRealType m3 = m_M3;
+  const ScalarRealType m4 = m_M4;
+
+  const unsigned int nl = numberOfLines;
+  const unsigned int total = ln * nl;
+
+  /**
+   * Causal direction pass
+   */
+  for ( unsigned int l = 0; l < nl; l++ )
+    {
+    const RealType *dt = data + l;
+    RealType *      sc = scratch + l;
+
+    // this value is assumed to exist from the border to infinity.
+    const RealType outV1 = dt[0];
+
+    /**
+     * Initialize borders
+     */
+    sc[0]      = RealType(outV1      * n0 +      outV1 * n1 + outV1      * n2 + outV1 * n3);
+    sc[nl]     = RealType(dt[nl]     * n0 +      outV1 * n1 + outV1      * n2 + outV1 * n3);
+    sc[2 * nl] = RealType(dt[2 * nl] * n0 +     dt[nl] * n1 + outV1      * n2 + outV1 * n3);
+    sc[3 * nl] = RealType(dt[3 * nl] * n0 + dt[2 * nl] * n1 + dt[nl]     * n2 + outV1 * n3);
+
+    // note that the outV1 value is multiplied by the Boundary coefficients m_BNi
+    sc[0]      -= RealType(outV1      * m_BN1 + outV1      * m_BN2 + outV1  * m_BN3 + outV1 * m_BN4);
+    sc[nl]     -= RealType(sc[0]      * d1    + outV1      * m_BN2 + outV1  * m_BN3 + outV1 * m_BN4);
+    sc[2 * nl] -= RealType(sc[nl]     * d1    + sc[0]      * d2    + outV1  * m_BN3 + outV1 * m_BN4);
+    sc[3 * nl] -= RealType(sc[2 * nl] * d1    + sc[nl]     * d2    + sc[0]  * d3    + outV1 * m_BN4);
+    }
+
+  /**
+   * Recursively filter the rest, all the lines at once
+   */
+  for ( unsigned int i = 4; i < ln; i++ )
+    {
+    const RealType *dt0 = data + i * nl;
+    const RealType *dt1 = dt0 - nl;
+    const RealType *dt2 = dt1 - nl;
+    const RealType *dt3 = dt2 - nl;
+    RealType *      sc0 = scratch + i * nl;
+    const RealType *sc1 = sc0 - nl;
+    const RealType *sc2 = sc1 - nl;
+    const RealType *sc3 = sc2 - nl;
+    const RealType *sc4 = sc3 - nl;
+    for ( unsigned int l = 0; l < nl; l++ )
+      {
+      sc0[l]  = RealType(dt0[l] * n0 + dt1[l] * n1 + dt2[l] * n2 + dt3[l] * n3);
+      sc0[l] -= RealType(sc1[l] * d1 + sc2[l] * d2 + sc3[l] * d3 + sc4[l] * d4);
+      }
+    }
+
+  /**
+   * Store the causal result
+   */
+  for ( unsigned int k = 0; k < total; k++ )
+    {
+    outs[k] = scratch[k];
+    }
+
+  /**
+   * AntiCausal direction pass
+   */
+  const unsigned int last = total - nl;
+  for ( unsigned int l = 0; l < nl; l++ )
+    {
+    const RealType *dt = data + last + l;
+    RealType *      sc = scratch + last + l;
+
+    // this value is assumed to exist from the border to infinity.
+    const RealType outV2 = dt[0];
+
+    /**
+     * Initialize borders
+     */
+    *( sc )          = RealType(outV2              * m1 + outV2             * m2 + outV2  * m3 + outV2 * m4);
+    *( sc - nl )     = RealType(dt[0]              * m1 + outV2             * m2 + outV2  * m3 + outV2 * m4);
+    *( sc - 2 * nl ) = RealType(*( dt - nl )       * m1 + dt[0]             * m2 + outV2  * m3 + outV2 * m4);
+    *( sc - 3 * nl ) = RealType(*( dt - 2 * nl )   * m1 + *( dt - nl )      * m2 + dt[0]  * m3 + outV2 * m4);
+
+    // note that the outV2 value is multiplied by the Boundary coefficients m_BMi
+    *( sc )          -= RealType(outV2             * m_BM1 + outV2          * m_BM2 + outV2  * m_BM3 + outV2 * m_BM4);
+    *( sc - nl )     -= RealType(*( sc )           * d1    + outV2          * m_BM2 + outV2  * m_BM3 + outV2 * m_BM4);
+    *( sc - 2 * nl ) -= RealType(*( sc - nl )      * d1    + *( sc )        * d2    + outV2  * m_BM3 + outV2 * m_BM4);
+    *( sc - 3 * nl ) -= RealType(*( sc - 2 * nl )  * d1    + *( sc - nl )   * d2    + *( sc ) * d3   + outV2 * m_BM4);
+    }
+
+  /**
+   * Recursively filter the rest, all the lines at once
+   */
+  for ( unsigned int i = ln - 4; i > 0; i-- )
+    {
+    RealType *      sc0 = scratch + ( i - 1 ) * nl;
+    const RealType *sc1 = sc0 + nl;
+    const RealType *sc2 = sc1 + nl;
+    const RealType *sc3 = sc2 + nl;
+    const RealType *sc4 = sc3 + nl;
+    const RealType *dt1 = data + i * nl;
+    const RealType *dt2 = dt1 + nl;
+    const RealType *dt3 = dt2 + nl;
+    const RealType *dt4 = dt3 + nl;
+    for ( unsigned int l = 0; l < nl; l++ )
+      {
+      sc0[l]  = RealType(dt1[l] * m1 + dt2[l] * m2 + dt3[l] * m3 + dt4[l] * m4);
+      sc0[l] -= RealType(sc1[l] * d1 + sc2[l] * d2 + sc3[l] * d3 + sc4[l] * d4);
+      }
+    }
+
+  /**
+   * Roll the antiCausal part into the output
+   */
+  for ( unsigned int k = 0; k < total; k++ )
+    {
+    outs[k] += scratch[k];
+    }
+}
+
 //
 // we need all of the image in just the "Direction" we are separated into
 //
@@ -304,6 +445,7 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
   outputIterator.SetDirection(this->m_Direction);
 
   const unsigned int ln = region.GetSize()[this->m_Direction];
+  const unsigned int linesPerBlock = m_NumberOfLinesPerBlock;
 
   RealType *inps = 0;
   RealType *outs = 0;
@@ -311,9 +453,9 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
 
   try
     {
-    inps = new RealType[ln];
-    outs = new RealType[ln];
-    scratch = new RealType[ln];
+    inps = new RealType[ln * linesPerBlock];
+    outs = new RealType[ln * linesPerBlock];
+    scratch = new RealType[ln * linesPerBlock];
 
     inputIterator.GoToBegin();
     outputIterator.GoToBegin();
@@ -321,30 +463,49 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
     const SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / outputRegionForThread.GetSize(this->m_Direction);
     ProgressReporter   progress(this, threadId, numberOfLinesToProcess, 10);
 
-    while ( !inputIterator.IsAtEnd() && !outputIterator.IsAtEnd() )
+    SizeValueType remainingLines = numberOfLinesToProcess;
+    while ( remainingLines > 0 && !inputIterator.IsAtEnd() && !outputIterator.IsAtEnd() )
       {
-      unsigned int i = 0;
-      while ( !inputIterator.IsAtEndOfLine() )
+      // Read a block of adjacent lines, interleaved
+      const unsigned int numberOfLines =
+        static_cast< unsigned int >( std::min( remainingLines, static_cast< SizeValueType >( linesPerBlock ) ) );
+      for ( unsigned int l = 0; l < numberOfLines; l++ )
         {
-        inps[i++]      = inputIterator.Get();
-        ++inputIterator;
+        unsigned int i = l;
+        while ( !inputIterator.IsAtEndOfLine() )
+          {
+          inps[i]        = inputIterator.Get();
+          i += numberOfLines;
+          ++inputIterator;
+          }
+        inputIterator.NextLine();
         }
 
-      this->FilterDataArray(outs, inps, scratch, ln);
-
-      unsigned int j = 0;
-      while ( !outputIterator.IsAtEndOfLine() )
+      if ( numberOfLines == 1 )
         {
-        outputIterator.Set( static_cast< OutputPixelType >( outs[j++] ) );
-        ++outputIterator;
+        this->FilterDataArray(outs, inps, scratch, ln);
+        }
+      else
+        {
+        this->FilterDataBlock(outs, inps, scratch, ln, numberOfLines);
         }
 
-      inputIterator.NextLine();
-      outputIterator.NextLine();
-
-      // Although the method name is CompletedPixel(),
-      // this is being called after each line is processed
-      progress.CompletedPixel();
+      for ( unsigned int l = 0; l < numberOfLines; l++ )
+        {
+        unsigned int j = l;
+        while ( !outputIterator.IsAtEndOfLine() )
+          {
+          outputIterator.Set( static_cast< OutputPixelType >( outs[j] ) );
+          j += numberOfLines;
+          ++outputIterator;
+          }
+        outputIterator.NextLine();
+
+        // Although the method name is CompletedPixel(),
+        // this is being called after each line is processed
+        progress.CompletedPixel();
+        }
+      remainingLines -= numberOfLines;
       }
     }
   catch (...)
@@ -375,6 +536,7 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
   Superclass::PrintSelf(os, indent);
 
   os << indent << "Direction: " << m_Direction << std::endl;
+  os << indent << "NumberOfLinesPerBlock: " << m_NumberOfLinesPerBlock << std::endl;
 }
 } // end namespace itk
 
@@ -0,0 +1,180 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkSeparableNeighborhoodOperatorImageFilter_h
+#define __itkSeparableNeighborhoodOperatorImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkNeighborhoodOperator.h"
+
+#include <vector>
+
+namespace itk
+{
+/** \class SeparableNeighborhoodOperatorImageFilter
+ * \brief Applies one-dimensional NeighborhoodOperators along the axes of an
+ * image, as one separable filter.
+ *
+ * This filter computes the same inner products as a chain of
+ * NeighborhoodOperatorImageFilters, one for each directional operator set
+ * with SetOperator(), with a zero flux Neumann boundary condition.  The
+ * axes without an operator are not filtered.
+ *
+ * Instead of full-size intermediate images, each thread processes its
+ * output region by tiles, split along all the axes.  The input of a tile,
+ * padded by the operator radii, is filtered along each axis in turn into
+ * a buffer of the tile, so that the intermediate results stay in cache.  The first axis is
+ * filtered on contiguous lines of the input; the other axes are filtered
+ * by accumulating whole contiguous lines of the buffer, weighted by the
+ * operator coefficients, instead of gathering strided neighborhoods.  The
+ * intermediate results are kept in the real type of the output pixel.
+ *
+ * \sa NeighborhoodOperatorImageFilter
+ * \sa DiscreteGaussianImageFilter
+ *
+ * \ingroup ImageFilters
+ * \ingroup ITKImageFilterBase
+ */
+template< class TInputImage, class TOutputImage, class TOperatorValueType = typename TOutputImage::PixelType >
+class ITK_EXPORT SeparableNeighborhoodOperatorImageFilter:
+  public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard "Self" & Superclass typedef. */
+  typedef SeparableNeighborhoodOperatorImageFilter        Self;
+  typedef ImageToImageFilter< TInputImage, TOutputImage > Superclass;
+  typedef SmartPointer< Self >                            Pointer;
+  typedef SmartPointer< const Self >                      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(SeparableNeighborhoodOperatorImageFilter, ImageToImageFilter);
+
+  /** Extract some information from the image types.  Dimensionality
+   * of the two images is assumed to be the same. */
+  typedef typename TOutputImage::PixelType                  OutputPixelType;
+  typedef typename TInputImage::PixelType                   InputPixelType;
+  typedef TOperatorValueType                                OperatorValueType;
+  typedef typename NumericTraits<InputPixelType>::ValueType InputPixelValueType;
+  typedef typename NumericTraits<OutputPixelType>::RealType ComputingPixelType;
+
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TOutputImage::ImageDimension);
+  itkStaticConstMacro(InputImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+
+  /** Image typedef support. */
+  typedef TInputImage                                InputImageType;
+  typedef TOutputImage                               OutputImageType;
+  typedef typename InputImageType::Pointer           InputImagePointer;
+  typedef typename InputImageType::RegionType        InputImageRegionType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename OutputImageType::SizeType         OutputSizeType;
+  typedef typename InputImageType::SizeType          RadiusType;
+
+  /** Operator types. */
+  typedef NeighborhoodOperator< OperatorValueType,
+                                itkGetStaticConstMacro(ImageDimension) > OperatorType;
+  typedef std::vector< OperatorValueType >                            KernelType;
+
+  /** Set the operator of the direction of \c op, replacing the operator
+   * previously set for that direction.  The operator must be one
+   * dimensional, as built by CreateDirectional(), and is stored as a copy of
+   * its coefficients. */
+  void SetOperator(const OperatorType & op);
+
+  /** Remove the operators of all the directions. */
+  void ClearOperators();
+
+  /** Get the coefficients of the operator of a direction, empty if the
+   * direction is not filtered. */
+  const KernelType & GetKernel(unsigned int direction) const;
+
+  /** Get the radius of the operators. */
+  RadiusType GetRadius() const;
+
+  /** Set/Get the maximum number of pixels of the buffers of the tiles
+   * processed at once by each thread, including the padding of the tiles.
+   * Each thread holds two such buffers.  The tiles are shrunk along the
+   * other axes first and along the first axis last, but are at least as
+   * thick as twice the radius of each axis, so that their padding does not
+   * dominate them; a larger buffer is used when even such a tile does not
+   * fit.  Defaults to 262144. */
+  itkSetClampMacro(MaximumNumberOfPixelsPerTile, SizeValueType, 1, NumericTraits< SizeValueType >::max());
+  itkGetConstMacro(MaximumNumberOfPixelsPerTile, SizeValueType);
+
+  /** SeparableNeighborhoodOperatorImageFilter needs a larger input
+   * requested region than the output requested region, padded by the
+   * radius of the operators.
+   *
+   * \sa ProcessObject::GenerateInputRequestedRegion() */
+  virtual void GenerateInputRequestedRegion()
+  throw ( InvalidRequestedRegionError );
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  /** Begin concept checking */
+  itkConceptMacro( SameDimensionCheck,
+                   ( Concept::SameDimension< InputImageDimension, ImageDimension > ) );
+  itkConceptMacro( InputConvertibleToOperatorCheck,
+                   ( Concept::Convertible< InputPixelValueType, OperatorValueType > ) );
+  itkConceptMacro( OperatorMultiplyOperatorCheck,
+                   ( Concept::MultiplyOperator< OperatorValueType > ) );
+  itkConceptMacro( OperatorAdditiveOperatorsCheck,
+                   ( Concept::AdditiveOperators< OperatorValueType > ) );
+  /** End concept checking */
+#endif
+protected:
+  SeparableNeighborhoodOperatorImageFilter();
+  virtual ~SeparableNeighborhoodOperatorImageFilter() {}
+
+  /** Filter the tiles of the region of a thread.
+   *
+   * \sa ImageToImageFilter::ThreadedGenerateData(),
+   *     ImageToImageFilter::GenerateData() */
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId);
+
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  SeparableNeighborhoodOperatorImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);                           //purposely not implemented
+
+  typedef std::vector< ComputingPixelType > BufferType;
+
+  /** Compute the size of the tiles of a region of a thread. */
+  OutputSizeType ComputeTileSize(const OutputSizeType & regionSize) const;
+
+  /** Filter a tile of the output, using two buffers of the thread. */
+  void GenerateTile(const OutputImageRegionType & tileRegion,
+                    BufferType & buffer, BufferType & otherBuffer,
+                    BufferType & line);
+
+  /** Coefficients of the operator of each direction. */
+  KernelType m_Kernels[ImageDimension];
+
+  SizeValueType m_MaximumNumberOfPixelsPerTile;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkSeparableNeighborhoodOperatorImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,434 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkSeparableNeighborhoodOperatorImageFilter_hxx
+#define __itkSeparableNeighborhoodOperatorImageFilter_hxx
+
+#include "itkSeparableNeighborhoodOperatorImageFilter.h"
+
+#include "itkImageLinearConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkProgressReporter.h"
+
+#include <algorithm>
+
+namespace itk
+{
+template< class TInputImage, class TOutputImage, class TOperatorValueType >
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::SeparableNeighborhoodOperatorImageFilter()
+{
+  m_MaximumNumberOfPixelsPerTile = 262144;
+}
+
+template< class TInputImage, class TOutputImage, class TOperatorValueType >
+void
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::SetOperator(const OperatorType & op)
+{
+  const unsigned long direction = op.GetDirection();
+  if ( direction >= ImageDimension )
+    {
+    itkExceptionMacro(<< "The direction " << direction << " of the operator is not an axis of the image.");
+    }
+  const SizeValueType radius = op.GetRadius(direction);
+  if ( op.Size() != 2 * radius + 1 )
+    {
+    itkExceptionMacro(<< "The operator is not one dimensional.");
+    }
+
+  KernelType kernel( op.Size() );
+  for ( unsigned int i = 0; i < op.Size(); ++i )
+    {
+    kernel[i] = op[i];
+    }
+  m_Kernels[direction] = kernel;
+  this->Modified();
+}
+
+template< class TInputImage, class TOutputImage, class TOperatorValueType >
+void
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::ClearOperators()
+{
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    m_Kernels[d].clear();
+    }
+  this->Modified();
+}
+
+template< class TInputImage, class TOutputImage, class TOperatorValueType >
+const typename SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >::KernelType &
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::GetKernel(unsigned int direction) const
+{
+  if ( direction >= ImageDimension )
+    {
+    itkExceptionMacro(<< "The direction " << direction << " is not an axis of the image.");
+    }
+  return m_Kernels[direction];
+}
+
+template< class TInputImage, class TOutputImage, class TOperatorValueType >
+typename SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >::RadiusType
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::GetRadius() const
+{
+  RadiusType radius;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    radius[d] = m_Kernels[d].empty() ? 0 : ( m_Kernels[d].size() - 1 ) / 2;
+    }
+  return radius;
+}
+
+template< class TInputImage, class TOutputImage, class TOperatorValueType >
+void
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::GenerateInputRequestedRegion()
+throw ( InvalidRequestedRegionError )
+{
+  // call the superclass' implementation of this method. this should
+  // copy the output requested region to the input requested region
+  Superclass::GenerateInputRequestedRegion();
+
+  // get pointers to the input and output
+  InputImagePointer inputPtr =
+    const_cast< TInputImage * >( this->GetInput() );
+
+  if ( !inputPtr )
+    {
+    return;
+    }
+
+  // get a copy of the input requested region (should equal the output
+  // requested region)
+  InputImageRegionType inputRequestedRegion;
+  inputRequestedRegion = inputPtr->GetRequestedRegion();
+
+  // pad the input requested region by the operator radius
+  inputRequestedRegion.PadByRadius( this->GetRadius() );
+
+  // crop the input requested region at the input's largest possible region
+  if ( inputRequestedRegion.Crop( inputPtr->GetLargestPossibleRegion() ) )
+    {
+    inputPtr->SetRequestedRegion(inputRequestedRegion);
+    return;
+    }
+  else
+    {
+    // Couldn't crop the region (requested region is outside the largest
+    // possible region).  Throw an exception.
+
+    // store what we tried to request (prior to trying to crop)
+    inputPtr->SetRequestedRegion(inputRequestedRegion);
+
+    // build an exception
+    InvalidRequestedRegionError e(__FILE__, __LINE__);
+    e.SetLocation(ITK_LOCATION);
+    e.SetDescription("Requested region is (at least partially) outside the largest possible region.");
+    e.SetDataObject(inputPtr);
+    throw e;
+    }
+}
+
+template< class TInputImage, class TOutputImage, class TOperatorValueType >
+void
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  OutputImageType *output = this->GetOutput();
+
+  // support progress methods/callbacks
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels(), 10 );
+
+  if ( outputRegionForThread.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  const OutputSizeType tileSize = this->ComputeTileSize( outputRegionForThread.GetSize() );
+
+  BufferType buffer;
+  BufferType otherBuffer;
+  BufferType line;
+
+  // Visit the tiles of the region, first along the first axis
+  OutputImageRegionType tileRegion;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    tileRegion.SetIndex( d, outputRegionForThread.GetIndex(d) );
+    }
+  bool done = false;
+  while ( !done )
+    {
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      const SizeValueType remaining = static_cast< SizeValueType >(
+        outputRegionForThread.GetIndex(d) + static_cast< IndexValueType >( outputRegionForThread.GetSize(d) )
+        - tileRegion.GetIndex(d) );
+      tileRegion.SetSize( d, std::min( tileSize[d], remaining ) );
+      }
+
+    this->GenerateTile( tileRegion, buffer, otherBuffer, line );
+
+    ImageRegionIterator< OutputImageType > it( output, tileRegion );
+    typename BufferType::const_iterator    bit = buffer.begin();
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it, ++bit )
+      {
+      it.Set( static_cast< OutputPixelType >( *bit ) );
+      progress.CompletedPixel();
+      }
+
+    done = true;
+    for ( unsigned int d = 0; d < ImageDimension && done; ++d )
+      {
+      const IndexValueType next = tileRegion.GetIndex(d) + static_cast< IndexValueType >( tileSize[d] );
+      if ( next < outputRegionForThread.GetIndex(d) + static_cast< IndexValueType >( outputRegionForThread.GetSize(d) ) )
+        {
+        tileRegion.SetIndex( d, next );
+        done = false;
+        }
+      else
+        {
+        tileRegion.SetIndex( d, outputRegionForThread.GetIndex(d) );
+        }
+      }
+    }
+}
+
+template< class TInputImage, class TOutputImage, class TOperatorValueType >
+typename SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >::OutputSizeType
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::ComputeTileSize(const OutputSizeType & regionSize) const
+{
+  const RadiusType radius = this->GetRadius();
+
+  // A tile is at least twice the radius of each axis thick, so that its
+  // padding does not dominate it.
+  OutputSizeType tileSize = regionSize;
+  OutputSizeType minimumSize;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    minimumSize[d] = std::min( regionSize[d], std::max( static_cast< SizeValueType >( 2 * radius[d] ),
+                                                        static_cast< SizeValueType >( 1 ) ) );
+    }
+
+  // Shrink the thickest of the other axes first, and the first axis last,
+  // so that the lines stay long, until the buffers of the tile fit.
+  for ( ;; )
+    {
+    SizeValueType bufferSize = tileSize[0];
+    for ( unsigned int d = 1; d < ImageDimension; ++d )
+      {
+      bufferSize *= tileSize[d] + 2 * radius[d];
+      }
+    if ( bufferSize <= m_MaximumNumberOfPixelsPerTile )
+      {
+      break;
+      }
+
+    unsigned int axis = ImageDimension;
+    for ( unsigned int d = 1; d < ImageDimension; ++d )
+      {
+      if ( tileSize[d] > minimumSize[d] && ( axis == ImageDimension || tileSize[d] > tileSize[axis] ) )
+        {
+        axis = d;
+        }
+      }
+    if ( axis == ImageDimension )
+      {
+      if ( tileSize[0] == minimumSize[0] )
+        {
+        break;
+        }
+      axis = 0;
+      }
+    const SizeValueType step = std::max( tileSize[axis] / 8, static_cast< SizeValueType >( 1 ) );
+    tileSize[axis] = std::max( tileSize[axis] - step, minimumSize[axis] );
+    }
+
+  return tileSize;
+}
+
+template< class TInputImage, class TOutputImage, class TOperatorValueType >
+void
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::GenerateTile(const OutputImageRegionType & tileRegion,
+               BufferType & buffer, BufferType & otherBuffer,
+               BufferType & line)
+{
+  const InputImageType *     input = this->GetInput();
+  const InputImageRegionType inputRegion = input->GetBufferedRegion();
+  const RadiusType           radius = this->GetRadius();
+  const ComputingPixelType   zero = NumericTraits< ComputingPixelType >::ZeroValue();
+
+  // The region filtered along the first axis is the tile padded along the
+  // other axes.  The boundary condition is applied at the buffered region
+  // of the input, as NeighborhoodOperatorImageFilter does.
+  InputImageRegionType passRegion = tileRegion;
+  for ( unsigned int d = 1; d < ImageDimension; ++d )
+    {
+    passRegion.SetIndex( d, passRegion.GetIndex(d) - static_cast< IndexValueType >( radius[d] ) );
+    passRegion.SetSize( d, passRegion.GetSize(d) + 2 * radius[d] );
+    }
+  passRegion.Crop( inputRegion );
+
+  //
+  // First axis: convolve the contiguous lines of the input
+  //
+  KernelType kernel = m_Kernels[0];
+  if ( kernel.empty() )
+    {
+    kernel.assign( 1, NumericTraits< OperatorValueType >::One );
+    }
+  const IndexValueType r0 = static_cast< IndexValueType >( radius[0] );
+  const SizeValueType  size0 = passRegion.GetSize(0);
+  const IndexValueType lineStart = passRegion.GetIndex(0) - r0;
+  const IndexValueType readStart = std::max( lineStart, inputRegion.GetIndex(0) );
+  const IndexValueType readEnd = std::min( passRegion.GetIndex(0) + static_cast< IndexValueType >( size0 ) - 1 + r0,
+                                           inputRegion.GetIndex(0) + static_cast< IndexValueType >( inputRegion.GetSize(0) ) - 1 );
+
+  InputImageRegionType readRegion = passRegion;
+  readRegion.SetIndex( 0, readStart );
+  readRegion.SetSize( 0, static_cast< SizeValueType >( readEnd - readStart + 1 ) );
+
+  line.resize( size0 + 2 * radius[0] );
+  buffer.resize( passRegion.GetNumberOfPixels() );
+
+  ImageLinearConstIteratorWithIndex< InputImageType > inIt( input, readRegion );
+  inIt.SetDirection(0);
+  typename BufferType::iterator row = buffer.begin();
+  for ( inIt.GoToBegin(); !inIt.IsAtEnd(); inIt.NextLine(), row += size0 )
+    {
+    // Read the line, and extend it by its end values
+    SizeValueType j = static_cast< SizeValueType >( readStart - lineStart );
+    for ( ; !inIt.IsAtEndOfLine(); ++inIt, ++j )
+      {
+      line[j] = static_cast< ComputingPixelType >( inIt.Get() );
+      }
+    for ( ; j < line.size(); ++j )
+      {
+      line[j] = line[readEnd - lineStart];
+      }
+    for ( j = 0; static_cast< IndexValueType >( j ) < readStart - lineStart; ++j )
+      {
+      line[j] = line[readStart - lineStart];
+      }
+
+    std::fill( row, row + size0, zero );
+    for ( SizeValueType k = 0; k < kernel.size(); ++k )
+      {
+      const OperatorValueType w = kernel[k];
+      const ComputingPixelType *source = &line[k];
+      ComputingPixelType *      destination = &( *row );
+      for ( SizeValueType i = 0; i < size0; ++i )
+        {
+        destination[i] += source[i] * w;
+        }
+      }
+    }
+
+  //
+  // Other axes: accumulate the lines of the buffer shifted along the axis
+  //
+  for ( unsigned int d = 1; d < ImageDimension; ++d )
+    {
+    if ( m_Kernels[d].empty() )
+      {
+      continue;
+      }
+    const KernelType &   kernelD = m_Kernels[d];
+    const IndexValueType rd = static_cast< IndexValueType >( radius[d] );
+    const IndexValueType inputStart = inputRegion.GetIndex(d);
+    const IndexValueType inputEnd = inputStart + static_cast< IndexValueType >( inputRegion.GetSize(d) ) - 1;
+
+    // Strides of the lines of the source buffer
+    OffsetValueType stride[ImageDimension];
+    stride[0] = 1;
+    for ( unsigned int e = 1; e < ImageDimension; ++e )
+      {
+      stride[e] = stride[e - 1] * static_cast< OffsetValueType >( passRegion.GetSize(e - 1) );
+      }
+
+    InputImageRegionType nextRegion = passRegion;
+    nextRegion.SetIndex( d, tileRegion.GetIndex(d) );
+    nextRegion.SetSize( d, tileRegion.GetSize(d) );
+    otherBuffer.resize( nextRegion.GetNumberOfPixels() );
+
+    // Visit the lines of the destination region in buffer order
+    IndexValueType position[ImageDimension];
+    for ( unsigned int e = 0; e < ImageDimension; ++e )
+      {
+      position[e] = 0;
+      }
+    const SizeValueType numberOfLines = nextRegion.GetNumberOfPixels() / size0;
+    ComputingPixelType *destination = &otherBuffer[0];
+    for ( SizeValueType n = 0; n < numberOfLines; ++n, destination += size0 )
+      {
+      OffsetValueType lineOffset = 0;
+      for ( unsigned int e = 1; e < ImageDimension; ++e )
+        {
+        if ( e != d )
+          {
+          lineOffset += position[e] * stride[e];
+          }
+        }
+      const IndexValueType center = nextRegion.GetIndex(d) + position[d];
+
+      std::fill( destination, destination + size0, zero );
+      for ( IndexValueType k = 0; k < static_cast< IndexValueType >( kernelD.size() ); ++k )
+        {
+        const IndexValueType      index = std::min( std::max( center + k - rd, inputStart ), inputEnd );
+        const ComputingPixelType *source = &buffer[lineOffset + ( index - passRegion.GetIndex(d) ) * stride[d]];
+        const OperatorValueType   w = kernelD[k];
+        for ( SizeValueType i = 0; i < size0; ++i )
+          {
+          destination[i] += source[i] * w;
+          }
+        }
+
+      for ( unsigned int e = 1; e < ImageDimension; ++e )
+        {
+        if ( ++position[e] < static_cast< IndexValueType >( nextRegion.GetSize(e) ) )
+          {
+          break;
+          }
+        position[e] = 0;
+        }
+      }
+
+    buffer.swap( otherBuffer );
+    passRegion = nextRegion;
+    }
+}
+
+template< class TInputImage, class TOutputImage, class TOperatorValueType >
+void
+SeparableNeighborhoodOperatorImageFilter< TInputImage, TOutputImage, TOperatorValueType >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Radius: " << this->GetRadius() << std::endl;
+  os << indent << "MaximumNumberOfPixelsPerTile: " << m_MaximumNumberOfPixelsPerTile << std::endl;
+}
+} // end namespace itk
+
+#endif
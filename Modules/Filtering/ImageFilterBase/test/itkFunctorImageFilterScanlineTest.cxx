@@ -0,0 +1,301 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <iostream>
+
+#include "itkBinaryFunctorImageFilter.h"
+#include "itkUnaryFunctorImageFilter.h"
+#include "itkCastImageFilter.h"
+#include "itkClampImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+namespace
+{
+// per-pixel functors
+class WeightedDifference
+{
+public:
+  WeightedDifference():m_Weight(2.0f) {}
+  bool operator!=(const WeightedDifference & other) const { return m_Weight != other.m_Weight; }
+  bool operator==(const WeightedDifference & other) const { return !( *this != other ); }
+  inline float operator()(const float & a, const short & b) const
+  {
+    return m_Weight * a - b;
+  }
+  float m_Weight;
+};
+
+// span functor, counting the scanlines it processes
+class SpanOffset
+{
+public:
+  SpanOffset():m_Offset(3), m_Scanlines(0) {}
+  bool operator!=(const SpanOffset & other) const { return m_Offset != other.m_Offset; }
+  bool operator==(const SpanOffset & other) const { return !( *this != other ); }
+  inline float operator()(const short & a) const
+  {
+    return a + m_Offset;
+  }
+  inline void operator()(const short *in, float *out, itk::SizeValueType n) const
+  {
+    for ( itk::SizeValueType i = 0; i < n; ++i )
+      {
+      out[i] = ( *this )( in[i] );
+      }
+    ++( *m_Scanlines );
+  }
+  short                 m_Offset;
+  itk::SizeValueType   *m_Scanlines;
+};
+}
+
+namespace itk
+{
+template< >
+struct FunctorSpanTraits< SpanOffset > {
+  itkStaticConstMacro(HasSpanOperator, bool, true);
+};
+}
+
+namespace
+{
+typedef itk::Image< float, 3 > FloatImageType;
+typedef itk::Image< short, 3 > ShortImageType;
+
+template< class TImage >
+typename TImage::Pointer MakeImage(int seed)
+{
+  typename TImage::SizeType size;
+  size[0] = 31;
+  size[1] = 17;
+  size[2] = 5;
+  typename TImage::IndexType index;
+  index[0] = -4;
+  index[1] = 2;
+  index[2] = 7;
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions( typename TImage::RegionType(index, size) );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< TImage > it( image, image->GetLargestPossibleRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const typename TImage::IndexType & idx = it.GetIndex();
+    it.Set( static_cast< typename TImage::PixelType >( ( idx[0] * 7 + idx[1] * 13 + idx[2] * 3 + seed ) % 101 ) );
+    }
+  return image;
+}
+
+template< class TFilter, class TReference >
+bool Check(TFilter *filter, const FloatImageType::RegionType & region, TReference reference,
+           const char *name)
+{
+  filter->GetOutput()->SetRequestedRegion(region);
+  filter->Update();
+  itk::ImageRegionConstIteratorWithIndex< FloatImageType > it(filter->GetOutput(), region);
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const float expected = reference( it.GetIndex() );
+    if ( it.Get() != expected )
+      {
+      std::cerr << name << ": " << it.Get() << " instead of " << expected
+                << " at " << it.GetIndex() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+struct BinaryReference
+{
+  const FloatImageType *a;
+  const ShortImageType *b;
+  float                 constantA;
+  short                 constantB;
+  float operator()(const FloatImageType::IndexType & index) const
+  {
+    return 2.0f * ( a ? a->GetPixel(index) : constantA ) - ( b ? b->GetPixel(index) : constantB );
+  }
+};
+
+struct UnaryReference
+{
+  const ShortImageType *a;
+  float operator()(const FloatImageType::IndexType & index) const
+  {
+    return static_cast< float >( a->GetPixel(index) + 3 );
+  }
+};
+
+// A scanline of infinities, NaN and finite values.
+template< class TPixel >
+typename itk::Image< TPixel, 2 >::Pointer MakeSpecialValuesImage(bool withNaN)
+{
+  typedef itk::Image< TPixel, 2 > ImageType;
+  const TPixel values[] = {
+    itk::NumericTraits< TPixel >::infinity(),
+    -itk::NumericTraits< TPixel >::infinity(),
+    itk::NumericTraits< TPixel >::quiet_NaN(),
+    static_cast< TPixel >( 1.5 ),
+    static_cast< TPixel >( -2.5 ),
+    static_cast< TPixel >( 3.0e4 ),
+    static_cast< TPixel >( -4.0e4 ),
+    itk::NumericTraits< TPixel >::max(),
+    itk::NumericTraits< TPixel >::NonpositiveMin()
+    };
+  const unsigned int numberOfValues = sizeof( values ) / sizeof( values[0] );
+
+  typename ImageType::SizeType size;
+  size[0] = numberOfValues;
+  size[1] = 3;
+  typename ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    TPixel value = values[it.GetIndex()[0]];
+    if ( !withNaN && value != value )
+      {
+      value = 0;
+      }
+    it.Set(value);
+    }
+  return image;
+}
+
+// Run the span path of the functor of TFilter, and compare it with its
+// per-pixel operator.
+template< class TFilter >
+bool CheckSpecialValues(bool withNaN, const char *name)
+{
+  typedef typename TFilter::InputImageType  InputImageType;
+  typedef typename TFilter::OutputImageType OutputImageType;
+  typedef typename OutputImageType::PixelType OutputPixelType;
+
+  typename InputImageType::Pointer input =
+    MakeSpecialValuesImage< typename InputImageType::PixelType >(withNaN);
+  typename TFilter::Pointer filter = TFilter::New();
+  filter->SetInput(input);
+  filter->Update();
+
+  itk::ImageRegionConstIteratorWithIndex< OutputImageType > it( filter->GetOutput(),
+                                                              filter->GetOutput()->GetLargestPossibleRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const OutputPixelType expected = filter->GetFunctor()( input->GetPixel( it.GetIndex() ) );
+    const OutputPixelType value = it.Get();
+    const bool            bothNaN = ( expected != expected ) && ( value != value );
+    if ( value != expected && !bothNaN )
+      {
+      std::cerr << name << ": " << value << " instead of " << expected
+                << " for " << input->GetPixel( it.GetIndex() ) << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkFunctorImageFilterScanlineTest(int, char *[])
+{
+  FloatImageType::Pointer a = MakeImage< FloatImageType >(1);
+  ShortImageType::Pointer b = MakeImage< ShortImageType >(5);
+
+  // whole images, and a region that starts inside the scanlines
+  FloatImageType::RegionType regions[2];
+  regions[0] = a->GetLargestPossibleRegion();
+  regions[1] = a->GetLargestPossibleRegion();
+  regions[1].ShrinkByRadius(1);
+  regions[1].SetSize(0, 9);
+
+  bool success = true;
+  for ( unsigned int r = 0; r < 2; ++r )
+    {
+    typedef itk::BinaryFunctorImageFilter< FloatImageType, ShortImageType, FloatImageType,
+                                           WeightedDifference > BinaryFilterType;
+    BinaryReference reference;
+    reference.a = a;
+    reference.b = b;
+    reference.constantA = 5.0f;
+    reference.constantB = 11;
+
+    BinaryFilterType::Pointer binary = BinaryFilterType::New();
+    binary->SetInput1(a);
+    binary->SetInput2(b);
+    success &= Check(binary.GetPointer(), regions[r], reference, "images");
+
+    binary = BinaryFilterType::New();
+    binary->SetInput1(a);
+    binary->SetConstant2(reference.constantB);
+    reference.b = 0;
+    success &= Check(binary.GetPointer(), regions[r], reference, "constant 2");
+
+    binary = BinaryFilterType::New();
+    binary->SetConstant1(reference.constantA);
+    binary->SetInput2(b);
+    reference.a = 0;
+    reference.b = b;
+    success &= Check(binary.GetPointer(), regions[r], reference, "constant 1");
+
+    typedef itk::UnaryFunctorImageFilter< ShortImageType, FloatImageType, SpanOffset > UnaryFilterType;
+    UnaryFilterType::Pointer unary = UnaryFilterType::New();
+    itk::SizeValueType       scanlines = 0;
+    unary->GetFunctor().m_Scanlines = &scanlines;
+    unary->SetNumberOfThreads(1);
+    unary->SetInput(b);
+    UnaryReference unaryReference;
+    unaryReference.a = b;
+    success &= Check(unary.GetPointer(), regions[r], unaryReference, "span functor");
+
+    const itk::SizeValueType expectedScanlines = regions[r].GetNumberOfPixels() / regions[r].GetSize(0);
+    if ( scanlines != expectedScanlines )
+      {
+      std::cerr << "span functor: " << scanlines << " scanlines instead of "
+                << expectedScanlines << std::endl;
+      success = false;
+      }
+    }
+
+  // the span paths of Cast and Clamp agree with their per-pixel
+  // operators on infinities and NaN
+  typedef itk::Image< float, 2 >  Float2DImageType;
+  typedef itk::Image< double, 2 > Double2DImageType;
+  typedef itk::Image< short, 2 >  Short2DImageType;
+  success &= CheckSpecialValues< itk::CastImageFilter< Float2DImageType, Double2DImageType > >(
+    true, "cast float to double");
+  success &= CheckSpecialValues< itk::CastImageFilter< Float2DImageType, Float2DImageType > >(
+    true, "cast float to float");
+  success &= CheckSpecialValues< itk::ClampImageFilter< Float2DImageType, Double2DImageType > >(
+    true, "clamp float to double");
+  success &= CheckSpecialValues< itk::ClampImageFilter< Float2DImageType, Float2DImageType > >(
+    true, "clamp float to float");
+  success &= CheckSpecialValues< itk::ClampImageFilter< Double2DImageType, Float2DImageType > >(
+    true, "clamp double to float");
+  // converting NaN to an integer is undefined
+  success &= CheckSpecialValues< itk::ClampImageFilter< Float2DImageType, Short2DImageType > >(
+    false, "clamp float to short");
+
+  if ( !success )
+    {
+    std::cerr << "Test failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,224 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkSeparableNeighborhoodOperatorImageFilter.h"
+#include "itkNeighborhoodOperatorImageFilter.h"
+#include "itkGaussianOperator.h"
+#include "itkDerivativeOperator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+/*
+ * Compare the separable filter with a chain of NeighborhoodOperatorImageFilters
+ * for several tile sizes, numbers of threads and output requested regions.
+ */
+
+namespace
+{
+const unsigned int ImageDimension = 3;
+
+typedef itk::Image<double, ImageDimension>                                          ImageType;
+typedef itk::SeparableNeighborhoodOperatorImageFilter<ImageType, ImageType, double> SeparableFilterType;
+typedef itk::NeighborhoodOperatorImageFilter<ImageType, ImageType, double>          FilterType;
+typedef SeparableFilterType::OperatorType                                           OperatorType;
+
+ImageType::Pointer
+FilterWithChain( ImageType * input, OperatorType * operators[ImageDimension] )
+{
+  ImageType::Pointer image = input;
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    if( !operators[d] )
+      {
+      continue;
+      }
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetOperator( *operators[d] );
+    filter->SetInput( image );
+    filter->Update();
+    image = filter->GetOutput();
+    image->DisconnectPipeline();
+    }
+  return image;
+}
+
+double
+MaximumDifference( const ImageType * image, const ImageType * reference, const ImageType::RegionType & region )
+{
+  double maximumDifference = 0.0;
+  itk::ImageRegionConstIteratorWithIndex<ImageType> It( image, region );
+  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+    {
+    maximumDifference = vnl_math_max( maximumDifference,
+      vnl_math_abs( It.Get() - reference->GetPixel( It.GetIndex() ) ) );
+    }
+  return maximumDifference;
+}
+}
+
+int itkSeparableNeighborhoodOperatorImageFilterTest( int, char * [] )
+{
+  ImageType::IndexType start;
+  start[0] = 3;
+  start[1] = -2;
+  start[2] = 5;
+  ImageType::SizeType size;
+  size[0] = 37;
+  size[1] = 23;
+  size[2] = 19;
+  ImageType::RegionType region( start, size );
+
+  ImageType::Pointer input = ImageType::New();
+  input->SetRegions( region );
+  input->Allocate();
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 12345 );
+
+  itk::ImageRegionIteratorWithIndex<ImageType> It( input, region );
+  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+    {
+    It.Set( static_cast<double>( generator->GetIntegerVariate( 999 ) ) / 10.0 + It.GetIndex()[0] );
+    }
+
+  itk::GaussianOperator<double, ImageDimension> gaussian0;
+  gaussian0.SetDirection( 0 );
+  gaussian0.SetVariance( 4.0 );
+  gaussian0.SetMaximumError( 0.001 );
+  gaussian0.CreateDirectional();
+
+  itk::DerivativeOperator<double, ImageDimension> derivative1;
+  derivative1.SetDirection( 1 );
+  derivative1.SetOrder( 1 );
+  derivative1.CreateDirectional();
+
+  itk::GaussianOperator<double, ImageDimension> gaussian2;
+  gaussian2.SetDirection( 2 );
+  gaussian2.SetVariance( 9.0 );
+  gaussian2.SetMaximumError( 0.001 );
+  gaussian2.CreateDirectional();
+
+  OperatorType * operators[ImageDimension] = { &gaussian0, &derivative1, &gaussian2 };
+  OperatorType * partialOperators[ImageDimension] = { 0, &derivative1, &gaussian2 };
+  OperatorType ** operatorSets[2] = { operators, partialOperators };
+
+  // The smallest tiles are split along all the axes, the largest is the
+  // whole region of a thread.
+  const itk::SizeValueType tileSizes[4] = { 1, 8000, 30000, 1000000 };
+  const itk::ThreadIdType  threadCounts[2] = { 1, 3 };
+
+  ImageType::IndexType subRegionStart = start;
+  subRegionStart[1] += 4;
+  subRegionStart[2] += 2;
+  ImageType::SizeType subRegionSize = size;
+  subRegionSize[1] -= 9;
+  subRegionSize[2] = 7;
+  const ImageType::RegionType subRegion( subRegionStart, subRegionSize );
+
+  for( unsigned int s = 0; s < 2; s++ )
+    {
+    ImageType::Pointer reference;
+    try
+      {
+      reference = FilterWithChain( input, operatorSets[s] );
+      }
+    catch( itk::ExceptionObject & e )
+      {
+      std::cerr << "Exception caught: " << e << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    for( unsigned int t = 0; t < 4; t++ )
+      {
+      for( unsigned int n = 0; n < 2; n++ )
+        {
+        SeparableFilterType::Pointer filter = SeparableFilterType::New();
+        for( unsigned int d = 0; d < ImageDimension; d++ )
+          {
+          if( operatorSets[s][d] )
+            {
+            filter->SetOperator( *operatorSets[s][d] );
+            }
+          }
+        filter->SetMaximumNumberOfPixelsPerTile( tileSizes[t] );
+        filter->SetNumberOfThreads( threadCounts[n] );
+        filter->SetInput( input );
+
+        double fullDifference = 0.0;
+        double subRegionDifference = 0.0;
+        try
+          {
+          filter->Update();
+          fullDifference = MaximumDifference( filter->GetOutput(), reference, region );
+
+          filter->GetOutput()->SetRequestedRegion( subRegion );
+          filter->Modified();
+          filter->Update();
+          subRegionDifference = MaximumDifference( filter->GetOutput(), reference, subRegion );
+          }
+        catch( itk::ExceptionObject & e )
+          {
+          std::cerr << "Exception caught: " << e << std::endl;
+          return EXIT_FAILURE;
+          }
+
+        std::cout << "Operators " << s << ", tile size " << tileSizes[t] << ", "
+                  << threadCounts[n] << " threads: maximum difference "
+                  << fullDifference << ", " << subRegionDifference << std::endl;
+        if( fullDifference > 1.0e-9 || subRegionDifference > 1.0e-9 )
+          {
+          std::cerr << "The separable filter differs from the chain of filters." << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+  // Only one dimensional operators are accepted
+  itk::GaussianOperator<double, ImageDimension> isotropic;
+  isotropic.SetVariance( 1.0 );
+  isotropic.CreateToRadius( 1 );
+
+  SeparableFilterType::Pointer filter = SeparableFilterType::New();
+  bool caught = false;
+  try
+    {
+    filter->SetOperator( isotropic );
+    }
+  catch( itk::ExceptionObject & e )
+    {
+    std::cout << "Expected exception caught: " << e.GetDescription() << std::endl;
+    caught = true;
+    }
+  if( !caught )
+    {
+    std::cerr << "A multidimensional operator was accepted." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  filter->SetOperator( gaussian2 );
+  filter->ClearOperators();
+  if( !filter->GetKernel( 2 ).empty() )
+    {
+    std::cerr << "ClearOperators() did not remove the operators." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
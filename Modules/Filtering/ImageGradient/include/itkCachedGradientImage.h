@@ -0,0 +1,205 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkCachedGradientImage_h
+#define __itkCachedGradientImage_h
+
+#include "itkImage.h"
+#include "itkMath.h"
+
+namespace itk
+{
+/** \class CachedGradientImage
+ * \brief Image gradients stored as one single precision image per
+ * component.
+ *
+ * CachedGradientImage holds the gradient of an image as VDimension scalar
+ * images of float, sharing the grid of the differentiated image. Compared
+ * to an image of CovariantVector< double >, this halves the memory of the
+ * gradients and lets each component be read as a contiguous buffer.
+ *
+ * The gradient is evaluated at an index of the buffered region with
+ * EvaluateAtIndex(), or linearly interpolated at a continuous index or a
+ * physical point with EvaluateAtContinuousIndex() and Evaluate(), as
+ * LinearInterpolateImageFunction does on a gradient image. The gradient
+ * type of these methods only needs an operator[] for each component, so
+ * that CovariantVectors of any precision can be filled.
+ *
+ * CachedGradientImages are created and shared by GradientImageCache.
+ *
+ * \sa GradientImageCache
+ * \ingroup ITKImageGradient
+ */
+template< unsigned int VDimension >
+class ITK_EXPORT CachedGradientImage:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef CachedGradientImage        Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(CachedGradientImage, Object);
+
+  itkStaticConstMacro(ImageDimension, unsigned int, VDimension);
+
+  /** Type of the gradient components and of the image of a component. */
+  typedef float                                    ComponentType;
+  typedef Image< ComponentType, VDimension >       ComponentImageType;
+  typedef typename ComponentImageType::Pointer     ComponentImagePointer;
+  typedef typename ComponentImageType::IndexType   IndexType;
+  typedef typename ComponentImageType::RegionType  RegionType;
+  typedef typename ComponentImageType::OffsetValueType OffsetValueType;
+
+  /** Set the image of a component. All components must share the grid
+   * and buffered region of the image of component 0. */
+  void SetComponentImage(unsigned int component, ComponentImageType *image);
+
+  /** Get the image of a component. */
+  const ComponentImageType * GetComponentImage(unsigned int component) const
+  {
+    return m_ComponentImages[component];
+  }
+
+  /** Get the buffered region of the gradient images. */
+  const RegionType & GetBufferedRegion() const
+  {
+    return m_ComponentImages[0]->GetBufferedRegion();
+  }
+
+  /** Get the gradient at an index of the buffered region. */
+  template< class TGradient >
+  void EvaluateAtIndex(const IndexType & index, TGradient & gradient) const
+  {
+    const OffsetValueType offset = m_ComponentImages[0]->ComputeOffset(index);
+
+    for ( unsigned int d = 0; d < VDimension; d++ )
+      {
+      gradient[d] = m_ComponentBuffers[d][offset];
+      }
+  }
+
+  /** Get the gradient linearly interpolated at a continuous index. The
+   * neighbors outside the buffered region are replaced by the nearest
+   * ones inside it. */
+  template< class TCoordRep, class TGradient >
+  void EvaluateAtContinuousIndex(const ContinuousIndex< TCoordRep, VDimension > & cindex,
+                                 TGradient & gradient) const
+  {
+    const RegionType &     region = this->GetBufferedRegion();
+    const OffsetValueType *offsetTable = m_ComponentImages[0]->GetOffsetTable();
+
+    IndexType baseIndex;
+    double    distance[VDimension];
+    for ( unsigned int dim = 0; dim < VDimension; dim++ )
+      {
+      baseIndex[dim] = Math::Floor< typename IndexType::IndexValueType >(cindex[dim]);
+      distance[dim] = cindex[dim] - static_cast< double >( baseIndex[dim] );
+      }
+
+    double value[VDimension];
+    for ( unsigned int d = 0; d < VDimension; d++ )
+      {
+      value[d] = 0.0;
+      }
+
+    // The neighbors are the corners of the unit cell at baseIndex.
+    const unsigned int numberOfNeighbors = 1 << VDimension;
+    for ( unsigned int counter = 0; counter < numberOfNeighbors; counter++ )
+      {
+      double          overlap = 1.0;
+      OffsetValueType offset = 0;
+      unsigned int    upper = counter;
+      for ( unsigned int dim = 0; dim < VDimension; dim++ )
+        {
+        OffsetValueType neighIndex = baseIndex[dim];
+        if ( upper & 1 )
+          {
+          ++neighIndex;
+          overlap *= distance[dim];
+          }
+        else
+          {
+          overlap *= 1.0 - distance[dim];
+          }
+        upper >>= 1;
+
+        const OffsetValueType startIndex = region.GetIndex(dim);
+        const OffsetValueType endIndex = startIndex + static_cast< OffsetValueType >( region.GetSize(dim) ) - 1;
+        if ( neighIndex > endIndex )
+          {
+          neighIndex = endIndex;
+          }
+        if ( neighIndex < startIndex )
+          {
+          neighIndex = startIndex;
+          }
+        offset += ( neighIndex - startIndex ) * offsetTable[dim];
+        }
+
+      if ( overlap != 0.0 )
+        {
+        for ( unsigned int d = 0; d < VDimension; d++ )
+          {
+          value[d] += overlap * m_ComponentBuffers[d][offset];
+          }
+        }
+      }
+
+    for ( unsigned int d = 0; d < VDimension; d++ )
+      {
+      gradient[d] = value[d];
+      }
+  }
+
+  /** Get the gradient linearly interpolated at a physical point. */
+  template< class TCoordRep, class TGradient >
+  void Evaluate(const Point< TCoordRep, VDimension > & point, TGradient & gradient) const
+  {
+    ContinuousIndex< TCoordRep, VDimension > cindex;
+    m_ComponentImages[0]->TransformPhysicalPointToContinuousIndex(point, cindex);
+    this->EvaluateAtContinuousIndex(cindex, gradient);
+  }
+
+  /** Get the memory used by the gradient components, in bytes. */
+  SizeValueType GetBufferSizeInBytes() const;
+
+protected:
+  CachedGradientImage();
+  virtual ~CachedGradientImage() {}
+
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  CachedGradientImage(const Self &); //purposely not implemented
+  void operator=(const Self &);      //purposely not implemented
+
+  ComponentImagePointer m_ComponentImages[VDimension];
+  const ComponentType * m_ComponentBuffers[VDimension];
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkCachedGradientImage.hxx"
+#endif
+
+#endif
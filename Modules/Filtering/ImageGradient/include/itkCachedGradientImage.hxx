@@ -0,0 +1,79 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkCachedGradientImage_hxx
+#define __itkCachedGradientImage_hxx
+
+#include "itkCachedGradientImage.h"
+
+namespace itk
+{
+template< unsigned int VDimension >
+CachedGradientImage< VDimension >
+::CachedGradientImage()
+{
+  for ( unsigned int d = 0; d < VDimension; d++ )
+    {
+    m_ComponentBuffers[d] = 0;
+    }
+}
+
+template< unsigned int VDimension >
+void
+CachedGradientImage< VDimension >
+::SetComponentImage(unsigned int component, ComponentImageType *image)
+{
+  if ( component >= VDimension )
+    {
+    itkExceptionMacro(<< "Component " << component << " is out of range.");
+    }
+  m_ComponentImages[component] = image;
+  m_ComponentBuffers[component] = image ? image->GetBufferPointer() : 0;
+  this->Modified();
+}
+
+template< unsigned int VDimension >
+SizeValueType
+CachedGradientImage< VDimension >
+::GetBufferSizeInBytes() const
+{
+  SizeValueType size = 0;
+  for ( unsigned int d = 0; d < VDimension; d++ )
+    {
+    if ( m_ComponentImages[d] )
+      {
+      size += m_ComponentImages[d]->GetBufferedRegion().GetNumberOfPixels() * sizeof( ComponentType );
+      }
+    }
+  return size;
+}
+
+template< unsigned int VDimension >
+void
+CachedGradientImage< VDimension >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  for ( unsigned int d = 0; d < VDimension; d++ )
+    {
+    os << indent << "ComponentImage[" << d << "]: " << m_ComponentImages[d].GetPointer() << std::endl;
+    }
+  os << indent << "BufferSizeInBytes: " << this->GetBufferSizeInBytes() << std::endl;
+}
+} // end namespace itk
+
+#endif
@@ -0,0 +1,182 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkGradientImageCache_h
+#define __itkGradientImageCache_h
+
+#include "itkCachedGradientImage.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkMutexLock.h"
+#include <list>
+
+namespace itk
+{
+/** \class GradientImageCache
+ * \brief Computes image gradients once and shares them between their
+ * users.
+ *
+ * GetGradientImage() returns the gradient of an image as a
+ * CachedGradientImage, computing it only if the same image, unmodified
+ * since, was not already differentiated with the same parameters. A
+ * positive Sigma selects the gradient of the image smoothed by a Gaussian
+ * of that standard deviation, in physical units, as computed by
+ * GradientRecursiveGaussianImageFilter. A Sigma of zero selects the
+ * unsmoothed central differences of CentralDifferenceImageFunction.
+ *
+ * An entry is identified by the address, modification time and buffer of
+ * the image, and by the gradient parameters, so that a modified or
+ * reallocated image is differentiated again. At most
+ * MaximumNumberOfEntries gradient images are kept; the least recently used
+ * one is released first. A returned gradient image stays valid while it is
+ * referenced, even after its entry was released.
+ *
+ * A single cache can be set on several registration metrics, for instance
+ * ImageToImageMetricv4 and DemonsRegistrationFunction, so that the
+ * gradients of an image are computed once for all the metrics, starts and
+ * registrations that use it. GetGradientImage() may be called from
+ * several threads. Gradients with different keys are computed
+ * concurrently; a request for gradients that are being computed waits
+ * for them.
+ *
+ * \sa CachedGradientImage
+ * \ingroup ITKImageGradient
+ */
+template< unsigned int VDimension >
+class ITK_EXPORT GradientImageCache:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef GradientImageCache         Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(GradientImageCache, Object);
+
+  itkStaticConstMacro(ImageDimension, unsigned int, VDimension);
+
+  typedef CachedGradientImage< VDimension >                     CachedGradientImageType;
+  typedef typename CachedGradientImageType::ConstPointer        CachedGradientImageConstPointer;
+  typedef typename CachedGradientImageType::ComponentImageType  ComponentImageType;
+
+  /** Get the gradient of an image, computing it if it is not cached.
+   * \c sigma is the standard deviation of the Gaussian smoothing, in
+   * physical units, or zero for unsmoothed central differences.
+   * \c normalizeAcrossScale only applies to smoothed gradients.
+   * \c useImageDirection selects gradients with respect to the physical
+   * space instead of the image grid. */
+  template< class TImage >
+  CachedGradientImageConstPointer GetGradientImage(const TImage *image,
+                                                   double sigma,
+                                                   bool normalizeAcrossScale,
+                                                   bool useImageDirection);
+
+  /** Set/Get the maximum number of gradient images kept. Defaults to 4. */
+  itkSetClampMacro(MaximumNumberOfEntries, SizeValueType, 1, NumericTraits< SizeValueType >::max());
+  itkGetConstMacro(MaximumNumberOfEntries, SizeValueType);
+
+  /** Set/Get the number of threads used to compute smoothed gradients. */
+  itkSetClampMacro(NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfThreads, ThreadIdType);
+
+  /** Get the number of gradient images currently kept or being
+   * computed. */
+  SizeValueType GetNumberOfEntries() const;
+
+  /** Get the number of requests served from the cache and the number of
+   * gradient images computed. */
+  itkGetConstMacro(NumberOfHits, SizeValueType);
+  itkGetConstMacro(NumberOfMisses, SizeValueType);
+
+  /** Release all the gradient images. */
+  void Clear();
+
+protected:
+  GradientImageCache();
+  virtual ~GradientImageCache() {}
+
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+  /** Compute the gradient of an image. */
+  template< class TImage >
+  CachedGradientImageConstPointer ComputeGradientImage(const TImage *image,
+                                                       double sigma,
+                                                       bool normalizeAcrossScale,
+                                                       bool useImageDirection) const;
+
+private:
+  GradientImageCache(const Self &); //purposely not implemented
+  void operator=(const Self &);     //purposely not implemented
+
+  /** What identifies a gradient image. */
+  struct EntryKey
+  {
+    const void *  m_Image;
+    unsigned long m_ImageMTime;
+    const void *  m_Buffer;
+    double        m_Sigma;
+    bool          m_NormalizeAcrossScale;
+    bool          m_UseImageDirection;
+
+    bool operator==(const EntryKey & other) const
+    {
+      return m_Image == other.m_Image && m_ImageMTime == other.m_ImageMTime
+             && m_Buffer == other.m_Buffer && m_Sigma == other.m_Sigma
+             && m_NormalizeAcrossScale == other.m_NormalizeAcrossScale
+             && m_UseImageDirection == other.m_UseImageDirection;
+    }
+  };
+
+  /** An entry without gradient image is being computed by the thread
+   * that holds its lock. */
+  struct EntryType
+  {
+    EntryKey                        m_Key;
+    MutexLock::Pointer              m_ComputeLock;
+    CachedGradientImageConstPointer m_GradientImage;
+  };
+
+  typedef typename std::list< EntryType >::iterator EntryIterator;
+
+  /** Find the entry of a key. m_Lock must be held. */
+  EntryIterator FindEntry(const EntryKey & key);
+
+  /** Release the least recently used computed entries in excess of
+   * MaximumNumberOfEntries. m_Lock must be held. */
+  void ReleaseEntries();
+
+  /** Entries, the most recently used first. */
+  std::list< EntryType > m_Entries;
+
+  SizeValueType m_MaximumNumberOfEntries;
+  ThreadIdType  m_NumberOfThreads;
+  SizeValueType m_NumberOfHits;
+  SizeValueType m_NumberOfMisses;
+
+  mutable SimpleFastMutexLock m_Lock;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkGradientImageCache.hxx"
+#endif
+
+#endif
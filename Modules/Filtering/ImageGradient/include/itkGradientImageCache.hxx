@@ -0,0 +1,265 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkGradientImageCache_hxx
+#define __itkGradientImageCache_hxx
+
+#include "itkGradientImageCache.h"
+#include "itkGradientRecursiveGaussianImageFilter.h"
+#include "itkCentralDifferenceImageFunction.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkMultiThreader.h"
+
+namespace itk
+{
+template< unsigned int VDimension >
+GradientImageCache< VDimension >
+::GradientImageCache():
+  m_MaximumNumberOfEntries(4),
+  m_NumberOfThreads( MultiThreader::GetGlobalDefaultNumberOfThreads() ),
+  m_NumberOfHits(0),
+  m_NumberOfMisses(0)
+{
+}
+
+template< unsigned int VDimension >
+template< class TImage >
+typename GradientImageCache< VDimension >::CachedGradientImageConstPointer
+GradientImageCache< VDimension >
+::GetGradientImage(const TImage *image,
+                   double sigma,
+                   bool normalizeAcrossScale,
+                   bool useImageDirection)
+{
+  if ( !image )
+    {
+    itkExceptionMacro(<< "No image to differentiate.");
+    }
+
+  EntryKey key;
+  key.m_Image = image;
+  key.m_ImageMTime = image->GetMTime();
+  key.m_Buffer = image->GetBufferPointer();
+  key.m_Sigma = sigma > 0.0 ? sigma : 0.0;
+  key.m_NormalizeAcrossScale = sigma > 0.0 ? normalizeAcrossScale : false;
+  key.m_UseImageDirection = useImageDirection;
+
+  // Look the key up, or add an entry to be computed.
+  m_Lock.Lock();
+  EntryIterator it = this->FindEntry(key);
+  if ( it != m_Entries.end() && it->m_GradientImage.IsNotNull() )
+    {
+    m_Entries.splice(m_Entries.begin(), m_Entries, it);
+    ++m_NumberOfHits;
+    CachedGradientImageConstPointer gradientImage = it->m_GradientImage;
+    m_Lock.Unlock();
+    return gradientImage;
+    }
+  if ( it == m_Entries.end() )
+    {
+    EntryType entry;
+    entry.m_Key = key;
+    entry.m_ComputeLock = MutexLock::New();
+    m_Entries.push_front(entry);
+    it = m_Entries.begin();
+    }
+  MutexLock::Pointer computeLock = it->m_ComputeLock;
+  m_Lock.Unlock();
+
+  // The gradients are computed without holding m_Lock, by the first
+  // thread to take the lock of the entry. The others wait for them.
+  computeLock->Lock();
+  m_Lock.Lock();
+  it = this->FindEntry(key);
+  if ( it != m_Entries.end() && it->m_GradientImage.IsNotNull() )
+    {
+    m_Entries.splice(m_Entries.begin(), m_Entries, it);
+    ++m_NumberOfHits;
+    CachedGradientImageConstPointer gradientImage = it->m_GradientImage;
+    m_Lock.Unlock();
+    computeLock->Unlock();
+    return gradientImage;
+    }
+  m_Lock.Unlock();
+
+  CachedGradientImageConstPointer gradientImage;
+  try
+    {
+    gradientImage = this->ComputeGradientImage(image, key.m_Sigma, key.m_NormalizeAcrossScale, useImageDirection);
+    }
+  catch ( ... )
+    {
+    // A waiting thread computes the gradients in turn.
+    computeLock->Unlock();
+    throw;
+    }
+
+  m_Lock.Lock();
+  ++m_NumberOfMisses;
+  it = this->FindEntry(key);
+  if ( it != m_Entries.end() )
+    {
+    it->m_GradientImage = gradientImage;
+    m_Entries.splice(m_Entries.begin(), m_Entries, it);
+    }
+  this->ReleaseEntries();
+  m_Lock.Unlock();
+  computeLock->Unlock();
+
+  return gradientImage;
+}
+
+template< unsigned int VDimension >
+typename GradientImageCache< VDimension >::EntryIterator
+GradientImageCache< VDimension >
+::FindEntry(const EntryKey & key)
+{
+  for ( EntryIterator it = m_Entries.begin(); it != m_Entries.end(); ++it )
+    {
+    if ( it->m_Key == key )
+      {
+      return it;
+      }
+    }
+  return m_Entries.end();
+}
+
+template< unsigned int VDimension >
+void
+GradientImageCache< VDimension >
+::ReleaseEntries()
+{
+  // Entries being computed are kept, for the threads waiting for them.
+  EntryIterator it = m_Entries.end();
+  while ( m_Entries.size() > m_MaximumNumberOfEntries && it != m_Entries.begin() )
+    {
+    --it;
+    if ( it->m_GradientImage.IsNotNull() )
+      {
+      it = m_Entries.erase(it);
+      }
+    }
+}
+
+template< unsigned int VDimension >
+template< class TImage >
+typename GradientImageCache< VDimension >::CachedGradientImageConstPointer
+GradientImageCache< VDimension >
+::ComputeGradientImage(const TImage *image,
+                       double sigma,
+                       bool normalizeAcrossScale,
+                       bool useImageDirection) const
+{
+  typedef typename CachedGradientImageType::ComponentType ComponentType;
+
+  const typename TImage::RegionType region = image->GetBufferedRegion();
+
+  ComponentType *                           buffers[VDimension];
+  typename CachedGradientImageType::Pointer gradientImage = CachedGradientImageType::New();
+  for ( unsigned int d = 0; d < VDimension; d++ )
+    {
+    typename ComponentImageType::Pointer componentImage = ComponentImageType::New();
+    componentImage->CopyInformation(image);
+    componentImage->SetRegions(region);
+    componentImage->Allocate();
+    buffers[d] = componentImage->GetBufferPointer();
+    gradientImage->SetComponentImage(d, componentImage);
+    }
+
+  if ( sigma > 0.0 )
+    {
+    typedef Image< CovariantVector< ComponentType, VDimension >, VDimension >  VectorImageType;
+    typedef GradientRecursiveGaussianImageFilter< TImage, VectorImageType >    FilterType;
+    typename FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(image);
+    filter->SetSigma(sigma);
+    filter->SetNormalizeAcrossScale(normalizeAcrossScale);
+    filter->SetUseImageDirection(useImageDirection);
+    filter->SetNumberOfThreads(m_NumberOfThreads);
+    filter->Update();
+
+    // Split the components of the filter output.
+    ImageRegionConstIterator< VectorImageType > it( filter->GetOutput(), region );
+    SizeValueType                                i = 0;
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it, ++i )
+      {
+      const typename VectorImageType::PixelType & gradient = it.Value();
+      for ( unsigned int d = 0; d < VDimension; d++ )
+        {
+        buffers[d][i] = gradient[d];
+        }
+      }
+    }
+  else
+    {
+    typedef CentralDifferenceImageFunction< TImage, double > FunctionType;
+    typename FunctionType::Pointer function = FunctionType::New();
+    function->SetUseImageDirection(useImageDirection);
+    function->SetInputImage(image);
+
+    ImageRegionConstIteratorWithIndex< TImage > it(image, region);
+    SizeValueType                               i = 0;
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it, ++i )
+      {
+      const typename FunctionType::OutputType gradient = function->EvaluateAtIndex( it.GetIndex() );
+      for ( unsigned int d = 0; d < VDimension; d++ )
+        {
+        buffers[d][i] = static_cast< ComponentType >( gradient[d] );
+        }
+      }
+    }
+
+  return gradientImage.GetPointer();
+}
+
+template< unsigned int VDimension >
+SizeValueType
+GradientImageCache< VDimension >
+::GetNumberOfEntries() const
+{
+  m_Lock.Lock();
+  const SizeValueType numberOfEntries = m_Entries.size();
+  m_Lock.Unlock();
+  return numberOfEntries;
+}
+
+template< unsigned int VDimension >
+void
+GradientImageCache< VDimension >
+::Clear()
+{
+  m_Lock.Lock();
+  m_Entries.clear();
+  m_Lock.Unlock();
+}
+
+template< unsigned int VDimension >
+void
+GradientImageCache< VDimension >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumNumberOfEntries: " << m_MaximumNumberOfEntries << std::endl;
+  os << indent << "NumberOfThreads: " << m_NumberOfThreads << std::endl;
+  os << indent << "NumberOfEntries: " << this->GetNumberOfEntries() << std::endl;
+  os << indent << "NumberOfHits: " << m_NumberOfHits << std::endl;
+  os << indent << "NumberOfMisses: " << m_NumberOfMisses << std::endl;
+}
+} // end namespace itk
+
+#endif
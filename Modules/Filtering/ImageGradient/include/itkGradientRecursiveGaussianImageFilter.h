@@ -123,6 +123,12 @@ public:
   /** Set Sigma value. Sigma is measured in the units of image spacing.  */
   void SetSigma(RealType sigma);
 
+  /** Get Sigma value. */
+  RealType GetSigma() const
+  {
+    return m_DerivativeFilter->GetSigma();
+  }
+
   /** Define which normalization factor will be used for the Gaussian
    *  \sa  RecursiveGaussianImageFilter::SetNormalizeAcrossScale
    */
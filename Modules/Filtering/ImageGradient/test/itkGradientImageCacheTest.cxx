@@ -0,0 +1,252 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkGradientImageCache.h"
+#include "itkGradientRecursiveGaussianImageFilter.h"
+#include "itkCentralDifferenceImageFunction.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMultiThreader.h"
+#include "itkMath.h"
+
+// Test that GradientImageCache computes the same gradients as
+// GradientRecursiveGaussianImageFilter and CentralDifferenceImageFunction,
+// that it reuses them until the image changes, that it evicts the
+// least recently used entries, and that concurrent requests compute each
+// gradient image once.
+
+namespace
+{
+typedef itk::Image< float, 2 >       GradientImageCacheTestImageType;
+typedef itk::GradientImageCache< 2 > GradientImageCacheTestCacheType;
+
+struct GradientImageCacheTestStruct
+{
+  GradientImageCacheTestCacheType *       Cache;
+  const GradientImageCacheTestImageType * Image;
+};
+
+ITK_THREAD_RETURN_TYPE GradientImageCacheTestCallback(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct *info =
+    static_cast< itk::MultiThreader::ThreadInfoStruct * >( arg );
+  const GradientImageCacheTestStruct *str =
+    static_cast< const GradientImageCacheTestStruct * >( info->UserData );
+
+  // Every thread requests the same two gradient images, in an order that
+  // depends on the thread.
+  const double sigmas[2] = { 4.0, 5.0 };
+  for ( unsigned int i = 0; i < 2; i++ )
+    {
+    str->Cache->GetGradientImage( str->Image, sigmas[( i + info->ThreadID ) % 2], true, true );
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+}
+
+int itkGradientImageCacheTest(int, char* [] )
+{
+  const unsigned int Dimension = 2;
+
+  typedef itk::Image< float, Dimension >                ImageType;
+  typedef itk::GradientImageCache< Dimension >          CacheType;
+  typedef CacheType::CachedGradientImageType            CachedGradientImageType;
+  typedef itk::CovariantVector< double, Dimension >     GradientType;
+
+  ImageType::SizeType size;
+  size[0] = 40;
+  size[1] = 32;
+  ImageType::IndexType start;
+  start[0] = 3;
+  start[1] = -2;
+  ImageType::RegionType region( start, size );
+
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 1.5;
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->SetSpacing( spacing );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    it.Set( vcl_sin( 0.2 * index[0] ) * vcl_cos( 0.3 * index[1] ) + 0.01 * index[0] * index[1] );
+    }
+
+  CacheType::Pointer cache = CacheType::New();
+  cache->Print( std::cout );
+
+  const double tolerance = 1e-4;
+
+  // Smoothed gradients against the filter.
+  typedef itk::GradientRecursiveGaussianImageFilter< ImageType > FilterType;
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( image );
+  filter->SetSigma( 1.25 );
+  filter->SetNormalizeAcrossScale( true );
+  filter->Update();
+
+  CachedGradientImageType::ConstPointer smoothed =
+    cache->GetGradientImage( image.GetPointer(), 1.25, true, true );
+  if ( smoothed->GetBufferedRegion() != region )
+    {
+    std::cerr << "Wrong region " << smoothed->GetBufferedRegion() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itk::ImageRegionConstIteratorWithIndex< FilterType::OutputImageType > fit( filter->GetOutput(), region );
+  for ( fit.GoToBegin(); !fit.IsAtEnd(); ++fit )
+    {
+    GradientType gradient;
+    smoothed->EvaluateAtIndex( fit.GetIndex(), gradient );
+    for ( unsigned int d = 0; d < Dimension; d++ )
+      {
+      if ( vcl_abs( gradient[d] - fit.Get()[d] ) > tolerance )
+        {
+        std::cerr << "Smoothed gradient mismatch at " << fit.GetIndex()
+                  << ": " << gradient << " vs " << fit.Get() << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // Central differences against the image function.
+  typedef itk::CentralDifferenceImageFunction< ImageType, double > CentralDifferenceType;
+  CentralDifferenceType::Pointer centralDifference = CentralDifferenceType::New();
+  centralDifference->SetInputImage( image );
+
+  CachedGradientImageType::ConstPointer unsmoothed =
+    cache->GetGradientImage( image.GetPointer(), 0.0, false, true );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    GradientType       gradient;
+    const GradientType expected = centralDifference->EvaluateAtIndex( it.GetIndex() );
+    unsmoothed->EvaluateAtIndex( it.GetIndex(), gradient );
+    for ( unsigned int d = 0; d < Dimension; d++ )
+      {
+      if ( vcl_abs( gradient[d] - expected[d] ) > tolerance )
+        {
+        std::cerr << "Central difference mismatch at " << it.GetIndex()
+                  << ": " << gradient << " vs " << expected << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // Interpolation reproduces the samples, and is linear in between.
+  itk::ContinuousIndex< double, Dimension > cindex;
+  cindex[0] = 10.25;
+  cindex[1] = 7.5;
+  GradientType interpolated;
+  unsmoothed->EvaluateAtContinuousIndex( cindex, interpolated );
+  GradientType corners[4];
+  ImageType::IndexType cornerIndex;
+  for ( unsigned int c = 0; c < 4; c++ )
+    {
+    cornerIndex[0] = 10 + ( c & 1 );
+    cornerIndex[1] = 7 + ( c >> 1 );
+    unsmoothed->EvaluateAtIndex( cornerIndex, corners[c] );
+    }
+  for ( unsigned int d = 0; d < Dimension; d++ )
+    {
+    const double expected = 0.5 * ( 0.75 * corners[0][d] + 0.25 * corners[1][d] )
+                            + 0.5 * ( 0.75 * corners[2][d] + 0.25 * corners[3][d] );
+    if ( vcl_abs( interpolated[d] - expected ) > tolerance )
+      {
+      std::cerr << "Interpolation mismatch: " << interpolated << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Reuse, recomputation after a modification, and eviction.
+  if ( cache->GetNumberOfMisses() != 2 || cache->GetNumberOfHits() != 0 )
+    {
+    std::cerr << "Expected 2 misses and no hits" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( cache->GetGradientImage( image.GetPointer(), 1.25, true, true ) != smoothed
+       || cache->GetNumberOfHits() != 1 )
+    {
+    std::cerr << "Expected a cache hit" << std::endl;
+    return EXIT_FAILURE;
+    }
+  image->Modified();
+  if ( cache->GetGradientImage( image.GetPointer(), 1.25, true, true ) == smoothed
+       || cache->GetNumberOfMisses() != 3 )
+    {
+    std::cerr << "Expected a recomputation after Modified()" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  cache->SetMaximumNumberOfEntries( 2 );
+  cache->GetGradientImage( image.GetPointer(), 2.0, true, true );
+  if ( cache->GetNumberOfEntries() != 2 )
+    {
+    std::cerr << "Expected 2 entries, got " << cache->GetNumberOfEntries() << std::endl;
+    return EXIT_FAILURE;
+    }
+  // 1.25 becomes the most recently used, so 2.0 is evicted by 3.0.
+  cache->GetGradientImage( image.GetPointer(), 1.25, true, true );
+  cache->GetGradientImage( image.GetPointer(), 3.0, true, true );
+  const itk::SizeValueType misses = cache->GetNumberOfMisses();
+  cache->GetGradientImage( image.GetPointer(), 1.25, true, true );
+  if ( cache->GetNumberOfMisses() != misses )
+    {
+    std::cerr << "The most recently used entry was evicted" << std::endl;
+    return EXIT_FAILURE;
+    }
+  cache->GetGradientImage( image.GetPointer(), 2.0, true, true );
+  if ( cache->GetNumberOfMisses() != misses + 1 )
+    {
+    std::cerr << "The least recently used entry was not evicted" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  cache->Clear();
+  if ( cache->GetNumberOfEntries() != 0 )
+    {
+    std::cerr << "Clear() left entries" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Concurrent requests.
+  GradientImageCacheTestStruct str;
+  str.Cache = cache;
+  str.Image = image;
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads( 4 );
+  threader->SetSingleMethod( GradientImageCacheTestCallback, &str );
+  const itk::SizeValueType missesBefore = cache->GetNumberOfMisses();
+  const itk::SizeValueType hitsBefore = cache->GetNumberOfHits();
+  threader->SingleMethodExecute();
+  const itk::SizeValueType requests = 2 * threader->GetNumberOfThreads();
+  if ( cache->GetNumberOfMisses() != missesBefore + 2
+       || cache->GetNumberOfHits() != hitsBefore + requests - 2 )
+    {
+    std::cerr << "Concurrent requests: " << cache->GetNumberOfMisses() - missesBefore
+              << " misses and " << cache->GetNumberOfHits() - hitsBefore
+              << " hits instead of 2 and " << requests - 2 << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -317,7 +317,8 @@ protected:
                             ThreadIdType threadId);
 
   /** Default implementation for resampling that works for any
-   * transformation type. */
+   * transformation type.  Each output scanline is mapped with a single
+   * call to Transform::TransformPointsAlongLine(). */
   virtual void NonlinearThreadedGenerateData(const OutputImageRegionType &
                                      outputRegionForThread,
                                      ThreadIdType threadId);
@@ -301,16 +301,11 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
   // Get this input pointers
   InputImageConstPointer inputPtr = this->GetInput();
 
-  // Create an iterator that will walk the output region for this thread.
-  typedef ImageRegionIteratorWithIndex< TOutputImage > OutputIterator;
+  // Create an iterator that will walk the output region for this thread,
+  // one scanline at a time.
+  typedef ImageLinearIteratorWithIndex< TOutputImage > OutputIterator;
   OutputIterator outIt(outputPtr, outputRegionForThread);
-
-  // Define a few indices that will be used to translate from an input pixel
-  // to an output pixel
-  PointType outputPoint;         // Coordinates of current output pixel
-  PointType inputPoint;          // Coordinates of current input pixel
-
-  ContinuousInputIndexType inputIndex;
+  outIt.SetDirection(0);
 
   // Support for progress methods/callbacks
   ProgressReporter progress( this,
@@ -326,43 +321,78 @@ ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
   const ComponentType minOutputValue = static_cast< ComponentType >( minValue );
   const ComponentType maxOutputValue = static_cast< ComponentType >( maxValue );
 
+  // The physical points of a scanline are mapped with a single call to
+  // the transform, which lets transforms such as BSplineTransform and
+  // DisplacementFieldTransform share work along the line, and the
+  // positions that fall inside the input buffer are interpolated with a
+  // single call to the interpolator.
+  const SizeValueType                     lineLength = outputRegionForThread.GetSize()[0];
+  std::vector< PointType >                outputPoints(lineLength);
+  std::vector< PointType >                inputPoints(lineLength);
+  std::vector< ContinuousInputIndexType > inputIndices(lineLength);
+  std::vector< ContinuousInputIndexType > insideIndices(lineLength);
+  std::vector< OutputType >               insideValues(lineLength);
+  std::vector< bool >                     isInside(lineLength);
+
   // Walk the output region
   outIt.GoToBegin();
 
   while ( !outIt.IsAtEnd() )
     {
-    // Determine the index of the current output pixel
-    outputPtr->TransformIndexToPhysicalPoint(outIt.GetIndex(), outputPoint);
+    // Determine the coordinates of the output pixels
+    for ( SizeValueType i = 0; !outIt.IsAtEndOfLine(); ++i, ++outIt )
+      {
+      outputPtr->TransformIndexToPhysicalPoint(outIt.GetIndex(), outputPoints[i]);
+      }
 
-    // Compute corresponding input pixel position
-    inputPoint = this->m_Transform->TransformPoint(outputPoint);
-    inputPtr->TransformPhysicalPointToContinuousIndex(inputPoint, inputIndex);
+    // Compute corresponding input pixel positions
+    this->m_Transform->TransformPointsAlongLine(&outputPoints[0], &inputPoints[0], lineLength);
 
-    PixelType        pixval;
-    OutputType       value;
-    // Evaluate input at right position and copy to the output
-    if ( m_Interpolator->IsInsideBuffer(inputIndex) )
+    SizeValueType numberOfInsidePoints = 0;
+    for ( SizeValueType i = 0; i < lineLength; ++i )
       {
-      value = m_Interpolator ->EvaluateAtContinuousIndex(inputIndex);
-      pixval = this->CastPixelWithBoundsChecking( value, minOutputValue, maxOutputValue );
-      outIt.Set(pixval);
+      inputPtr->TransformPhysicalPointToContinuousIndex(inputPoints[i], inputIndices[i]);
+
+      isInside[i] = m_Interpolator->IsInsideBuffer(inputIndices[i]);
+      if ( isInside[i] )
+        {
+        insideIndices[numberOfInsidePoints++] = inputIndices[i];
+        }
       }
-    else
+
+    if ( numberOfInsidePoints > 0 )
+      {
+      m_Interpolator->EvaluateAtContinuousIndices(&insideIndices[0],
+                                                  &insideValues[0],
+                                                  numberOfInsidePoints);
+      }
+
+    // Copy the values to the output
+    outIt.GoToBeginOfLine();
+    SizeValueType insideCount = 0;
+    for ( SizeValueType i = 0; !outIt.IsAtEndOfLine(); ++i, ++outIt )
       {
-      if( m_Extrapolator.IsNull() )
+      if ( isInside[i] )
         {
-        outIt.Set( m_DefaultPixelValue ); // default background value
+        outIt.Set( this->CastPixelWithBoundsChecking( insideValues[insideCount++],
+                                                      minOutputValue, maxOutputValue ) );
         }
       else
         {
-        value = m_Extrapolator->EvaluateAtContinuousIndex( inputIndex );
-        pixval = this->CastPixelWithBoundsChecking( value, minOutputValue, maxOutputValue );
-        outIt.Set(pixval);
+        if( m_Extrapolator.IsNull() )
+          {
+          outIt.Set( m_DefaultPixelValue ); // default background value
+          }
+        else
+          {
+          const OutputType value = m_Extrapolator->EvaluateAtContinuousIndex( inputIndices[i] );
+          outIt.Set( this->CastPixelWithBoundsChecking( value, minOutputValue, maxOutputValue ) );
+          }
         }
-      }
 
-    progress.CompletedPixel();
-    ++outIt;
+      progress.CompletedPixel();
+      }
+    outIt.NextLine();
     }
 
   return;
@@ -58,7 +58,7 @@ public:
 private:
   unsigned int m_Size;
 
-  typedef Function::MorphologyHistogram< InputImagePixelType, TCompare >              HistogramType;
+  typedef Function::AnchorHistogram< InputImagePixelType, TCompare >                  HistogramType;
 
   bool StartLine(std::vector<TInputPix> & buffer,
                  std::vector<TInputPix> & inbuffer,
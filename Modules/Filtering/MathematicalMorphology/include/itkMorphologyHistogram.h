@@ -22,19 +22,23 @@
 #include <vector>
 #include "itkIntTypes.h"
 #include "itkNumericTraits.h"
+#include "itkOccupancyHistogram.h"
 
 namespace itk
 {
 namespace Function
 {
 template< class TInputPixel, class TCompare >
-class MorphologyHistogram
+class MapMorphologyHistogram
 {
 public:
 
   typedef typename std::map< TInputPixel, IdentifierType, TCompare > MapType;
 
-  MorphologyHistogram(){}
+  MapMorphologyHistogram()
+  {
+    m_Boundary = NumericTraits< TInputPixel >::Zero;
+  }
 
   inline void AddBoundary()
   {
@@ -109,6 +113,12 @@ public:
 
 };
 
+template< class TInputPixel, class TCompare >
+class MorphologyHistogram:
+  public MapMorphologyHistogram< TInputPixel, TCompare >
+{
+};
+
 template< class TInputPixel, class TCompare >
 class VectorMorphologyHistogram
 {
@@ -190,6 +200,80 @@ public:
   TInputPixel                     m_Boundary;
 };
 
+// The 16 bit types are too large for the vector to be scanned when the
+// extremum is removed, so the bins are indexed by occupancy bitmaps
+template< class TInputPixel, class TCompare >
+class OccupancyMorphologyHistogram
+{
+public:
+
+  OccupancyMorphologyHistogram()
+  {
+    if ( m_Compare( NumericTraits< TInputPixel >::max(), NumericTraits< TInputPixel >::NonpositiveMin() ) )
+      {
+      m_InitValue = NumericTraits< TInputPixel >::NonpositiveMin();
+      }
+    else
+      {
+      m_InitValue = NumericTraits< TInputPixel >::max();
+      }
+    m_Boundary = 0;
+  }
+
+  inline void AddBoundary()
+  {
+    m_Histogram.AddPixel(m_Boundary);
+  }
+
+  inline void RemoveBoundary()
+  {
+    m_Histogram.RemovePixel(m_Boundary);
+  }
+
+  inline void AddPixel(const TInputPixel & p)
+  {
+    m_Histogram.AddPixel(p);
+  }
+
+  inline void RemovePixel(const TInputPixel & p)
+  {
+    m_Histogram.RemovePixel(p);
+  }
+
+  inline TInputPixel GetValue()
+  {
+    if ( m_Histogram.IsEmpty() )
+      {
+      return m_InitValue;
+      }
+    if ( m_Compare( NumericTraits< TInputPixel >::max(), NumericTraits< TInputPixel >::NonpositiveMin() ) )
+      {
+      return m_Histogram.GetMaximum();
+      }
+    return m_Histogram.GetMinimum();
+  }
+
+  inline TInputPixel GetValue(const TInputPixel &)
+  {
+    return GetValue();
+  }
+
+  void SetBoundary(const TInputPixel & val)
+  {
+    m_Boundary = val;
+  }
+
+  static bool UseVectorBasedAlgorithm()
+  {
+    return true;
+  }
+
+  OccupancyHistogram< TInputPixel > m_Histogram;
+  TInputPixel                       m_InitValue;
+  TCompare                          m_Compare;
+  TInputPixel                       m_Boundary;
+};
+
 /** \cond HIDE_SPECIALIZATION_DOCUMENTATION */
 
 // now create MorphologyHistogram partial specilizations using the VectorMorphologyHistogram
@@ -213,6 +297,43 @@ class MorphologyHistogram<bool, TCompare>:
 {
 };
 
+template< class TCompare >
+class MorphologyHistogram<short, TCompare>:
+  public OccupancyMorphologyHistogram<short, TCompare>
+{
+};
+
+template< class TCompare >
+class MorphologyHistogram<unsigned short, TCompare>:
+  public OccupancyMorphologyHistogram<unsigned short, TCompare>
+{
+};
+
+/** \endcond */
+
+// The anchor filters create a new histogram for each segment of a line,
+// and only add a few values to it: the 16 bit occupancy histograms are
+// too expensive to create for that use, so the maps are used instead.
+template< class TInputPixel, class TCompare >
+class AnchorHistogram:
+  public MorphologyHistogram< TInputPixel, TCompare >
+{
+};
+
+/** \cond HIDE_SPECIALIZATION_DOCUMENTATION */
+
+template< class TCompare >
+class AnchorHistogram<short, TCompare>:
+  public MapMorphologyHistogram<short, TCompare>
+{
+};
+
+template< class TCompare >
+class AnchorHistogram<unsigned short, TCompare>:
+  public MapMorphologyHistogram<unsigned short, TCompare>
+{
+};
+
 /** \endcond */
 
 } // end namespace Function
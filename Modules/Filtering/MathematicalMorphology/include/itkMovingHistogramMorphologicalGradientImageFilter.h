@@ -19,6 +19,7 @@
 #define __itkMovingHistogramMorphologicalGradientImageFilter_h
 
 #include "itkMovingHistogramImageFilter.h"
+#include "itkOccupancyHistogram.h"
 #include <map>
 
 namespace itk
@@ -179,6 +180,52 @@ public:
   SizeValueType                m_Count;
 };
 
+// The 16 bit types are too large for the vector to be scanned when the
+// extrema are removed, so the bins are indexed by occupancy bitmaps
+template< class TInputPixel >
+class OccupancyMorphologicalGradientHistogram
+{
+public:
+  OccupancyMorphologicalGradientHistogram(){}
+
+  ~OccupancyMorphologicalGradientHistogram(){}
+
+  inline void AddBoundary() {}
+
+  inline void RemoveBoundary() {}
+
+  inline void AddPixel(const TInputPixel & p)
+  {
+    m_Histogram.AddPixel(p);
+  }
+
+  inline void RemovePixel(const TInputPixel & p)
+  {
+    m_Histogram.RemovePixel(p);
+  }
+
+  inline TInputPixel GetValue(const TInputPixel &)
+  {
+    return GetValue();
+  }
+
+  inline TInputPixel GetValue()
+  {
+    if ( !m_Histogram.IsEmpty() )
+      {
+      return m_Histogram.GetMaximum() - m_Histogram.GetMinimum();
+      }
+    return NumericTraits< TInputPixel >::Zero;
+  }
+
+  static bool UseVectorBasedAlgorithm()
+  {
+    return true;
+  }
+
+  OccupancyHistogram< TInputPixel > m_Histogram;
+};
+
 /** \cond HIDE_SPECIALIZATION_DOCUMENTATION */
 
 // now create MorphologicalGradientHistogram specilizations using the VectorMorphologicalGradientHistogram
@@ -202,6 +249,18 @@ class MorphologicalGradientHistogram<bool>:
 {
 };
 
+template<>
+class MorphologicalGradientHistogram<short>:
+  public OccupancyMorphologicalGradientHistogram<short>
+{
+};
+
+template<>
+class MorphologicalGradientHistogram<unsigned short>:
+  public OccupancyMorphologicalGradientHistogram<unsigned short>
+{
+};
+
 /** \endcond */
 
 } // end namespace Function
@@ -0,0 +1,198 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkOccupancyHistogram_h
+#define __itkOccupancyHistogram_h
+
+#include <vector>
+#include <algorithm>
+#include "itkIntTypes.h"
+#include "itkMacro.h"
+#include "itkNumericTraits.h"
+
+namespace itk
+{
+namespace Function
+{
+/** \class OccupancyHistogram
+ * \brief Flat histogram of an integral pixel type with occupancy bitmaps.
+ *
+ * The histogram has one bin for each value of the pixel type, which is
+ * meant to be a 16 bit integral type. Above the bins, a bitmap keeps
+ * one bit per bin telling whether the bin is occupied, and a summary
+ * bitmap keeps one bit per word of the first bitmap telling whether the
+ * word is not null. The minimum and the maximum of the histogram are
+ * found by scanning the few words of the summary bitmap and then one
+ * word of the bin bitmap, whatever the distance between the values.
+ *
+ * Copying a histogram only copies the words of bins which are occupied
+ * in either histogram, so that the copies made by the moving histogram
+ * algorithm at each line cost as much as the number of distinct values
+ * in the neighborhood and not as much as the range of the pixel type.
+ *
+ * \ingroup ITKMathematicalMorphology
+ */
+template< class TInputPixel >
+class OccupancyHistogram
+{
+public:
+  OccupancyHistogram()
+  {
+    const SizeValueType numberOfBins = (OffsetValueType)NumericTraits< TInputPixel >::max()
+                                       - (OffsetValueType)NumericTraits< TInputPixel >::NonpositiveMin() + 1;
+    const SizeValueType numberOfWords = ( numberOfBins + WordBits - 1 ) / WordBits;
+
+    m_Counts.resize(numberOfWords * WordBits, 0);
+    m_Words.resize(numberOfWords, 0);
+    m_Summary.resize( ( numberOfWords + WordBits - 1 ) / WordBits, 0 );
+    m_Count = 0;
+  }
+
+  OccupancyHistogram & operator=(const OccupancyHistogram & other)
+  {
+    if ( this == &other )
+      {
+      return *this;
+      }
+    // only the words occupied in one of the histograms can differ
+    for ( SizeValueType s = 0; s < m_Summary.size(); ++s )
+      {
+      WordType summary = m_Summary[s] | other.m_Summary[s];
+      while ( summary != 0 )
+        {
+        const SizeValueType w = s * WordBits + HighestBit(summary);
+        summary &= ~( WordType(1) << ( w % WordBits ) );
+
+        const SizeValueType *otherCounts = &( other.m_Counts[w * WordBits] );
+        std::copy( otherCounts, otherCounts + WordBits, &( m_Counts[w * WordBits] ) );
+        m_Words[w] = other.m_Words[w];
+        }
+      m_Summary[s] = other.m_Summary[s];
+      }
+    m_Count = other.m_Count;
+    return *this;
+  }
+
+  inline void AddPixel(const TInputPixel & p)
+  {
+    const SizeValueType bin = PixelToBin(p);
+
+    if ( m_Counts[bin]++ == 0 )
+      {
+      const SizeValueType w = bin / WordBits;
+      m_Words[w] |= WordType(1) << ( bin % WordBits );
+      m_Summary[w / WordBits] |= WordType(1) << ( w % WordBits );
+      }
+    ++m_Count;
+  }
+
+  inline void RemovePixel(const TInputPixel & p)
+  {
+    const SizeValueType bin = PixelToBin(p);
+
+    itkAssertInDebugAndIgnoreInReleaseMacro( m_Counts[bin] > 0 );
+    if ( --m_Counts[bin] == 0 )
+      {
+      const SizeValueType w = bin / WordBits;
+      m_Words[w] &= ~( WordType(1) << ( bin % WordBits ) );
+      if ( m_Words[w] == 0 )
+        {
+        m_Summary[w / WordBits] &= ~( WordType(1) << ( w % WordBits ) );
+        }
+      }
+    --m_Count;
+  }
+
+  inline bool IsEmpty() const
+  {
+    return m_Count == 0;
+  }
+
+  /** Return the largest value in the histogram, which must not be
+   * empty. */
+  inline TInputPixel GetMaximum() const
+  {
+    itkAssertInDebugAndIgnoreInReleaseMacro( !IsEmpty() );
+    SizeValueType s = m_Summary.size() - 1;
+    while ( m_Summary[s] == 0 )
+      {
+      --s;
+      }
+    const SizeValueType w = s * WordBits + HighestBit(m_Summary[s]);
+    return BinToPixel( w * WordBits + HighestBit(m_Words[w]) );
+  }
+
+  /** Return the smallest value in the histogram, which must not be
+   * empty. */
+  inline TInputPixel GetMinimum() const
+  {
+    itkAssertInDebugAndIgnoreInReleaseMacro( !IsEmpty() );
+    SizeValueType s = 0;
+    while ( m_Summary[s] == 0 )
+      {
+      ++s;
+      }
+    const SizeValueType w = s * WordBits + LowestBit(m_Summary[s]);
+    return BinToPixel( w * WordBits + LowestBit(m_Words[w]) );
+  }
+
+private:
+  typedef uint64_t WordType;
+
+  static const SizeValueType WordBits = 64;
+
+  static SizeValueType PixelToBin(const TInputPixel & p)
+  {
+    return (SizeValueType)( (OffsetValueType)p - (OffsetValueType)NumericTraits< TInputPixel >::NonpositiveMin() );
+  }
+
+  static TInputPixel BinToPixel(SizeValueType bin)
+  {
+    return static_cast< TInputPixel >( (OffsetValueType)bin
+                                       + (OffsetValueType)NumericTraits< TInputPixel >::NonpositiveMin() );
+  }
+
+  /** Position of the highest set bit of a non null word. */
+  static SizeValueType HighestBit(WordType word)
+  {
+    SizeValueType bit = 0;
+    for ( SizeValueType shift = WordBits / 2; shift > 0; shift /= 2 )
+      {
+      if ( ( word >> shift ) != 0 )
+        {
+        word >>= shift;
+        bit += shift;
+        }
+      }
+    return bit;
+  }
+
+  /** Position of the lowest set bit of a non null word. */
+  static SizeValueType LowestBit(WordType word)
+  {
+    return HighestBit( word & ( ~word + 1 ) );
+  }
+
+  std::vector< SizeValueType > m_Counts;
+  std::vector< WordType >      m_Words;
+  std::vector< WordType >      m_Summary;
+  SizeValueType                m_Count;
+};
+} // end namespace Function
+} // end namespace itk
+
+#endif
@@ -0,0 +1,255 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMovingHistogramDilateImageFilter.h"
+#include "itkMovingHistogramErodeImageFilter.h"
+#include "itkMovingHistogramMorphologicalGradientImageFilter.h"
+#include "itkGrayscaleDilateImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+#include <set>
+
+/*
+ * The moving histogram filters use a flat histogram with occupancy
+ * bitmaps for the 16 bit pixel types. Check the histogram against a
+ * multiset, then check the dilation, the erosion and the gradient of
+ * 16 bit images against the same filters on int images, which use a
+ * map.
+ */
+
+namespace
+{
+template< class TPixel >
+bool
+TestOccupancyHistogram()
+{
+  typedef itk::Function::OccupancyHistogram< TPixel > HistogramType;
+  typedef std::multiset< TPixel >                     ReferenceType;
+
+  HistogramType histograms[2];
+  ReferenceType references[2];
+
+  const long minimum = itk::NumericTraits< TPixel >::NonpositiveMin();
+  const long range = static_cast< long >( itk::NumericTraits< TPixel >::max() ) - minimum + 1;
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 12345 );
+
+  for ( unsigned int i = 0; i < 20000; i++ )
+    {
+    const unsigned int h = generator->GetIntegerVariate( 1 );
+    // cluster the values so that the words fill and empty, and use
+    // the extreme values of the type
+    long value = minimum + static_cast< long >( generator->GetIntegerVariate( range - 1 ) );
+    if ( i % 3 == 0 )
+      {
+      value = minimum + static_cast< long >( generator->GetIntegerVariate( 199 ) );
+      }
+    else if ( i % 3 == 1 )
+      {
+      value = minimum + range - 1 - static_cast< long >( generator->GetIntegerVariate( 199 ) );
+      }
+    const TPixel p = static_cast< TPixel >( value );
+
+    if ( !references[h].empty() && generator->GetIntegerVariate( 4 ) < 2 )
+      {
+      // remove the smallest or the largest value
+      typename ReferenceType::iterator it = references[h].begin();
+      if ( generator->GetIntegerVariate( 1 ) )
+        {
+        it = references[h].end();
+        --it;
+        }
+      histograms[h].RemovePixel(*it);
+      references[h].erase(it);
+      }
+    else
+      {
+      histograms[h].AddPixel(p);
+      references[h].insert(p);
+      }
+
+    if ( i % 1000 == 999 )
+      {
+      // copy between histograms of different contents
+      histograms[1 - h] = histograms[h];
+      references[1 - h] = references[h];
+      }
+
+    for ( unsigned int k = 0; k < 2; k++ )
+      {
+      if ( histograms[k].IsEmpty() != references[k].empty() )
+        {
+        std::cerr << "Wrong emptiness at step " << i << std::endl;
+        return false;
+        }
+      if ( !references[k].empty()
+           && ( histograms[k].GetMinimum() != *references[k].begin()
+                || histograms[k].GetMaximum() != *references[k].rbegin() ) )
+        {
+        std::cerr << "Wrong extrema at step " << i << ": "
+                  << histograms[k].GetMinimum() << " " << histograms[k].GetMaximum() << " instead of "
+                  << *references[k].begin() << " " << *references[k].rbegin() << std::endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+template< class TImage1, class TImage2 >
+bool
+CompareImages(const char *name, TImage1 *image1, TImage2 *image2)
+{
+  itk::ImageRegionIteratorWithIndex< TImage1 > it1( image1, image1->GetLargestPossibleRegion() );
+  itk::ImageRegionIteratorWithIndex< TImage2 > it2( image2, image2->GetLargestPossibleRegion() );
+  for ( ; !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    if ( static_cast< typename TImage2::PixelType >( it1.Get() ) != it2.Get() )
+      {
+      std::cerr << name << " differs at " << it1.GetIndex() << ": " << it1.Get() << " != " << it2.Get()
+                << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+template< class TFilter, class TReferenceFilter, class TImage, class TReferenceImage, class TKernel >
+bool
+CompareFilters(const char *name, TImage *image, TReferenceImage *referenceImage, const TKernel & kernel)
+{
+  typename TReferenceFilter::Pointer reference = TReferenceFilter::New();
+  reference->SetInput(referenceImage);
+  reference->SetKernel(kernel);
+  reference->Update();
+
+  for ( unsigned int threads = 1; threads <= 3; threads += 2 )
+    {
+    typename TFilter::Pointer filter = TFilter::New();
+    filter->SetInput(image);
+    filter->SetKernel(kernel);
+    filter->SetNumberOfThreads(threads);
+    filter->Update();
+
+    if ( !filter->GetUseVectorBasedAlgorithm() )
+      {
+      std::cerr << name << " does not use the vector based algorithm" << std::endl;
+      return false;
+      }
+    if ( !CompareImages(name, reference->GetOutput(), filter->GetOutput()) )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+template< class TPixel, unsigned int VDimension >
+bool
+TestMovingHistogramFilters(long minimum, long range)
+{
+  typedef itk::Image< TPixel, VDimension >              ImageType;
+  typedef itk::Image< int, VDimension >                 IntImageType;
+  typedef itk::FlatStructuringElement< VDimension >     KernelType;
+
+  typename ImageType::SizeType size;
+  size.Fill(15);
+  size[0] = 33;
+
+  typename ImageType::Pointer    image = ImageType::New();
+  typename IntImageType::Pointer intImage = IntImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  intImage->SetRegions(size);
+  intImage->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType >    it( image, image->GetLargestPossibleRegion() );
+  itk::ImageRegionIteratorWithIndex< IntImageType > intIt( intImage, intImage->GetLargestPossibleRegion() );
+  unsigned long                                     i = 0;
+  for ( ; !it.IsAtEnd(); ++it, ++intIt, ++i )
+    {
+    const long value = minimum + static_cast< long >( ( i * 7919 + ( i * i ) % 104729 ) % range );
+    it.Set( static_cast< TPixel >( value ) );
+    intIt.Set( static_cast< int >( value ) );
+    }
+
+  typename KernelType::RadiusType radius;
+  radius.Fill(2);
+  radius[0] = 3;
+  const KernelType ball = KernelType::Ball(radius);
+  const KernelType box = KernelType::Box(radius);
+
+  typedef itk::MovingHistogramDilateImageFilter< ImageType, ImageType, KernelType >       DilateType;
+  typedef itk::MovingHistogramDilateImageFilter< IntImageType, IntImageType, KernelType > IntDilateType;
+  typedef itk::MovingHistogramErodeImageFilter< ImageType, ImageType, KernelType >        ErodeType;
+  typedef itk::MovingHistogramErodeImageFilter< IntImageType, IntImageType, KernelType >  IntErodeType;
+  typedef itk::MovingHistogramMorphologicalGradientImageFilter< ImageType, ImageType, KernelType >
+  GradientType;
+  typedef itk::MovingHistogramMorphologicalGradientImageFilter< IntImageType, IntImageType, KernelType >
+  IntGradientType;
+
+  bool passed = true;
+  passed &= CompareFilters< DilateType, IntDilateType >("Dilation", image.GetPointer(), intImage.GetPointer(), ball);
+  passed &= CompareFilters< ErodeType, IntErodeType >("Erosion", image.GetPointer(), intImage.GetPointer(), ball);
+  passed &= CompareFilters< GradientType, IntGradientType >("Gradient", image.GetPointer(), intImage.GetPointer(),
+                                                            ball);
+  passed &= CompareFilters< DilateType, IntDilateType >("Box dilation", image.GetPointer(), intImage.GetPointer(),
+                                                        box);
+
+  // the anchor algorithm does not use the flat histograms but must not
+  // be affected by them
+  typedef itk::GrayscaleDilateImageFilter< ImageType, ImageType, KernelType > GrayscaleDilateType;
+  typename GrayscaleDilateType::Pointer anchor = GrayscaleDilateType::New();
+  anchor->SetInput(image);
+  anchor->SetKernel(box);
+  anchor->SetAlgorithm(GrayscaleDilateType::ANCHOR);
+  anchor->Update();
+
+  typename DilateType::Pointer histogram = DilateType::New();
+  histogram->SetInput(image);
+  histogram->SetKernel(box);
+  histogram->Update();
+  passed &= CompareImages("Anchor dilation", histogram->GetOutput(), anchor->GetOutput());
+
+  return passed;
+}
+}
+
+int itkMovingHistogramOccupancyHistogramTest(int, char * [])
+{
+  bool passed = true;
+
+  passed &= TestOccupancyHistogram< unsigned short >();
+  passed &= TestOccupancyHistogram< short >();
+
+  passed &= TestMovingHistogramFilters< unsigned short, 2 >(0, 65536);
+  passed &= TestMovingHistogramFilters< short, 2 >(-2000, 4000);
+  passed &= TestMovingHistogramFilters< unsigned short, 3 >(1000, 3000);
+
+  if ( !passed )
+    {
+    std::cerr << "Test failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,208 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkBlockRankHistogram_h
+#define __itkBlockRankHistogram_h
+
+#include "itkIntTypes.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace itk
+{
+namespace Function
+{
+/** \class BlockRankHistogram
+ * \brief Histogram of bin indices that keeps track of a rank incrementally.
+ *
+ * The histogram counts entries in a fixed number of bins and groups
+ * the bins into blocks of 256 whose totals are kept up to date. The
+ * bin holding the requested rank is remembered between queries
+ * together with the number of entries below it, so that in a sliding
+ * window, where only a few entries change between two queries, the
+ * rank bin is found by moving from its previous position, skipping
+ * whole blocks when the rank is far away. Adding or removing an entry
+ * is O(1) and a query costs at most a few hundred steps even with
+ * 65536 bins, instead of a scan of the whole histogram.
+ *
+ * Assigning a histogram with the same number of bins only copies the
+ * blocks which are occupied in either histogram, so that the copies
+ * made by the moving histogram algorithm at each line cost as much as
+ * the number of occupied blocks and not as much as the number of bins.
+ *
+ * The rank follows the convention of RankHistogram: a rank of 0 is
+ * the minimum, 1 the maximum and 0.5 the median of an odd number of
+ * entries.
+ *
+ * \ingroup ITKSmoothing
+ */
+class BlockRankHistogram
+{
+public:
+  BlockRankHistogram()
+  {
+    m_Rank = 0.5;
+    m_Entries = m_Below = m_RankBin = 0;
+  }
+
+  BlockRankHistogram & operator=(const BlockRankHistogram & other)
+  {
+    if ( this == &other )
+      {
+      return *this;
+      }
+    if ( m_Bins.size() != other.m_Bins.size() )
+      {
+      m_Bins = other.m_Bins;
+      m_Blocks = other.m_Blocks;
+      }
+    else
+      {
+      // only the bins of the blocks occupied in one of the histograms
+      // can differ
+      for ( SizeValueType b = 0; b < m_Blocks.size(); ++b )
+        {
+        if ( m_Blocks[b] != 0 || other.m_Blocks[b] != 0 )
+          {
+          const SizeValueType *otherBins = &( other.m_Bins[b << BlockShift] );
+          std::copy( otherBins, otherBins + BlockSize, &( m_Bins[b << BlockShift] ) );
+          m_Blocks[b] = other.m_Blocks[b];
+          }
+        }
+      }
+    m_Entries = other.m_Entries;
+    m_Below = other.m_Below;
+    m_RankBin = other.m_RankBin;
+    m_Rank = other.m_Rank;
+    return *this;
+  }
+
+  /** Set the number of bins and empty the histogram. */
+  void SetNumberOfBins(SizeValueType numberOfBins)
+  {
+    // round up to a whole number of blocks so that skipping a block
+    // never goes past the end of the bins
+    const SizeValueType numberOfBlocks = ( numberOfBins + BlockSize - 1 ) >> BlockShift;
+
+    m_Bins.assign(numberOfBlocks << BlockShift, 0);
+    m_Blocks.assign(numberOfBlocks, 0);
+    m_Entries = m_Below = m_RankBin = 0;
+  }
+
+  SizeValueType GetNumberOfBins() const
+  {
+    return m_Bins.size();
+  }
+
+  SizeValueType GetBinCount(SizeValueType bin) const
+  {
+    return m_Bins[bin];
+  }
+
+  SizeValueType GetNumberOfEntries() const
+  {
+    return m_Entries;
+  }
+
+  void SetRank(float rank)
+  {
+    m_Rank = rank;
+  }
+
+  void AddBin(SizeValueType bin)
+  {
+    ++m_Bins[bin];
+    ++m_Blocks[bin >> BlockShift];
+    ++m_Entries;
+    if ( bin < m_RankBin )
+      {
+      ++m_Below;
+      }
+  }
+
+  void RemoveBin(SizeValueType bin)
+  {
+    --m_Bins[bin];
+    --m_Blocks[bin >> BlockShift];
+    --m_Entries;
+    if ( bin < m_RankBin )
+      {
+      --m_Below;
+      }
+  }
+
+  /** Return the bin holding the requested rank. The histogram must not
+   * be empty. */
+  SizeValueType GetRankBin()
+  {
+    const SizeValueType target = (SizeValueType)( m_Rank * ( m_Entries - 1 ) ) + 1;
+
+    // move down while the entries below the current bin reach the
+    // target
+    while ( m_Below >= target )
+      {
+      if ( ( m_RankBin & BlockMask ) == 0
+           && m_Below - m_Blocks[( m_RankBin >> BlockShift ) - 1] >= target )
+        {
+        m_RankBin -= BlockSize;
+        m_Below -= m_Blocks[m_RankBin >> BlockShift];
+        }
+      else
+        {
+        --m_RankBin;
+        m_Below -= m_Bins[m_RankBin];
+        }
+      }
+
+    // move up while the current bin does not reach the target
+    while ( m_Below + m_Bins[m_RankBin] < target )
+      {
+      if ( ( m_RankBin & BlockMask ) == 0
+           && m_Below + m_Blocks[m_RankBin >> BlockShift] < target )
+        {
+        m_Below += m_Blocks[m_RankBin >> BlockShift];
+        m_RankBin += BlockSize;
+        }
+      else
+        {
+        m_Below += m_Bins[m_RankBin];
+        ++m_RankBin;
+        }
+      }
+
+    return m_RankBin;
+  }
+
+private:
+  static const SizeValueType BlockShift = 8;
+  static const SizeValueType BlockSize = 1 << BlockShift;
+  static const SizeValueType BlockMask = BlockSize - 1;
+
+  typedef std::vector< SizeValueType > CountVectorType;
+
+  CountVectorType m_Bins;
+  CountVectorType m_Blocks;
+  SizeValueType   m_Entries;
+  SizeValueType   m_Below;
+  SizeValueType   m_RankBin;
+  float           m_Rank;
+};
+} // end namespace Function
+} // end namespace itk
+
+#endif
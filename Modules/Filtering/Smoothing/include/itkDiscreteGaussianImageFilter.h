@@ -43,7 +43,13 @@ namespace itk
  * When the Gaussian kernel is small, this filter tends to run faster than
  * itk::RecursiveGaussianImageFilter.
  *
+ * The operators of all the dimensions are applied at once by a
+ * SeparableNeighborhoodOperatorImageFilter, which keeps the intermediate
+ * results of a tile of the image in cache and in the real type of the
+ * output pixel.
+ *
  * \sa GaussianOperator
+ * \sa SeparableNeighborhoodOperatorImageFilter
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
@@ -207,9 +213,24 @@ public:
    * The default value is $ImageDimension^2$.
    *
    * This parameter was introduced to reduce the memory used by images
-   * internally, at the cost of performance.
+   * internally, at the cost of performance.  The filter now convolves
+   * the image tile by tile, without full-size intermediate images, so
+   * this parameter is deprecated and ignored by the CPU implementation.
+   * Setting it issues a warning.
+   *
+   * \sa SeparableNeighborhoodOperatorImageFilter
    */
-  itkSetMacro(InternalNumberOfStreamDivisions, unsigned int);
+  virtual void SetInternalNumberOfStreamDivisions(const unsigned int divisions)
+  {
+    itkWarningMacro("InternalNumberOfStreamDivisions is deprecated and ignored by the CPU implementation: "
+                    "the image is convolved tile by tile.");
+    if ( this->m_InternalNumberOfStreamDivisions != divisions )
+      {
+      this->m_InternalNumberOfStreamDivisions = divisions;
+      this->Modified();
+      }
+  }
+
   itkGetConstReferenceMacro(InternalNumberOfStreamDivisions, unsigned int);
 
   /** DiscreteGaussianImageFilter needs a larger input requested region
@@ -245,8 +266,8 @@ protected:
 
   /** Standard pipeline method. While this class does not implement a
    * ThreadedGenerateData(), its GenerateData() delegates all
-   * calculations to an NeighborhoodOperatorImageFilter.  Since the
-   * NeighborhoodOperatorImageFilter is multithreaded, this filter is
+   * calculations to a SeparableNeighborhoodOperatorImageFilter.  Since the
+   * SeparableNeighborhoodOperatorImageFilter is multithreaded, this filter is
    * multithreaded by default. */
   void GenerateData();
 
@@ -20,9 +20,45 @@
 
 #include "itkBoxImageFilter.h"
 #include "itkImage.h"
+#include "itkIsSame.h"
+#include "itkProgressReporter.h"
 
 namespace itk
 {
+/** \cond HIDE_META_PROGRAMMING */
+/** Whether the median of pixels of type TPixel can be computed with a
+ * histogram of one bin per value. */
+template< class TPixel >
+struct MedianImageFilterHistogramTraits:public FalseType {};
+template< >
+struct MedianImageFilterHistogramTraits< char >:public TrueType {};
+template< >
+struct MedianImageFilterHistogramTraits< signed char >:public TrueType {};
+template< >
+struct MedianImageFilterHistogramTraits< unsigned char >:public TrueType {};
+template< >
+struct MedianImageFilterHistogramTraits< short >:public TrueType {};
+template< >
+struct MedianImageFilterHistogramTraits< unsigned short >:public TrueType {};
+
+/** Whether the median of pixels of type TPixel can be computed with a
+ * histogram of the ranks of the pixels among their sorted values. */
+template< class TPixel >
+struct MedianImageFilterRankTraits:public FalseType {};
+template< >
+struct MedianImageFilterRankTraits< int >:public TrueType {};
+template< >
+struct MedianImageFilterRankTraits< unsigned int >:public TrueType {};
+template< >
+struct MedianImageFilterRankTraits< long >:public TrueType {};
+template< >
+struct MedianImageFilterRankTraits< unsigned long >:public TrueType {};
+template< >
+struct MedianImageFilterRankTraits< float >:public TrueType {};
+template< >
+struct MedianImageFilterRankTraits< double >:public TrueType {};
+/** \endcond */
+
 /** \class MedianImageFilter
  * \brief Applies a median filter to an image
  *
@@ -35,6 +71,23 @@ namespace itk
  * This filter requires that the input pixel type provides an operator<()
  * (LessThan Comparable).
  *
+ * For small neighborhoods, the pixels of each neighborhood are partially
+ * sorted to find the median. When the neighborhood has at least
+ * MinimumNeighborhoodSizeForHistogram pixels, the filter instead slides
+ * a histogram along the lines of the image: the neighborhood of the next
+ * pixel is obtained by removing one column of pixels and adding another,
+ * and the median is tracked incrementally in a block histogram, so that
+ * the cost per pixel grows with the size of a column rather than with the
+ * size of the neighborhood. For integral pixel types of at most 16 bits,
+ * the histogram has one bin per value of the pixel type, indexed directly
+ * by the input values. For the other integral and floating point pixel
+ * types, each thread sorts the distinct values of blocks of its input
+ * region and the histogram counts the ranks of the pixels among them;
+ * since the ranks cost a sort and the histogram has as many bins as
+ * there are distinct values, this is only done from the larger
+ * MinimumNeighborhoodSizeForRankHistogram. The pixels of other types
+ * are always sorted. Both methods give exactly the same result.
+ *
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
@@ -64,10 +117,10 @@ public:
   typedef TOutputImage OutputImageType;
 
   /** Standard class typedefs. */
-  typedef MedianImageFilter                                     Self;
-  typedef ImageToImageFilter< InputImageType, OutputImageType > Superclass;
-  typedef SmartPointer< Self >                                  Pointer;
-  typedef SmartPointer< const Self >                            ConstPointer;
+  typedef MedianImageFilter                                 Self;
+  typedef BoxImageFilter< InputImageType, OutputImageType > Superclass;
+  typedef SmartPointer< Self >                              Pointer;
+  typedef SmartPointer< const Self >                        ConstPointer;
 
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
@@ -84,6 +137,19 @@ public:
 
   typedef typename InputImageType::SizeType InputSizeType;
 
+  /** Set/Get the number of pixels in the neighborhood from which the
+   * median of scalar pixels is computed with a sliding histogram rather
+   * than by sorting.  Defaults to 25. */
+  itkSetMacro(MinimumNeighborhoodSizeForHistogram, SizeValueType);
+  itkGetConstMacro(MinimumNeighborhoodSizeForHistogram, SizeValueType);
+
+  /** Set/Get the number of pixels in the neighborhood from which the
+   * median of the pixels which do not index the histogram, such as
+   * floating point pixels, is computed with a sliding histogram of their
+   * ranks rather than by sorting.  Defaults to 49. */
+  itkSetMacro(MinimumNeighborhoodSizeForRankHistogram, SizeValueType);
+  itkGetConstMacro(MinimumNeighborhoodSizeForRankHistogram, SizeValueType);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro( SameDimensionCheck,
@@ -98,6 +164,8 @@ protected:
   MedianImageFilter();
   virtual ~MedianImageFilter() {}
 
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
   /** MedianImageFilter can be implemented as a multithreaded filter.
    * Therefore, this implementation provides a ThreadedGenerateData()
    * routine which is called for each processing thread. The output
@@ -111,9 +179,44 @@ protected:
   void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                             ThreadIdType threadId);
 
+  /** Compute the median of the region with a sliding histogram indexed
+   * by the input values, when the pixel type allows it, or else with a
+   * sliding histogram of the ranks of the input values. */
+  void ThreadedGenerateDataWithHistogram(const OutputImageRegionType & outputRegionForThread,
+                                         ThreadIdType threadId, const TrueType &);
+
+  void ThreadedGenerateDataWithHistogram(const OutputImageRegionType & outputRegionForThread,
+                                         ThreadIdType threadId, const FalseType &)
+  {
+    this->ThreadedGenerateDataWithRanks( outputRegionForThread, threadId,
+                                         MedianImageFilterRankTraits< InputPixelType >() );
+  }
+
+  /** Compute the median of the region with a sliding histogram of the
+   * ranks of the input values among the sorted values of blocks of the
+   * region, when the pixel type allows it. */
+  void ThreadedGenerateDataWithRanks(const OutputImageRegionType & outputRegionForThread,
+                                     ThreadIdType threadId, const TrueType &);
+
+  void ThreadedGenerateDataWithRanks(const OutputImageRegionType &,
+                                     ThreadIdType, const FalseType &)
+  {}
+
+  /** Slide a histogram along the lines of the region of an image of
+   * bins, the input image itself or an image of ranks. A pixel p falls
+   * in the bin p - firstBin, and the output value of a bin is read from
+   * binValues, or is the bin plus firstBin when binValues is NULL. */
+  template< class TBinImage >
+  void SlideHistogram(const TBinImage *binImage, OffsetValueType firstBin,
+                      SizeValueType numberOfBins, const InputPixelType *binValues,
+                      const OutputImageRegionType & region, ProgressReporter & progress);
+
 private:
   MedianImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);    //purposely not implemented
+
+  SizeValueType m_MinimumNeighborhoodSizeForHistogram;
+  SizeValueType m_MinimumNeighborhoodSizeForRankHistogram;
 };
 } // end namespace itk
 
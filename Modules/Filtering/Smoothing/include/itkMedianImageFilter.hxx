@@ -22,6 +22,9 @@
 #include "itkConstNeighborhoodIterator.h"
 #include "itkNeighborhoodInnerProduct.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageLinearIteratorWithIndex.h"
+#include "itkBlockRankHistogram.h"
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkOffset.h"
 #include "itkProgressReporter.h"
@@ -34,7 +37,199 @@ namespace itk
 template< class TInputImage, class TOutputImage >
 MedianImageFilter< TInputImage, TOutputImage >
 ::MedianImageFilter()
-{}
+{
+  m_MinimumNeighborhoodSizeForHistogram = 25;
+  m_MinimumNeighborhoodSizeForRankHistogram = 49;
+}
+
+template< class TInputImage, class TOutputImage >
+template< class TBinImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::SlideHistogram(const TBinImage *binImage, OffsetValueType firstBin,
+                 SizeValueType numberOfBins, const InputPixelType *binValues,
+                 const OutputImageRegionType & region, ProgressReporter & progress)
+{
+  typedef typename TBinImage::PixelType BinPixelType;
+
+  typename OutputImageType::Pointer output = this->GetOutput();
+
+  const InputSizeType &                    radius = this->GetRadius();
+  const InputImageRegionType               bufferedRegion = binImage->GetBufferedRegion();
+  const typename InputImageType::IndexType bufferStart = bufferedRegion.GetIndex();
+  const InputSizeType                      bufferSize = bufferedRegion.GetSize();
+  const OffsetValueType *                  offsetTable = binImage->GetOffsetTable();
+  const BinPixelType *                     pixels = binImage->GetBufferPointer();
+
+  // offsets of the neighborhood along the lines, with the zero flux
+  // Neumann boundary condition of the buffered region
+  const SizeValueType            lineLength = region.GetSize(0);
+  const SizeValueType            width = 2 * radius[0] + 1;
+  std::vector< OffsetValueType > lineOffsets(lineLength + width - 1);
+  for ( SizeValueType i = 0; i < lineOffsets.size(); ++i )
+    {
+    const OffsetValueType x = region.GetIndex(0) - (OffsetValueType)radius[0]
+                              + (OffsetValueType)i - bufferStart[0];
+    lineOffsets[i] = std::min( std::max( x, OffsetValueType(0) ), (OffsetValueType)bufferSize[0] - 1 );
+    }
+
+  Function::BlockRankHistogram histogram;
+  histogram.SetNumberOfBins(numberOfBins);
+  histogram.SetRank(0.5);
+
+  std::vector< OffsetValueType > columnOffsets;
+  std::vector< OffsetValueType > nextColumnOffsets;
+
+  ImageLinearIteratorWithIndex< OutputImageType > it(output, region);
+  it.SetDirection(0);
+  for ( it.GoToBegin(); !it.IsAtEnd(); it.NextLine() )
+    {
+    // offsets of the pixels of a column of the neighborhood, which
+    // spans the other dimensions
+    const typename OutputImageType::IndexType lineIndex = it.GetIndex();
+    columnOffsets.assign(1, 0);
+    for ( unsigned int d = 1; d < InputImageDimension; ++d )
+      {
+      nextColumnOffsets.clear();
+      for ( OffsetValueType k = -(OffsetValueType)radius[d]; k <= (OffsetValueType)radius[d]; ++k )
+        {
+        const OffsetValueType y = std::min( std::max( lineIndex[d] + k - bufferStart[d], OffsetValueType(0) ),
+                                            (OffsetValueType)bufferSize[d] - 1 );
+        for ( SizeValueType j = 0; j < columnOffsets.size(); ++j )
+          {
+          nextColumnOffsets.push_back(columnOffsets[j] + y * offsetTable[d]);
+          }
+        }
+      columnOffsets.swap(nextColumnOffsets);
+      }
+    const SizeValueType    columnSize = columnOffsets.size();
+    const OffsetValueType *column = &( columnOffsets[0] );
+
+    for ( SizeValueType i = 0; i < width; ++i )
+      {
+      const BinPixelType *columnPixels = pixels + lineOffsets[i];
+      for ( SizeValueType j = 0; j < columnSize; ++j )
+        {
+        histogram.AddBin(static_cast< OffsetValueType >( columnPixels[column[j]] ) - firstBin);
+        }
+      }
+
+    for ( SizeValueType i = 0; i < lineLength; ++i )
+      {
+      const SizeValueType  bin = histogram.GetRankBin();
+      const InputPixelType value = binValues ? binValues[bin]
+                                   : static_cast< InputPixelType >( static_cast< OffsetValueType >( bin ) + firstBin );
+      it.Set( static_cast< OutputPixelType >( value ) );
+      ++it;
+      progress.CompletedPixel();
+
+      if ( i + 1 < lineLength )
+        {
+        const BinPixelType *removedPixels = pixels + lineOffsets[i];
+        const BinPixelType *addedPixels = pixels + lineOffsets[i + width];
+        for ( SizeValueType j = 0; j < columnSize; ++j )
+          {
+          histogram.RemoveBin(static_cast< OffsetValueType >( removedPixels[column[j]] ) - firstBin);
+          histogram.AddBin(static_cast< OffsetValueType >( addedPixels[column[j]] ) - firstBin);
+          }
+        }
+      }
+
+    // empty the histogram for the next line
+    for ( SizeValueType i = lineLength - 1; i < lineLength - 1 + width; ++i )
+      {
+      const BinPixelType *columnPixels = pixels + lineOffsets[i];
+      for ( SizeValueType j = 0; j < columnSize; ++j )
+        {
+        histogram.RemoveBin(static_cast< OffsetValueType >( columnPixels[column[j]] ) - firstBin);
+        }
+      }
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateDataWithHistogram(const OutputImageRegionType & outputRegionForThread,
+                                    ThreadIdType threadId, const TrueType &)
+{
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  // one bin per value of the pixel type, from its smallest value
+  const OffsetValueType firstBin = static_cast< OffsetValueType >( NumericTraits< InputPixelType >::NonpositiveMin() );
+  const SizeValueType   numberOfBins = static_cast< SizeValueType >(
+    static_cast< OffsetValueType >( NumericTraits< InputPixelType >::max() ) - firstBin + 1 );
+
+  this->SlideHistogram( this->GetInput(), firstBin, numberOfBins, NULL, outputRegionForThread, progress );
+}
+
+template< class TInputImage, class TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateDataWithRanks(const OutputImageRegionType & outputRegionForThread,
+                                ThreadIdType threadId, const TrueType &)
+{
+  typedef Image< unsigned int, InputImageDimension > RankImageType;
+
+  const InputImageType *input = this->GetInput();
+  const InputSizeType & radius = this->GetRadius();
+
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  // The region is processed in blocks along its last dimension, so that
+  // the values sorted at once, their ranks and the bins of the histogram
+  // stay within a few megabytes whatever the size of the image.
+  const SizeValueType maximumBlockSize = 1 << 18;
+  const unsigned int  last = InputImageDimension - 1;
+  SizeValueType       sliceSize = 1;
+  for ( unsigned int d = 0; d < last; ++d )
+    {
+    sliceSize *= outputRegionForThread.GetSize(d) + 2 * radius[d];
+    }
+  const SizeValueType blockLength =
+    std::max( maximumBlockSize / sliceSize, SizeValueType( 4 * radius[last] + 1 ) ) - 2 * radius[last];
+
+  const OffsetValueType regionEnd =
+    outputRegionForThread.GetIndex(last) + (OffsetValueType)outputRegionForThread.GetSize(last);
+  std::vector< InputPixelType > values;
+  for ( OffsetValueType blockStart = outputRegionForThread.GetIndex(last); blockStart < regionEnd;
+        blockStart += (OffsetValueType)blockLength )
+    {
+    OutputImageRegionType block = outputRegionForThread;
+    block.SetIndex( last, blockStart );
+    block.SetSize( last, std::min( blockLength, SizeValueType( regionEnd - blockStart ) ) );
+
+    // the pixels the neighborhoods of the block read, with the zero flux
+    // Neumann boundary condition
+    InputImageRegionType inputBlock = block;
+    inputBlock.PadByRadius(radius);
+    inputBlock.Crop( input->GetBufferedRegion() );
+
+    // sorted distinct values of the block
+    values.clear();
+    values.reserve( inputBlock.GetNumberOfPixels() );
+    ImageRegionConstIterator< InputImageType > inputIt(input, inputBlock);
+    for ( inputIt.GoToBegin(); !inputIt.IsAtEnd(); ++inputIt )
+      {
+      values.push_back( inputIt.Get() );
+      }
+    std::sort( values.begin(), values.end() );
+    values.erase( std::unique( values.begin(), values.end() ), values.end() );
+
+    // ranks of the pixels among the values
+    typename RankImageType::Pointer ranks = RankImageType::New();
+    ranks->SetRegions(inputBlock);
+    ranks->Allocate();
+    ImageRegionIterator< RankImageType > rankIt(ranks, inputBlock);
+    for ( inputIt.GoToBegin(); !inputIt.IsAtEnd(); ++inputIt, ++rankIt )
+      {
+      rankIt.Set( static_cast< unsigned int >(
+                    std::lower_bound( values.begin(), values.end(), inputIt.Get() ) - values.begin() ) );
+      }
+
+    this->SlideHistogram( ranks.GetPointer(), 0, values.size(), &( values[0] ), block, progress );
+    }
+}
 
 template< class TInputImage, class TOutputImage >
 void
@@ -42,6 +237,22 @@ MedianImageFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
 {
+  const InputSizeType & radius = this->GetRadius();
+  SizeValueType         neighborhoodSize = 1;
+  for ( unsigned int d = 0; d < InputImageDimension; ++d )
+    {
+    neighborhoodSize *= 2 * radius[d] + 1;
+    }
+  if ( ( MedianImageFilterHistogramTraits< InputPixelType >::Value
+         && neighborhoodSize >= m_MinimumNeighborhoodSizeForHistogram )
+       || ( MedianImageFilterRankTraits< InputPixelType >::Value
+            && neighborhoodSize >= m_MinimumNeighborhoodSizeForRankHistogram ) )
+    {
+    this->ThreadedGenerateDataWithHistogram( outputRegionForThread, threadId,
+                                             MedianImageFilterHistogramTraits< InputPixelType >() );
+    return;
+    }
+
   // Allocate output
   typename OutputImageType::Pointer output = this->GetOutput();
   typename  InputImageType::ConstPointer input  = this->GetInput();
@@ -94,6 +305,18 @@ MedianImageFilter< TInputImage, TOutputImage >
       }
     }
 }
+
+template< class TInputImage, class TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "MinimumNeighborhoodSizeForHistogram: " << m_MinimumNeighborhoodSizeForHistogram << std::endl;
+  os << indent << "MinimumNeighborhoodSizeForRankHistogram: " << m_MinimumNeighborhoodSizeForRankHistogram
+     << std::endl;
+}
 } // end namespace itk
 
 #endif
@@ -0,0 +1,256 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMedianImageFilter.h"
+#include "itkBlockRankHistogram.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+/*
+ * Check that the sliding histogram method of the median filter gives
+ * the same result as sorting each neighborhood, for 8 and 16 bit integer
+ * pixels indexing the histogram, for 32 bit integer and floating point
+ * pixels whose ranks are counted, in one block or several, for
+ * anisotropic radii, several threads, a requested region smaller than
+ * the image and the boundaries.  Also check that assigning a block rank
+ * histogram copies it.
+ */
+
+namespace
+{
+template< class TImage >
+typename TImage::Pointer
+CreateMedianTestImage(const typename TImage::SizeType & size, unsigned int numberOfValues, double scale)
+{
+  typename TImage::IndexType start;
+  for ( unsigned int d = 0; d < TImage::ImageDimension; d++ )
+    {
+    start[d] = 3 - 2 * static_cast< int >( d );
+    }
+  typename TImage::RegionType region(start, size);
+
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< TImage > it( image, region );
+  unsigned long                               i = 0;
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it, ++i )
+    {
+    const unsigned long value = ( i * 7919 + ( i * i ) % 104729 ) % numberOfValues;
+    it.Set( static_cast< typename TImage::PixelType >( scale * value ) );
+    }
+  return image;
+}
+
+template< class TImage >
+bool
+CompareMedianMethods(TImage *image, const typename TImage::SizeType & radius,
+                     const typename TImage::RegionType & requestedRegion)
+{
+  typedef itk::MedianImageFilter< TImage, TImage > FilterType;
+
+  typename FilterType::Pointer sortFilter = FilterType::New();
+  sortFilter->SetInput(image);
+  sortFilter->SetRadius(radius);
+  sortFilter->SetMinimumNeighborhoodSizeForHistogram( itk::NumericTraits< itk::SizeValueType >::max() );
+  sortFilter->SetMinimumNeighborhoodSizeForRankHistogram( itk::NumericTraits< itk::SizeValueType >::max() );
+  sortFilter->GetOutput()->SetRequestedRegion(requestedRegion);
+  sortFilter->Update();
+
+  for ( unsigned int threads = 1; threads <= 3; threads += 2 )
+    {
+    typename FilterType::Pointer histogramFilter = FilterType::New();
+    histogramFilter->SetInput(image);
+    histogramFilter->SetRadius(radius);
+    histogramFilter->SetMinimumNeighborhoodSizeForHistogram(0);
+    histogramFilter->SetMinimumNeighborhoodSizeForRankHistogram(0);
+    histogramFilter->SetNumberOfThreads(threads);
+    histogramFilter->GetOutput()->SetRequestedRegion(requestedRegion);
+    histogramFilter->Update();
+
+    itk::ImageRegionIteratorWithIndex< TImage > sortIt(sortFilter->GetOutput(), requestedRegion);
+    itk::ImageRegionIteratorWithIndex< TImage > histogramIt(histogramFilter->GetOutput(), requestedRegion);
+    for ( ; !sortIt.IsAtEnd(); ++sortIt, ++histogramIt )
+      {
+      if ( sortIt.Get() != histogramIt.Get() )
+        {
+        std::cerr << "The histogram and sorting methods differ at " << sortIt.GetIndex()
+                  << " with radius " << radius << " and " << threads << " threads: "
+                  << static_cast< typename itk::NumericTraits< typename TImage::PixelType >::PrintType >
+                    ( histogramIt.Get() )
+                  << " != "
+                  << static_cast< typename itk::NumericTraits< typename TImage::PixelType >::PrintType >
+                    ( sortIt.Get() )
+                  << std::endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+bool
+CheckBlockRankHistogramAssignment()
+{
+  typedef itk::Function::BlockRankHistogram HistogramType;
+
+  HistogramType source;
+  source.SetNumberOfBins(65536);
+  HistogramType target;
+  target.SetNumberOfBins(65536);
+  for ( itk::SizeValueType i = 0; i < 50; ++i )
+    {
+    source.AddBin( ( i * 7919 ) % 65536 );
+    target.AddBin( ( i * 104729 + 13 ) % 65536 );
+    }
+  source.GetRankBin();
+  target.GetRankBin();
+
+  target = source;
+
+  // the copy keeps track of the rank like the source
+  for ( itk::SizeValueType i = 0; i < 50; ++i )
+    {
+    const itk::SizeValueType removed = ( i * 7919 ) % 65536;
+    const itk::SizeValueType added = ( i * 31 + 40000 ) % 65536;
+    for ( unsigned int h = 0; h < 2; ++h )
+      {
+      HistogramType & histogram = h == 0 ? source : target;
+      histogram.RemoveBin(removed);
+      histogram.AddBin(added);
+      }
+    if ( source.GetRankBin() != target.GetRankBin() )
+      {
+      std::cerr << "The assigned block rank histogram differs from its source." << std::endl;
+      return false;
+      }
+    }
+  for ( itk::SizeValueType bin = 0; bin < source.GetNumberOfBins(); ++bin )
+    {
+    if ( source.GetBinCount(bin) != target.GetBinCount(bin) )
+      {
+      std::cerr << "Bin " << bin << " of the assigned block rank histogram differs from its source." << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkMedianImageFilterHistogramTest(int, char* [] )
+{
+  bool passed = true;
+
+  // 2D images of 8 bit, 16 bit and floating point pixels
+  typedef itk::Image< unsigned char, 2 >  UCharImageType;
+  typedef itk::Image< short, 2 >          ShortImageType;
+  typedef itk::Image< signed char, 2 >    SCharImageType;
+  typedef itk::Image< float, 2 >          FloatImageType;
+
+  UCharImageType::SizeType size2D;
+  size2D[0] = 37;
+  size2D[1] = 23;
+
+  UCharImageType::SizeType radius2D;
+  radius2D[0] = 3;
+  radius2D[1] = 2;
+
+  UCharImageType::Pointer  ucharImage = CreateMedianTestImage< UCharImageType >(size2D, 256, 1.0);
+  ShortImageType::Pointer  shortImage = CreateMedianTestImage< ShortImageType >(size2D, 3000, -7.0);
+  SCharImageType::Pointer  scharImage = CreateMedianTestImage< SCharImageType >(size2D, 128, -1.0);
+  FloatImageType::Pointer  floatImage = CreateMedianTestImage< FloatImageType >(size2D, 100000, 0.37);
+
+  const UCharImageType::RegionType largest2D = ucharImage->GetLargestPossibleRegion();
+  UCharImageType::RegionType       requested2D = largest2D;
+  requested2D.ShrinkByRadius(5);
+
+  passed &= CompareMedianMethods< UCharImageType >(ucharImage, radius2D, largest2D);
+  passed &= CompareMedianMethods< UCharImageType >(ucharImage, radius2D, requested2D);
+  passed &= CompareMedianMethods< ShortImageType >(shortImage, radius2D, largest2D);
+  passed &= CompareMedianMethods< SCharImageType >(scharImage, radius2D, largest2D);
+  passed &= CompareMedianMethods< FloatImageType >(floatImage, radius2D, largest2D);
+  passed &= CompareMedianMethods< FloatImageType >(floatImage, radius2D, requested2D);
+
+  // 32 bit integer pixels, and floating point pixels over an image large
+  // enough for its ranks to be counted in several blocks
+  typedef itk::Image< int, 2 > IntImageType;
+  IntImageType::Pointer intImage = CreateMedianTestImage< IntImageType >(size2D, 100000, -3.0);
+  passed &= CompareMedianMethods< IntImageType >(intImage, radius2D, largest2D);
+
+  FloatImageType::SizeType blocksSize2D;
+  blocksSize2D[0] = 4000;
+  blocksSize2D[1] = 150;
+  FloatImageType::Pointer blocksImage = CreateMedianTestImage< FloatImageType >(blocksSize2D, 100000, 0.37);
+  passed &= CompareMedianMethods< FloatImageType >(blocksImage, radius2D, blocksImage->GetLargestPossibleRegion());
+
+  // a radius larger than the image and a null radius
+  UCharImageType::SizeType largeRadius;
+  largeRadius[0] = 40;
+  largeRadius[1] = 1;
+  passed &= CompareMedianMethods< UCharImageType >(ucharImage, largeRadius, largest2D);
+
+  UCharImageType::SizeType nullRadius;
+  nullRadius.Fill(0);
+  passed &= CompareMedianMethods< UCharImageType >(ucharImage, nullRadius, largest2D);
+
+  // 3D images
+  typedef itk::Image< unsigned short, 3 > UShortImageType;
+  typedef itk::Image< double, 3 >         DoubleImageType;
+
+  UShortImageType::SizeType size3D;
+  size3D[0] = 19;
+  size3D[1] = 11;
+  size3D[2] = 9;
+
+  UShortImageType::SizeType radius3D;
+  radius3D[0] = 2;
+  radius3D[1] = 1;
+  radius3D[2] = 3;
+
+  UShortImageType::Pointer ushortImage = CreateMedianTestImage< UShortImageType >(size3D, 65536, 1.0);
+  DoubleImageType::Pointer doubleImage = CreateMedianTestImage< DoubleImageType >(size3D, 500, 0.1);
+
+  const UShortImageType::RegionType largest3D = ushortImage->GetLargestPossibleRegion();
+  UShortImageType::RegionType       requested3D = largest3D;
+  requested3D.ShrinkByRadius(2);
+
+  passed &= CompareMedianMethods< UShortImageType >(ushortImage, radius3D, largest3D);
+  passed &= CompareMedianMethods< UShortImageType >(ushortImage, radius3D, requested3D);
+  passed &= CompareMedianMethods< DoubleImageType >(doubleImage, radius3D, largest3D);
+
+  passed &= CheckBlockRankHistogramAssignment();
+
+  // the histogram method is used by default for large neighborhoods
+  typedef itk::MedianImageFilter< UCharImageType, UCharImageType > FilterType;
+  FilterType::Pointer filter = FilterType::New();
+  if ( filter->GetMinimumNeighborhoodSizeForHistogram() != 25
+       || filter->GetMinimumNeighborhoodSizeForRankHistogram() != 49 )
+    {
+    std::cerr << "Unexpected default parameters" << std::endl;
+    passed = false;
+    }
+  filter->Print(std::cout);
+
+  if ( !passed )
+    {
+    std::cerr << "Test failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed" << std::endl;
+  return EXIT_SUCCESS;
+}
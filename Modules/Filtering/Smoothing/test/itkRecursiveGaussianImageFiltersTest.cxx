@@ -21,6 +21,7 @@
 #include "itkRecursiveGaussianImageFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
 #include "itkImageRegionConstIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
 
 #include <algorithm>
 #include <numeric>
@@ -512,6 +513,86 @@ int itkRecursiveGaussianImageFiltersTest(int, char* [] )
     }
   }
 
+  {
+  std::cout << "Test filtering blocks of lines using a 3-D image" << std::endl;
+
+  typedef itk::Image< float, 3 > ImageType;
+
+  ImageType::SizeType size;
+  size[0] = 21;
+  size[1] = 13;
+  size[2] = 7;
+
+  ImageType::Pointer inputImage = ImageType::New();
+  inputImage->SetRegions( size );
+  inputImage->Allocate();
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 17 );
+
+  itk::ImageRegionIteratorWithIndex< ImageType > init( inputImage, inputImage->GetBufferedRegion() );
+  for ( init.GoToBegin(); !init.IsAtEnd(); ++init )
+    {
+    init.Set( static_cast< float >( generator->GetIntegerVariate( 99 ) ) );
+    }
+
+  typedef itk::RecursiveGaussianImageFilter< ImageType, ImageType > FilterType;
+
+  // The lines of the blocks must be filtered exactly as one at a time,
+  // including the last incomplete block of each thread.
+  const unsigned int linesPerBlock[4] = { 1, 4, 16, 64 };
+  for ( unsigned int direction = 0; direction < 3; ++direction )
+    {
+    ImageType::Pointer reference;
+    for ( unsigned int b = 0; b < 4; ++b )
+      {
+      FilterType::Pointer filter = FilterType::New();
+      filter->SetInput( inputImage );
+      filter->SetDirection( direction );
+      filter->SetSigma( 2.0 );
+      filter->SetOrder( FilterType::SecondOrder );
+      filter->SetNumberOfThreads( 3 );
+      filter->SetNumberOfLinesPerBlock( linesPerBlock[b] );
+      if ( filter->GetNumberOfLinesPerBlock() != linesPerBlock[b] )
+        {
+        std::cerr << "SetNumberOfLinesPerBlock/GetNumberOfLinesPerBlock failure!" << std::endl;
+        return EXIT_FAILURE;
+        }
+      // The block size is capped.
+      filter->SetNumberOfLinesPerBlock( 1000 );
+      if ( filter->GetNumberOfLinesPerBlock() != 64 )
+        {
+        std::cerr << "SetNumberOfLinesPerBlock accepted " << filter->GetNumberOfLinesPerBlock()
+                  << " lines per block" << std::endl;
+        return EXIT_FAILURE;
+        }
+      filter->SetNumberOfLinesPerBlock( linesPerBlock[b] );
+      filter->Update();
+
+      ImageType::Pointer output = filter->GetOutput();
+      if ( b == 0 )
+        {
+        reference = output;
+        continue;
+        }
+
+      itk::ImageRegionConstIterator< ImageType > it( output, output->GetBufferedRegion() );
+      itk::ImageRegionConstIterator< ImageType > rt( reference, reference->GetBufferedRegion() );
+      for ( ; !it.IsAtEnd(); ++it, ++rt )
+        {
+        if ( it.Get() != rt.Get() )
+          {
+          std::cerr << "Filtering " << linesPerBlock[b] << " lines at a time along direction "
+                    << direction << " differs from filtering one line at a time: "
+                    << it.Get() << " != " << rt.Get() << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+  }
+
   // All objects should be automatically destroyed at this point
   return EXIT_SUCCESS;
 
@@ -79,6 +79,15 @@ class MetaDataDictionary;
  *                             in the MetaDataDictionary
  * re-arrangement.
  *
+ * VoxelData is stored as a chunked dataset.  The chunk shape is set in
+ * ITK axis order with SetChunkSize(), where a missing or zero entry
+ * selects the whole extent of that axis; by default each chunk holds one
+ * slice of the slowest axis.  Chunks are compressed with deflate at
+ * CompressionLevel (0 stores them uncompressed).  Streamed writes and
+ * pasted regions only update the chunks they overlap: the split regions
+ * used for writing, and the regions suggested for streamed reading, are
+ * expanded to chunk boundaries so that each chunk is compressed or
+ * decompressed once per piece.
  *
  */
 
@@ -87,9 +96,12 @@ class ITK_EXPORT HDF5ImageIO:public StreamingImageIOBase
 public:
   /** Standard class typedefs. */
   typedef HDF5ImageIO          Self;
-  typedef ImageIOBase          Superclass;
+  typedef StreamingImageIOBase Superclass;
   typedef SmartPointer< Self > Pointer;
 
+  /** Chunk extents, fastest moving axis first. */
+  typedef std::vector< SizeValueType > ChunkSizeType;
+
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
 
@@ -129,6 +141,29 @@ public:
    * that the IORegions has been set properly. */
   virtual void Write(const void *buffer);
 
+  /** Set/Get the chunk extents of the VoxelData dataset, fastest moving
+   * axis first.  Entries that are missing or zero select the whole
+   * extent of that axis, and an empty ChunkSize (the default) chunks
+   * the data by slices of the slowest moving axis.  The ChunkSize only
+   * affects writing; reading a file does not change it. */
+  void SetChunkSize(const ChunkSizeType & chunkSize);
+  itkGetConstReferenceMacro(ChunkSize, ChunkSizeType);
+
+  /** Get the chunk extents of the VoxelData dataset of the file last
+   * read by ReadImageInformation, fastest moving axis first.  Empty when
+   * the dataset is not chunked. */
+  itkGetConstReferenceMacro(FileChunkSize, ChunkSizeType);
+
+  /** Set/Get the deflate level used to compress each chunk, from 0 (no
+   * compression) to 9.  The default is 5. */
+  itkSetClampMacro(CompressionLevel, int, 0, 9);
+  itkGetConstMacro(CompressionLevel, int);
+
+  /** Expand the requested region to the chunk boundaries of the file,
+   * when streamed reading is enabled. */
+  virtual ImageIORegion
+  GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requested) const;
+
 protected:
   HDF5ImageIO();
   ~HDF5ImageIO();
@@ -137,6 +172,15 @@ protected:
 
   void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Split the paste region into pieces that are whole multiples of the
+   * chunk extent along the split axis. */
+  virtual unsigned int GetActualNumberOfSplitsForWritingCanStreamWrite(unsigned int numberOfRequestedSplits,
+                                                                       const ImageIORegion & pasteRegion) const;
+
+  virtual ImageIORegion GetSplitRegionForWritingCanStreamWrite(unsigned int ithPiece,
+                                                               unsigned int numberOfActualSplits,
+                                                               const ImageIORegion & pasteRegion) const;
+
 private:
   HDF5ImageIO(const Self &);   //purposely not implemented
   void operator=(const Self &); //purposely not implemented
@@ -186,9 +230,25 @@ private:
                        unsigned long numElements);
   void SetupStreaming(H5::DataSpace *imageSpace,
                       H5::DataSpace *slabSpace);
-  H5::H5File  *m_H5File;
-  H5::DataSet *m_VoxelDataSet;
-  bool         m_ImageInformationWritten;
+
+  /** The chunk extents used for writing, one per image axis. */
+  ChunkSizeType GetChunkSizeForWriting() const;
+
+  /** Number of values per split piece along splitAxis, rounded up to a
+   * multiple of the chunk extent. */
+  SizeValueType GetChunkAlignedPieceSize(int splitAxis,
+                                         SizeValueType range,
+                                         unsigned int numberOfSplits) const;
+
+  /** Open an existing file and its VoxelData dataset for pasting. */
+  void OpenFileForPasting();
+
+  H5::H5File   *m_H5File;
+  H5::DataSet  *m_VoxelDataSet;
+  bool          m_ImageInformationWritten;
+  ChunkSizeType m_ChunkSize;
+  ChunkSizeType m_FileChunkSize;
+  int           m_CompressionLevel;
 };
 } // end namespace itk
 
@@ -21,13 +21,15 @@
 #include "itkArray.h"
 #include "itksys/SystemTools.hxx"
 #include "itk_H5Cpp.h"
+#include <algorithm>
 
 namespace itk
 {
 
 HDF5ImageIO::HDF5ImageIO() : m_H5File(0),
                              m_VoxelDataSet(0),
-                             m_ImageInformationWritten(false)
+                             m_ImageInformationWritten(false),
+                             m_CompressionLevel(5)
 {
 }
 
@@ -52,6 +54,30 @@ HDF5ImageIO
   Superclass::PrintSelf(os, indent);
   // just prints out the pointer value.
   os << indent << "H5File: " << this->m_H5File << std::endl;
+  os << indent << "ChunkSize: [";
+  for(unsigned int i = 0; i < this->m_ChunkSize.size(); i++)
+    {
+    os << (i > 0 ? ", " : "") << this->m_ChunkSize[i];
+    }
+  os << "]" << std::endl;
+  os << indent << "FileChunkSize: [";
+  for(unsigned int i = 0; i < this->m_FileChunkSize.size(); i++)
+    {
+    os << (i > 0 ? ", " : "") << this->m_FileChunkSize[i];
+    }
+  os << "]" << std::endl;
+  os << indent << "CompressionLevel: " << this->m_CompressionLevel << std::endl;
+}
+
+void
+HDF5ImageIO
+::SetChunkSize(const ChunkSizeType & chunkSize)
+{
+  if(this->m_ChunkSize != chunkSize)
+    {
+    this->m_ChunkSize = chunkSize;
+    this->Modified();
+    }
 }
 
 //
@@ -740,6 +766,19 @@ HDF5ImageIO
       {
       this->SetNumberOfComponents(Dims[nDims - 1]);
       }
+    //
+    // record the chunk layout, in ITK axis order, so that streamed
+    // reads can be aligned with it.
+    this->m_FileChunkSize.clear();
+    H5::DSetCreatPropList imagePlist = imageSet.getCreatePlist();
+    if(imagePlist.getLayout() == H5D_CHUNKED)
+      {
+      imagePlist.getChunk(static_cast<int>(nDims),Dims);
+      for(int i = numDims - 1; i >= 0; i--)
+        {
+        this->m_FileChunkSize.push_back(Dims[i]);
+        }
+      }
     delete [] Dims;
 
     //
@@ -927,10 +966,20 @@ HDF5ImageIO
     {
     limit = HDFDim;
     }
+  // a region of lower dimension than the file selects the first
+  // index of the remaining dimensions
   for(int i=0; i < limit; i++)
     {
-    offset[limit - i - 1] = start[i];
-    HDFSize[limit - i - 1] = size[i];
+    if(static_cast<unsigned int>(i) < regionToRead.GetImageDimension())
+      {
+      offset[limit - i - 1] = start[i];
+      HDFSize[limit - i - 1] = size[i];
+      }
+    else
+      {
+      offset[limit - i - 1] = 0;
+      HDFSize[limit - i - 1] = 1;
+      }
     }
   slabSpace->setExtentSimple(HDFDim,HDFSize);
   imageSpace->selectHyperslab(H5S_SELECT_SET,HDFSize,offset);
@@ -1016,6 +1065,18 @@ HDF5ImageIO
     {
     return;
     }
+  //
+  // a region written into an existing file is pasted into its
+  // VoxelData; GetActualNumberOfSplitsForWriting has already checked
+  // that the file is compatible, or removed it when streaming a
+  // whole image.
+  if(this->RequestedToStream() &&
+     itksys::SystemTools::FileExists(this->GetFileName()))
+    {
+    this->OpenFileForPasting();
+    this->m_ImageInformationWritten = true;
+    return;
+    }
 
   try
     {
@@ -1244,12 +1305,23 @@ HDF5ImageIO
     VoxelDataName += "/0";
     VoxelDataName += VoxelData;
     // set up properties for chunked, compressed writes.
-    // in this case, set the chunk size to be the N-1 dimension
-    // region
+    ChunkSizeType chunkSize = this->GetChunkSizeForWriting();
+    hsize_t *chunkDims = new hsize_t[numDims];
+    for(int i(0), j(static_cast<int>(chunkSize.size())-1); j >= 0; i++, j--)
+      {
+      chunkDims[i] = chunkSize[j];
+      }
+    if(numComponents > 1)
+      {
+      chunkDims[numDims - 1] = numComponents;
+      }
     H5::DSetCreatPropList plist;
-    plist.setDeflate(5);
-    dims[0] = 1;
-    plist.setChunk(numDims,dims);
+    if(this->m_CompressionLevel > 0)
+      {
+      plist.setDeflate(this->m_CompressionLevel);
+      }
+    plist.setChunk(numDims,chunkDims);
+    delete [] chunkDims;
 
     //
     // Create DataSet Once, potentially write to it many times
@@ -1287,6 +1359,183 @@ HDF5ImageIO
     }
 }
 
+void
+HDF5ImageIO
+::OpenFileForPasting()
+{
+  try
+    {
+    this->m_H5File = new H5::H5File(this->GetFileName(),
+                                    H5F_ACC_RDWR);
+    std::string VoxelDataName(ImageGroup);
+    VoxelDataName += "/0";
+    VoxelDataName += VoxelData;
+    this->m_VoxelDataSet = new H5::DataSet();
+    *(this->m_VoxelDataSet) = this->m_H5File->openDataSet(VoxelDataName);
+    }
+  // catch failure caused by the H5File operations
+  catch( H5::FileIException error )
+    {
+    itkExceptionMacro(<< error.getCDetailMsg());
+    }
+  // catch failure caused by the DataSet operations
+  catch( H5::DataSetIException error )
+    {
+    itkExceptionMacro(<< error.getCDetailMsg());
+    }
+}
+
+HDF5ImageIO::ChunkSizeType
+HDF5ImageIO
+::GetChunkSizeForWriting() const
+{
+  const unsigned int numDims = this->GetNumberOfDimensions();
+  ChunkSizeType      chunkSize(numDims);
+
+  for(unsigned int i = 0; i < numDims; i++)
+    {
+    const SizeValueType dim = this->m_Dimensions[i];
+    SizeValueType       chunk = dim;
+    if(this->m_ChunkSize.empty())
+      {
+      // one slice of the slowest moving axis
+      if(numDims > 1 && i == numDims - 1)
+        {
+        chunk = 1;
+        }
+      }
+    else if(i < this->m_ChunkSize.size() && this->m_ChunkSize[i] > 0)
+      {
+      chunk = std::min(this->m_ChunkSize[i],dim);
+      }
+    chunkSize[i] = std::max(chunk,static_cast<SizeValueType>(1));
+    }
+  //
+  // HDF5 limits a chunk to 4GB; halve the slowest moving axes until
+  // the chunk fits.
+  const double maxChunkBytes = 4294967295.0;
+  for(;;)
+    {
+    double chunkBytes = static_cast<double>(this->GetComponentSize()) *
+      this->GetNumberOfComponents();
+    for(unsigned int i = 0; i < numDims; i++)
+      {
+      chunkBytes *= chunkSize[i];
+      }
+    int axis = numDims - 1;
+    while(axis >= 0 && chunkSize[axis] == 1)
+      {
+      --axis;
+      }
+    if(chunkBytes <= maxChunkBytes || axis < 0)
+      {
+      break;
+      }
+    chunkSize[axis] = ( chunkSize[axis] + 1 ) / 2;
+    }
+  return chunkSize;
+}
+
+ImageIOBase::SizeValueType
+HDF5ImageIO
+::GetChunkAlignedPieceSize(int splitAxis,
+                           SizeValueType range,
+                           unsigned int numberOfSplits) const
+{
+  SizeValueType valuesPerPiece = ( range + numberOfSplits - 1 ) / numberOfSplits;
+
+  if(static_cast<unsigned int>(splitAxis) < this->GetNumberOfDimensions())
+    {
+    const SizeValueType chunk = this->GetChunkSizeForWriting()[splitAxis];
+    valuesPerPiece = ( ( valuesPerPiece + chunk - 1 ) / chunk ) * chunk;
+    }
+  return valuesPerPiece;
+}
+
+unsigned int
+HDF5ImageIO
+::GetActualNumberOfSplitsForWritingCanStreamWrite(unsigned int numberOfRequestedSplits,
+                                                  const ImageIORegion & pasteRegion) const
+{
+  // split on the outermost dimension available
+  int splitAxis = pasteRegion.GetImageDimension() - 1;
+  while(splitAxis >= 0 && pasteRegion.GetSize(splitAxis) == 1)
+    {
+    --splitAxis;
+    }
+  if(splitAxis < 0 || numberOfRequestedSplits < 2)
+    {
+    return 1;
+    }
+
+  const SizeValueType range = pasteRegion.GetSize(splitAxis);
+  const SizeValueType valuesPerPiece =
+    this->GetChunkAlignedPieceSize(splitAxis,range,numberOfRequestedSplits);
+  return static_cast<unsigned int>( ( range + valuesPerPiece - 1 ) / valuesPerPiece );
+}
+
+ImageIORegion
+HDF5ImageIO
+::GetSplitRegionForWritingCanStreamWrite(unsigned int ithPiece,
+                                         unsigned int numberOfActualSplits,
+                                         const ImageIORegion & pasteRegion) const
+{
+  ImageIORegion splitRegion = pasteRegion;
+
+  int splitAxis = pasteRegion.GetImageDimension() - 1;
+  while(splitAxis >= 0 && pasteRegion.GetSize(splitAxis) == 1)
+    {
+    --splitAxis;
+    }
+  if(splitAxis < 0 || numberOfActualSplits < 2)
+    {
+    return splitRegion;
+    }
+
+  const SizeValueType range = pasteRegion.GetSize(splitAxis);
+  const SizeValueType valuesPerPiece =
+    this->GetChunkAlignedPieceSize(splitAxis,range,numberOfActualSplits);
+  const SizeValueType offset = std::min(ithPiece * valuesPerPiece,range);
+  splitRegion.SetIndex(splitAxis,pasteRegion.GetIndex(splitAxis) + offset);
+  splitRegion.SetSize(splitAxis,std::min(valuesPerPiece,range - offset));
+  return splitRegion;
+}
+
+ImageIORegion
+HDF5ImageIO
+::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requested) const
+{
+  ImageIORegion streamableRegion =
+    Superclass::GenerateStreamableReadRegionFromRequestedRegion(requested);
+
+  if(!this->m_UseStreamedReading)
+    {
+    return streamableRegion;
+    }
+  //
+  // grow the region to whole chunks, so that no chunk is
+  // decompressed by more than one piece.
+  const unsigned int numDims =
+    std::min<unsigned int>(streamableRegion.GetImageDimension(),
+                           this->m_FileChunkSize.size());
+  for(unsigned int i = 0; i < numDims; i++)
+    {
+    const SizeValueType chunk = this->m_FileChunkSize[i];
+    if(chunk < 2)
+      {
+      continue;
+      }
+    const SizeValueType start = streamableRegion.GetIndex(i);
+    SizeValueType       end = start + streamableRegion.GetSize(i);
+    const SizeValueType alignedStart = ( start / chunk ) * chunk;
+    end = std::min(( ( end + chunk - 1 ) / chunk ) * chunk,
+                   this->m_Dimensions[i]);
+    streamableRegion.SetIndex(i,alignedStart);
+    streamableRegion.SetSize(i,end - alignedStart);
+    }
+  return streamableRegion;
+}
+
 //
 // GetHeaderSize -- return 0
 ImageIOBase::SizeType
@@ -0,0 +1,288 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkHDF5ImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkIOTestHelper.h"
+#include "itkPipelineMonitorImageFilter.h"
+
+namespace
+{
+const unsigned int Dimension = 3;
+typedef short                                PixelType;
+typedef itk::Image< PixelType, Dimension >   ImageType;
+typedef itk::ImageFileWriter< ImageType >    WriterType;
+typedef itk::ImageFileReader< ImageType >    ReaderType;
+
+ImageType::Pointer MakeImage(PixelType sign)
+{
+  ImageType::SizeType size;
+  size[0] = 16;
+  size[1] = 12;
+  size[2] = 10;
+  ImageType::RegionType region(size);
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  PixelType value = 0;
+  itk::ImageRegionIterator< ImageType > it(image, region);
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it, ++value )
+    {
+    it.Set(sign * value);
+    }
+  return image;
+}
+
+ImageType::Pointer ReadImage(const char *fileName, itk::HDF5ImageIO *io)
+{
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(io);
+  reader->Update();
+  return reader->GetOutput();
+}
+
+void WriteImage(const ImageType *image, const char *fileName)
+{
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  writer->SetImageIO( itk::HDF5ImageIO::New() );
+  writer->Update();
+}
+
+bool CheckRegion(const itk::ImageIORegion & region,
+                 const itk::IndexValueType *index,
+                 const itk::SizeValueType *size)
+{
+  for ( unsigned int i = 0; i < Dimension; i++ )
+    {
+    if ( region.GetIndex(i) != index[i] || region.GetSize(i) != size[i] )
+      {
+      std::cout << "Unexpected region " << region << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkHDF5ImageIOChunkedStreamingWriteTest(int ac, char * av [])
+{
+  if ( ac > 1 )
+    {
+    itksys::SystemTools::ChangeDirectory(av[1]);
+    }
+  const char *fileName = "ChunkedStreamingWrite.hdf5";
+  int         result = EXIT_SUCCESS;
+
+  itk::HDF5ImageIO::ChunkSizeType chunkSize(Dimension);
+  chunkSize[0] = 8;
+  chunkSize[1] = 6;
+  chunkSize[2] = 4;
+
+  ImageType::Pointer image = MakeImage(1);
+
+  //
+  // split pieces are whole multiples of the chunk extent
+  itk::HDF5ImageIO::Pointer splitIO = itk::HDF5ImageIO::New();
+  splitIO->SetNumberOfDimensions(Dimension);
+  splitIO->SetComponentType(itk::ImageIOBase::SHORT);
+  splitIO->SetNumberOfComponents(1);
+  itk::ImageIORegion largest(Dimension);
+  for ( unsigned int i = 0; i < Dimension; i++ )
+    {
+    splitIO->SetDimensions( i, image->GetLargestPossibleRegion().GetSize(i) );
+    largest.SetSize( i, image->GetLargestPossibleRegion().GetSize(i) );
+    }
+  splitIO->SetChunkSize(chunkSize);
+  const unsigned int numberOfSplits = splitIO->GetActualNumberOfSplitsForWriting(4, largest, largest);
+  if ( numberOfSplits != 3 )
+    {
+    std::cout << "Expected 3 chunk aligned splits, got " << numberOfSplits << std::endl;
+    result = EXIT_FAILURE;
+    }
+  for ( unsigned int piece = 0; piece < numberOfSplits; piece++ )
+    {
+    itk::ImageIORegion split = splitIO->GetSplitRegionForWriting(piece, numberOfSplits, largest, largest);
+    const itk::IndexValueType index[Dimension] = { 0, 0, 4 * piece };
+    const itk::SizeValueType  size[Dimension] = { 16, 12, piece < 2 ? 4u : 2u };
+    if ( !CheckRegion(split, index, size) )
+      {
+      result = EXIT_FAILURE;
+      }
+    }
+
+  //
+  // stream the image from a file into a chunked, compressed file
+  const char *sourceFileName = "ChunkedStreamingSource.hdf5";
+  const char *pasteFileName = "ChunkedStreamingPaste.hdf5";
+  ImageType::Pointer pasteImage = MakeImage(-1);
+
+  itk::HDF5ImageIO::Pointer writeIO = itk::HDF5ImageIO::New();
+  writeIO->SetChunkSize(chunkSize);
+  writeIO->SetCompressionLevel(1);
+  writeIO->Print(std::cout);
+
+  ReaderType::Pointer sourceReader = ReaderType::New();
+  sourceReader->SetFileName(sourceFileName);
+  sourceReader->SetUseStreaming(true);
+  itk::HDF5ImageIO::Pointer sourceIO = itk::HDF5ImageIO::New();
+  sourceIO->SetUseStreamedReading(true);
+  sourceReader->SetImageIO(sourceIO);
+
+  typedef itk::PipelineMonitorImageFilter< ImageType > MonitorType;
+  MonitorType::Pointer monitor = MonitorType::New();
+  monitor->SetInput( sourceReader->GetOutput() );
+
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(fileName);
+  writer->SetInput( monitor->GetOutput() );
+  writer->SetImageIO(writeIO);
+  writer->SetNumberOfStreamDivisions(4);
+
+  //
+  // paste a region of negated values into the existing file
+  itk::ImageIORegion pasteRegion(Dimension);
+  pasteRegion.SetIndex(0, 2);
+  pasteRegion.SetIndex(1, 3);
+  pasteRegion.SetIndex(2, 1);
+  pasteRegion.SetSize(0, 5);
+  pasteRegion.SetSize(1, 4);
+  pasteRegion.SetSize(2, 6);
+
+  ReaderType::Pointer pasteReader = ReaderType::New();
+  pasteReader->SetFileName(pasteFileName);
+  pasteReader->SetUseStreaming(true);
+  itk::HDF5ImageIO::Pointer pasteSourceIO = itk::HDF5ImageIO::New();
+  pasteSourceIO->SetUseStreamedReading(true);
+  pasteReader->SetImageIO(pasteSourceIO);
+
+  WriterType::Pointer pasteWriter = WriterType::New();
+  pasteWriter->SetFileName(fileName);
+  pasteWriter->SetInput( pasteReader->GetOutput() );
+  pasteWriter->SetImageIO( itk::HDF5ImageIO::New() );
+  pasteWriter->SetIORegion(pasteRegion);
+  pasteWriter->SetNumberOfStreamDivisions(2);
+
+  ImageType::Pointer         readImage;
+  itk::HDF5ImageIO::Pointer  readIO = itk::HDF5ImageIO::New();
+  try
+    {
+    WriteImage(image, sourceFileName);
+    WriteImage(pasteImage, pasteFileName);
+
+    writer->Update();
+    if ( !monitor->VerifyAllInputCanStream(numberOfSplits) )
+      {
+      std::cout << "The image was not written in " << numberOfSplits << " pieces" << std::endl;
+      result = EXIT_FAILURE;
+      }
+    // close the files before they are read
+    writer = WriterType::Pointer();
+    writeIO = itk::HDF5ImageIO::Pointer();
+
+    pasteWriter->Update();
+    pasteWriter = WriterType::Pointer();
+
+    readImage = ReadImage(fileName, readIO);
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cout << "Exception Object caught: " << std::endl
+              << err << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  //
+  // the chunk layout is read back from the file, without changing the
+  // chunk size used for writing
+  if ( readIO->GetFileChunkSize() != chunkSize )
+    {
+    std::cout << "Chunk size not read back from the file" << std::endl;
+    readIO->Print(std::cout);
+    result = EXIT_FAILURE;
+    }
+  if ( !readIO->GetChunkSize().empty() )
+    {
+    std::cout << "Reading changed the chunk size used for writing" << std::endl;
+    readIO->Print(std::cout);
+    result = EXIT_FAILURE;
+    }
+
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it( readImage, readImage->GetLargestPossibleRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    bool                       pasted = true;
+    for ( unsigned int i = 0; i < Dimension; i++ )
+      {
+      pasted = pasted && index[i] >= pasteRegion.GetIndex(i)
+        && index[i] < static_cast< itk::IndexValueType >( pasteRegion.GetIndex(i) + pasteRegion.GetSize(i) );
+      }
+    const PixelType expected = pasted ? pasteImage->GetPixel(index) : image->GetPixel(index);
+    if ( it.Get() != expected )
+      {
+      std::cout << "Pixel " << index << " is " << it.Get()
+                << " instead of " << expected << std::endl;
+      result = EXIT_FAILURE;
+      break;
+      }
+    }
+
+  //
+  // streamed reads are expanded to whole chunks, clipped to the image
+  readIO->SetUseStreamedReading(true);
+  itk::ImageIORegion requested(Dimension);
+  requested.SetIndex(0, 3);
+  requested.SetIndex(1, 7);
+  requested.SetIndex(2, 5);
+  requested.SetSize(0, 2);
+  requested.SetSize(1, 2);
+  requested.SetSize(2, 2);
+  const itk::IndexValueType innerIndex[Dimension] = { 0, 6, 4 };
+  const itk::SizeValueType  innerSize[Dimension] = { 8, 6, 4 };
+  if ( !CheckRegion(readIO->GenerateStreamableReadRegionFromRequestedRegion(requested),
+                    innerIndex, innerSize) )
+    {
+    result = EXIT_FAILURE;
+    }
+  requested.SetIndex(0, 10);
+  requested.SetIndex(1, 10);
+  requested.SetIndex(2, 9);
+  requested.SetSize(0, 1);
+  requested.SetSize(1, 1);
+  requested.SetSize(2, 1);
+  const itk::IndexValueType edgeIndex[Dimension] = { 8, 6, 8 };
+  const itk::SizeValueType  edgeSize[Dimension] = { 8, 6, 2 };
+  if ( !CheckRegion(readIO->GenerateStreamableReadRegionFromRequestedRegion(requested),
+                    edgeIndex, edgeSize) )
+    {
+    result = EXIT_FAILURE;
+    }
+
+  readIO = itk::HDF5ImageIO::Pointer();
+  sourceReader = ReaderType::Pointer();
+  pasteReader = ReaderType::Pointer();
+  itk::IOTestHelper::Remove(fileName);
+  itk::IOTestHelper::Remove(sourceFileName);
+  itk::IOTestHelper::Remove(pasteFileName);
+  return result;
+}
@@ -0,0 +1,138 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkBlockGzipCodec_h
+#define __itkBlockGzipCodec_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+#include "itkMultiThreader.h"
+#include "itkImageIORegion.h"
+#include <vector>
+#include <iostream>
+
+namespace itk
+{
+/** \class BlockGzipCodec
+ * \brief Compress and decompress a buffer as a gzip member made of
+ * independently deflated blocks.
+ *
+ * The buffer is cut in blocks of BlockSize bytes which are deflated on
+ * several threads, each without reference to the data of the other
+ * blocks.  Every block but the last one ends with a sync flush, so the
+ * concatenated blocks form a single deflate stream, and the result is a
+ * regular gzip member that any gzip capable reader decodes.  The
+ * compressed size of each block is stored in an extra field of the gzip
+ * header (subfield "IT"), which lets Read() inflate the blocks on several
+ * threads and decode only the blocks that overlap a requested range.
+ *
+ * The index has to fit in the 64 KB extra field: the block size is
+ * increased when a buffer would need more than 16379 blocks.
+ *
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+class ITK_EXPORT BlockGzipCodec:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef BlockGzipCodec             Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(BlockGzipCodec, Object);
+
+  /** Set/Get the size of the uncompressed blocks used by Compress().
+   * Defaults to 1 MB. */
+  itkSetClampMacro(BlockSize, SizeValueType, 4096, 1024 * 1024 * 1024);
+  itkGetConstMacro(BlockSize, SizeValueType);
+
+  /** Set/Get the zlib compression level used by Compress(), 6 by
+   * default. */
+  itkSetClampMacro(CompressionLevel, int, 1, 9);
+  itkGetConstMacro(CompressionLevel, int);
+
+  /** Set/Get the number of threads that deflate and inflate the blocks.
+   * Initialized to MultiThreader::GetGlobalDefaultNumberOfThreads(). */
+  itkSetClampMacro(NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfThreads, ThreadIdType);
+
+  /** Compress size bytes of data into a gzip member, which replaces the
+   * content of compressed. */
+  void Compress(const void *data, SizeValueType size,
+                std::vector< char > & compressed) const;
+
+  /** Read the header of the gzip member that starts at the current
+   * position of is.  Returns false, with the stream repositioned, when
+   * the member does not hold a block index, for instance when it was
+   * written by a regular gzip or zlib encoder. */
+  bool ReadIndex(std::istream & is);
+
+  /** Size of the data decoded by the member whose index was read last. */
+  itkGetConstMacro(UncompressedSize, SizeValueType);
+
+  /** Decompress size bytes starting at offset in the data of the member
+   * whose index was read last from is, inflating only the blocks that
+   * overlap the range.  The CRC of the member is verified when the whole
+   * data is decoded.  Throws an ExceptionObject on failure. */
+  void Read(std::istream & is, SizeValueType offset, SizeValueType size,
+            void *buffer) const;
+
+  /** Decompress the pixels of region into buffer, out of data that hold
+   * an image of the given dimensions with pixelSize bytes per pixel.
+   * Only the range of the data that covers the region is decoded. */
+  void ReadRegion(std::istream & is, const ImageIORegion & region,
+                  const std::vector< SizeValueType > & dimensions,
+                  SizeValueType pixelSize, void *buffer) const;
+
+protected:
+  BlockGzipCodec();
+  ~BlockGzipCodec() {}
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  BlockGzipCodec(const Self &);  //purposely not implemented
+  void operator=(const Self &); //purposely not implemented
+
+  struct CompressStruct;
+  struct DecompressStruct;
+
+  static ITK_THREAD_RETURN_TYPE CompressThreaderCallback(void *arg);
+
+  static ITK_THREAD_RETURN_TYPE DecompressThreaderCallback(void *arg);
+
+  SizeValueType m_BlockSize;
+  int           m_CompressionLevel;
+  ThreadIdType  m_NumberOfThreads;
+
+  /** Index of the member read by ReadIndex(): position of the member in
+   * the stream, uncompressed size and block size, and offsets of the
+   * compressed blocks (plus the offset of the trailer) in the member. */
+  std::streampos               m_MemberPosition;
+  SizeValueType                m_UncompressedSize;
+  SizeValueType                m_IndexBlockSize;
+  std::vector< SizeValueType > m_BlockOffsets;
+};
+} // end namespace itk
+
+#endif // __itkBlockGzipCodec_h
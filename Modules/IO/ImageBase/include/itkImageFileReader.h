@@ -153,6 +153,22 @@ public:
   itkSetMacro(UseStreaming, bool);
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
+
+  /** Set/Get whether the output buffer is memory mapped from the file
+   * instead of being allocated and read.  Mapping is used when the ImageIO
+   * reports a mappable data file (see ImageIOBase::GetMappableDataFile()),
+   * the whole image is read, and the output pixels are stored in the file
+   * exactly as in memory, without conversion, at a file offset that is a
+   * multiple of the buffer alignment (64 bytes unless the pixel container
+   * has an allocator with another one); otherwise the file is read as
+   * usual.  A mapped image opens in constant time, loads its pages on
+   * first access, and shares them with other processes that map the same
+   * file.  The mapping is copy-on-write: the buffer can be modified, but
+   * the file is not.  Off by default.
+   * \sa MemoryMappedBufferAllocator */
+  itkSetMacro(UseMemoryMapping, bool);
+  itkGetConstMacro(UseMemoryMapping, bool);
+  itkBooleanMacro(UseMemoryMapping);
 protected:
   ImageFileReader();
   ~ImageFileReader();
@@ -171,12 +187,19 @@ protected:
   /** Does the real work. */
   virtual void GenerateData();
 
+  /** Allocate the output buffer as a mapping of the file when
+   * UseMemoryMapping is on and the file allows it.  Returns false, with
+   * the output not allocated, otherwise. */
+  bool MapOutputBuffer();
+
   ImageIOBase::Pointer m_ImageIO;
 
   bool m_UserSpecifiedImageIO; // keep track whether the
                                // ImageIO is user specified
 
   bool m_UseStreaming;
+
+  bool m_UseMemoryMapping;
 private:
   ImageFileReader(const Self &); //purposely not implemented
   void operator=(const Self &);  //purposely not implemented
@@ -24,6 +24,8 @@
 #include "itkConvertPixelBuffer.h"
 #include "itkPixelTraits.h"
 #include "itkVectorImage.h"
+#include "itkMemoryMappedBufferAllocator.h"
+#include "itkIsSame.h"
 
 #include "itksys/SystemTools.hxx"
 #include <fstream>
@@ -38,6 +40,7 @@ ImageFileReader< TOutputImage, ConvertPixelTraits >
   this->SetFileName("");
   m_UserSpecifiedImageIO = false;
   m_UseStreaming = true;
+  m_UseMemoryMapping = false;
 }
 
 template< class TOutputImage, class ConvertPixelTraits >
@@ -63,6 +66,7 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
 
   os << indent << "UserSpecifiedImageIO flag: " << m_UserSpecifiedImageIO << "\n";
   os << indent << "m_UseStreaming: " << m_UseStreaming << "\n";
+  os << indent << "UseMemoryMapping: " << m_UseMemoryMapping << "\n";
 }
 
 template< class TOutputImage, class ConvertPixelTraits >
@@ -357,9 +361,6 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
                  << "Allocating the buffer with the EnlargedRequestedRegion \n"
                  << output->GetRequestedRegion() << "\n");
 
-  // allocated the output image to the size of the enlarge requested region
-  this->AllocateOutputs();
-
   // Test if the file exists and if it can be opened.
   // An exception will be thrown otherwise, since we can't
   // successfully read the file. We catch the exception because some
@@ -382,6 +383,16 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
   itkDebugMacro (<< "Setting imageIO IORegion to: " << m_ActualIORegion);
   m_ImageIO->SetIORegion(m_ActualIORegion);
 
+  // map the file when its pixels are stored as in the output buffer,
+  // there is nothing left to read then
+  if ( m_UseMemoryMapping && this->MapOutputBuffer() )
+    {
+    return;
+    }
+
+  // allocated the output image to the size of the enlarge requested region
+  this->AllocateOutputs();
+
   char *loadBuffer = 0;
   // the size of the buffer is computed based on the actual number of
   // pixels to be read and the actual size of the pixels to be read
@@ -470,6 +481,85 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
     }
 }
 
+template< class TOutputImage, class ConvertPixelTraits >
+bool
+ImageFileReader< TOutputImage, ConvertPixelTraits >
+::MapOutputBuffer()
+{
+  typedef typename TOutputImage::PixelContainer PixelContainerType;
+  typedef typename PixelContainerType::Element  ElementType;
+
+  TOutputImage *output = this->GetOutput();
+
+  // the whole image must be read, without conversion, into an Image
+  // (not a VectorImage, whose buffer elements are pixel components) whose
+  // buffer elements need no construction
+  ImageIOBase::IOComponentType ioType =
+    ImageIOBase
+    ::MapPixelType< typename ConvertPixelTraits::ComponentType >::CType;
+  const SizeValueType numberOfPixels = m_ActualIORegion.GetNumberOfPixels();
+  if ( !BufferElementTraits< ElementType >::IsTriviallyConstructible
+       || !IsSame< ElementType, OutputImagePixelType >::Value
+       || m_ImageIO->GetComponentType() != ioType
+       || m_ImageIO->GetNumberOfComponents() != ConvertPixelTraits::GetNumberOfComponents()
+       || numberOfPixels == 0
+       || numberOfPixels != static_cast< SizeValueType >( m_ImageIO->GetImageSizeInPixels() )
+       || numberOfPixels != output->GetRequestedRegion().GetNumberOfPixels()
+       || numberOfPixels * sizeof( ElementType ) !=
+          static_cast< SizeValueType >( m_ImageIO->GetImageSizeInBytes() ) )
+    {
+    return false;
+    }
+
+  std::string           dataFileName;
+  ImageIOBase::SizeType dataPosition = 0;
+  if ( !m_ImageIO->GetMappableDataFile(dataFileName, dataPosition) )
+    {
+    return false;
+    }
+
+  // the buffer is as aligned as the data position: it must keep the
+  // alignment of the allocator, and that of the pixel components
+  PixelContainerType *     container = output->GetPixelContainer();
+  BufferAllocator::Pointer previousAllocator = container->GetAllocator();
+
+  MemoryMappedBufferAllocator::Pointer allocator = MemoryMappedBufferAllocator::New();
+  if ( previousAllocator.IsNotNull() )
+    {
+    allocator->SetAlignment( previousAllocator->GetAlignment() );
+    }
+  const SizeValueType alignment = allocator->GetAlignment();
+  const SizeValueType componentSize = sizeof( typename ConvertPixelTraits::ComponentType );
+  if ( ( alignment > 1 && dataPosition % alignment != 0 ) || dataPosition % componentSize != 0 )
+    {
+    itkDebugMacro(<< "Reading instead of mapping: the data position " << dataPosition
+                  << " is not aligned");
+    return false;
+    }
+  allocator->SetFileName(dataFileName);
+  allocator->SetFileOffset( static_cast< SizeValueType >( dataPosition ) );
+
+  // release the current buffer so that Allocate() does not reuse it, and
+  // map the new one; later allocations use the previous allocator again
+  output->SetBufferedRegion( output->GetRequestedRegion() );
+  container->Initialize();
+  container->SetAllocator(allocator);
+  try
+    {
+    output->Allocate();
+    }
+  catch ( ExceptionObject & err )
+    {
+    itkDebugMacro(<< "Reading instead of mapping: " << err.GetDescription());
+    container->SetAllocator(previousAllocator);
+    return false;
+    }
+  container->SetAllocator(previousAllocator);
+
+  itkDebugMacro(<< "Mapped " << dataFileName << " at " << dataPosition);
+  return true;
+}
+
 template< class TOutputImage, class ConvertPixelTraits >
 void
 ImageFileReader< TOutputImage, ConvertPixelTraits >
@@ -322,6 +322,17 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void *buffer) = 0;
 
+  /** Get the file that holds the pixel data and the position of the
+   * first pixel in it, when the whole image is stored there
+   * uncompressed, contiguously and in the byte order of this machine,
+   * so that it can be memory mapped instead of read.  Called after
+   * ReadImageInformation().  Default is false. */
+  virtual bool GetMappableDataFile(std::string & itkNotUsed(fileName),
+                                   SizeType & itkNotUsed(dataPosition))
+  {
+    return false;
+  }
+
   /*-------- This part of the interfaces deals with writing data ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -621,6 +632,12 @@ protected:
   /** Convenient method to read a buffer as binary. Return true on success. */
   bool ReadBufferAsBinary(std::istream & os, void *buffer, SizeType numberOfBytesToBeRead);
 
+  /** Swap the bytes of numberOfComponents components of
+   * GetComponentSize() bytes, stored in byteOrder, to the byte order of
+   * this machine. */
+  void SwapBytesToSystemByteOrder(void *buffer, SizeValueType numberOfComponents,
+                                  ByteOrder byteOrder) const;
+
   /** Insert an extension to the list of supported extensions for reading. */
   void AddSupportedReadExtension(const char *extension);
 
@@ -23,6 +23,7 @@
 #include <string>
 #include "itkMetaDataDictionary.h"
 #include "itkImageFileReader.h"
+#include "itkSimpleFastMutexLock.h"
 
 namespace itk
 {
@@ -34,6 +35,12 @@ namespace itk
  * the files, but the image data must have the same Size for all
  * dimensions.
  *
+ * By default the files are read one after the other.  When
+ * NumberOfReadingThreads is greater than one and no ImageIO was set, up
+ * to that many files are read concurrently, each directly into its slice
+ * of the output buffer.  The MetaDataDictionaryArray is still ordered as
+ * the file names.
+ *
  * \sa GDCMSeriesFileNames
  * \sa NumericSeriesFileNames
  * \ingroup IOFilters
@@ -153,9 +160,21 @@ public:
   itkSetMacro(UseStreaming, bool);
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
+
+  /** Set/Get the maximum number of files read at the same time.  The
+   * default, 1, reads the files sequentially.  Larger values keep
+   * several reads in flight, which pays off on storage that serves
+   * concurrent requests well.  Each slice is then read with an ImageIO
+   * created by the factory mechanism.  The files are always read
+   * sequentially with an ImageIO set with SetImageIO(), since its
+   * configuration cannot be carried over to other instances, and it is
+   * left holding the state of the last file read. */
+  itkSetClampMacro(NumberOfReadingThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfReadingThreads, ThreadIdType);
 protected:
   ImageSeriesReader():m_ImageIO(0), m_ReverseOrder(false),
-    m_UseStreaming(true), m_MetaDataDictionaryArrayUpdate(true) {}
+    m_UseStreaming(true), m_NumberOfReadingThreads(1),
+    m_MetaDataDictionaryArrayUpdate(true) {}
   ~ImageSeriesReader();
   void PrintSelf(std::ostream & os, Indent indent) const;
 
@@ -183,6 +202,8 @@ protected:
   DictionaryArrayType m_MetaDataDictionaryArray;
 
   bool m_UseStreaming;
+
+  ThreadIdType m_NumberOfReadingThreads;
 private:
   ImageSeriesReader(const Self &); //purposely not implemented
   void operator=(const Self &);    //purposely not implemented
@@ -191,6 +212,55 @@ private:
 
   int ComputeMovingDimensionIndex(ReaderType *reader);
 
+  /** Read the i-th slice of the output from its file with imageIO (NULL
+   * selects the factory mechanism).  Returns whether the slice was
+   * inside the requested region and has been read; dictionary receives
+   * a deep copy of the MetaDataDictionary when requested, NULL otherwise. */
+  bool ReadSlice(int i, ImageIOBase *imageIO,
+                 bool needToUpdateMetaDataDictionaryArray,
+                 DictionaryRawPointer & dictionary);
+
+  /** Read the slices on NumberOfReadingThreads threads. */
+  void ReadSlicesInParallel(bool needToUpdateMetaDataDictionaryArray);
+
+  /** Copy of an exception caught in a reading thread, rethrown with its
+   * dynamic type by the thread that called GenerateData(). */
+  class ExceptionHolderBase
+  {
+public:
+    virtual ~ExceptionHolderBase() {}
+    virtual void Throw() const = 0;
+  };
+
+  template< class TException >
+  class ExceptionHolder:public ExceptionHolderBase
+  {
+public:
+    ExceptionHolder(const TException & e):m_Exception(e) {}
+    virtual void Throw() const { throw m_Exception; }
+private:
+    TException m_Exception;
+  };
+
+  /** Shared state of the reading threads. */
+  struct ReadSlicesStruct {
+    Self *Reader;
+    bool NeedToUpdateMetaDataDictionaryArray;
+    int NumberOfFiles;
+    int NextSlice;
+    SizeValueType NumberOfSlicesToRead;
+    SizeValueType NumberOfSlicesRead;
+    DictionaryArrayType Dictionaries;
+    bool Failed;
+    ExceptionHolderBase *Exception;
+    SimpleFastMutexLock Mutex;
+  };
+
+  static ITK_THREAD_RETURN_TYPE ReadSlicesThreaderCallback(void *arg);
+
+  /** Record the first exception of the reading threads. */
+  static void SetReadSlicesException(ReadSlicesStruct *str, ExceptionHolderBase *exception);
+
   /** Modified time of the MetaDataDictionaryArray */
   TimeStamp m_MetaDataDictionaryArrayMTime;
 
@@ -26,6 +26,9 @@
 #include "vnl/vnl_math.h"
 #include "itkProgressReporter.h"
 #include "itkMetaDataObject.h"
+#include "itkMultiThreader.h"
+#include "itkMutexLockHolder.h"
+#include <new>
 
 namespace itk
 {
@@ -54,6 +57,7 @@ void ImageSeriesReader< TOutputImage >
 
   os << indent << "ReverseOrder: " << m_ReverseOrder << std::endl;
   os << indent << "UseStreaming: " << m_UseStreaming << std::endl;
+  os << indent << "NumberOfReadingThreads: " << m_NumberOfReadingThreads << std::endl;
 
   if ( m_ImageIO )
     {
@@ -282,6 +286,66 @@ void ImageSeriesReader< TOutputImage >
 {
   TOutputImage *output = this->GetOutput();
 
+  ImageRegionType requestedRegion = output->GetRequestedRegion();
+
+  // Allocate the output buffer
+  output->SetBufferedRegion(requestedRegion);
+  output->Allocate();
+
+  // We utilize the modified time of the output information to
+  // know when the meta array needs to be updated, when the output
+  // information is updated so should the meta array.
+  // Each file can not be read in the UpdateOutputInformation methods
+  // due to the poor performance of reading each file a second time there.
+  bool needToUpdateMetaDataDictionaryArray =
+    this->m_OutputInformationMTime > this->m_MetaDataDictionaryArrayMTime
+    && m_MetaDataDictionaryArrayUpdate;
+
+  const int numberOfFiles = static_cast< int >( m_FileNames.size() );
+
+  if ( m_NumberOfReadingThreads > 1 && numberOfFiles > 1 && m_ImageIO.IsNull() )
+    {
+    this->ReadSlicesInParallel(needToUpdateMetaDataDictionaryArray);
+    }
+  else
+    {
+    // progress reported on a per slice basis
+    ProgressReporter progress(this, 0,
+                              requestedRegion.GetSize(TOutputImage::ImageDimension-1),
+                              100);
+
+    for ( int i = 0; i != numberOfFiles; ++i )
+      {
+      DictionaryRawPointer newDictionary = 0;
+      if ( this->ReadSlice(i, m_ImageIO, needToUpdateMetaDataDictionaryArray, newDictionary) )
+        {
+        // report progress for read slices
+        progress.CompletedPixel();
+        }
+      if ( newDictionary )
+        {
+        m_MetaDataDictionaryArray.push_back(newDictionary);
+        }
+      }
+    }
+
+  // update the time if we modified the meta array
+  if ( needToUpdateMetaDataDictionaryArray )
+    {
+    m_MetaDataDictionaryArrayMTime.Modified();
+    }
+}
+
+template< class TOutputImage >
+bool ImageSeriesReader< TOutputImage >
+::ReadSlice(int i, ImageIOBase *imageIO,
+            bool needToUpdateMetaDataDictionaryArray,
+            DictionaryRawPointer & dictionary)
+{
+  dictionary = 0;
+
+  TOutputImage *output = this->GetOutput();
+
   ImageRegionType requestedRegion = output->GetRequestedRegion();
   ImageRegionType largestRegion = output->GetLargestPossibleRegion();
   ImageRegionType sliceRegionToRequest = output->GetRequestedRegion();
@@ -301,164 +365,291 @@ void ImageSeriesReader< TOutputImage >
     sliceRegionToRequest.SetIndex(this->m_NumberOfDimensionsInImage, 0);
     }
 
-  // Allocate the output buffer
-  output->SetBufferedRegion(requestedRegion);
-  output->Allocate();
-
-  // progress reported on a per slice basis
-  ProgressReporter progress(this, 0,
-                            requestedRegion.GetSize(TOutputImage::ImageDimension-1),
-                            100);
-
-  // We utilize the modified time of the output information to
-  // know when the meta array needs to be updated, when the output
-  // information is updated so should the meta array.
-  // Each file can not be read in the UpdateOutputInformation methods
-  // due to the poor performance of reading each file a second time there.
-  bool needToUpdateMetaDataDictionaryArray =
-    this->m_OutputInformationMTime > this->m_MetaDataDictionaryArrayMTime
-    && m_MetaDataDictionaryArrayUpdate;
-
   typename  TOutputImage::InternalPixelType *outputBuffer = output->GetBufferPointer();
   IndexType                           sliceStartIndex = requestedRegion.GetIndex();
   const int                           numberOfFiles = static_cast< int >( m_FileNames.size() );
 
-  for ( int i = 0; i != numberOfFiles; ++i )
+  if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
     {
-    if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
-      {
-      sliceStartIndex[this->m_NumberOfDimensionsInImage] = i;
-      }
+    sliceStartIndex[this->m_NumberOfDimensionsInImage] = i;
+    }
 
-    const bool insideRequestedRegion = requestedRegion.IsInside(sliceStartIndex);
-    const int  iFileName = ( m_ReverseOrder ? numberOfFiles - i - 1 : i );
+  const bool insideRequestedRegion = requestedRegion.IsInside(sliceStartIndex);
+  const int  iFileName = ( m_ReverseOrder ? numberOfFiles - i - 1 : i );
 
-    // check if we need this slice
-    if ( !insideRequestedRegion && !needToUpdateMetaDataDictionaryArray )
-      {
-      continue;
-      }
+  // check if we need this slice
+  if ( !insideRequestedRegion && !needToUpdateMetaDataDictionaryArray )
+    {
+    return false;
+    }
 
-    // configure reader
-    typename ReaderType::Pointer reader = ReaderType::New();
-    reader->SetFileName( m_FileNames[iFileName].c_str() );
+  // configure reader
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( m_FileNames[iFileName].c_str() );
 
-    TOutputImage * readerOutput = reader->GetOutput();
+  TOutputImage * readerOutput = reader->GetOutput();
 
-    if ( m_ImageIO )
+  if ( imageIO )
+    {
+    reader->SetImageIO(imageIO);
+    }
+  reader->SetUseStreaming(m_UseStreaming);
+  readerOutput->SetRequestedRegion(sliceRegionToRequest);
+
+  // update the data or info
+  if ( !insideRequestedRegion )
+    {
+    reader->UpdateOutputInformation();
+    }
+  else
+    {
+    // read the meta data information
+    readerOutput->UpdateOutputInformation();
+
+    // propagate the requested region to determin what the region
+    // will actually be read
+    readerOutput->PropagateRequestedRegion();
+
+    // check that the size of each slice is the same
+    if ( readerOutput->GetLargestPossibleRegion().GetSize() != validSize )
       {
-      reader->SetImageIO(m_ImageIO);
+      itkExceptionMacro( << "Size mismatch! The size of  "
+                         << m_FileNames[iFileName].c_str()
+                         << " is "
+                         << readerOutput->GetLargestPossibleRegion().GetSize()
+                         << " and does not match the required size "
+                         << validSize
+                         << " from file "
+                         << m_FileNames[m_ReverseOrder ? m_FileNames.size() - 1 : 0].c_str() );
       }
-    reader->SetUseStreaming(m_UseStreaming);
-    readerOutput->SetRequestedRegion(sliceRegionToRequest);
 
-    // update the data or info
-    if ( !insideRequestedRegion )
+    // get the size of the region to be read
+    SizeType readSize = readerOutput->GetRequestedRegion().GetSize();
+
+    if( readSize == sliceRegionToRequest.GetSize() )
       {
-      reader->UpdateOutputInformation();
+      // if the buffer of the ImageReader is going to match that of
+      // ourselves, then set the ImageReader's buffer to a section
+      // of ours
+
+      const size_t  numberOfPixelsInSlice = sliceRegionToRequest.GetNumberOfPixels();
+
+      typedef typename TOutputImage::AccessorFunctorType AccessorFunctorType;
+      const size_t      numberOfInternalComponentsPerPixel =  AccessorFunctorType::GetVectorLength( output );
+
+
+      const ptrdiff_t   sliceOffset = ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage ) ?
+        ( i - requestedRegion.GetIndex(this->m_NumberOfDimensionsInImage)) : 0;
+
+      const ptrdiff_t  numberOfPixelComponentsUpToSlice =  numberOfPixelsInSlice * numberOfInternalComponentsPerPixel * sliceOffset;
+      const bool       bufferDelete = false;
+
+      typename  TOutputImage::InternalPixelType * outputSliceBuffer = outputBuffer + numberOfPixelComponentsUpToSlice;
+
+      if ( strcmp(output->GetNameOfClass(), "VectorImage") == 0 )
+        {
+        // if the input image type is a vector image then the number
+        // of components needs to be set for the size
+        readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
+                                                             numberOfPixelsInSlice*numberOfInternalComponentsPerPixel,
+                                                             bufferDelete );
+        }
+      else
+        {
+        // otherwise the actual number of pixels needs to be passed
+        readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
+                                                             numberOfPixelsInSlice,
+                                                             bufferDelete );
+        }
+      readerOutput->UpdateOutputData();
       }
     else
       {
-      // read the meta data information
-      readerOutput->UpdateOutputInformation();
+      // the read region isn't going to match exactly what we need
+      // to update to buffer created by the reader, then copy
 
-      // propagate the requested region to determin what the region
-      // will actually be read
-      readerOutput->PropagateRequestedRegion();
+      reader->Update();
 
-      // check that the size of each slice is the same
-      if ( readerOutput->GetLargestPossibleRegion().GetSize() != validSize )
+      // output of buffer copy
+      ImageRegionType outRegion = requestedRegion;
+      outRegion.SetIndex( sliceStartIndex );
+
+      // set the moving dimension to a size of 1
+      if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
         {
-        itkExceptionMacro( << "Size mismatch! The size of  "
-                           << m_FileNames[iFileName].c_str()
-                           << " is "
-                           << readerOutput->GetLargestPossibleRegion().GetSize()
-                           << " and does not match the required size "
-                           << validSize
-                           << " from file "
-                           << m_FileNames[m_ReverseOrder ? m_FileNames.size() - 1 : 0].c_str() );
+        outRegion.SetSize(this->m_NumberOfDimensionsInImage, 1);
         }
 
-      // get the size of the region to be read
-      SizeType readSize = readerOutput->GetRequestedRegion().GetSize();
+      ImageAlgorithm::Copy( readerOutput, output, sliceRegionToRequest, outRegion );
 
-      if( readSize == sliceRegionToRequest.GetSize() )
-        {
-        // if the buffer of the ImageReader is going to match that of
-        // ourselves, then set the ImageReader's buffer to a section
-        // of ours
+      }
+    } // end !insidedRequestedRegion
 
-        const size_t  numberOfPixelsInSlice = sliceRegionToRequest.GetNumberOfPixels();
+  // Deep copy the MetaDataDictionary into the array
+  if ( reader->GetImageIO() &&  needToUpdateMetaDataDictionaryArray )
+    {
+    dictionary = new DictionaryType;
+    *dictionary = reader->GetImageIO()->GetMetaDataDictionary();
+    }
 
-        typedef typename TOutputImage::AccessorFunctorType AccessorFunctorType;
-        const size_t      numberOfInternalComponentsPerPixel =  AccessorFunctorType::GetVectorLength( output );
+  return insideRequestedRegion;
+}
 
+template< class TOutputImage >
+void ImageSeriesReader< TOutputImage >
+::ReadSlicesInParallel(bool needToUpdateMetaDataDictionaryArray)
+{
+  const int numberOfFiles = static_cast< int >( m_FileNames.size() );
 
-        const ptrdiff_t   sliceOffset = ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage ) ?
-          ( i - requestedRegion.GetIndex(this->m_NumberOfDimensionsInImage)) : 0;
+  ReadSlicesStruct str;
+  str.Reader = this;
+  str.NeedToUpdateMetaDataDictionaryArray = needToUpdateMetaDataDictionaryArray;
+  str.NumberOfFiles = numberOfFiles;
+  str.NextSlice = 0;
+  str.NumberOfSlicesToRead =
+    this->GetOutput()->GetRequestedRegion().GetSize(TOutputImage::ImageDimension-1);
+  str.NumberOfSlicesRead = 0;
+  str.Dictionaries.resize(numberOfFiles, 0);
+  str.Failed = false;
+  str.Exception = 0;
+
+  // The slices are handed out one at a time, so that no more than
+  // NumberOfReadingThreads files are being read at any moment.
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads( vnl_math_min( m_NumberOfReadingThreads,
+                                              static_cast< ThreadIdType >( numberOfFiles ) ) );
+  threader->SetSingleMethod(Self::ReadSlicesThreaderCallback, &str);
+
+  this->UpdateProgress(0.0f);
+  threader->SingleMethodExecute();
+
+  if ( str.Failed )
+    {
+    for ( int i = 0; i != numberOfFiles; ++i )
+      {
+      delete str.Dictionaries[i];
+      }
+    try
+      {
+      str.Exception->Throw();
+      }
+    catch ( ... )
+      {
+      delete str.Exception;
+      throw;
+      }
+    }
 
-        const ptrdiff_t  numberOfPixelComponentsUpToSlice =  numberOfPixelsInSlice * numberOfInternalComponentsPerPixel * sliceOffset;
-        const bool       bufferDelete = false;
+  // the dictionaries are appended in the order of the files, as the
+  // sequential reader does
+  for ( int i = 0; i != numberOfFiles; ++i )
+    {
+    if ( str.Dictionaries[i] )
+      {
+      m_MetaDataDictionaryArray.push_back(str.Dictionaries[i]);
+      }
+    }
+  this->UpdateProgress(1.0f);
+}
 
-        typename  TOutputImage::InternalPixelType * outputSliceBuffer = outputBuffer + numberOfPixelComponentsUpToSlice;
+template< class TOutputImage >
+ITK_THREAD_RETURN_TYPE
+ImageSeriesReader< TOutputImage >
+::ReadSlicesThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  const ThreadIdType               threadId = info->ThreadID;
+  ReadSlicesStruct *               str = static_cast< ReadSlicesStruct * >( info->UserData );
+  Self *                           self = str->Reader;
 
-        if ( strcmp(output->GetNameOfClass(), "VectorImage") == 0 )
-          {
-          // if the input image type is a vector image then the number
-          // of components needs to be set for the size
-          readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
-                                                               numberOfPixelsInSlice*numberOfInternalComponentsPerPixel,
-                                                               bufferDelete );
-          }
-        else
+  try
+    {
+    for (;; )
+      {
+      int i;
+        {
+        MutexLockHolder< SimpleFastMutexLock > lock(str->Mutex);
+        if ( str->Failed || str->NextSlice == str->NumberOfFiles )
           {
-          // otherwise the actual number of pixels needs to be passed
-          readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
-                                                               numberOfPixelsInSlice,
-                                                               bufferDelete );
+          break;
           }
-        readerOutput->UpdateOutputData();
+        i = str->NextSlice++;
         }
-      else
-        {
-        // the read region isn't going to match exactly what we need
-        // to update to buffer created by the reader, then copy
 
-        reader->Update();
+      DictionaryRawPointer newDictionary = 0;
+      const bool           sliceRead =
+        self->ReadSlice(i, 0, str->NeedToUpdateMetaDataDictionaryArray, newDictionary);
+      str->Dictionaries[i] = newDictionary;
 
-        // output of buffer copy
-        ImageRegionType outRegion = requestedRegion;
-        outRegion.SetIndex( sliceStartIndex );
-
-        // set the moving dimension to a size of 1
-        if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
+      float progress = 0.0f;
+        {
+        MutexLockHolder< SimpleFastMutexLock > lock(str->Mutex);
+        if ( sliceRead )
           {
-          outRegion.SetSize(this->m_NumberOfDimensionsInImage, 1);
+          ++str->NumberOfSlicesRead;
           }
-
-        ImageAlgorithm::Copy( readerOutput, output, sliceRegionToRequest, outRegion );
-
+        progress = static_cast< float >( str->NumberOfSlicesRead )
+                   / static_cast< float >( str->NumberOfSlicesToRead );
         }
 
-      // report progress for read slices
-      progress.CompletedPixel();
-
-     } // end !insidedRequestedRegion
-
-    // Deep copy the MetaDataDictionary into the array
-    if ( reader->GetImageIO() &&  needToUpdateMetaDataDictionaryArray )
-      {
-      DictionaryRawPointer newDictionary = new DictionaryType;
-      *newDictionary = reader->GetImageIO()->GetMetaDataDictionary();
-      m_MetaDataDictionaryArray.push_back(newDictionary);
+      // progress events are only invoked from the first thread
+      if ( threadId == 0 && sliceRead )
+        {
+        self->UpdateProgress(progress);
+        }
       }
+    }
+  // the exception types thrown while reading are kept, so that they can
+  // be caught as such around Update()
+  catch ( ImageFileReaderException & e )
+    {
+    SetReadSlicesException( str, new ExceptionHolder< ImageFileReaderException >(e) );
+    }
+  catch ( ProcessAborted & e )
+    {
+    SetReadSlicesException( str, new ExceptionHolder< ProcessAborted >(e) );
+    }
+  catch ( MemoryAllocationError & e )
+    {
+    SetReadSlicesException( str, new ExceptionHolder< MemoryAllocationError >(e) );
+    }
+  catch ( ExceptionObject & e )
+    {
+    SetReadSlicesException( str, new ExceptionHolder< ExceptionObject >(e) );
+    }
+  catch ( std::bad_alloc & e )
+    {
+    SetReadSlicesException( str, new ExceptionHolder< std::bad_alloc >(e) );
+    }
+  catch ( std::exception & e )
+    {
+    SetReadSlicesException( str, new ExceptionHolder< ExceptionObject >(
+                              ExceptionObject(__FILE__, __LINE__, e.what(), ITK_LOCATION) ) );
+    }
+  catch ( ... )
+    {
+    SetReadSlicesException( str, new ExceptionHolder< ExceptionObject >(
+                              ExceptionObject(__FILE__, __LINE__, "Unknown exception while reading a slice",
+                                              ITK_LOCATION) ) );
+    }
 
-    } // end per slice loop
+  return ITK_THREAD_RETURN_VALUE;
+}
 
-  // update the time if we modified the meta array
-  if ( needToUpdateMetaDataDictionaryArray )
+template< class TOutputImage >
+void
+ImageSeriesReader< TOutputImage >
+::SetReadSlicesException(ReadSlicesStruct *str, ExceptionHolderBase *exception)
+{
+  MutexLockHolder< SimpleFastMutexLock > lock(str->Mutex);
+  if ( str->Failed )
     {
-    m_MetaDataDictionaryArrayMTime.Modified();
+    delete exception;
+    }
+  else
+    {
+    str->Failed = true;
+    str->Exception = exception;
     }
 }
 
@@ -0,0 +1,498 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkBlockGzipCodec.h"
+#include "itk_zlib.h"
+#include <algorithm>
+#include <cstring>
+
+namespace itk
+{
+namespace
+{
+// gzip header with FEXTRA set, and the "IT" subfield holding the index:
+// uncompressed size (8 bytes), block size (4 bytes), then the compressed
+// size of each block (4 bytes each), all little endian.
+const unsigned int GzipHeaderSize = 10;
+const unsigned int IndexFixedSize = 12;
+const unsigned int MaximumSubfieldSize = 65535 - 4;
+const SizeValueType MaximumNumberOfBlocks = ( MaximumSubfieldSize - IndexFixedSize ) / 4;
+
+void AppendLittleEndian(std::vector< char > & out, uint64_t value, unsigned int numberOfBytes)
+{
+  for ( unsigned int i = 0; i < numberOfBytes; ++i )
+    {
+    out.push_back( static_cast< char >( ( value >> ( 8 * i ) ) & 0xff ) );
+    }
+}
+
+uint64_t ReadLittleEndian(const unsigned char *in, unsigned int numberOfBytes)
+{
+  uint64_t value = 0;
+  for ( unsigned int i = 0; i < numberOfBytes; ++i )
+    {
+    value |= static_cast< uint64_t >( in[i] ) << ( 8 * i );
+    }
+  return value;
+}
+}
+
+struct BlockGzipCodec::CompressStruct {
+  const unsigned char *Data;
+  SizeValueType Size;
+  SizeValueType BlockSize;
+  SizeValueType NumberOfBlocks;
+  int CompressionLevel;
+  std::vector< std::vector< char > > Blocks;
+  std::vector< uLong > BlockCRCs;
+  std::vector< int > ThreadFailed;
+};
+
+struct BlockGzipCodec::DecompressStruct {
+  const unsigned char *Input;
+  const SizeValueType *BlockOffsets;
+  SizeValueType FirstBlock;
+  SizeValueType LastBlock;
+  SizeValueType BlockSize;
+  SizeValueType UncompressedSize;
+  SizeValueType Offset;
+  SizeValueType Size;
+  unsigned char *Output;
+  bool ComputeCRC;
+  std::vector< uLong > BlockCRCs;
+  std::vector< int > ThreadFailed;
+};
+
+BlockGzipCodec::BlockGzipCodec():
+  m_BlockSize(1024 * 1024),
+  m_CompressionLevel(6),
+  m_NumberOfThreads( MultiThreader::GetGlobalDefaultNumberOfThreads() ),
+  m_MemberPosition(0),
+  m_UncompressedSize(0),
+  m_IndexBlockSize(0)
+{}
+
+void BlockGzipCodec::Compress(const void *data, SizeValueType size,
+                              std::vector< char > & compressed) const
+{
+  CompressStruct str;
+  str.Data = static_cast< const unsigned char * >( data );
+  str.Size = size;
+  str.BlockSize = m_BlockSize;
+  if ( size > str.BlockSize * MaximumNumberOfBlocks )
+    {
+    // the index must fit in the gzip header
+    str.BlockSize = ( size + MaximumNumberOfBlocks - 1 ) / MaximumNumberOfBlocks;
+    }
+  str.NumberOfBlocks = ( size == 0 ) ? 1 : ( size + str.BlockSize - 1 ) / str.BlockSize;
+  str.CompressionLevel = m_CompressionLevel;
+  str.Blocks.resize(str.NumberOfBlocks);
+  str.BlockCRCs.resize(str.NumberOfBlocks);
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads( static_cast< ThreadIdType >(
+                                  std::min< SizeValueType >(m_NumberOfThreads, str.NumberOfBlocks) ) );
+  str.ThreadFailed.resize(threader->GetNumberOfThreads(), 0);
+  threader->SetSingleMethod(Self::CompressThreaderCallback, &str);
+  threader->SingleMethodExecute();
+
+  for ( size_t t = 0; t < str.ThreadFailed.size(); ++t )
+    {
+    if ( str.ThreadFailed[t] )
+      {
+      itkExceptionMacro("Failed to deflate the data");
+      }
+    }
+
+  // header
+  const SizeValueType subfieldSize = IndexFixedSize + 4 * str.NumberOfBlocks;
+  compressed.clear();
+  compressed.reserve(GzipHeaderSize + 6 + subfieldSize);
+  const unsigned char header[GzipHeaderSize] = {
+    0x1f, 0x8b, // magic
+    8,          // deflate
+    4,          // FEXTRA
+    0, 0, 0, 0, // no modification time
+    0,          // extra flags
+    255         // unknown operating system
+  };
+  compressed.insert( compressed.end(), header, header + GzipHeaderSize );
+  AppendLittleEndian(compressed, subfieldSize + 4, 2);
+  compressed.push_back('I');
+  compressed.push_back('T');
+  AppendLittleEndian(compressed, subfieldSize, 2);
+  AppendLittleEndian(compressed, size, 8);
+  AppendLittleEndian(compressed, str.BlockSize, 4);
+  for ( SizeValueType i = 0; i < str.NumberOfBlocks; ++i )
+    {
+    AppendLittleEndian(compressed, str.Blocks[i].size(), 4);
+    }
+
+  // blocks, then the trailer
+  uLong crc = crc32(0L, Z_NULL, 0);
+  for ( SizeValueType i = 0; i < str.NumberOfBlocks; ++i )
+    {
+    compressed.insert( compressed.end(), str.Blocks[i].begin(), str.Blocks[i].end() );
+    std::vector< char >().swap(str.Blocks[i]);
+
+    const SizeValueType blockLength =
+      std::min(str.BlockSize, size - std::min(size, i * str.BlockSize) );
+    crc = crc32_combine( crc, str.BlockCRCs[i], static_cast< z_off_t >( blockLength ) );
+    }
+  AppendLittleEndian(compressed, crc, 4);
+  AppendLittleEndian(compressed, size & 0xffffffff, 4);
+}
+
+ITK_THREAD_RETURN_TYPE BlockGzipCodec::CompressThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  const ThreadIdType               threadId = info->ThreadID;
+  const ThreadIdType               numberOfThreads = info->NumberOfThreads;
+  CompressStruct *                 str = static_cast< CompressStruct * >( info->UserData );
+
+  for ( SizeValueType i = threadId; i < str->NumberOfBlocks; i += numberOfThreads )
+    {
+    const SizeValueType  blockStart = std::min(str->Size, i * str->BlockSize);
+    const SizeValueType  blockLength = std::min(str->BlockSize, str->Size - blockStart);
+    const unsigned char *in = str->Data + blockStart;
+    std::vector< char > &out = str->Blocks[i];
+
+    // raw deflate, so that the blocks concatenate into one stream; all
+    // blocks but the last end byte aligned with an empty stored block
+    z_stream z;
+    memset( &z, 0, sizeof( z ) );
+    if ( deflateInit2(&z, str->CompressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK )
+      {
+      str->ThreadFailed[threadId] = 1;
+      return ITK_THREAD_RETURN_VALUE;
+      }
+    const int flush = ( i + 1 == str->NumberOfBlocks ) ? Z_FINISH : Z_SYNC_FLUSH;
+
+    out.resize(deflateBound( &z, static_cast< uLong >( blockLength ) ) + 16);
+    z.next_in = const_cast< Bytef * >( in );
+    z.avail_in = static_cast< uInt >( blockLength );
+    z.next_out = reinterpret_cast< Bytef * >( &out[0] );
+    z.avail_out = static_cast< uInt >( out.size() );
+    for (;; )
+      {
+      if ( z.avail_out == 0 )
+        {
+        const size_t used = out.size();
+        out.resize(2 * used);
+        z.next_out = reinterpret_cast< Bytef * >( &out[used] );
+        z.avail_out = static_cast< uInt >( used );
+        }
+      const int err = deflate(&z, flush);
+      if ( err == Z_STREAM_ERROR )
+        {
+        str->ThreadFailed[threadId] = 1;
+        break;
+        }
+      if ( flush == Z_FINISH ? err == Z_STREAM_END : ( z.avail_in == 0 && z.avail_out != 0 ) )
+        {
+        break;
+        }
+      }
+    out.resize(z.total_out);
+    deflateEnd(&z);
+
+    str->BlockCRCs[i] = crc32( crc32(0L, Z_NULL, 0), in, static_cast< uInt >( blockLength ) );
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+bool BlockGzipCodec::ReadIndex(std::istream & is)
+{
+  const std::streampos memberPosition = is.tellg();
+
+  unsigned char header[GzipHeaderSize + 2];
+  is.read(reinterpret_cast< char * >( header ), GzipHeaderSize + 2);
+  if ( !is || header[0] != 0x1f || header[1] != 0x8b || header[2] != 8 || header[3] != 4 )
+    {
+    is.clear();
+    is.seekg(memberPosition);
+    return false;
+    }
+
+  const unsigned int           extraLength = static_cast< unsigned int >( ReadLittleEndian(header + GzipHeaderSize, 2) );
+  std::vector< unsigned char > extra(extraLength + 1);
+  is.read(reinterpret_cast< char * >( &extra[0] ), extraLength);
+
+  bool found = false;
+  for ( unsigned int p = 0; is && p + 4 <= extraLength; )
+    {
+    const unsigned int subfieldSize = static_cast< unsigned int >( ReadLittleEndian(&extra[p + 2], 2) );
+    if ( p + 4 + subfieldSize > extraLength )
+      {
+      break;
+      }
+    if ( extra[p] == 'I' && extra[p + 1] == 'T'
+         && subfieldSize >= IndexFixedSize && ( subfieldSize - IndexFixedSize ) % 4 == 0 )
+      {
+      const unsigned char *index = &extra[p + 4];
+      const SizeValueType  uncompressedSize = static_cast< SizeValueType >( ReadLittleEndian(index, 8) );
+      const SizeValueType  blockSize = static_cast< SizeValueType >( ReadLittleEndian(index + 8, 4) );
+      const SizeValueType  numberOfBlocks = ( subfieldSize - IndexFixedSize ) / 4;
+      if ( blockSize > 0
+           && numberOfBlocks == ( uncompressedSize == 0 ? 1 : ( uncompressedSize + blockSize - 1 ) / blockSize ) )
+        {
+        m_MemberPosition = memberPosition;
+        m_UncompressedSize = uncompressedSize;
+        m_IndexBlockSize = blockSize;
+        m_BlockOffsets.resize(numberOfBlocks + 1);
+        m_BlockOffsets[0] = GzipHeaderSize + 2 + extraLength;
+        for ( SizeValueType i = 0; i < numberOfBlocks; ++i )
+          {
+          m_BlockOffsets[i + 1] = m_BlockOffsets[i]
+                                  + static_cast< SizeValueType >( ReadLittleEndian(index + IndexFixedSize + 4 * i, 4) );
+          }
+        found = true;
+        }
+      break;
+      }
+    p += 4 + subfieldSize;
+    }
+
+  is.clear();
+  is.seekg(memberPosition);
+  return found;
+}
+
+void BlockGzipCodec::Read(std::istream & is, SizeValueType offset, SizeValueType size,
+                          void *buffer) const
+{
+  if ( size == 0 )
+    {
+    return;
+    }
+  if ( m_BlockOffsets.empty() || offset + size > m_UncompressedSize )
+    {
+    itkExceptionMacro("Requested data [" << offset << ", " << offset + size
+                      << ") are outside of the " << m_UncompressedSize << " bytes of the block index");
+    }
+
+  DecompressStruct str;
+  str.FirstBlock = offset / m_IndexBlockSize;
+  str.LastBlock = ( offset + size - 1 ) / m_IndexBlockSize;
+  str.BlockOffsets = &m_BlockOffsets[0];
+  str.BlockSize = m_IndexBlockSize;
+  str.UncompressedSize = m_UncompressedSize;
+  str.Offset = offset;
+  str.Size = size;
+  str.Output = static_cast< unsigned char * >( buffer );
+  str.ComputeCRC = ( size == m_UncompressedSize );
+
+  const SizeValueType numberOfBlocks = str.LastBlock - str.FirstBlock + 1;
+  str.BlockCRCs.resize(str.LastBlock + 1);
+
+  // read the compressed blocks at once, with the trailer when the CRC is
+  // verified
+  const SizeValueType inputStart = m_BlockOffsets[str.FirstBlock];
+  const SizeValueType inputSize = m_BlockOffsets[str.LastBlock + 1] - inputStart
+                                  + ( str.ComputeCRC ? 8 : 0 );
+  std::vector< unsigned char > input(inputSize + 1);
+  is.clear();
+  is.seekg( m_MemberPosition + static_cast< std::streamoff >( inputStart ) );
+  is.read( reinterpret_cast< char * >( &input[0] ), static_cast< std::streamsize >( inputSize ) );
+  if ( static_cast< SizeValueType >( is.gcount() ) != inputSize )
+    {
+    itkExceptionMacro("Unexpected end of the compressed data");
+    }
+  str.Input = &input[0];
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads( static_cast< ThreadIdType >(
+                                  std::min< SizeValueType >(m_NumberOfThreads, numberOfBlocks) ) );
+  str.ThreadFailed.resize(threader->GetNumberOfThreads(), 0);
+  threader->SetSingleMethod(Self::DecompressThreaderCallback, &str);
+  threader->SingleMethodExecute();
+
+  for ( size_t t = 0; t < str.ThreadFailed.size(); ++t )
+    {
+    if ( str.ThreadFailed[t] )
+      {
+      itkExceptionMacro("Failed to inflate the compressed data");
+      }
+    }
+
+  if ( str.ComputeCRC )
+    {
+    uLong crc = crc32(0L, Z_NULL, 0);
+    for ( SizeValueType i = 0; i <= str.LastBlock; ++i )
+      {
+      const SizeValueType blockLength =
+        std::min(m_IndexBlockSize, m_UncompressedSize - std::min(m_UncompressedSize, i * m_IndexBlockSize) );
+      crc = crc32_combine( crc, str.BlockCRCs[i], static_cast< z_off_t >( blockLength ) );
+      }
+    const unsigned char *trailer = &input[inputSize - 8];
+    if ( ReadLittleEndian(trailer, 4) != crc
+         || ReadLittleEndian(trailer + 4, 4) != ( m_UncompressedSize & 0xffffffff ) )
+      {
+      itkExceptionMacro("CRC error in the compressed data");
+      }
+    }
+}
+
+void BlockGzipCodec::ReadRegion(std::istream & is, const ImageIORegion & region,
+                                const std::vector< SizeValueType > & dimensions,
+                                SizeValueType pixelSize, void *buffer) const
+{
+  const unsigned int nDims = static_cast< unsigned int >( dimensions.size() );
+
+  // the region is copied row by row out of the range of the data that
+  // covers it, unless it is that range, which happens when it spans
+  // whole rows, slices, ...
+  std::vector< SizeValueType > strides(nDims);
+  SizeValueType                firstByte = 0;
+  SizeValueType                lastByte = 0;
+  SizeValueType                stride = pixelSize;
+  bool                         contiguous = true;
+  bool                         lowerDimensionsComplete = true;
+  for ( unsigned int i = 0; i < nDims; i++ )
+    {
+    strides[i] = stride;
+    firstByte += region.GetIndex(i) * stride;
+    lastByte += ( region.GetIndex(i) + region.GetSize(i) - 1 ) * stride;
+    if ( region.GetSize(i) > 1 && !lowerDimensionsComplete )
+      {
+      contiguous = false;
+      }
+    if ( region.GetSize(i) != dimensions[i] )
+      {
+      lowerDimensionsComplete = false;
+      }
+    stride *= dimensions[i];
+    }
+  lastByte += pixelSize;
+
+  const SizeValueType rangeSize = lastByte - firstByte;
+  if ( contiguous )
+    {
+    this->Read(is, firstByte, rangeSize, buffer);
+    return;
+    }
+
+  std::vector< char > range(rangeSize);
+  this->Read(is, firstByte, rangeSize, &range[0]);
+
+  const SizeValueType          rowSize = region.GetSize(0) * pixelSize;
+  char *                       out = static_cast< char * >( buffer );
+  std::vector< SizeValueType > position(nDims, 0);
+  for (;; )
+    {
+    SizeValueType offset = 0;
+    for ( unsigned int i = 1; i < nDims; i++ )
+      {
+      offset += position[i] * strides[i];
+      }
+    memcpy(out, &range[offset], rowSize);
+    out += rowSize;
+
+    unsigned int i = 1;
+    for (; i < nDims; i++ )
+      {
+      if ( ++position[i] < region.GetSize(i) )
+        {
+        break;
+        }
+      position[i] = 0;
+      }
+    if ( i >= nDims )
+      {
+      break;
+      }
+    }
+}
+
+ITK_THREAD_RETURN_TYPE BlockGzipCodec::DecompressThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  const ThreadIdType               threadId = info->ThreadID;
+  const ThreadIdType               numberOfThreads = info->NumberOfThreads;
+  DecompressStruct *               str = static_cast< DecompressStruct * >( info->UserData );
+
+  std::vector< unsigned char > blockBuffer;
+  for ( SizeValueType i = str->FirstBlock + threadId; i <= str->LastBlock; i += numberOfThreads )
+    {
+    const SizeValueType blockStart = i * str->BlockSize;
+    const SizeValueType blockLength = std::min(str->BlockSize, str->UncompressedSize - blockStart);
+    const bool          inside = blockStart >= str->Offset
+                                 && blockStart + blockLength <= str->Offset + str->Size;
+
+    // blocks that are entirely requested are inflated in place
+    unsigned char *out;
+    if ( inside )
+      {
+      out = str->Output + ( blockStart - str->Offset );
+      }
+    else
+      {
+      blockBuffer.resize(blockLength + 1);
+      out = &blockBuffer[0];
+      }
+
+    z_stream z;
+    memset( &z, 0, sizeof( z ) );
+    if ( inflateInit2(&z, -MAX_WBITS) != Z_OK )
+      {
+      str->ThreadFailed[threadId] = 1;
+      break;
+      }
+    z.next_in = const_cast< Bytef * >( str->Input + ( str->BlockOffsets[i] - str->BlockOffsets[str->FirstBlock] ) );
+    z.avail_in = static_cast< uInt >( str->BlockOffsets[i + 1] - str->BlockOffsets[i] );
+    z.next_out = out;
+    z.avail_out = static_cast< uInt >( blockLength );
+    const int err = inflate(&z, Z_SYNC_FLUSH);
+    const bool last = ( blockStart + blockLength == str->UncompressedSize );
+    const bool ok = ( last ? err == Z_STREAM_END : ( err == Z_OK || err == Z_BUF_ERROR || err == Z_STREAM_END ) )
+                    && z.total_out == blockLength;
+    inflateEnd(&z);
+    if ( !ok )
+      {
+      str->ThreadFailed[threadId] = 1;
+      break;
+      }
+
+    if ( str->ComputeCRC )
+      {
+      str->BlockCRCs[i] = crc32( crc32(0L, Z_NULL, 0), out, static_cast< uInt >( blockLength ) );
+      }
+
+    if ( !inside )
+      {
+      const SizeValueType copyStart = std::max(blockStart, str->Offset);
+      const SizeValueType copyEnd = std::min(blockStart + blockLength, str->Offset + str->Size);
+      memcpy(str->Output + ( copyStart - str->Offset ), out + ( copyStart - blockStart ), copyEnd - copyStart);
+      }
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void BlockGzipCodec::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "BlockSize: " << m_BlockSize << std::endl;
+  os << indent << "CompressionLevel: " << m_CompressionLevel << std::endl;
+  os << indent << "NumberOfThreads: " << m_NumberOfThreads << std::endl;
+  os << indent << "UncompressedSize: " << m_UncompressedSize << std::endl;
+  os << indent << "NumberOfBlocks: "
+     << ( m_BlockOffsets.empty() ? 0 : m_BlockOffsets.size() - 1 ) << std::endl;
+}
+} // end namespace itk
@@ -17,6 +17,7 @@
  *=========================================================================*/
 
 #include "itkImageIOBase.h"
+#include "itkByteSwapper.h"
 
 namespace itk
 {
@@ -935,6 +936,51 @@ ImageIOBase
   return streamableRegion;
 }
 
+void
+ImageIOBase
+::SwapBytesToSystemByteOrder(void *buffer, SizeValueType numberOfComponents,
+                             ByteOrder byteOrder) const
+{
+  const bool bigEndian = ( byteOrder == BigEndian );
+  switch ( this->GetComponentSize() )
+    {
+    case 1:
+      break;
+    case 2:
+      if ( bigEndian )
+        {
+        ByteSwapper< uint16_t >::SwapRangeFromSystemToBigEndian( (uint16_t *)buffer, numberOfComponents );
+        }
+      else
+        {
+        ByteSwapper< uint16_t >::SwapRangeFromSystemToLittleEndian( (uint16_t *)buffer, numberOfComponents );
+        }
+      break;
+    case 4:
+      if ( bigEndian )
+        {
+        ByteSwapper< uint32_t >::SwapRangeFromSystemToBigEndian( (uint32_t *)buffer, numberOfComponents );
+        }
+      else
+        {
+        ByteSwapper< uint32_t >::SwapRangeFromSystemToLittleEndian( (uint32_t *)buffer, numberOfComponents );
+        }
+      break;
+    case 8:
+      if ( bigEndian )
+        {
+        ByteSwapper< uint64_t >::SwapRangeFromSystemToBigEndian( (uint64_t *)buffer, numberOfComponents );
+        }
+      else
+        {
+        ByteSwapper< uint64_t >::SwapRangeFromSystemToLittleEndian( (uint64_t *)buffer, numberOfComponents );
+        }
+      break;
+    default:
+      itkExceptionMacro(<< "Unknown component size " << this->GetComponentSize());
+    }
+}
+
 /** Return the directions that this particular ImageIO would use by default
  *  in the case the recipient image dimension is smaller than the dimension
  *  of the image in file. */
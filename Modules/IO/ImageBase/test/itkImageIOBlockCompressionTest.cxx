@@ -0,0 +1,196 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageIOFactory.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkMetaImageIO.h"
+#include "itkNrrdImageIO.h"
+
+/*
+ * Write block compressed files in the format of the file extension, and
+ * read them back whole and by regions.
+ */
+
+namespace
+{
+typedef itk::Image< short, 3 > ImageType;
+
+bool SameValues(const ImageType *expected, const ImageType *image, const ImageType::RegionType & region)
+{
+  if ( !image->GetBufferedRegion().IsInside(region) )
+    {
+    return false;
+    }
+  itk::ImageRegionConstIterator< ImageType > it(expected, region);
+  itk::ImageRegionConstIterator< ImageType > it2(image, region);
+  for ( it.GoToBegin(), it2.GoToBegin(); !it.IsAtEnd(); ++it, ++it2 )
+    {
+    if ( it.Get() != it2.Get() )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+int CheckRead(const ImageType *image, const std::string & fileName, bool blockCompressed)
+{
+  typedef itk::ImageFileReader< ImageType > ReaderType;
+  int result = EXIT_SUCCESS;
+
+  // whole image
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->Update();
+  if ( !SameValues( image, reader->GetOutput(), image->GetLargestPossibleRegion() ) )
+    {
+    std::cout << fileName << ": pixel values differ" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  if ( !blockCompressed )
+    {
+    return result;
+    }
+
+  // regions that are, and are not, contiguous in the file
+  ImageType::RegionType regions[2];
+  regions[0].SetIndex(2, 5);
+  regions[0].SetSize( 0, image->GetLargestPossibleRegion().GetSize(0) );
+  regions[0].SetSize( 1, image->GetLargestPossibleRegion().GetSize(1) );
+  regions[0].SetSize(2, 9);
+  regions[1].SetIndex(0, 17);
+  regions[1].SetIndex(1, 3);
+  regions[1].SetIndex(2, 11);
+  regions[1].SetSize(0, 40);
+  regions[1].SetSize(1, 50);
+  regions[1].SetSize(2, 6);
+  for ( unsigned int r = 0; r < 2; r++ )
+    {
+    ReaderType::Pointer regionReader = ReaderType::New();
+    regionReader->SetFileName(fileName);
+    regionReader->UpdateOutputInformation();
+    regionReader->GetOutput()->SetRequestedRegion(regions[r]);
+    regionReader->Update();
+    if ( regionReader->GetOutput()->GetBufferedRegion() != regions[r]
+         || !SameValues( image, regionReader->GetOutput(), regions[r] ) )
+      {
+      std::cout << fileName << ": region " << regions[r] << " read failed" << std::endl;
+      result = EXIT_FAILURE;
+      }
+    }
+  return result;
+}
+
+// Block compression is an option of the ImageIO of each format.
+bool SetUseBlockCompression(itk::ImageIOBase *io, bool blockCompression)
+{
+  if ( itk::MetaImageIO *metaIO = dynamic_cast< itk::MetaImageIO * >( io ) )
+    {
+    metaIO->SetUseBlockCompression(blockCompression);
+    return true;
+    }
+  if ( itk::NrrdImageIO *nrrdIO = dynamic_cast< itk::NrrdImageIO * >( io ) )
+    {
+    nrrdIO->SetUseBlockCompression(blockCompression);
+    return true;
+    }
+  return false;
+}
+
+void WriteCompressed(const ImageType *image, const std::string & fileName, bool blockCompression)
+{
+  itk::ImageIOBase::Pointer io =
+    itk::ImageIOFactory::CreateImageIO(fileName.c_str(), itk::ImageIOFactory::WriteMode);
+  if ( io.IsNull() || !SetUseBlockCompression(io, blockCompression) )
+    {
+    itkGenericExceptionMacro(<< "No ImageIO with block compression writes " << fileName);
+    }
+
+  typedef itk::ImageFileWriter< ImageType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(fileName);
+  writer->SetImageIO(io);
+  writer->SetInput(image);
+  writer->UseCompressionOn();
+  writer->Update();
+}
+}
+
+int itkImageIOBlockCompressionTest(int argc, char *argv[])
+{
+  if ( argc < 4 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputBase extension detachedExtension" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string prefix = argv[1];
+  const std::string extension = argv[2];
+  const std::string detachedExtension = argv[3];
+
+  // several blocks of the default block size
+  ImageType::SizeType size;
+  size[0] = 256;
+  size[1] = 256;
+  size[2] = 24;
+  ImageType::RegionType region(size);
+  ImageType::Pointer    image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  unsigned int value = 0;
+  itk::ImageRegionIterator< ImageType > it(image, region);
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it, ++value )
+    {
+    it.Set( static_cast< short >( ( value * 7 ) % 1021 ) );
+    }
+
+  int result = EXIT_SUCCESS;
+  try
+    {
+    // pixels following the header
+    WriteCompressed(image, prefix + "." + extension, true);
+    if ( CheckRead(image, prefix + "." + extension, true) != EXIT_SUCCESS )
+      {
+      result = EXIT_FAILURE;
+      }
+
+    // pixels in a separate data file
+    WriteCompressed(image, prefix + "." + detachedExtension, true);
+    if ( CheckRead(image, prefix + "." + detachedExtension, true) != EXIT_SUCCESS )
+      {
+      result = EXIT_FAILURE;
+      }
+
+    // regular compressed data are still read
+    WriteCompressed(image, prefix + "Regular." + extension, false);
+    if ( CheckRead(image, prefix + "Regular." + extension, false) != EXIT_SUCCESS )
+      {
+      result = EXIT_FAILURE;
+      }
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cerr << "Exception caught: " << err << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return result;
+}
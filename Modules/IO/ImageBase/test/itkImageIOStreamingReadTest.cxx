@@ -0,0 +1,186 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkStreamingImageFilter.h"
+
+/*
+ * Write an image in the format of the file extension, stream it back in
+ * slabs, and read a region that is not contiguous in the file. The
+ * ImageIO is selected by the factories from the file extension.
+ */
+
+namespace
+{
+template< typename TPixel >
+void SetTestPixel(TPixel & pix, unsigned long value)
+{
+  pix = static_cast< TPixel >( value % 251 );
+}
+
+void SetTestPixel(itk::Vector< float, 3 > & pix, unsigned long value)
+{
+  for ( unsigned int c = 0; c < 3; ++c )
+    {
+    pix[c] = static_cast< float >( value ) + 0.25f * c;
+    }
+}
+
+// Compare the buffered region of image with the pixels of original.
+template< typename TImage >
+bool SameBufferedPixels(const TImage *image, const TImage *original)
+{
+  itk::ImageRegionConstIteratorWithIndex< TImage > it( image, image->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != original->GetPixel( it.GetIndex() ) )
+      {
+      std::cerr << "Pixel " << it.GetIndex() << " is " << it.Get()
+                << ", expected " << original->GetPixel( it.GetIndex() ) << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+template< typename TPixel >
+int StreamingReadTest(const std::string & fileName, bool useCompression, bool expectStreaming)
+{
+  typedef itk::Image< TPixel, 3 > ImageType;
+
+  typename ImageType::SizeType size;
+  size[0] = 11;
+  size[1] = 7;
+  size[2] = 5;
+  typename ImageType::RegionType region(size);
+
+  typename ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  TPixel *buffer = image->GetBufferPointer();
+  for ( unsigned long i = 0; i < region.GetNumberOfPixels(); ++i )
+    {
+    SetTestPixel(buffer[i], i);
+    }
+
+  typedef itk::ImageFileWriter< ImageType > WriterType;
+  typename WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  writer->SetUseCompression(useCompression);
+  writer->Update();
+
+  typedef itk::ImageFileReader< ImageType > ReaderType;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->UseStreamingOn();
+
+  // Stream the whole image in slabs.
+  typedef itk::PipelineMonitorImageFilter< ImageType > MonitorType;
+  typename MonitorType::Pointer monitor = MonitorType::New();
+  monitor->SetInput( reader->GetOutput() );
+
+  typedef itk::StreamingImageFilter< ImageType, ImageType > StreamingType;
+  typename StreamingType::Pointer streamer = StreamingType::New();
+  streamer->SetInput( monitor->GetOutput() );
+  streamer->SetNumberOfStreamDivisions(5);
+  streamer->Update();
+
+  if ( expectStreaming ? !monitor->VerifyAllInputCanStream(5) : !monitor->VerifyAllInputCanNotStream() )
+    {
+    std::cerr << fileName << ": unexpected streaming behavior" << std::endl;
+    std::cerr << monitor;
+    return EXIT_FAILURE;
+    }
+  if ( !SameBufferedPixels< ImageType >(streamer->GetOutput(), image) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Read a sub-region that is not contiguous in the file.
+  typename ImageType::IndexType subIndex;
+  subIndex[0] = 3;
+  subIndex[1] = 2;
+  subIndex[2] = 1;
+  typename ImageType::SizeType subSize;
+  subSize[0] = 4;
+  subSize[1] = 3;
+  subSize[2] = 3;
+  typename ImageType::RegionType subRegion(subIndex, subSize);
+
+  reader->Modified();
+  reader->GetOutput()->SetRequestedRegion(subRegion);
+  reader->GetOutput()->Update();
+
+  if ( expectStreaming && reader->GetOutput()->GetBufferedRegion() != subRegion )
+    {
+    std::cerr << fileName << ": buffered region " << reader->GetOutput()->GetBufferedRegion()
+              << " is not the requested region " << subRegion << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( !SameBufferedPixels< ImageType >(reader->GetOutput(), image) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
+}
+
+int itkImageIOStreamingReadTest(int argc, char *argv[])
+{
+  if ( argc < 6 )
+    {
+    std::cerr << "Usage: " << argv[0]
+              << " outputBase extension detachedExtension compressedExtension compressedCanStream(0|1)"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string prefix = argv[1];
+  const std::string extension = argv[2];
+  const std::string detachedExtension = argv[3];
+  const std::string compressedExtension = argv[4];
+  const bool        compressedCanStream = atoi(argv[5]) != 0;
+
+  int result = EXIT_SUCCESS;
+  try
+    {
+    // attached and detached raw data
+    result |= StreamingReadTest< short >(prefix + "Short." + extension, false, true);
+    result |= StreamingReadTest< float >(prefix + "Float." + detachedExtension, false, true);
+    result |= StreamingReadTest< itk::Vector< float, 3 > >(prefix + "Vector." + extension, false, true);
+    // compressed data is either decompressed up to the end of each
+    // region, or read as a whole
+    result |= StreamingReadTest< short >(prefix + "Compressed." + compressedExtension, true,
+                                         compressedCanStream);
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cerr << err << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if ( result == EXIT_SUCCESS )
+    {
+    std::cout << "Test passed." << std::endl;
+    }
+  return result;
+}
@@ -0,0 +1,230 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageSeriesReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageIOFactory.h"
+#include "itkImageRegionIterator.h"
+#include "itkMetaDataObject.h"
+#include <sstream>
+
+// Reads the same series sequentially and with several reading threads,
+// and checks that the pixels and the MetaDataDictionaryArray agree.
+
+namespace
+{
+typedef unsigned short                  PixelType;
+typedef itk::Image< PixelType, 2 >      SliceType;
+typedef itk::Image< PixelType, 3 >      VolumeType;
+typedef itk::ImageSeriesReader< VolumeType > SeriesReaderType;
+
+const char * const SliceKey = "SeriesTestSliceNumber";
+
+int CompareSeries(const SeriesReaderType::FileNamesContainer & fileNames,
+                  bool reverseOrder,
+                  itk::ThreadIdType numberOfReadingThreads)
+{
+  const int numberOfFiles = static_cast< int >( fileNames.size() );
+
+  SeriesReaderType::Pointer sequentialReader = SeriesReaderType::New();
+  sequentialReader->SetFileNames(fileNames);
+  sequentialReader->SetReverseOrder(reverseOrder);
+  sequentialReader->Update();
+
+  SeriesReaderType::Pointer parallelReader = SeriesReaderType::New();
+  parallelReader->SetFileNames(fileNames);
+  parallelReader->SetReverseOrder(reverseOrder);
+  parallelReader->SetNumberOfReadingThreads(numberOfReadingThreads);
+  parallelReader->Update();
+
+  std::cout << "ReverseOrder: " << reverseOrder
+            << " NumberOfReadingThreads: " << parallelReader->GetNumberOfReadingThreads()
+            << std::endl;
+
+  if ( parallelReader->GetOutput()->GetLargestPossibleRegion()
+       != sequentialReader->GetOutput()->GetLargestPossibleRegion() )
+    {
+    std::cerr << "Region mismatch" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itk::ImageRegionConstIterator< VolumeType > sit( sequentialReader->GetOutput(),
+                                                   sequentialReader->GetOutput()->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< VolumeType > pit( parallelReader->GetOutput(),
+                                                   parallelReader->GetOutput()->GetLargestPossibleRegion() );
+  for (; !sit.IsAtEnd(); ++sit, ++pit )
+    {
+    const int slice = reverseOrder ? numberOfFiles - 1 - sit.GetIndex()[2] : sit.GetIndex()[2];
+    const PixelType expected =
+      static_cast< PixelType >( slice * 1000 + sit.GetIndex()[0] + 13 * sit.GetIndex()[1] );
+    if ( sit.Get() != expected || pit.Get() != expected )
+      {
+      std::cerr << "Pixel mismatch at " << sit.GetIndex() << ": expected " << expected
+                << ", sequential " << sit.Get() << ", parallel " << pit.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  const SeriesReaderType::DictionaryArrayType & dictionaries =
+    *parallelReader->GetMetaDataDictionaryArray();
+  if ( dictionaries.size() != fileNames.size() )
+    {
+    std::cerr << "Expected " << fileNames.size() << " dictionaries, got "
+              << dictionaries.size() << std::endl;
+    return EXIT_FAILURE;
+    }
+  for ( int i = 0; i < numberOfFiles; ++i )
+    {
+    std::string value;
+    std::ostringstream expected;
+    expected << ( reverseOrder ? numberOfFiles - 1 - i : i );
+    if ( !itk::ExposeMetaData< std::string >( *dictionaries[i], SliceKey, value )
+         || value != expected.str() )
+      {
+      std::cerr << "Dictionary " << i << " holds slice \"" << value
+                << "\", expected " << expected.str() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
+}
+
+int itkImageSeriesReaderParallelTest(int argc, char *argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const int numberOfFiles = 24;
+
+  SeriesReaderType::FileNamesContainer fileNames;
+  for ( int i = 0; i < numberOfFiles; ++i )
+    {
+    SliceType::Pointer slice = SliceType::New();
+    SliceType::SizeType size;
+    size[0] = 13;
+    size[1] = 11;
+    slice->SetRegions(size);
+    slice->Allocate();
+
+    itk::ImageRegionIterator< SliceType > it( slice, slice->GetLargestPossibleRegion() );
+    for (; !it.IsAtEnd(); ++it )
+      {
+      it.Set( static_cast< PixelType >( i * 1000 + it.GetIndex()[0] + 13 * it.GetIndex()[1] ) );
+      }
+
+    std::ostringstream sliceNumber;
+    sliceNumber << i;
+    itk::EncapsulateMetaData< std::string >( slice->GetMetaDataDictionary(), SliceKey, sliceNumber.str() );
+
+    std::ostringstream fileName;
+    fileName << argv[1] << "/itkImageSeriesReaderParallelTest_" << i << ".mha";
+    fileNames.push_back( fileName.str() );
+
+    itk::ImageFileWriter< SliceType >::Pointer writer = itk::ImageFileWriter< SliceType >::New();
+    writer->SetInput(slice);
+    writer->SetFileName( fileName.str() );
+    try
+      {
+      writer->Update();
+      }
+    catch ( itk::ExceptionObject & e )
+      {
+      std::cerr << e << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  try
+    {
+    if ( CompareSeries(fileNames, false, 4) != EXIT_SUCCESS
+         || CompareSeries(fileNames, true, 4) != EXIT_SUCCESS
+         || CompareSeries(fileNames, false, 2 * numberOfFiles) != EXIT_SUCCESS )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // a series read with an ImageIO set by the user is read sequentially
+  // with that ImageIO, which keeps the state of the last file
+  itk::ImageIOBase::Pointer imageIO =
+    itk::ImageIOFactory::CreateImageIO( fileNames[0].c_str(), itk::ImageIOFactory::ReadMode );
+  SeriesReaderType::Pointer ioReader = SeriesReaderType::New();
+  ioReader->SetFileNames(fileNames);
+  ioReader->SetImageIO(imageIO);
+  ioReader->SetNumberOfReadingThreads(4);
+  try
+    {
+    ioReader->Update();
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string lastSlice;
+  std::ostringstream expectedLastSlice;
+  expectedLastSlice << numberOfFiles - 1;
+  if ( !itk::ExposeMetaData< std::string >( imageIO->GetMetaDataDictionary(), SliceKey, lastSlice )
+       || lastSlice != expectedLastSlice.str() )
+    {
+    std::cerr << "The ImageIO holds slice \"" << lastSlice << "\", expected "
+              << expectedLastSlice.str() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // an error in one of the reading threads is reported by Update(), with
+  // the type of the exception that was thrown
+  SeriesReaderType::FileNamesContainer missingFileNames = fileNames;
+  missingFileNames[numberOfFiles / 2] = std::string( argv[1] ) + "/itkImageSeriesReaderParallelTest_missing.mha";
+
+  SeriesReaderType::Pointer reader = SeriesReaderType::New();
+  reader->SetFileNames(missingFileNames);
+  reader->SetNumberOfReadingThreads(4);
+  bool caught = false;
+  try
+    {
+    reader->Update();
+    }
+  catch ( itk::ImageFileReaderException & e )
+    {
+    std::cout << "Expected exception: " << e.GetDescription() << std::endl;
+    caught = true;
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << "Unexpected exception type: " << e << std::endl;
+    return EXIT_FAILURE;
+    }
+  if ( !caught )
+    {
+    std::cerr << "A missing file did not raise an exception" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
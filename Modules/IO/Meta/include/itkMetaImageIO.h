@@ -69,6 +69,11 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void *buffer);
 
+  /** Uncompressed binary data, stored in the header file (LOCAL) or in a
+   * single data file in the byte order of this machine, can be memory
+   * mapped. */
+  virtual bool GetMappableDataFile(std::string & fileName, SizeType & dataPosition);
+
   MetaImage * GetMetaImagePointer(void);
 
   /*-------- This part of the interfaces deals with writing data. ----- */
@@ -115,11 +120,12 @@ public:
                            const ImageIORegion & largestPossibleRegion);
 
   /** Determine if the ImageIO can stream reading from this
-   *  file. Only time cannot stream read/write is if compression is used.
+   *  file. Only time cannot stream read/write is if compression is used,
+   *  unless the data were compressed as independent blocks.
    *  CanRead must be called prior to this function. */
   virtual bool CanStreamRead()
   {
-    if ( m_MetaImage.CompressedData() )
+    if ( m_MetaImage.CompressedData() && !m_BlockCompressedData )
       {
       return false;
       }
@@ -145,6 +151,15 @@ public:
    * \warning this is only used when streaming is on. */
   itkSetMacro(SubSamplingFactor, unsigned int);
   itkGetConstMacro(SubSamplingFactor, unsigned int);
+
+  /** Set/Get whether compressed data are written as independently
+   * deflated blocks (see BlockGzipCodec).  The blocks are compressed on
+   * several threads and the file remains readable by any MetaImage
+   * reader, while files written this way are decompressed on several
+   * threads and can be streamed.  Off by default. */
+  itkSetMacro(UseBlockCompression, bool);
+  itkGetConstMacro(UseBlockCompression, bool);
+  itkBooleanMacro(UseBlockCompression);
 protected:
   MetaImageIO();
   ~MetaImageIO();
@@ -157,7 +172,19 @@ private:
   MetaImageIO(const Self &);    //purposely not implemented
   void operator=(const Self &); //purposely not implemented
 
+  /** Locate the element data: the header file for LOCAL data or the
+   * single data file, and the position of the data in it.  dataSize is
+   * needed for a HeaderSize of -1, 0 when unknown. */
+  bool GetElementDataFile(std::string & fileName, SizeType & dataPosition,
+                          SizeType dataSize) const;
+
+  /** Decode the IORegion of block compressed data into buffer. */
+  void ReadBlockCompressedData(void *buffer);
+
   unsigned int m_SubSamplingFactor;
+
+  bool m_UseBlockCompression;
+  bool m_BlockCompressedData;
 };
 } // end namespace itk
 
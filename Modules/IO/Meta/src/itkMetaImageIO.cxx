@@ -20,6 +20,7 @@
 #include "itkSpatialOrientationAdapter.h"
 #include "itkMetaDataObject.h"
 #include "itkIOCommon.h"
+#include "itkBlockGzipCodec.h"
 #include "itksys/SystemTools.hxx"
 
 namespace itk
@@ -28,6 +29,8 @@ MetaImageIO::MetaImageIO()
 {
   m_FileType = Binary;
   m_SubSamplingFactor = 1;
+  m_UseBlockCompression = false;
+  m_BlockCompressedData = false;
   if ( MET_SystemByteOrderMSB() )
     {
     m_ByteOrder = BigEndian;
@@ -52,6 +55,8 @@ void MetaImageIO::PrintSelf(std::ostream & os, Indent indent) const
   Superclass::PrintSelf(os, indent);
   m_MetaImage.PrintInfo();
   os << indent << "SubSamplingFactor: " << m_SubSamplingFactor << "\n";
+  os << indent << "UseBlockCompression: " << m_UseBlockCompression << "\n";
+  os << indent << "BlockCompressedData: " << m_BlockCompressedData << "\n";
 }
 
 void MetaImageIO::SetDataFileName(const char *filename)
@@ -416,10 +421,35 @@ void MetaImageIO::ReadImageInformation()
     EncapsulateMetaData< std::string >(
       metaDict, ITK_ExperimentDate, std::string( m_MetaImage.AcquisitionDate() ) );
     }
+
+  //
+  // Data compressed as independent blocks can be read on several threads
+  // and streamed
+  //
+  m_BlockCompressedData = false;
+  std::string dataFileName;
+  SizeType    dataPosition;
+  if ( m_MetaImage.CompressedData() && m_MetaImage.BinaryData()
+       && this->GetElementDataFile(dataFileName, dataPosition, 0) )
+    {
+    std::ifstream file(dataFileName.c_str(), std::ios::in | std::ios::binary);
+    file.seekg(dataPosition, std::ios::beg);
+
+    BlockGzipCodec::Pointer codec = BlockGzipCodec::New();
+    m_BlockCompressedData = file.good() && codec->ReadIndex(file)
+                            && codec->GetUncompressedSize() ==
+                            static_cast< SizeValueType >( this->GetImageSizeInBytes() );
+    }
 }
 
 void MetaImageIO::Read(void *buffer)
 {
+  if ( m_BlockCompressedData && m_SubSamplingFactor == 1 )
+    {
+    this->ReadBlockCompressedData(buffer);
+    return;
+    }
+
   const unsigned int nDims = this->GetNumberOfDimensions();
 
   // this will check to see if we are actually streaming
@@ -487,6 +517,149 @@ void MetaImageIO::Read(void *buffer)
     }
 }
 
+bool MetaImageIO::GetMappableDataFile(std::string & fileName, SizeType & dataPosition)
+{
+  if ( m_MetaImage.CompressedData() || !m_MetaImage.BinaryData()
+       || m_SubSamplingFactor != 1 )
+    {
+    return false;
+    }
+
+  // Read() swaps the bytes unless the order is the one of this machine
+  if ( this->GetComponentSize() > 1
+       && m_MetaImage.BinaryDataByteOrderMSB() != MET_SystemByteOrderMSB() )
+    {
+    return false;
+    }
+
+  return this->GetElementDataFile( fileName, dataPosition, this->GetImageSizeInBytes() );
+}
+
+bool MetaImageIO::GetElementDataFile(std::string & fileName, SizeType & dataPosition,
+                                     SizeType dataSize) const
+{
+  // lists and patterns of slice files are not a single data file
+  const std::string elementDataFileName = m_MetaImage.ElementDataFileName();
+  const bool        local = ( elementDataFileName == "LOCAL"
+                              || elementDataFileName == "Local"
+                              || elementDataFileName == "local" );
+  if ( local )
+    {
+    fileName = m_FileName;
+    }
+  else if ( elementDataFileName.compare(0, 4, "LIST") == 0
+            || elementDataFileName.find('%') != std::string::npos )
+    {
+    return false;
+    }
+  else if ( itksys::SystemTools::FileIsFullPath( elementDataFileName.c_str() ) )
+    {
+    fileName = elementDataFileName;
+    }
+  else
+    {
+    fileName = itksys::SystemTools::GetFilenamePath(m_FileName);
+    if ( !fileName.empty() )
+      {
+      fileName += "/";
+      }
+    fileName += elementDataFileName;
+    }
+
+  // see MetaImage::M_ReadElements
+  if ( m_MetaImage.HeaderSize() > 0 )
+    {
+    dataPosition = m_MetaImage.HeaderSize();
+    }
+  else if ( m_MetaImage.HeaderSize() == -1 )
+    {
+    const SizeType fileLength =
+      static_cast< SizeType >( itksys::SystemTools::FileLength( fileName.c_str() ) );
+    // a truncated file cannot hold the data
+    if ( dataSize == 0 || fileLength < dataSize )
+      {
+      return false;
+      }
+    dataPosition = fileLength - dataSize;
+    }
+  else if ( !local )
+    {
+    dataPosition = 0;
+    }
+  else
+    {
+    // the data follows the header
+    std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+    MetaImage     header;
+    if ( !file.is_open() || !header.ReadStream(0, &file, false) )
+      {
+      return false;
+      }
+    const std::streamoff position = file.tellg();
+    if ( position < 0 )
+      {
+      return false;
+      }
+    dataPosition = static_cast< SizeType >( position );
+    }
+  return true;
+}
+
+void MetaImageIO::ReadBlockCompressedData(void *buffer)
+{
+  std::string fileName;
+  SizeType    dataPosition;
+  if ( !this->GetElementDataFile(fileName, dataPosition, 0) )
+    {
+    itkExceptionMacro("Cannot locate the compressed data of " << m_FileName);
+    }
+
+  std::ifstream file( fileName.c_str(), std::ios::in | std::ios::binary );
+  if ( !file.is_open() )
+    {
+    itkExceptionMacro("Cannot open " << fileName);
+    }
+  file.seekg(dataPosition, std::ios::beg);
+
+  BlockGzipCodec::Pointer codec = BlockGzipCodec::New();
+  if ( !codec->ReadIndex(file) )
+    {
+    itkExceptionMacro("Missing block index in the compressed data of " << fileName);
+    }
+
+  const unsigned int nDims = this->GetNumberOfDimensions();
+  ImageIORegion      region(nDims);
+  std::vector< SizeValueType > dimensions(nDims);
+  for ( unsigned int i = 0; i < nDims; i++ )
+    {
+    dimensions[i] = this->GetDimensions(i);
+    if ( m_IORegion.GetImageDimension() == 0 )
+      {
+      // not streaming
+      region.SetIndex(i, 0);
+      region.SetSize(i, dimensions[i]);
+      }
+    else if ( i < m_IORegion.GetImageDimension() )
+      {
+      region.SetIndex( i, m_IORegion.GetIndex(i) );
+      region.SetSize( i, m_IORegion.GetSize(i) );
+      }
+    else
+      {
+      region.SetIndex(i, 0);
+      region.SetSize(i, 1);
+      }
+    }
+  codec->ReadRegion(file, region, dimensions,
+                    this->GetComponentSize() * this->GetNumberOfComponents(), buffer);
+
+  // swap the bytes to the order of this machine
+  const SizeValueType numberOfComponents =
+    static_cast< SizeValueType >( region.GetNumberOfPixels() ) * this->GetNumberOfComponents();
+  this->SwapBytesToSystemByteOrder( buffer, numberOfComponents,
+                                    m_MetaImage.BinaryDataByteOrderMSB() ? BigEndian : LittleEndian );
+}
+
 MetaImage * MetaImageIO::GetMetaImagePointer(void)
 {
   return &m_MetaImage;
@@ -1073,7 +1246,18 @@ MetaImageIO
     }
   else
     {
-    if ( !m_MetaImage.Write( m_FileName.c_str() ) )
+    // compress the data as independent blocks on several threads
+    std::vector< char > compressedData;
+    if ( m_UseCompression && m_UseBlockCompression && binaryData )
+      {
+      BlockGzipCodec::Pointer codec = BlockGzipCodec::New();
+      codec->Compress( buffer, this->GetImageSizeInBytes(), compressedData );
+      m_MetaImage.CompressedElementData( &compressedData[0], compressedData.size() );
+      }
+
+    const bool written = m_MetaImage.Write( m_FileName.c_str() );
+    m_MetaImage.CompressedElementData(NULL, 0);
+    if ( !written )
       {
       itkExceptionMacro( "File cannot be written: "
                          << this->GetFileName()
@@ -0,0 +1,225 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#define SPECIFIC_IMAGEIO_MODULE_TEST
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkMemoryMappedBufferAllocator.h"
+#include "itkMetaImageIO.h"
+#include "itksys/SystemTools.hxx"
+
+#include <fstream>
+
+namespace
+{
+typedef itk::Image< short, 3 > ShortImageType;
+typedef itk::Image< float, 3 > FloatImageType;
+
+template< class TImage >
+typename TImage::Pointer
+ReadMetaImage(const std::string & fileName, bool useMemoryMapping)
+{
+  typedef itk::ImageFileReader< TImage > ReaderType;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO( itk::MetaImageIO::New() );
+  reader->SetUseMemoryMapping(useMemoryMapping);
+  reader->Update();
+  return reader->GetOutput();
+}
+
+// Only pixel data at a 64 byte aligned position of the file is mapped.
+bool IsMappable(const std::string & fileName)
+{
+  itk::MetaImageIO::Pointer io = itk::MetaImageIO::New();
+  io->SetFileName(fileName);
+  io->ReadImageInformation();
+
+  std::string                dataFileName;
+  itk::ImageIOBase::SizeType dataPosition = 0;
+  return io->GetMappableDataFile(dataFileName, dataPosition) && dataPosition % 64 == 0;
+}
+
+// A data file shorter than the pixel data it should end with has no
+// data position.
+bool TruncatedDataFileIsMappable(const std::string & prefix)
+{
+  const std::string headerFileName = prefix + "Truncated.mhd";
+  const std::string dataFileName = prefix + "Truncated.raw";
+
+  std::ofstream header( headerFileName.c_str() );
+  header << "ObjectType = Image\n"
+         << "NDims = 3\n"
+         << "DimSize = 37 29 7\n"
+         << "ElementType = MET_SHORT\n"
+         << "HeaderSize = -1\n"
+         << "ElementDataFile = " << itksys::SystemTools::GetFilenameName(dataFileName) << "\n";
+  header.close();
+
+  std::ofstream data( dataFileName.c_str(), std::ios::out | std::ios::binary );
+  const std::vector< char > bytes(100, 0);
+  data.write( &bytes[0], bytes.size() );
+  data.close();
+
+  itk::MetaImageIO::Pointer io = itk::MetaImageIO::New();
+  io->SetFileName(headerFileName);
+  io->ReadImageInformation();
+
+  std::string                mappedFileName;
+  itk::ImageIOBase::SizeType dataPosition = 0;
+  return io->GetMappableDataFile(mappedFileName, dataPosition);
+}
+
+template< class TImage >
+bool IsMapped(TImage *image)
+{
+  return dynamic_cast< itk::MemoryMappedBufferAllocator * >(
+    image->GetPixelContainer()->GetBufferAllocator() ) != 0;
+}
+
+template< class TImage >
+bool SameValues(const ShortImageType *expected, const TImage *image)
+{
+  itk::ImageRegionConstIterator< ShortImageType > it( expected, expected->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< TImage >         it2( image, image->GetLargestPossibleRegion() );
+  for ( it.GoToBegin(), it2.GoToBegin(); !it.IsAtEnd(); ++it, ++it2 )
+    {
+    if ( it2.IsAtEnd() || static_cast< double >( it.Get() ) != static_cast< double >( it2.Get() ) )
+      {
+      return false;
+      }
+    }
+  return it2.IsAtEnd();
+}
+
+int CheckRead(const ShortImageType *image, const std::string & fileName, bool expectMapped)
+{
+  int result = EXIT_SUCCESS;
+
+  // copy-on-write mapping
+  ShortImageType::Pointer mapped = ReadMetaImage< ShortImageType >(fileName, true);
+  if ( IsMapped( mapped.GetPointer() ) != expectMapped )
+    {
+    std::cout << fileName << ": expected " << ( expectMapped ? "a" : "no" )
+              << " mapped buffer" << std::endl;
+    result = EXIT_FAILURE;
+    }
+  if ( !SameValues( image, mapped.GetPointer() ) )
+    {
+    std::cout << fileName << ": pixel values differ" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // writing to the buffer does not change the file
+  ShortImageType::IndexType index;
+  index.Fill(1);
+  mapped->SetPixel(index, -1);
+  ShortImageType::Pointer reread = ReadMetaImage< ShortImageType >(fileName, false);
+  if ( IsMapped( reread.GetPointer() ) || !SameValues( image, reread.GetPointer() ) )
+    {
+    std::cout << fileName << ": modifying the mapped buffer changed the file" << std::endl;
+    result = EXIT_FAILURE;
+    }
+
+  // a conversion is never mapped
+  FloatImageType::Pointer converted = ReadMetaImage< FloatImageType >(fileName, true);
+  if ( IsMapped( converted.GetPointer() ) || !SameValues( image, converted.GetPointer() ) )
+    {
+    std::cout << fileName << ": converted read failed" << std::endl;
+    result = EXIT_FAILURE;
+    }
+  return result;
+}
+
+void WriteMetaImage(const ShortImageType *image, const std::string & fileName, bool compress)
+{
+  typedef itk::ImageFileWriter< ShortImageType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(fileName);
+  writer->SetImageIO( itk::MetaImageIO::New() );
+  writer->SetInput(image);
+  writer->SetUseCompression(compress);
+  writer->Update();
+}
+}
+
+int itkMetaImageIOMemoryMappingTest(int argc, char *argv[])
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string prefix = std::string(argv[1]) + "/MetaImageIOMemoryMapping";
+
+  ShortImageType::SizeType size;
+  size[0] = 37;
+  size[1] = 29;
+  size[2] = 7;
+  ShortImageType::RegionType region(size);
+  ShortImageType::Pointer    image = ShortImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  short value = 0;
+  itk::ImageRegionIterator< ShortImageType > it(image, region);
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it, value += 3 )
+    {
+    it.Set(value);
+    }
+
+  int result = EXIT_SUCCESS;
+  try
+    {
+    // pixels following the header, mapped only when the header length
+    // keeps them aligned
+    WriteMetaImage(image, prefix + ".mha", false);
+    if ( CheckRead(image, prefix + ".mha", IsMappable(prefix + ".mha")) != EXIT_SUCCESS )
+      {
+      result = EXIT_FAILURE;
+      }
+
+    // pixels in a separate data file
+    WriteMetaImage(image, prefix + ".mhd", false);
+    if ( CheckRead(image, prefix + ".mhd", true) != EXIT_SUCCESS )
+      {
+      result = EXIT_FAILURE;
+      }
+
+    // compressed pixels are read
+    WriteMetaImage(image, prefix + "Compressed.mha", true);
+    if ( CheckRead(image, prefix + "Compressed.mha", false) != EXIT_SUCCESS )
+      {
+      result = EXIT_FAILURE;
+      }
+
+    if ( TruncatedDataFileIsMappable(prefix) )
+      {
+      std::cout << "a truncated data file was reported as mappable" << std::endl;
+      result = EXIT_FAILURE;
+      }
+    }
+  catch ( itk::ExceptionObject & err )
+    {
+    std::cerr << "Exception caught: " << err << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return result;
+}
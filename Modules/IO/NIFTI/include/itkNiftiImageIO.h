@@ -71,6 +71,11 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void *buffer);
 
+  /** Any region of the image can be read.  For uncompressed files only
+   * the rows of the region are read from disk; compressed files are
+   * decompressed up to the end of the region. */
+  virtual bool CanStreamRead() { return true; }
+
   /*-------- This part of the interfaces deals with writing data. ----- */
 
   /** Determine if the file can be written with this ImageIO implementation.
@@ -344,6 +344,10 @@ ImageIORegion
 NiftiImageIO
 ::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const
 {
+  if ( !m_UseStreamedReading )
+    {
+    return Superclass::GenerateStreamableReadRegionFromRequestedRegion(requestedRegion);
+    }
   return requestedRegion;
 }
 
@@ -437,7 +441,7 @@ void NiftiImageIO::Read(void *buffer)
   ImageIORegion::SizeType  size = regionToRead.GetSize();
   ImageIORegion::IndexType start = regionToRead.GetIndex();
 
-  int          numElts = 1;
+  size_t       numElts = 1;
   int          _origin[7];
   int          _size[7];
   unsigned int i;
@@ -463,8 +467,11 @@ void NiftiImageIO::Read(void *buffer)
     // other dims out of the way
     _size[6] = _size[5];
     _size[5] = _size[4];
+    _origin[6] = _origin[5];
+    _origin[5] = _origin[4];
     // sizes = x y z t vecsize
     _size[4] = numComponents;
+    _origin[4] = 0;
     }
   // Free memory if any was occupied already (incase of re-using the IO filter).
   if ( this->m_NiftiImage != NULL )
@@ -527,9 +534,9 @@ void NiftiImageIO::Read(void *buffer)
       static_cast< unsigned int >( this->GetNumberOfComponents() )
       * static_cast< unsigned int >( sizeof( float ) );
 
-    // Deal with correct management of 64bits platforms
-    const size_t imageSizeInComponents =
-      static_cast< size_t >( this->GetImageSizeInComponents() );
+    // Deal with correct management of 64bits platforms; only the
+    // requested region has been read
+    const size_t imageSizeInComponents = numElts * numComponents;
 
     //
     // allocate new buffer for floats. Malloc instead of new to
@@ -602,12 +609,14 @@ void NiftiImageIO::Read(void *buffer)
     {
     // otherwise nifti is x y z t vec l m 0, itk is
     // vec x y z t l m o
+    // the data holds the requested region only, so the loops run over
+    // the region size rather than the image size
     const char *       niftibuf = (const char *)data;
     char *             itkbuf = (char *)buffer;
-    const unsigned int rowdist = this->m_NiftiImage->dim[1];
-    const unsigned int slicedist = rowdist * this->m_NiftiImage->dim[2];
-    const unsigned int volumedist = slicedist * this->m_NiftiImage->dim[3];
-    const unsigned int seriesdist = volumedist * this->m_NiftiImage->dim[4];
+    const size_t       rowdist = _size[0];
+    const size_t       slicedist = rowdist * _size[1];
+    const size_t       volumedist = slicedist * _size[2];
+    const size_t       seriesdist = volumedist * _size[3];
     //
     // as per ITK bug 0007485
     // NIfTI is lower triangular, ITK is upper triangular.
@@ -626,19 +635,19 @@ void NiftiImageIO::Read(void *buffer)
         vecOrder[i] = i;
         }
       }
-    for ( int t = 0; t < this->m_NiftiImage->dim[4]; t++ )
+    for ( int t = 0; t < _size[3]; t++ )
       {
-      for ( int z = 0; z < this->m_NiftiImage->dim[3]; z++ )
+      for ( int z = 0; z < _size[2]; z++ )
         {
-        for ( int y = 0; y < this->m_NiftiImage->dim[2]; y++ )
+        for ( int y = 0; y < _size[1]; y++ )
           {
-          for ( int x = 0; x < this->m_NiftiImage->dim[1]; x++ )
+          for ( int x = 0; x < _size[0]; x++ )
             {
             for ( unsigned int c = 0; c < numComponents; c++ )
               {
-              const unsigned int nifti_index =
+              const size_t nifti_index =
                 ( c * seriesdist + volumedist * t + slicedist * z + rowdist * y + x ) * pixelSize;
-              const unsigned int itk_index =
+              const size_t itk_index =
                 ( ( volumedist * t + slicedist * z + rowdist * y + x ) * numComponents + vecOrder[c] ) * pixelSize;
               memcpy(itkbuf + itk_index, niftibuf + nifti_index, pixelSize);
               }
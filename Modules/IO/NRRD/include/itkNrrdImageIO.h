@@ -19,7 +19,7 @@
 #define __itkNrrdImageIO_h
 
 
-#include "itkImageIOBase.h"
+#include "itkStreamingImageIOBase.h"
 #include <fstream>
 
 namespace itk
@@ -30,22 +30,26 @@ namespace itk
  * The Nrrd format was developed as part of the Teem package
  * (teem.sourceforge.net).
  *
+ * Files with raw encoding and a single (attached or detached) data file
+ * can be read region by region: when the IORegion is smaller than the
+ * image, only the requested region is read from the data file.
+ *
  *  \ingroup IOFilters
  * \ingroup ITKIONRRD
  */
-class ITK_EXPORT NrrdImageIO:public ImageIOBase
+class ITK_EXPORT NrrdImageIO:public StreamingImageIOBase
 {
 public:
   /** Standard class typedefs. */
   typedef NrrdImageIO          Self;
-  typedef ImageIOBase          Superclass;
+  typedef StreamingImageIOBase Superclass;
   typedef SmartPointer< Self > Pointer;
 
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
 
   /** Run-time type information (and related methods). */
-  itkTypeMacro(NrrdImageIO, ImageIOBase);
+  itkTypeMacro(NrrdImageIO, StreamingImageIOBase);
 
   /** The different types of ImageIO's can support data of varying
    * dimensionality. For example, some file formats are strictly 2D
@@ -64,6 +68,13 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void *buffer);
 
+  /** Returns true for raw encoded or block compressed gzip data in a
+   * single data file, once ReadImageInformation() has been called. */
+  virtual bool CanStreamRead(void);
+
+  /** Writing is always done with the whole image. */
+  virtual bool CanStreamWrite(void) { return false; }
+
   /** Determine the file type. Returns true if this ImageIO can write the
    * file specified. */
   virtual bool CanWriteFile(const char *);
@@ -75,6 +86,15 @@ public:
    * that the IORegions has been set properly. */
   virtual void Write(const void *buffer);
 
+  /** When UseCompression is on, write the gzip data as independently
+   * deflated blocks with a block index (see BlockGzipCodec), so that it
+   * is compressed and decompressed by several threads and a requested
+   * region is read without inflating the whole data.  The data remain
+   * readable by any gzip decoder.  Off by default. */
+  itkSetMacro(UseBlockCompression, bool);
+  itkGetConstMacro(UseBlockCompression, bool);
+  itkBooleanMacro(UseBlockCompression);
+
 protected:
   NrrdImageIO();
   ~NrrdImageIO();
@@ -86,9 +106,23 @@ protected:
 
   ImageIOBase::IOComponentType NrrdToITKComponentType(const int) const;
 
+  /** Position of the raw data in m_DataFileName. */
+  virtual SizeType GetHeaderSize(void) const { return m_DataPosition; }
+
 private:
   NrrdImageIO(const Self &);    //purposely not implemented
   void operator=(const Self &); //purposely not implemented
+
+  /** Decompress the IORegion out of block compressed data. */
+  void ReadBlockCompressedData(void *buffer);
+
+  /** File holding the raw or block compressed data, empty when the data
+   * cannot be read region by region. */
+  std::string m_DataFileName;
+  SizeType    m_DataPosition;
+  bool        m_BlockCompressedData;
+
+  bool m_UseBlockCompression;
 };
 } // end namespace itk
 
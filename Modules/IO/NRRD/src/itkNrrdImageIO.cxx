@@ -22,12 +22,16 @@
 #include "itkMetaDataObject.h"
 #include "itkIOCommon.h"
 #include "itkFloatingPointExceptions.h"
+#include "itkBlockGzipCodec.h"
 
 namespace itk
 {
 #define KEY_PREFIX "NRRD_"
 
-NrrdImageIO::NrrdImageIO()
+NrrdImageIO::NrrdImageIO():
+  m_DataPosition(0),
+  m_BlockCompressedData(false),
+  m_UseBlockCompression(false)
 {
   this->SetNumberOfDimensions(3);
   this->AddSupportedWriteExtension(".nrrd");
@@ -55,6 +59,17 @@ bool NrrdImageIO::SupportsDimension(unsigned long dim)
 void NrrdImageIO::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "DataFileName: " << m_DataFileName << std::endl;
+  os << indent << "DataPosition: " << m_DataPosition << std::endl;
+  os << indent << "BlockCompressedData: " << m_BlockCompressedData << std::endl;
+  os << indent << "UseBlockCompression: " << m_UseBlockCompression << std::endl;
+}
+
+bool NrrdImageIO::CanStreamRead(void)
+{
+  // Masked tensors need the whole data for cropping out the mask.
+  return !m_DataFileName.empty()
+         && this->GetPixelType() != ImageIOBase::SYMMETRICSECONDRANKTENSOR;
 }
 
 ImageIOBase::IOComponentType
@@ -246,6 +261,9 @@ void NrrdImageIO::ReadImageInformation()
     // this is the mechanism by which we tell nrrdLoad to read
     // just the header, and none of the data
     nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+    // with a single data file, nrrdLoad leaves it open and positioned at
+    // the start of the data, past any line and byte skips
+    nrrdIoStateSet(nio, nrrdIoStateKeepNrrdDataFileOpen, 1);
     if ( nrrdLoad(nrrd, this->GetFileName(), nio) != 0 )
       {
       char *err = biffGetDone(NRRD);
@@ -262,6 +280,60 @@ void NrrdImageIO::ReadImageInformation()
     // restore state
     FloatingPointExceptions::SetEnabled(saveFPEState);
 
+    // Remember where the raw or block compressed data is, so that Read()
+    // can seek to a requested region instead of loading the whole data.
+    m_DataFileName = "";
+    m_DataPosition = 0;
+    m_BlockCompressedData = false;
+    if ( nio->dataFile )
+      {
+      const long dataPosition = ftell(nio->dataFile);
+      if ( nrrdFormatNRRD == nio->format
+           && ( nrrdEncodingRaw == nio->encoding
+                || ( nrrdEncodingGzip == nio->encoding && 0 == nio->byteSkip ) )
+           && !nio->dataFNFormat
+           && dataPosition >= 0 )
+        {
+        if ( 0 == nio->dataFNArr->len )
+          {
+          // attached header
+          m_DataFileName = this->GetFileName();
+          }
+        else if ( 1 == nio->dataFNArr->len && strcmp(nio->dataFN[0], "-") )
+          {
+          // detached header; relative data file names are relative to
+          // the header, as in nrrdIoStateDataFileIterNext()
+          const char *dataFN = nio->dataFN[0];
+          if ( '/' != dataFN[0] && ':' != dataFN[1] && airStrlen(nio->path) )
+            {
+            m_DataFileName = std::string(nio->path) + "/" + dataFN;
+            }
+          else
+            {
+            m_DataFileName = dataFN;
+            }
+          }
+        m_DataPosition = static_cast< SizeType >( dataPosition );
+        }
+      nio->dataFile = airFclose(nio->dataFile);
+
+      if ( nrrdEncodingGzip == nio->encoding && !m_DataFileName.empty() )
+        {
+        // gzip data can only be read region by region when it carries
+        // a block index
+        std::ifstream file( m_DataFileName.c_str(), std::ios::in | std::ios::binary );
+        file.seekg(m_DataPosition, std::ios::beg);
+        BlockGzipCodec::Pointer codec = BlockGzipCodec::New();
+        m_BlockCompressedData = file.good() && codec->ReadIndex(file)
+                                && codec->GetUncompressedSize() ==
+                                static_cast< SizeValueType >( nrrdElementNumber(nrrd) * nrrdElementSize(nrrd) );
+        if ( !m_BlockCompressedData )
+          {
+          m_DataFileName = "";
+          }
+        }
+      }
+
     if ( nrrdTypeBlock == nrrd->type )
       {
       itkExceptionMacro("ReadImageInformation: Cannot currently "
@@ -313,6 +385,12 @@ void NrrdImageIO::ReadImageInformation()
       }
     // else nrrd->spaceDim == domainAxisNum when nrrd has orientation
 
+    if ( 1 == rangeAxisNum && 0 != rangeAxisIdx[0] )
+      {
+      // Read() has to permute the axes of the whole data
+      m_DataFileName = "";
+      }
+
     if ( 0 == rangeAxisNum )
       {
       // we don't have any non-scalar data
@@ -687,7 +765,12 @@ void NrrdImageIO::ReadImageInformation()
     }
   catch (...)
     {
-    // clean up from an exception
+    // clean up from an exception; the data file is left open by a
+    // failed or interrupted nrrdLoad with nrrdIoStateKeepNrrdDataFileOpen
+    if ( nio->dataFile )
+      {
+      nio->dataFile = airFclose(nio->dataFile);
+      }
     nrrd = nrrdNix(nrrd);
     nio = nrrdIoStateNix(nio);
 
@@ -696,8 +779,61 @@ void NrrdImageIO::ReadImageInformation()
     }
 }
 
+void NrrdImageIO::ReadBlockCompressedData(void *buffer)
+{
+  std::ifstream file;
+  this->OpenFileForReading( file, m_DataFileName.c_str() );
+  file.seekg(m_DataPosition, std::ios::beg);
+
+  BlockGzipCodec::Pointer codec = BlockGzipCodec::New();
+  if ( !codec->ReadIndex(file) )
+    {
+    itkExceptionMacro("Missing block index in the compressed data of " << m_DataFileName);
+    }
+
+  const unsigned int           nDims = this->GetNumberOfDimensions();
+  ImageIORegion                region(nDims);
+  std::vector< SizeValueType > dimensions(nDims);
+  for ( unsigned int i = 0; i < nDims; i++ )
+    {
+    dimensions[i] = this->GetDimensions(i);
+    if ( i < m_IORegion.GetImageDimension() )
+      {
+      region.SetIndex( i, m_IORegion.GetIndex(i) );
+      region.SetSize( i, m_IORegion.GetSize(i) );
+      }
+    else
+      {
+      region.SetIndex(i, 0);
+      region.SetSize(i, 1);
+      }
+    }
+  codec->ReadRegion(file, region, dimensions,
+                    this->GetComponentSize() * this->GetNumberOfComponents(), buffer);
+}
+
 void NrrdImageIO::Read(void *buffer)
 {
+  if ( this->CanStreamRead() && ( m_BlockCompressedData || this->RequestedToStream() ) )
+    {
+    if ( m_BlockCompressedData )
+      {
+      this->ReadBlockCompressedData(buffer);
+      }
+    else
+      {
+      std::ifstream file;
+      this->OpenFileForReading( file, m_DataFileName.c_str() );
+      this->StreamReadBufferAsBinary(file, buffer);
+      }
+
+    const SizeValueType numberOfComponents =
+      static_cast< SizeValueType >( this->GetIORegion().GetNumberOfPixels() )
+      * this->GetNumberOfComponents();
+    this->SwapBytesToSystemByteOrder( buffer, numberOfComponents, this->GetByteOrder() );
+    return;
+    }
+
   Nrrd *       nrrd = nrrdNew();
   unsigned int baseDim;
   bool         nrrdAllocated;
@@ -1074,8 +1210,15 @@ void NrrdImageIO::Write(const void *buffer)
     }
 
   // set encoding for data: compressed (raw), (uncompressed) raw, or ascii
-  if ( this->GetUseCompression() == true
-       && nrrdEncodingGzip->available() )
+  const bool blockCompression = this->GetUseCompression() && m_UseBlockCompression;
+  if ( blockCompression )
+    {
+    // the header says gzip, the data are written below
+    nio->encoding = nrrdEncodingGzip;
+    nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+    }
+  else if ( this->GetUseCompression() == true
+            && nrrdEncodingGzip->available() )
     {
     // this is necessarily gzip-compressed *raw* data
     nio->encoding = nrrdEncodingGzip;
@@ -1120,6 +1263,45 @@ void NrrdImageIO::Write(const void *buffer)
                       << this->GetFileName() << ":\n" << err);
     }
 
+  if ( blockCompression )
+    {
+    // the data follow an attached header, or go to the data file named
+    // in a detached one
+    std::string dataFileName = this->GetFileName();
+    if ( nio->dataFNArr->len )
+      {
+      const char *dataFN = nio->dataFN[0];
+      if ( '/' != dataFN[0] && ':' != dataFN[1] && airStrlen(nio->path) )
+        {
+        dataFileName = std::string(nio->path) + "/" + dataFN;
+        }
+      else
+        {
+        dataFileName = dataFN;
+        }
+      }
+    nrrd = nrrdNix(nrrd);
+    nio = nrrdIoStateNix(nio);
+
+    std::vector< char >     compressedData;
+    BlockGzipCodec::Pointer codec = BlockGzipCodec::New();
+    codec->Compress(buffer, this->GetImageSizeInBytes(), compressedData);
+
+    std::ios::openmode mode = std::ios::out | std::ios::binary;
+    mode |= ( dataFileName == this->GetFileName() ) ? std::ios::app : std::ios::trunc;
+    std::ofstream       file(dataFileName.c_str(), mode);
+    if ( !file.is_open() )
+      {
+      itkExceptionMacro("Write: Cannot open " << dataFileName);
+      }
+    file.write( &compressedData[0], compressedData.size() );
+    if ( file.fail() )
+      {
+      itkExceptionMacro("Write: Error writing " << dataFileName);
+      }
+    return;
+    }
+
   // Free the nrrd struct but don't touch nrrd->data
   nrrd = nrrdNix(nrrd);
   nio = nrrdIoStateNix(nio);
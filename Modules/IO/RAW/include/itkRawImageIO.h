@@ -106,6 +106,10 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void *buffer);
 
+  /** Binary files stored in the byte order of this machine can be
+   * memory mapped, starting after the header. */
+  virtual bool GetMappableDataFile(std::string & fileName, SizeType & dataPosition);
+
   /** Set/Get the Data mask. */
   itkGetConstReferenceMacro(ImageMask, unsigned short);
   void SetImageMask(unsigned long val)
@@ -232,6 +232,29 @@ void RawImageIO< TPixel, VImageDimension >
   else if itkReadRawBytesAfterSwappingMacro(double, DOUBLE)
 }
 
+template< class TPixel, unsigned int VImageDimension >
+bool RawImageIO< TPixel, VImageDimension >
+::GetMappableDataFile(std::string & fileName, SizeType & dataPosition)
+{
+  if ( m_FileType != Binary )
+    {
+    return false;
+    }
+
+  // Read() swaps the bytes unless the order is the one of this machine
+  const ByteOrder systemByteOrder =
+    ByteSwapper< int >::SystemIsBigEndian() ? BigEndian : LittleEndian;
+  if ( this->GetComponentSize() > 1
+       && m_ByteOrder != OrderNotApplicable && m_ByteOrder != systemByteOrder )
+    {
+    return false;
+    }
+
+  fileName = m_FileName;
+  dataPosition = static_cast< SizeType >( this->GetHeaderSize() );
+  return true;
+}
+
 template< class TPixel, unsigned int VImageDimension >
 bool RawImageIO< TPixel, VImageDimension >
 ::CanWriteFile(const char *fname)
@@ -25,6 +25,11 @@ namespace itk
 /** \class TransformFileReader
  *
  * \brief TODO
+ *
+ * The transforms are read with double parameters.  A transform that
+ * was written with float parameters is read as the same transform with
+ * double parameters.
+ *
  * \ingroup ITKIOTransformBase
  *
  * \wiki
@@ -27,6 +27,10 @@ namespace itk
 /** \class TransformFileWriter
  *
  * \brief TODO
+ *
+ * The transforms are written with double parameters, so the input
+ * transforms must derive from TransformBase, i.e. TransformBaseTemplate<double>.
+ *
  * \ingroup ITKIOTransformBase
  *
  * \wiki
@@ -111,21 +111,13 @@ CompositeTransformIOHelper
   // try each CompositeTransform Type, starting with
   // most common
   if(this->BuildTransformList<double,3>(transform) == 0 &&
-     this->BuildTransformList<float,3>(transform) == 0 &&
      this->BuildTransformList<double,2>(transform) == 0 &&
-     this->BuildTransformList<float,2>(transform) == 0 &&
      this->BuildTransformList<double,4>(transform) == 0 &&
      this->BuildTransformList<double,5>(transform) == 0 &&
      this->BuildTransformList<double,6>(transform) == 0 &&
      this->BuildTransformList<double,7>(transform) == 0 &&
      this->BuildTransformList<double,8>(transform) == 0 &&
-     this->BuildTransformList<double,9>(transform) == 0 &&
-     this->BuildTransformList<float,4>(transform) == 0 &&
-     this->BuildTransformList<float,5>(transform) == 0 &&
-     this->BuildTransformList<float,6>(transform) == 0 &&
-     this->BuildTransformList<float,7>(transform) == 0 &&
-     this->BuildTransformList<float,8>(transform) == 0 &&
-     this->BuildTransformList<float,9>(transform) == 0)
+     this->BuildTransformList<double,9>(transform) == 0)
     {
     itkGenericExceptionMacro(<< "Unsupported Composite Transform Type "
                              << transform->GetTransformTypeAsString());
@@ -140,21 +132,13 @@ CompositeTransformIOHelper
   // try each CompositeTransform Type, starting with
   // most common
   if(this->InternalSetTransformList<double,3>(transform,transformList) == 0 &&
-     this->InternalSetTransformList<float,3>(transform,transformList) == 0 &&
      this->InternalSetTransformList<double,2>(transform,transformList) == 0 &&
-     this->InternalSetTransformList<float,2>(transform,transformList) == 0 &&
      this->InternalSetTransformList<double,4>(transform,transformList) == 0 &&
      this->InternalSetTransformList<double,5>(transform,transformList) == 0 &&
      this->InternalSetTransformList<double,6>(transform,transformList) == 0 &&
      this->InternalSetTransformList<double,7>(transform,transformList) == 0 &&
      this->InternalSetTransformList<double,8>(transform,transformList) == 0 &&
-     this->InternalSetTransformList<double,9>(transform,transformList) == 0 &&
-     this->InternalSetTransformList<float,4>(transform,transformList) == 0 &&
-     this->InternalSetTransformList<float,5>(transform,transformList) == 0 &&
-     this->InternalSetTransformList<float,6>(transform,transformList) == 0 &&
-     this->InternalSetTransformList<float,7>(transform,transformList) == 0 &&
-     this->InternalSetTransformList<float,8>(transform,transformList) == 0 &&
-     this->InternalSetTransformList<float,9>(transform,transformList) == 0)
+     this->InternalSetTransformList<double,9>(transform,transformList) == 0)
     {
     itkGenericExceptionMacro(<< "Unsupported Composite Transform Type "
                              << transform->GetTransformTypeAsString());
@@ -41,16 +41,26 @@ TransformIOBase::CreateTransform(TransformPointer & ptr,
   TransformFactoryBase *theFactory =
     TransformFactoryBase::GetFactory();
 
+  // The transforms are read with double parameters, so a transform that was
+  // written with float parameters is created with double parameters.
+  std::string transformName = ClassName;
+  const std::string floatName("_float_");
+  const std::string::size_type floatPosition = transformName.find(floatName);
+  if ( floatPosition != std::string::npos )
+    {
+    transformName.replace(floatPosition, floatName.size(), "_double_");
+    }
+
   // Instantiate the transform
   itkDebugMacro ("About to call ObjectFactory");
   LightObject::Pointer i;
-  i = ObjectFactoryBase::CreateInstance ( ClassName.c_str() );
+  i = ObjectFactoryBase::CreateInstance ( transformName.c_str() );
   itkDebugMacro ("After call ObjectFactory");
   ptr = dynamic_cast< TransformBase * >( i.GetPointer() );
   if ( ptr.IsNull() )
     {
     std::ostringstream msg;
-    msg << "Could not create an instance of " << ClassName << std::endl
+    msg << "Could not create an instance of " << transformName << std::endl
         << "The usual cause of this error is not registering the "
         << "transform with TransformFactory" << std::endl;
     msg << "Currently registered Transforms: " << std::endl;
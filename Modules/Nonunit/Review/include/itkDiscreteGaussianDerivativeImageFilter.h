@@ -128,9 +128,22 @@ public:
    * The default value is $ImageDimension^2$.
    *
    * This parameter was introduced to reduce the memory used by images
-   * internally, at the cost of performance.
+   * internally, at the cost of performance.  The filter now convolves
+   * the image tile by tile, without full-size intermediate images, so
+   * this parameter is deprecated and ignored.  Setting it issues a
+   * warning.
    */
-  itkSetMacro(InternalNumberOfStreamDivisions, unsigned int);
+  virtual void SetInternalNumberOfStreamDivisions(const unsigned int divisions)
+  {
+    itkWarningMacro("InternalNumberOfStreamDivisions is deprecated and ignored: "
+                    "the image is convolved tile by tile.");
+    if ( this->m_InternalNumberOfStreamDivisions != divisions )
+      {
+      this->m_InternalNumberOfStreamDivisions = divisions;
+      this->Modified();
+      }
+  }
+
   itkGetConstMacro(InternalNumberOfStreamDivisions, unsigned int);
 
   /** Convenience Set methods for setting all dimensional parameters
@@ -209,8 +222,8 @@ protected:
 
   /** Standard pipeline method. While this class does not implement a
    * ThreadedGenerateData(), its GenerateData() delegates all
-   * calculations to an NeighborhoodOperatorImageFilter.  Since the
-   * NeighborhoodOperatorImageFilter is multithreaded, this filter is
+   * calculations to a SeparableNeighborhoodOperatorImageFilter.  Since the
+   * SeparableNeighborhoodOperatorImageFilter is multithreaded, this filter is
    * multithreaded by default. */
   void GenerateData();
 
@@ -19,11 +19,9 @@
 #define __itkDiscreteGaussianDerivativeImageFilter_hxx
 
 #include "itkDiscreteGaussianDerivativeImageFilter.h"
-#include "itkNeighborhoodOperatorImageFilter.h"
+#include "itkSeparableNeighborhoodOperatorImageFilter.h"
 #include "itkGaussianDerivativeOperator.h"
-#include "itkImageRegionIterator.h"
 #include "itkProgressAccumulator.h"
-#include "itkStreamingImageFilter.h"
 
 namespace itk
 {
@@ -119,60 +117,32 @@ DiscreteGaussianDerivativeImageFilter< TInputImage, TOutputImage >
   output->Allocate();
 
   // Create an internal image to protect the input image's metdata
-  // (e.g. RequestedRegion). The StreamingImageFilter changes the
-  // requested region as poart of its normal provessing.
+  // (e.g. RequestedRegion). The mini-pipeline changes the requested
+  // region as part of its normal processing.
   typename TInputImage::Pointer localInput = TInputImage::New();
   localInput->Graft( this->GetInput() );
 
-  // Type of the pixel to use for intermediate results
+  // Type of the operator coefficients
   typedef typename NumericTraits< OutputPixelType >::RealType RealOutputPixelType;
-  typedef Image< OutputPixelType, ImageDimension >            RealOutputImageType;
-
-  // Type definition for the internal neighborhood filter
-  //
-  // First filter convolves and changes type from input type to real type
-  // Middle filters convolves from real to real
-  // Last filter convolves and changes type from real type to output type
-  // Streaming filter forces the mini-pipeline to run in chunks
-  typedef NeighborhoodOperatorImageFilter< InputImageType,
-                                           RealOutputImageType, RealOutputPixelType > FirstFilterType;
-  typedef NeighborhoodOperatorImageFilter< RealOutputImageType,
-                                           RealOutputImageType, RealOutputPixelType > IntermediateFilterType;
-  typedef NeighborhoodOperatorImageFilter< RealOutputImageType,
-                                           OutputImageType, RealOutputPixelType > LastFilterType;
-  typedef NeighborhoodOperatorImageFilter< InputImageType,
-                                           OutputImageType, RealOutputPixelType > SingleFilterType;
-  typedef StreamingImageFilter< OutputImageType, OutputImageType >
-  StreamingFilterType;
-
-  typedef typename FirstFilterType::Pointer        FirstFilterPointer;
-  typedef typename IntermediateFilterType::Pointer IntermediateFilterPointer;
-  typedef typename LastFilterType::Pointer         LastFilterPointer;
-  typedef typename SingleFilterType::Pointer       SingleFilterPointer;
-  typedef typename StreamingFilterType::Pointer    StreamingFilterPointer;
+
+  // The separable filter applies the operators of all the dimensions tile
+  // by tile, without full-size intermediate images.
+  typedef SeparableNeighborhoodOperatorImageFilter< InputImageType,
+                                                    OutputImageType, RealOutputPixelType > SeparableFilterType;
 
   // Create a series of operators
   typedef GaussianDerivativeOperator< RealOutputPixelType, ImageDimension > OperatorType;
-  std::vector< OperatorType > oper;
-  oper.resize(ImageDimension);
 
-  // Create a process accumulator for tracking the progress of minipipeline
-  ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
-  progress->SetMiniPipelineFilter(this);
+  typename SeparableFilterType::Pointer separableFilter = SeparableFilterType::New();
 
   // Set up the operators
   for ( unsigned int i = 0; i < ImageDimension; ++i )
     {
-    // we reverse the direction to minimize computation while, because
-    // the largest dimension will be split slice wise for streaming.
-    //
-    // This is to say oper[0] = Z, oper[1] = Y, oper[2] = X for the
-    // 3D case.
-    unsigned int reverse_i = ImageDimension - i - 1;
+    OperatorType oper;
 
     // Set up the operator for this dimension
-    oper[reverse_i].SetDirection(i);
-    oper[reverse_i].SetOrder(m_Order[i]);
+    oper.SetDirection(i);
+    oper.SetOrder(m_Order[i]);
     if ( m_UseImageSpacing == true )
       {
       if ( localInput->GetSpacing()[i] == 0.0 )
@@ -184,114 +154,42 @@ DiscreteGaussianDerivativeImageFilter< TInputImage, TOutputImage >
         // convert the variance from physical units to pixels
         double s = localInput->GetSpacing()[i];
         s = s * s;
-        oper[reverse_i].SetVariance(m_Variance[i] / s);
+        oper.SetVariance(m_Variance[i] / s);
         }
       }
     else
       {
-      oper[reverse_i].SetVariance(m_Variance[i]);
+      oper.SetVariance(m_Variance[i]);
       }
 
-    oper[reverse_i].SetMaximumKernelWidth(m_MaximumKernelWidth);
-    oper[reverse_i].SetMaximumError(m_MaximumError[i]);
-    oper[reverse_i].SetNormalizeAcrossScale(m_NormalizeAcrossScale);
-    oper[reverse_i].CreateDirectional();
-    }
+    oper.SetMaximumKernelWidth(m_MaximumKernelWidth);
+    oper.SetMaximumError(m_MaximumError[i]);
+    oper.SetNormalizeAcrossScale(m_NormalizeAcrossScale);
+    oper.CreateDirectional();
 
-  // Create a chain of filters
-  if ( ImageDimension == 1 )
-    {
-    // Use just a single filter
-    SingleFilterPointer singleFilter = SingleFilterType::New();
-    singleFilter->SetOperator(oper[0]);
-    singleFilter->SetInput(localInput);
-    progress->RegisterInternalFilter(singleFilter, 1.0f / ImageDimension);
-
-    // Graft this filters output onto the mini-pipeline so the mini-pipeline
-    // has the correct region ivars and will write to this filters bulk data
-    // output.
-    singleFilter->GraftOutput(output);
-
-    // Update the filter
-    singleFilter->Update();
-
-    // Graft the last output of the mini-pipeline onto this filters output so
-    // the final output has the correct region ivars and a handle to the final
-    // bulk data
-    this->GraftOutput(output);
+    separableFilter->SetOperator(oper);
     }
-  else
-    {
-    // Setup a full mini-pipeline and stream the data through the
-    // pipeline.
-    unsigned int numberOfStages = ImageDimension * this->GetInternalNumberOfStreamDivisions() + 1;
-
-    // First filter convolves and changes type from input type to real type
-    FirstFilterPointer firstFilter = FirstFilterType::New();
-    firstFilter->SetOperator(oper[0]);
-    firstFilter->ReleaseDataFlagOn();
-    firstFilter->SetInput(localInput);
-    progress->RegisterInternalFilter(firstFilter, 1.0f / numberOfStages);
-
-    // Middle filters convolves from real to real
-    std::vector< IntermediateFilterPointer > intermediateFilters;
-    if ( ImageDimension > 2 )
-      {
-      for ( int i = 1; i < ImageDimension - 1; ++i )
-        {
-        IntermediateFilterPointer f = IntermediateFilterType::New();
-        f->SetOperator(oper[i]);
-        f->ReleaseDataFlagOn();
-        progress->RegisterInternalFilter(f, 1.0f / numberOfStages);
-
-        if ( i == 1 )
-          {
-          f->SetInput( firstFilter->GetOutput() );
-          }
-        else
-          {
-          // note: first filter in vector (zeroth element) is for i==1
-          f->SetInput( intermediateFilters[i - 2]->GetOutput() );
-          }
-        intermediateFilters.push_back(f);
-        }
-      }
 
-    // Last filter convolves and changes type from real type to output type
-    LastFilterPointer lastFilter = LastFilterType::New();
-    lastFilter->SetOperator(oper[ImageDimension - 1]);
-    lastFilter->ReleaseDataFlagOn();
-    if ( ImageDimension > 2 )
-      {
-      int temp_dim = static_cast< int >( ImageDimension ) - 3;
-      lastFilter->SetInput( intermediateFilters[temp_dim]->GetOutput() );
-      }
-    else
-      {
-      lastFilter->SetInput( firstFilter->GetOutput() );
-      }
-    progress->RegisterInternalFilter(lastFilter, 1.0f / numberOfStages);
-
-    // Put in a StreamingImageFilter so the mini-pipeline is processed
-    // in chunks to minimize memory usage
-    StreamingFilterPointer streamingFilter = StreamingFilterType::New();
-    streamingFilter->SetInput( lastFilter->GetOutput() );
-    streamingFilter->SetNumberOfStreamDivisions( this->GetInternalNumberOfStreamDivisions() );
-    progress->RegisterInternalFilter(streamingFilter, 1.0f / numberOfStages);
-
-    // Graft this filters output onto the mini-pipeline so the mini-pipeline
-    // has the correct region ivars and will write to this filters bulk data
-    // output.
-    streamingFilter->GraftOutput(output);
-
-    // Update the last filter in the chain
-    streamingFilter->Update();
-
-    // Graft the last output of the mini-pipeline onto this filters output so
-    // the final output has the correct region ivars and a handle to the final
-    // bulk data
-    this->GraftOutput(output);
-    }
+  // Create a process accumulator for tracking the progress of minipipeline
+  ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
+  progress->SetMiniPipelineFilter(this);
+  progress->RegisterInternalFilter(separableFilter, 1.0f);
+
+  separableFilter->SetInput(localInput);
+  separableFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
+
+  // Graft this filters output onto the mini-pipeline so the mini-pipeline
+  // has the correct region ivars and will write to this filters bulk data
+  // output.
+  separableFilter->GraftOutput(output);
+
+  // Update the filter
+  separableFilter->Update();
+
+  // Graft the output of the mini-pipeline onto this filters output so
+  // the final output has the correct region ivars and a handle to the final
+  // bulk data
+  this->GraftOutput(output);
 }
 
 template< class TInputImage, class TOutputImage >
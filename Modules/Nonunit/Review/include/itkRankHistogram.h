@@ -21,6 +21,7 @@
 
 #include "itkIntTypes.h"
 #include "itkNumericTraits.h"
+#include "itkBlockRankHistogram.h"
 
 #include <map>
 #include <vector>
@@ -257,6 +258,9 @@ private:
 };
 
 
+// The vector version counts every possible pixel value in a block
+// histogram, which keeps track of the rank incrementally. It is
+// used for the pixel types of at most 16 bits.
 template< class TInputPixel >
 class VectorRankHistogram
 {
@@ -265,39 +269,29 @@ public:
 
   VectorRankHistogram()
   {
-    m_Size = (OffsetValueType)NumericTraits< TInputPixel >::max() - (OffsetValueType)NumericTraits< TInputPixel >::NonpositiveMin() + 1;
-    m_Vec.resize(m_Size, 0);
-    if ( m_Compare( NumericTraits< TInputPixel >::max(),
-                    NumericTraits< TInputPixel >::NonpositiveMin() ) )
-      {
-      m_InitVal = NumericTraits< TInputPixel >::NonpositiveMin();
-      }
-    else
-      {
-      m_InitVal = NumericTraits< TInputPixel >::max();
-      }
-    m_Entries = m_Below = 0;
-    m_RankValue = m_InitVal  - NumericTraits< TInputPixel >::NonpositiveMin();
+    m_Histogram.SetNumberOfBins( (OffsetValueType)NumericTraits< TInputPixel >::max()
+                                 - (OffsetValueType)NumericTraits< TInputPixel >::NonpositiveMin() + 1 );
     m_Rank = 0.5;
+    m_Histogram.SetRank(m_Rank);
   }
 
   ~VectorRankHistogram() {}
 
   bool IsValid()
   {
-    return m_Entries > 0;
+    return m_Histogram.GetNumberOfEntries() > 0;
   }
 
   TInputPixel GetValueBruteForce()
   {
     SizeValueType count = 0;
-    SizeValueType target = (SizeValueType)( m_Rank * ( m_Entries - 1 ) ) + 1;
-    for( SizeValueType i=0; i<m_Size; i++ )
+    SizeValueType target = (SizeValueType)( m_Rank * ( m_Histogram.GetNumberOfEntries() - 1 ) ) + 1;
+    for( SizeValueType i=0; i<m_Histogram.GetNumberOfBins(); i++ )
       {
-      count += m_Vec[i];
+      count += m_Histogram.GetBinCount(i);
       if( count >= target )
         {
-        return i + NumericTraits< TInputPixel >::NonpositiveMin();
+        return BinToPixel(i);
         }
       }
     return NumericTraits< TInputPixel >::max();
@@ -305,42 +299,29 @@ public:
 
   TInputPixel GetValue(const TInputPixel &)
   {
-    return GetValueBruteForce();
+    const TInputPixel value = BinToPixel( m_Histogram.GetRankBin() );
+
+    itkAssertInDebugAndIgnoreInReleaseMacro( value == GetValueBruteForce() );
+    return value;
   }
 
   void AddPixel(const TInputPixel & p)
   {
-    OffsetValueType q = (OffsetValueType)p - NumericTraits< TInputPixel >::NonpositiveMin();
-
-    m_Vec[q]++;
-    if ( m_Compare(p, m_RankValue) || p == m_RankValue )
-      {
-      ++m_Below;
-      }
-    ++m_Entries;
+    m_Histogram.AddBin( PixelToBin(p) );
   }
 
   void RemovePixel(const TInputPixel & p)
   {
-    const OffsetValueType q = (OffsetValueType)p - NumericTraits< TInputPixel >::NonpositiveMin();
-
-    itkAssertInDebugAndIgnoreInReleaseMacro( q >= 0 );
-    itkAssertInDebugAndIgnoreInReleaseMacro( q < (int)m_Vec.size() );
-    itkAssertInDebugAndIgnoreInReleaseMacro( m_Entries >= 1 );
-    itkAssertInDebugAndIgnoreInReleaseMacro( m_Vec[q] > 0 );
-
-    m_Vec[q]--;
-    --m_Entries;
+    itkAssertInDebugAndIgnoreInReleaseMacro( m_Histogram.GetNumberOfEntries() >= 1 );
+    itkAssertInDebugAndIgnoreInReleaseMacro( m_Histogram.GetBinCount( PixelToBin(p) ) > 0 );
 
-    if ( m_Compare(p, m_RankValue) || p == m_RankValue )
-      {
-      --m_Below;
-      }
+    m_Histogram.RemoveBin( PixelToBin(p) );
   }
 
   void SetRank(float rank)
   {
     m_Rank = rank;
+    m_Histogram.SetRank(rank);
   }
 
   void AddBoundary(){}
@@ -356,15 +337,18 @@ protected:
   float m_Rank;
 
 private:
-  typedef typename std::vector< SizeValueType > VecType;
+  static SizeValueType PixelToBin(const TInputPixel & p)
+  {
+    return (SizeValueType)( (OffsetValueType)p - (OffsetValueType)NumericTraits< TInputPixel >::NonpositiveMin() );
+  }
 
-  VecType       m_Vec;
-  SizeValueType m_Size;
-  TCompare      m_Compare;
-  TInputPixel   m_RankValue;
-  TInputPixel   m_InitVal;
-  int           m_Below;
-  int           m_Entries;
+  static TInputPixel BinToPixel(SizeValueType bin)
+  {
+    return static_cast< TInputPixel >( (OffsetValueType)bin
+                                       + (OffsetValueType)NumericTraits< TInputPixel >::NonpositiveMin() );
+  }
+
+  BlockRankHistogram m_Histogram;
 };
 
 // now create MorphologicalGradientHistogram specilizations using the VectorMorphologicalGradientHistogram
@@ -390,6 +374,18 @@ class RankHistogram<bool>:
 {
 };
 
+template<>
+class RankHistogram<short>:
+  public VectorRankHistogram<short>
+{
+};
+
+template<>
+class RankHistogram<unsigned short>:
+  public VectorRankHistogram<unsigned short>
+{
+};
+
 /** \endcond */
 
 } // end namespace Function
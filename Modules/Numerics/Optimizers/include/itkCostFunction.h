@@ -25,29 +25,32 @@
 
 namespace itk
 {
-/** \class CostFunction
+/** \class CostFunctionTemplate
  * \brief Base class for cost functions intended to be used with Optimizers.
  *
+ * \tparam TInternalComputationValueType The type of the parameters.
+ *
  * \ingroup Numerics Optimizers
  *
  * \ingroup ITKOptimizers
  */
 
-class ITK_EXPORT CostFunction:public Object
+template< class TInternalComputationValueType >
+class ITK_EXPORT CostFunctionTemplate:public Object
 {
 public:
   /** Standard class typedefs. */
-  typedef CostFunction               Self;
+  typedef CostFunctionTemplate       Self;
   typedef Object                     Superclass;
   typedef SmartPointer< Self >       Pointer;
   typedef SmartPointer< const Self > ConstPointer;
 
   /** Run-time type information (and related methods). */
-  itkTypeMacro(CostFunction, Object);
+  itkTypeMacro(CostFunctionTemplate, Object);
 
   /**  ParametersType typedef.
    *  It defines a position in the optimization search space. */
-  typedef double                                     ParametersValueType;
+  typedef TInternalComputationValueType              ParametersValueType;
   typedef OptimizerParameters< ParametersValueType > ParametersType;
 
   /** Return the number of parameters required to compute
@@ -56,14 +59,21 @@ public:
   virtual unsigned int GetNumberOfParameters(void) const  = 0;
 
 protected:
-  CostFunction() {}
-  virtual ~CostFunction() {}
+  CostFunctionTemplate() {}
+  virtual ~CostFunctionTemplate() {}
   void PrintSelf(std::ostream & os, Indent indent) const;
 
 private:
-  CostFunction(const Self &);   //purposely not implemented
+  CostFunctionTemplate(const Self &);   //purposely not implemented
   void operator=(const Self &); //purposely not implemented
 };
+
+/** The cost function with double parameters used by the optimizers. */
+typedef CostFunctionTemplate< double > CostFunction;
 } // end namespace itk
 
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkCostFunction.hxx"
+#endif
+
 #endif
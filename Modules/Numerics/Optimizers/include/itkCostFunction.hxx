@@ -15,14 +15,20 @@
  *  limitations under the License.
  *
  *=========================================================================*/
+#ifndef __itkCostFunction_hxx
+#define __itkCostFunction_hxx
+
 #include "itkCostFunction.h"
 
 namespace itk
 {
+template< class TInternalComputationValueType >
 void
-CostFunction
+CostFunctionTemplate< TInternalComputationValueType >
 ::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
 }
 } // end namespace itk
+
+#endif
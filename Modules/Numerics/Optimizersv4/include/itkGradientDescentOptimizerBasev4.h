@@ -24,7 +24,7 @@
 
 namespace itk
 {
-/** \class GradientDescentOptimizerBasev4
+/** \class GradientDescentOptimizerBasev4Template
  *  \brief Abstract base class for gradient descent-style optimizers.
  *
  * Gradient modification is threaded in \c ModifyGradient.
@@ -35,18 +35,19 @@ namespace itk
  * \ingroup ITKOptimizersv4
  */
 
-class ITK_EXPORT GradientDescentOptimizerBasev4
-  : public ObjectToObjectOptimizerBase
+template< class TInternalComputationValueType >
+class ITK_EXPORT GradientDescentOptimizerBasev4Template
+  : public ObjectToObjectOptimizerBaseTemplate< TInternalComputationValueType >
 {
 public:
   /** Standard class typedefs. */
-  typedef GradientDescentOptimizerBasev4 Self;
-  typedef ObjectToObjectOptimizerBase    Superclass;
-  typedef SmartPointer< Self >           Pointer;
-  typedef SmartPointer< const Self >     ConstPointer;
+  typedef GradientDescentOptimizerBasev4Template                              Self;
+  typedef ObjectToObjectOptimizerBaseTemplate< TInternalComputationValueType > Superclass;
+  typedef SmartPointer< Self >                                                Pointer;
+  typedef SmartPointer< const Self >                                          ConstPointer;
 
   /** Run-time type information (and related methods). */
-  itkTypeMacro(GradientDescentOptimizerBasev4, ObjectToObjectOptimizerBase);
+  itkTypeMacro(GradientDescentOptimizerBasev4Template, ObjectToObjectOptimizerBaseTemplate);
 
   /** Codes of stopping conditions. */
   typedef enum {
@@ -66,17 +67,21 @@ public:
   typedef std::ostringstream                     StopConditionDescriptionType;
 
   /** Metric type over which this class is templated */
-  typedef Superclass::MetricType                    MetricType;
-  typedef MetricType::Pointer                       MetricTypePointer;
+  typedef typename Superclass::MetricType           MetricType;
+  typedef typename MetricType::Pointer              MetricTypePointer;
 
   /** Derivative type */
-  typedef MetricType::DerivativeType                DerivativeType;
+  typedef typename MetricType::DerivativeType       DerivativeType;
 
   /** Measure type */
-  typedef Superclass::MeasureType                   MeasureType;
+  typedef typename Superclass::MeasureType          MeasureType;
 
   /** Internal computation type, for maintaining a desired precision */
-  typedef Superclass::InternalComputationValueType InternalComputationValueType;
+  typedef typename Superclass::InternalComputationValueType InternalComputationValueType;
+
+  /** Parameters and scales types */
+  typedef typename Superclass::ParametersType       ParametersType;
+  typedef typename Superclass::ScalesType           ScalesType;
 
   /** Get the most recent gradient values. */
   itkGetConstReferenceMacro( Gradient, DerivativeType );
@@ -123,16 +128,21 @@ public:
 protected:
 
   /** Default constructor */
-  GradientDescentOptimizerBasev4();
-  virtual ~GradientDescentOptimizerBasev4();
+  GradientDescentOptimizerBasev4Template();
+  virtual ~GradientDescentOptimizerBasev4Template();
+
+  typedef GradientDescentOptimizerBasev4ModifyGradientByScalesThreaderTemplate< TInternalComputationValueType >
+    ModifyGradientByScalesThreaderType;
+  typedef GradientDescentOptimizerBasev4ModifyGradientByLearningRateThreaderTemplate< TInternalComputationValueType >
+    ModifyGradientByLearningRateThreaderType;
 
-  friend class GradientDescentOptimizerBasev4ModifyGradientByScalesThreader;
-  friend class GradientDescentOptimizerBasev4ModifyGradientByLearningRateThreader;
+  friend class GradientDescentOptimizerBasev4ModifyGradientByScalesThreaderTemplate< TInternalComputationValueType >;
+  friend class GradientDescentOptimizerBasev4ModifyGradientByLearningRateThreaderTemplate< TInternalComputationValueType >;
 
-  typedef GradientDescentOptimizerBasev4ModifyGradientByScalesThreader::IndexRangeType IndexRangeType;
+  typedef typename ModifyGradientByScalesThreaderType::IndexRangeType IndexRangeType;
 
-  GradientDescentOptimizerBasev4ModifyGradientByScalesThreader::Pointer       m_ModifyGradientByScalesThreader;
-  GradientDescentOptimizerBasev4ModifyGradientByLearningRateThreader::Pointer m_ModifyGradientByLearningRateThreader;
+  typename ModifyGradientByScalesThreaderType::Pointer       m_ModifyGradientByScalesThreader;
+  typename ModifyGradientByLearningRateThreaderType::Pointer m_ModifyGradientByLearningRateThreader;
 
   /** Derived classes define this worker method to modify the gradient by scales.
    * Modifications must be performed over the index range defined in
@@ -160,11 +170,19 @@ protected:
   virtual void PrintSelf(std::ostream & os, Indent indent) const;
 
 private:
-  GradientDescentOptimizerBasev4( const Self & ); //purposely not implemented
+  GradientDescentOptimizerBasev4Template( const Self & ); //purposely not implemented
   void operator=( const Self& ); //purposely not implemented
 
 };
 
+/** The gradient descent optimizer base with double parameters and
+ * derivative. */
+typedef GradientDescentOptimizerBasev4Template< double > GradientDescentOptimizerBasev4;
+
 } // end namespace itk
 
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkGradientDescentOptimizerBasev4.hxx"
+#endif
+
 #endif
@@ -16,20 +16,24 @@
  *
  *=========================================================================*/
 
+#ifndef __itkGradientDescentOptimizerBasev4_hxx
+#define __itkGradientDescentOptimizerBasev4_hxx
+
 #include "itkGradientDescentOptimizerBasev4.h"
 
 namespace itk
 {
 
 //-------------------------------------------------------------------
-GradientDescentOptimizerBasev4
-::GradientDescentOptimizerBasev4()
+template< class TInternalComputationValueType >
+GradientDescentOptimizerBasev4Template< TInternalComputationValueType >
+::GradientDescentOptimizerBasev4Template()
 {
   /** Threader for apply scales to gradient */
-  this->m_ModifyGradientByScalesThreader = GradientDescentOptimizerBasev4ModifyGradientByScalesThreader::New();
+  this->m_ModifyGradientByScalesThreader = ModifyGradientByScalesThreaderType::New();
 
   /** Threader for apply the learning rate to gradient */
-  this->m_ModifyGradientByLearningRateThreader = GradientDescentOptimizerBasev4ModifyGradientByLearningRateThreader::New();
+  this->m_ModifyGradientByLearningRateThreader = ModifyGradientByLearningRateThreaderType::New();
 
   this->m_NumberOfIterations = 100;
   this->m_CurrentIteration   = 0;
@@ -38,13 +42,15 @@ GradientDescentOptimizerBasev4
 }
 
 //-------------------------------------------------------------------
-GradientDescentOptimizerBasev4
-::~GradientDescentOptimizerBasev4()
+template< class TInternalComputationValueType >
+GradientDescentOptimizerBasev4Template< TInternalComputationValueType >
+::~GradientDescentOptimizerBasev4Template()
 {}
 
 //-------------------------------------------------------------------
+template< class TInternalComputationValueType >
 void
-GradientDescentOptimizerBasev4
+GradientDescentOptimizerBasev4Template< TInternalComputationValueType >
 ::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
@@ -56,16 +62,18 @@ GradientDescentOptimizerBasev4
 
 
 //-------------------------------------------------------------------
-const GradientDescentOptimizerBasev4::StopConditionReturnStringType
-GradientDescentOptimizerBasev4
+template< class TInternalComputationValueType >
+const typename GradientDescentOptimizerBasev4Template< TInternalComputationValueType >::StopConditionReturnStringType
+GradientDescentOptimizerBasev4Template< TInternalComputationValueType >
 ::GetStopConditionDescription() const
 {
   return this->m_StopConditionDescription.str();
 }
 
 //-------------------------------------------------------------------
+template< class TInternalComputationValueType >
 void
-GradientDescentOptimizerBasev4
+GradientDescentOptimizerBasev4Template< TInternalComputationValueType >
 ::StopOptimization(void)
 {
   itkDebugMacro( "StopOptimization called with a description - "
@@ -75,8 +83,9 @@ GradientDescentOptimizerBasev4
 }
 
 //-------------------------------------------------------------------
+template< class TInternalComputationValueType >
 void
-GradientDescentOptimizerBasev4
+GradientDescentOptimizerBasev4Template< TInternalComputationValueType >
 ::ModifyGradientByScales()
 {
   if ( this->m_ScalesAreIdentity )
@@ -95,6 +104,7 @@ GradientDescentOptimizerBasev4
     // in their constructor.
     itkAssertInDebugAndIgnoreInReleaseMacro( !m_ModifyGradientByScalesThreader.IsNull() );
 
+    this->m_ModifyGradientByScalesThreader->SetMaximumNumberOfThreads( this->GetNumberOfThreads() );
     this->m_ModifyGradientByScalesThreader->Execute( this, fullrange );
     }
   else
@@ -105,8 +115,9 @@ GradientDescentOptimizerBasev4
 }
 
 //-------------------------------------------------------------------
+template< class TInternalComputationValueType >
 void
-GradientDescentOptimizerBasev4
+GradientDescentOptimizerBasev4Template< TInternalComputationValueType >
 ::ModifyGradientByLearningRate()
 {
   IndexRangeType fullrange;
@@ -122,6 +133,7 @@ GradientDescentOptimizerBasev4
        But m_LearningRate is not assessible here.
        Should we declare it in a base class as m_Scales ? */
 
+    this->m_ModifyGradientByLearningRateThreader->SetMaximumNumberOfThreads( this->GetNumberOfThreads() );
     this->m_ModifyGradientByLearningRateThreader->Execute( this, fullrange );
     }
   else
@@ -132,3 +144,5 @@ GradientDescentOptimizerBasev4
 }
 
 } //namespace itk
+
+#endif
@@ -15,14 +15,18 @@
  *  limitations under the License.
  *
  *=========================================================================*/
+#ifndef __itkGradientDescentOptimizerBasev4ModifyGradientByLearningRateThreader_hxx
+#define __itkGradientDescentOptimizerBasev4ModifyGradientByLearningRateThreader_hxx
+
 #include "itkGradientDescentOptimizerBasev4ModifyGradientByLearningRateThreader.h"
 #include "itkGradientDescentOptimizerBasev4.h"
 
 namespace itk
 {
 
+template< class TInternalComputationValueType >
 void
-GradientDescentOptimizerBasev4ModifyGradientByLearningRateThreader
+GradientDescentOptimizerBasev4ModifyGradientByLearningRateThreaderTemplate< TInternalComputationValueType >
 ::ThreadedExecution( const IndexRangeType & subrange,
                      const ThreadIdType itkNotUsed(threadId) )
 {
@@ -30,3 +34,5 @@ GradientDescentOptimizerBasev4ModifyGradientByLearningRateThreader
 }
 
 } // end namespace itk
+
+#endif
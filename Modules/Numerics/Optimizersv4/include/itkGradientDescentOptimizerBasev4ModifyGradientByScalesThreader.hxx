@@ -15,14 +15,18 @@
  *  limitations under the License.
  *
  *=========================================================================*/
+#ifndef __itkGradientDescentOptimizerBasev4ModifyGradientByScalesThreader_hxx
+#define __itkGradientDescentOptimizerBasev4ModifyGradientByScalesThreader_hxx
+
 #include "itkGradientDescentOptimizerBasev4ModifyGradientByScalesThreader.h"
 #include "itkGradientDescentOptimizerBasev4.h"
 
 namespace itk
 {
 
+template< class TInternalComputationValueType >
 void
-GradientDescentOptimizerBasev4ModifyGradientByScalesThreader
+GradientDescentOptimizerBasev4ModifyGradientByScalesThreaderTemplate< TInternalComputationValueType >
 ::ThreadedExecution( const IndexRangeType & subrange,
                      const ThreadIdType itkNotUsed(threadId) )
 {
@@ -30,3 +34,5 @@ GradientDescentOptimizerBasev4ModifyGradientByScalesThreader
 }
 
 } // end namespace itk
+
+#endif
@@ -24,7 +24,7 @@
 
 namespace itk
 {
-/** \class GradientDescentOptimizerv4
+/** \class GradientDescentOptimizerv4Template
  *  \brief Gradient descent optimizer.
  *
  * GradientDescentOptimizer implements a simple gradient descent optimizer.
@@ -78,30 +78,42 @@ namespace itk
  * parameters via the metric::UpdateTransformParameters method, after the
  * optimizer applies scales and a learning rate.
  *
+ * The gradient, the scales and the best parameters hold
+ * \c TInternalComputationValueType values, so that a float optimizer keeps
+ * the per-parameter arrays of a dense transform in float.
+ *
  * \ingroup ITKOptimizersv4
  */
-class ITK_EXPORT GradientDescentOptimizerv4
-  : public GradientDescentOptimizerBasev4
+template< class TInternalComputationValueType >
+class ITK_EXPORT GradientDescentOptimizerv4Template
+  : public GradientDescentOptimizerBasev4Template< TInternalComputationValueType >
 {
 public:
   /** Standard class typedefs. */
-  typedef GradientDescentOptimizerv4     Self;
-  typedef GradientDescentOptimizerBasev4 Superclass;
-  typedef SmartPointer< Self >           Pointer;
-  typedef SmartPointer< const Self >     ConstPointer;
+  typedef GradientDescentOptimizerv4Template                                     Self;
+  typedef GradientDescentOptimizerBasev4Template< TInternalComputationValueType > Superclass;
+  typedef SmartPointer< Self >                                                   Pointer;
+  typedef SmartPointer< const Self >                                             ConstPointer;
 
   /** Run-time type information (and related methods). */
-  itkTypeMacro(GradientDescentOptimizerv4, GradientDescentOptimizerBasev4);
+  itkTypeMacro(GradientDescentOptimizerv4Template, GradientDescentOptimizerBasev4Template);
 
   /** New macro for creation of through a Smart Pointer   */
   itkNewMacro(Self);
 
   /** Derivative type */
-  typedef Superclass::DerivativeType      DerivativeType;
+  typedef typename Superclass::DerivativeType      DerivativeType;
 
   /** Metric type over which this class is templated */
-  typedef Superclass::MeasureType                  MeasureType;
-  typedef Superclass::InternalComputationValueType InternalComputationValueType;
+  typedef typename Superclass::MeasureType                  MeasureType;
+  typedef typename Superclass::InternalComputationValueType InternalComputationValueType;
+  typedef typename Superclass::IndexRangeType               IndexRangeType;
+  typedef typename Superclass::ParametersType               ParametersType;
+  typedef typename Superclass::ScalesType                   ScalesType;
+
+  /** Type of the scales estimator */
+  typedef OptimizerParameterScalesEstimatorTemplate< TInternalComputationValueType >
+    OptimizerParameterScalesEstimatorType;
 
   /** Type for the convergence checker */
   typedef itk::Function::WindowConvergenceMonitoringFunction<double>
@@ -133,7 +145,7 @@ public:
    * \sa SetDoEstimateLearningRateAtEachIteration()
    * \sa SetDoEstimateLearningOnce()
    */
-  itkSetObjectMacro(ScalesEstimator, OptimizerParameterScalesEstimator);
+  itkSetObjectMacro(ScalesEstimator, OptimizerParameterScalesEstimatorType);
 
   /** Option to use ScalesEstimator for scales estimation.
    * The estimation is performed once at begin of
@@ -235,14 +247,14 @@ protected:
   InternalComputationValueType  m_MaximumStepSizeInPhysicalUnits;
 
   /** Default constructor */
-  GradientDescentOptimizerv4();
+  GradientDescentOptimizerv4Template();
 
   /** Destructor */
-  virtual ~GradientDescentOptimizerv4();
+  virtual ~GradientDescentOptimizerv4Template();
 
   virtual void PrintSelf( std::ostream & os, Indent indent ) const;
 
-  OptimizerParameterScalesEstimator::Pointer m_ScalesEstimator;
+  typename OptimizerParameterScalesEstimatorType::Pointer m_ScalesEstimator;
 
   /** Minimum convergence value for convergence checking.
    *  The convergence checker calculates convergence value by fitting to
@@ -261,7 +273,7 @@ protected:
   InternalComputationValueType m_ConvergenceValue;
 
   /** The convergence checker. */
-  ConvergenceMonitoringType::Pointer m_ConvergenceMonitoring;
+  typename ConvergenceMonitoringType::Pointer m_ConvergenceMonitoring;
 
   /** Store the best value and related paramters */
   MeasureType                  m_CurrentBestValue;
@@ -286,10 +298,17 @@ private:
    */
   bool m_DoEstimateLearningRateOnce;
 
-  GradientDescentOptimizerv4( const Self & ); //purposely not implemented
+  GradientDescentOptimizerv4Template( const Self & ); //purposely not implemented
   void operator=( const Self& ); //purposely not implemented
 };
 
+/** The gradient descent optimizer with double parameters and derivative. */
+typedef GradientDescentOptimizerv4Template< double > GradientDescentOptimizerv4;
+
 } // end namespace itk
 
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkGradientDescentOptimizerv4.hxx"
+#endif
+
 #endif
@@ -16,6 +16,9 @@
  *
  *=========================================================================*/
 
+#ifndef __itkGradientDescentOptimizerv4_hxx
+#define __itkGradientDescentOptimizerv4_hxx
+
 #include "itkGradientDescentOptimizerv4.h"
 
 namespace itk
@@ -24,8 +27,9 @@ namespace itk
 /**
  * Default constructor
  */
-GradientDescentOptimizerv4
-::GradientDescentOptimizerv4()
+template< class TInternalComputationValueType >
+GradientDescentOptimizerv4Template< TInternalComputationValueType >
+::GradientDescentOptimizerv4Template()
 {
   this->m_LearningRate = NumericTraits<InternalComputationValueType>::One;
 
@@ -48,16 +52,18 @@ GradientDescentOptimizerv4
 /**
  * Destructor
  */
-GradientDescentOptimizerv4
-::~GradientDescentOptimizerv4()
+template< class TInternalComputationValueType >
+GradientDescentOptimizerv4Template< TInternalComputationValueType >
+::~GradientDescentOptimizerv4Template()
 {}
 
 
 /**
  *PrintSelf
  */
+template< class TInternalComputationValueType >
 void
-GradientDescentOptimizerv4
+GradientDescentOptimizerv4Template< TInternalComputationValueType >
 ::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
@@ -83,8 +89,9 @@ GradientDescentOptimizerv4
 /**
  * Start and run the optimization
  */
+template< class TInternalComputationValueType >
 void
-GradientDescentOptimizerv4
+GradientDescentOptimizerv4Template< TInternalComputationValueType >
 ::StartOptimization()
 {
   itkDebugMacro("StartOptimization");
@@ -132,8 +139,9 @@ GradientDescentOptimizerv4
 /**
  * StopOptimization
  */
+template< class TInternalComputationValueType >
 void
-GradientDescentOptimizerv4
+GradientDescentOptimizerv4Template< TInternalComputationValueType >
 ::StopOptimization(void)
 {
   if( this->m_ReturnBestParametersAndValue )
@@ -147,8 +155,9 @@ GradientDescentOptimizerv4
 /**
  * Resume optimization.
  */
+template< class TInternalComputationValueType >
 void
-GradientDescentOptimizerv4
+GradientDescentOptimizerv4Template< TInternalComputationValueType >
 ::ResumeOptimization()
 {
   this->m_StopConditionDescription.str("");
@@ -167,7 +176,7 @@ GradientDescentOptimizerv4
       }
     catch ( ExceptionObject & err )
       {
-      this->m_StopCondition = COSTFUNCTION_ERROR;
+      this->m_StopCondition = Superclass::COSTFUNCTION_ERROR;
       this->m_StopConditionDescription << "Metric error during optimization";
       this->StopOptimization();
 
@@ -191,8 +200,8 @@ GradientDescentOptimizerv4
       this->m_ConvergenceValue = this->m_ConvergenceMonitoring->GetConvergenceValue();
       if (this->m_ConvergenceValue <= this->m_MinimumConvergenceValue)
         {
-        this->m_StopConditionDescription << "Convergence checker passed at iteration " << m_CurrentIteration << ".";
-        this->m_StopCondition = CONVERGENCE_CHECKER_PASSED;
+        this->m_StopConditionDescription << "Convergence checker passed at iteration " << this->m_CurrentIteration << ".";
+        this->m_StopCondition = Superclass::CONVERGENCE_CHECKER_PASSED;
         this->StopOptimization();
         break;
         }
@@ -219,7 +228,7 @@ GradientDescentOptimizerv4
     if ( this->m_CurrentIteration >= this->m_NumberOfIterations )
       {
       this->m_StopConditionDescription << "Maximum number of iterations (" << this->m_NumberOfIterations << ") exceeded.";
-      this->m_StopCondition = MAXIMUM_NUMBER_OF_ITERATIONS;
+      this->m_StopCondition = Superclass::MAXIMUM_NUMBER_OF_ITERATIONS;
       this->StopOptimization();
       break;
       }
@@ -229,8 +238,9 @@ GradientDescentOptimizerv4
 /**
  * Advance one Step following the gradient direction
  */
+template< class TInternalComputationValueType >
 void
-GradientDescentOptimizerv4
+GradientDescentOptimizerv4Template< TInternalComputationValueType >
 ::AdvanceOneStep()
 {
   itkDebugMacro("AdvanceOneStep");
@@ -251,7 +261,7 @@ GradientDescentOptimizerv4
     }
   catch ( ExceptionObject & err )
     {
-    this->m_StopCondition = UPDATE_PARAMETERS_ERROR;
+    this->m_StopCondition = Superclass::UPDATE_PARAMETERS_ERROR;
     this->m_StopConditionDescription << "UpdateTransformParameters error";
     this->StopOptimization();
 
@@ -265,8 +275,9 @@ GradientDescentOptimizerv4
 /**
  * Modify the gradient by scales over a given index range.
  */
+template< class TInternalComputationValueType >
 void
-GradientDescentOptimizerv4
+GradientDescentOptimizerv4Template< TInternalComputationValueType >
 ::ModifyGradientByScalesOverSubRange( const IndexRangeType& subrange )
 {
   const ScalesType& scales = this->GetScales();
@@ -287,8 +298,9 @@ GradientDescentOptimizerv4
 /**
  * Modify the gradient by learning rate over a given index range.
  */
+template< class TInternalComputationValueType >
 void
-GradientDescentOptimizerv4
+GradientDescentOptimizerv4Template< TInternalComputationValueType >
 ::ModifyGradientByLearningRateOverSubRange( const IndexRangeType& subrange )
 {
   /* Loop over the range. It is inclusive. */
@@ -301,8 +313,9 @@ GradientDescentOptimizerv4
 /**
  * Estimate the learning rate.
  */
+template< class TInternalComputationValueType >
 void
-GradientDescentOptimizerv4
+GradientDescentOptimizerv4Template< TInternalComputationValueType >
 ::EstimateLearningRate()
 {
   if ( this->m_ScalesEstimator.IsNull() )
@@ -327,3 +340,5 @@ GradientDescentOptimizerv4
 }
 
 }//namespace itk
+
+#endif
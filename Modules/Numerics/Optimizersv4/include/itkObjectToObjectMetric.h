@@ -79,27 +79,37 @@ namespace itk
  * The eventual goal however is to allow for either moving, fixed or both
  * transforms to be active within a single metric.
  *
+ * \note Precision
+ * \c TInternalComputationValueType is the scalar type of the fixed and moving
+ * transforms, of their parameters, of the derivative and of the internal
+ * computations of derived metrics. Setting it to float lets dense transforms
+ * such as DisplacementFieldTransform hold their fields in single precision,
+ * to be optimized by GradientDescentOptimizerv4Template<float>. The measure
+ * remains double.
+ *
  * \ingroup ITKOptimizersv4
  */
-template<unsigned int TFixedDimension, unsigned int TMovingDimension, class TVirtualImage = Image<typename ObjectToObjectMetricBase::ParametersValueType, TFixedDimension> >
+template<unsigned int TFixedDimension, unsigned int TMovingDimension, class TVirtualImage = Image<double, TFixedDimension>,
+         class TInternalComputationValueType = double >
 class ITK_EXPORT ObjectToObjectMetric:
-  public ObjectToObjectMetricBase
+  public ObjectToObjectMetricBaseTemplate<TInternalComputationValueType>
 {
 public:
   /** Standard class typedefs. */
-  typedef ObjectToObjectMetric         Self;
-  typedef ObjectToObjectMetricBase     Superclass;
+  typedef ObjectToObjectMetric                                            Self;
+  typedef ObjectToObjectMetricBaseTemplate<TInternalComputationValueType> Superclass;
   typedef SmartPointer< Self >         Pointer;
   typedef SmartPointer< const Self >   ConstPointer;
 
   /** Run-time type information (and related methods). */
-  itkTypeMacro(ObjectToObjectMetric, ObjectToObjectMetricBase);
+  itkTypeMacro(ObjectToObjectMetric, ObjectToObjectMetricBaseTemplate);
 
-  /** Type used for representing object components  */
-  typedef typename Superclass::ParametersValueType            CoordinateRepresentationType;
+  /** Type used for representing object components. It stays double, the
+   * coordinate type of image points, whatever the parameters type. */
+  typedef double                                              CoordinateRepresentationType;
 
-  /** Type for internal computations */
-  typedef typename Superclass::InternalComputationValueType   InternalComputationValueType;
+  /** Type for internal computations, and scalar type of the transforms */
+  typedef TInternalComputationValueType                       InternalComputationValueType;
 
   /**  Type of the measure. */
   typedef typename Superclass::MeasureType            MeasureType;
@@ -140,8 +150,8 @@ public:
   typedef typename VirtualPointSetType::Pointer                                 VirtualPointSetPointer;
 
   /**  Type of the Transform Base classes */
-  typedef Transform<ParametersValueType, TVirtualImage::ImageDimension, TMovingDimension> MovingTransformType;
-  typedef Transform<ParametersValueType, TVirtualImage::ImageDimension, TFixedDimension>  FixedTransformType;
+  typedef Transform<TInternalComputationValueType, TVirtualImage::ImageDimension, TMovingDimension> MovingTransformType;
+  typedef Transform<TInternalComputationValueType, TVirtualImage::ImageDimension, TFixedDimension>  FixedTransformType;
 
   typedef typename FixedTransformType::Pointer         FixedTransformPointer;
   typedef typename FixedTransformType::InputPointType  FixedInputPointType;
@@ -159,7 +169,7 @@ public:
   typedef typename MovingTransformType::JacobianType    MovingTransformJacobianType;
 
   /** DisplacementFieldTransform types for working with local-support transforms */
-  typedef DisplacementFieldTransform<CoordinateRepresentationType, itkGetStaticConstMacro( MovingDimension ) >  MovingDisplacementFieldTransformType;
+  typedef DisplacementFieldTransform<TInternalComputationValueType, itkGetStaticConstMacro( MovingDimension ) >  MovingDisplacementFieldTransformType;
 
   virtual void Initialize(void) throw ( ExceptionObject );
 
@@ -24,7 +24,7 @@
 namespace itk
 {
 
-/** \class ObjectToObjectMetricBase
+/** \class ObjectToObjectMetricBaseTemplate
  * \brief Base class for all object-to-object similarlity metrics added in ITKv4.
  *
  * This is the abstract base class for a hierarchy of similarity metrics
@@ -44,37 +44,41 @@ namespace itk
  *  HasLocalSupport
  *  UpdateTransformParameters
  *
+ * The parameters and the derivative hold \c TInternalComputationValueType
+ * values, which must match the parameters of the active transform.
+ *
  * \ingroup ITKOptimizersv4
  */
-class ITK_EXPORT ObjectToObjectMetricBase:
-  public SingleValuedCostFunctionv4
+template< class TInternalComputationValueType >
+class ITK_EXPORT ObjectToObjectMetricBaseTemplate:
+  public SingleValuedCostFunctionv4Template< TInternalComputationValueType >
 {
 public:
   /** Standard class typedefs. */
-  typedef ObjectToObjectMetricBase     Self;
-  typedef SingleValuedCostFunctionv4   Superclass;
-  typedef SmartPointer< Self >         Pointer;
-  typedef SmartPointer< const Self >   ConstPointer;
+  typedef ObjectToObjectMetricBaseTemplate                                   Self;
+  typedef SingleValuedCostFunctionv4Template< TInternalComputationValueType > Superclass;
+  typedef SmartPointer< Self >                                               Pointer;
+  typedef SmartPointer< const Self >                                         ConstPointer;
 
   /** Run-time type information (and related methods). */
-  itkTypeMacro(ObjectToObjectMetricBase, SingleValuedCostFunctionv4);
+  itkTypeMacro(ObjectToObjectMetricBaseTemplate, SingleValuedCostFunctionv4Template);
 
   /** Type used for representing object components  */
-  typedef Superclass::ParametersValueType CoordinateRepresentationType;
+  typedef typename Superclass::ParametersValueType CoordinateRepresentationType;
 
   /** Type for internal computations */
-  typedef double                          InternalComputationValueType;
+  typedef TInternalComputationValueType            InternalComputationValueType;
 
   /**  Type of the measure. */
-  typedef  Superclass::MeasureType        MeasureType;
+  typedef  typename Superclass::MeasureType        MeasureType;
 
   /**  Type of the derivative. */
-  typedef  Superclass::DerivativeType     DerivativeType;
-  typedef  DerivativeType::ValueType      DerivativeValueType;
-  
+  typedef  typename Superclass::DerivativeType     DerivativeType;
+  typedef  typename DerivativeType::ValueType      DerivativeValueType;
+
   /**  Type of the parameters. */
-  typedef  Superclass::ParametersType       ParametersType;
-  typedef  Superclass::ParametersValueType  ParametersValueType;
+  typedef  typename Superclass::ParametersType       ParametersType;
+  typedef  typename Superclass::ParametersValueType  ParametersValueType;
 
   /** Source of the gradient(s) used by the metric
    * (e.g. image gradients, in the case of
@@ -162,8 +166,8 @@ public:
   MeasureType GetCurrentValue() const;
 
 protected:
-  ObjectToObjectMetricBase();
-  virtual ~ObjectToObjectMetricBase();
+  ObjectToObjectMetricBaseTemplate();
+  virtual ~ObjectToObjectMetricBaseTemplate();
 
   void PrintSelf(std::ostream & os, Indent indent) const;
 
@@ -173,10 +177,17 @@ protected:
   mutable MeasureType             m_Value;
 
 private:
-  ObjectToObjectMetricBase(const Self &); //purposely not implemented
+  ObjectToObjectMetricBaseTemplate(const Self &); //purposely not implemented
   void operator=(const Self &);     //purposely not implemented
 
 };
+
+/** The metric base with double parameters and derivative. */
+typedef ObjectToObjectMetricBaseTemplate< double > ObjectToObjectMetricBase;
 } // end namespace itk
 
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkObjectToObjectMetricBase.hxx"
+#endif
+
 #endif
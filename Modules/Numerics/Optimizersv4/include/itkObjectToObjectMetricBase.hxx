@@ -15,14 +15,18 @@
  *  limitations under the License.
  *
  *=========================================================================*/
+#ifndef __itkObjectToObjectMetricBase_hxx
+#define __itkObjectToObjectMetricBase_hxx
+
 #include "itkObjectToObjectMetricBase.h"
 
 namespace itk
 {
 
 //-------------------------------------------------------------------
-ObjectToObjectMetricBase
-::ObjectToObjectMetricBase()
+template< class TInternalComputationValueType >
+ObjectToObjectMetricBaseTemplate< TInternalComputationValueType >
+::ObjectToObjectMetricBaseTemplate()
 {
   // Don't call SetGradientSource, to avoid valgrind warning.
   this->m_GradientSource = this->GRADIENT_SOURCE_MOVING;
@@ -30,13 +34,15 @@ ObjectToObjectMetricBase
 }
 
 //-------------------------------------------------------------------
-ObjectToObjectMetricBase
-::~ObjectToObjectMetricBase()
+template< class TInternalComputationValueType >
+ObjectToObjectMetricBaseTemplate< TInternalComputationValueType >
+::~ObjectToObjectMetricBaseTemplate()
 {}
 
 //-------------------------------------------------------------------
+template< class TInternalComputationValueType >
 bool
-ObjectToObjectMetricBase
+ObjectToObjectMetricBaseTemplate< TInternalComputationValueType >
 ::GetGradientSourceIncludesFixed() const
 {
   return m_GradientSource == GRADIENT_SOURCE_FIXED ||
@@ -44,8 +50,9 @@ ObjectToObjectMetricBase
 }
 
 //-------------------------------------------------------------------
+template< class TInternalComputationValueType >
 bool
-ObjectToObjectMetricBase
+ObjectToObjectMetricBaseTemplate< TInternalComputationValueType >
 ::GetGradientSourceIncludesMoving() const
 {
   return m_GradientSource == GRADIENT_SOURCE_MOVING ||
@@ -53,16 +60,18 @@ ObjectToObjectMetricBase
 }
 
 //-------------------------------------------------------------------
-ObjectToObjectMetricBase::MeasureType
-ObjectToObjectMetricBase
+template< class TInternalComputationValueType >
+typename ObjectToObjectMetricBaseTemplate< TInternalComputationValueType >::MeasureType
+ObjectToObjectMetricBaseTemplate< TInternalComputationValueType >
 ::GetCurrentValue() const
 {
   return m_Value;
 }
 
 //-------------------------------------------------------------------
+template< class TInternalComputationValueType >
 void
-ObjectToObjectMetricBase
+ObjectToObjectMetricBaseTemplate< TInternalComputationValueType >
 ::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
@@ -86,3 +95,5 @@ ObjectToObjectMetricBase
 }
 
 }//namespace itk
+
+#endif
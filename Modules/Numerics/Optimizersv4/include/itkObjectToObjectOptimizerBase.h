@@ -24,7 +24,7 @@
 
 namespace itk
 {
-/** \class ObjectToObjectOptimizerBase
+/** \class ObjectToObjectOptimizerBaseTemplate
  * \brief Abstract base for object-to-object optimizers.
  *
  * The goal of this optimizer hierarchy is to work with metrics
@@ -53,39 +53,44 @@ namespace itk
  * \note Derived classes must override StartOptimization, and then call
  * this base class version to perform common initializations.
  *
+ * The scales, the parameters and the metric derivative hold
+ * \c TInternalComputationValueType values, the type of the parameters of the
+ * metric's active transform.
+ *
  * \ingroup ITKOptimizersv4
  */
 
-class ITK_EXPORT ObjectToObjectOptimizerBase : public Object
+template< class TInternalComputationValueType >
+class ITK_EXPORT ObjectToObjectOptimizerBaseTemplate : public Object
 {
 public:
   /** Standard class typedefs. */
-  typedef ObjectToObjectOptimizerBase                 Self;
+  typedef ObjectToObjectOptimizerBaseTemplate         Self;
   typedef Object                                      Superclass;
   typedef SmartPointer< Self >                        Pointer;
   typedef SmartPointer< const Self >                  ConstPointer;
 
   /** Run-time type information (and related methods). */
-  itkTypeMacro(ObjectToObjectOptimizerBase, Object);
+  itkTypeMacro(ObjectToObjectOptimizerBaseTemplate, Object);
 
   /**  Scale type. */
-  typedef OptimizerParameters< double >             ScalesType;
+  typedef OptimizerParameters< TInternalComputationValueType > ScalesType;
 
   /**  Parameters type. */
-  typedef OptimizerParameters< double >             ParametersType;
+  typedef OptimizerParameters< TInternalComputationValueType > ParametersType;
 
   /** Metric function type */
-  typedef ObjectToObjectMetricBase                  MetricType;
-  typedef MetricType::Pointer                       MetricTypePointer;
+  typedef ObjectToObjectMetricBaseTemplate< TInternalComputationValueType > MetricType;
+  typedef typename MetricType::Pointer                                       MetricTypePointer;
 
   /** Number of parameters type */
-  typedef MetricType::NumberOfParametersType        NumberOfParametersType;
+  typedef typename MetricType::NumberOfParametersType        NumberOfParametersType;
 
   /** Measure type */
-  typedef MetricType::MeasureType                   MeasureType;
+  typedef typename MetricType::MeasureType                   MeasureType;
 
   /** Internal computation value type */
-  typedef MetricType::InternalComputationValueType  InternalComputationValueType;
+  typedef TInternalComputationValueType                      InternalComputationValueType;
 
   /** Accessors for Metric */
   itkGetObjectMacro( Metric, MetricType );
@@ -133,8 +138,8 @@ public:
 protected:
 
   /** Default constructor */
-  ObjectToObjectOptimizerBase();
-  virtual ~ObjectToObjectOptimizerBase();
+  ObjectToObjectOptimizerBaseTemplate();
+  virtual ~ObjectToObjectOptimizerBaseTemplate();
 
   MetricTypePointer             m_Metric;
   ThreadIdType                  m_NumberOfThreads;
@@ -155,12 +160,19 @@ protected:
 private:
 
   //purposely not implemented
-  ObjectToObjectOptimizerBase( const Self & );
+  ObjectToObjectOptimizerBaseTemplate( const Self & );
   //purposely not implemented
   void operator=( const Self& );
 
 };
 
+/** The optimizer base with double parameters and derivative. */
+typedef ObjectToObjectOptimizerBaseTemplate< double > ObjectToObjectOptimizerBase;
+
 } // end namespace itk
 
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkObjectToObjectOptimizerBase.hxx"
+#endif
+
 #endif
@@ -15,6 +15,9 @@
  *  limitations under the License.
  *
  *=========================================================================*/
+#ifndef __itkObjectToObjectOptimizerBase_hxx
+#define __itkObjectToObjectOptimizerBase_hxx
+
 #include "itkObjectToObjectOptimizerBase.h"
 #include "itkMultiThreader.h"
 
@@ -22,8 +25,9 @@ namespace itk
 {
 
 //-------------------------------------------------------------------
-ObjectToObjectOptimizerBase
-::ObjectToObjectOptimizerBase()
+template< class TInternalComputationValueType >
+ObjectToObjectOptimizerBaseTemplate< TInternalComputationValueType >
+::ObjectToObjectOptimizerBaseTemplate()
 {
   this->m_Metric = NULL;
   this->m_CurrentMetricValue = 0;
@@ -34,12 +38,14 @@ ObjectToObjectOptimizerBase
 }
 
 //-------------------------------------------------------------------
-ObjectToObjectOptimizerBase
-::~ObjectToObjectOptimizerBase()
+template< class TInternalComputationValueType >
+ObjectToObjectOptimizerBaseTemplate< TInternalComputationValueType >
+::~ObjectToObjectOptimizerBaseTemplate()
 {}
 
+template< class TInternalComputationValueType >
 void
-ObjectToObjectOptimizerBase
+ObjectToObjectOptimizerBaseTemplate< TInternalComputationValueType >
 ::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
@@ -56,8 +62,9 @@ ObjectToObjectOptimizerBase
 }
 
 //-------------------------------------------------------------------
+template< class TInternalComputationValueType >
 void
-ObjectToObjectOptimizerBase
+ObjectToObjectOptimizerBaseTemplate< TInternalComputationValueType >
 ::SetNumberOfThreads( ThreadIdType number )
 {
   if( number < 1 )
@@ -72,8 +79,9 @@ ObjectToObjectOptimizerBase
 }
 
 //-------------------------------------------------------------------
+template< class TInternalComputationValueType >
 void
-ObjectToObjectOptimizerBase
+ObjectToObjectOptimizerBaseTemplate< TInternalComputationValueType >
 ::StartOptimization()
 {
   /* Validate some settings */
@@ -84,7 +92,7 @@ ObjectToObjectOptimizerBase
     }
 
   /* Verify m_Scales. If m_Scales hasn't been set, initialize to all 1's. */
-  typedef ScalesType::ValueType     ValueType;
+  typedef typename ScalesType::ValueType     ValueType;
   if( this->m_Scales.Size() > 0 )
     {
     if( this->m_Scales.Size() != this->m_Metric->GetNumberOfLocalParameters() )
@@ -96,7 +104,7 @@ ObjectToObjectOptimizerBase
     /* Check that all values in m_Scales are > machine epsilon, to avoid
      * division by zero/epsilon.
      * Also check if scales are identity. */
-    typedef ScalesType::size_type     SizeType;
+    typedef typename ScalesType::size_type     SizeType;
     this->m_ScalesAreIdentity = true;
     for( SizeType i=0; i < this->m_Scales.Size(); i++ )
       {
@@ -128,8 +136,9 @@ ObjectToObjectOptimizerBase
 }
 
 //-------------------------------------------------------------------
-const ObjectToObjectOptimizerBase::ParametersType &
-ObjectToObjectOptimizerBase
+template< class TInternalComputationValueType >
+const typename ObjectToObjectOptimizerBaseTemplate< TInternalComputationValueType >::ParametersType &
+ObjectToObjectOptimizerBaseTemplate< TInternalComputationValueType >
 ::GetCurrentPosition()
 {
   if( this->m_Metric.IsNull() )
@@ -140,11 +149,14 @@ ObjectToObjectOptimizerBase
 }
 
 //-------------------------------------------------------------------
-const ObjectToObjectOptimizerBase::MeasureType &
-ObjectToObjectOptimizerBase
+template< class TInternalComputationValueType >
+const typename ObjectToObjectOptimizerBaseTemplate< TInternalComputationValueType >::MeasureType &
+ObjectToObjectOptimizerBaseTemplate< TInternalComputationValueType >
 ::GetValue()
 {
   return this->GetCurrentMetricValue();
 }
 
 }//namespace itk
+
+#endif
@@ -51,17 +51,18 @@ namespace itk
  * \ingroup ITKOptimizersv4
  */
 template < class TMetric >
-class ITK_EXPORT RegistrationParameterScalesEstimator : public OptimizerParameterScalesEstimator
+class ITK_EXPORT RegistrationParameterScalesEstimator
+  : public OptimizerParameterScalesEstimatorTemplate< typename TMetric::ParametersValueType >
 {
 public:
   /** Standard class typedefs. */
-  typedef RegistrationParameterScalesEstimator  Self;
-  typedef OptimizerParameterScalesEstimator     Superclass;
-  typedef SmartPointer<Self>                    Pointer;
-  typedef SmartPointer<const Self>              ConstPointer;
+  typedef RegistrationParameterScalesEstimator                                                Self;
+  typedef OptimizerParameterScalesEstimatorTemplate< typename TMetric::ParametersValueType >  Superclass;
+  typedef SmartPointer<Self>                                                                  Pointer;
+  typedef SmartPointer<const Self>                                                            ConstPointer;
 
   /** Run-time type information (and related methods). */
-  itkTypeMacro( RegistrationParameterScalesEstimator, OptimizerParameterScalesEstimator );
+  itkTypeMacro( RegistrationParameterScalesEstimator, OptimizerParameterScalesEstimatorTemplate );
 
   /** Type of scales */
   typedef typename Superclass::ScalesType           ScalesType;
@@ -74,6 +75,9 @@ public:
   typedef typename MetricType::Pointer              MetricPointer;
   typedef typename MetricType::ConstPointer         MetricConstPointer;
 
+  /** Type of the transform base, with the parameter type of the metric */
+  typedef TransformBaseTemplate< typename MetricType::ParametersValueType > TransformBaseType;
+
   /** Type of the transform to initialize */
   typedef typename MetricType::FixedTransformType   FixedTransformType;
   typedef typename FixedTransformType::ConstPointer FixedTransformConstPointer;
@@ -224,7 +228,7 @@ protected:
   VirtualRegionType GetVirtualDomainCentralRegion();
 
   /** Get the transform in use. */
-  const TransformBase *GetTransform();
+  const TransformBaseType *GetTransform();
 
   /** Get the dimension of the target transformed to. */
   SizeValueType GetDimension();
@@ -94,7 +94,7 @@ if (m_Metric.IsNull())
 
 /** Get the transform being estimated scales for. */
 template< class TMetric >
-const TransformBase *
+const typename RegistrationParameterScalesEstimator< TMetric >::TransformBaseType *
 RegistrationParameterScalesEstimator< TMetric >
 ::GetTransform()
 {
@@ -390,7 +390,7 @@ RegistrationParameterScalesEstimator< TMetric >
   typedef Rigid3DPerspectiveTransform<ScalarType>
           Rigid3DPerspectiveTransformType;
 
-  const TransformBase *transform = this->GetTransform();
+  const TransformBaseType *transform = this->GetTransform();
 
   if ( dynamic_cast< const MatrixOffsetTransformBaseType * >( transform ) != NULL
     || dynamic_cast< const TranslationTransformType * >( transform ) != NULL
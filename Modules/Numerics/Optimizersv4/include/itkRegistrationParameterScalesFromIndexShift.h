@@ -60,6 +60,7 @@ public:
   typedef typename Superclass::FixedTransformType        FixedTransformType;
   typedef typename Superclass::JacobianType              JacobianType;
   typedef typename Superclass::VirtualImageConstPointer  VirtualImageConstPointer;
+  typedef typename Superclass::TransformBaseType         TransformBaseType;
 
   typedef typename TMetric::FixedImageType               FixedImageType;
   typedef typename TMetric::MovingImageType              MovingImageType;
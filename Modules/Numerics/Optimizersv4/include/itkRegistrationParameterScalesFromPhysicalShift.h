@@ -60,6 +60,7 @@ public:
   typedef typename Superclass::FixedTransformType        FixedTransformType;
   typedef typename Superclass::JacobianType              JacobianType;
   typedef typename Superclass::VirtualImageConstPointer  VirtualImageConstPointer;
+  typedef typename Superclass::TransformBaseType         TransformBaseType;
 
 protected:
   RegistrationParameterScalesFromPhysicalShift();
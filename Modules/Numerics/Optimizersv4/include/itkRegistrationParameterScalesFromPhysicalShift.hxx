@@ -54,7 +54,7 @@ RegistrationParameterScalesFromPhysicalShift< TMetric >
 
   // We save the old parameters and apply the delta parameters to calculate the
   // voxel shift. After it is done, we will reset to the old parameters.
-  TransformBase *transform = const_cast<TransformBase *>(this->GetTransform());
+  TransformBaseType *transform = const_cast<TransformBaseType *>(this->GetTransform());
   const ParametersType oldParameters = transform->GetParameters();
 
   const SizeValueType numSamples = this->m_SamplePoints.size();
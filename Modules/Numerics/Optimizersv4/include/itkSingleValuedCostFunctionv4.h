@@ -23,7 +23,7 @@
 
 namespace itk
 {
-/** \class SingleValuedCostFunctionv4
+/** \class SingleValuedCostFunctionv4Template
  * \brief This class is a base for a CostFunction that returns a
  * single value.
  *
@@ -38,6 +38,10 @@ namespace itk
  * ParametersType and DerivativeType will be some sort of array-like type with
  * millions of elements.
  *
+ * The parameters and the derivative hold \c TInternalComputationValueType
+ * values. Using float instead of the default double halves their memory.
+ * The value of the cost function is always a double.
+ *
  * Derived classes must provide implementations for:
  *  GetValue
  *  GetValueAndDerivative
@@ -45,18 +49,19 @@ namespace itk
  * \ingroup Numerics Optimizers
  * \ingroup ITKOptimizersv4
  */
-class ITK_EXPORT SingleValuedCostFunctionv4:
-  public CostFunction
+template< class TInternalComputationValueType >
+class ITK_EXPORT SingleValuedCostFunctionv4Template:
+  public CostFunctionTemplate< TInternalComputationValueType >
 {
 public:
   /** Standard class typedefs. */
-  typedef SingleValuedCostFunctionv4   Self;
-  typedef CostFunction                 Superclass;
-  typedef SmartPointer< Self >         Pointer;
-  typedef SmartPointer< const Self >   ConstPointer;
+  typedef SingleValuedCostFunctionv4Template                   Self;
+  typedef CostFunctionTemplate< TInternalComputationValueType > Superclass;
+  typedef SmartPointer< Self >                                 Pointer;
+  typedef SmartPointer< const Self >                           ConstPointer;
 
   /** Run-time type information (and related methods). */
-  itkTypeMacro(SingleValuedCostFunctionv4, CostFunction);
+  itkTypeMacro(SingleValuedCostFunctionv4Template, CostFunctionTemplate);
 
   /**  MeasureType typedef.
    *  It defines a type used to return the cost function value. */
@@ -64,8 +69,8 @@ public:
 
   /**  ParametersType typedef.
    *  It defines a position in the optimization search space. */
-  typedef Superclass::ParametersType      ParametersType;
-  typedef Superclass::ParametersValueType ParametersValueType;
+  typedef typename Superclass::ParametersType      ParametersType;
+  typedef typename Superclass::ParametersValueType ParametersValueType;
 
   /** DerivativeType typedef.
    *  It defines a type used to return the cost function derivative.  */
@@ -82,13 +87,16 @@ public:
                                      DerivativeType & derivative) const = 0;
 
 protected:
-  SingleValuedCostFunctionv4() {}
-  virtual ~SingleValuedCostFunctionv4() {}
+  SingleValuedCostFunctionv4Template() {}
+  virtual ~SingleValuedCostFunctionv4Template() {}
 
 private:
-  SingleValuedCostFunctionv4(const Self &); //purposely not implemented
+  SingleValuedCostFunctionv4Template(const Self &); //purposely not implemented
   void operator=(const Self &);           //purposely not implemented
 };
+
+/** The cost function with double parameters and derivative. */
+typedef SingleValuedCostFunctionv4Template< double > SingleValuedCostFunctionv4;
 } // end namespace itk
 
 #endif
@@ -291,6 +291,7 @@ QuasiNewtonOptimizerv4
   if( this->m_Gradient.GetSize() > 10000 )
     {
     /* This ends up calling EstimateNewtonStepOverSubRange from each thread */
+    this->m_EstimateNewtonStepThreader->SetMaximumNumberOfThreads( this->GetNumberOfThreads() );
     this->m_EstimateNewtonStepThreader->Execute( this, fullrange );
     }
   else
@@ -0,0 +1,138 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkRegistrationImagePyramid_h
+#define __itkRegistrationImagePyramid_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkArray.h"
+#include "itkIntTypes.h"
+
+#include <vector>
+
+namespace itk
+{
+/** \class RegistrationImagePyramid
+ * \brief Smoothed images and reference domains of a multi-resolution
+ * registration, computed once and shared between registrations.
+ *
+ * For each level, the input image is smoothed with a
+ * DiscreteGaussianImageFilter of standard deviation
+ * SmoothingSigmasPerLevel[level], in physical units, and the smoothed
+ * image is shrunk by ShrinkFactorsPerLevel[level].  The smoothed image is
+ * what ImageRegistrationMethodv4 and its subclasses register at that
+ * level, and the shrunk image gives the reference (virtual) domain.
+ *
+ * Update() recomputes the levels only when the input image, the schedule
+ * or the pyramid itself was modified since the last update, so a pyramid
+ * of an atlas set on the registrations of many subjects is computed once.
+ * Update() is not thread safe; the levels may be read concurrently once
+ * the pyramid is up to date.
+ *
+ * \sa ImageRegistrationMethodv4::SetFixedImagePyramid()
+ * \sa MultiResolutionPyramidImageFilter
+ *
+ * \ingroup RegistrationFilters
+ * \ingroup ITKRegistrationCommon
+ */
+template< class TImage >
+class ITK_EXPORT RegistrationImagePyramid:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef RegistrationImagePyramid   Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** New macro for creation of through a Smart Pointer. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(RegistrationImagePyramid, Object);
+
+  /** Image types. */
+  typedef TImage                           ImageType;
+  typedef typename ImageType::Pointer      ImagePointer;
+  typedef typename ImageType::ConstPointer ImageConstPointer;
+
+  /** Schedule types. */
+  typedef Array< SizeValueType > ShrinkFactorsArrayType;
+  typedef Array< double >        SmoothingSigmasArrayType;
+
+  /** Set/Get the image of which to compute the pyramid. */
+  itkSetConstObjectMacro(Input, ImageType);
+  itkGetConstObjectMacro(Input, ImageType);
+
+  /** Set/Get the shrink factor of each level. */
+  itkSetMacro(ShrinkFactorsPerLevel, ShrinkFactorsArrayType);
+  itkGetConstMacro(ShrinkFactorsPerLevel, ShrinkFactorsArrayType);
+
+  /** Set/Get the standard deviation of the smoothing of each level, in
+   * physical units. */
+  itkSetMacro(SmoothingSigmasPerLevel, SmoothingSigmasArrayType);
+  itkGetConstMacro(SmoothingSigmasPerLevel, SmoothingSigmasArrayType);
+
+  /** Set/Get the maximum error of the Gaussian kernel approximation.
+   * Defaults to 0.01. */
+  itkSetMacro(MaximumError, double);
+  itkGetConstMacro(MaximumError, double);
+
+  /** Get the number of levels, that is the length of the schedule. */
+  SizeValueType GetNumberOfLevels() const
+  { return m_ShrinkFactorsPerLevel.Size(); }
+
+  /** Compute the levels if the input, the schedule or the pyramid was
+   * modified since the last update. */
+  void Update();
+
+  /** Get the smoothed image of a level.  Throws if the level has not been
+   * computed. */
+  ImageType * GetSmoothedImage(SizeValueType level) const;
+
+  /** Get the smoothed and shrunk image of a level.  Throws if the level
+   * has not been computed. */
+  ImageType * GetShrunkImage(SizeValueType level) const;
+
+protected:
+  RegistrationImagePyramid();
+  virtual ~RegistrationImagePyramid() {}
+
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  RegistrationImagePyramid(const Self &); //purposely not implemented
+  void operator=(const Self &);           //purposely not implemented
+
+  ImageConstPointer m_Input;
+
+  ShrinkFactorsArrayType   m_ShrinkFactorsPerLevel;
+  SmoothingSigmasArrayType m_SmoothingSigmasPerLevel;
+  double                   m_MaximumError;
+
+  std::vector< ImagePointer > m_SmoothedImages;
+  std::vector< ImagePointer > m_ShrunkImages;
+  TimeStamp                   m_UpdateTime;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkRegistrationImagePyramid.hxx"
+#endif
+
+#endif
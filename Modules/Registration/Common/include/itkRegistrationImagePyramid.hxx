@@ -0,0 +1,130 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkRegistrationImagePyramid_hxx
+#define __itkRegistrationImagePyramid_hxx
+
+#include "itkRegistrationImagePyramid.h"
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkShrinkImageFilter.h"
+
+namespace itk
+{
+template< class TImage >
+RegistrationImagePyramid< TImage >
+::RegistrationImagePyramid()
+{
+  m_MaximumError = 0.01;
+}
+
+template< class TImage >
+void
+RegistrationImagePyramid< TImage >
+::Update()
+{
+  if ( !m_Input )
+    {
+    itkExceptionMacro(<< "Input image is not present");
+    }
+  if ( m_SmoothingSigmasPerLevel.Size() != m_ShrinkFactorsPerLevel.Size() )
+    {
+    itkExceptionMacro(<< "The number of smoothing sigmas ("
+                      << m_SmoothingSigmasPerLevel.Size()
+                      << ") differs from the number of shrink factors ("
+                      << m_ShrinkFactorsPerLevel.Size() << ")");
+    }
+
+  if ( m_SmoothedImages.size() == this->GetNumberOfLevels()
+       && m_UpdateTime.GetMTime() > this->GetMTime()
+       && m_UpdateTime.GetMTime() > m_Input->GetMTime() )
+    {
+    return;
+    }
+
+  m_SmoothedImages.clear();
+  m_ShrunkImages.clear();
+
+  typedef DiscreteGaussianImageFilter< ImageType, ImageType > SmoothingFilterType;
+  typedef ShrinkImageFilter< ImageType, ImageType >           ShrinkFilterType;
+  for ( SizeValueType level = 0; level < this->GetNumberOfLevels(); level++ )
+    {
+    typename SmoothingFilterType::Pointer smoothingFilter = SmoothingFilterType::New();
+    smoothingFilter->SetUseImageSpacingOn();
+    smoothingFilter->SetVariance( vnl_math_sqr( m_SmoothingSigmasPerLevel[level] ) );
+    smoothingFilter->SetMaximumError(m_MaximumError);
+    smoothingFilter->SetInput(m_Input);
+    smoothingFilter->Update();
+
+    ImagePointer smoothedImage = smoothingFilter->GetOutput();
+    smoothedImage->DisconnectPipeline();
+
+    // The shrunk smoothed image has the geometry of the shrunk input
+    typename ShrinkFilterType::Pointer shrinkFilter = ShrinkFilterType::New();
+    shrinkFilter->SetShrinkFactors(m_ShrinkFactorsPerLevel[level]);
+    shrinkFilter->SetInput(smoothedImage);
+    shrinkFilter->Update();
+
+    ImagePointer shrunkImage = shrinkFilter->GetOutput();
+    shrunkImage->DisconnectPipeline();
+
+    m_SmoothedImages.push_back(smoothedImage);
+    m_ShrunkImages.push_back(shrunkImage);
+    }
+
+  m_UpdateTime.Modified();
+}
+
+template< class TImage >
+typename RegistrationImagePyramid< TImage >::ImageType *
+RegistrationImagePyramid< TImage >
+::GetSmoothedImage(SizeValueType level) const
+{
+  if ( level >= m_SmoothedImages.size() )
+    {
+    itkExceptionMacro(<< "Level " << level << " has not been computed");
+    }
+  return m_SmoothedImages[level];
+}
+
+template< class TImage >
+typename RegistrationImagePyramid< TImage >::ImageType *
+RegistrationImagePyramid< TImage >
+::GetShrunkImage(SizeValueType level) const
+{
+  if ( level >= m_ShrunkImages.size() )
+    {
+    itkExceptionMacro(<< "Level " << level << " has not been computed");
+    }
+  return m_ShrunkImages[level];
+}
+
+template< class TImage >
+void
+RegistrationImagePyramid< TImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Input: " << m_Input.GetPointer() << std::endl;
+  os << indent << "Shrink factors: " << m_ShrinkFactorsPerLevel << std::endl;
+  os << indent << "Smoothing sigmas: " << m_SmoothingSigmasPerLevel << std::endl;
+  os << indent << "Maximum error: " << m_MaximumError << std::endl;
+  os << indent << "Computed levels: " << m_SmoothedImages.size() << std::endl;
+}
+} // end namespace itk
+
+#endif
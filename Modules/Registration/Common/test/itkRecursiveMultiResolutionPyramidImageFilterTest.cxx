@@ -16,6 +16,7 @@
  *
  *=========================================================================*/
 #include "itkRecursiveMultiResolutionPyramidImageFilter.h"
+#include "itkStreamingImageFilter.h"
 
 #include <iostream>
 namespace
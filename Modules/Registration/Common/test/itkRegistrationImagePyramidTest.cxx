@@ -0,0 +1,186 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkRegistrationImagePyramid.h"
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkShrinkImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+/**
+ * This test checks that the levels of RegistrationImagePyramid match
+ * the images computed by ImageRegistrationMethodv4 at each level, and
+ * that they are only recomputed when the input or the schedule change.
+ */
+int itkRegistrationImagePyramidTest(int, char* [] )
+{
+  const unsigned int Dimension = 2;
+  typedef itk::Image< float, Dimension >             ImageType;
+  typedef itk::RegistrationImagePyramid< ImageType > PyramidType;
+
+  ImageType::RegionType region;
+  ImageType::SizeType   size = {{ 37, 26 }};
+  ImageType::IndexType  start = {{ 3, -2 }};
+  region.SetSize(size);
+  region.SetIndex(start);
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.8;
+  spacing[1] = 1.5;
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->SetSpacing(spacing);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set( static_cast< float >( ( index[0] * 7 + index[1] * 13 ) % 17 ) );
+    }
+
+  PyramidType::ShrinkFactorsArrayType shrinkFactors(3);
+  shrinkFactors[0] = 4;
+  shrinkFactors[1] = 2;
+  shrinkFactors[2] = 1;
+  PyramidType::SmoothingSigmasArrayType smoothingSigmas(3);
+  smoothingSigmas[0] = 2.0;
+  smoothingSigmas[1] = 1.0;
+  smoothingSigmas[2] = 0.0;
+
+  PyramidType::Pointer pyramid = PyramidType::New();
+  pyramid->SetInput(image);
+  pyramid->SetShrinkFactorsPerLevel(shrinkFactors);
+  pyramid->SetSmoothingSigmasPerLevel(smoothingSigmas);
+  pyramid->Update();
+  pyramid->Print(std::cout);
+
+  if ( pyramid->GetNumberOfLevels() != 3 )
+    {
+    std::cerr << "Wrong number of levels: " << pyramid->GetNumberOfLevels() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  for ( unsigned int level = 0; level < pyramid->GetNumberOfLevels(); level++ )
+    {
+    typedef itk::DiscreteGaussianImageFilter< ImageType, ImageType > SmoothingFilterType;
+    SmoothingFilterType::Pointer smoothingFilter = SmoothingFilterType::New();
+    smoothingFilter->SetUseImageSpacingOn();
+    smoothingFilter->SetVariance( smoothingSigmas[level] * smoothingSigmas[level] );
+    smoothingFilter->SetMaximumError(0.01);
+    smoothingFilter->SetInput(image);
+    smoothingFilter->Update();
+
+    const ImageType *smoothedImage = pyramid->GetSmoothedImage(level);
+    if ( smoothedImage->GetBufferedRegion() != region )
+      {
+      std::cerr << "Wrong region of smoothed image " << level << ": "
+                << smoothedImage->GetBufferedRegion() << std::endl;
+      return EXIT_FAILURE;
+      }
+    itk::ImageRegionConstIterator< ImageType > expectedIt( smoothingFilter->GetOutput(), region );
+    itk::ImageRegionConstIterator< ImageType > smoothedIt( smoothedImage, region );
+    for ( ; !expectedIt.IsAtEnd(); ++expectedIt, ++smoothedIt )
+      {
+      if ( smoothedIt.Get() != expectedIt.Get() )
+        {
+        std::cerr << "Smoothed image " << level << " differs at "
+                  << smoothedIt.GetIndex() << ": " << smoothedIt.Get()
+                  << " instead of " << expectedIt.Get() << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+
+    // The reference domain is that of the shrunk input image
+    typedef itk::ShrinkImageFilter< ImageType, ImageType > ShrinkFilterType;
+    ShrinkFilterType::Pointer shrinkFilter = ShrinkFilterType::New();
+    shrinkFilter->SetShrinkFactors(shrinkFactors[level]);
+    shrinkFilter->SetInput(image);
+    shrinkFilter->Update();
+
+    const ImageType *shrunkImage = pyramid->GetShrunkImage(level);
+    if ( shrunkImage->GetLargestPossibleRegion()
+         != shrinkFilter->GetOutput()->GetLargestPossibleRegion()
+         || shrunkImage->GetSpacing() != shrinkFilter->GetOutput()->GetSpacing()
+         || shrunkImage->GetOrigin() != shrinkFilter->GetOutput()->GetOrigin()
+         || shrunkImage->GetDirection() != shrinkFilter->GetOutput()->GetDirection() )
+      {
+      std::cerr << "Wrong domain of shrunk image " << level << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // An up to date pyramid keeps its levels. The reference keeps the first
+  // level alive, so that a recomputed level cannot reuse its address.
+  ImageType::ConstPointer firstLevel = pyramid->GetSmoothedImage(0);
+  pyramid->SetShrinkFactorsPerLevel(shrinkFactors);
+  pyramid->SetSmoothingSigmasPerLevel(smoothingSigmas);
+  pyramid->SetInput(image);
+  pyramid->Update();
+  if ( pyramid->GetSmoothedImage(0) != firstLevel.GetPointer() )
+    {
+    std::cerr << "Levels of an up to date pyramid were recomputed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A modified input is smoothed again
+  image->Modified();
+  pyramid->Update();
+  if ( pyramid->GetSmoothedImage(0) == firstLevel.GetPointer() )
+    {
+    std::cerr << "Levels were not recomputed for a modified input" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Requesting a level that is not computed and mismatched schedules throw
+  bool caught = false;
+  try
+    {
+    pyramid->GetShrunkImage(3);
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cout << "Caught expected exception: " << e.GetDescription() << std::endl;
+    caught = true;
+    }
+  if ( !caught )
+    {
+    std::cerr << "Expected an exception for level 3" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  smoothingSigmas.SetSize(2);
+  pyramid->SetSmoothingSigmasPerLevel(smoothingSigmas);
+  caught = false;
+  try
+    {
+    pyramid->Update();
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cout << "Caught expected exception: " << e.GetDescription() << std::endl;
+    caught = true;
+    }
+  if ( !caught )
+    {
+    std::cerr << "Expected an exception for mismatched schedules" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -24,8 +24,8 @@
 namespace itk
 {
 
-template<class TFixedImage, class TMovingImage, class TVirtualImage>
-ANTSNeighborhoodCorrelationImageToImageMetricv4<TFixedImage, TMovingImage,TVirtualImage>
+template<class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType>
+ANTSNeighborhoodCorrelationImageToImageMetricv4<TFixedImage, TMovingImage,TVirtualImage, TInternalComputationValueType>
 ::ANTSNeighborhoodCorrelationImageToImageMetricv4()
 {
   // initialize radius. note that a radius of 1 can be unstable
@@ -38,15 +38,15 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4<TFixedImage, TMovingImage,TVirtu
   //this->m_SparseGetValueAndDerivativeThreader =
 }
 
-template<class TFixedImage, class TMovingImage, class TVirtualImage>
-ANTSNeighborhoodCorrelationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
+template<class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType>
+ANTSNeighborhoodCorrelationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType>
 ::~ANTSNeighborhoodCorrelationImageToImageMetricv4()
 {
 }
 
-template<class TFixedImage, class TMovingImage, class TVirtualImage>
+template<class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType>
 void
-ANTSNeighborhoodCorrelationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
+ANTSNeighborhoodCorrelationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType>
 ::Initialize(void) throw ( itk::ExceptionObject )
 {
   if( this->GetUseFixedSampledPointSet() )
@@ -56,9 +56,9 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4<TFixedImage, TMovingImage, TVirt
   Superclass::Initialize();
 }
 
-template<class TFixedImage, class TMovingImage, class TVirtualImage>
+template<class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType>
 void
-ANTSNeighborhoodCorrelationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
+ANTSNeighborhoodCorrelationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType>
 ::InitializeScanning( const ImageRegionType &scanRegion, ScanIteratorType &scanIt,
                       ScanMemType & scanMem, ScanParametersType &scanParameters ) const
 {
@@ -94,9 +94,9 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4<TFixedImage, TMovingImage, TVirt
 }
 
 
-template<class TFixedImage, class TMovingImage, class TVirtualImage>
+template<class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType>
 void
-ANTSNeighborhoodCorrelationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
+ANTSNeighborhoodCorrelationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType>
 ::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
@@ -130,7 +130,7 @@ CorrelationImageToImageMetricv4GetValueAndDerivativeThreader<TDomainPartitioner,
      *  we will want to always add to the values in m_DerivativeResult so they
      *  can be efficiently accumulated between multiple metrics.
      */
-    *(associate->m_DerivativeResult) += 2.0 *fm/(f2*m2)*(fdm - fm/m2*mdm);
+    *(associate->m_DerivativeResult) += 2.0 *fm/(f2*m2)*(fdm - static_cast<DerivativeValueType>( fm/m2 )*mdm);
     }
 
 }
@@ -140,10 +140,10 @@ bool
 CorrelationImageToImageMetricv4GetValueAndDerivativeThreader<TDomainPartitioner, TImageToImageMetric, TCorrelationMetric>
 ::ProcessVirtualPoint( const VirtualIndexType & virtualIndex, const VirtualPointType & virtualPoint, const ThreadIdType threadId )
 {
-  FixedOutputPointType        mappedFixedPoint;
+  FixedImagePointType         mappedFixedPoint;
   FixedImagePixelType         mappedFixedPixelValue;
   FixedImageGradientType      mappedFixedImageGradient;
-  MovingOutputPointType       mappedMovingPoint;
+  MovingImagePointType        mappedMovingPoint;
   MovingImagePixelType        mappedMovingPixelValue;
   MovingImageGradientType     mappedMovingImageGradient;
   bool                        pointIsValid = false;
@@ -23,8 +23,8 @@
 namespace itk
 {
 
-template < class TFixedImage, class TMovingImage, class TVirtualImage >
-DemonsImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualImage>
+template < class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+DemonsImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualImage, TInternalComputationValueType>
 ::DemonsImageToImageMetricv4()
 {
   // We have our own GetValueAndDerivativeThreader's that we want
@@ -41,15 +41,15 @@ DemonsImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualImage>
 
 }
 
-template < class TFixedImage, class TMovingImage, class TVirtualImage >
-DemonsImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualImage>
+template < class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+DemonsImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualImage, TInternalComputationValueType>
 ::~DemonsImageToImageMetricv4()
 {
 }
 
-template < class TFixedImage, class TMovingImage, class TVirtualImage >
+template < class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
 void
-DemonsImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualImage>
+DemonsImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualImage, TInternalComputationValueType>
 ::Initialize(void) throw ( itk::ExceptionObject )
 {
   // Make sure user has not set to use both moving and fixed image
@@ -92,9 +92,9 @@ DemonsImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualImage>
   Superclass::Initialize();
 }
 
-template < class TFixedImage, class TMovingImage, class TVirtualImage  >
+template < class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType  >
 void
-DemonsImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualImage>
+DemonsImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualImage, TInternalComputationValueType>
 ::PrintSelf(std::ostream& os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
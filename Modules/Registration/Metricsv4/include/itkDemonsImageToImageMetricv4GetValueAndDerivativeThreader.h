@@ -82,6 +82,13 @@ protected:
         DerivativeType &                  localDerivativeReturn,
         const ThreadIdType                threadID ) const;
 
+  /** Interpolate the moving image values of the points together, with
+   * ProcessVirtualPointsInBatch(). */
+  virtual void ProcessVirtualPoints( const VirtualIndexType * virtualIndices,
+                                     const VirtualPointType * virtualPoints,
+                                     const SizeValueType numberOfPoints,
+                                     const ThreadIdType threadId );
+
 private:
   DemonsImageToImageMetricv4GetValueAndDerivativeThreader( const Self & ); // purposely not implemented
   void operator=( const Self & ); // purposely not implemented
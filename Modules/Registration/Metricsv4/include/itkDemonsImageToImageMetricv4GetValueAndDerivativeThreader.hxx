@@ -23,6 +23,17 @@
 namespace itk
 {
 
+template< class TDomainPartitioner, class TImageToImageMetric, class TDemonsMetric >
+void
+DemonsImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TDemonsMetric >
+::ProcessVirtualPoints( const VirtualIndexType * virtualIndices,
+                        const VirtualPointType * virtualPoints,
+                        const SizeValueType numberOfPoints,
+                        const ThreadIdType threadId )
+{
+  this->ProcessVirtualPointsInBatch( virtualIndices, virtualPoints, numberOfPoints, threadId );
+}
+
 template< class TDomainPartitioner, class TImageToImageMetric, class TDemonsMetric >
 bool
 DemonsImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TDemonsMetric >
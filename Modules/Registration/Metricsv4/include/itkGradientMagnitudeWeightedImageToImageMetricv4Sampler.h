@@ -0,0 +1,99 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkGradientMagnitudeWeightedImageToImageMetricv4Sampler_h
+#define __itkGradientMagnitudeWeightedImageToImageMetricv4Sampler_h
+
+#include "itkImageToImageMetricv4SamplerBase.h"
+#include <vector>
+
+namespace itk
+{
+/** \class GradientMagnitudeWeightedImageToImageMetricv4Sampler
+ * \brief Samples voxels of the virtual domain with a probability that
+ * increases with the gradient magnitude of the fixed image.
+ *
+ * The weight of a voxel is the magnitude of the central difference
+ * gradient of the fixed image at the voxel mapped by the fixed transform,
+ * plus MinimumRelativeWeight times the mean magnitude, so that uniform
+ * regions are still sampled.  Voxels mapped outside the fixed image or its
+ * mask are not sampled.  The voxels are drawn independently, with
+ * replacement, concentrating the samples on the edges that drive the
+ * registration.
+ *
+ * The cumulative weights are computed in Initialize(), and take one double
+ * per voxel of the virtual region.
+ *
+ * \ingroup ITKMetricsv4
+ */
+template< class TFixedImage, class TMovingImage = TFixedImage, class TVirtualImage = TFixedImage, class TInternalComputationValueType = double >
+class ITK_EXPORT GradientMagnitudeWeightedImageToImageMetricv4Sampler:
+  public ImageToImageMetricv4SamplerBase< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+{
+public:
+  /** Standard class typedefs. */
+  typedef GradientMagnitudeWeightedImageToImageMetricv4Sampler                        Self;
+  typedef ImageToImageMetricv4SamplerBase< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType > Superclass;
+  typedef SmartPointer< Self >                                                        Pointer;
+  typedef SmartPointer< const Self >                                                  ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(GradientMagnitudeWeightedImageToImageMetricv4Sampler, ImageToImageMetricv4SamplerBase);
+
+  typedef typename Superclass::MetricType       MetricType;
+  typedef typename Superclass::VirtualIndexType VirtualIndexType;
+  typedef typename Superclass::VirtualPointType VirtualPointType;
+
+  /** Set/Get the weight added to every voxel, relative to the mean gradient
+   * magnitude.  Defaults to 0.1. */
+  itkSetMacro(MinimumRelativeWeight, double);
+  itkGetConstMacro(MinimumRelativeWeight, double);
+
+  /** Compute the weights of the voxels from the fixed image of the
+   * metric. */
+  virtual void Initialize(const MetricType *metric);
+
+protected:
+  GradientMagnitudeWeightedImageToImageMetricv4Sampler();
+  virtual ~GradientMagnitudeWeightedImageToImageMetricv4Sampler() {}
+
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+  typedef typename Superclass::RandomGenerator RandomGenerator;
+
+  virtual void SelectSample(SizeValueType sample, RandomGenerator & random,
+                            VirtualIndexType & index) const;
+
+private:
+  GradientMagnitudeWeightedImageToImageMetricv4Sampler(const Self &); //purposely not implemented
+  void operator=(const Self &);                                       //purposely not implemented
+
+  double m_MinimumRelativeWeight;
+
+  /** Cumulative weights of the voxels, in raster order. */
+  std::vector< double > m_CumulativeWeights;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkGradientMagnitudeWeightedImageToImageMetricv4Sampler.hxx"
+#endif
+
+#endif
@@ -0,0 +1,137 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkGradientMagnitudeWeightedImageToImageMetricv4Sampler_hxx
+#define __itkGradientMagnitudeWeightedImageToImageMetricv4Sampler_hxx
+
+#include "itkGradientMagnitudeWeightedImageToImageMetricv4Sampler.h"
+#include "itkCentralDifferenceImageFunction.h"
+#include <algorithm>
+
+namespace itk
+{
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+GradientMagnitudeWeightedImageToImageMetricv4Sampler< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::GradientMagnitudeWeightedImageToImageMetricv4Sampler()
+{
+  this->m_MinimumRelativeWeight = 0.1;
+}
+
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+void
+GradientMagnitudeWeightedImageToImageMetricv4Sampler< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::Initialize(const MetricType *metric)
+{
+  Superclass::Initialize(metric);
+
+  if ( !metric->GetFixedImage() || !metric->GetFixedTransform() )
+    {
+    itkExceptionMacro("The fixed image and transform of the metric are required.");
+    }
+
+  typedef CentralDifferenceImageFunction< TFixedImage,
+                                          typename MetricType::CoordinateRepresentationType >
+                                                   GradientCalculatorType;
+  typename GradientCalculatorType::Pointer calculator = GradientCalculatorType::New();
+  calculator->UseImageDirectionOn();
+  calculator->SetInputImage( metric->GetFixedImage() );
+
+  const typename MetricType::FixedTransformType *fixedTransform = metric->GetFixedTransform();
+  const typename MetricType::FixedImageMaskType *fixedMask = metric->GetFixedImageMask();
+
+  // Gradient magnitudes, negative outside the fixed image or mask.
+  const SizeValueType numberOfPixels = this->GetVirtualRegion().GetNumberOfPixels();
+  this->m_CumulativeWeights.resize(numberOfPixels);
+
+  double        sumOfMagnitudes = 0.0;
+  SizeValueType numberOfInside = 0;
+  for ( SizeValueType offset = 0; offset < numberOfPixels; ++offset )
+    {
+    VirtualIndexType index;
+    VirtualPointType virtualPoint;
+    this->ComputeIndex(offset, index);
+    this->GetVirtualImage()->TransformIndexToPhysicalPoint(index, virtualPoint);
+
+    const typename MetricType::FixedOutputPointType fixedPoint = fixedTransform->TransformPoint(virtualPoint);
+    if ( !calculator->IsInsideBuffer(fixedPoint)
+         || ( fixedMask && !fixedMask->IsInside(fixedPoint) ) )
+      {
+      this->m_CumulativeWeights[offset] = -1.0;
+      continue;
+      }
+    const double magnitude = calculator->Evaluate(fixedPoint).GetNorm();
+    this->m_CumulativeWeights[offset] = magnitude;
+    sumOfMagnitudes += magnitude;
+    ++numberOfInside;
+    }
+  if ( numberOfInside == 0 )
+    {
+    itkExceptionMacro("No voxel of the virtual region maps inside the fixed image.");
+    }
+
+  // A uniform fixed image is sampled uniformly.
+  double minimumWeight = this->m_MinimumRelativeWeight * sumOfMagnitudes / numberOfInside;
+  if ( sumOfMagnitudes == 0.0 )
+    {
+    minimumWeight = 1.0;
+    }
+
+  double sumOfWeights = 0.0;
+  for ( SizeValueType offset = 0; offset < numberOfPixels; ++offset )
+    {
+    if ( this->m_CumulativeWeights[offset] >= 0.0 )
+      {
+      sumOfWeights += this->m_CumulativeWeights[offset] + minimumWeight;
+      }
+    this->m_CumulativeWeights[offset] = sumOfWeights;
+    }
+}
+
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+void
+GradientMagnitudeWeightedImageToImageMetricv4Sampler< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::SelectSample(SizeValueType itkNotUsed(sample), RandomGenerator & random,
+               VirtualIndexType & index) const
+{
+  // The first voxel whose cumulative weight exceeds the variate, which
+  // skips the voxels of null weight.  The variate may round up to the sum
+  // of the weights, in which case the last voxel of positive weight is
+  // taken.
+  const double sumOfWeights = this->m_CumulativeWeights.back();
+  const double variate = random.GetVariate() * sumOfWeights;
+
+  std::vector< double >::const_iterator it =
+    std::upper_bound(this->m_CumulativeWeights.begin(), this->m_CumulativeWeights.end(), variate);
+  if ( it == this->m_CumulativeWeights.end() )
+    {
+    it = std::lower_bound(this->m_CumulativeWeights.begin(), this->m_CumulativeWeights.end(), sumOfWeights);
+    }
+  this->ComputeIndex(it - this->m_CumulativeWeights.begin(), index);
+}
+
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+void
+GradientMagnitudeWeightedImageToImageMetricv4Sampler< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "MinimumRelativeWeight: " << this->m_MinimumRelativeWeight << std::endl;
+}
+} // end namespace itk
+
+#endif
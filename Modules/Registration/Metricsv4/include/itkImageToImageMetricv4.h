@@ -29,10 +29,14 @@
 #include "itkImageToImageFilter.h"
 #include "itkImageToImageMetricv4GetValueAndDerivativeThreader.h"
 #include "itkGradientRecursiveGaussianImageFilter.h"
+#include "itkGradientImageCache.h"
 #include "itkPointSet.h"
 
 namespace itk
 {
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+class ImageToImageMetricv4SamplerBase;
+
 /** \class ImageToImageMetricv4
  *
  * Computes similarity between regions of two images, using two
@@ -77,6 +81,14 @@ namespace itk
  *  once at the beginning. The user can supply a different function by calling
  *  SetFixedImageGradientCalculator and/or SetMovingImageGradientCalculator.
  *
+ * With the default gradient filter and gradient interpolator, the gradient
+ * images can instead be taken from a GradientImageCache set with
+ * SetGradientImageCache. The cache keeps the gradients in single precision,
+ * one image per component, and computes them only once for the images it has
+ * already differentiated with the same smoothing, so that one cache can be
+ * shared by the metrics of several starts, levels or registrations of the
+ * same images.
+ *
  * Both image gradient calculation methods are threaded.
  * Generally it is not recommended to use different image gradient methods for
  * the fixed and moving images because the methods return different results.
@@ -97,6 +109,12 @@ namespace itk
  * the point's geometric coordinates.
  * Point sets are set via SetFixedSampledPointSet, and the point set is enabled
  * for use by calling SetUseFixedSampledPointSet.
+ * Alternatively, a sampler (see ImageToImageMetricv4SamplerBase) set with
+ * SetSampler generates the points in the virtual domain, regularly, at
+ * random, stratified or weighted by the fixed image gradient magnitude.
+ * The points are then regenerated at each evaluation of the metric, unless
+ * RegenerateSamplesEachIteration is off, so that a small fraction of the
+ * domain can be sampled with stochastic gradient descent.
  * \note If the point set is sparse, the option SetUse[Fixed|Moving]ImageGradientFilter
  * typically should be disabled to avoid excessive computation. However,
  * the gradient values of the fixed image are not cached
@@ -155,15 +173,15 @@ namespace itk
  *
  * \ingroup ITKMetricsv4
  */
-template<class TFixedImage,class TMovingImage,class TVirtualImage = TFixedImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage = TFixedImage, class TInternalComputationValueType = double>
 class ITK_EXPORT ImageToImageMetricv4 :
-  public ObjectToObjectMetric<TFixedImage::ImageDimension, TMovingImage::ImageDimension, TVirtualImage>
+  public ObjectToObjectMetric<TFixedImage::ImageDimension, TMovingImage::ImageDimension, TVirtualImage, TInternalComputationValueType>
 {
 public:
 
   /** Standard class typedefs. */
   typedef ImageToImageMetricv4                                                                            Self;
-  typedef ObjectToObjectMetric<TFixedImage::ImageDimension, TMovingImage::ImageDimension, TVirtualImage>  Superclass;
+  typedef ObjectToObjectMetric<TFixedImage::ImageDimension, TMovingImage::ImageDimension, TVirtualImage, TInternalComputationValueType>  Superclass;
   typedef SmartPointer<Self>                                                                              Pointer;
   typedef SmartPointer<const Self>                                                                        ConstPointer;
 
@@ -341,6 +359,12 @@ public:
   typedef typename MovingImageGradientCalculatorType::Pointer
                                             MovingImageGradientCalculatorPointer;
 
+  /** Type of the cache of gradient images shared between metrics. */
+  typedef GradientImageCache< itkGetStaticConstMacro(VirtualImageDimension) >
+                                            GradientImageCacheType;
+  typedef typename GradientImageCacheType::CachedGradientImageType
+                                            CachedGradientImageType;
+
   /**  Type of the measure. */
   typedef typename Superclass::MeasureType    MeasureType;
 
@@ -394,6 +418,25 @@ public:
   itkGetConstReferenceMacro(UseFixedSampledPointSet, bool);
   itkBooleanMacro(UseFixedSampledPointSet);
 
+  /** Type of the sampler of the virtual domain. */
+  typedef ImageToImageMetricv4SamplerBase< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+                                                                        SamplerType;
+  typedef SmartPointer< SamplerType >                                   SamplerPointer;
+
+  /** Set/Get the sampler that generates the virtual domain sampling point
+   * set.  Setting a sampler turns UseFixedSampledPointSet on, and the
+   * sampler takes the place of the fixed sampled point set.  Setting NULL
+   * turns UseFixedSampledPointSet off. */
+  virtual void SetSampler( SamplerType * sampler );
+  itkGetObjectMacro(Sampler, SamplerType);
+
+  /** Set/Get whether the sampler generates new samples at each evaluation
+   * of the metric.  Otherwise, the samples generated in Initialize() are
+   * used throughout.  Defaults to true. */
+  itkSetMacro(RegenerateSamplesEachIteration, bool);
+  itkGetConstMacro(RegenerateSamplesEachIteration, bool);
+  itkBooleanMacro(RegenerateSamplesEachIteration);
+
   /** Get the virtual domain sampling point set */
   itkGetConstObjectMacro(VirtualSampledPointSet, VirtualPointSetType);
 
@@ -435,6 +478,26 @@ public:
   /** Get Moving Gradient Image. */
   itkGetConstObjectMacro(MovingImageGradientImage, MovingImageGradientImageType);
 
+  /** Set/Get the cache the gradient images of the default gradient filters
+   * are taken from, instead of computing them with the filters. NULL by
+   * default. Only used when Use[Fixed|Moving]ImageGradientFilter is set and
+   * both the gradient filter and the gradient interpolator are the default
+   * ones; the cache interpolates its gradients itself. */
+  itkSetObjectMacro(GradientImageCache, GradientImageCacheType);
+  itkGetObjectMacro(GradientImageCache, GradientImageCacheType);
+
+  /** Whether the fixed and moving gradient images are taken from the
+   * GradientImageCache, that is whether a cache is set, the gradient filter
+   * is used, and both the gradient filter and the gradient interpolator are
+   * the default ones. Otherwise the gradient filter is run on the image. */
+  bool GetFixedImageGradientsFromCache() const;
+  bool GetMovingImageGradientsFromCache() const;
+
+  /** Get the fixed and moving gradient images taken from the
+   * GradientImageCache, NULL when they are not taken from a cache. */
+  itkGetConstObjectMacro(FixedImageCachedGradientImage, CachedGradientImageType);
+  itkGetConstObjectMacro(MovingImageCachedGradientImage, CachedGradientImageType);
+
   /** Get number of valid points from most recent update */
   itkGetConstMacro( NumberOfValidPoints, SizeValueType );
 
@@ -556,6 +619,23 @@ protected:
                            MovingImagePixelType & mappedMovingPixelValue,
                            MovingImageGradientType & mappedMovingImageGradient ) const;
 
+  /** Transform an array of points from VirtualImage domain to MovingImage
+   * domain, as \c TransformAndEvaluateMovingPoint does for a single point,
+   * interpolating the moving image at all the valid points with a single
+   * call to the moving interpolator.
+   * The mapped point, pixel value and, if \c computeImageGradient is set,
+   * image gradient of point \c i are returned at position \c i of the
+   * output arrays. The positions of the valid points are returned in
+   * increasing order in \c validPoints, and their number is returned. */
+  SizeValueType TransformAndEvaluateMovingPoints(
+                           const VirtualPointType * points,
+                           const SizeValueType numberOfPoints,
+                           const bool computeImageGradient,
+                           MovingImagePointType * mappedMovingPoints,
+                           MovingImagePixelType * mappedMovingPixelValues,
+                           MovingImageGradientType * mappedMovingImageGradients,
+                           SizeValueType * validPoints ) const;
+
   /** Compute image derivatives for a Fixed point.
    * \warning This doesn't transform result into virtual space. For that,
    * see TransformAndEvaluateFixedPoint
@@ -616,6 +696,11 @@ protected:
   typename FixedImageGradientInterpolatorType::Pointer    m_FixedImageGradientInterpolator;
   typename MovingImageGradientInterpolatorType::Pointer   m_MovingImageGradientInterpolator;
 
+  /** Pointers to the default gradient interpolators. The gradient images are
+   * only taken from the GradientImageCache while these are in use. */
+  typename FixedImageGradientInterpolatorType::Pointer    m_DefaultFixedImageGradientInterpolator;
+  typename MovingImageGradientInterpolatorType::Pointer   m_DefaultMovingImageGradientInterpolator;
+
   /** Flag to control use of precomputed gradient filter image or gradient
    * calculator for image gradient calculations. */
   bool                          m_UseFixedImageGradientFilter;
@@ -636,6 +721,11 @@ protected:
   mutable FixedImageGradientImagePointer    m_FixedImageGradientImage;
   mutable MovingImageGradientImagePointer   m_MovingImageGradientImage;
 
+  /** Cache of gradient images, and the gradient images taken from it. */
+  typename GradientImageCacheType::Pointer                  m_GradientImageCache;
+  mutable typename CachedGradientImageType::ConstPointer    m_FixedImageCachedGradientImage;
+  mutable typename CachedGradientImageType::ConstPointer    m_MovingImageCachedGradientImage;
+
   /** Image gradient calculators */
   FixedImageGradientCalculatorPointer   m_FixedImageGradientCalculator;
   MovingImageGradientCalculatorPointer  m_MovingImageGradientCalculator;
@@ -659,6 +749,10 @@ protected:
   /** Flag to use FixedSampledPointSet, i.e. Sparse sampling. */
   bool                                    m_UseFixedSampledPointSet;
 
+  /** Sampler of the virtual domain, which replaces FixedSampledPointSet. */
+  SamplerPointer                          m_Sampler;
+  bool                                    m_RegenerateSamplesEachIteration;
+
   ImageToImageMetricv4();
   virtual ~ImageToImageMetricv4();
 
@@ -668,6 +762,11 @@ private:
   /** Map the fixed point set samples to the virtual domain */
   void MapFixedSampledPointSetToVirtual( void );
 
+  /** Generation of the sampled point set generated by the sampler, and
+   * whether it has been used for an evaluation. */
+  mutable SizeValueType m_SampleGeneration;
+  mutable bool          m_SampledPointSetIsUsed;
+
   /** Flag for warning about use of GetValue. Will be removed when
    *  GetValue implementation is improved. */
   mutable bool m_HaveMadeGetValueWarning;
@@ -25,12 +25,13 @@
 #include "itkLinearInterpolateImageFunction.h"
 #include "itkIdentityTransform.h"
 #include "itkCentralDifferenceImageFunction.h"
+#include "itkImageToImageMetricv4SamplerBase.h"
 
 namespace itk
 {
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::ImageToImageMetricv4()
 {
   /* Interpolators. Default to linear. */
@@ -51,8 +52,10 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
   this->m_MovingImageGradientFilter        = this->m_DefaultMovingImageGradientFilter;
 
   /* Interpolators for image gradient filters */
-  this->m_FixedImageGradientInterpolator  = FixedImageGradientInterpolatorType::New();
-  this->m_MovingImageGradientInterpolator = MovingImageGradientInterpolatorType::New();
+  this->m_DefaultFixedImageGradientInterpolator  = FixedImageGradientInterpolatorType::New();
+  this->m_DefaultMovingImageGradientInterpolator = MovingImageGradientInterpolatorType::New();
+  this->m_FixedImageGradientInterpolator  = this->m_DefaultFixedImageGradientInterpolator;
+  this->m_MovingImageGradientInterpolator = this->m_DefaultMovingImageGradientInterpolator;
 
   /* Setup default gradient image function */
   typedef CentralDifferenceImageFunction<FixedImageType,
@@ -74,6 +77,9 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
   this->m_UseFixedImageGradientFilter  = true;
   this->m_UseMovingImageGradientFilter = true;
   this->m_UseFixedSampledPointSet      = false;
+  this->m_RegenerateSamplesEachIteration = true;
+  this->m_SampleGeneration = 0;
+  this->m_SampledPointSetIsUsed = false;
 
   this->m_FloatingPointCorrectionResolution = 1e6;
   this->m_UseFloatingPointCorrection = false;
@@ -86,15 +92,15 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
   this->m_ComputeDerivative = true;
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::~ImageToImageMetricv4()
 {
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 void
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::Initialize() throw ( itk::ExceptionObject )
 {
   itkDebugMacro("Initialize entered");
@@ -154,8 +160,19 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
   Superclass::Initialize();
 
   /* Map the fixed samples into the virtual domain and store in
-   * a searpate point set. */
-  if( this->m_UseFixedSampledPointSet )
+   * a searpate point set, or generate the samples directly in the
+   * virtual domain with the sampler. */
+  if( this->m_Sampler )
+    {
+    this->m_UseFixedSampledPointSet = true;
+    this->m_Sampler->Initialize( this );
+    this->m_VirtualSampledPointSet = VirtualPointSetType::New();
+    this->m_VirtualSampledPointSet->Initialize();
+    this->m_SampleGeneration = 0;
+    this->m_Sampler->GenerateSamples( this->m_VirtualSampledPointSet, this->m_SampleGeneration );
+    this->m_SampledPointSetIsUsed = false;
+    }
+  else if( this->m_UseFixedSampledPointSet )
     {
     this->MapFixedSampledPointSetToVirtual();
     }
@@ -170,12 +187,14 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
     {
     itkDebugMacro("Initialize FixedImageGradientCalculator");
     this->m_FixedImageGradientImage = NULL;
+    this->m_FixedImageCachedGradientImage = NULL;
     this->m_FixedImageGradientCalculator->SetInputImage(this->m_FixedImage);
     }
   if( ! this->m_UseMovingImageGradientFilter )
     {
     itkDebugMacro("Initialize MovingImageGradientCalculator");
     this->m_MovingImageGradientImage = NULL;
+    this->m_MovingImageCachedGradientImage = NULL;
     this->m_MovingImageGradientCalculator->SetInputImage(this->m_MovingImage);
     }
 
@@ -205,9 +224,9 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
     }
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
-typename ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>::MeasureType
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
+typename ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType>::MeasureType
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType>
 ::GetValue() const
 {
   this-> m_ComputeDerivative = false;
@@ -224,18 +243,18 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
   return this->m_Value;
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 void
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType>
 ::GetDerivative( DerivativeType & derivative ) const
 {
   MeasureType value;
   this->GetValueAndDerivative( value, derivative );
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 void
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType>
 ::GetValueAndDerivative( MeasureType & value, DerivativeType & derivative ) const
 {
   this->m_ComputeDerivative = true;
@@ -251,9 +270,9 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
   value = this->m_Value;
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 void
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::GetValueAndDerivativeExecute() const
 {
   if( this->m_UseFixedSampledPointSet ) // sparse sampling
@@ -274,11 +293,22 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
     }
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 void
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::InitializeForIteration() const
 {
+  /* The samples generated in Initialize serve the first evaluation. */
+  if( this->m_Sampler && this->m_RegenerateSamplesEachIteration )
+    {
+    if( this->m_SampledPointSetIsUsed )
+      {
+      this->m_SampleGeneration++;
+      this->m_Sampler->GenerateSamples( this->m_VirtualSampledPointSet, this->m_SampleGeneration );
+      }
+    this->m_SampledPointSetIsUsed = true;
+    }
+
   if( this->m_ComputeDerivative )
     {
     /* This size always comes from the active transform */
@@ -292,9 +322,9 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
     }
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 bool
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::TransformAndEvaluateFixedPoint(
                          const VirtualIndexType & itkNotUsed(index),
                          const VirtualPointType & virtualPoint,
@@ -338,9 +368,9 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
   return pointIsValid;
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 bool
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::TransformAndEvaluateMovingPoint(
                          const VirtualIndexType & itkNotUsed(index),
                          const VirtualPointType & virtualPoint,
@@ -383,13 +413,81 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
   return pointIsValid;
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
+SizeValueType
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::TransformAndEvaluateMovingPoints(
+                         const VirtualPointType * virtualPoints,
+                         const SizeValueType numberOfPoints,
+                         const bool computeImageGradient,
+                         MovingImagePointType * mappedMovingPoints,
+                         MovingImagePixelType * mappedMovingPixelValues,
+                         MovingImageGradientType * mappedMovingImageGradients,
+                         SizeValueType * validPoints ) const
+{
+  typedef typename MovingInterpolatorType::ContinuousIndexType MovingContinuousIndexType;
+  typedef typename MovingInterpolatorType::OutputType          MovingInterpolatorOutputType;
+
+  const MovingImageType * interpolatedImage = this->m_MovingInterpolator->GetInputImage();
+  std::vector< MovingContinuousIndexType > validIndices( numberOfPoints );
+  SizeValueType numberOfValidPoints = 0;
+
+  for( SizeValueType i = 0; i < numberOfPoints; ++i )
+    {
+    mappedMovingPixelValues[i] = NumericTraits<MovingImagePixelType>::Zero;
+
+    // map the point into moving space
+    mappedMovingPoints[i] = this->m_MovingTransform->TransformPoint( virtualPoints[i] );
+
+    // check against the mask if one is assigned
+    if ( this->m_MovingImageMask && ! this->m_MovingImageMask->IsInside( mappedMovingPoints[i] ) )
+      {
+      continue;
+      }
+
+    // Check if mapped point is inside image buffer
+    if( ! this->m_MovingInterpolator->IsInsideBuffer( mappedMovingPoints[i] ) )
+      {
+      continue;
+      }
+
+    interpolatedImage->TransformPhysicalPointToContinuousIndex( mappedMovingPoints[i],
+                                                                validIndices[numberOfValidPoints] );
+    validPoints[numberOfValidPoints++] = i;
+    }
+
+  if( numberOfValidPoints == 0 )
+    {
+    return numberOfValidPoints;
+    }
+
+  std::vector< MovingInterpolatorOutputType > values( numberOfValidPoints );
+  this->m_MovingInterpolator->EvaluateAtContinuousIndices( &validIndices[0], &values[0], numberOfValidPoints );
+
+  for( SizeValueType j = 0; j < numberOfValidPoints; ++j )
+    {
+    const SizeValueType i = validPoints[j];
+    mappedMovingPixelValues[i] = values[j];
+    if( computeImageGradient )
+      {
+      this->ComputeMovingImageGradientAtPoint( mappedMovingPoints[i], mappedMovingImageGradients[i] );
+      }
+    }
+
+  return numberOfValidPoints;
+}
+
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 void
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::ComputeFixedImageGradientAtPoint( const FixedImagePointType & mappedPoint,
                              FixedImageGradientType & gradient ) const
 {
-  if ( this->m_UseFixedImageGradientFilter )
+  if ( this->m_FixedImageCachedGradientImage )
+    {
+    this->m_FixedImageCachedGradientImage->Evaluate( mappedPoint, gradient );
+    }
+  else if ( this->m_UseFixedImageGradientFilter )
     {
     gradient = m_FixedImageGradientInterpolator->Evaluate( mappedPoint );
     }
@@ -400,14 +498,18 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
     }
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 void
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::ComputeMovingImageGradientAtPoint(
                               const MovingImagePointType & mappedPoint,
                               MovingImageGradientType & gradient ) const
 {
-  if ( this->m_UseMovingImageGradientFilter )
+  if ( this->m_MovingImageCachedGradientImage )
+    {
+    this->m_MovingImageCachedGradientImage->Evaluate( mappedPoint, gradient );
+    }
+  else if ( this->m_UseMovingImageGradientFilter )
     {
     gradient = m_MovingImageGradientInterpolator->Evaluate( mappedPoint );
     }
@@ -418,14 +520,18 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
     }
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 void
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::ComputeFixedImageGradientAtIndex(
                               const VirtualIndexType & index,
                               FixedImageGradientType & gradient ) const
 {
-  if ( this->m_UseFixedImageGradientFilter )
+  if ( this->m_FixedImageCachedGradientImage )
+    {
+    this->m_FixedImageCachedGradientImage->EvaluateAtIndex( index, gradient );
+    }
+  else if ( this->m_UseFixedImageGradientFilter )
     {
     gradient = this->m_FixedImageGradientImage->GetPixel(index);
     }
@@ -436,14 +542,18 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
     }
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 void
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::ComputeMovingImageGradientAtIndex(
                               const VirtualIndexType & index,
                               MovingImageGradientType & gradient ) const
 {
-  if ( this->m_UseMovingImageGradientFilter )
+  if ( this->m_MovingImageCachedGradientImage )
+    {
+    this->m_MovingImageCachedGradientImage->EvaluateAtIndex( index, gradient );
+    }
+  else if ( this->m_UseMovingImageGradientFilter )
     {
     gradient = this->m_MovingImageGradientImage->GetPixel(index);
     }
@@ -454,31 +564,79 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
     }
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
+bool
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::GetFixedImageGradientsFromCache() const
+{
+  /* The cached gradients are interpolated by the cache itself, so a gradient
+   * interpolator replaced by a derived class also disables the cache. */
+  return this->m_GradientImageCache && this->m_UseFixedImageGradientFilter
+    && this->m_FixedImageGradientFilter.GetPointer() == this->m_DefaultFixedImageGradientFilter.GetPointer()
+    && this->m_FixedImageGradientInterpolator.GetPointer() == this->m_DefaultFixedImageGradientInterpolator.GetPointer();
+}
+
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
+bool
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::GetMovingImageGradientsFromCache() const
+{
+  return this->m_GradientImageCache && this->m_UseMovingImageGradientFilter
+    && this->m_MovingImageGradientFilter.GetPointer() == this->m_DefaultMovingImageGradientFilter.GetPointer()
+    && this->m_MovingImageGradientInterpolator.GetPointer() == this->m_DefaultMovingImageGradientInterpolator.GetPointer();
+}
+
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 void
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::ComputeFixedImageGradientFilterImage()
 {
+  /* Take the gradients of the default filter from the cache if there is one. */
+  if( this->GetFixedImageGradientsFromCache() )
+    {
+    this->m_FixedImageCachedGradientImage = this->m_GradientImageCache->GetGradientImage(
+      this->m_FixedImage.GetPointer(),
+      this->m_DefaultFixedImageGradientFilter->GetSigma(),
+      this->m_DefaultFixedImageGradientFilter->GetNormalizeAcrossScale(),
+      this->m_DefaultFixedImageGradientFilter->GetUseImageDirection() );
+    this->m_FixedImageGradientImage = NULL;
+    return;
+    }
+  this->m_FixedImageCachedGradientImage = NULL;
+
   this->m_FixedImageGradientFilter->SetInput( this->m_FixedImage );
   this->m_FixedImageGradientFilter->Update();
   this->m_FixedImageGradientImage = this->m_FixedImageGradientFilter->GetOutput();
   this->m_FixedImageGradientInterpolator->SetInputImage( this->m_FixedImageGradientImage );
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 void
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::ComputeMovingImageGradientFilterImage() const
 {
+  /* Take the gradients of the default filter from the cache if there is one. */
+  if( this->GetMovingImageGradientsFromCache() )
+    {
+    this->m_MovingImageCachedGradientImage = this->m_GradientImageCache->GetGradientImage(
+      this->m_MovingImage.GetPointer(),
+      this->m_DefaultMovingImageGradientFilter->GetSigma(),
+      this->m_DefaultMovingImageGradientFilter->GetNormalizeAcrossScale(),
+      this->m_DefaultMovingImageGradientFilter->GetUseImageDirection() );
+    this->m_MovingImageGradientImage = NULL;
+    return;
+    }
+  this->m_MovingImageCachedGradientImage = NULL;
+
   this->m_MovingImageGradientFilter->SetInput( this->m_MovingImage );
   this->m_MovingImageGradientFilter->Update();
   this->m_MovingImageGradientImage = this->m_MovingImageGradientFilter->GetOutput();
   this->m_MovingImageGradientInterpolator->SetInputImage( this->m_MovingImageGradientImage );
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 void
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::InitializeDefaultFixedImageGradientFilter()
 {
   const typename FixedImageType::SpacingType & spacing = this->m_FixedImage->GetSpacing();
@@ -496,9 +654,9 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
   this->m_DefaultFixedImageGradientFilter->SetUseImageDirection( true );
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 void
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::InitializeDefaultMovingImageGradientFilter()
 {
   const typename MovingImageType::SpacingType & spacing = this->m_MovingImage->GetSpacing();
@@ -516,9 +674,9 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
   this->m_DefaultMovingImageGradientFilter->SetUseImageDirection(true);
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 void
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::SetMaximumNumberOfThreads( const ThreadIdType number )
 {
   if( number != this->m_SparseGetValueAndDerivativeThreader->GetMaximumNumberOfThreads() )
@@ -533,9 +691,9 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
     }
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 ThreadIdType
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::GetMaximumNumberOfThreads() const
 {
   if( this->m_UseFixedSampledPointSet )
@@ -545,9 +703,9 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
   return  this->m_DenseGetValueAndDerivativeThreader->GetMaximumNumberOfThreads();
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 ThreadIdType
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::GetNumberOfThreadsUsed() const
 {
   if( this->m_UseFixedSampledPointSet )
@@ -560,9 +718,22 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
     }
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
+void
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType>
+::SetSampler( SamplerType * sampler )
+{
+  if( this->m_Sampler != sampler )
+    {
+    this->m_Sampler = sampler;
+    this->m_UseFixedSampledPointSet = ( sampler != NULL );
+    this->Modified();
+    }
+}
+
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 void
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType>
 ::MapFixedSampledPointSetToVirtual()
 {
   this->m_VirtualSampledPointSet = VirtualPointSetType::New();
@@ -609,9 +780,9 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
 }
 
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 SizeValueType
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType>
 ::GetNumberOfDomainPoints() const
 {
   if( this->m_UseFixedSampledPointSet )
@@ -627,9 +798,9 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
     }
 }
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage, class TInternalComputationValueType>
 void
-ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
 ::PrintSelf(std::ostream& os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
@@ -688,6 +859,23 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
     {
     os << indent << "MovingImageMask is NULL." << std::endl;
     }
+  if( this->m_Sampler )
+    {
+    os << indent << "Sampler: " << this->m_Sampler << std::endl;
+    }
+  else
+    {
+    os << indent << "Sampler is NULL." << std::endl;
+    }
+  os << indent << "RegenerateSamplesEachIteration: " << this->m_RegenerateSamplesEachIteration << std::endl;
+  if( this->m_GradientImageCache )
+    {
+    os << indent << "GradientImageCache: " << this->m_GradientImageCache << std::endl;
+    }
+  else
+    {
+    os << indent << "GradientImageCache is NULL." << std::endl;
+    }
 }
 
 }//namespace itk
@@ -96,8 +96,8 @@ protected:
   /** Constructor. */
   ImageToImageMetricv4GetValueAndDerivativeThreader() {}
 
-  /** Walk through the given virtual image domain, and call \c ProcessVirtualPoint on every
-   * point. */
+  /** Walk through the given virtual image domain, and call \c ProcessVirtualPoints on
+   * every scanline. */
   virtual void ThreadedExecution( const DomainType & subdomain,
                                   const ThreadIdType threadId );
 
@@ -157,8 +157,8 @@ protected:
   /** Constructor. */
   ImageToImageMetricv4GetValueAndDerivativeThreader() {}
 
-  /** Walk through the given virtual image domain, and call \c ProcessVirtualPoint on every
-   * point. */
+  /** Walk through the given virtual point set, and call \c ProcessVirtualPoints on
+   * consecutive blocks of points. */
   virtual void ThreadedExecution( const DomainType & subdomain,
                                   const ThreadIdType threadId );
 
@@ -18,7 +18,7 @@
 #ifndef __itkImageToImageMetricv4GetValueAndDerivativeThreader_hxx
 #define __itkImageToImageMetricv4GetValueAndDerivativeThreader_hxx
 
-#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageLinearConstIteratorWithIndex.h"
 #include "itkImageToImageMetricv4GetValueAndDerivativeThreader.h"
 
 namespace itk
@@ -30,16 +30,24 @@ ImageToImageMetricv4GetValueAndDerivativeThreader< ThreadedImageRegionPartitione
 ::ThreadedExecution ( const DomainType & imageSubRegion,
                       const ThreadIdType threadId )
 {
-  VirtualPointType virtualPoint;
-  VirtualIndexType virtualIndex;
   typename VirtualImageType::ConstPointer virtualImage = this->m_Associate->GetVirtualImage();
-  typedef ImageRegionConstIteratorWithIndex< VirtualImageType > IteratorType;
+  typedef ImageLinearConstIteratorWithIndex< VirtualImageType > IteratorType;
   IteratorType it( virtualImage, imageSubRegion );
-  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+  it.SetDirection( 0 );
+
+  /* The points are processed one scanline at a time. */
+  const SizeValueType             lineLength = imageSubRegion.GetSize()[0];
+  std::vector< VirtualIndexType > virtualIndices( lineLength );
+  std::vector< VirtualPointType > virtualPoints( lineLength );
+  for( it.GoToBegin(); !it.IsAtEnd(); it.NextLine() )
     {
-    virtualIndex = it.GetIndex();
-    virtualImage->TransformIndexToPhysicalPoint( virtualIndex, virtualPoint );
-    this->ProcessVirtualPoint( virtualIndex, virtualPoint, threadId );
+    SizeValueType numberOfPoints = 0;
+    for( ; !it.IsAtEndOfLine(); ++it, ++numberOfPoints )
+      {
+      virtualIndices[numberOfPoints] = it.GetIndex();
+      virtualImage->TransformIndexToPhysicalPoint( virtualIndices[numberOfPoints], virtualPoints[numberOfPoints] );
+      }
+    this->ProcessVirtualPoints( &virtualIndices[0], &virtualPoints[0], numberOfPoints, threadId );
     }
 }
 
@@ -49,18 +57,26 @@ ImageToImageMetricv4GetValueAndDerivativeThreader< ThreadedIndexedContainerParti
 ::ThreadedExecution ( const DomainType & indexSubRange,
                       const ThreadIdType threadId )
 {
-  VirtualPointType virtualPoint;
-  VirtualIndexType virtualIndex;
   typename VirtualImageType::ConstPointer virtualImage = this->m_Associate->GetVirtualImage();
   typename TImageToImageMetricv4::VirtualPointSetType::ConstPointer virtualSampledPointSet = this->m_Associate->GetVirtualSampledPointSet();
   typedef typename TImageToImageMetricv4::VirtualPointSetType::MeshTraits::PointIdentifier ElementIdentifierType;
   const ElementIdentifierType begin = indexSubRange[0];
   const ElementIdentifierType end   = indexSubRange[1];
+
+  /* The points are processed in blocks of a fixed size. */
+  const SizeValueType             blockSize = 256;
+  std::vector< VirtualIndexType > virtualIndices( blockSize );
+  std::vector< VirtualPointType > virtualPoints( blockSize );
+  SizeValueType                   numberOfPoints = 0;
   for( ElementIdentifierType i = begin; i <= end; ++i )
     {
-    virtualPoint = virtualSampledPointSet->GetPoint( i );
-    virtualImage->TransformPhysicalPointToIndex( virtualPoint, virtualIndex );
-    this->ProcessVirtualPoint( virtualIndex, virtualPoint, threadId );
+    virtualPoints[numberOfPoints] = virtualSampledPointSet->GetPoint( i );
+    virtualImage->TransformPhysicalPointToIndex( virtualPoints[numberOfPoints], virtualIndices[numberOfPoints] );
+    if( ++numberOfPoints == blockSize || i == end )
+      {
+      this->ProcessVirtualPoints( &virtualIndices[0], &virtualPoints[0], numberOfPoints, threadId );
+      numberOfPoints = 0;
+      }
     }
 }
 
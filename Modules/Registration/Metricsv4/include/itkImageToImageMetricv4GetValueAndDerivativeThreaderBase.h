@@ -36,8 +36,9 @@ namespace itk
  *
  *  The \c ThreadedExecution in
  *  ImageToImageMetricv4GetValueAndDerivativeThreader calls \c
- *  ProcessVirtualPoint on every point in the virtual image domain.  \c
- *  ProcessVirtualPoint calls \c ProcessPoint on each point.
+ *  ProcessVirtualPoints on the points of the virtual image domain, one
+ *  scanline or range of points at a time.  \c ProcessVirtualPoints
+ *  calls \c ProcessPoint on each point.
  *
  * \ingroup ITKMetricsv4 */
 template < class TDomainPartitioner, class TImageToImageMetricv4 >
@@ -114,6 +115,28 @@ protected:
                                     const VirtualPointType & virtualPoint,
                                     const ThreadIdType threadId );
 
+  /** Method called by the threaders to process an array of virtual points.
+   * The default calls \c ProcessVirtualPoint on each point in turn.
+   * Derived classes that do not override \c ProcessVirtualPoint may
+   * override this method to call \c ProcessVirtualPointsInBatch
+   * instead. */
+  virtual void ProcessVirtualPoints( const VirtualIndexType * virtualIndices,
+                                     const VirtualPointType * virtualPoints,
+                                     const SizeValueType numberOfPoints,
+                                     const ThreadIdType threadId );
+
+  /** Gives the same results as calling the \c ProcessVirtualPoint of
+   * this class on each point in turn, but the moving image values of
+   * the whole array are interpolated with a single call to the moving
+   * interpolator, see
+   * ImageToImageMetricv4::TransformAndEvaluateMovingPoints.
+   * \warning This does not call \c ProcessVirtualPoint, so it must not
+   * be used by derived classes that override it. */
+  void ProcessVirtualPointsInBatch( const VirtualIndexType * virtualIndices,
+                                    const VirtualPointType * virtualPoints,
+                                    const SizeValueType numberOfPoints,
+                                    const ThreadIdType threadId );
+
   /** Method to calculate the metric value and derivative
    * given a point, value and image derivative for both fixed and moving
    * spaces. The provided values have been calculated from \c virtualPoint,
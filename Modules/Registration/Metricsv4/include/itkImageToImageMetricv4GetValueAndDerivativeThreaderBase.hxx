@@ -174,10 +174,10 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImag
                        const VirtualPointType & virtualPoint,
                        const ThreadIdType threadId )
 {
-  FixedOutputPointType        mappedFixedPoint;
+  FixedImagePointType         mappedFixedPoint;
   FixedImagePixelType         mappedFixedPixelValue;
   FixedImageGradientType      mappedFixedImageGradient;
-  MovingOutputPointType       mappedMovingPoint;
+  MovingImagePointType        mappedMovingPoint;
   MovingImagePixelType        mappedMovingPixelValue;
   MovingImageGradientType     mappedMovingImageGradient;
   bool                        pointIsValid = false;
@@ -264,6 +264,129 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImag
   return pointIsValid;
 }
 
+template< class TDomainPartitioner, class TImageToImageMetricv4 >
+void
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImageToImageMetricv4 >
+::ProcessVirtualPoints( const VirtualIndexType * virtualIndices,
+                        const VirtualPointType * virtualPoints,
+                        const SizeValueType numberOfPoints,
+                        const ThreadIdType threadId )
+{
+  for( SizeValueType i = 0; i < numberOfPoints; ++i )
+    {
+    this->ProcessVirtualPoint( virtualIndices[i], virtualPoints[i], threadId );
+    }
+}
+
+template< class TDomainPartitioner, class TImageToImageMetricv4 >
+void
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImageToImageMetricv4 >
+::ProcessVirtualPointsInBatch( const VirtualIndexType * virtualIndices,
+                               const VirtualPointType * virtualPoints,
+                               const SizeValueType numberOfPoints,
+                               const ThreadIdType threadId )
+{
+  std::vector< FixedImagePointType >     mappedFixedPoints( numberOfPoints );
+  std::vector< FixedImagePixelType >     mappedFixedPixelValues( numberOfPoints );
+  std::vector< FixedImageGradientType >  mappedFixedImageGradients( numberOfPoints );
+  std::vector< SizeValueType >           validFixedPoints( numberOfPoints );
+  std::vector< VirtualPointType >        validFixedVirtualPoints( numberOfPoints );
+  SizeValueType                          numberOfValidFixedPoints = 0;
+
+  /* Transform the points into fixed space, and evaluate. */
+  try
+    {
+    for( SizeValueType i = 0; i < numberOfPoints; ++i )
+      {
+      if( this->m_Associate->TransformAndEvaluateFixedPoint( virtualIndices[i],
+                                        virtualPoints[i],
+                                        this->m_Associate->GetComputeDerivative() && this->m_Associate->GetGradientSourceIncludesFixed(),
+                                        mappedFixedPoints[i],
+                                        mappedFixedPixelValues[i],
+                                        mappedFixedImageGradients[i] ) )
+        {
+        validFixedPoints[numberOfValidFixedPoints] = i;
+        validFixedVirtualPoints[numberOfValidFixedPoints] = virtualPoints[i];
+        ++numberOfValidFixedPoints;
+        }
+      }
+    }
+  catch( ExceptionObject & exc )
+    {
+    std::string msg("Caught exception: \n");
+    msg += exc.what();
+    ExceptionObject err(__FILE__, __LINE__, msg);
+    throw err;
+    }
+  if( numberOfValidFixedPoints == 0 )
+    {
+    return;
+    }
+
+  /* Transform the remaining points into moving space, and evaluate them
+   * together. */
+  std::vector< MovingImagePointType >    mappedMovingPoints( numberOfValidFixedPoints );
+  std::vector< MovingImagePixelType >    mappedMovingPixelValues( numberOfValidFixedPoints );
+  std::vector< MovingImageGradientType > mappedMovingImageGradients( numberOfValidFixedPoints );
+  std::vector< SizeValueType >           validMovingPoints( numberOfValidFixedPoints );
+  SizeValueType                          numberOfValidMovingPoints = 0;
+  try
+    {
+    numberOfValidMovingPoints = this->m_Associate->TransformAndEvaluateMovingPoints( &validFixedVirtualPoints[0],
+                                    numberOfValidFixedPoints,
+                                    this->m_Associate->GetComputeDerivative() && this->m_Associate->GetGradientSourceIncludesMoving(),
+                                    &mappedMovingPoints[0],
+                                    &mappedMovingPixelValues[0],
+                                    &mappedMovingImageGradients[0],
+                                    &validMovingPoints[0] );
+    }
+  catch( ExceptionObject & exc )
+    {
+    std::string msg("Caught exception: \n");
+    msg += exc.what();
+    ExceptionObject err(__FILE__, __LINE__, msg);
+    throw err;
+    }
+
+  /* Call the user method in derived classes to do the specific
+   * calculations for value and derivative, in the order of the points. */
+  MeasureType metricValueResult;
+  for( SizeValueType j = 0; j < numberOfValidMovingPoints; ++j )
+    {
+    const SizeValueType k = validMovingPoints[j];
+    const SizeValueType i = validFixedPoints[k];
+    bool pointIsValid = false;
+    try
+      {
+      pointIsValid = this->ProcessPoint(
+                                     virtualIndices[i],
+                                     virtualPoints[i],
+                                     mappedFixedPoints[i], mappedFixedPixelValues[i],
+                                     mappedFixedImageGradients[i],
+                                     mappedMovingPoints[k], mappedMovingPixelValues[k],
+                                     mappedMovingImageGradients[k],
+                                     metricValueResult, this->m_LocalDerivativesPerThread[threadId],
+                                     threadId );
+      }
+    catch( ExceptionObject & exc )
+      {
+      std::string msg("Exception in GetValueAndDerivativeProcessPoint:\n");
+      msg += exc.what();
+      ExceptionObject err(__FILE__, __LINE__, msg);
+      throw err;
+      }
+    if( pointIsValid )
+      {
+      this->m_NumberOfValidPointsPerThread[threadId]++;
+      this->m_MeasurePerThread[threadId] += metricValueResult;
+      if( this->m_Associate->GetComputeDerivative() )
+        {
+        this->StorePointDerivativeResult( virtualIndices[i], threadId );
+        }
+      }
+    }
+}
+
 template< class TDomainPartitioner, class TImageToImageMetricv4 >
 void
 ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImageToImageMetricv4 >
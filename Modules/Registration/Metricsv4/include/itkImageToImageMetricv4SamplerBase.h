@@ -0,0 +1,226 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageToImageMetricv4SamplerBase_h
+#define __itkImageToImageMetricv4SamplerBase_h
+
+#include "itkImageToImageMetricv4.h"
+#include "itkImageToImageMetricv4SamplerThreader.h"
+#include "itkIntTypes.h"
+
+namespace itk
+{
+/** \class ImageToImageMetricv4SamplerBase
+ * \brief Base class of the strategies that sample the virtual domain of an
+ * ImageToImageMetricv4.
+ *
+ * A sampler set on the metric with ImageToImageMetricv4::SetSampler()
+ * generates the virtual domain points over which the metric is evaluated,
+ * in place of a fixed sampled point set.  The metric calls \c Initialize
+ * from its own Initialize(), and \c GenerateSamples every time the samples
+ * are regenerated, typically at each iteration of the optimizer, so that
+ * sparse sampling can be used with stochastic gradient descent.
+ *
+ * Derived classes select the voxel of each sample in \c SelectSample.  Each
+ * sample is then optionally perturbed within its voxel.  The random variates
+ * of a sample depend only on the seed, on the generation and on the sample
+ * number, so the samples are generated in parallel and do not depend on the
+ * number of threads.
+ *
+ * \sa RegularImageToImageMetricv4Sampler, RandomImageToImageMetricv4Sampler
+ * \sa StratifiedImageToImageMetricv4Sampler
+ * \sa GradientMagnitudeWeightedImageToImageMetricv4Sampler
+ *
+ * \ingroup ITKMetricsv4
+ */
+template< class TFixedImage, class TMovingImage = TFixedImage, class TVirtualImage = TFixedImage, class TInternalComputationValueType = double >
+class ITK_EXPORT ImageToImageMetricv4SamplerBase : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageToImageMetricv4SamplerBase Self;
+  typedef Object                          Superclass;
+  typedef SmartPointer< Self >            Pointer;
+  typedef SmartPointer< const Self >      ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageToImageMetricv4SamplerBase, Object);
+
+  /** Type of the metric whose virtual domain is sampled. */
+  typedef ImageToImageMetricv4< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType > MetricType;
+
+  typedef typename MetricType::VirtualImageType    VirtualImageType;
+  typedef typename MetricType::VirtualRegionType   VirtualRegionType;
+  typedef typename MetricType::VirtualSizeType     VirtualSizeType;
+  typedef typename MetricType::VirtualIndexType    VirtualIndexType;
+  typedef typename MetricType::VirtualPointType    VirtualPointType;
+  typedef typename MetricType::VirtualPointSetType VirtualPointSetType;
+
+  itkStaticConstMacro(VirtualImageDimension, unsigned int, TVirtualImage::ImageDimension);
+
+  /** Type of the seed of the random variates. */
+  typedef uint32_t SeedType;
+
+  /** Set/Get the fraction of the voxels of the virtual domain that are
+   * sampled, in ]0,1].  Defaults to 0.01. */
+  itkSetClampMacro(SamplingPercentage, double, NumericTraits< double >::min(), 1.0);
+  itkGetConstMacro(SamplingPercentage, double);
+
+  /** Set/Get the seed of the random variates.  Defaults to 1234. */
+  itkSetMacro(Seed, SeedType);
+  itkGetConstMacro(Seed, SeedType);
+
+  /** Set/Get whether each sample is randomly displaced within its voxel.
+   * Defaults to true. */
+  itkSetMacro(PerturbSamples, bool);
+  itkGetConstMacro(PerturbSamples, bool);
+  itkBooleanMacro(PerturbSamples);
+
+  /** Prepare the sampling of the virtual domain of the metric, which must
+   * have been set.  Called by the metric during its initialization. */
+  virtual void Initialize(const MetricType *metric);
+
+  /** Get the number of samples generated by \c GenerateSamples.  Valid
+   * after \c Initialize. */
+  itkGetConstMacro(NumberOfSamples, SizeValueType);
+
+  /** Replace the points of the point set with the samples of the given
+   * generation.  A different generation gives a different set of samples. */
+  void GenerateSamples(VirtualPointSetType *pointSet, SizeValueType generation) const;
+
+  /** Set/Get the maximum number of threads used to generate the samples. */
+  void SetMaximumNumberOfThreads(const ThreadIdType threads);
+  ThreadIdType GetMaximumNumberOfThreads() const;
+
+protected:
+  ImageToImageMetricv4SamplerBase();
+  virtual ~ImageToImageMetricv4SamplerBase() {}
+
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+  /** \class RandomGenerator
+   * Counter based generator of the uniform random variates of a sample.
+   * \ingroup ITKMetricsv4 */
+  class RandomGenerator
+  {
+  public:
+    RandomGenerator(SeedType seed, SizeValueType generation, SizeValueType sample):
+      m_Counter(0)
+    {
+      m_Key = Hash(seed);
+      m_Key = Hash( m_Key ^ Fold(generation) );
+      m_Key = Hash( m_Key ^ Fold(sample) );
+    }
+
+    /** Return a variate uniformly distributed in [0,1[. */
+    double GetVariate()
+    {
+      const uint32_t high = this->Next() >> 5;
+      const uint32_t low = this->Next() >> 6;
+
+      return ( high * 67108864.0 + low ) * ( 1.0 / 9007199254740992.0 );
+    }
+
+    /** Return an integer uniformly distributed in [0,n[. */
+    SizeValueType GetIntegerVariate(SizeValueType n)
+    {
+      const SizeValueType i = static_cast< SizeValueType >( this->GetVariate() * n );
+
+      return i < n ? i : n - 1;
+    }
+
+  private:
+    static uint32_t Hash(uint32_t x)
+    {
+      x ^= x >> 16;
+      x *= 0x7feb352dU;
+      x ^= x >> 15;
+      x *= 0x846ca68bU;
+      x ^= x >> 16;
+      return x;
+    }
+
+    static uint32_t Fold(SizeValueType value)
+    {
+      const uint32_t low = static_cast< uint32_t >( value );
+      const uint32_t high = static_cast< uint32_t >( ( value >> 16 ) >> 16 );
+
+      return low ^ Hash(high);
+    }
+
+    uint32_t Next()
+    {
+      ++m_Counter;
+      return Hash( m_Key + 0x9e3779b9U * m_Counter );
+    }
+
+    uint32_t m_Key;
+    uint32_t m_Counter;
+  };
+
+  /** Return the number of samples of the virtual region.  By default, the
+   * sampling percentage of the number of voxels, and at least one. */
+  virtual SizeValueType ComputeNumberOfSamples() const;
+
+  /** Select the voxel of the given sample. */
+  virtual void SelectSample(SizeValueType sample, RandomGenerator & random,
+                            VirtualIndexType & index) const = 0;
+
+  /** Get the index of the voxel at the given offset in the virtual region. */
+  void ComputeIndex(SizeValueType offset, VirtualIndexType & index) const;
+
+  /** Get the virtual image and region being sampled. */
+  const VirtualImageType * GetVirtualImage() const
+  { return m_VirtualImage.GetPointer(); }
+  const VirtualRegionType & GetVirtualRegion() const
+  { return m_VirtualRegion; }
+
+  /** Get the generation of the samples being generated. */
+  SizeValueType GetGeneration() const
+  { return m_Generation; }
+
+private:
+  ImageToImageMetricv4SamplerBase(const Self &); //purposely not implemented
+  void operator=(const Self &);                  //purposely not implemented
+
+  typedef ImageToImageMetricv4SamplerThreader< Self > ThreaderType;
+  friend class ImageToImageMetricv4SamplerThreader< Self >;
+
+  /** Generate the samples of a subrange.  Called by the threader. */
+  void ThreadedGenerateSamples(const typename ThreaderType::DomainType & subRange) const;
+
+  double        m_SamplingPercentage;
+  SeedType      m_Seed;
+  bool          m_PerturbSamples;
+  SizeValueType m_NumberOfSamples;
+
+  typename VirtualImageType::ConstPointer m_VirtualImage;
+  VirtualRegionType                       m_VirtualRegion;
+
+  typename ThreaderType::Pointer m_Threader;
+
+  /** Generation and points being generated. */
+  mutable SizeValueType                             m_Generation;
+  mutable typename VirtualPointSetType::PointType * m_SampledPoints;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkImageToImageMetricv4SamplerBase.hxx"
+#endif
+
+#endif
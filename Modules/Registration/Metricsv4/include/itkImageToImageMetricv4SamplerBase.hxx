@@ -0,0 +1,182 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageToImageMetricv4SamplerBase_hxx
+#define __itkImageToImageMetricv4SamplerBase_hxx
+
+#include "itkImageToImageMetricv4SamplerBase.h"
+#include "itkContinuousIndex.h"
+
+namespace itk
+{
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+ImageToImageMetricv4SamplerBase< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::ImageToImageMetricv4SamplerBase()
+{
+  this->m_SamplingPercentage = 0.01;
+  this->m_Seed = 1234;
+  this->m_PerturbSamples = true;
+  this->m_NumberOfSamples = 0;
+  this->m_Threader = ThreaderType::New();
+  this->m_Generation = 0;
+  this->m_SampledPoints = NULL;
+}
+
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+void
+ImageToImageMetricv4SamplerBase< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::Initialize(const MetricType *metric)
+{
+  if ( !metric )
+    {
+    itkExceptionMacro("The metric is not present.");
+    }
+  this->m_VirtualImage = metric->GetVirtualImage();
+  if ( this->m_VirtualImage.IsNull() )
+    {
+    itkExceptionMacro("The virtual domain of the metric is not set.");
+    }
+  this->m_VirtualRegion = metric->GetVirtualRegion();
+  if ( this->m_VirtualRegion.GetNumberOfPixels() == 0 )
+    {
+    itkExceptionMacro("The virtual region is empty.");
+    }
+
+  this->m_NumberOfSamples = this->ComputeNumberOfSamples();
+  if ( this->m_NumberOfSamples == 0 )
+    {
+    itkExceptionMacro("No samples are drawn from the virtual region.");
+    }
+}
+
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+SizeValueType
+ImageToImageMetricv4SamplerBase< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::ComputeNumberOfSamples() const
+{
+  const SizeValueType numberOfSamples = static_cast< SizeValueType >(
+    this->m_VirtualRegion.GetNumberOfPixels() * this->m_SamplingPercentage );
+
+  return numberOfSamples > 0 ? numberOfSamples : 1;
+}
+
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+void
+ImageToImageMetricv4SamplerBase< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::GenerateSamples(VirtualPointSetType *pointSet, SizeValueType generation) const
+{
+  if ( this->m_NumberOfSamples == 0 )
+    {
+    itkExceptionMacro("The sampler is not initialized.");
+    }
+
+  typename VirtualPointSetType::PointsContainer *points = pointSet->GetPoints();
+  points->CastToSTLContainer().resize(this->m_NumberOfSamples);
+
+  this->m_Generation = generation;
+  this->m_SampledPoints = &( points->CastToSTLContainer()[0] );
+
+  typename ThreaderType::DomainType range;
+  range[0] = 0;
+  range[1] = this->m_NumberOfSamples - 1;
+  this->m_Threader->Execute(const_cast< Self * >( this ), range);
+
+  this->m_SampledPoints = NULL;
+  points->Modified();
+}
+
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+void
+ImageToImageMetricv4SamplerBase< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::ThreadedGenerateSamples(const typename ThreaderType::DomainType & subRange) const
+{
+  // The perturbation is kept strictly within the voxel, so that the virtual
+  // index of a sample is the index of the selected voxel.
+  const double perturbation = 0.999;
+
+  ContinuousIndex< double, VirtualImageDimension > cindex;
+  VirtualIndexType                                 index;
+  VirtualPointType                                 point;
+
+  for ( SizeValueType i = subRange[0]; i <= static_cast< SizeValueType >( subRange[1] ); ++i )
+    {
+    RandomGenerator random(this->m_Seed, this->m_Generation, i);
+    this->SelectSample(i, random, index);
+    for ( unsigned int d = 0; d < VirtualImageDimension; d++ )
+      {
+      cindex[d] = index[d];
+      if ( this->m_PerturbSamples )
+        {
+        cindex[d] += perturbation * ( random.GetVariate() - 0.5 );
+        }
+      }
+    this->m_VirtualImage->TransformContinuousIndexToPhysicalPoint(cindex, point);
+    this->m_SampledPoints[i].CastFrom(point);
+    }
+}
+
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+void
+ImageToImageMetricv4SamplerBase< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::ComputeIndex(SizeValueType offset, VirtualIndexType & index) const
+{
+  const VirtualSizeType & size = this->m_VirtualRegion.GetSize();
+
+  index = this->m_VirtualRegion.GetIndex();
+  for ( unsigned int d = 0; d < VirtualImageDimension; d++ )
+    {
+    index[d] += static_cast< IndexValueType >( offset % size[d] );
+    offset /= size[d];
+    }
+}
+
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+void
+ImageToImageMetricv4SamplerBase< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::SetMaximumNumberOfThreads(const ThreadIdType threads)
+{
+  if ( threads != this->m_Threader->GetMaximumNumberOfThreads() )
+    {
+    this->m_Threader->SetMaximumNumberOfThreads(threads);
+    this->Modified();
+    }
+}
+
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+ThreadIdType
+ImageToImageMetricv4SamplerBase< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::GetMaximumNumberOfThreads() const
+{
+  return this->m_Threader->GetMaximumNumberOfThreads();
+}
+
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+void
+ImageToImageMetricv4SamplerBase< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "SamplingPercentage: " << this->m_SamplingPercentage << std::endl;
+  os << indent << "Seed: " << this->m_Seed << std::endl;
+  os << indent << "PerturbSamples: " << this->m_PerturbSamples << std::endl;
+  os << indent << "NumberOfSamples: " << this->m_NumberOfSamples << std::endl;
+  os << indent << "VirtualRegion: " << this->m_VirtualRegion << std::endl;
+}
+} // end namespace itk
+
+#endif
@@ -0,0 +1,72 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageToImageMetricv4SamplerThreader_h
+#define __itkImageToImageMetricv4SamplerThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+
+namespace itk
+{
+
+/** \class ImageToImageMetricv4SamplerThreader
+ * \brief Generates the samples of an ImageToImageMetricv4SamplerBase in
+ * parallel.
+ *
+ * The range of sample numbers is split between the threads, and each thread
+ * calls \c ThreadedGenerateSamples on the sampler for its subrange.
+ *
+ * \ingroup ITKMetricsv4
+ */
+template < class TSampler >
+class ImageToImageMetricv4SamplerThreader
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, TSampler >
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageToImageMetricv4SamplerThreader                             Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner, TSampler > Superclass;
+  typedef SmartPointer< Self >                                            Pointer;
+  typedef SmartPointer< const Self >                                      ConstPointer;
+
+  itkTypeMacro( ImageToImageMetricv4SamplerThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+
+protected:
+  ImageToImageMetricv4SamplerThreader() {}
+
+  /** Generate the samples of the subrange. */
+  virtual void ThreadedExecution( const DomainType & subRange,
+                                  const ThreadIdType threadId );
+
+private:
+  ImageToImageMetricv4SamplerThreader( const Self & ); // purposely not implemented
+  void operator=( const Self & ); // purposely not implemented
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkImageToImageMetricv4SamplerThreader.hxx"
+#endif
+
+#endif
@@ -73,6 +73,17 @@ JointHistogramMutualInformationGetValueAndDerivativeThreader< TDomainPartitioner
     }
 }
 
+template< class TDomainPartitioner, class TImageToImageMetric, class TJointHistogramMetric >
+void
+JointHistogramMutualInformationGetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TJointHistogramMetric >
+::ProcessVirtualPoints( const VirtualIndexType * virtualIndices,
+                        const VirtualPointType * virtualPoints,
+                        const SizeValueType numberOfPoints,
+                        const ThreadIdType threadId )
+{
+  this->ProcessVirtualPointsInBatch( virtualIndices, virtualPoints, numberOfPoints, threadId );
+}
+
 template< class TDomainPartitioner, class TImageToImageMetric, class TJointHistogramMetric >
 bool
 JointHistogramMutualInformationGetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TJointHistogramMetric >
@@ -41,15 +41,15 @@ namespace itk
  * \ingroup ITKMetricsv4
  */
 
-template<class TFixedImage,class TMovingImage,class TVirtualImage = TFixedImage>
+template<class TFixedImage,class TMovingImage,class TVirtualImage = TFixedImage, class TInternalComputationValueType = double>
 class ITK_EXPORT JointHistogramMutualInformationImageToImageMetricv4 :
-  public ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
+  public ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType>
 {
 public:
 
   /** Standard class typedefs. */
   typedef JointHistogramMutualInformationImageToImageMetricv4            Self;
-  typedef ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage> Superclass;
+  typedef ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType> Superclass;
   typedef SmartPointer<Self>                                             Pointer;
   typedef SmartPointer<const Self>                                       ConstPointer;
 
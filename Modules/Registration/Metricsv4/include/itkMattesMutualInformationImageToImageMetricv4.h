@@ -20,6 +20,7 @@
 
 #include "itkImageToImageMetricv4.h"
 #include "itkMattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader.h"
+#include "itkMattesMutualInformationImageToImageMetricv4JointPDFReductionThreader.h"
 #include "itkPoint.h"
 #include "itkIndex.h"
 #include "itkBSplineDerivativeKernelFunction.h"
@@ -62,10 +63,19 @@ namespace itk
  * \warning Local-support transforms are not yet supported. If used,
  * an exception is thrown during Initialize().
  *
- * \note The per-iteration post-processing code is not multi-threaded, but could be
- * readily be made so for a small performance gain.
- * See GetValueCommonAfterThreadedExecution(), GetValueAndDerivative()
- * and threader::AfterThreadedExecution().
+ * With a global-support transform, the derivatives of the joint PDF with
+ * respect to the transform parameters are accumulated by default into one
+ * array per thread, of NumberOfHistogramBins^2 times the number of
+ * parameters each, which are summed after the points have been processed.
+ * For transforms with many parameters, such as BSpline transforms, these
+ * copies dominate the memory use of the metric. With
+ * UseSharedJointPDFDerivativesOn() all threads accumulate into a single
+ * array instead, serializing the updates of each fixed image bin with a
+ * lock, which removes the copies and their summation. Only the transform
+ * parameters with a nonzero Jacobian are updated for each point.
+ *
+ * The per-thread joint PDFs are summed in parallel over the fixed image
+ * bins, see MattesMutualInformationImageToImageMetricv4JointPDFReductionThreader.
  *
  * The algorithm and much of the code was copied from the previous
  * Mattes MI metric, i.e. itkMattesMutualInformationImageToImageMetric.
@@ -92,14 +102,14 @@ namespace itk
  * \sa itkImageToImageMetricv4
  * \ingroup ITKMetricsv4
  */
-template <class TFixedImage, class TMovingImage, class TVirtualImage = TFixedImage >
+template <class TFixedImage, class TMovingImage, class TVirtualImage = TFixedImage, class TInternalComputationValueType = double >
 class ITK_EXPORT MattesMutualInformationImageToImageMetricv4 :
-public ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
+public ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType>
 {
 public:
   /** Standard class typedefs. */
   typedef MattesMutualInformationImageToImageMetricv4                    Self;
-  typedef ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage> Superclass;
+  typedef ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType> Superclass;
   typedef SmartPointer<Self>                                             Pointer;
   typedef SmartPointer<const Self>                                       ConstPointer;
 
@@ -147,6 +157,16 @@ public:
   itkSetClampMacro( NumberOfHistogramBins, SizeValueType, 5, NumericTraits<SizeValueType>::max() );
   itkGetConstReferenceMacro(NumberOfHistogramBins, SizeValueType);
 
+  /** Accumulate the joint PDF derivatives of global-support transforms
+   * into a single array shared by all threads, instead of into one array
+   * per thread that are summed afterwards. This divides the memory used for
+   * the derivatives by the number of threads and removes their summation,
+   * at the cost of locking a fixed image bin for each point. Off by
+   * default. Has no effect with local-support transforms. */
+  itkSetMacro(UseSharedJointPDFDerivatives, bool);
+  itkGetConstMacro(UseSharedJointPDFDerivatives, bool);
+  itkBooleanMacro(UseSharedJointPDFDerivatives);
+
   virtual void Initialize(void) throw ( itk::ExceptionObject );
 
   /** The marginal PDFs are stored as std::vector. */
@@ -197,6 +217,9 @@ protected:
     MattesMutualInformationDenseGetValueAndDerivativeThreaderType;
   typedef MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< ThreadedIndexedContainerPartitioner, Superclass, Self >
     MattesMutualInformationSparseGetValueAndDerivativeThreaderType;
+  friend class MattesMutualInformationImageToImageMetricv4JointPDFReductionThreader< Self >;
+  typedef MattesMutualInformationImageToImageMetricv4JointPDFReductionThreader< Self >
+    JointPDFReductionThreaderType;
 
   void PrintSelf(std::ostream& os, Indent indent) const;
 
@@ -252,11 +275,17 @@ protected:
   typename std::vector<JointPDFType::Pointer>            m_ThreaderJointPDF;
   typename std::vector<JointPDFDerivativesType::Pointer> m_ThreaderJointPDFDerivatives;
 
-  std::vector<int> m_ThreaderJointPDFStartBin;
-  std::vector<int> m_ThreaderJointPDFEndBin;
-
+  /** Sums of the joint PDF over the bins of each reduction thread. */
   mutable std::vector<PDFValueType> m_ThreaderJointPDFSum;
 
+  /** Shared accumulation of the joint PDF derivatives, with one lock per
+   * fixed image bin. */
+  bool                                  m_UseSharedJointPDFDerivatives;
+  std::vector<FastMutexLock::Pointer>   m_JointPDFDerivativesLocks;
+
+  /** Sums the per-thread joint PDFs and joint PDF derivatives. */
+  typename JointPDFReductionThreaderType::Pointer m_JointPDFReductionThreader;
+
   /** Store the per-point local derivative result by parzen window bin.
    * For local-support transforms only. */
   mutable std::vector<DerivativeType>              m_LocalDerivativeByParzenBin;
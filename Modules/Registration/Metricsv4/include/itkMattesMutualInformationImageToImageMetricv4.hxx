@@ -23,8 +23,8 @@
 namespace itk
 {
 
-template < class TFixedImage, class TMovingImage, class TVirtualImage >
-MattesMutualInformationImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualImage>
+template < class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+MattesMutualInformationImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualImage, TInternalComputationValueType>
 ::MattesMutualInformationImageToImageMetricv4() :
   m_NumberOfHistogramBins(50),
   m_MovingImageNormalizedMin(0.0),
@@ -46,18 +46,19 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualIma
   // For multi-threading the metric
   m_ThreaderJointPDF(0),
   m_ThreaderJointPDFDerivatives(0),
-  m_ThreaderJointPDFStartBin(0),
-  m_ThreaderJointPDFEndBin(0),
-  m_ThreaderJointPDFSum(0)
+  m_ThreaderJointPDFSum(0),
+  m_UseSharedJointPDFDerivatives(false)
 {
   // We have our own GetValueAndDerivativeThreader's that we want
   // ImageToImageMetricv4 to use.
   this->m_DenseGetValueAndDerivativeThreader  = MattesMutualInformationDenseGetValueAndDerivativeThreaderType::New();
   this->m_SparseGetValueAndDerivativeThreader = MattesMutualInformationSparseGetValueAndDerivativeThreaderType::New();
+
+  this->m_JointPDFReductionThreader = JointPDFReductionThreaderType::New();
 }
 
-template < class TFixedImage, class TMovingImage, class TVirtualImage >
-MattesMutualInformationImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualImage>
+template < class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+MattesMutualInformationImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualImage, TInternalComputationValueType>
 ::~MattesMutualInformationImageToImageMetricv4()
 {
 }
@@ -66,9 +67,9 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualIma
 /**
  * Initialize
  */
-template <class TFixedImage, class TMovingImage, class TVirtualImage>
+template <class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType>
 void
-MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
+MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType>
 ::Initialize(void) throw ( itk::ExceptionObject )
 {
   /* Superclass initialization */
@@ -178,13 +179,13 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualI
    * is now performed in the threader BeforeThreadedExecution method */
   }
 
-template <class TFixedImage, class TMovingImage, class TVirtualImage>
+template <class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType>
 void
-MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
+MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType>
 ::ComputeResults() const
 {
   // Collect some results
-  for( ThreadIdType threadID = 1; threadID < this->GetNumberOfThreadsUsed(); threadID++ )
+  for( SizeValueType threadID = 1; threadID < this->m_ThreaderJointPDFSum.size(); threadID++ )
     {
     this->m_ThreaderJointPDFSum[0] += this->m_ThreaderJointPDFSum[threadID];
     }
@@ -323,66 +324,45 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualI
 /**
  * Common post-threading code.
  */
-template <class TFixedImage, class TMovingImage, class TVirtualImage>
+template <class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType>
 void
-MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
+MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType>
 ::GetValueCommonAfterThreadedExecution()
 {
   // This method is from MattesMutualImageToImageMetric::GetValueThreadPostProcess. Common
   // code used by GetValue and GetValueAndDerivative.
-  // Should be threaded. But if modified to do so, should probably not be threaded
-  // separately, but rather as a part of all post-processing.
-  for( ThreadIdType threadID = 0; threadID < this->GetNumberOfThreadsUsed(); threadID++ )
+  // The per-thread joint PDFs, fixed image marginal PDFs and joint PDF
+  // derivatives are summed in parallel over the fixed image bins.
+  if( this->m_JointPDFReductionThreader->GetMaximumNumberOfThreads() != this->GetMaximumNumberOfThreads() )
     {
-    const int maxI = this->m_NumberOfHistogramBins * ( this->m_ThreaderJointPDFEndBin[threadID] - this->m_ThreaderJointPDFStartBin[threadID] + 1 );
-
-    const unsigned int tPdfPtrOffset = ( this->m_ThreaderJointPDFStartBin[threadID] * this->m_ThreaderJointPDF[0]->GetOffsetTable()[1] );
-    JointPDFValueType * const pdfPtrStart = this->m_ThreaderJointPDF[0]->GetBufferPointer() + tPdfPtrOffset;
-
-    // The PDF domain is chunked based on thread.  Each thread consolodates independent parts of the PDF.
-    for( unsigned int t = 1; t < this->GetNumberOfThreadsUsed(); t++ )
-      {
-      JointPDFValueType *                 pdfPtr = pdfPtrStart;
-      JointPDFValueType const *          tPdfPtr = this->m_ThreaderJointPDF[t]->GetBufferPointer() + tPdfPtrOffset;
-      JointPDFValueType const * const tPdfPtrEnd = tPdfPtr + maxI;
-      // for(i=0; i < maxI; i++)
-      while( tPdfPtr < tPdfPtrEnd )
-        {
-        *( pdfPtr++ ) += *( tPdfPtr++ );
-        }
-      for( int i = this->m_ThreaderJointPDFStartBin[threadID]; i <= this->m_ThreaderJointPDFEndBin[threadID]; i++ )
-        {
-        this->m_ThreaderFixedImageMarginalPDF[0][i] += this->m_ThreaderFixedImageMarginalPDF[t][i];
-        }
-      }
-    // Sum of this threads domain into the this->m_ThreaderJointPDFSum that covers that part of the domain.
-    PDFValueType                    jointPDFSum = 0.0;
-    JointPDFValueType const * pdfPtr = pdfPtrStart;
-    for( int i = 0; i < maxI; i++ )
-      {
-      jointPDFSum += *( pdfPtr++ );
-      }
-    this->m_ThreaderJointPDFSum[threadID] = jointPDFSum;
-  }
+    this->m_JointPDFReductionThreader->SetMaximumNumberOfThreads( this->GetMaximumNumberOfThreads() );
+    }
+  typename JointPDFReductionThreaderType::DomainType binRange;
+  binRange[0] = 0;
+  binRange[1] = this->m_NumberOfHistogramBins - 1;
+  this->m_JointPDFReductionThreader->Execute( this, binRange );
 }
 
 /**
  * PrintSelf
  */
-template < class TFixedImage, class TMovingImage, class TVirtualImage  >
+template < class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType  >
 void
-MattesMutualInformationImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualImage>
+MattesMutualInformationImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualImage, TInternalComputationValueType>
 ::PrintSelf(std::ostream& os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfHistogramBins: " << this->m_NumberOfHistogramBins << std::endl;
+  os << indent << "UseSharedJointPDFDerivatives: "
+     << ( this->m_UseSharedJointPDFDerivatives ? "On" : "Off" ) << std::endl;
 }
 
 /**
  * ComputeSingleFixedImageParzenWindowIndex.
  */
-template <class TFixedImage, class TMovingImage, class TVirtualImage>
+template <class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType>
 OffsetValueType
-MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
+MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType>
 ::ComputeSingleFixedImageParzenWindowIndex( const FixedImagePixelType & value ) const
 {
   // Note. The previous version of this metric pre-computed these values
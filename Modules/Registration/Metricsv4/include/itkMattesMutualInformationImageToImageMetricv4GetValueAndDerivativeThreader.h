@@ -19,6 +19,7 @@
 #define __itkMattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader_h
 
 #include "itkImageToImageMetricv4GetValueAndDerivativeThreader.h"
+#include "itkFastMutexLock.h"
 
 namespace itk
 {
@@ -104,7 +105,22 @@ protected:
         DerivativeType &                  localDerivativeReturn,
         const ThreadIdType                threadID ) const;
 
-  /** Compute PDF derivative contribution for each parameter. */
+  /** Interpolate the moving image values of the points together, with
+   * ProcessVirtualPointsInBatch(). */
+  virtual void ProcessVirtualPoints( const VirtualIndexType * virtualIndices,
+                                     const VirtualPointType * virtualPoints,
+                                     const SizeValueType numberOfPoints,
+                                     const ThreadIdType threadId );
+
+  /** Compute the products of the transform Jacobian with the moving image
+   * gradient for a global-support transform, keeping only the nonzero
+   * products and their parameters. */
+  virtual void ComputeJacobianGradientProducts(const ThreadIdType threadID,
+                             const JacobianType &            jacobian,
+                             const MovingImageGradientType & movingGradient) const;
+
+  /** Compute PDF derivative contribution for each parameter of a
+   * local-support transform. */
   virtual void ComputePDFDerivatives(const ThreadIdType &    threadID,
                              const OffsetValueType &         fixedImageParzenWindowIndex,
                              const JacobianType &            jacobian,
@@ -113,6 +129,11 @@ protected:
                              const PDFValueType &            cubicBSplineDerivativeValue,
                              DerivativeValueType *           localSupportDerivativeResultPtr) const;
 
+  /** Per-thread nonzero products of the transform Jacobian with the moving
+   * image gradient, and the parameters they belong to. */
+  mutable std::vector< std::vector< PDFValueType > >           m_JacobianGradientProductPerThread;
+  mutable std::vector< std::vector< NumberOfParametersType > > m_JacobianGradientParameterPerThread;
+
 private:
   MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader( const Self & ); // purposely not implemented
   void operator=( const Self & ); // purposely not implemented
@@ -49,20 +49,6 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
   associate->m_ThreaderFixedImageMarginalPDF.resize(associate->GetNumberOfThreadsUsed(),
                                          std::vector<PDFValueType>(associate->m_NumberOfHistogramBins, 0.0F) );
 
-  associate->m_ThreaderJointPDFStartBin.resize( this->GetNumberOfThreadsUsed() );
-  associate->m_ThreaderJointPDFEndBin.resize(this->GetNumberOfThreadsUsed() );
-  const OffsetValueType binRange = associate->m_NumberOfHistogramBins / this->GetNumberOfThreadsUsed();
-  for( ThreadIdType threadID = 0; threadID < this->GetNumberOfThreadsUsed(); threadID++ )
-    {
-    associate->m_ThreaderJointPDFStartBin[threadID] = threadID * binRange;
-    associate->m_ThreaderJointPDFEndBin[threadID] = ( threadID + 1 ) * binRange - 1;
-    }
-  // Ensure that the last EndBin range contains the last histogram bin
-  associate->m_ThreaderJointPDFStartBin[this->GetNumberOfThreadsUsed() - 1] = ( this->GetNumberOfThreadsUsed() - 1 ) * binRange;
-  associate->m_ThreaderJointPDFEndBin[this->GetNumberOfThreadsUsed() - 1] = associate->m_NumberOfHistogramBins - 1;
-
-  associate->m_ThreaderJointPDFSum.resize(this->GetNumberOfThreadsUsed());
-
   JointPDFRegionType jointPDFRegion;
   // For the joint PDF define a region starting from {0,0}
   // with size {m_NumberOfHistogramBins, this->m_NumberOfHistogramBins}.
@@ -153,9 +139,27 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
       jointPDFDerivativesRegion.SetIndex(jointPDFDerivativesIndex);
       jointPDFDerivativesRegion.SetSize(jointPDFDerivativesSize);
 
-      associate->m_ThreaderJointPDFDerivatives.resize(this->GetNumberOfThreadsUsed());
+      // With shared accumulation, a single copy is updated by all threads
+      // under one lock per fixed image bin.
+      if( associate->m_UseSharedJointPDFDerivatives )
+        {
+        associate->m_ThreaderJointPDFDerivatives.resize(1);
+        if( associate->m_JointPDFDerivativesLocks.size() != associate->m_NumberOfHistogramBins )
+          {
+          associate->m_JointPDFDerivativesLocks.resize( associate->m_NumberOfHistogramBins );
+          for( SizeValueType bin = 0; bin < associate->m_NumberOfHistogramBins; bin++ )
+            {
+            associate->m_JointPDFDerivativesLocks[bin] = FastMutexLock::New();
+            }
+          }
+        }
+      else
+        {
+        associate->m_ThreaderJointPDFDerivatives.resize(this->GetNumberOfThreadsUsed());
+        associate->m_JointPDFDerivativesLocks.clear();
+        }
       // Set the regions and allocate
-      for( ThreadIdType threadID = 0; threadID < this->GetNumberOfThreadsUsed(); threadID++ )
+      for( SizeValueType threadID = 0; threadID < associate->m_ThreaderJointPDFDerivatives.size(); threadID++ )
         {
         associate->m_ThreaderJointPDFDerivatives[threadID] = JointPDFDerivativesType::New();
         associate->m_ThreaderJointPDFDerivatives[threadID]->SetRegions( jointPDFDerivativesRegion);
@@ -164,6 +168,9 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
       }
     }
 
+  this->m_JacobianGradientProductPerThread.resize( this->GetNumberOfThreadsUsed() );
+  this->m_JacobianGradientParameterPerThread.resize( this->GetNumberOfThreadsUsed() );
+
   /**
    * Setup the kernels used for the Parzen windows.
    */
@@ -176,17 +183,28 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
     {
     std::fill( associate->m_ThreaderFixedImageMarginalPDF[threadID].begin(), associate->m_ThreaderFixedImageMarginalPDF[threadID].end(), 0.0F);
     associate->m_ThreaderJointPDF[threadID]->FillBuffer(0.0F);
-    if( this->GetComputeDerivative() )
+    }
+  if( this->GetComputeDerivative() )
+    {
+    for( SizeValueType threadID = 0; threadID < associate->m_ThreaderJointPDFDerivatives.size(); threadID++ )
       {
-      if( ! associate->HasLocalSupport() )
-        {
-        associate->m_ThreaderJointPDFDerivatives[threadID]->FillBuffer(0.0F);
-        }
+      associate->m_ThreaderJointPDFDerivatives[threadID]->FillBuffer(0.0F);
       }
     }
 }
 
 
+template< class TDomainPartitioner, class TImageToImageMetric, class TMattesMutualInformationMetric >
+void
+MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TMattesMutualInformationMetric >
+::ProcessVirtualPoints( const VirtualIndexType * virtualIndices,
+                        const VirtualPointType * virtualPoints,
+                        const SizeValueType numberOfPoints,
+                        const ThreadIdType threadId )
+{
+  this->ProcessVirtualPointsInBatch( virtualIndices, virtualPoints, numberOfPoints, threadId );
+}
+
 template< class TDomainPartitioner, class TImageToImageMetric, class TMattesMutualInformationMetric >
 bool
 MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TMattesMutualInformationMetric >
@@ -288,6 +306,29 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
     associate->GetMovingTransform()->ComputeJacobianWithRespectToParameters( virtualPoint, jacobian);
     }
 
+  // With global support transforms, the products of the Jacobian with the
+  // moving image gradient are computed once for the four affected bins, and
+  // only the parameters with a nonzero product are updated.
+  const bool computeGlobalDerivatives = this->GetComputeDerivative()
+    && associate->m_MovingTransform->GetTransformCategory() != MovingTransformType::DisplacementField;
+  JointPDFDerivativesValueType * derivPtr = NULL;
+  FastMutexLock * derivativesLock = NULL;
+  if( computeGlobalDerivatives )
+    {
+    this->ComputeJacobianGradientProducts( threadID, jacobian, movingImageGradient );
+
+    const ThreadIdType derivativesID = associate->m_UseSharedJointPDFDerivatives ? 0 : threadID;
+    JointPDFDerivativesType * jointPDFDerivatives = associate->m_ThreaderJointPDFDerivatives[derivativesID];
+    derivPtr = jointPDFDerivatives->GetBufferPointer()
+      + ( fixedImageParzenWindowIndex * jointPDFDerivatives->GetOffsetTable()[2] )
+      + ( pdfMovingIndex * jointPDFDerivatives->GetOffsetTable()[1] );
+    if( associate->m_UseSharedJointPDFDerivatives )
+      {
+      derivativesLock = associate->m_JointPDFDerivativesLocks[fixedImageParzenWindowIndex];
+      derivativesLock->Lock();
+      }
+    }
+
   SizeValueType movingParzenBin = 0;
 
   while( pdfMovingIndex <= pdfMovingIndexMax )
@@ -300,24 +341,31 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
       // Compute the cubicBSplineDerivative for later repeated use.
       const PDFValueType cubicBSplineDerivativeValue = associate->m_CubicBSplineDerivativeKernel->Evaluate(movingImageParzenWindowArg);
 
-      // Pointer to local derivative partial result container.
-      // Not used with global support transforms.
-      DerivativeValueType * localSupportDerivativeResultPtr = NULL;
-
-    if( associate->m_MovingTransform->GetTransformCategory() == MovingTransformType::DisplacementField )
-      {
-      // ptr to where the derivative result should go, for efficiency
-      localSupportDerivativeResultPtr = &( associate->m_LocalDerivativeByParzenBin[movingParzenBin][localDerivativeOffset] );
-      }
-
-      // Compute PDF derivative contribution.
-      this->ComputePDFDerivatives(threadID,
-                                  fixedImageParzenWindowIndex,
-                                  jacobian,
-                                  pdfMovingIndex,
-                                  movingImageGradient,
-                                  cubicBSplineDerivativeValue,
-                                  localSupportDerivativeResultPtr);
+      if( computeGlobalDerivatives )
+        {
+        const std::vector< PDFValueType > & products = this->m_JacobianGradientProductPerThread[threadID];
+        const std::vector< NumberOfParametersType > & parameters = this->m_JacobianGradientParameterPerThread[threadID];
+        for( SizeValueType k = 0; k < products.size(); k++ )
+          {
+          derivPtr[parameters[k]] -= products[k] * cubicBSplineDerivativeValue;
+          }
+        derivPtr += associate->GetNumberOfLocalParameters();
+        }
+      else
+        {
+        // ptr to where the derivative result should go, for efficiency
+        DerivativeValueType * localSupportDerivativeResultPtr =
+          &( associate->m_LocalDerivativeByParzenBin[movingParzenBin][localDerivativeOffset] );
+
+        // Compute PDF derivative contribution.
+        this->ComputePDFDerivatives(threadID,
+                                    fixedImageParzenWindowIndex,
+                                    jacobian,
+                                    pdfMovingIndex,
+                                    movingImageGradient,
+                                    cubicBSplineDerivativeValue,
+                                    localSupportDerivativeResultPtr);
+        }
       }
 
     movingImageParzenWindowArg += 1.0;
@@ -325,6 +373,11 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
     ++movingParzenBin;
     }
 
+  if( derivativesLock )
+    {
+    derivativesLock->Unlock();
+    }
+
   // have to do this here since we're returning false
   this->m_NumberOfValidPointsPerThread[threadID]++;
 
@@ -332,16 +385,48 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
   return false;
 }
 
+/**
+ * ComputeJacobianGradientProducts
+ */
+template< class TDomainPartitioner, class TImageToImageMetric, class TMattesMutualInformationMetric >
+void
+MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TMattesMutualInformationMetric >
+::ComputeJacobianGradientProducts(const ThreadIdType              threadID,
+                                  const JacobianType &            jacobian,
+                                  const MovingImageGradientType & movingImageGradient) const
+{
+  TMattesMutualInformationMetric * associate = dynamic_cast<TMattesMutualInformationMetric*>(this->m_Associate);
+
+  std::vector< PDFValueType > & products = this->m_JacobianGradientProductPerThread[threadID];
+  std::vector< NumberOfParametersType > & parameters = this->m_JacobianGradientParameterPerThread[threadID];
+  products.clear();
+  parameters.clear();
+
+  for( NumberOfParametersType mu = 0; mu < associate->GetNumberOfLocalParameters(); mu++ )
+    {
+    PDFValueType innerProduct = 0.0;
+    for( SizeValueType dim = 0; dim < associate->MovingImageDimension; dim++ )
+      {
+      innerProduct += jacobian[dim][mu] * movingImageGradient[dim];
+      }
+    if( innerProduct != 0.0 )
+      {
+      products.push_back( innerProduct );
+      parameters.push_back( mu );
+      }
+    }
+}
+
 /**
  * ComputePDFDerivative
  */
 template< class TDomainPartitioner, class TImageToImageMetric, class TMattesMutualInformationMetric >
 void
 MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TMattesMutualInformationMetric >
-::ComputePDFDerivatives(const ThreadIdType &            threadID,
-                        const OffsetValueType &         fixedImageParzenWindowIndex,
+::ComputePDFDerivatives(const ThreadIdType &,
+                        const OffsetValueType &,
                         const JacobianType &            jacobian,
-                        const OffsetValueType &         pdfMovingIndex,
+                        const OffsetValueType &,
                         const MovingImageGradientType & movingImageGradient,
                         const PDFValueType &            cubicBSplineDerivativeValue,
                         DerivativeValueType *           localSupportDerivativeResultPtr) const
@@ -349,18 +434,7 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
   /* Convenience assignment */
   TMattesMutualInformationMetric * associate = dynamic_cast<TMattesMutualInformationMetric*>(this->m_Associate);
 
-  // Update bins in the PDF derivatives for the current intensity pair
-
-  const OffsetValueType pdfFixedIndex = fixedImageParzenWindowIndex;
-
-  JointPDFDerivativesValueType *derivPtr=0;
-  if( associate->m_MovingTransform->GetTransformCategory() != MovingTransformType::DisplacementField )
-    {
-    derivPtr = associate->m_ThreaderJointPDFDerivatives[threadID]->GetBufferPointer()
-      + ( pdfFixedIndex  * associate->m_ThreaderJointPDFDerivatives[threadID]->GetOffsetTable()[2] )
-      + ( pdfMovingIndex * associate->m_ThreaderJointPDFDerivatives[threadID]->GetOffsetTable()[1] );
-    }
-
+  // Update the local-support derivative for the current intensity pair
   for( NumberOfParametersType mu = 0; mu < associate->GetNumberOfLocalParameters(); mu++ )
     {
     PDFValueType innerProduct = 0.0;
@@ -370,16 +444,8 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
       }
 
     const PDFValueType derivativeContribution = innerProduct * cubicBSplineDerivativeValue;
-    if( associate->m_MovingTransform->GetTransformCategory() == MovingTransformType::DisplacementField )
-      {
-      *( localSupportDerivativeResultPtr ) += derivativeContribution;
-      localSupportDerivativeResultPtr++;
-      }
-    else
-      {
-      *( derivPtr ) -= derivativeContribution;
-      ++derivPtr;
-      }
+    *( localSupportDerivativeResultPtr ) += derivativeContribution;
+    localSupportDerivativeResultPtr++;
     }
 }
 
@@ -402,48 +468,10 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
   /* Porting: This code is from
    * MattesMutualInformationImageToImageMetric::GetValueAndDerivativeThreadPostProcess */
 
-  /* Post-processing that is common the GetValue and GetValueAndDerivative */
+  /* Post-processing that is common the GetValue and GetValueAndDerivative.
+   * This also sums and normalizes the joint PDF derivatives. */
   associate->GetValueCommonAfterThreadedExecution();
 
-  /* This should be done via its own threader class. Previously it was threaded using
-   * old ImageToImageMetric threaded post-processing. */
-  if( this->GetComputeDerivative() )
-    {
-    if( ! associate->HasLocalSupport() )
-      {
-      for( ThreadIdType threadID = 0; threadID < this->GetNumberOfThreadsUsed(); threadID++ )
-        {
-        const NumberOfParametersType rowSize = associate->GetNumberOfLocalParameters() * associate->m_NumberOfHistogramBins;
-
-        const SizeValueType maxI = rowSize * ( associate->m_ThreaderJointPDFEndBin[threadID] - associate->m_ThreaderJointPDFStartBin[threadID] + 1 );
-
-        JointPDFDerivativesValueType *const pdfDPtrStart = associate->m_ThreaderJointPDFDerivatives[0]->GetBufferPointer()
-          + ( associate->m_ThreaderJointPDFStartBin[threadID] * rowSize );
-        const SizeValueType tPdfDPtrOffset = associate->m_ThreaderJointPDFStartBin[threadID] *  rowSize;
-        for( SizeValueType t = 1; t < this->GetNumberOfThreadsUsed(); t++ )
-          {
-          JointPDFDerivativesValueType *      pdfDPtr = pdfDPtrStart;
-          JointPDFDerivativesValueType const *tPdfDPtr = associate->m_ThreaderJointPDFDerivatives[t]->GetBufferPointer() + tPdfDPtrOffset;
-          JointPDFDerivativesValueType const * const tPdfDPtrEnd = tPdfDPtr + maxI;
-          // for(i = 0; i < maxI; i++)
-          while( tPdfDPtr < tPdfDPtrEnd )
-            {
-            *( pdfDPtr++ ) += *( tPdfDPtr++ );
-            }
-          }
-
-        const PDFValueType nFactor = 1.0 / ( associate->m_MovingImageBinSize * associate->GetNumberOfValidPoints() );
-
-        JointPDFDerivativesValueType *             pdfDPtr = pdfDPtrStart;
-        JointPDFDerivativesValueType const * const tPdfDPtrEnd = pdfDPtrStart + maxI;
-        while( pdfDPtr < tPdfDPtrEnd )
-          {
-          *( pdfDPtr++ ) *= nFactor;
-          }
-        }
-      }
-    }
-
   // Collect and compute results.
   // Value and derivative are stored in member vars.
   associate->ComputeResults();
@@ -0,0 +1,82 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkMattesMutualInformationImageToImageMetricv4JointPDFReductionThreader_h
+#define __itkMattesMutualInformationImageToImageMetricv4JointPDFReductionThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+
+namespace itk
+{
+
+/** \class MattesMutualInformationImageToImageMetricv4JointPDFReductionThreader
+ * \brief Sums the per-thread joint PDFs and joint PDF derivatives of
+ * MattesMutualInformationImageToImageMetricv4.
+ *
+ * The domain is the range of fixed image histogram bins. Each thread
+ * adds the rows of the per-thread joint PDFs, fixed image marginal PDFs and
+ * joint PDF derivatives of its bins into the first copy, normalizes the
+ * derivative rows and sums the joint PDF of its bins into its entry of the
+ * metric's \c m_ThreaderJointPDFSum.
+ *
+ * \ingroup ITKMetricsv4
+ */
+template < class TMattesMutualInformationMetric >
+class MattesMutualInformationImageToImageMetricv4JointPDFReductionThreader
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, TMattesMutualInformationMetric >
+{
+public:
+  /** Standard class typedefs. */
+  typedef MattesMutualInformationImageToImageMetricv4JointPDFReductionThreader         Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner, TMattesMutualInformationMetric > Superclass;
+  typedef SmartPointer< Self >                                                        Pointer;
+  typedef SmartPointer< const Self >                                                  ConstPointer;
+
+  itkTypeMacro( MattesMutualInformationImageToImageMetricv4JointPDFReductionThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+
+  typedef typename TMattesMutualInformationMetric::PDFValueType                 PDFValueType;
+  typedef typename TMattesMutualInformationMetric::JointPDFValueType            JointPDFValueType;
+  typedef typename TMattesMutualInformationMetric::JointPDFDerivativesValueType JointPDFDerivativesValueType;
+
+protected:
+  MattesMutualInformationImageToImageMetricv4JointPDFReductionThreader() {}
+
+  /** Allocate the per-thread sums of the joint PDF. */
+  virtual void BeforeThreadedExecution();
+
+  /** Reduce the rows of the fixed image bins in the subrange. */
+  virtual void ThreadedExecution( const DomainType & subRange,
+                                  const ThreadIdType threadId );
+
+private:
+  MattesMutualInformationImageToImageMetricv4JointPDFReductionThreader( const Self & ); // purposely not implemented
+  void operator=( const Self & ); // purposely not implemented
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkMattesMutualInformationImageToImageMetricv4JointPDFReductionThreader.hxx"
+#endif
+
+#endif
@@ -0,0 +1,111 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkMattesMutualInformationImageToImageMetricv4JointPDFReductionThreader_hxx
+#define __itkMattesMutualInformationImageToImageMetricv4JointPDFReductionThreader_hxx
+
+#include "itkMattesMutualInformationImageToImageMetricv4JointPDFReductionThreader.h"
+
+namespace itk
+{
+
+template< class TMattesMutualInformationMetric >
+void
+MattesMutualInformationImageToImageMetricv4JointPDFReductionThreader< TMattesMutualInformationMetric >
+::BeforeThreadedExecution()
+{
+  this->m_Associate->m_ThreaderJointPDFSum.assign( this->GetNumberOfThreadsUsed(), 0.0 );
+}
+
+template< class TMattesMutualInformationMetric >
+void
+MattesMutualInformationImageToImageMetricv4JointPDFReductionThreader< TMattesMutualInformationMetric >
+::ThreadedExecution( const DomainType & subRange,
+                     const ThreadIdType threadId )
+{
+  AssociateType * associate = this->m_Associate;
+
+  const SizeValueType numberOfBins = associate->m_NumberOfHistogramBins;
+  const SizeValueType numberOfPDFs = associate->m_ThreaderJointPDF.size();
+  const SizeValueType startBin = subRange[0];
+  const SizeValueType numberOfRows = subRange[1] - subRange[0] + 1;
+
+  // The PDF domain is chunked based on thread. Each thread consolidates
+  // independent rows of the PDF.
+  const SizeValueType maxI = numberOfBins * numberOfRows;
+  const SizeValueType tPdfPtrOffset = startBin * associate->m_ThreaderJointPDF[0]->GetOffsetTable()[1];
+  JointPDFValueType * const pdfPtrStart = associate->m_ThreaderJointPDF[0]->GetBufferPointer() + tPdfPtrOffset;
+  for( SizeValueType t = 1; t < numberOfPDFs; t++ )
+    {
+    JointPDFValueType *                 pdfPtr = pdfPtrStart;
+    JointPDFValueType const *          tPdfPtr = associate->m_ThreaderJointPDF[t]->GetBufferPointer() + tPdfPtrOffset;
+    JointPDFValueType const * const tPdfPtrEnd = tPdfPtr + maxI;
+    while( tPdfPtr < tPdfPtrEnd )
+      {
+      *( pdfPtr++ ) += *( tPdfPtr++ );
+      }
+    for( SizeValueType i = startBin; i < startBin + numberOfRows; i++ )
+      {
+      associate->m_ThreaderFixedImageMarginalPDF[0][i] += associate->m_ThreaderFixedImageMarginalPDF[t][i];
+      }
+    }
+
+  PDFValueType jointPDFSum = 0.0;
+  JointPDFValueType const * pdfPtr = pdfPtrStart;
+  for( SizeValueType i = 0; i < maxI; i++ )
+    {
+    jointPDFSum += *( pdfPtr++ );
+    }
+  associate->m_ThreaderJointPDFSum[threadId] = jointPDFSum;
+
+  // The joint PDF derivatives are only used for global-support
+  // transforms when derivatives are requested. With shared accumulation
+  // there is a single copy, which only needs to be normalized.
+  if( ! associate->GetComputeDerivative() || associate->HasLocalSupport() )
+    {
+    return;
+    }
+
+  const SizeValueType rowSize = associate->GetNumberOfLocalParameters() * numberOfBins;
+  const SizeValueType maxD = rowSize * numberOfRows;
+  JointPDFDerivativesValueType * const pdfDPtrStart = associate->m_ThreaderJointPDFDerivatives[0]->GetBufferPointer()
+    + ( startBin * rowSize );
+  for( SizeValueType t = 1; t < associate->m_ThreaderJointPDFDerivatives.size(); t++ )
+    {
+    JointPDFDerivativesValueType *             pdfDPtr = pdfDPtrStart;
+    JointPDFDerivativesValueType const *      tPdfDPtr = associate->m_ThreaderJointPDFDerivatives[t]->GetBufferPointer()
+      + ( startBin * rowSize );
+    JointPDFDerivativesValueType const * const tPdfDPtrEnd = tPdfDPtr + maxD;
+    while( tPdfDPtr < tPdfDPtrEnd )
+      {
+      *( pdfDPtr++ ) += *( tPdfDPtr++ );
+      }
+    }
+
+  const PDFValueType nFactor = 1.0 / ( associate->m_MovingImageBinSize * associate->GetNumberOfValidPoints() );
+
+  JointPDFDerivativesValueType *             pdfDPtr = pdfDPtrStart;
+  JointPDFDerivativesValueType const * const pdfDPtrEnd = pdfDPtrStart + maxD;
+  while( pdfDPtr < pdfDPtrEnd )
+    {
+    *( pdfDPtr++ ) *= nFactor;
+    }
+}
+
+} // end namespace itk
+
+#endif
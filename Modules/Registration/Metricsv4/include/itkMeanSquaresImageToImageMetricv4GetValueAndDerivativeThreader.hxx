@@ -23,6 +23,17 @@
 namespace itk
 {
 
+template< class TDomainPartitioner, class TImageToImageMetric, class TMeanSquaresMetric >
+void
+MeanSquaresImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TMeanSquaresMetric >
+::ProcessVirtualPoints( const VirtualIndexType * virtualIndices,
+                        const VirtualPointType * virtualPoints,
+                        const SizeValueType numberOfPoints,
+                        const ThreadIdType threadId )
+{
+  this->ProcessVirtualPointsInBatch( virtualIndices, virtualPoints, numberOfPoints, threadId );
+}
+
 template< class TDomainPartitioner, class TImageToImageMetric, class TMeanSquaresMetric >
 bool
 MeanSquaresImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TMeanSquaresMetric >
@@ -0,0 +1,73 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkRandomImageToImageMetricv4Sampler_h
+#define __itkRandomImageToImageMetricv4Sampler_h
+
+#include "itkImageToImageMetricv4SamplerBase.h"
+
+namespace itk
+{
+/** \class RandomImageToImageMetricv4Sampler
+ * \brief Samples voxels of the virtual domain uniformly at random.
+ *
+ * The voxels are drawn independently, with replacement, so that each
+ * generation is a new random subset of the virtual domain, as with the
+ * random sampling of the Mattes mutual information metric of the previous
+ * registration framework.
+ *
+ * \ingroup ITKMetricsv4
+ */
+template< class TFixedImage, class TMovingImage = TFixedImage, class TVirtualImage = TFixedImage, class TInternalComputationValueType = double >
+class ITK_EXPORT RandomImageToImageMetricv4Sampler:
+  public ImageToImageMetricv4SamplerBase< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+{
+public:
+  /** Standard class typedefs. */
+  typedef RandomImageToImageMetricv4Sampler                                           Self;
+  typedef ImageToImageMetricv4SamplerBase< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType > Superclass;
+  typedef SmartPointer< Self >                                                        Pointer;
+  typedef SmartPointer< const Self >                                                  ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(RandomImageToImageMetricv4Sampler, ImageToImageMetricv4SamplerBase);
+
+  typedef typename Superclass::VirtualIndexType VirtualIndexType;
+
+protected:
+  RandomImageToImageMetricv4Sampler() {}
+  virtual ~RandomImageToImageMetricv4Sampler() {}
+
+  typedef typename Superclass::RandomGenerator RandomGenerator;
+
+  virtual void SelectSample(SizeValueType sample, RandomGenerator & random,
+                            VirtualIndexType & index) const;
+
+private:
+  RandomImageToImageMetricv4Sampler(const Self &); //purposely not implemented
+  void operator=(const Self &);                    //purposely not implemented
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkRandomImageToImageMetricv4Sampler.hxx"
+#endif
+
+#endif
@@ -0,0 +1,35 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkRandomImageToImageMetricv4Sampler_hxx
+#define __itkRandomImageToImageMetricv4Sampler_hxx
+
+#include "itkRandomImageToImageMetricv4Sampler.h"
+
+namespace itk
+{
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+void
+RandomImageToImageMetricv4Sampler< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::SelectSample(SizeValueType itkNotUsed(sample), RandomGenerator & random,
+               VirtualIndexType & index) const
+{
+  this->ComputeIndex(random.GetIntegerVariate( this->GetVirtualRegion().GetNumberOfPixels() ), index);
+}
+} // end namespace itk
+
+#endif
@@ -0,0 +1,78 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkRegularImageToImageMetricv4Sampler_h
+#define __itkRegularImageToImageMetricv4Sampler_h
+
+#include "itkImageToImageMetricv4SamplerBase.h"
+
+namespace itk
+{
+/** \class RegularImageToImageMetricv4Sampler
+ * \brief Samples every k-th voxel of the virtual domain.
+ *
+ * The voxels of the virtual region are taken in raster order with a step
+ * of k = ceil(1 / SamplingPercentage).  The first voxel is drawn at random
+ * in each generation, so that the regular grid of samples moves from one
+ * iteration to the next.
+ *
+ * \ingroup ITKMetricsv4
+ */
+template< class TFixedImage, class TMovingImage = TFixedImage, class TVirtualImage = TFixedImage, class TInternalComputationValueType = double >
+class ITK_EXPORT RegularImageToImageMetricv4Sampler:
+  public ImageToImageMetricv4SamplerBase< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+{
+public:
+  /** Standard class typedefs. */
+  typedef RegularImageToImageMetricv4Sampler                                          Self;
+  typedef ImageToImageMetricv4SamplerBase< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType > Superclass;
+  typedef SmartPointer< Self >                                                        Pointer;
+  typedef SmartPointer< const Self >                                                  ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(RegularImageToImageMetricv4Sampler, ImageToImageMetricv4SamplerBase);
+
+  typedef typename Superclass::VirtualIndexType VirtualIndexType;
+
+protected:
+  RegularImageToImageMetricv4Sampler() {}
+  virtual ~RegularImageToImageMetricv4Sampler() {}
+
+  typedef typename Superclass::RandomGenerator RandomGenerator;
+
+  virtual SizeValueType ComputeNumberOfSamples() const;
+
+  virtual void SelectSample(SizeValueType sample, RandomGenerator & random,
+                            VirtualIndexType & index) const;
+
+private:
+  RegularImageToImageMetricv4Sampler(const Self &); //purposely not implemented
+  void operator=(const Self &);                     //purposely not implemented
+
+  /** Return the step between two samples. */
+  SizeValueType GetStep() const;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkRegularImageToImageMetricv4Sampler.hxx"
+#endif
+
+#endif
@@ -0,0 +1,66 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkRegularImageToImageMetricv4Sampler_hxx
+#define __itkRegularImageToImageMetricv4Sampler_hxx
+
+#include "itkRegularImageToImageMetricv4Sampler.h"
+#include "vnl/vnl_math.h"
+
+namespace itk
+{
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+SizeValueType
+RegularImageToImageMetricv4Sampler< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::GetStep() const
+{
+  const SizeValueType step = static_cast< SizeValueType >( vcl_ceil( 1.0 / this->GetSamplingPercentage() ) );
+
+  return step > 0 ? step : 1;
+}
+
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+SizeValueType
+RegularImageToImageMetricv4Sampler< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::ComputeNumberOfSamples() const
+{
+  const SizeValueType numberOfSamples = this->GetVirtualRegion().GetNumberOfPixels() / this->GetStep();
+
+  return numberOfSamples > 0 ? numberOfSamples : 1;
+}
+
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+void
+RegularImageToImageMetricv4Sampler< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::SelectSample(SizeValueType sample, RandomGenerator & itkNotUsed(random),
+               VirtualIndexType & index) const
+{
+  const SizeValueType numberOfPixels = this->GetVirtualRegion().GetNumberOfPixels();
+  const SizeValueType step = this->GetStep();
+
+  // The first voxel is common to all the samples of a generation, and such
+  // that the last sample is within the region.
+  const SizeValueType lastStart = numberOfPixels - ( this->GetNumberOfSamples() - 1 ) * step;
+  RandomGenerator     startRandom( this->GetSeed(), this->GetGeneration(),
+                                   NumericTraits< SizeValueType >::max() );
+  const SizeValueType start = startRandom.GetIntegerVariate( vnl_math_min(step, lastStart) );
+
+  this->ComputeIndex(start + sample * step, index);
+}
+} // end namespace itk
+
+#endif
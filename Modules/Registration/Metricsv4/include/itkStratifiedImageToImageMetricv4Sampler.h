@@ -0,0 +1,86 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkStratifiedImageToImageMetricv4Sampler_h
+#define __itkStratifiedImageToImageMetricv4Sampler_h
+
+#include "itkImageToImageMetricv4SamplerBase.h"
+
+namespace itk
+{
+/** \class StratifiedImageToImageMetricv4Sampler
+ * \brief Samples one random voxel in each cell of a grid over the virtual
+ * domain.
+ *
+ * The virtual region is divided into cubic cells whose side, in voxels, is
+ * the rounded D-th root of 1 / SamplingPercentage, and one voxel is drawn at
+ * random in each cell.  The samples therefore cover the whole domain, with
+ * less clustering than random sampling, and the effective sampling
+ * percentage is that of the cell size.
+ *
+ * \ingroup ITKMetricsv4
+ */
+template< class TFixedImage, class TMovingImage = TFixedImage, class TVirtualImage = TFixedImage, class TInternalComputationValueType = double >
+class ITK_EXPORT StratifiedImageToImageMetricv4Sampler:
+  public ImageToImageMetricv4SamplerBase< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+{
+public:
+  /** Standard class typedefs. */
+  typedef StratifiedImageToImageMetricv4Sampler                                       Self;
+  typedef ImageToImageMetricv4SamplerBase< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType > Superclass;
+  typedef SmartPointer< Self >                                                        Pointer;
+  typedef SmartPointer< const Self >                                                  ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(StratifiedImageToImageMetricv4Sampler, ImageToImageMetricv4SamplerBase);
+
+  typedef typename Superclass::VirtualIndexType VirtualIndexType;
+  typedef typename Superclass::VirtualSizeType  VirtualSizeType;
+
+  itkStaticConstMacro(VirtualImageDimension, unsigned int, Superclass::VirtualImageDimension);
+
+protected:
+  StratifiedImageToImageMetricv4Sampler() {}
+  virtual ~StratifiedImageToImageMetricv4Sampler() {}
+
+  typedef typename Superclass::RandomGenerator RandomGenerator;
+
+  virtual SizeValueType ComputeNumberOfSamples() const;
+
+  virtual void SelectSample(SizeValueType sample, RandomGenerator & random,
+                            VirtualIndexType & index) const;
+
+private:
+  StratifiedImageToImageMetricv4Sampler(const Self &); //purposely not implemented
+  void operator=(const Self &);                        //purposely not implemented
+
+  /** Return the side of the cells, in voxels. */
+  SizeValueType GetCellSize() const;
+
+  /** Return the number of cells along each dimension. */
+  VirtualSizeType GetNumberOfCells() const;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkStratifiedImageToImageMetricv4Sampler.hxx"
+#endif
+
+#endif
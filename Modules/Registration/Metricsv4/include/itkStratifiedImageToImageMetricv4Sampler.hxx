@@ -0,0 +1,91 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkStratifiedImageToImageMetricv4Sampler_hxx
+#define __itkStratifiedImageToImageMetricv4Sampler_hxx
+
+#include "itkStratifiedImageToImageMetricv4Sampler.h"
+#include "vnl/vnl_math.h"
+
+namespace itk
+{
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+SizeValueType
+StratifiedImageToImageMetricv4Sampler< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::GetCellSize() const
+{
+  const SizeValueType cellSize = static_cast< SizeValueType >(
+    vnl_math_rnd( vcl_pow( 1.0 / this->GetSamplingPercentage(), 1.0 / VirtualImageDimension ) ) );
+
+  return cellSize > 0 ? cellSize : 1;
+}
+
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+typename StratifiedImageToImageMetricv4Sampler< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >::VirtualSizeType
+StratifiedImageToImageMetricv4Sampler< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::GetNumberOfCells() const
+{
+  const VirtualSizeType & size = this->GetVirtualRegion().GetSize();
+  const SizeValueType     cellSize = this->GetCellSize();
+  VirtualSizeType         numberOfCells;
+
+  for ( unsigned int d = 0; d < VirtualImageDimension; d++ )
+    {
+    numberOfCells[d] = ( size[d] + cellSize - 1 ) / cellSize;
+    }
+  return numberOfCells;
+}
+
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+SizeValueType
+StratifiedImageToImageMetricv4Sampler< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::ComputeNumberOfSamples() const
+{
+  const VirtualSizeType numberOfCells = this->GetNumberOfCells();
+  SizeValueType         numberOfSamples = 1;
+
+  for ( unsigned int d = 0; d < VirtualImageDimension; d++ )
+    {
+    numberOfSamples *= numberOfCells[d];
+    }
+  return numberOfSamples;
+}
+
+template< class TFixedImage, class TMovingImage, class TVirtualImage, class TInternalComputationValueType >
+void
+StratifiedImageToImageMetricv4Sampler< TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType >
+::SelectSample(SizeValueType sample, RandomGenerator & random,
+               VirtualIndexType & index) const
+{
+  const VirtualSizeType & size = this->GetVirtualRegion().GetSize();
+  const VirtualSizeType   numberOfCells = this->GetNumberOfCells();
+  const SizeValueType     cellSize = this->GetCellSize();
+
+  index = this->GetVirtualRegion().GetIndex();
+  for ( unsigned int d = 0; d < VirtualImageDimension; d++ )
+    {
+    // Cells on the upper border of the region may be truncated.
+    const SizeValueType cellStart = ( sample % numberOfCells[d] ) * cellSize;
+    sample /= numberOfCells[d];
+
+    const SizeValueType cellExtent = vnl_math_min(cellSize, size[d] - cellStart);
+    index[d] += static_cast< IndexValueType >( cellStart + random.GetIntegerVariate(cellExtent) );
+    }
+}
+} // end namespace itk
+
+#endif
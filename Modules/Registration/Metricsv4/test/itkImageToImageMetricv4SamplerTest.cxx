@@ -0,0 +1,349 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkJointHistogramMutualInformationImageToImageMetricv4.h"
+#include "itkCorrelationImageToImageMetricv4.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkRegularImageToImageMetricv4Sampler.h"
+#include "itkRandomImageToImageMetricv4Sampler.h"
+#include "itkStratifiedImageToImageMetricv4Sampler.h"
+#include "itkGradientMagnitudeWeightedImageToImageMetricv4Sampler.h"
+#include "itkTranslationTransform.h"
+#include "itkGaussianImageSource.h"
+#include "itkCyclicShiftImageFilter.h"
+#include "itkRegistrationParameterScalesFromPhysicalShift.h"
+#include "itkGradientDescentOptimizerv4.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkCentralDifferenceImageFunction.h"
+
+/* This test checks the samplers of the virtual domain of
+ * ImageToImageMetricv4:
+ *  1) the number of samples and their location in the virtual domain
+ *  2) the samples are regenerated at each evaluation, reproducibly and
+ *     independently of the number of threads
+ *  3) stochastic registrations with a few percent of samples converge
+ */
+
+namespace
+{
+const unsigned int Dimension = 2;
+
+typedef itk::Image< double, Dimension >                         ImageType;
+typedef itk::TranslationTransform< double, Dimension >          TransformType;
+typedef itk::ImageToImageMetricv4SamplerBase< ImageType >       SamplerType;
+typedef SamplerType::VirtualPointSetType                        PointSetType;
+
+void ImageToImageMetricv4SamplerTestCreateImages( ImageType::Pointer & fixedImage,
+                                                   ImageType::Pointer & movingImage,
+                                                   ImageType::OffsetType & imageShift )
+{
+  const itk::SizeValueType  imageSize = 100;
+  const itk::OffsetValueType boundary = 6;
+
+  typedef itk::GaussianImageSource< ImageType > GaussianImageSourceType;
+  GaussianImageSourceType::Pointer fixedImageSource = GaussianImageSourceType::New();
+  ImageType::SizeType size;
+  size.Fill( imageSize );
+  fixedImageSource->SetSize( size );
+  fixedImageSource->SetNormalized( false );
+  fixedImageSource->SetScale( 1.0f );
+  fixedImageSource->Update();
+  fixedImage = fixedImageSource->GetOutput();
+
+  // zero-out the boundary
+  itk::ImageRegionIteratorWithIndex< ImageType > it( fixedImage, fixedImage->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); ! it.IsAtEnd(); ++it )
+    {
+    for( unsigned int n = 0; n < Dimension; n++ )
+      {
+      if( it.GetIndex()[n] < boundary || ( static_cast< itk::OffsetValueType >( size[n] ) - it.GetIndex()[n] ) <= boundary )
+        {
+        it.Set( 0.0 );
+        break;
+        }
+      }
+    }
+
+  // shift the fixed image to get the moving image
+  typedef itk::CyclicShiftImageFilter< ImageType, ImageType > CyclicShiftFilterType;
+  CyclicShiftFilterType::Pointer shiftFilter = CyclicShiftFilterType::New();
+  imageShift.Fill( boundary - 1 );
+  imageShift[0] = ( boundary - 1 ) / 2;
+  shiftFilter->SetInput( fixedImage );
+  shiftFilter->SetShift( imageShift );
+  shiftFilter->Update();
+  movingImage = shiftFilter->GetOutput();
+}
+
+bool ImageToImageMetricv4SamplerTestSamePoints( const PointSetType * a, const PointSetType * b )
+{
+  if( a->GetNumberOfPoints() != b->GetNumberOfPoints() )
+    {
+    return false;
+    }
+  for( itk::SizeValueType i = 0; i < a->GetNumberOfPoints(); i++ )
+    {
+    if( a->GetPoint( i ) != b->GetPoint( i ) )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+/* Check the samples of a sampler with a mean squares metric. */
+int ImageToImageMetricv4SamplerTestSamples( SamplerType * sampler, itk::SizeValueType expectedNumberOfSamples,
+                                             ImageType * fixedImage, ImageType * movingImage )
+{
+  typedef itk::MeanSquaresImageToImageMetricv4< ImageType, ImageType > MetricType;
+  std::cout << "*** " << sampler->GetNameOfClass() << std::endl;
+
+  TransformType::Pointer transform = TransformType::New();
+  transform->SetIdentity();
+
+  MetricType::Pointer metric = MetricType::New();
+  metric->SetFixedImage( fixedImage );
+  metric->SetMovingImage( movingImage );
+  metric->SetMovingTransform( transform );
+  metric->SetSampler( sampler );
+  if( !metric->GetUseFixedSampledPointSet() )
+    {
+    std::cerr << "Setting a sampler did not enable sparse sampling." << std::endl;
+    return EXIT_FAILURE;
+    }
+  metric->Initialize();
+
+  PointSetType::Pointer initial = PointSetType::New();
+  sampler->GenerateSamples( initial, 0 );
+  if( !ImageToImageMetricv4SamplerTestSamePoints( initial, metric->GetVirtualSampledPointSet() ) )
+    {
+    std::cerr << "Initialize did not generate the first generation." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if( metric->GetNumberOfDomainPoints() != expectedNumberOfSamples )
+    {
+    std::cerr << "Expected " << expectedNumberOfSamples << " samples, got "
+              << metric->GetNumberOfDomainPoints() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // every sample lies in the virtual domain, within its voxel
+  for( itk::SizeValueType i = 0; i < metric->GetNumberOfDomainPoints(); i++ )
+    {
+    ImageType::PointType point;
+    point.CastFrom( metric->GetVirtualSampledPointSet()->GetPoint( i ) );
+    ImageType::IndexType index;
+    if( !metric->GetVirtualImage()->TransformPhysicalPointToIndex( point, index ) )
+      {
+      std::cerr << "Sample " << i << " is outside the virtual domain: " << point << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // the first evaluation uses the initial samples, the next ones new samples
+  MetricType::MeasureType    value;
+  MetricType::DerivativeType derivative;
+  metric->GetValueAndDerivative( value, derivative );
+  if( !ImageToImageMetricv4SamplerTestSamePoints( initial, metric->GetVirtualSampledPointSet() ) )
+    {
+    std::cerr << "The first evaluation did not use the initial samples." << std::endl;
+    return EXIT_FAILURE;
+    }
+  metric->GetValueAndDerivative( value, derivative );
+  if( ImageToImageMetricv4SamplerTestSamePoints( initial, metric->GetVirtualSampledPointSet() ) )
+    {
+    std::cerr << "The samples were not regenerated." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // the samples depend on the generation only, not on the threads
+  PointSetType::Pointer singleThreaded = PointSetType::New();
+  PointSetType::Pointer multiThreaded = PointSetType::New();
+  sampler->SetMaximumNumberOfThreads( 1 );
+  sampler->GenerateSamples( singleThreaded, 1 );
+  sampler->SetMaximumNumberOfThreads( 4 );
+  sampler->GenerateSamples( multiThreaded, 1 );
+  if( !ImageToImageMetricv4SamplerTestSamePoints( singleThreaded, multiThreaded )
+      || !ImageToImageMetricv4SamplerTestSamePoints( singleThreaded, metric->GetVirtualSampledPointSet() ) )
+    {
+    std::cerr << "The samples depend on the number of threads." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // without regeneration, the initial samples are kept
+  metric->RegenerateSamplesEachIterationOff();
+  metric->Initialize();
+  metric->GetValueAndDerivative( value, derivative );
+  metric->GetValueAndDerivative( value, derivative );
+  if( !ImageToImageMetricv4SamplerTestSamePoints( initial, metric->GetVirtualSampledPointSet() ) )
+    {
+    std::cerr << "The samples were regenerated." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  metric->SetSampler( NULL );
+  if( metric->GetUseFixedSampledPointSet() )
+    {
+    std::cerr << "Removing the sampler did not disable sparse sampling." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
+
+/* Register the shifted images with a sampler. */
+template< class TMetric >
+int ImageToImageMetricv4SamplerTestRegistration( SamplerType * sampler, int numberOfIterations, double maximumStepSize,
+                                                  ImageType * fixedImage, ImageType * movingImage,
+                                                  const ImageType::OffsetType & imageShift )
+{
+  typename TMetric::Pointer metric = TMetric::New();
+  std::cout << "*** " << metric->GetNameOfClass() << " with " << sampler->GetNameOfClass() << std::endl;
+
+  TransformType::Pointer transform = TransformType::New();
+  transform->SetIdentity();
+
+  metric->SetFixedImage( fixedImage );
+  metric->SetMovingImage( movingImage );
+  metric->SetMovingTransform( transform );
+  metric->SetUseMovingImageGradientFilter( false );
+  metric->SetUseFixedImageGradientFilter( false );
+  metric->SetSampler( sampler );
+  metric->Initialize();
+
+  typedef itk::RegistrationParameterScalesFromPhysicalShift< TMetric > ScalesEstimatorType;
+  typename ScalesEstimatorType::Pointer scalesEstimator = ScalesEstimatorType::New();
+  scalesEstimator->SetMetric( metric );
+
+  itk::GradientDescentOptimizerv4::Pointer optimizer = itk::GradientDescentOptimizerv4::New();
+  optimizer->SetMetric( metric );
+  optimizer->SetNumberOfIterations( numberOfIterations );
+  optimizer->SetScalesEstimator( scalesEstimator );
+  optimizer->SetMaximumStepSizeInPhysicalUnits( maximumStepSize );
+  optimizer->StartOptimization();
+
+  std::cout << "samples: " << metric->GetNumberOfDomainPoints()
+            << ", imageShift: " << imageShift
+            << ", final parameters: " << transform->GetParameters() << std::endl;
+
+  const double tolerance = 0.11;
+  for( unsigned int n = 0; n < Dimension; n++ )
+    {
+    if( vcl_fabs( 1.0 - ( static_cast< double >( imageShift[n] ) / transform->GetParameters()[n] ) ) > tolerance )
+      {
+      std::cerr << "Final transform parameters are not within tolerance of image shift." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int itkImageToImageMetricv4SamplerTest( int, char *[] )
+{
+  ImageType::Pointer    fixedImage;
+  ImageType::Pointer    movingImage;
+  ImageType::OffsetType imageShift;
+  ImageToImageMetricv4SamplerTestCreateImages( fixedImage, movingImage, imageShift );
+
+  typedef itk::RegularImageToImageMetricv4Sampler< ImageType >                RegularSamplerType;
+  typedef itk::RandomImageToImageMetricv4Sampler< ImageType >                 RandomSamplerType;
+  typedef itk::StratifiedImageToImageMetricv4Sampler< ImageType >             StratifiedSamplerType;
+  typedef itk::GradientMagnitudeWeightedImageToImageMetricv4Sampler< ImageType > GradientMagnitudeWeightedSamplerType;
+
+  RegularSamplerType::Pointer regularSampler = RegularSamplerType::New();
+  regularSampler->SetSamplingPercentage( 0.03 );
+  RandomSamplerType::Pointer randomSampler = RandomSamplerType::New();
+  randomSampler->SetSamplingPercentage( 0.03 );
+  StratifiedSamplerType::Pointer stratifiedSampler = StratifiedSamplerType::New();
+  stratifiedSampler->SetSamplingPercentage( 0.04 );
+  GradientMagnitudeWeightedSamplerType::Pointer gradientMagnitudeWeightedSampler = GradientMagnitudeWeightedSamplerType::New();
+  gradientMagnitudeWeightedSampler->SetSamplingPercentage( 0.03 );
+
+  std::cout << randomSampler << std::endl;
+  std::cout << gradientMagnitudeWeightedSampler << std::endl;
+
+  bool passed = true;
+
+  // 10000 voxels: a step of 34 voxels, cells of 5x5 voxels
+  passed &= ImageToImageMetricv4SamplerTestSamples( regularSampler, 10000 / 34, fixedImage, movingImage ) == EXIT_SUCCESS;
+  passed &= ImageToImageMetricv4SamplerTestSamples( randomSampler, 300, fixedImage, movingImage ) == EXIT_SUCCESS;
+  passed &= ImageToImageMetricv4SamplerTestSamples( stratifiedSampler, 400, fixedImage, movingImage ) == EXIT_SUCCESS;
+  passed &= ImageToImageMetricv4SamplerTestSamples( gradientMagnitudeWeightedSampler, 300, fixedImage, movingImage ) == EXIT_SUCCESS;
+
+  // a different seed gives different samples
+  {
+  PointSetType::Pointer a = PointSetType::New();
+  PointSetType::Pointer b = PointSetType::New();
+  randomSampler->GenerateSamples( a, 0 );
+  randomSampler->SetSeed( 4321 );
+  randomSampler->GenerateSamples( b, 0 );
+  if( ImageToImageMetricv4SamplerTestSamePoints( a, b ) )
+    {
+    std::cerr << "The seed does not change the samples." << std::endl;
+    passed = false;
+    }
+  }
+
+  // the gradient magnitude weighted samples concentrate on the edges
+  {
+  typedef itk::CentralDifferenceImageFunction< ImageType > GradientCalculatorType;
+  GradientCalculatorType::Pointer calculator = GradientCalculatorType::New();
+  calculator->SetInputImage( fixedImage );
+
+  SamplerType * samplers[2] = { randomSampler, gradientMagnitudeWeightedSampler };
+  double        meanMagnitude[2];
+  for( unsigned int k = 0; k < 2; k++ )
+    {
+    PointSetType::Pointer samples = PointSetType::New();
+    samplers[k]->GenerateSamples( samples, 0 );
+    meanMagnitude[k] = 0.0;
+    for( itk::SizeValueType i = 0; i < samples->GetNumberOfPoints(); i++ )
+      {
+      ImageType::PointType point;
+      point.CastFrom( samples->GetPoint( i ) );
+      meanMagnitude[k] += calculator->Evaluate( point ).GetNorm() / samples->GetNumberOfPoints();
+      }
+    }
+  std::cout << "Mean gradient magnitude: random " << meanMagnitude[0]
+            << ", gradient magnitude weighted " << meanMagnitude[1] << std::endl;
+  if( meanMagnitude[1] < 2.0 * meanMagnitude[0] )
+    {
+    std::cerr << "The gradient magnitude weighted samples are not concentrated on the edges." << std::endl;
+    passed = false;
+    }
+  }
+
+  typedef itk::MattesMutualInformationImageToImageMetricv4< ImageType, ImageType >        MattesMetricType;
+  typedef itk::JointHistogramMutualInformationImageToImageMetricv4< ImageType, ImageType > JointHistogramMetricType;
+  typedef itk::CorrelationImageToImageMetricv4< ImageType, ImageType >                   CorrelationMetricType;
+
+  passed &= ImageToImageMetricv4SamplerTestRegistration< MattesMetricType >( randomSampler, 120, 0.1, fixedImage, movingImage, imageShift ) == EXIT_SUCCESS;
+  passed &= ImageToImageMetricv4SamplerTestRegistration< MattesMetricType >( stratifiedSampler, 120, 0.1, fixedImage, movingImage, imageShift ) == EXIT_SUCCESS;
+  passed &= ImageToImageMetricv4SamplerTestRegistration< JointHistogramMetricType >( regularSampler, 100, 1.0, fixedImage, movingImage, imageShift ) == EXIT_SUCCESS;
+  passed &= ImageToImageMetricv4SamplerTestRegistration< CorrelationMetricType >( gradientMagnitudeWeightedSampler, 100, 1.0, fixedImage, movingImage, imageShift ) == EXIT_SUCCESS;
+
+  if( !passed )
+    {
+    std::cerr << "Failed." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -141,6 +141,13 @@ public:
   itkStaticConstMacro(MovingImageDimension, ImageDimensionType,
       ::itk::GetImageDimension<TMovingImage>::ImageDimension);
 
+  /** Replace the default moving image gradient interpolator, as a derived
+   * metric interpolating its gradients differently would. */
+  void ReplaceMovingImageGradientInterpolator()
+    {
+    this->m_MovingImageGradientInterpolator = Superclass::MovingImageGradientInterpolatorType::New();
+    }
+
 protected:
   friend class ImageToImageTestGetValueAndDerivativeThreader<itk::ThreadedImageRegionPartitioner< VirtualImageDimension >, Superclass >;
   friend class ImageToImageTestGetValueAndDerivativeThreader<itk::ThreadedIndexedContainerPartitioner, Superclass >;
@@ -688,6 +695,43 @@ int itkImageToImageMetricv4Test(int, char ** const)
     return EXIT_FAILURE;
     }
 
+  //
+  // Test that the gradients are only taken from a gradient image cache
+  // while the default gradient filters and interpolators are in use.
+  //
+  std::cout << "Testing with gradient image cache:" << std::endl;
+  metric->SetUseFixedSampledPointSet( false );
+  metric->SetUseFixedImageGradientFilter( true );
+  metric->SetUseMovingImageGradientFilter( true );
+  metric->SetGradientImageCache( ImageToImageMetricv4TestMetricType::GradientImageCacheType::New() );
+  metric->Initialize();
+  if( metric->GetFixedImageCachedGradientImage() == NULL ||
+      metric->GetMovingImageCachedGradientImage() == NULL )
+    {
+    std::cerr << "Gradients were not taken from the cache." << std::endl;
+    return EXIT_FAILURE;
+    }
+  metric->ReplaceMovingImageGradientInterpolator();
+  metric->Initialize();
+  if( metric->GetFixedImageCachedGradientImage() == NULL ||
+      metric->GetMovingImageCachedGradientImage() != NULL ||
+      metric->GetMovingImageGradientImage() == NULL )
+    {
+    std::cerr << "Moving gradients were taken from the cache with a "
+              << "non-default gradient interpolator." << std::endl;
+    return EXIT_FAILURE;
+    }
+  ImageToImageMetricv4TestMetricType::MeasureType     cachedValue;
+  ImageToImageMetricv4TestMetricType::DerivativeType  cachedDerivative;
+  metric->GetValueAndDerivative( cachedValue, cachedDerivative );
+  if( metric->GetNumberOfValidPoints() != imageSize * imageSize )
+    {
+    std::cerr << "Wrong number of valid points with gradient image cache: "
+              << metric->GetNumberOfValidPoints() << std::endl;
+    return EXIT_FAILURE;
+    }
+  metric->SetGradientImageCache( NULL );
+
   // exercise methods.
   metric->SetUseFloatingPointCorrection( false );
   metric->SetFloatingPointCorrectionResolution( 1 );
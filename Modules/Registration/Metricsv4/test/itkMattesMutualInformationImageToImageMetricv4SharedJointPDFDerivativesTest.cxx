@@ -0,0 +1,208 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkGaussianImageSource.h"
+#include "itkImageRegionIterator.h"
+#include "itkTimeProbe.h"
+
+/* This test compares the accumulation of the joint PDF derivatives of
+ * MattesMutualInformationImageToImageMetricv4 into one array per thread
+ * with the accumulation into a single array shared by all threads, for an
+ * affine and a BSpline transform, and reports the time of both. */
+
+namespace
+{
+const unsigned int Dimension = 2;
+
+typedef itk::Image< double, Dimension >                                             ImageType;
+typedef itk::MattesMutualInformationImageToImageMetricv4< ImageType, ImageType >    MetricType;
+typedef MetricType::DerivativeType                                                  DerivativeType;
+typedef MetricType::MovingTransformType                                             MovingTransformType;
+
+ImageType::Pointer MattesSharedJointPDFDerivativesTestCreateImage( double sigma, bool invert )
+{
+  typedef itk::GaussianImageSource< ImageType > GaussianImageSourceType;
+  GaussianImageSourceType::Pointer source = GaussianImageSourceType::New();
+  ImageType::SizeType size;
+  size.Fill( 64 );
+  GaussianImageSourceType::ArrayType sigmas;
+  sigmas.Fill( sigma );
+  GaussianImageSourceType::ArrayType mean;
+  mean.Fill( 32.0 );
+  source->SetSize( size );
+  source->SetSigma( sigmas );
+  source->SetMean( mean );
+  source->SetNormalized( false );
+  source->SetScale( 100.0 );
+  source->Update();
+  ImageType::Pointer image = source->GetOutput();
+
+  // A different intensity mapping for the moving image.
+  if( invert )
+    {
+    itk::ImageRegionIterator< ImageType > it( image, image->GetLargestPossibleRegion() );
+    for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      it.Set( 100.0 - it.Get() );
+      }
+    }
+  return image;
+}
+
+void MattesSharedJointPDFDerivativesTestEvaluate( ImageType * fixedImage, ImageType * movingImage,
+                                                   MovingTransformType * transform, bool shared,
+                                                   itk::ThreadIdType threads, unsigned int repeats,
+                                                   MetricType::MeasureType & value,
+                                                   DerivativeType & derivative )
+{
+  MetricType::Pointer metric = MetricType::New();
+  metric->SetFixedImage( fixedImage );
+  metric->SetMovingImage( movingImage );
+  metric->SetMovingTransform( transform );
+  metric->SetNumberOfHistogramBins( 32 );
+  metric->SetMaximumNumberOfThreads( threads );
+  metric->SetUseSharedJointPDFDerivatives( shared );
+  metric->Initialize();
+
+  itk::TimeProbe timer;
+  for( unsigned int n = 0; n < repeats; n++ )
+    {
+    timer.Start();
+    metric->GetValueAndDerivative( value, derivative );
+    timer.Stop();
+    }
+  if( metric->GetJointPDFDerivatives().IsNull() )
+    {
+    std::cerr << "No joint PDF derivatives." << std::endl;
+    value = itk::NumericTraits< MetricType::MeasureType >::max();
+    }
+
+  std::cout << "  " << ( shared ? "shared    " : "per-thread" ) << " threads: " << threads
+            << " value: " << value << " mean time: " << timer.GetMean() << " s" << std::endl;
+}
+
+int MattesSharedJointPDFDerivativesTestCompare( ImageType * fixedImage, ImageType * movingImage,
+                                                 MovingTransformType * transform )
+{
+  std::cout << "*** " << transform->GetNameOfClass() << ", "
+            << transform->GetNumberOfParameters() << " parameters" << std::endl;
+
+  const unsigned int repeats = 5;
+  const itk::ThreadIdType threads = 4;
+
+  MetricType::MeasureType referenceValue;
+  DerivativeType          referenceDerivative;
+  MattesSharedJointPDFDerivativesTestEvaluate( fixedImage, movingImage, transform, false, 1, repeats,
+                                               referenceValue, referenceDerivative );
+
+  double derivativeMagnitude = 0.0;
+  for( itk::SizeValueType p = 0; p < referenceDerivative.Size(); p++ )
+    {
+    derivativeMagnitude = std::max( derivativeMagnitude, vcl_abs( referenceDerivative[p] ) );
+    }
+  if( derivativeMagnitude == 0.0 )
+    {
+    std::cerr << "The reference derivative is zero." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const bool shared[3] = { false, true, true };
+  const itk::ThreadIdType numberOfThreads[3] = { threads, 1, threads };
+  for( unsigned int c = 0; c < 3; c++ )
+    {
+    MetricType::MeasureType value;
+    DerivativeType          derivative;
+    MattesSharedJointPDFDerivativesTestEvaluate( fixedImage, movingImage, transform, shared[c], numberOfThreads[c],
+                                                 repeats, value, derivative );
+
+    const double tolerance = 1e-10;
+    if( vcl_abs( value - referenceValue ) > tolerance * vcl_abs( referenceValue ) )
+      {
+      std::cerr << "The value " << value << " differs from " << referenceValue << std::endl;
+      return EXIT_FAILURE;
+      }
+    for( itk::SizeValueType p = 0; p < derivative.Size(); p++ )
+      {
+      if( vcl_abs( derivative[p] - referenceDerivative[p] ) > tolerance * derivativeMagnitude )
+        {
+        std::cerr << "The derivative of parameter " << p << " is " << derivative[p]
+                  << " instead of " << referenceDerivative[p] << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int itkMattesMutualInformationImageToImageMetricv4SharedJointPDFDerivativesTest( int, char *[] )
+{
+  ImageType::Pointer fixedImage = MattesSharedJointPDFDerivativesTestCreateImage( 10.0, false );
+  ImageType::Pointer movingImage = MattesSharedJointPDFDerivativesTestCreateImage( 12.0, true );
+
+  typedef itk::AffineTransform< double, Dimension > AffineTransformType;
+  AffineTransformType::Pointer affineTransform = AffineTransformType::New();
+  affineTransform->SetIdentity();
+  AffineTransformType::OutputVectorType translation;
+  translation[0] = 1.5;
+  translation[1] = -2.0;
+  affineTransform->SetTranslation( translation );
+  affineTransform->Rotate2D( 0.05 );
+
+  typedef itk::BSplineTransform< double, Dimension, 3 > BSplineTransformType;
+  BSplineTransformType::Pointer bsplineTransform = BSplineTransformType::New();
+  BSplineTransformType::OriginType origin;
+  origin.Fill( 0.0 );
+  BSplineTransformType::PhysicalDimensionsType dimensions;
+  dimensions.Fill( 63.0 );
+  BSplineTransformType::MeshSizeType meshSize;
+  meshSize.Fill( 12 );
+  bsplineTransform->SetTransformDomainOrigin( origin );
+  bsplineTransform->SetTransformDomainPhysicalDimensions( dimensions );
+  bsplineTransform->SetTransformDomainMeshSize( meshSize );
+  BSplineTransformType::ParametersType parameters( bsplineTransform->GetNumberOfParameters() );
+  for( itk::SizeValueType p = 0; p < parameters.Size(); p++ )
+    {
+    parameters[p] = 0.5 * vcl_sin( 0.37 * p );
+    }
+  bsplineTransform->SetParametersByValue( parameters );
+
+  MetricType::Pointer metric = MetricType::New();
+  if( metric->GetUseSharedJointPDFDerivatives() )
+    {
+    std::cerr << "UseSharedJointPDFDerivatives should be off by default." << std::endl;
+    return EXIT_FAILURE;
+    }
+  metric->UseSharedJointPDFDerivativesOn();
+  metric->Print( std::cout );
+
+  if( MattesSharedJointPDFDerivativesTestCompare( fixedImage, movingImage, affineTransform ) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+  if( MattesSharedJointPDFDerivativesTestCompare( fixedImage, movingImage, bsplineTransform ) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -22,6 +22,7 @@
 #include "itkPoint.h"
 #include "itkLinearInterpolateImageFunction.h"
 #include "itkCentralDifferenceImageFunction.h"
+#include "itkGradientImageCache.h"
 
 namespace itk
 {
@@ -39,6 +40,11 @@ namespace itk
  * interpolators via method SetMovingImageInterpolator. Note that the input
  * interpolator must derive from baseclass InterpolateImageFunction.
  *
+ * The fixed image gradient can be taken from a GradientImageCache set with
+ * SetGradientImageCache, which computes it once for all the iterations and
+ * for all the functions that share the cache, instead of at each pixel of
+ * each iteration.
+ *
  * This class is templated over the fixed image type, moving image type,
  * and the displacement field type.
  *
@@ -122,6 +128,11 @@ public:
   typedef typename MovingImageGradientCalculatorType::Pointer
   MovingImageGradientCalculatorPointer;
 
+  /** Gradient image cache type. */
+  typedef GradientImageCache< itkGetStaticConstMacro(ImageDimension) > GradientImageCacheType;
+  typedef typename GradientImageCacheType::Pointer                     GradientImageCachePointer;
+  typedef typename GradientImageCacheType::CachedGradientImageType     CachedGradientImageType;
+
   /** Set the moving image interpolator. */
   void SetMovingImageInterpolator(InterpolatorType *ptr)
   { m_MovingImageInterpolator = ptr; }
@@ -178,6 +189,16 @@ public:
   virtual bool GetUseMovingImageGradient() const
   { return m_UseMovingImageGradient; }
 
+  /** Set/Get the cache the fixed image gradient is taken from. The cache
+   * provides the unsmoothed central differences of the fixed image, in
+   * single precision. NULL by default, in which case the gradient is
+   * computed by the gradient calculator at each pixel. The moving image
+   * gradient is always computed by its gradient calculator. */
+  virtual void SetGradientImageCache(GradientImageCacheType *cache)
+  { m_GradientImageCache = cache; }
+  virtual GradientImageCacheType * GetGradientImageCache() const
+  { return m_GradientImageCache.GetPointer(); }
+
   /** Set/Get the threshold below which the absolute difference of
    * intensity yields a match. When the intensities match between a
    * moving and fixed image pixel, the update vector (for that
@@ -215,6 +236,10 @@ private:
   /** Function to compute derivatives of the fixed image. */
   GradientCalculatorPointer m_FixedImageGradientCalculator;
 
+  /** Cache of fixed image gradients, and the gradient taken from it. */
+  GradientImageCachePointer                      m_GradientImageCache;
+  typename CachedGradientImageType::ConstPointer m_FixedImageCachedGradientImage;
+
   /** Function to compute derivatives of the moving image. */
   MovingImageGradientCalculatorPointer m_MovingImageGradientCalculator;
   bool                                 m_UseMovingImageGradient;
@@ -80,6 +80,8 @@ DemonsRegistrationFunction< TFixedImage, TMovingImage, TDisplacementField >
   os << m_MovingImageInterpolator.GetPointer() << std::endl;
   os << indent << "FixedImageGradientCalculator: ";
   os << m_FixedImageGradientCalculator.GetPointer() << std::endl;
+  os << indent << "GradientImageCache: ";
+  os << m_GradientImageCache.GetPointer() << std::endl;
   os << indent << "DenominatorThreshold: ";
   os << m_DenominatorThreshold << std::endl;
   os << indent << "IntensityDifferenceThreshold: ";
@@ -151,6 +153,17 @@ DemonsRegistrationFunction< TFixedImage, TMovingImage, TDisplacementField >
   m_FixedImageGradientCalculator->SetInputImage( this->GetFixedImage() );
   m_MovingImageGradientCalculator->SetInputImage( this->GetMovingImage() );
 
+  // take the fixed image gradient from the cache, if any
+  if ( m_GradientImageCache && !m_UseMovingImageGradient )
+    {
+    m_FixedImageCachedGradientImage = m_GradientImageCache->GetGradientImage(
+      this->GetFixedImage(), 0.0, false, m_FixedImageGradientCalculator->GetUseImageDirection() );
+    }
+  else
+    {
+    m_FixedImageCachedGradientImage = NULL;
+    }
+
   // setup moving image interpolator
   m_MovingImageInterpolator->SetInputImage( this->GetMovingImage() );
 
@@ -197,7 +210,11 @@ DemonsRegistrationFunction< TFixedImage, TMovingImage, TDisplacementField >
 
   CovariantVectorType gradient;
   // Compute the gradient of either fixed or moving image
-  if ( !m_UseMovingImageGradient )
+  if ( m_FixedImageCachedGradientImage )
+    {
+    m_FixedImageCachedGradientImage->EvaluateAtIndex(index, gradient);
+    }
+  else if ( !m_UseMovingImageGradient )
     {
     gradient = m_FixedImageGradientCalculator->EvaluateAtIndex(index);
     }
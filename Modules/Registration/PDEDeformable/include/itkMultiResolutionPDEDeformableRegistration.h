@@ -59,7 +59,9 @@ namespace itk
  *
  * MultiResolutionPyramidImageFilters are used to downsample the fixed
  * and moving images. A VectorExpandImageFilter is used to upsample
- * the deformation as we move from a coarse to fine solution.
+ * the deformation as we move from a coarse to fine solution.  Pyramids
+ * set by the user keep their levels, so that a pyramid of a fixed atlas
+ * can be shared between the registrations of many moving images.
  *
  * This class is templated over the fixed image type, the moving image type,
  * and the Deformation Field type.
@@ -203,14 +205,17 @@ public:
   /** Get the internal registrator. */
   itkGetObjectMacro(RegistrationFilter, RegistrationType);
 
-  /** Set the fixed image pyramid. */
-  itkSetObjectMacro(FixedImagePyramid, FixedImagePyramidType);
+  /** Set the fixed image pyramid.  Unlike those of the default pyramid,
+   * the levels of a pyramid that is set are kept after the registration,
+   * so that registrations sharing the pyramid and the fixed image compute
+   * them once. */
+  virtual void SetFixedImagePyramid(FixedImagePyramidType *pyramid);
 
   /** Get the fixed image pyramid. */
   itkGetObjectMacro(FixedImagePyramid, FixedImagePyramidType);
 
-  /** Set the moving image pyramid. */
-  itkSetObjectMacro(MovingImagePyramid, MovingImagePyramidType);
+  /** Set the moving image pyramid.  \sa SetFixedImagePyramid() */
+  virtual void SetMovingImagePyramid(MovingImagePyramidType *pyramid);
 
   /** Get the moving image pyramid. */
   itkGetObjectMacro(MovingImagePyramid, MovingImagePyramidType);
@@ -289,6 +294,8 @@ private:
   RegistrationPointer       m_RegistrationFilter;
   FixedImagePyramidPointer  m_FixedImagePyramid;
   MovingImagePyramidPointer m_MovingImagePyramid;
+  bool                      m_ReleaseFixedImagePyramidData;
+  bool                      m_ReleaseMovingImagePyramidData;
   FieldExpanderPointer      m_FieldExpander;
   DisplacementFieldPointer  m_InitialDisplacementField;
 
@@ -44,6 +44,8 @@ MultiResolutionPDEDeformableRegistration< TFixedImage, TMovingImage, TDisplaceme
 
   m_MovingImagePyramid  = MovingImagePyramidType::New();
   m_FixedImagePyramid     = FixedImagePyramidType::New();
+  m_ReleaseMovingImagePyramidData = true;
+  m_ReleaseFixedImagePyramidData = true;
   m_FieldExpander     = FieldExpanderType::New();
   m_InitialDisplacementField = NULL;
 
@@ -161,6 +163,38 @@ MultiResolutionPDEDeformableRegistration< TFixedImage, TMovingImage, TDisplaceme
     }
 }
 
+/**
+ * Set the fixed image pyramid
+ */
+template< class TFixedImage, class TMovingImage, class TDisplacementField, class TRealType >
+void
+MultiResolutionPDEDeformableRegistration< TFixedImage, TMovingImage, TDisplacementField, TRealType >
+::SetFixedImagePyramid(FixedImagePyramidType *pyramid)
+{
+  if ( m_FixedImagePyramid != pyramid )
+    {
+    m_FixedImagePyramid = pyramid;
+    m_ReleaseFixedImagePyramidData = false;
+    this->Modified();
+    }
+}
+
+/**
+ * Set the moving image pyramid
+ */
+template< class TFixedImage, class TMovingImage, class TDisplacementField, class TRealType >
+void
+MultiResolutionPDEDeformableRegistration< TFixedImage, TMovingImage, TDisplacementField, TRealType >
+::SetMovingImagePyramid(MovingImagePyramidType *pyramid)
+{
+  if ( m_MovingImagePyramid != pyramid )
+    {
+    m_MovingImagePyramid = pyramid;
+    m_ReleaseMovingImagePyramidData = false;
+    this->Modified();
+    }
+}
+
 /**
  * Standard PrintSelf method.
  */
@@ -187,6 +221,10 @@ MultiResolutionPDEDeformableRegistration< TFixedImage, TMovingImage, TDisplaceme
   os << m_MovingImagePyramid.GetPointer() << std::endl;
   os << indent << "FixedImagePyramid: ";
   os << m_FixedImagePyramid.GetPointer() << std::endl;
+  os << indent << "ReleaseMovingImagePyramidData: ";
+  os << m_ReleaseMovingImagePyramidData << std::endl;
+  os << indent << "ReleaseFixedImagePyramidData: ";
+  os << m_ReleaseFixedImagePyramidData << std::endl;
 
   os << indent << "FieldExpander: ";
   os << m_FieldExpander.GetPointer() << std::endl;
@@ -390,11 +428,11 @@ MultiResolutionPDEDeformableRegistration< TFixedImage, TMovingImage, TDisplaceme
     this->InvokeEvent( IterationEvent() );
 
     // We can release data from pyramid which are no longer required.
-    if ( movingLevel > 0 )
+    if ( movingLevel > 0 && m_ReleaseMovingImagePyramidData )
       {
       m_MovingImagePyramid->GetOutput(movingLevel - 1)->ReleaseData();
       }
-    if ( fixedLevel > 0 )
+    if ( fixedLevel > 0 && m_ReleaseFixedImagePyramidData )
       {
       m_FixedImagePyramid->GetOutput(fixedLevel - 1)->ReleaseData();
       }
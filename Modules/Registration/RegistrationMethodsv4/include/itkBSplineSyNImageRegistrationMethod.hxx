@@ -21,11 +21,7 @@
 #include "itkBSplineSyNImageRegistrationMethod.h"
 
 #include "itkBSplineSmoothingOnUpdateDisplacementFieldTransformParametersAdaptor.h"
-#include "itkComposeDisplacementFieldsImageFilter.h"
-#include "itkImportImageFilter.h"
-#include "itkInvertDisplacementFieldImageFilter.h"
 #include "itkIterationReporter.h"
-#include "itkMultiplyImageFilter.h"
 #include "itkWindowConvergenceMonitoringFunction.h"
 
 namespace itk
@@ -92,6 +88,20 @@ BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
   typename IdentityTransformType::Pointer identityTransform;
   identityTransform = IdentityTransformType::New();
 
+  // The identity field is allocated once per level.
+  typename DisplacementFieldTransformType::Pointer identityDisplacementFieldTransform;
+  if( this->m_DownsampleImagesForMetricDerivatives )
+    {
+    typename DisplacementFieldType::Pointer identityField = DisplacementFieldType::New();
+    identityField->CopyInformation( virtualDomainImage );
+    identityField->SetRegions( virtualDomainImage->GetRequestedRegion() );
+    identityField->Allocate();
+    identityField->FillBuffer( zeroVector );
+
+    identityDisplacementFieldTransform = DisplacementFieldTransformType::New();
+    identityDisplacementFieldTransform->SetDisplacementField( identityField );
+    }
+
   IterationReporter reporter( this, 0, 1 );
 
   while( this->m_CurrentIteration++ < this->m_NumberOfIterationsPerLevel[this->m_CurrentLevel] && !this->m_IsConverged )
@@ -117,7 +127,9 @@ BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
     DisplacementFieldPointer movingToMiddleSmoothUpdateField;
     if( this->m_DownsampleImagesForMetricDerivatives )
       {
-      typedef ResampleImageFilter<MovingImageType, MovingImageType> MovingResamplerType;
+      this->m_MetricTime.Start();
+
+      typedef ResampleImageFilter<MovingImageType, MovingImageType, RealType> MovingResamplerType;
       typename MovingResamplerType::Pointer movingResampler = MovingResamplerType::New();
       movingResampler->SetTransform( movingComposite );
       movingResampler->SetInput( this->m_MovingSmoothImage );
@@ -128,7 +140,7 @@ BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
       movingResampler->SetDefaultPixelValue( 0 );
       movingResampler->Update();
 
-      typedef ResampleImageFilter<FixedImageType, FixedImageType> FixedResamplerType;
+      typedef ResampleImageFilter<FixedImageType, FixedImageType, RealType> FixedResamplerType;
       typename FixedResamplerType::Pointer fixedResampler = FixedResamplerType::New();
       fixedResampler->SetTransform( fixedComposite );
       fixedResampler->SetInput( this->m_FixedSmoothImage );
@@ -139,14 +151,7 @@ BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
       fixedResampler->SetDefaultPixelValue( 0 );
       fixedResampler->Update();
 
-      typename DisplacementFieldType::Pointer identityField = DisplacementFieldType::New();
-      identityField->CopyInformation( virtualDomainImage );
-      identityField->SetRegions( virtualDomainImage->GetRequestedRegion() );
-      identityField->Allocate();
-      identityField->FillBuffer( zeroVector );
-
-      typename DisplacementFieldTransformType::Pointer identityDisplacementFieldTransform = DisplacementFieldTransformType::New();
-      identityDisplacementFieldTransform->SetDisplacementField( identityField );
+      this->m_MetricTime.Stop();
 
       fixedToMiddleSmoothUpdateField = this->ComputeUpdateField( fixedResampler->GetOutput(), identityTransform,
         movingResampler->GetOutput(), identityDisplacementFieldTransform, movingMetricValue );
@@ -172,33 +177,37 @@ BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
 
     // Add the update field to both displacement fields (from fixed/moving to middle image) and then smooth
 
-    typedef ComposeDisplacementFieldsImageFilter<DisplacementFieldType> ComposerType;
+    DisplacementFieldPointer fixedToMiddleTotalField = this->m_FixedToMiddleTransform->GetDisplacementField();
+    DisplacementFieldPointer movingToMiddleTotalField = this->m_MovingToMiddleTransform->GetDisplacementField();
 
-    typename ComposerType::Pointer fixedComposer = ComposerType::New();
-    fixedComposer->SetDisplacementField( fixedToMiddleSmoothUpdateField );
-    fixedComposer->SetWarpingField( this->m_FixedToMiddleTransform->GetDisplacementField() );
-    fixedComposer->Update();
+    this->m_CompositionTime.Start();
+    this->ComposeUpdateField( fixedToMiddleSmoothUpdateField, fixedToMiddleTotalField );
+    this->ComposeUpdateField( movingToMiddleSmoothUpdateField, movingToMiddleTotalField );
+    this->m_CompositionTime.Stop();
 
-    DisplacementFieldPointer fixedToMiddleSmoothTotalFieldTmp = this->BSplineSmoothDisplacementField( fixedComposer->GetOutput(),
+    this->m_TotalFieldSmoothingTime.Start();
+    DisplacementFieldPointer fixedToMiddleSmoothTotalField = this->BSplineSmoothDisplacementField( fixedToMiddleTotalField,
       this->m_FixedToMiddleTransform->GetNumberOfControlPointsForTheTotalField() );
-
-    typename ComposerType::Pointer movingComposer = ComposerType::New();
-    movingComposer->SetDisplacementField( movingToMiddleSmoothUpdateField );
-    movingComposer->SetWarpingField( this->m_MovingToMiddleTransform->GetDisplacementField() );
-    movingComposer->Update();
-
-    DisplacementFieldPointer movingToMiddleSmoothTotalFieldTmp = this->BSplineSmoothDisplacementField( movingComposer->GetOutput(),
+    DisplacementFieldPointer movingToMiddleSmoothTotalField = this->BSplineSmoothDisplacementField( movingToMiddleTotalField,
       this->m_MovingToMiddleTransform->GetNumberOfControlPointsForTheTotalField() );
+    this->m_TotalFieldSmoothingTime.Stop();
+
+    // Iteratively estimate the inverse fields, starting from the current inverse fields,
+    // and then refine the total fields by inverting the inverse fields.
 
-    // Iteratively estimate the inverse fields.
+    DisplacementFieldPointer fixedToMiddleSmoothTotalFieldInverse = this->m_FixedToMiddleTransform->GetInverseDisplacementField();
+    DisplacementFieldPointer movingToMiddleSmoothTotalFieldInverse = this->m_MovingToMiddleTransform->GetInverseDisplacementField();
 
-    DisplacementFieldPointer fixedToMiddleSmoothTotalFieldInverse = this->InvertDisplacementField( fixedToMiddleSmoothTotalFieldTmp, this->m_FixedToMiddleTransform->GetInverseDisplacementField() );
-    DisplacementFieldPointer fixedToMiddleSmoothTotalField = this->InvertDisplacementField( fixedToMiddleSmoothTotalFieldInverse, fixedToMiddleSmoothTotalFieldTmp );
+    this->m_InversionTime.Start();
+    this->EstimateInverseDisplacementField( fixedToMiddleSmoothTotalField, fixedToMiddleSmoothTotalFieldInverse );
+    this->EstimateInverseDisplacementField( fixedToMiddleSmoothTotalFieldInverse, fixedToMiddleSmoothTotalField );
 
-    DisplacementFieldPointer movingToMiddleSmoothTotalFieldInverse = this->InvertDisplacementField( movingToMiddleSmoothTotalFieldTmp, this->m_MovingToMiddleTransform->GetInverseDisplacementField() );
-    DisplacementFieldPointer movingToMiddleSmoothTotalField = this->InvertDisplacementField( movingToMiddleSmoothTotalFieldInverse, movingToMiddleSmoothTotalFieldTmp );
+    this->EstimateInverseDisplacementField( movingToMiddleSmoothTotalField, movingToMiddleSmoothTotalFieldInverse );
+    this->EstimateInverseDisplacementField( movingToMiddleSmoothTotalFieldInverse, movingToMiddleSmoothTotalField );
+    this->m_InversionTime.Stop();
 
-    // Assign the displacement fields and their inverses to the proper transforms.
+    // Assign the displacement fields and their inverses to the proper transforms.  Setting the
+    // displacement field releases the inverse field, which was updated in place, so it is reassigned.
     this->m_FixedToMiddleTransform->SetDisplacementField( fixedToMiddleSmoothTotalField );
     this->m_FixedToMiddleTransform->SetInverseDisplacementField( fixedToMiddleSmoothTotalFieldInverse );
 
@@ -227,6 +236,8 @@ BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
 
   // pre calculate the voxel distance to be used in properly scaling the gradient.
 
+  this->m_MetricTime.Start();
+
   this->m_Metric->SetFixedImage( fixedImage );
   this->m_Metric->SetFixedTransform( const_cast<TransformBaseType *>( fixedTransform ) );
   this->m_Metric->SetMovingImage( movingImage );
@@ -240,27 +251,18 @@ BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
   metricDerivative.Fill( NumericTraits<typename MetricDerivativeType::ValueType>::Zero );
   this->m_Metric->GetValueAndDerivative( value, metricDerivative );
 
+  this->m_MetricTime.Stop();
+
   // we rescale the update velocity field at each time point.
   // we first need to convert to a displacement field to look
   // at the max norm of the field.
 
-  const SizeValueType numberOfPixels = static_cast<SizeValueType>( metricDerivative.Size() / ImageDimension );
-  const bool importFilterWillReleaseMemory = false;
-
-  // Brad L. says I should feel bad about using a reinterpret_cast.  I do feel bad.
-
-  DisplacementVectorType *metricDerivativeFieldPointer = reinterpret_cast<DisplacementVectorType *>( metricDerivative.data_block() );
+  this->m_UpdateFieldSmoothingTime.Start();
 
-  typedef ImportImageFilter<DisplacementVectorType, ImageDimension> ImporterType;
-  typename ImporterType::Pointer importer = ImporterType::New();
-  importer->SetImportPointer( metricDerivativeFieldPointer, numberOfPixels, importFilterWillReleaseMemory );
-  importer->SetRegion( virtualDomainImage->GetBufferedRegion() );
-  importer->SetOrigin( virtualDomainImage->GetOrigin() );
-  importer->SetSpacing( virtualDomainImage->GetSpacing() );
-  importer->SetDirection( virtualDomainImage->GetDirection() );
-  importer->Update();
+  DisplacementFieldPointer metricDerivativeField = OutputTransformType::template GetDerivativeAsField<DisplacementFieldType>( metricDerivative,
+    virtualDomainImage->GetBufferedRegion(), virtualDomainImage->GetOrigin(), virtualDomainImage->GetSpacing(), virtualDomainImage->GetDirection() );
 
-  DisplacementFieldPointer updateField = this->BSplineSmoothDisplacementField( importer->GetOutput(), this->m_FixedToMiddleTransform->GetNumberOfControlPointsForTheUpdateField() );
+  DisplacementFieldPointer updateField = this->BSplineSmoothDisplacementField( metricDerivativeField, this->m_FixedToMiddleTransform->GetNumberOfControlPointsForTheUpdateField() );
 
   typename DisplacementFieldType::SpacingType spacing = updateField->GetSpacing();
   ImageRegionConstIterator<DisplacementFieldType> ItF( updateField, updateField->GetLargestPossibleRegion() );
@@ -283,20 +285,18 @@ BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
       }
     }
 
-  RealType scale = this->m_LearningRate / maxNorm;
+  // The smoothed field is not shared, so it is scaled in place.
+  const RealType scale = this->m_LearningRate / maxNorm;
 
-  typedef Image<RealType, ImageDimension> RealImageType;
-
-  typedef MultiplyImageFilter<DisplacementFieldType, RealImageType, DisplacementFieldType> MultiplierType;
-  typename MultiplierType::Pointer multiplier = MultiplierType::New();
-  multiplier->SetInput( updateField );
-  multiplier->SetConstant( scale );
+  ImageRegionIterator<DisplacementFieldType> ItS( updateField, updateField->GetLargestPossibleRegion() );
+  for( ItS.GoToBegin(); !ItS.IsAtEnd(); ++ItS )
+    {
+    ItS.Set( ItS.Get() * scale );
+    }
 
-  typename DisplacementFieldType::Pointer scaledUpdateField = multiplier->GetOutput();
-  scaledUpdateField->Update();
-  scaledUpdateField->DisconnectPipeline();
+  this->m_UpdateFieldSmoothingTime.Stop();
 
-  return scaledUpdateField;
+  return updateField;
 }
 
 template<typename TFixedImage, typename TMovingImage, typename TOutputTransform>
@@ -0,0 +1,232 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkBatchImageRegistrationMethodv4_h
+#define __itkBatchImageRegistrationMethodv4_h
+
+#include "itkObject.h"
+#include "itkMultiThreader.h"
+#include "itkSimpleFastMutexLock.h"
+
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/** \class BatchImageRegistrationMethodv4
+ * \brief Runs the registrations of many moving images to one fixed image
+ * concurrently, sharing the state that only depends on the fixed image.
+ *
+ * Each registration is an ImageRegistrationMethodv4, or one of its
+ * subclasses, configured as usual with its moving image, metric, optimizer,
+ * transforms and schedule, and added with AddRegistration().  All the
+ * registrations must use the same number of levels, shrink factors,
+ * smoothing sigmas and metric sampling, and must not share their metric or
+ * optimizer.  A metric that uses a fixed image gradient filter must use the
+ * default gradient filter and interpolator, whose gradients are taken from
+ * the gradient image cache.  StartRegistration() then prepares once:
+ *
+ *   \li the smoothed fixed image and the virtual domain of every level,
+ *       computed by a pyramid of the fixed image,
+ *   \li the cache of the gradient images, through which the metrics
+ *       compute the gradients of the smoothed fixed images once,
+ *   \li the metric sample points of every level, when the registrations
+ *       sample the metric,
+ *
+ * sets them, with the fixed image, on all the registrations, and runs
+ * NumberOfConcurrentRegistrations registrations at a time, each with
+ * NumberOfThreadsPerRegistration threads.  The registrations read images
+ * owned by the batch, which share the buffers of the fixed image and of
+ * the levels: neither the fixed image nor the pyramid is modified, and
+ * the pyramid is not updated while the registrations run.  A pyramid or a
+ * gradient image cache set on the batch is used instead of a new one, so
+ * that the fixed state can also be shared between batches.
+ *
+ * Registrations that draw from the global random generator while they
+ * run, for instance through a parameter scales estimator with
+ * RandomSampling, cannot be run concurrently.
+ *
+ * A registration that throws does not stop the others.  After
+ * StartRegistration(), the output transform and the statistics of each
+ * registration, that is whether it succeeded, its final metric value,
+ * convergence value, convergence state and iteration, and its elapsed
+ * time, can be queried by index.
+ *
+ * \sa ImageRegistrationMethodv4::SetFixedImagesPerLevel()
+ * \sa ImageRegistrationMethodv4::SetMetricSamplePointSetsPerLevel()
+ * \sa ImageToImageMetricv4::SetGradientImageCache()
+ *
+ * \ingroup ITKRegistrationMethodsv4
+ */
+template<typename TRegistrationMethod>
+class ITK_EXPORT BatchImageRegistrationMethodv4
+:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef BatchImageRegistrationMethodv4            Self;
+  typedef Object                                    Superclass;
+  typedef SmartPointer<Self>                        Pointer;
+  typedef SmartPointer<const Self>                  ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( BatchImageRegistrationMethodv4, Object );
+
+  /** Registration typedefs. */
+  typedef TRegistrationMethod                                         RegistrationMethodType;
+  typedef typename RegistrationMethodType::Pointer                    RegistrationMethodPointer;
+  typedef typename RegistrationMethodType::FixedImageType             FixedImageType;
+  typedef typename RegistrationMethodType::MovingImageType            MovingImageType;
+  typedef typename RegistrationMethodType::OutputTransformType        OutputTransformType;
+  typedef typename RegistrationMethodType::RealType                   RealType;
+  typedef typename RegistrationMethodType::MetricType                 MetricType;
+
+  /** Shared state typedefs. */
+  typedef typename RegistrationMethodType::FixedImagePyramidType      FixedImagePyramidType;
+  typedef typename FixedImagePyramidType::Pointer                     FixedImagePyramidPointer;
+  typedef typename MetricType::GradientImageCacheType                 GradientImageCacheType;
+  typedef typename GradientImageCacheType::Pointer                    GradientImageCachePointer;
+  typedef typename RegistrationMethodType::MetricSamplePointSetsContainerType
+                                                                      MetricSamplePointSetsContainerType;
+  typedef typename RegistrationMethodType::FixedImagePointer          FixedImagePointer;
+  typedef typename RegistrationMethodType::FixedImagesContainerType   FixedImagesContainerType;
+
+  /** Convergence and timing statistics of a registration of the batch. */
+  struct RegistrationStatisticsType
+  {
+    /** Whether the registration completed without throwing. */
+    bool          Succeeded;
+    /** Description of the exception thrown by the registration, if any. */
+    std::string   ErrorDescription;
+    /** Values reported by the registration at its end. */
+    RealType      MetricValue;
+    RealType      ConvergenceValue;
+    bool          IsConverged;
+    SizeValueType CurrentIteration;
+    /** Wall clock time of the registration, in seconds. */
+    RealType      ElapsedTime;
+  };
+
+  /** Set/Get the fixed image of all the registrations. */
+  itkSetConstObjectMacro( FixedImage, FixedImageType );
+  itkGetConstObjectMacro( FixedImage, FixedImageType );
+
+  /** Add a configured registration to the batch and return its index. */
+  SizeValueType AddRegistration( RegistrationMethodType * );
+
+  /** Get a registration of the batch. */
+  RegistrationMethodType * GetRegistration( const SizeValueType ) const;
+
+  /** Get the number of registrations of the batch. */
+  SizeValueType GetNumberOfRegistrations() const
+  { return static_cast<SizeValueType>( this->m_Registrations.size() ); }
+
+  /** Remove all the registrations from the batch. */
+  void ClearRegistrations();
+
+  /** Set/Get the pyramid that computes the levels of the fixed image.  By
+   * default a pyramid is created by StartRegistration(). */
+  itkSetObjectMacro( FixedImagePyramid, FixedImagePyramidType );
+  itkGetObjectMacro( FixedImagePyramid, FixedImagePyramidType );
+
+  /** Set/Get the cache of the gradient images, set on the metrics that do
+   * not have one.  By default a cache is created by StartRegistration(),
+   * which keeps the gradient images of every level of the fixed image and
+   * of the moving images of the concurrent registrations. */
+  itkSetObjectMacro( GradientImageCache, GradientImageCacheType );
+  itkGetObjectMacro( GradientImageCache, GradientImageCacheType );
+
+  /** Set/Get the number of registrations run at the same time.  Defaults to
+   * the global default number of threads. */
+  itkSetClampMacro( NumberOfConcurrentRegistrations, ThreadIdType, 1, ITK_MAX_THREADS );
+  itkGetConstMacro( NumberOfConcurrentRegistrations, ThreadIdType );
+
+  /** Set/Get the number of threads of each registration, set on the
+   * registration, its metric and its optimizer.  Defaults to 1. */
+  itkSetClampMacro( NumberOfThreadsPerRegistration, ThreadIdType, 1, ITK_MAX_THREADS );
+  itkGetConstMacro( NumberOfThreadsPerRegistration, ThreadIdType );
+
+  /** Prepare the shared state and run all the registrations. */
+  void StartRegistration();
+
+  /** Get the output transform of a registration. */
+  const OutputTransformType * GetOutputTransform( const SizeValueType ) const;
+
+  /** Get the statistics of a registration.  Valid after StartRegistration(). */
+  const RegistrationStatisticsType & GetRegistrationStatistics( const SizeValueType ) const;
+
+  /** Get the wall clock time spent preparing the shared state and running
+   * all the registrations, in seconds. */
+  itkGetConstMacro( PreparationTime, RealType );
+  itkGetConstMacro( ElapsedTime, RealType );
+
+protected:
+  BatchImageRegistrationMethodv4();
+  virtual ~BatchImageRegistrationMethodv4() {}
+  virtual void PrintSelf( std::ostream & os, Indent indent ) const;
+
+  /** Compute the state shared by the registrations and set it on them. */
+  virtual void PrepareRegistrations();
+
+  /** Make an image that shares the buffer of an image. */
+  FixedImagePointer ShareImageBuffer( const FixedImageType * ) const;
+
+  /** Run a registration and record its statistics.  Called concurrently. */
+  virtual void RunRegistration( const SizeValueType );
+
+  /** Static function used as a "callback" by the MultiThreader.  Each thread
+   * runs registrations until none is left. */
+  static ITK_THREAD_RETURN_TYPE RegistrationThreaderCallback( void *arg );
+
+private:
+  BatchImageRegistrationMethodv4( const Self & );   //purposely not implemented
+  void operator=( const Self & );                   //purposely not implemented
+
+  /** Take the index of the next registration to run, if any. */
+  bool GetNextRegistration( SizeValueType & );
+
+  typename FixedImageType::ConstPointer                           m_FixedImage;
+
+  std::vector<RegistrationMethodPointer>                          m_Registrations;
+  std::vector<RegistrationStatisticsType>                         m_RegistrationStatistics;
+
+  FixedImagePyramidPointer                                        m_FixedImagePyramid;
+  FixedImagesContainerType                                        m_FixedSmoothImagesPerLevel;
+  FixedImagesContainerType                                        m_VirtualDomainImagesPerLevel;
+  GradientImageCachePointer                                       m_GradientImageCache;
+  MetricSamplePointSetsContainerType                              m_MetricSamplePointSetsPerLevel;
+
+  ThreadIdType                                                    m_NumberOfConcurrentRegistrations;
+  ThreadIdType                                                    m_NumberOfThreadsPerRegistration;
+
+  MultiThreader::Pointer                                          m_Threader;
+  SimpleFastMutexLock                                             m_NextRegistrationLock;
+  SizeValueType                                                   m_NextRegistration;
+
+  RealType                                                        m_PreparationTime;
+  RealType                                                        m_ElapsedTime;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkBatchImageRegistrationMethodv4.hxx"
+#endif
+
+#endif
@@ -0,0 +1,399 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkBatchImageRegistrationMethodv4_hxx
+#define __itkBatchImageRegistrationMethodv4_hxx
+
+#include "itkBatchImageRegistrationMethodv4.h"
+#include "itkTimeProbe.h"
+
+#include <set>
+
+namespace itk
+{
+/**
+ * Constructor
+ */
+template<typename TRegistrationMethod>
+BatchImageRegistrationMethodv4<TRegistrationMethod>
+::BatchImageRegistrationMethodv4() :
+  m_NumberOfConcurrentRegistrations( MultiThreader::GetGlobalDefaultNumberOfThreads() ),
+  m_NumberOfThreadsPerRegistration( 1 ),
+  m_NextRegistration( 0 ),
+  m_PreparationTime( NumericTraits<RealType>::Zero ),
+  m_ElapsedTime( NumericTraits<RealType>::Zero )
+{
+  this->m_Threader = MultiThreader::New();
+}
+
+/**
+ * Add a registration
+ */
+template<typename TRegistrationMethod>
+SizeValueType
+BatchImageRegistrationMethodv4<TRegistrationMethod>
+::AddRegistration( RegistrationMethodType * registration )
+{
+  if( !registration )
+    {
+    itkExceptionMacro( "The registration is not present." );
+    }
+  this->m_Registrations.push_back( registration );
+  this->Modified();
+
+  return static_cast<SizeValueType>( this->m_Registrations.size() - 1 );
+}
+
+/**
+ * Get a registration
+ */
+template<typename TRegistrationMethod>
+typename BatchImageRegistrationMethodv4<TRegistrationMethod>::RegistrationMethodType *
+BatchImageRegistrationMethodv4<TRegistrationMethod>
+::GetRegistration( const SizeValueType index ) const
+{
+  if( index >= this->m_Registrations.size() )
+    {
+    itkExceptionMacro( "Registration " << index << " is out of range: the batch has "
+      << this->m_Registrations.size() << " registrations." );
+    }
+  return this->m_Registrations[index].GetPointer();
+}
+
+/**
+ * Remove all the registrations
+ */
+template<typename TRegistrationMethod>
+void
+BatchImageRegistrationMethodv4<TRegistrationMethod>
+::ClearRegistrations()
+{
+  this->m_Registrations.clear();
+  this->m_RegistrationStatistics.clear();
+  this->Modified();
+}
+
+/**
+ * Get the output transform of a registration
+ */
+template<typename TRegistrationMethod>
+const typename BatchImageRegistrationMethodv4<TRegistrationMethod>::OutputTransformType *
+BatchImageRegistrationMethodv4<TRegistrationMethod>
+::GetOutputTransform( const SizeValueType index ) const
+{
+  return this->GetRegistration( index )->GetOutput()->Get();
+}
+
+/**
+ * Get the statistics of a registration
+ */
+template<typename TRegistrationMethod>
+const typename BatchImageRegistrationMethodv4<TRegistrationMethod>::RegistrationStatisticsType &
+BatchImageRegistrationMethodv4<TRegistrationMethod>
+::GetRegistrationStatistics( const SizeValueType index ) const
+{
+  if( index >= this->m_RegistrationStatistics.size() )
+    {
+    itkExceptionMacro( "No statistics for registration " << index << ": the batch has run "
+      << this->m_RegistrationStatistics.size() << " registrations." );
+    }
+  return this->m_RegistrationStatistics[index];
+}
+
+/**
+ * Prepare the shared state and set it on the registrations
+ */
+template<typename TRegistrationMethod>
+void
+BatchImageRegistrationMethodv4<TRegistrationMethod>
+::PrepareRegistrations()
+{
+  if( !this->m_FixedImage )
+    {
+    itkExceptionMacro( "The fixed image is not present." );
+    }
+  if( this->m_Registrations.empty() )
+    {
+    itkExceptionMacro( "The batch has no registration." );
+    }
+
+  // The shared state is computed from the schedule and the sampling of the
+  // first registration, which all the others must use as well.
+  const RegistrationMethodType * reference = this->m_Registrations[0];
+  const SizeValueType numberOfLevels = reference->GetNumberOfLevels();
+
+  std::set<const void *> registrations;
+  std::set<const void *> metrics;
+  std::set<const void *> optimizers;
+  for( SizeValueType n = 0; n < this->m_Registrations.size(); n++ )
+    {
+    RegistrationMethodType * registration = this->m_Registrations[n];
+    if( !registration->GetMetric() || !registration->GetOptimizer() )
+      {
+      itkExceptionMacro( "Registration " << n << " has no metric or no optimizer." );
+      }
+    if( registration->GetNumberOfLevels() != numberOfLevels
+      || registration->GetShrinkFactorsPerLevel() != reference->GetShrinkFactorsPerLevel()
+      || registration->GetSmoothingSigmasPerLevel() != reference->GetSmoothingSigmasPerLevel() )
+      {
+      itkExceptionMacro( "Registration " << n << " does not have the schedule of the first registration." );
+      }
+    if( registration->GetMetricSamplingStrategy() != reference->GetMetricSamplingStrategy()
+      || registration->GetMetricSamplingPercentagePerLevel() != reference->GetMetricSamplingPercentagePerLevel() )
+      {
+      itkExceptionMacro( "Registration " << n << " does not have the metric sampling of the first registration." );
+      }
+    if( !registrations.insert( registration ).second
+      || !metrics.insert( registration->GetMetric() ).second
+      || !optimizers.insert( registration->GetOptimizer() ).second )
+      {
+      itkExceptionMacro( "Registration " << n << " shares its registration method, metric or optimizer "
+        << "with another registration of the batch." );
+      }
+    }
+
+  // The levels of the fixed image are computed once, here, by the pyramid.
+  if( !this->m_FixedImagePyramid )
+    {
+    this->m_FixedImagePyramid = FixedImagePyramidType::New();
+    }
+  typename FixedImagePyramidType::SmoothingSigmasArrayType smoothingSigmas( reference->GetSmoothingSigmasPerLevel().Size() );
+  for( SizeValueType n = 0; n < smoothingSigmas.Size(); n++ )
+    {
+    smoothingSigmas[n] = reference->GetSmoothingSigmasPerLevel()[n];
+    }
+  this->m_FixedImagePyramid->SetInput( this->m_FixedImage );
+  this->m_FixedImagePyramid->SetShrinkFactorsPerLevel( reference->GetShrinkFactorsPerLevel() );
+  this->m_FixedImagePyramid->SetSmoothingSigmasPerLevel( smoothingSigmas );
+  this->m_FixedImagePyramid->Update();
+
+  // The registrations read images owned by the batch, which share the
+  // buffers of the levels, so that the pyramid is never updated while they
+  // run.  All the registrations read the same level images, through which
+  // the gradient image cache identifies the gradients they share.
+  this->m_FixedSmoothImagesPerLevel.resize( numberOfLevels );
+  this->m_VirtualDomainImagesPerLevel.resize( numberOfLevels );
+  for( SizeValueType level = 0; level < numberOfLevels; level++ )
+    {
+    this->m_FixedSmoothImagesPerLevel[level] = this->ShareImageBuffer( this->m_FixedImagePyramid->GetSmoothedImage( level ) );
+    this->m_VirtualDomainImagesPerLevel[level] = this->ShareImageBuffer( this->m_FixedImagePyramid->GetShrunkImage( level ) );
+    }
+
+  if( !this->m_GradientImageCache )
+    {
+    this->m_GradientImageCache = GradientImageCacheType::New();
+    this->m_GradientImageCache->SetMaximumNumberOfEntries( numberOfLevels * ( this->m_NumberOfConcurrentRegistrations + 1 ) );
+    this->m_GradientImageCache->SetNumberOfThreads( this->m_NumberOfThreadsPerRegistration );
+    }
+
+  // The sample points are generated here, serially, since the random
+  // sampling draws from the global random generator.
+  this->m_MetricSamplePointSetsPerLevel.clear();
+  if( reference->GetMetricSamplingStrategy() != RegistrationMethodType::NONE )
+    {
+    for( SizeValueType level = 0; level < numberOfLevels; level++ )
+      {
+      this->m_MetricSamplePointSetsPerLevel.push_back(
+        reference->GenerateMetricSamplePoints( this->m_VirtualDomainImagesPerLevel[level], level ) );
+      }
+    }
+
+  for( SizeValueType n = 0; n < this->m_Registrations.size(); n++ )
+    {
+    RegistrationMethodType * registration = this->m_Registrations[n];
+    // The fixed image is an input of the pipeline of each registration,
+    // which writes its requested region, so each registration gets its own.
+    registration->SetFixedImage( this->ShareImageBuffer( this->m_FixedImage ) );
+    registration->SetFixedImagesPerLevel( this->m_FixedSmoothImagesPerLevel, this->m_VirtualDomainImagesPerLevel );
+    registration->SetMetricSamplePointSetsPerLevel( this->m_MetricSamplePointSetsPerLevel );
+    registration->SetNumberOfThreads( this->m_NumberOfThreadsPerRegistration );
+
+    MetricType * metric = registration->GetMetric();
+    if( !metric->GetGradientImageCache() )
+      {
+      metric->SetGradientImageCache( this->m_GradientImageCache );
+      }
+    // A gradient filter run on the level images, which all the
+    // registrations share, would update them from several threads.
+    if( metric->GetUseFixedImageGradientFilter() && !metric->GetFixedImageGradientsFromCache() )
+      {
+      itkExceptionMacro( "The metric of registration " << n << " computes the fixed image gradients with a "
+        << "gradient filter or interpolator other than the default ones, which cannot share the level images." );
+      }
+    metric->SetMaximumNumberOfThreads( this->m_NumberOfThreadsPerRegistration );
+    registration->GetOptimizer()->SetNumberOfThreads( this->m_NumberOfThreadsPerRegistration );
+    }
+
+  this->m_RegistrationStatistics.assign( this->m_Registrations.size(), RegistrationStatisticsType() );
+}
+
+/**
+ * Make an image that shares the buffer of an image
+ */
+template<typename TRegistrationMethod>
+typename BatchImageRegistrationMethodv4<TRegistrationMethod>::FixedImagePointer
+BatchImageRegistrationMethodv4<TRegistrationMethod>
+::ShareImageBuffer( const FixedImageType * image ) const
+{
+  FixedImagePointer sharedImage = FixedImageType::New();
+  sharedImage->CopyInformation( image );
+  sharedImage->SetBufferedRegion( image->GetBufferedRegion() );
+  sharedImage->SetRequestedRegionToLargestPossibleRegion();
+  sharedImage->SetPixelContainer( const_cast<typename FixedImageType::PixelContainer *>( image->GetPixelContainer() ) );
+
+  return sharedImage;
+}
+
+/**
+ * Prepare the shared state and run all the registrations
+ */
+template<typename TRegistrationMethod>
+void
+BatchImageRegistrationMethodv4<TRegistrationMethod>
+::StartRegistration()
+{
+  TimeProbe elapsedTime;
+  elapsedTime.Start();
+
+  TimeProbe preparationTime;
+  preparationTime.Start();
+  this->PrepareRegistrations();
+  preparationTime.Stop();
+  this->m_PreparationTime = static_cast<RealType>( preparationTime.GetTotal() );
+
+  this->m_NextRegistration = 0;
+
+  const SizeValueType numberOfRegistrations = this->m_Registrations.size();
+  ThreadIdType numberOfThreads = this->m_NumberOfConcurrentRegistrations;
+  if( numberOfRegistrations < numberOfThreads )
+    {
+    numberOfThreads = static_cast<ThreadIdType>( numberOfRegistrations );
+    }
+  this->m_Threader->SetNumberOfThreads( numberOfThreads );
+  this->m_Threader->SetSingleMethod( this->RegistrationThreaderCallback, this );
+  this->m_Threader->SingleMethodExecute();
+
+  elapsedTime.Stop();
+  this->m_ElapsedTime = static_cast<RealType>( elapsedTime.GetTotal() );
+}
+
+/**
+ * Run the registrations of one thread
+ */
+template<typename TRegistrationMethod>
+ITK_THREAD_RETURN_TYPE
+BatchImageRegistrationMethodv4<TRegistrationMethod>
+::RegistrationThreaderCallback( void *arg )
+{
+  MultiThreader::ThreadInfoStruct * threadInfo = static_cast<MultiThreader::ThreadInfoStruct *>( arg );
+  Self * self = static_cast<Self *>( threadInfo->UserData );
+
+  SizeValueType index;
+  while( self->GetNextRegistration( index ) )
+    {
+    self->RunRegistration( index );
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/**
+ * Take the index of the next registration to run
+ */
+template<typename TRegistrationMethod>
+bool
+BatchImageRegistrationMethodv4<TRegistrationMethod>
+::GetNextRegistration( SizeValueType & index )
+{
+  this->m_NextRegistrationLock.Lock();
+  index = this->m_NextRegistration;
+  const bool available = ( index < this->m_Registrations.size() );
+  if( available )
+    {
+    ++this->m_NextRegistration;
+    }
+  this->m_NextRegistrationLock.Unlock();
+
+  return available;
+}
+
+/**
+ * Run a registration and record its statistics
+ */
+template<typename TRegistrationMethod>
+void
+BatchImageRegistrationMethodv4<TRegistrationMethod>
+::RunRegistration( const SizeValueType index )
+{
+  RegistrationMethodType * registration = this->m_Registrations[index];
+  RegistrationStatisticsType & statistics = this->m_RegistrationStatistics[index];
+
+  statistics.Succeeded = false;
+  statistics.ErrorDescription.clear();
+
+  TimeProbe elapsedTime;
+  elapsedTime.Start();
+  try
+    {
+    registration->StartRegistration();
+    statistics.Succeeded = true;
+    }
+  catch( ExceptionObject & exception )
+    {
+    statistics.ErrorDescription = exception.GetDescription();
+    }
+  catch( std::exception & exception )
+    {
+    statistics.ErrorDescription = exception.what();
+    }
+  catch( ... )
+    {
+    statistics.ErrorDescription = "Unknown exception.";
+    }
+  elapsedTime.Stop();
+
+  statistics.MetricValue = registration->GetCurrentMetricValue();
+  statistics.ConvergenceValue = registration->GetCurrentConvergenceValue();
+  statistics.IsConverged = registration->GetIsConverged();
+  statistics.CurrentIteration = registration->GetCurrentIteration();
+  statistics.ElapsedTime = static_cast<RealType>( elapsedTime.GetTotal() );
+}
+
+/**
+ * PrintSelf
+ */
+template<typename TRegistrationMethod>
+void
+BatchImageRegistrationMethodv4<TRegistrationMethod>
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "Fixed image: " << this->m_FixedImage.GetPointer() << std::endl;
+  os << indent << "Number of registrations: " << this->m_Registrations.size() << std::endl;
+  os << indent << "Fixed image pyramid: " << this->m_FixedImagePyramid.GetPointer() << std::endl;
+  os << indent << "Gradient image cache: " << this->m_GradientImageCache.GetPointer() << std::endl;
+  os << indent << "Number of metric sample point sets: " << this->m_MetricSamplePointSetsPerLevel.size() << std::endl;
+  os << indent << "Number of concurrent registrations: " << this->m_NumberOfConcurrentRegistrations << std::endl;
+  os << indent << "Number of threads per registration: " << this->m_NumberOfThreadsPerRegistration << std::endl;
+  os << indent << "Preparation time: " << this->m_PreparationTime << std::endl;
+  os << indent << "Elapsed time: " << this->m_ElapsedTime << std::endl;
+}
+
+} // end namespace itk
+
+#endif
@@ -26,6 +26,7 @@
 #include "itkObjectToObjectOptimizerBase.h"
 #include "itkImageToImageMetricv4.h"
 #include "itkInterpolateImageFunction.h"
+#include "itkRegistrationImagePyramid.h"
 #include "itkTransform.h"
 #include "itkTransformParametersAdaptor.h"
 
@@ -112,13 +113,14 @@ public:
   typedef TMovingImage                                                MovingImageType;
   typedef typename MovingImageType::Pointer                           MovingImagePointer;
 
-  /** Metric and transform typedefs */
-  typedef ImageToImageMetricv4<FixedImageType, MovingImageType>       MetricType;
-  typedef typename MetricType::Pointer                                MetricPointer;
-
+  /** Metric and transform typedefs. The scalar type of the output
+   * transform is also the precision of the metric transforms. */
   typedef TOutputTransform                                            OutputTransformType;
   typedef typename OutputTransformType::Pointer                       OutputTransformPointer;
   typedef typename OutputTransformType::ScalarType                    RealType;
+
+  typedef ImageToImageMetricv4<FixedImageType, MovingImageType, FixedImageType, RealType> MetricType;
+  typedef typename MetricType::Pointer                                MetricPointer;
   typedef typename OutputTransformType::DerivativeType                DerivativeType;
   typedef typename DerivativeType::ValueType                          DerivativeValueType;
 
@@ -140,10 +142,17 @@ public:
   typedef Array<RealType>                                             SmoothingSigmasArrayType;
   typedef Array<RealType>                                             MetricSamplingPercentageArrayType;
 
+  /** Image pyramid typedefs */
+  typedef RegistrationImagePyramid<FixedImageType>                    FixedImagePyramidType;
+  typedef typename FixedImagePyramidType::Pointer                     FixedImagePyramidPointer;
+  typedef RegistrationImagePyramid<MovingImageType>                   MovingImagePyramidType;
+  typedef typename MovingImagePyramidType::Pointer                    MovingImagePyramidPointer;
+  typedef std::vector<FixedImagePointer>                              FixedImagesContainerType;
+
   /** Interpolator typedefs */
-  typedef InterpolateImageFunction<FixedImageType, RealType>          FixedInterpolatorType;
+  typedef typename MetricType::FixedInterpolatorType                  FixedInterpolatorType;
   typedef typename FixedInterpolatorType::Pointer                     FixedInterpolatorPointer;
-  typedef InterpolateImageFunction<MovingImageType, RealType>         MovingInterpolatorType;
+  typedef typename MetricType::MovingInterpolatorType                 MovingInterpolatorType;
   typedef typename MovingInterpolatorType::Pointer                    MovingInterpolatorPointer;
 
   /** Transform adaptor typedefs */
@@ -151,14 +160,17 @@ public:
   typedef typename TransformParametersAdaptorType::Pointer            TransformParametersAdaptorPointer;
   typedef std::vector<TransformParametersAdaptorPointer>              TransformParametersAdaptorsContainerType;
 
-  /**  Type of the optimizer. */
-  typedef ObjectToObjectOptimizerBase                                 OptimizerType;
+  /**  Type of the optimizer, which works in the precision of the output transform. */
+  typedef ObjectToObjectOptimizerBaseTemplate<RealType>               OptimizerType;
   typedef typename OptimizerType::Pointer                             OptimizerPointer;
 
   /** enum type for metric sampling strategy */
   enum MetricSamplingStrategyType { NONE, REGULAR, RANDOM };
 
   typedef typename MetricType::FixedSampledPointSetType               MetricSamplePointSetType;
+  typedef typename MetricSamplePointSetType::Pointer                  MetricSamplePointSetPointer;
+  typedef std::vector<MetricSamplePointSetPointer>                    MetricSamplePointSetsContainerType;
+  typedef typename MetricType::VirtualImageType                       VirtualImageType;
 
   /** Set/Get the fixed image. */
   itkSetInputMacro( FixedImage, FixedImageType );
@@ -199,6 +211,25 @@ public:
   itkSetMacro( MetricSamplingPercentagePerLevel, MetricSamplingPercentageArrayType );
   itkGetConstMacro( MetricSamplingPercentagePerLevel, MetricSamplingPercentageArrayType );
 
+  /**
+   * Set/Get the metric sample point sets of the levels.  When the point set
+   * of a level is set, the metric is sampled at its points instead of
+   * points generated with the sampling strategy, so that the points
+   * generated once with GenerateMetricSamplePoints() can be shared by the
+   * registrations of many moving images to the same fixed image.  Empty by
+   * default.
+   */
+  void SetMetricSamplePointSetsPerLevel( const MetricSamplePointSetsContainerType & );
+  const MetricSamplePointSetsContainerType & GetMetricSamplePointSetsPerLevel() const;
+
+  /**
+   * Generate the metric sample points of a level over the given virtual
+   * domain, following the sampling strategy and the sampling percentage of
+   * the level.  The virtual domain of a level is the shrunk fixed image of
+   * that level.
+   */
+  MetricSamplePointSetPointer GenerateMetricSamplePoints( const VirtualImageType *, const SizeValueType ) const;
+
   /** Set/Get the optimizer. */
   itkSetObjectMacro( Optimizer, OptimizerType );
   itkGetObjectMacro( Optimizer, OptimizerType );
@@ -233,6 +264,34 @@ public:
   itkSetMacro( SmoothingSigmasPerLevel, SmoothingSigmasArrayType );
   itkGetConstMacro( SmoothingSigmasPerLevel, SmoothingSigmasArrayType );
 
+  /**
+   * Set/Get the pyramid of the fixed image.  When set, the smoothed fixed
+   * image and the reference domain of each level are taken from the pyramid,
+   * which is given the fixed image and the shrink factors and smoothing sigmas
+   * of the registration, and is only recomputed when these change.  Sharing
+   * one pyramid between the registrations of many moving images to the same
+   * fixed image computes its levels once.  By default no pyramid is set and
+   * each level is computed when the registration reaches it.
+   */
+  itkSetObjectMacro( FixedImagePyramid, FixedImagePyramidType );
+  itkGetObjectMacro( FixedImagePyramid, FixedImagePyramidType );
+
+  /** Set/Get the pyramid of the moving image.  \sa SetFixedImagePyramid() */
+  itkSetObjectMacro( MovingImagePyramid, MovingImagePyramidType );
+  itkGetObjectMacro( MovingImagePyramid, MovingImagePyramidType );
+
+  /**
+   * Set/Get the smoothed fixed image and the reference domain of each
+   * level, computed beforehand.  When both are set for a level, they are
+   * used as they are, instead of the fixed image pyramid or of the fixed
+   * image, and must not be modified while the registration runs.  Several
+   * registrations may read the same images concurrently.  Empty by default.
+   */
+  void SetFixedImagesPerLevel( const FixedImagesContainerType & smoothImages,
+                               const FixedImagesContainerType & virtualDomainImages );
+  const FixedImagesContainerType & GetFixedSmoothImagesPerLevel() const;
+  const FixedImagesContainerType & GetVirtualDomainImagesPerLevel() const;
+
   /** Method that initiates the registration */
   void StartRegistration() { this->GenerateData(); }
 
@@ -294,10 +353,16 @@ protected:
   MetricPointer                                                   m_Metric;
   MetricSamplingStrategyType                                      m_MetricSamplingStrategy;
   MetricSamplingPercentageArrayType                               m_MetricSamplingPercentagePerLevel;
+  MetricSamplePointSetsContainerType                              m_MetricSamplePointSetsPerLevel;
 
   ShrinkFactorsArrayType                                          m_ShrinkFactorsPerLevel;
   SmoothingSigmasArrayType                                        m_SmoothingSigmasPerLevel;
 
+  FixedImagePyramidPointer                                        m_FixedImagePyramid;
+  MovingImagePyramidPointer                                       m_MovingImagePyramid;
+  FixedImagesContainerType                                        m_FixedSmoothImagesPerLevel;
+  FixedImagesContainerType                                        m_VirtualDomainImagesPerLevel;
+
   TransformParametersAdaptorsContainerType                        m_TransformParametersAdaptorsPerLevel;
 
   CompositeTransformPointer                                       m_CompositeTransform;
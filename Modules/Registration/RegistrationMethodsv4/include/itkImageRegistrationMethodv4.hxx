@@ -58,15 +58,15 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>
   typename IdentityTransformType::Pointer defaultMovingInitialTransform = IdentityTransformType::New();
   this->m_MovingInitialTransform = defaultMovingInitialTransform;
 
-  typedef LinearInterpolateImageFunction<FixedImageType, RealType> DefaultFixedInterpolatorType;
+  typedef LinearInterpolateImageFunction<FixedImageType, typename FixedInterpolatorType::CoordRepType> DefaultFixedInterpolatorType;
   typename DefaultFixedInterpolatorType::Pointer fixedInterpolator = DefaultFixedInterpolatorType::New();
   this->m_FixedInterpolator = fixedInterpolator;
 
-  typedef LinearInterpolateImageFunction<MovingImageType, RealType> DefaultMovingInterpolatorType;
+  typedef LinearInterpolateImageFunction<MovingImageType, typename MovingInterpolatorType::CoordRepType> DefaultMovingInterpolatorType;
   typename DefaultMovingInterpolatorType::Pointer movingInterpolator = DefaultMovingInterpolatorType::New();
   this->m_MovingInterpolator = movingInterpolator;
 
-  typedef JointHistogramMutualInformationImageToImageMetricv4<FixedImageType, MovingImageType> MetricForStageOneType;
+  typedef JointHistogramMutualInformationImageToImageMetricv4<FixedImageType, MovingImageType, FixedImageType, RealType> MetricForStageOneType;
   typename MetricForStageOneType::Pointer mutualInformationMetric = MetricForStageOneType::New();
   mutualInformationMetric->SetNumberOfHistogramBins( 20 );
   mutualInformationMetric->SetUseMovingImageGradientFilter( false );
@@ -79,7 +79,7 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>
   scalesEstimator->SetMetric( mutualInformationMetric );
   scalesEstimator->SetTransformForward( true );
 
-  typedef GradientDescentOptimizerv4 DefaultOptimizerType;
+  typedef GradientDescentOptimizerv4Template<RealType> DefaultOptimizerType;
   typename DefaultOptimizerType::Pointer optimizer = DefaultOptimizerType::New();
   optimizer->SetLearningRate( 1.0 );
   optimizer->SetNumberOfIterations( 1000 );
@@ -168,34 +168,73 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>
   // At each resolution, we can
   //   1. subsample the reference domain (typically the fixed image) and/or
   //   2. smooth the fixed and moving images.
+  // Image pyramids, when set, hold both for all levels.
 
-  typedef ShrinkImageFilter<FixedImageType, FixedImageType> ShrinkFilterType;
-  typename ShrinkFilterType::Pointer shrinkFilter = ShrinkFilterType::New();
-  shrinkFilter->SetShrinkFactors( this->m_ShrinkFactorsPerLevel[level] );
-  shrinkFilter->SetInput( this->GetFixedImage() );
-  shrinkFilter->Update();
-
-  typedef DiscreteGaussianImageFilter<FixedImageType, FixedImageType> FixedImageSmoothingFilterType;
-  typename FixedImageSmoothingFilterType::Pointer fixedImageSmoothingFilter = FixedImageSmoothingFilterType::New();
-  fixedImageSmoothingFilter->SetUseImageSpacingOn();
-  fixedImageSmoothingFilter->SetVariance( vnl_math_sqr( this->m_SmoothingSigmasPerLevel[level] ) );
-  fixedImageSmoothingFilter->SetMaximumError( 0.01 );
-  fixedImageSmoothingFilter->SetInput( this->GetFixedImage() );
-
-  this->m_FixedSmoothImage = fixedImageSmoothingFilter->GetOutput();
-  this->m_FixedSmoothImage->Update();
-  this->m_FixedSmoothImage->DisconnectPipeline();
-
-  typedef DiscreteGaussianImageFilter<MovingImageType, MovingImageType> MovingImageSmoothingFilterType;
-  typename MovingImageSmoothingFilterType::Pointer movingImageSmoothingFilter = MovingImageSmoothingFilterType::New();
-  movingImageSmoothingFilter->SetUseImageSpacingOn();
-  movingImageSmoothingFilter->SetVariance( vnl_math_sqr( this->m_SmoothingSigmasPerLevel[level] ) );
-  movingImageSmoothingFilter->SetMaximumError( 0.01 );
-  movingImageSmoothingFilter->SetInput( this->GetMovingImage() );
-
-  this->m_MovingSmoothImage = movingImageSmoothingFilter->GetOutput();
-  this->m_MovingSmoothImage->Update();
-  this->m_MovingSmoothImage->DisconnectPipeline();
+  typename FixedImagePyramidType::SmoothingSigmasArrayType smoothingSigmas( this->m_SmoothingSigmasPerLevel.Size() );
+  for( unsigned int n = 0; n < smoothingSigmas.Size(); n++ )
+    {
+    smoothingSigmas[n] = this->m_SmoothingSigmasPerLevel[n];
+    }
+
+  FixedImagePointer virtualDomainImage;
+  if( level < this->m_FixedSmoothImagesPerLevel.size() && level < this->m_VirtualDomainImagesPerLevel.size() )
+    {
+    virtualDomainImage = this->m_VirtualDomainImagesPerLevel[level];
+    this->m_FixedSmoothImage = this->m_FixedSmoothImagesPerLevel[level];
+    }
+  else if( this->m_FixedImagePyramid )
+    {
+    this->m_FixedImagePyramid->SetInput( this->GetFixedImage() );
+    this->m_FixedImagePyramid->SetShrinkFactorsPerLevel( this->m_ShrinkFactorsPerLevel );
+    this->m_FixedImagePyramid->SetSmoothingSigmasPerLevel( smoothingSigmas );
+    this->m_FixedImagePyramid->Update();
+
+    virtualDomainImage = this->m_FixedImagePyramid->GetShrunkImage( level );
+    this->m_FixedSmoothImage = this->m_FixedImagePyramid->GetSmoothedImage( level );
+    }
+  else
+    {
+    typedef ShrinkImageFilter<FixedImageType, FixedImageType> ShrinkFilterType;
+    typename ShrinkFilterType::Pointer shrinkFilter = ShrinkFilterType::New();
+    shrinkFilter->SetShrinkFactors( this->m_ShrinkFactorsPerLevel[level] );
+    shrinkFilter->SetInput( this->GetFixedImage() );
+    shrinkFilter->Update();
+    virtualDomainImage = shrinkFilter->GetOutput();
+
+    typedef DiscreteGaussianImageFilter<FixedImageType, FixedImageType> FixedImageSmoothingFilterType;
+    typename FixedImageSmoothingFilterType::Pointer fixedImageSmoothingFilter = FixedImageSmoothingFilterType::New();
+    fixedImageSmoothingFilter->SetUseImageSpacingOn();
+    fixedImageSmoothingFilter->SetVariance( vnl_math_sqr( this->m_SmoothingSigmasPerLevel[level] ) );
+    fixedImageSmoothingFilter->SetMaximumError( 0.01 );
+    fixedImageSmoothingFilter->SetInput( this->GetFixedImage() );
+
+    this->m_FixedSmoothImage = fixedImageSmoothingFilter->GetOutput();
+    this->m_FixedSmoothImage->Update();
+    this->m_FixedSmoothImage->DisconnectPipeline();
+    }
+
+  if( this->m_MovingImagePyramid )
+    {
+    this->m_MovingImagePyramid->SetInput( this->GetMovingImage() );
+    this->m_MovingImagePyramid->SetShrinkFactorsPerLevel( this->m_ShrinkFactorsPerLevel );
+    this->m_MovingImagePyramid->SetSmoothingSigmasPerLevel( smoothingSigmas );
+    this->m_MovingImagePyramid->Update();
+
+    this->m_MovingSmoothImage = this->m_MovingImagePyramid->GetSmoothedImage( level );
+    }
+  else
+    {
+    typedef DiscreteGaussianImageFilter<MovingImageType, MovingImageType> MovingImageSmoothingFilterType;
+    typename MovingImageSmoothingFilterType::Pointer movingImageSmoothingFilter = MovingImageSmoothingFilterType::New();
+    movingImageSmoothingFilter->SetUseImageSpacingOn();
+    movingImageSmoothingFilter->SetVariance( vnl_math_sqr( this->m_SmoothingSigmasPerLevel[level] ) );
+    movingImageSmoothingFilter->SetMaximumError( 0.01 );
+    movingImageSmoothingFilter->SetInput( this->GetMovingImage() );
+
+    this->m_MovingSmoothImage = movingImageSmoothingFilter->GetOutput();
+    this->m_MovingSmoothImage->Update();
+    this->m_MovingSmoothImage->DisconnectPipeline();
+    }
 
   // Set-up the composite transform at initialization
   if( level == 0 )
@@ -222,7 +261,7 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>
   this->m_Metric->SetMovingInterpolator( this->m_MovingInterpolator );
   this->m_Metric->SetFixedImage( this->m_FixedSmoothImage );
   this->m_Metric->SetMovingImage( this->m_MovingSmoothImage );
-  this->m_Metric->SetVirtualDomainFromImage( shrinkFilter->GetOutput() );
+  this->m_Metric->SetVirtualDomainFromImage( virtualDomainImage );
 
   if( this->m_MetricSamplingStrategy != NONE )
     {
@@ -257,6 +296,25 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>
 
     this->m_Metric->Initialize();
     this->m_Optimizer->StartOptimization();
+
+    // Report the state of the optimizer at the end of the level.
+    this->m_CurrentMetricValue = static_cast<RealType>( this->m_Optimizer->GetCurrentMetricValue() );
+
+    typedef GradientDescentOptimizerBasev4Template<RealType> GradientDescentOptimizerBasev4Type;
+    const GradientDescentOptimizerBasev4Type *gradientDescentOptimizer =
+      dynamic_cast<const GradientDescentOptimizerBasev4Type *>( this->m_Optimizer.GetPointer() );
+    if( gradientDescentOptimizer )
+      {
+      this->m_CurrentIteration = gradientDescentOptimizer->GetCurrentIteration();
+      this->m_IsConverged = ( gradientDescentOptimizer->GetStopCondition() == GradientDescentOptimizerBasev4Type::CONVERGENCE_CHECKER_PASSED );
+      }
+    typedef GradientDescentOptimizerv4Template<RealType> GradientDescentOptimizerv4Type;
+    const GradientDescentOptimizerv4Type *gradientDescentOptimizerv4 =
+      dynamic_cast<const GradientDescentOptimizerv4Type *>( this->m_Optimizer.GetPointer() );
+    if( gradientDescentOptimizerv4 )
+      {
+      this->m_CurrentConvergenceValue = static_cast<RealType>( gradientDescentOptimizerv4->GetConvergenceValue() );
+      }
     }
 }
 
@@ -335,17 +393,37 @@ void
 ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>
 ::SetMetricSamplePoints()
 {
-  typename MetricSamplePointSetType::Pointer samplePointSet = MetricSamplePointSetType::New();
+  MetricSamplePointSetPointer samplePointSet;
+  if( this->m_CurrentLevel < this->m_MetricSamplePointSetsPerLevel.size() )
+    {
+    samplePointSet = this->m_MetricSamplePointSetsPerLevel[this->m_CurrentLevel];
+    }
+  if( samplePointSet.IsNull() )
+    {
+    samplePointSet = this->GenerateMetricSamplePoints( this->m_Metric->GetVirtualImage(), this->m_CurrentLevel );
+    }
+
+  this->m_Metric->SetFixedSampledPointSet( samplePointSet );
+  this->m_Metric->SetUseFixedSampledPointSet( true );
+}
+
+/**
+ * Generate the metric samples of a level
+ */
+template<typename TFixedImage, typename TMovingImage, typename TTransform>
+typename ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>::MetricSamplePointSetPointer
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>
+::GenerateMetricSamplePoints( const VirtualImageType * virtualImage, const SizeValueType level ) const
+{
+  MetricSamplePointSetPointer samplePointSet = MetricSamplePointSetType::New();
   samplePointSet->Initialize();
 
   typedef typename MetricSamplePointSetType::PointType SamplePointType;
 
-  typedef typename MetricType::VirtualImageType         VirtualDomainImageType;
-  typedef typename VirtualDomainImageType::RegionType   VirtualDomainRegionType;
+  typedef typename VirtualImageType::RegionType         VirtualDomainRegionType;
 
-  const VirtualDomainImageType * virtualImage = this->m_Metric->GetVirtualImage();
   const VirtualDomainRegionType & virtualDomainRegion = virtualImage->GetRequestedRegion();
-  const typename VirtualDomainImageType::SpacingType virtualSpacing = virtualImage->GetSpacing();
+  const typename VirtualImageType::SpacingType virtualSpacing = virtualImage->GetSpacing();
 
   unsigned long sampleCount = virtualDomainRegion.GetNumberOfPixels();
 
@@ -359,10 +437,10 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>
     {
     case REGULAR:
       {
-      sampleCount = static_cast<unsigned long>( vcl_ceil( 1.0 / this->m_MetricSamplingPercentagePerLevel[this->m_CurrentLevel] ) );
+      sampleCount = static_cast<unsigned long>( vcl_ceil( 1.0 / this->m_MetricSamplingPercentagePerLevel[level] ) );
 
       unsigned long count = 0;
-      ImageRegionConstIteratorWithIndex<VirtualDomainImageType> It( virtualImage, virtualDomainRegion );
+      ImageRegionConstIteratorWithIndex<VirtualImageType> It( virtualImage, virtualDomainRegion );
       for( It.GoToBegin(); !It.IsAtEnd(); ++It )
         {
         if( count % sampleCount == 0 )
@@ -384,9 +462,9 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>
       }
     case RANDOM:
       {
-      sampleCount = static_cast<unsigned long>( static_cast<float>( sampleCount ) * this->m_MetricSamplingPercentagePerLevel[this->m_CurrentLevel] );
+      sampleCount = static_cast<unsigned long>( static_cast<float>( sampleCount ) * this->m_MetricSamplingPercentagePerLevel[level] );
 
-      ImageRandomConstIteratorWithIndex<VirtualDomainImageType> ItR( virtualImage, virtualDomainRegion );
+      ImageRandomConstIteratorWithIndex<VirtualImageType> ItR( virtualImage, virtualDomainRegion );
       ItR.SetNumberOfSamples( sampleCount );
       for( ItR.GoToBegin(); !ItR.IsAtEnd(); ++ItR )
         {
@@ -409,8 +487,66 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>
       }
     }
 
-  this->m_Metric->SetFixedSampledPointSet( samplePointSet );
-  this->m_Metric->SetUseFixedSampledPointSet( true );
+  return samplePointSet;
+}
+
+/**
+ * Set the metric sample point sets per level
+ */
+template<typename TFixedImage, typename TMovingImage, typename TTransform>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>
+::SetMetricSamplePointSetsPerLevel( const MetricSamplePointSetsContainerType & samplePointSets )
+{
+  this->m_MetricSamplePointSetsPerLevel = samplePointSets;
+  this->Modified();
+}
+
+/**
+ * Get the metric sample point sets per level
+ */
+template<typename TFixedImage, typename TMovingImage, typename TTransform>
+const typename ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>::MetricSamplePointSetsContainerType &
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>
+::GetMetricSamplePointSetsPerLevel() const
+{
+  return this->m_MetricSamplePointSetsPerLevel;
+}
+
+/**
+ * Set the fixed images per level
+ */
+template<typename TFixedImage, typename TMovingImage, typename TTransform>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>
+::SetFixedImagesPerLevel( const FixedImagesContainerType & smoothImages,
+                          const FixedImagesContainerType & virtualDomainImages )
+{
+  this->m_FixedSmoothImagesPerLevel = smoothImages;
+  this->m_VirtualDomainImagesPerLevel = virtualDomainImages;
+  this->Modified();
+}
+
+/**
+ * Get the smoothed fixed images per level
+ */
+template<typename TFixedImage, typename TMovingImage, typename TTransform>
+const typename ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>::FixedImagesContainerType &
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>
+::GetFixedSmoothImagesPerLevel() const
+{
+  return this->m_FixedSmoothImagesPerLevel;
+}
+
+/**
+ * Get the virtual domain images per level
+ */
+template<typename TFixedImage, typename TMovingImage, typename TTransform>
+const typename ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>::FixedImagesContainerType &
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>
+::GetVirtualDomainImagesPerLevel() const
+{
+  return this->m_VirtualDomainImagesPerLevel;
 }
 
 /*
@@ -432,6 +568,9 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>
 
   os << indent << "Shrink factors: " << this->m_ShrinkFactorsPerLevel << std::endl;
   os << indent << "Smoothing sigmas: " << this->m_SmoothingSigmasPerLevel << std::endl;
+  os << indent << "Fixed image pyramid: " << this->m_FixedImagePyramid.GetPointer() << std::endl;
+  os << indent << "Moving image pyramid: " << this->m_MovingImagePyramid.GetPointer() << std::endl;
+  os << indent << "Number of fixed images per level: " << this->m_FixedSmoothImagesPerLevel.size() << std::endl;
 
   os << indent << "Metric sampling strategy: " << this->m_MetricSamplingStrategy << std::endl;
 
@@ -441,6 +580,7 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform>
     os << this->m_MetricSamplingPercentagePerLevel[i] << " ";
     }
   os << std::endl;
+  os << indent << "Number of metric sample point sets: " << this->m_MetricSamplePointSetsPerLevel.size() << std::endl;
 }
 
 /*
@@ -21,6 +21,10 @@
 #include "itkImageRegistrationMethodv4.h"
 
 #include "itkDisplacementFieldTransform.h"
+#include "itkSyNImageRegistrationMethodComposeUpdateFieldThreader.h"
+#include "itkSyNImageRegistrationMethodInvertDisplacementFieldThreader.h"
+#include "itkTimeProbe.h"
+#include "itkVectorLinearInterpolateImageFunction.h"
 
 namespace itk
 {
@@ -62,6 +66,14 @@ class Array1DToData;
  * The method evolved since that time with crucial contributions from Gang Song and
  * Nick Tustison. Though similar in spirit, this implementation is not identical.
  *
+ * At each iteration the update fields are composed with the total fields in
+ * place, and the smoothed total fields are inverted in place starting from
+ * the current inverse fields, so that only the smoothing allocates new
+ * fields.  Both operations are multithreaded, and each pass of the
+ * fixed-point inversion composes the estimate with the field to invert and
+ * updates the estimate at the same time.  The time spent in each stage is
+ * accumulated over all levels and can be queried after the registration.
+ *
  * \todo Need to allow the fixed image to have a composite transform.
  *
  * \author Nick Tustison
@@ -110,6 +122,8 @@ public:
   typedef typename OutputTransformType::DisplacementFieldType         DisplacementFieldType;
   typedef typename DisplacementFieldType::Pointer                     DisplacementFieldPointer;
   typedef typename DisplacementFieldType::PixelType                   DisplacementVectorType;
+  typedef VectorLinearInterpolateImageFunction<DisplacementFieldType, RealType>
+                                                                      DisplacementFieldInterpolatorType;
 
   typedef typename Superclass::CompositeTransformType                 CompositeTransformType;
   typedef typename CompositeTransformType::TransformType              TransformBaseType;
@@ -162,6 +176,19 @@ public:
   itkSetMacro( GaussianSmoothingVarianceForTheTotalField, RealType );
   itkGetConstReferenceMacro( GaussianSmoothingVarianceForTheTotalField, RealType );
 
+  /**
+   * Get the time spent in each stage of the iterations, accumulated over all
+   * levels of the last registration: evaluating the metric (including the
+   * resampling of the images), smoothing and scaling the update fields,
+   * composing the update fields with the total fields, smoothing the total
+   * fields and inverting them.
+   */
+  itkGetConstReferenceMacro( MetricTime, TimeProbe );
+  itkGetConstReferenceMacro( UpdateFieldSmoothingTime, TimeProbe );
+  itkGetConstReferenceMacro( CompositionTime, TimeProbe );
+  itkGetConstReferenceMacro( TotalFieldSmoothingTime, TimeProbe );
+  itkGetConstReferenceMacro( InversionTime, TimeProbe );
+
 protected:
   SyNImageRegistrationMethod();
   virtual ~SyNImageRegistrationMethod();
@@ -183,6 +210,13 @@ protected:
   virtual DisplacementFieldPointer GaussianSmoothDisplacementField( const DisplacementFieldType *, const RealType );
   virtual DisplacementFieldPointer InvertDisplacementField( const DisplacementFieldType *, const DisplacementFieldType * = NULL );
 
+  /** Compose the update field with the total field, in place. */
+  virtual void ComposeUpdateField( const DisplacementFieldType * updateField, DisplacementFieldType * totalField );
+
+  /** Iteratively estimate the inverse of a displacement field in place, using
+   * the input content of \c inverseField as the initial estimate. */
+  virtual void EstimateInverseDisplacementField( const DisplacementFieldType * field, DisplacementFieldType * inverseField );
+
   RealType                                                        m_LearningRate;
 
   OutputTransformPointer                                          m_MovingToMiddleTransform;
@@ -195,6 +229,31 @@ protected:
   bool                                                            m_DownsampleImagesForMetricDerivatives;
   bool                                                            m_AverageMidPointGradients;
 
+  TimeProbe                                                       m_MetricTime;
+  TimeProbe                                                       m_UpdateFieldSmoothingTime;
+  TimeProbe                                                       m_CompositionTime;
+  TimeProbe                                                       m_TotalFieldSmoothingTime;
+  TimeProbe                                                       m_InversionTime;
+
+  friend class SyNImageRegistrationMethodComposeUpdateFieldThreader< Self >;
+  friend class SyNImageRegistrationMethodInvertDisplacementFieldThreader< Self >;
+  typedef SyNImageRegistrationMethodComposeUpdateFieldThreader< Self >       ComposeUpdateFieldThreaderType;
+  typedef SyNImageRegistrationMethodInvertDisplacementFieldThreader< Self >  InvertDisplacementFieldThreaderType;
+
+  typename ComposeUpdateFieldThreaderType::Pointer                m_ComposeUpdateFieldThreader;
+  typename InvertDisplacementFieldThreaderType::Pointer           m_InvertDisplacementFieldThreader;
+
+  // internal ivars necessary for the multithreaded composition and inversion
+
+  DisplacementFieldPointer                                        m_ThreaderField;
+  typename DisplacementFieldInterpolatorType::Pointer             m_ThreaderFieldInterpolator;
+  DisplacementFieldPointer                                        m_ThreaderResidualField;
+  RealType                                                        m_ThreaderEpsilon;
+  RealType                                                        m_ThreaderMaxErrorNorm;
+  RealType                                                        m_ThreaderMeanErrorNorm;
+  bool                                                            m_ThreaderApplyResidual;
+  bool                                                            m_ThreaderComputeResidual;
+
 private:
   SyNImageRegistrationMethod( const Self & );   //purposely not implemented
   void operator=( const Self & );               //purposely not implemented
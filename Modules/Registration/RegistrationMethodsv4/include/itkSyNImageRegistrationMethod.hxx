@@ -22,10 +22,8 @@
 
 #include "itkComposeDisplacementFieldsImageFilter.h"
 #include "itkGaussianOperator.h"
-#include "itkImportImageFilter.h"
-#include "itkInvertDisplacementFieldImageFilter.h"
+#include "itkImageDuplicator.h"
 #include "itkIterationReporter.h"
-#include "itkMultiplyImageFilter.h"
 #include "itkVectorNeighborhoodOperatorImageFilter.h"
 #include "itkWindowConvergenceMonitoringFunction.h"
 
@@ -40,6 +38,11 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
   m_LearningRate( 0.25 ),
   m_ConvergenceThreshold( 1.0e-6 ),
   m_ConvergenceWindowSize( 10 ),
+  m_ThreaderEpsilon( 0.0 ),
+  m_ThreaderMaxErrorNorm( 0.0 ),
+  m_ThreaderMeanErrorNorm( 0.0 ),
+  m_ThreaderApplyResidual( false ),
+  m_ThreaderComputeResidual( false ),
   m_GaussianSmoothingVarianceForTheUpdateField( 3.0 ),
   m_GaussianSmoothingVarianceForTheTotalField( 0.5 )
 {
@@ -51,6 +54,11 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
   this->m_AverageMidPointGradients = false;
   this->m_FixedToMiddleTransform = OutputTransformType::New();
   this->m_MovingToMiddleTransform = OutputTransformType::New();
+
+  this->m_ComposeUpdateFieldThreader = ComposeUpdateFieldThreaderType::New();
+  this->m_InvertDisplacementFieldThreader = InvertDisplacementFieldThreaderType::New();
+  this->m_ThreaderFieldInterpolator = DisplacementFieldInterpolatorType::New();
+  this->m_ThreaderResidualField = DisplacementFieldType::New();
 }
 
 template<typename TFixedImage, typename TMovingImage, typename TOutputTransform>
@@ -133,6 +141,20 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
   typename IdentityTransformType::Pointer identityTransform;
   identityTransform = IdentityTransformType::New();
 
+  // The identity field is allocated once per level.
+  typename DisplacementFieldTransformType::Pointer identityDisplacementFieldTransform;
+  if( this->m_DownsampleImagesForMetricDerivatives )
+    {
+    typename DisplacementFieldType::Pointer identityField = DisplacementFieldType::New();
+    identityField->CopyInformation( virtualDomainImage );
+    identityField->SetRegions( virtualDomainImage->GetRequestedRegion() );
+    identityField->Allocate();
+    identityField->FillBuffer( zeroVector );
+
+    identityDisplacementFieldTransform = DisplacementFieldTransformType::New();
+    identityDisplacementFieldTransform->SetDisplacementField( identityField );
+    }
+
   IterationReporter reporter( this, 0, 1 );
 
   while( this->m_CurrentIteration++ < this->m_NumberOfIterationsPerLevel[this->m_CurrentLevel] && !this->m_IsConverged )
@@ -158,7 +180,9 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
     DisplacementFieldPointer movingToMiddleSmoothUpdateField;
     if( this->m_DownsampleImagesForMetricDerivatives )
       {
-      typedef ResampleImageFilter<MovingImageType, MovingImageType> MovingResamplerType;
+      this->m_MetricTime.Start();
+
+      typedef ResampleImageFilter<MovingImageType, MovingImageType, RealType> MovingResamplerType;
       typename MovingResamplerType::Pointer movingResampler = MovingResamplerType::New();
       movingResampler->SetTransform( movingComposite );
       movingResampler->SetInput( this->m_MovingSmoothImage );
@@ -169,7 +193,7 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
       movingResampler->SetDefaultPixelValue( 0 );
       movingResampler->Update();
 
-      typedef ResampleImageFilter<FixedImageType, FixedImageType> FixedResamplerType;
+      typedef ResampleImageFilter<FixedImageType, FixedImageType, RealType> FixedResamplerType;
       typename FixedResamplerType::Pointer fixedResampler = FixedResamplerType::New();
       fixedResampler->SetTransform( fixedComposite );
       fixedResampler->SetInput( this->m_FixedSmoothImage );
@@ -180,14 +204,7 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
       fixedResampler->SetDefaultPixelValue( 0 );
       fixedResampler->Update();
 
-      typename DisplacementFieldType::Pointer identityField = DisplacementFieldType::New();
-      identityField->CopyInformation( virtualDomainImage );
-      identityField->SetRegions( virtualDomainImage->GetRequestedRegion() );
-      identityField->Allocate();
-      identityField->FillBuffer( zeroVector );
-
-      typename DisplacementFieldTransformType::Pointer identityDisplacementFieldTransform = DisplacementFieldTransformType::New();
-      identityDisplacementFieldTransform->SetDisplacementField( identityField );
+      this->m_MetricTime.Stop();
 
       fixedToMiddleSmoothUpdateField = this->ComputeUpdateField( fixedResampler->GetOutput(), identityTransform,
         movingResampler->GetOutput(), identityDisplacementFieldTransform, movingMetricValue );
@@ -213,31 +230,35 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
 
     // Add the update field to both displacement fields (from fixed/moving to middle image) and then smooth
 
-    typedef ComposeDisplacementFieldsImageFilter<DisplacementFieldType> ComposerType;
-
-    typename ComposerType::Pointer fixedComposer = ComposerType::New();
-    fixedComposer->SetDisplacementField( fixedToMiddleSmoothUpdateField );
-    fixedComposer->SetWarpingField( this->m_FixedToMiddleTransform->GetDisplacementField() );
-    fixedComposer->Update();
+    DisplacementFieldPointer fixedToMiddleTotalField = this->m_FixedToMiddleTransform->GetDisplacementField();
+    DisplacementFieldPointer movingToMiddleTotalField = this->m_MovingToMiddleTransform->GetDisplacementField();
 
-    DisplacementFieldPointer fixedToMiddleSmoothTotalFieldTmp = this->GaussianSmoothDisplacementField( fixedComposer->GetOutput(), this->m_GaussianSmoothingVarianceForTheTotalField );
+    this->m_CompositionTime.Start();
+    this->ComposeUpdateField( fixedToMiddleSmoothUpdateField, fixedToMiddleTotalField );
+    this->ComposeUpdateField( movingToMiddleSmoothUpdateField, movingToMiddleTotalField );
+    this->m_CompositionTime.Stop();
 
-    typename ComposerType::Pointer movingComposer = ComposerType::New();
-    movingComposer->SetDisplacementField( movingToMiddleSmoothUpdateField );
-    movingComposer->SetWarpingField( this->m_MovingToMiddleTransform->GetDisplacementField() );
-    movingComposer->Update();
+    this->m_TotalFieldSmoothingTime.Start();
+    DisplacementFieldPointer fixedToMiddleSmoothTotalField = this->GaussianSmoothDisplacementField( fixedToMiddleTotalField, this->m_GaussianSmoothingVarianceForTheTotalField );
+    DisplacementFieldPointer movingToMiddleSmoothTotalField = this->GaussianSmoothDisplacementField( movingToMiddleTotalField, this->m_GaussianSmoothingVarianceForTheTotalField );
+    this->m_TotalFieldSmoothingTime.Stop();
 
-    DisplacementFieldPointer movingToMiddleSmoothTotalFieldTmp = this->GaussianSmoothDisplacementField( movingComposer->GetOutput(), this->m_GaussianSmoothingVarianceForTheTotalField );
+    // Iteratively estimate the inverse fields, starting from the current inverse fields,
+    // and then refine the total fields by inverting the inverse fields.
 
-    // Iteratively estimate the inverse fields.
+    DisplacementFieldPointer fixedToMiddleSmoothTotalFieldInverse = this->m_FixedToMiddleTransform->GetInverseDisplacementField();
+    DisplacementFieldPointer movingToMiddleSmoothTotalFieldInverse = this->m_MovingToMiddleTransform->GetInverseDisplacementField();
 
-    DisplacementFieldPointer fixedToMiddleSmoothTotalFieldInverse = this->InvertDisplacementField( fixedToMiddleSmoothTotalFieldTmp, this->m_FixedToMiddleTransform->GetInverseDisplacementField() );
-    DisplacementFieldPointer fixedToMiddleSmoothTotalField = this->InvertDisplacementField( fixedToMiddleSmoothTotalFieldInverse, fixedToMiddleSmoothTotalFieldTmp );
+    this->m_InversionTime.Start();
+    this->EstimateInverseDisplacementField( fixedToMiddleSmoothTotalField, fixedToMiddleSmoothTotalFieldInverse );
+    this->EstimateInverseDisplacementField( fixedToMiddleSmoothTotalFieldInverse, fixedToMiddleSmoothTotalField );
 
-    DisplacementFieldPointer movingToMiddleSmoothTotalFieldInverse = this->InvertDisplacementField( movingToMiddleSmoothTotalFieldTmp, this->m_MovingToMiddleTransform->GetInverseDisplacementField() );
-    DisplacementFieldPointer movingToMiddleSmoothTotalField = this->InvertDisplacementField( movingToMiddleSmoothTotalFieldInverse, movingToMiddleSmoothTotalFieldTmp );
+    this->EstimateInverseDisplacementField( movingToMiddleSmoothTotalField, movingToMiddleSmoothTotalFieldInverse );
+    this->EstimateInverseDisplacementField( movingToMiddleSmoothTotalFieldInverse, movingToMiddleSmoothTotalField );
+    this->m_InversionTime.Stop();
 
-    // Assign the displacement fields and their inverses to the proper transforms.
+    // Assign the displacement fields and their inverses to the proper transforms.  Setting the
+    // displacement field releases the inverse field, which was updated in place, so it is reassigned.
     this->m_FixedToMiddleTransform->SetDisplacementField( fixedToMiddleSmoothTotalField );
     this->m_FixedToMiddleTransform->SetInverseDisplacementField( fixedToMiddleSmoothTotalFieldInverse );
 
@@ -266,6 +287,8 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
 
   // pre calculate the voxel distance to be used in properly scaling the gradient.
 
+  this->m_MetricTime.Start();
+
   this->m_Metric->SetFixedImage( fixedImage );
   this->m_Metric->SetFixedTransform( const_cast<TransformBaseType *>( fixedTransform ) );
   this->m_Metric->SetMovingImage( movingImage );
@@ -279,26 +302,17 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
   metricDerivative.Fill( NumericTraits<typename MetricDerivativeType::ValueType>::Zero );
   this->m_Metric->GetValueAndDerivative( value, metricDerivative );
 
+  this->m_MetricTime.Stop();
+
   // we rescale the update velocity field at each time point.
   // we first need to convert to a displacement field to look
   // at the max norm of the field.
 
-  const SizeValueType numberOfPixels = static_cast<SizeValueType>( metricDerivative.Size() / ImageDimension );
-  const bool importFilterWillReleaseMemory = false;
-
-  // Brad L. says I should feel bad about using a reinterpret_cast.  I do feel bad.
+  this->m_UpdateFieldSmoothingTime.Start();
 
-  DisplacementVectorType *metricDerivativeFieldPointer = reinterpret_cast<DisplacementVectorType *>( metricDerivative.data_block() );
-
-  typedef ImportImageFilter<DisplacementVectorType, ImageDimension> ImporterType;
-  typename ImporterType::Pointer importer = ImporterType::New();
-  importer->SetImportPointer( metricDerivativeFieldPointer, numberOfPixels, importFilterWillReleaseMemory );
-  importer->SetRegion( virtualDomainImage->GetBufferedRegion() );
-  importer->SetOrigin( virtualDomainImage->GetOrigin() );
-  importer->SetSpacing( virtualDomainImage->GetSpacing() );
-  importer->SetDirection( virtualDomainImage->GetDirection() );
-  importer->Update();
-  DisplacementFieldPointer updateField = this->GaussianSmoothDisplacementField( importer->GetOutput(), this->m_GaussianSmoothingVarianceForTheUpdateField );
+  DisplacementFieldPointer metricDerivativeField = OutputTransformType::template GetDerivativeAsField<DisplacementFieldType>( metricDerivative,
+    virtualDomainImage->GetBufferedRegion(), virtualDomainImage->GetOrigin(), virtualDomainImage->GetSpacing(), virtualDomainImage->GetDirection() );
+  DisplacementFieldPointer updateField = this->GaussianSmoothDisplacementField( metricDerivativeField, this->m_GaussianSmoothingVarianceForTheUpdateField );
 
   typename DisplacementFieldType::SpacingType spacing = updateField->GetSpacing();
   ImageRegionConstIterator<DisplacementFieldType> ItF( updateField, updateField->GetLargestPossibleRegion() );
@@ -321,20 +335,18 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
       }
     }
 
-  RealType scale = this->m_LearningRate / maxNorm;
-
-  typedef Image<RealType, ImageDimension> RealImageType;
+  // The smoothed field is not shared, so it is scaled in place.
+  const RealType scale = this->m_LearningRate / maxNorm;
 
-  typedef MultiplyImageFilter<DisplacementFieldType, RealImageType, DisplacementFieldType> MultiplierType;
-  typename MultiplierType::Pointer multiplier = MultiplierType::New();
-  multiplier->SetInput( updateField );
-  multiplier->SetConstant( scale );
+  ImageRegionIterator<DisplacementFieldType> ItS( updateField, updateField->GetLargestPossibleRegion() );
+  for( ItS.GoToBegin(); !ItS.IsAtEnd(); ++ItS )
+    {
+    ItS.Set( ItS.Get() * scale );
+    }
 
-  typename DisplacementFieldType::Pointer scaledUpdateField = multiplier->GetOutput();
-  scaledUpdateField->Update();
-  scaledUpdateField->DisconnectPipeline();
+  this->m_UpdateFieldSmoothingTime.Stop();
 
-  return scaledUpdateField;
+  return updateField;
 }
 
 template<typename TFixedImage, typename TMovingImage, typename TOutputTransform>
@@ -342,21 +354,103 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
 SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
 ::InvertDisplacementField( const DisplacementFieldType * field, const DisplacementFieldType * inverseFieldEstimate )
 {
-  typedef InvertDisplacementFieldImageFilter<DisplacementFieldType> InverterType;
+  DisplacementFieldPointer inverseField;
 
-  typename InverterType::Pointer inverter = InverterType::New();
-  inverter->SetInput( field );
-  inverter->SetInverseFieldInitialEstimate( inverseFieldEstimate );
-  inverter->SetMaximumNumberOfIterations( 20 );
-  inverter->SetMeanErrorToleranceThreshold( 0.001 );
-  inverter->SetMaxErrorToleranceThreshold( 0.1 );
-  inverter->Update();
+  if( inverseFieldEstimate )
+    {
+    typedef ImageDuplicator<DisplacementFieldType> DuplicatorType;
+    typename DuplicatorType::Pointer duplicator = DuplicatorType::New();
+    duplicator->SetInputImage( inverseFieldEstimate );
+    duplicator->Update();
 
-  DisplacementFieldPointer inverseField = inverter->GetOutput();
+    inverseField = duplicator->GetOutput();
+    }
+  else
+    {
+    inverseField = DisplacementFieldType::New();
+    inverseField->CopyInformation( field );
+    inverseField->SetRegions( field->GetBufferedRegion() );
+    inverseField->Allocate();
+    inverseField->FillBuffer( DisplacementVectorType( 0.0 ) );
+    }
+
+  this->EstimateInverseDisplacementField( field, inverseField );
 
   return inverseField;
 }
 
+template<typename TFixedImage, typename TMovingImage, typename TOutputTransform>
+void
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
+::ComposeUpdateField( const DisplacementFieldType * updateField, DisplacementFieldType * totalField )
+{
+  this->m_ThreaderField = totalField;
+  this->m_ThreaderFieldInterpolator->SetInputImage( updateField );
+
+  this->m_ComposeUpdateFieldThreader->SetMaximumNumberOfThreads( this->GetNumberOfThreads() );
+  this->m_ComposeUpdateFieldThreader->Execute( this, totalField->GetBufferedRegion() );
+
+  totalField->Modified();
+
+  this->m_ThreaderField = NULL;
+  this->m_ThreaderFieldInterpolator->SetInputImage( NULL );
+}
+
+template<typename TFixedImage, typename TMovingImage, typename TOutputTransform>
+void
+SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
+::EstimateInverseDisplacementField( const DisplacementFieldType * field, DisplacementFieldType * inverseField )
+{
+  // Stopping criteria of the fixed-point iteration, with errors measured in voxels.
+  const unsigned int maximumNumberOfIterations = 20;
+  const RealType meanErrorToleranceThreshold = 0.001;
+  const RealType maxErrorToleranceThreshold = 0.1;
+
+  this->m_ThreaderField = inverseField;
+  this->m_ThreaderFieldInterpolator->SetInputImage( field );
+
+  // The residual field is reused as long as the domain does not change.
+  if( this->m_ThreaderResidualField->GetBufferedRegion() != inverseField->GetBufferedRegion() )
+    {
+    this->m_ThreaderResidualField->SetRegions( inverseField->GetBufferedRegion() );
+    this->m_ThreaderResidualField->Allocate();
+    }
+
+  this->m_InvertDisplacementFieldThreader->SetMaximumNumberOfThreads( this->GetNumberOfThreads() );
+
+  // The first pass only computes the residual of the initial estimate.  Each
+  // following pass applies the residual of the previous pass and, unless the
+  // previous errors are within tolerance or this is the last iteration, computes
+  // the residual of the updated estimate in the same sweep.
+  this->m_ThreaderApplyResidual = false;
+  this->m_ThreaderComputeResidual = true;
+  this->m_InvertDisplacementFieldThreader->Execute( this, inverseField->GetBufferedRegion() );
+
+  this->m_ThreaderApplyResidual = true;
+  for( unsigned int iteration = 1; iteration <= maximumNumberOfIterations; iteration++ )
+    {
+    itkDebugMacro( "Inversion iteration " << iteration << ": mean error norm = " << this->m_ThreaderMeanErrorNorm
+      << ", max error norm = " << this->m_ThreaderMaxErrorNorm );
+
+    this->m_ThreaderEpsilon = ( iteration == 1 ) ? 0.75 : 0.5;
+    this->m_ThreaderComputeResidual = ( iteration < maximumNumberOfIterations &&
+      this->m_ThreaderMaxErrorNorm > maxErrorToleranceThreshold &&
+      this->m_ThreaderMeanErrorNorm > meanErrorToleranceThreshold );
+
+    this->m_InvertDisplacementFieldThreader->Execute( this, inverseField->GetBufferedRegion() );
+
+    if( !this->m_ThreaderComputeResidual )
+      {
+      break;
+      }
+    }
+
+  inverseField->Modified();
+
+  this->m_ThreaderField = NULL;
+  this->m_ThreaderFieldInterpolator->SetInputImage( NULL );
+}
+
 template<typename TFixedImage, typename TMovingImage, typename TOutputTransform>
 typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>::DisplacementFieldPointer
 SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
@@ -457,6 +551,12 @@ void
 SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
 ::GenerateData()
 {
+  this->m_MetricTime = TimeProbe();
+  this->m_UpdateFieldSmoothingTime = TimeProbe();
+  this->m_CompositionTime = TimeProbe();
+  this->m_TotalFieldSmoothingTime = TimeProbe();
+  this->m_InversionTime = TimeProbe();
+
   for( this->m_CurrentLevel = 0; this->m_CurrentLevel < this->m_NumberOfLevels; this->m_CurrentLevel++ )
     {
     this->InitializeRegistrationAtEachLevel( this->m_CurrentLevel );
@@ -508,6 +608,11 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform>
   os << indent << "Convergence window size: " << this->m_ConvergenceWindowSize << std::endl;
   os << indent << "Gaussian smoothing variance for the update field: " << this->m_GaussianSmoothingVarianceForTheUpdateField << std::endl;
   os << indent << "Gaussian smoothing variance for the total field: " << this->m_GaussianSmoothingVarianceForTheTotalField << std::endl;
+  os << indent << "Metric time: " << this->m_MetricTime.GetTotal() << std::endl;
+  os << indent << "Update field smoothing time: " << this->m_UpdateFieldSmoothingTime.GetTotal() << std::endl;
+  os << indent << "Composition time: " << this->m_CompositionTime.GetTotal() << std::endl;
+  os << indent << "Total field smoothing time: " << this->m_TotalFieldSmoothingTime.GetTotal() << std::endl;
+  os << indent << "Inversion time: " << this->m_InversionTime.GetTotal() << std::endl;
 }
 
 } // end namespace itk
@@ -0,0 +1,81 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkSyNImageRegistrationMethodComposeUpdateFieldThreader_h
+#define __itkSyNImageRegistrationMethodComposeUpdateFieldThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedImageRegionPartitioner.h"
+
+namespace itk
+{
+
+/** \class SyNImageRegistrationMethodComposeUpdateFieldThreader
+ * \brief Composes an update field with a total displacement field of
+ * SyNImageRegistrationMethod, in place.
+ *
+ * The domain is the buffered region of the total field, which is the
+ * associate's \c m_ThreaderField.  Each thread replaces the displacement
+ * \f$ u(x) \f$ of the total field with \f$ u(x) + v(x + u(x)) \f$, where
+ * the update field \f$ v \f$ is evaluated by the associate's
+ * \c m_ThreaderFieldInterpolator.  This is the composition computed by
+ * ComposeDisplacementFieldsImageFilter.  Since each pixel of the total
+ * field is only read at its own location, no output buffer is needed.
+ *
+ * \ingroup ITKRegistrationMethodsv4
+ */
+template< class TSyNImageRegistrationMethod >
+class SyNImageRegistrationMethodComposeUpdateFieldThreader
+  : public DomainThreader< ThreadedImageRegionPartitioner< TSyNImageRegistrationMethod::ImageDimension >, TSyNImageRegistrationMethod >
+{
+public:
+  /** Standard class typedefs. */
+  typedef SyNImageRegistrationMethodComposeUpdateFieldThreader                   Self;
+  typedef DomainThreader< ThreadedImageRegionPartitioner< TSyNImageRegistrationMethod::ImageDimension >,
+    TSyNImageRegistrationMethod >                                                Superclass;
+  typedef SmartPointer< Self >                                                   Pointer;
+  typedef SmartPointer< const Self >                                             ConstPointer;
+
+  itkTypeMacro( SyNImageRegistrationMethodComposeUpdateFieldThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+
+  typedef typename AssociateType::DisplacementFieldType  DisplacementFieldType;
+  typedef typename AssociateType::DisplacementVectorType DisplacementVectorType;
+
+protected:
+  SyNImageRegistrationMethodComposeUpdateFieldThreader() {}
+
+  /** Compose the update field with the total field over the subregion. */
+  virtual void ThreadedExecution( const DomainType & subRegion,
+                                  const ThreadIdType threadId );
+
+private:
+  SyNImageRegistrationMethodComposeUpdateFieldThreader( const Self & ); // purposely not implemented
+  void operator=( const Self & ); // purposely not implemented
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkSyNImageRegistrationMethodComposeUpdateFieldThreader.hxx"
+#endif
+
+#endif
@@ -0,0 +1,76 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkSyNImageRegistrationMethodComposeUpdateFieldThreader_hxx
+#define __itkSyNImageRegistrationMethodComposeUpdateFieldThreader_hxx
+
+#include "itkSyNImageRegistrationMethodComposeUpdateFieldThreader.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+namespace itk
+{
+
+template< class TSyNImageRegistrationMethod >
+void
+SyNImageRegistrationMethodComposeUpdateFieldThreader< TSyNImageRegistrationMethod >
+::ThreadedExecution( const DomainType & subRegion,
+                     const ThreadIdType itkNotUsed( threadId ) )
+{
+  AssociateType * associate = this->m_Associate;
+
+  DisplacementFieldType * totalField = associate->m_ThreaderField.GetPointer();
+  typename AssociateType::DisplacementFieldInterpolatorType * interpolator = associate->m_ThreaderFieldInterpolator.GetPointer();
+
+  typedef typename DisplacementFieldType::PointType PointType;
+
+  PointType pointIn1;
+  PointType pointIn2;
+  PointType pointIn3;
+
+  DisplacementVectorType outDisplacement;
+
+  ImageRegionIteratorWithIndex< DisplacementFieldType > ItF( totalField, subRegion );
+  for( ItF.GoToBegin(); !ItF.IsAtEnd(); ++ItF )
+    {
+    totalField->TransformIndexToPhysicalPoint( ItF.GetIndex(), pointIn1 );
+
+    const DisplacementVectorType warpVector = ItF.Get();
+    for( unsigned int d = 0; d < AssociateType::ImageDimension; d++ )
+      {
+      pointIn2[d] = pointIn1[d] + warpVector[d];
+      }
+
+    typename AssociateType::DisplacementFieldInterpolatorType::OutputType displacement( 0.0 );
+    if( interpolator->IsInsideBuffer( pointIn2 ) )
+      {
+      displacement = interpolator->Evaluate( pointIn2 );
+      }
+
+    for( unsigned int d = 0; d < AssociateType::ImageDimension; d++ )
+      {
+      pointIn3[d] = pointIn2[d] + displacement[d];
+      }
+
+    outDisplacement = pointIn3 - pointIn1;
+
+    ItF.Set( outDisplacement );
+    }
+}
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,99 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkSyNImageRegistrationMethodInvertDisplacementFieldThreader_h
+#define __itkSyNImageRegistrationMethodInvertDisplacementFieldThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedImageRegionPartitioner.h"
+
+namespace itk
+{
+
+/** \class SyNImageRegistrationMethodInvertDisplacementFieldThreader
+ * \brief Performs one pass of the fixed-point inversion of a displacement
+ * field for SyNImageRegistrationMethod.
+ *
+ * The domain is the buffered region of the inverse field estimate, which is
+ * the associate's \c m_ThreaderField and is updated in place.  The field to
+ * invert is evaluated by the associate's \c m_ThreaderFieldInterpolator.
+ *
+ * A pass fuses the two steps of consecutive iterations of
+ * InvertDisplacementFieldImageFilter at each pixel.  When
+ * \c m_ThreaderApplyResidual is set, the residual stored in
+ * \c m_ThreaderResidualField by the previous pass is added to the inverse
+ * estimate, scaled by \c m_ThreaderEpsilon and clamped by the previous max
+ * error norm.  When \c m_ThreaderComputeResidual is set, the composition of
+ * the updated estimate with the field to invert is negated and stored as the
+ * next residual, and the mean and max of its norms, in voxels, are reduced
+ * into \c m_ThreaderMeanErrorNorm and \c m_ThreaderMaxErrorNorm.  As the
+ * estimate is only read at its own location, neither a composed field nor a
+ * norm image is needed.
+ *
+ * \ingroup ITKRegistrationMethodsv4
+ */
+template< class TSyNImageRegistrationMethod >
+class SyNImageRegistrationMethodInvertDisplacementFieldThreader
+  : public DomainThreader< ThreadedImageRegionPartitioner< TSyNImageRegistrationMethod::ImageDimension >, TSyNImageRegistrationMethod >
+{
+public:
+  /** Standard class typedefs. */
+  typedef SyNImageRegistrationMethodInvertDisplacementFieldThreader              Self;
+  typedef DomainThreader< ThreadedImageRegionPartitioner< TSyNImageRegistrationMethod::ImageDimension >,
+    TSyNImageRegistrationMethod >                                                Superclass;
+  typedef SmartPointer< Self >                                                   Pointer;
+  typedef SmartPointer< const Self >                                             ConstPointer;
+
+  itkTypeMacro( SyNImageRegistrationMethodInvertDisplacementFieldThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+
+  typedef typename AssociateType::DisplacementFieldType  DisplacementFieldType;
+  typedef typename AssociateType::DisplacementVectorType DisplacementVectorType;
+  typedef typename DisplacementVectorType::ComponentType RealType;
+
+protected:
+  SyNImageRegistrationMethodInvertDisplacementFieldThreader() {}
+
+  /** Allocate the per-thread error norms. */
+  virtual void BeforeThreadedExecution();
+
+  /** Update the inverse estimate and compute the residual over the subregion. */
+  virtual void ThreadedExecution( const DomainType & subRegion,
+                                  const ThreadIdType threadId );
+
+  /** Reduce the per-thread error norms. */
+  virtual void AfterThreadedExecution();
+
+private:
+  SyNImageRegistrationMethodInvertDisplacementFieldThreader( const Self & ); // purposely not implemented
+  void operator=( const Self & ); // purposely not implemented
+
+  std::vector< RealType > m_ErrorNormSumPerThread;
+  std::vector< RealType > m_MaxErrorNormPerThread;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkSyNImageRegistrationMethodInvertDisplacementFieldThreader.hxx"
+#endif
+
+#endif
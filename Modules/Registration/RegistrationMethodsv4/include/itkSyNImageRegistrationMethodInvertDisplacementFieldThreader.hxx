@@ -0,0 +1,176 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkSyNImageRegistrationMethodInvertDisplacementFieldThreader_hxx
+#define __itkSyNImageRegistrationMethodInvertDisplacementFieldThreader_hxx
+
+#include "itkSyNImageRegistrationMethodInvertDisplacementFieldThreader.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+namespace itk
+{
+
+template< class TSyNImageRegistrationMethod >
+void
+SyNImageRegistrationMethodInvertDisplacementFieldThreader< TSyNImageRegistrationMethod >
+::BeforeThreadedExecution()
+{
+  this->m_ErrorNormSumPerThread.assign( this->GetNumberOfThreadsUsed(), NumericTraits<RealType>::Zero );
+  this->m_MaxErrorNormPerThread.assign( this->GetNumberOfThreadsUsed(), NumericTraits<RealType>::Zero );
+}
+
+template< class TSyNImageRegistrationMethod >
+void
+SyNImageRegistrationMethodInvertDisplacementFieldThreader< TSyNImageRegistrationMethod >
+::ThreadedExecution( const DomainType & subRegion,
+                     const ThreadIdType threadId )
+{
+  AssociateType * associate = this->m_Associate;
+
+  DisplacementFieldType * inverseField = associate->m_ThreaderField.GetPointer();
+  DisplacementFieldType * residualField = associate->m_ThreaderResidualField.GetPointer();
+  typename AssociateType::DisplacementFieldInterpolatorType * interpolator = associate->m_ThreaderFieldInterpolator.GetPointer();
+
+  const bool applyResidual = associate->m_ThreaderApplyResidual;
+  const bool computeResidual = associate->m_ThreaderComputeResidual;
+  const RealType epsilon = associate->m_ThreaderEpsilon;
+  const RealType maxErrorNorm = associate->m_ThreaderMaxErrorNorm;
+
+  const typename DisplacementFieldType::SpacingType spacing = inverseField->GetSpacing();
+  const typename DisplacementFieldType::RegionType fullRegion = inverseField->GetBufferedRegion();
+  const typename DisplacementFieldType::SizeType size = fullRegion.GetSize();
+  const typename DisplacementFieldType::IndexType startIndex = fullRegion.GetIndex();
+  const DisplacementVectorType zeroVector( 0.0 );
+
+  typedef typename DisplacementFieldType::PointType PointType;
+
+  PointType pointIn1;
+  PointType pointIn2;
+  PointType pointIn3;
+
+  DisplacementVectorType composedDisplacement;
+
+  RealType errorNormSum = NumericTraits<RealType>::Zero;
+  RealType maxErrorNormInSubRegion = NumericTraits<RealType>::Zero;
+
+  ImageRegionIteratorWithIndex< DisplacementFieldType > ItI( inverseField, subRegion );
+  ImageRegionIterator< DisplacementFieldType > ItE( residualField, subRegion );
+  for( ItI.GoToBegin(), ItE.GoToBegin(); !ItI.IsAtEnd(); ++ItI, ++ItE )
+    {
+    const typename DisplacementFieldType::IndexType index = ItI.GetIndex();
+
+    if( applyResidual )
+      {
+      DisplacementVectorType update = ItE.Get();
+      RealType scaledNorm = 0.0;
+      for( unsigned int d = 0; d < AssociateType::ImageDimension; d++ )
+        {
+        scaledNorm += vnl_math_sqr( update[d] / spacing[d] );
+        }
+      scaledNorm = vcl_sqrt( scaledNorm );
+
+      if( scaledNorm > epsilon * maxErrorNorm )
+        {
+        update *= ( epsilon * maxErrorNorm / scaledNorm );
+        }
+      update = ItI.Get() + update * epsilon;
+
+      for( unsigned int d = 0; d < AssociateType::ImageDimension; d++ )
+        {
+        if( index[d] == startIndex[d] || index[d] == static_cast<IndexValueType>( size[d] ) - startIndex[d] - 1 )
+          {
+          update = zeroVector;
+          break;
+          }
+        }
+      ItI.Set( update );
+      }
+
+    if( computeResidual )
+      {
+      inverseField->TransformIndexToPhysicalPoint( index, pointIn1 );
+
+      const DisplacementVectorType warpVector = ItI.Get();
+      for( unsigned int d = 0; d < AssociateType::ImageDimension; d++ )
+        {
+        pointIn2[d] = pointIn1[d] + warpVector[d];
+        }
+
+      typename AssociateType::DisplacementFieldInterpolatorType::OutputType displacement( 0.0 );
+      if( interpolator->IsInsideBuffer( pointIn2 ) )
+        {
+        displacement = interpolator->Evaluate( pointIn2 );
+        }
+
+      for( unsigned int d = 0; d < AssociateType::ImageDimension; d++ )
+        {
+        pointIn3[d] = pointIn2[d] + displacement[d];
+        }
+      composedDisplacement = pointIn3 - pointIn1;
+
+      RealType scaledNorm = 0.0;
+      for( unsigned int d = 0; d < AssociateType::ImageDimension; d++ )
+        {
+        scaledNorm += vnl_math_sqr( composedDisplacement[d] / spacing[d] );
+        }
+      scaledNorm = vcl_sqrt( scaledNorm );
+
+      errorNormSum += scaledNorm;
+      if( maxErrorNormInSubRegion < scaledNorm )
+        {
+        maxErrorNormInSubRegion = scaledNorm;
+        }
+
+      ItE.Set( -composedDisplacement );
+      }
+    }
+
+  this->m_ErrorNormSumPerThread[threadId] = errorNormSum;
+  this->m_MaxErrorNormPerThread[threadId] = maxErrorNormInSubRegion;
+}
+
+template< class TSyNImageRegistrationMethod >
+void
+SyNImageRegistrationMethodInvertDisplacementFieldThreader< TSyNImageRegistrationMethod >
+::AfterThreadedExecution()
+{
+  AssociateType * associate = this->m_Associate;
+
+  if( !associate->m_ThreaderComputeResidual )
+    {
+    return;
+    }
+
+  RealType errorNormSum = NumericTraits<RealType>::Zero;
+  RealType maxErrorNorm = NumericTraits<RealType>::Zero;
+  for( ThreadIdType i = 0; i < this->GetNumberOfThreadsUsed(); i++ )
+    {
+    errorNormSum += this->m_ErrorNormSumPerThread[i];
+    if( maxErrorNorm < this->m_MaxErrorNormPerThread[i] )
+      {
+      maxErrorNorm = this->m_MaxErrorNormPerThread[i];
+      }
+    }
+
+  associate->m_ThreaderMeanErrorNorm = errorNormSum /
+    static_cast<RealType>( associate->m_ThreaderField->GetBufferedRegion().GetNumberOfPixels() );
+  associate->m_ThreaderMaxErrorNorm = maxErrorNorm;
+}
+
+} // end namespace itk
+
+#endif
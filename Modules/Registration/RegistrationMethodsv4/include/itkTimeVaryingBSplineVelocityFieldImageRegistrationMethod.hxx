@@ -21,9 +21,10 @@
 #include "itkTimeVaryingBSplineVelocityFieldImageRegistrationMethod.h"
 
 #include "itkBSplineScatteredDataPointSetToImageFilter.h"
+#include "itkConstNeighborhoodIterator.h"
 #include "itkDisplacementFieldTransform.h"
 #include "itkImageDuplicator.h"
-#include "itkImportImageFilter.h"
+#include "itkNeighborhoodAlgorithm.h"
 #include "itkPointSet.h"
 #include "itkResampleImageFilter.h"
 #include "itkStatisticsImageFilter.h"
@@ -221,7 +222,7 @@ TimeVaryingBSplineVelocityFieldImageRegistrationMethod<TFixedImage, TMovingImage
         identityDisplacementFieldTransform->SetDisplacementField( fieldDuplicatorIdentity->GetOutput() );
         }
 
-      typedef itk::ResampleImageFilter<MovingImageType, VirtualImageType> MovingImageResampleFilterType;
+      typedef itk::ResampleImageFilter<MovingImageType, VirtualImageType, RealType> MovingImageResampleFilterType;
       typename MovingImageResampleFilterType::Pointer movingImageResampler = MovingImageResampleFilterType::New();
       movingImageResampler->SetTransform( this->m_CompositeTransform );
       movingImageResampler->SetInput( this->m_MovingSmoothImage );
@@ -232,7 +233,7 @@ TimeVaryingBSplineVelocityFieldImageRegistrationMethod<TFixedImage, TMovingImage
       movingImageResampler->SetDefaultPixelValue( 0 );
       movingImageResampler->Update();
 
-      typedef itk::ResampleImageFilter<FixedImageType, VirtualImageType> FixedImageResampleFilterType;
+      typedef itk::ResampleImageFilter<FixedImageType, VirtualImageType, RealType> FixedImageResampleFilterType;
       typename FixedImageResampleFilterType::Pointer fixedImageResampler = FixedImageResampleFilterType::New();
       fixedImageResampler->SetTransform( fixedDisplacementFieldTransform );
       fixedImageResampler->SetInput( this->m_FixedSmoothImage );
@@ -265,28 +266,17 @@ TimeVaryingBSplineVelocityFieldImageRegistrationMethod<TFixedImage, TMovingImage
       // we first need to convert to a displacement field to look
       // at the max norm of the field.
 
-      const SizeValueType numberOfPixels = static_cast<SizeValueType>( metricDerivative.Size() / ImageDimension );
-      const bool importFilterWillReleaseMemory = false;
-
-      DisplacementVectorType *metricDerivativeFieldPointer = reinterpret_cast<DisplacementVectorType *>( metricDerivative.data_block() );
-
       typename VirtualImageType::DirectionType identity;
       identity.SetIdentity();
 
-      typedef ImportImageFilter<DisplacementVectorType, ImageDimension> DisplacementFieldImporterType;
-      typename DisplacementFieldImporterType::Pointer displacementFieldImporter = DisplacementFieldImporterType::New();
-      displacementFieldImporter->SetImportPointer( metricDerivativeFieldPointer, numberOfPixels, importFilterWillReleaseMemory );
-      displacementFieldImporter->SetRegion( virtualDomainImage->GetBufferedRegion() );
-      displacementFieldImporter->SetOrigin( virtualDomainImage->GetOrigin() );
-      displacementFieldImporter->SetSpacing( virtualDomainImage->GetSpacing() );
-      displacementFieldImporter->SetDirection( identity );
-      displacementFieldImporter->Update();
+      typename DisplacementFieldType::Pointer metricDerivativeField = OutputTransformType::template GetDerivativeAsField<DisplacementFieldType>( metricDerivative,
+        virtualDomainImage->GetBufferedRegion(), virtualDomainImage->GetOrigin(), virtualDomainImage->GetSpacing(), identity );
 
       typedef Image<RealType, ImageDimension> MagnitudeImageType;
 
       typedef VectorMagnitudeImageFilter<DisplacementFieldType, MagnitudeImageType> MagnituderType;
       typename MagnituderType::Pointer magnituder = MagnituderType::New();
-      magnituder->SetInput( displacementFieldImporter->GetOutput() );
+      magnituder->SetInput( metricDerivativeField );
       magnituder->Update();
 
       typedef StatisticsImageFilter<MagnitudeImageType> StatisticsImageFilterType;
@@ -307,30 +297,18 @@ TimeVaryingBSplineVelocityFieldImageRegistrationMethod<TFixedImage, TMovingImage
 
     // Here we need to convert the metric derivative to the control point derivative.
 
-    const bool importFilterWillReleaseMemory = false;
-
-    DisplacementVectorType *metricDerivativeFieldPointer = reinterpret_cast<DisplacementVectorType *>( updateDerivative.data_block() );
-
-    const SizeValueType numberOfVelocityFieldPixels = static_cast<SizeValueType>( updateDerivative.Size() / ImageDimension );
-
     typename TimeVaryingVelocityFieldType::DirectionType identity;
     identity.SetIdentity();
 
-    typedef ImportImageFilter<DisplacementVectorType, ImageDimension + 1> VelocityFieldImporterType;
-    typename VelocityFieldImporterType::Pointer velocityFieldImporter = VelocityFieldImporterType::New();
-    velocityFieldImporter->SetImportPointer( metricDerivativeFieldPointer, numberOfVelocityFieldPixels, importFilterWillReleaseMemory );
-    velocityFieldImporter->SetRegion( sampledVelocityFieldSize );
-    velocityFieldImporter->SetOrigin( sampledVelocityFieldOrigin );
-    velocityFieldImporter->SetSpacing( sampledVelocityFieldSpacing );
-    velocityFieldImporter->SetDirection( identity );
-    velocityFieldImporter->Update();
+    TimeVaryingVelocityFieldPointer updateDerivativeField = OutputTransformType::template GetDerivativeAsField<TimeVaryingVelocityFieldType>( updateDerivative,
+      sampledVelocityFieldSize, sampledVelocityFieldOrigin, sampledVelocityFieldSpacing, identity );
 
     itkDebugMacro( "Extracting points from field. " )
 
     const typename VirtualImageType::IndexType virtualDomainIndex = virtualDomainImage->GetLargestPossibleRegion().GetIndex();
     const typename VirtualImageType::SizeType virtualDomainSize = virtualDomainImage->GetLargestPossibleRegion().GetSize();
 
-    ImageRegionConstIteratorWithIndex<TimeVaryingVelocityFieldType> It( velocityFieldImporter->GetOutput(), velocityFieldImporter->GetOutput()->GetBufferedRegion() );
+    ImageRegionConstIteratorWithIndex<TimeVaryingVelocityFieldType> It( updateDerivativeField, updateDerivativeField->GetBufferedRegion() );
     for( It.GoToBegin(); !It.IsAtEnd(); ++It )
       {
       typename TimeVaryingVelocityFieldType::IndexType index = It.GetIndex();
@@ -355,7 +333,7 @@ TimeVaryingBSplineVelocityFieldImageRegistrationMethod<TFixedImage, TMovingImage
         }
 
       typename TimeVaryingVelocityFieldType::PointType point;
-      velocityFieldImporter->GetOutput()->TransformIndexToPhysicalPoint( index, point );
+      updateDerivativeField->TransformIndexToPhysicalPoint( index, point );
 
       typename PointSetType::PointType spatioTemporalPoint;
       for( unsigned int d = 0; d < ImageDimension + 1; d++ )
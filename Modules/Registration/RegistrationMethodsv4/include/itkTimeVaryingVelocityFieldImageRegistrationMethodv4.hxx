@@ -24,7 +24,6 @@
 #include "itkConstNeighborhoodIterator.h"
 #include "itkDisplacementFieldTransform.h"
 #include "itkImageDuplicator.h"
-#include "itkImportImageFilter.h"
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkResampleImageFilter.h"
 #include "itkStatisticsImageFilter.h"
@@ -176,7 +175,7 @@ TimeVaryingVelocityFieldImageRegistrationMethodv4<TFixedImage, TMovingImage, TOu
         identityDisplacementFieldTransform->SetDisplacementField( fieldDuplicatorIdentity->GetOutput() );
         }
 
-      typedef itk::ResampleImageFilter<MovingImageType, VirtualImageType> MovingImageResampleFilterType;
+      typedef itk::ResampleImageFilter<MovingImageType, VirtualImageType, RealType> MovingImageResampleFilterType;
       typename MovingImageResampleFilterType::Pointer movingImageResampler = MovingImageResampleFilterType::New();
       movingImageResampler->SetTransform( this->m_CompositeTransform );
       movingImageResampler->SetInput( this->m_MovingSmoothImage );
@@ -187,7 +186,7 @@ TimeVaryingVelocityFieldImageRegistrationMethodv4<TFixedImage, TMovingImage, TOu
       movingImageResampler->SetDefaultPixelValue( 0 );
       movingImageResampler->Update();
 
-      typedef itk::ResampleImageFilter<FixedImageType, VirtualImageType> FixedImageResampleFilterType;
+      typedef itk::ResampleImageFilter<FixedImageType, VirtualImageType, RealType> FixedImageResampleFilterType;
       typename FixedImageResampleFilterType::Pointer fixedImageResampler = FixedImageResampleFilterType::New();
       fixedImageResampler->SetTransform( fixedDisplacementFieldTransform );
       fixedImageResampler->SetInput( this->m_FixedSmoothImage );
@@ -220,23 +219,14 @@ TimeVaryingVelocityFieldImageRegistrationMethodv4<TFixedImage, TMovingImage, TOu
       // we first need to convert to a displacement field to look
       // at the max norm of the field.
 
-      const bool importFilterWillReleaseMemory = false;
-      DisplacementVectorType *metricDerivativeFieldPointer = reinterpret_cast<DisplacementVectorType *>( metricDerivative.data_block() );
-
-      typedef ImportImageFilter<DisplacementVectorType, ImageDimension> ImporterType;
-      typename ImporterType::Pointer importer = ImporterType::New();
-      importer->SetImportPointer( metricDerivativeFieldPointer, numberOfPixelsPerTimePoint, importFilterWillReleaseMemory );
-      importer->SetRegion( virtualDomainImage->GetBufferedRegion() );
-      importer->SetOrigin( virtualDomainImage->GetOrigin() );
-      importer->SetSpacing( virtualDomainImage->GetSpacing() );
-      importer->SetDirection( virtualDomainImage->GetDirection() );
-      importer->Update();
+      DisplacementFieldPointer metricDerivativeField = OutputTransformType::template GetDerivativeAsField<DisplacementFieldType>( metricDerivative,
+        virtualDomainImage->GetBufferedRegion(), virtualDomainImage->GetOrigin(), virtualDomainImage->GetSpacing(), virtualDomainImage->GetDirection() );
 
       typedef Image<RealType, ImageDimension> MagnitudeImageType;
 
       typedef VectorMagnitudeImageFilter<DisplacementFieldType, MagnitudeImageType> MagnituderType;
       typename MagnituderType::Pointer magnituder = MagnituderType::New();
-      magnituder->SetInput( importer->GetOutput() );
+      magnituder->SetInput( metricDerivativeField );
       magnituder->Update();
 
       typedef StatisticsImageFilter<MagnitudeImageType> StatisticsImageFilterType;
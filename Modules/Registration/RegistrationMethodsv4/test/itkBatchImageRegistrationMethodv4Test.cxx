@@ -0,0 +1,291 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBatchImageRegistrationMethodv4.h"
+#include "itkImageRegistrationMethodv4.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkGradientDescentOptimizerv4.h"
+#include "itkImageRegionIterator.h"
+#include "itkResampleImageFilter.h"
+#include "itkSmoothingRecursiveGaussianImageFilter.h"
+#include "itkTranslationTransform.h"
+
+/*
+ * Register several translated copies of a fixed image to it, once as a batch
+ * run two registrations at a time and once one after the other, and check
+ * that both give the same translations and that the batch shares the
+ * gradients of the fixed image.
+ */
+
+namespace
+{
+const unsigned int ImageDimension = 2;
+
+typedef itk::Image<float, ImageDimension>                                           ImageType;
+typedef itk::TranslationTransform<double, ImageDimension>                           TransformType;
+typedef itk::ImageRegistrationMethodv4<ImageType, ImageType, TransformType>         RegistrationType;
+typedef itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>                  MetricType;
+typedef itk::GradientDescentOptimizerv4                                             OptimizerType;
+typedef itk::BatchImageRegistrationMethodv4<RegistrationType>                       BatchRegistrationType;
+
+// A smoothed square, whose gradients the fixed image levels share.
+ImageType::Pointer
+CreateFixedImage()
+{
+  ImageType::SizeType size;
+  size.Fill( 48 );
+
+  ImageType::Pointer square = ImageType::New();
+  square->SetRegions( size );
+  square->Allocate();
+  square->FillBuffer( 0.0 );
+
+  ImageType::IndexType squareIndex;
+  squareIndex.Fill( 16 );
+  ImageType::SizeType squareSize;
+  squareSize.Fill( 16 );
+  ImageType::RegionType squareRegion( squareIndex, squareSize );
+  itk::ImageRegionIterator<ImageType> It( square, squareRegion );
+  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+    {
+    It.Set( 100.0 );
+    }
+
+  typedef itk::SmoothingRecursiveGaussianImageFilter<ImageType, ImageType> SmoothingFilterType;
+  SmoothingFilterType::Pointer smoothing = SmoothingFilterType::New();
+  smoothing->SetInput( square );
+  smoothing->SetSigma( 4.0 );
+  smoothing->Update();
+
+  return smoothing->GetOutput();
+}
+
+// The fixed image translated by an offset, which the registration recovers.
+ImageType::Pointer
+CreateMovingImage( ImageType * fixedImage, const double offset[ImageDimension] )
+{
+  TransformType::Pointer translation = TransformType::New();
+  TransformType::OutputVectorType inverseOffset;
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    inverseOffset[d] = -offset[d];
+    }
+  translation->Translate( inverseOffset );
+
+  typedef itk::ResampleImageFilter<ImageType, ImageType> ResampleFilterType;
+  ResampleFilterType::Pointer resample = ResampleFilterType::New();
+  resample->SetInput( fixedImage );
+  resample->SetTransform( translation );
+  resample->SetOutputParametersFromImage( fixedImage );
+  resample->SetDefaultPixelValue( 0.0 );
+  resample->Update();
+
+  return resample->GetOutput();
+}
+
+RegistrationType::Pointer
+CreateRegistration( ImageType * fixedImage, ImageType * movingImage )
+{
+  RegistrationType::ShrinkFactorsArrayType shrinkFactorsPerLevel;
+  shrinkFactorsPerLevel.SetSize( 2 );
+  shrinkFactorsPerLevel[0] = 2;
+  shrinkFactorsPerLevel[1] = 1;
+
+  RegistrationType::SmoothingSigmasArrayType smoothingSigmasPerLevel;
+  smoothingSigmasPerLevel.SetSize( 2 );
+  smoothingSigmasPerLevel[0] = 1;
+  smoothingSigmasPerLevel[1] = 0;
+
+  RegistrationType::MetricSamplingPercentageArrayType samplingPercentagePerLevel;
+  samplingPercentagePerLevel.SetSize( 2 );
+  samplingPercentagePerLevel.Fill( 0.5 );
+
+  MetricType::Pointer metric = MetricType::New();
+  metric->SetMaximumNumberOfThreads( 1 );
+
+  OptimizerType::Pointer optimizer = OptimizerType::New();
+  optimizer->SetLearningRate( 0.01 );
+  optimizer->SetNumberOfIterations( 100 );
+  optimizer->SetMinimumConvergenceValue( 1.0e-6 );
+  optimizer->SetConvergenceWindowSize( 10 );
+  optimizer->SetDoEstimateLearningRateOnce( false );
+  optimizer->SetNumberOfThreads( 1 );
+
+  RegistrationType::Pointer registration = RegistrationType::New();
+  registration->SetFixedImage( fixedImage );
+  registration->SetMovingImage( movingImage );
+  registration->SetNumberOfLevels( 2 );
+  registration->SetShrinkFactorsPerLevel( shrinkFactorsPerLevel );
+  registration->SetSmoothingSigmasPerLevel( smoothingSigmasPerLevel );
+  registration->SetMetricSamplingStrategy( RegistrationType::REGULAR );
+  registration->SetMetricSamplingPercentagePerLevel( samplingPercentagePerLevel );
+  registration->SetMetric( metric );
+  registration->SetOptimizer( optimizer );
+  registration->SetNumberOfThreads( 1 );
+
+  return registration;
+}
+}
+
+int itkBatchImageRegistrationMethodv4Test( int, char * [] )
+{
+  const unsigned int numberOfRegistrations = 4;
+  const double offsets[numberOfRegistrations][ImageDimension] =
+    { { 2.0, -1.0 }, { -1.5, 2.0 }, { 0.5, 1.5 }, { -2.0, -2.0 } };
+
+  ImageType::Pointer fixedImage = CreateFixedImage();
+
+  std::vector<ImageType::Pointer> movingImages;
+  for( unsigned int n = 0; n < numberOfRegistrations; n++ )
+    {
+    movingImages.push_back( CreateMovingImage( fixedImage, offsets[n] ) );
+    }
+
+  BatchRegistrationType::Pointer batch = BatchRegistrationType::New();
+  batch->SetFixedImage( fixedImage );
+  batch->SetNumberOfConcurrentRegistrations( 2 );
+  batch->SetNumberOfThreadsPerRegistration( 1 );
+  for( unsigned int n = 0; n < numberOfRegistrations; n++ )
+    {
+    if( batch->AddRegistration( CreateRegistration( fixedImage, movingImages[n] ) ) != n )
+      {
+      std::cerr << "Unexpected index of registration " << n << "." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  try
+    {
+    batch->StartRegistration();
+    }
+  catch( itk::ExceptionObject & e )
+    {
+    std::cerr << "Exception caught: " << e << std::endl;
+    return EXIT_FAILURE;
+    }
+  batch->Print( std::cout );
+
+  for( unsigned int n = 0; n < numberOfRegistrations; n++ )
+    {
+    const BatchRegistrationType::RegistrationStatisticsType & statistics = batch->GetRegistrationStatistics( n );
+    if( !statistics.Succeeded )
+      {
+      std::cerr << "Registration " << n << " failed: " << statistics.ErrorDescription << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    RegistrationType::Pointer sequentialRegistration = CreateRegistration( fixedImage, movingImages[n] );
+    try
+      {
+      sequentialRegistration->StartRegistration();
+      }
+    catch( itk::ExceptionObject & e )
+      {
+      std::cerr << "Exception caught: " << e << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    const TransformType::ParametersType batchParameters = batch->GetOutputTransform( n )->GetParameters();
+    const TransformType::ParametersType sequentialParameters = sequentialRegistration->GetOutput()->Get()->GetParameters();
+
+    std::cout << "Registration " << n << ": translation " << batchParameters
+              << ", metric " << statistics.MetricValue
+              << ", convergence " << statistics.ConvergenceValue
+              << ", converged " << statistics.IsConverged
+              << ", iteration " << statistics.CurrentIteration
+              << ", time " << statistics.ElapsedTime << std::endl;
+
+    for( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      if( vnl_math_abs( batchParameters[d] - sequentialParameters[d] ) > 1.0e-6 )
+        {
+        std::cerr << "The batch and sequential translations of registration " << n << " differ: "
+                  << batchParameters << " != " << sequentialParameters << std::endl;
+        return EXIT_FAILURE;
+        }
+      if( vnl_math_abs( batchParameters[d] - offsets[n][d] ) > 0.25 )
+        {
+        std::cerr << "Registration " << n << " did not recover the translation: "
+                  << batchParameters << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    if( statistics.MetricValue != sequentialRegistration->GetCurrentMetricValue()
+      || statistics.CurrentIteration != sequentialRegistration->GetCurrentIteration() )
+      {
+      std::cerr << "The batch and sequential statistics of registration " << n << " differ." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // The gradients of the smoothed fixed image are computed once per level
+  if( batch->GetGradientImageCache()->GetNumberOfHits() == 0 )
+    {
+    std::cerr << "The gradients of the fixed image were not shared." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Gradient image cache: " << batch->GetGradientImageCache()->GetNumberOfHits() << " hits, "
+            << batch->GetGradientImageCache()->GetNumberOfMisses() << " misses" << std::endl;
+  std::cout << "Preparation time: " << batch->GetPreparationTime()
+            << ", elapsed time: " << batch->GetElapsedTime() << std::endl;
+
+  // Registrations with different schedules cannot share the fixed state
+  RegistrationType::Pointer mismatchedRegistration = CreateRegistration( fixedImage, movingImages[0] );
+  mismatchedRegistration->SetNumberOfLevels( 1 );
+  batch->AddRegistration( mismatchedRegistration );
+
+  bool caught = false;
+  try
+    {
+    batch->StartRegistration();
+    }
+  catch( itk::ExceptionObject & e )
+    {
+    std::cout << "Expected exception caught: " << e.GetDescription() << std::endl;
+    caught = true;
+    }
+  if( !caught )
+    {
+    std::cerr << "Registrations with different schedules were accepted." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A gradient filter of the metric would update the shared level images
+  batch->ClearRegistrations();
+  RegistrationType::Pointer filteredRegistration = CreateRegistration( fixedImage, movingImages[0] );
+  filteredRegistration->GetMetric()->SetFixedImageGradientFilter( MetricType::DefaultFixedImageGradientFilter::New() );
+  batch->AddRegistration( filteredRegistration );
+
+  caught = false;
+  try
+    {
+    batch->StartRegistration();
+    }
+  catch( itk::ExceptionObject & e )
+    {
+    std::cout << "Expected exception caught: " << e.GetDescription() << std::endl;
+    caught = true;
+    }
+  if( !caught )
+    {
+    std::cerr << "A registration with its own fixed image gradient filter was accepted." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
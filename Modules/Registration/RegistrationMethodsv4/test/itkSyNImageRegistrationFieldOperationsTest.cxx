@@ -0,0 +1,179 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkSyNImageRegistrationMethod.h"
+#include "itkComposeDisplacementFieldsImageFilter.h"
+#include "itkInvertDisplacementFieldImageFilter.h"
+#include "itkImageDuplicator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+/*
+ * Compare the in-place composition and inversion of the SyN method with
+ * ComposeDisplacementFieldsImageFilter and
+ * InvertDisplacementFieldImageFilter, which the method used before.
+ */
+
+namespace
+{
+const unsigned int ImageDimension = 2;
+
+typedef itk::Image<float, ImageDimension> ImageType;
+
+/** Expose the field operations of the SyN method. */
+class SyNFieldOperations
+  : public itk::SyNImageRegistrationMethod<ImageType, ImageType>
+{
+public:
+  typedef SyNFieldOperations                                      Self;
+  typedef itk::SyNImageRegistrationMethod<ImageType, ImageType>   Superclass;
+  typedef itk::SmartPointer<Self>                                 Pointer;
+
+  itkNewMacro( Self );
+
+  using Superclass::ComposeUpdateField;
+  using Superclass::InvertDisplacementField;
+
+protected:
+  SyNFieldOperations() {}
+};
+
+typedef SyNFieldOperations::DisplacementFieldType DisplacementFieldType;
+
+/** A smooth field with displacements of up to \c amplitude mm. */
+DisplacementFieldType::Pointer
+CreateField( double amplitude, double phase )
+{
+  DisplacementFieldType::SizeType size;
+  size[0] = 40;
+  size[1] = 32;
+  DisplacementFieldType::IndexType start;
+  start[0] = 2;
+  start[1] = -3;
+  DisplacementFieldType::SpacingType spacing;
+  spacing[0] = 1.5;
+  spacing[1] = 0.75;
+  DisplacementFieldType::PointType origin;
+  origin[0] = -10.0;
+  origin[1] = 4.0;
+
+  DisplacementFieldType::Pointer field = DisplacementFieldType::New();
+  field->SetRegions( DisplacementFieldType::RegionType( start, size ) );
+  field->SetSpacing( spacing );
+  field->SetOrigin( origin );
+  field->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<DisplacementFieldType> It( field, field->GetBufferedRegion() );
+  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+    {
+    const DisplacementFieldType::IndexType index = It.GetIndex();
+    const double u = ( index[0] - start[0] ) / static_cast<double>( size[0] - 1 );
+    const double v = ( index[1] - start[1] ) / static_cast<double>( size[1] - 1 );
+    // The window keeps the field away from the border.
+    const double window = vcl_sin( vnl_math::pi * u ) * vcl_sin( vnl_math::pi * v );
+    DisplacementFieldType::PixelType displacement;
+    displacement[0] = amplitude * window * vcl_sin( 2.0 * vnl_math::pi * v + phase );
+    displacement[1] = amplitude * window * vcl_cos( 2.0 * vnl_math::pi * u + phase );
+    It.Set( displacement );
+    }
+  return field;
+}
+
+DisplacementFieldType::Pointer
+Duplicate( const DisplacementFieldType * field )
+{
+  typedef itk::ImageDuplicator<DisplacementFieldType> DuplicatorType;
+  DuplicatorType::Pointer duplicator = DuplicatorType::New();
+  duplicator->SetInputImage( field );
+  duplicator->Update();
+  return duplicator->GetOutput();
+}
+
+double
+MaximumDifference( const DisplacementFieldType * field1, const DisplacementFieldType * field2 )
+{
+  double maximumDifference = 0.0;
+  itk::ImageRegionConstIteratorWithIndex<DisplacementFieldType> It( field1, field1->GetBufferedRegion() );
+  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+    {
+    const double difference = ( It.Get() - field2->GetPixel( It.GetIndex() ) ).GetNorm();
+    maximumDifference = vnl_math_max( maximumDifference, difference );
+    }
+  return maximumDifference;
+}
+}
+
+int itkSyNImageRegistrationFieldOperationsTest( int, char * [] )
+{
+  SyNFieldOperations::Pointer syn = SyNFieldOperations::New();
+
+  DisplacementFieldType::Pointer totalField = CreateField( 3.0, 0.0 );
+  DisplacementFieldType::Pointer updateField = CreateField( 1.0, 0.7 );
+
+  bool passed = true;
+
+  // Composition
+  typedef itk::ComposeDisplacementFieldsImageFilter<DisplacementFieldType> ComposerType;
+  ComposerType::Pointer composer = ComposerType::New();
+  composer->SetDisplacementField( updateField );
+  composer->SetWarpingField( totalField );
+  composer->Update();
+
+  DisplacementFieldType::Pointer composedField = Duplicate( totalField );
+  syn->ComposeUpdateField( updateField, composedField );
+
+  const double compositionDifference = MaximumDifference( composedField, composer->GetOutput() );
+  std::cout << "Maximum composition difference: " << compositionDifference << std::endl;
+  if( compositionDifference > 1.0e-4 )
+    {
+    std::cerr << "The composed field differs from ComposeDisplacementFieldsImageFilter." << std::endl;
+    passed = false;
+    }
+
+  // Inversion, from a zero and from a nonzero initial estimate
+  typedef itk::InvertDisplacementFieldImageFilter<DisplacementFieldType> InverterType;
+  DisplacementFieldType::Pointer estimate = CreateField( -2.5, 0.1 );
+  for( unsigned int useEstimate = 0; useEstimate < 2; useEstimate++ )
+    {
+    const DisplacementFieldType * initialEstimate = useEstimate ? estimate.GetPointer() : NULL;
+
+    InverterType::Pointer inverter = InverterType::New();
+    inverter->SetInput( totalField );
+    inverter->SetInverseFieldInitialEstimate( initialEstimate );
+    inverter->SetMaximumNumberOfIterations( 20 );
+    inverter->SetMeanErrorToleranceThreshold( 0.001 );
+    inverter->SetMaxErrorToleranceThreshold( 0.1 );
+    inverter->Update();
+
+    DisplacementFieldType::Pointer inverseField = syn->InvertDisplacementField( totalField, initialEstimate );
+
+    const double inversionDifference = MaximumDifference( inverseField, inverter->GetOutput() );
+    std::cout << "Maximum inversion difference" << ( useEstimate ? " with" : " without" )
+              << " initial estimate: " << inversionDifference << std::endl;
+    if( inversionDifference > 1.0e-3 )
+      {
+      std::cerr << "The inverse field differs from InvertDisplacementFieldImageFilter." << std::endl;
+      passed = false;
+      }
+    }
+
+  if( !passed )
+    {
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,265 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkSyNImageRegistrationMethod.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTimeVaryingVelocityFieldTransform.h"
+
+/*
+ * Register two synthetic blobs with the SyN method in double and in float
+ * precision and check that both produce the same displacement field.  The
+ * float transforms are also checked to share their float parameters with
+ * their fields.
+ */
+
+namespace
+{
+const unsigned int ImageDimension = 2;
+
+typedef itk::Image<float, ImageDimension> ImageType;
+
+ImageType::Pointer
+CreateBlobImage( double centerX, double centerY )
+{
+  ImageType::SizeType size;
+  size.Fill( 48 );
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> It( image, image->GetLargestPossibleRegion() );
+  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
+    {
+    const ImageType::IndexType index = It.GetIndex();
+    const double dx = ( index[0] - centerX ) / 8.0;
+    const double dy = ( index[1] - centerY ) / 6.0;
+    It.Set( static_cast<float>( 100.0 * vcl_exp( -0.5 * ( dx * dx + dy * dy ) ) ) );
+    }
+  return image;
+}
+
+template<class TRealType>
+typename itk::DisplacementFieldTransform<TRealType, ImageDimension>::DisplacementFieldType::Pointer
+PerformSyNRegistration( ImageType * fixedImage, ImageType * movingImage, double & metricValue )
+{
+  typedef itk::DisplacementFieldTransform<TRealType, ImageDimension>                   OutputTransformType;
+  typedef typename OutputTransformType::DisplacementFieldType                          DisplacementFieldType;
+  typedef itk::SyNImageRegistrationMethod<ImageType, ImageType, OutputTransformType>   RegistrationType;
+  typedef itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType, ImageType, TRealType> MetricType;
+
+  typename DisplacementFieldType::PixelType zeroVector( 0.0 );
+
+  typename DisplacementFieldType::Pointer displacementField = DisplacementFieldType::New();
+  displacementField->CopyInformation( fixedImage );
+  displacementField->SetRegions( fixedImage->GetBufferedRegion() );
+  displacementField->Allocate();
+  displacementField->FillBuffer( zeroVector );
+
+  typename DisplacementFieldType::Pointer inverseDisplacementField = DisplacementFieldType::New();
+  inverseDisplacementField->CopyInformation( fixedImage );
+  inverseDisplacementField->SetRegions( fixedImage->GetBufferedRegion() );
+  inverseDisplacementField->Allocate();
+  inverseDisplacementField->FillBuffer( zeroVector );
+
+  typename RegistrationType::Pointer registration = RegistrationType::New();
+
+  typename OutputTransformType::Pointer outputTransform = const_cast<OutputTransformType *>( registration->GetOutput()->Get() );
+  outputTransform->SetDisplacementField( displacementField );
+  outputTransform->SetInverseDisplacementField( inverseDisplacementField );
+
+  typename MetricType::Pointer metric = MetricType::New();
+
+  typename RegistrationType::NumberOfIterationsArrayType numberOfIterationsPerLevel;
+  numberOfIterationsPerLevel.SetSize( 1 );
+  numberOfIterationsPerLevel[0] = 20;
+
+  typename RegistrationType::ShrinkFactorsArrayType shrinkFactorsPerLevel;
+  shrinkFactorsPerLevel.SetSize( 1 );
+  shrinkFactorsPerLevel[0] = 1;
+
+  typename RegistrationType::SmoothingSigmasArrayType smoothingSigmasPerLevel;
+  smoothingSigmasPerLevel.SetSize( 1 );
+  smoothingSigmasPerLevel[0] = 0;
+
+  registration->SetFixedImage( fixedImage );
+  registration->SetMovingImage( movingImage );
+  registration->SetNumberOfLevels( 1 );
+  registration->SetShrinkFactorsPerLevel( shrinkFactorsPerLevel );
+  registration->SetSmoothingSigmasPerLevel( smoothingSigmasPerLevel );
+  registration->SetMetric( metric );
+  registration->SetLearningRate( 0.25 );
+  registration->SetNumberOfIterationsPerLevel( numberOfIterationsPerLevel );
+  registration->SetGaussianSmoothingVarianceForTheUpdateField( 3.0 );
+  registration->SetGaussianSmoothingVarianceForTheTotalField( 0.5 );
+  registration->StartRegistration();
+
+  metricValue = registration->GetCurrentMetricValue();
+
+  return outputTransform->GetDisplacementField();
+}
+}
+
+int itkSyNImageRegistrationFloatTest( int, char * [] )
+{
+  //
+  // Parameter interface of the float transforms
+  //
+  typedef itk::DisplacementFieldTransform<float, ImageDimension> FloatTransformType;
+  typedef FloatTransformType::DisplacementFieldType              FloatFieldType;
+
+  FloatFieldType::SizeType fieldSize;
+  fieldSize.Fill( 4 );
+  FloatFieldType::Pointer field = FloatFieldType::New();
+  field->SetRegions( fieldSize );
+  field->Allocate();
+  field->FillBuffer( FloatFieldType::PixelType( 0.0f ) );
+
+  FloatTransformType::Pointer floatTransform = FloatTransformType::New();
+  if( floatTransform->GetNumberOfParameters() != 0 )
+    {
+    std::cerr << "Expected no parameters without a displacement field." << std::endl;
+    return EXIT_FAILURE;
+    }
+  floatTransform->SetDisplacementField( field );
+
+  const unsigned int numberOfParameters = 16 * ImageDimension;
+  if( floatTransform->GetNumberOfParameters() != numberOfParameters )
+    {
+    std::cerr << "Expected " << numberOfParameters << " parameters, got "
+              << floatTransform->GetNumberOfParameters() << "." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  FloatTransformType::ParametersType parameters( numberOfParameters );
+  for( unsigned int k = 0; k < numberOfParameters; k++ )
+    {
+    parameters[k] = 0.5 * k;
+    }
+  floatTransform->SetParameters( parameters );
+
+  FloatTransformType::DerivativeType update( numberOfParameters );
+  update.Fill( 1.0 );
+  floatTransform->UpdateTransformParameters( update, 2.0 );
+
+  const FloatTransformType::ParametersType & floatParameters = floatTransform->GetParameters();
+  const float *fieldPointer = reinterpret_cast<const float *>( field->GetBufferPointer() );
+  if( floatParameters.data_block() != fieldPointer )
+    {
+    std::cerr << "The parameters do not share the memory of the displacement field." << std::endl;
+    return EXIT_FAILURE;
+    }
+  for( unsigned int k = 0; k < numberOfParameters; k++ )
+    {
+    if( fieldPointer[k] != static_cast<float>( 0.5 * k + 2.0 ) )
+      {
+      std::cerr << "Parameter " << k << " was not set in the displacement field." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  typedef itk::TimeVaryingVelocityFieldTransform<float, ImageDimension> FloatVelocityTransformType;
+  typedef FloatVelocityTransformType::TimeVaryingVelocityFieldType      FloatVelocityFieldType;
+
+  FloatVelocityFieldType::SizeType velocityFieldSize;
+  velocityFieldSize.Fill( 4 );
+  FloatVelocityFieldType::Pointer velocityField = FloatVelocityFieldType::New();
+  velocityField->SetRegions( velocityFieldSize );
+  velocityField->Allocate();
+  velocityField->FillBuffer( FloatVelocityFieldType::PixelType( 0.0f ) );
+
+  FloatVelocityTransformType::Pointer floatVelocityTransform = FloatVelocityTransformType::New();
+  floatVelocityTransform->SetTimeVaryingVelocityField( velocityField );
+  if( floatVelocityTransform->GetNumberOfParameters() != 64 * ImageDimension )
+    {
+    std::cerr << "Expected " << 64 * ImageDimension << " velocity field parameters, got "
+              << floatVelocityTransform->GetNumberOfParameters() << "." << std::endl;
+    return EXIT_FAILURE;
+    }
+  FloatVelocityTransformType::ParametersType velocityParameters( 64 * ImageDimension );
+  velocityParameters.Fill( 0.25 );
+  floatVelocityTransform->SetParameters( velocityParameters );
+  if( velocityField->GetPixel( velocityField->GetLargestPossibleRegion().GetIndex() )[0] != 0.25f )
+    {
+    std::cerr << "The parameters were not set in the velocity field." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  //
+  // SyN registration in double and in float
+  //
+  ImageType::Pointer fixedImage = CreateBlobImage( 24.0, 24.0 );
+  ImageType::Pointer movingImage = CreateBlobImage( 26.0, 23.0 );
+
+  double doubleMetricValue = 0.0;
+  double floatMetricValue = 0.0;
+
+  typedef itk::DisplacementFieldTransform<double, ImageDimension>::DisplacementFieldType DoubleFieldType;
+
+  DoubleFieldType::Pointer doubleField;
+  FloatFieldType::Pointer floatField;
+  try
+    {
+    doubleField = PerformSyNRegistration<double>( fixedImage, movingImage, doubleMetricValue );
+    floatField = PerformSyNRegistration<float>( fixedImage, movingImage, floatMetricValue );
+    }
+  catch( itk::ExceptionObject & e )
+    {
+    std::cerr << "Exception caught: " << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Metric value (double): " << doubleMetricValue << std::endl;
+  std::cout << "Metric value (float):  " << floatMetricValue << std::endl;
+
+  double maximumDisplacement = 0.0;
+  double maximumDifference = 0.0;
+  itk::ImageRegionConstIterator<DoubleFieldType> ItD( doubleField, doubleField->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator<FloatFieldType> ItF( floatField, floatField->GetLargestPossibleRegion() );
+  for( ItD.GoToBegin(), ItF.GoToBegin(); !ItD.IsAtEnd(); ++ItD, ++ItF )
+    {
+    for( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      maximumDisplacement = vnl_math_max( maximumDisplacement, vnl_math_abs( ItD.Get()[d] ) );
+      maximumDifference = vnl_math_max( maximumDifference,
+        vnl_math_abs( ItD.Get()[d] - static_cast<double>( ItF.Get()[d] ) ) );
+      }
+    }
+
+  std::cout << "Maximum displacement: " << maximumDisplacement << std::endl;
+  std::cout << "Maximum float/double difference: " << maximumDifference << std::endl;
+
+  if( maximumDisplacement < 0.5 )
+    {
+    std::cerr << "The registration did not recover the displacement." << std::endl;
+    return EXIT_FAILURE;
+    }
+  if( maximumDifference > 1.0e-3 * maximumDisplacement + 1.0e-4 )
+    {
+    std::cerr << "The float and double registrations differ." << std::endl;
+    return EXIT_FAILURE;
+    }
+  if( vnl_math_abs( floatMetricValue - doubleMetricValue ) > 1.0e-3 * vnl_math_abs( doubleMetricValue ) + 1.0e-4 )
+    {
+    std::cerr << "The float and double metric values differ." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -469,6 +469,9 @@ void MetaImage::Clear(void)
 
   m_ElementData = NULL;
 
+  m_CompressedElementData = NULL;
+  m_CompressedElementDataSize = 0;
+
   strcpy(m_ElementDataFileName, "");
 
   MetaObject::Clear();
@@ -977,6 +980,17 @@ ElementData(void * _elementData, bool _autoFreeElementData)
   m_AutoFreeElementData = _autoFreeElementData;
   }
 
+//
+//
+//
+void MetaImage::
+CompressedElementData(const void * _compressedData,
+                      METAIO_STL::streamoff _compressedDataSize)
+  {
+  m_CompressedElementData = _compressedData;
+  m_CompressedElementDataSize = _compressedData ? _compressedDataSize : 0;
+  }
+
 //
 //
 //
@@ -1628,7 +1642,12 @@ WriteStream(METAIO_STREAM::ofstream * _stream,
     MET_SizeOfType(m_ElementType, &elementSize);
     int elementNumberOfBytes = elementSize*m_ElementNumberOfChannels;
 
-    if(_constElementData == NULL)
+    if(m_CompressedElementData != NULL)
+      {
+      // compressed by the caller
+      m_CompressedDataSize = m_CompressedElementDataSize;
+      }
+    else if(_constElementData == NULL)
       {
       compressedElementData = MET_PerformCompression(
                                   (const unsigned char *)m_ElementData,
@@ -1653,9 +1672,18 @@ WriteStream(METAIO_STREAM::ofstream * _stream,
     if(m_BinaryData && m_CompressedData && !strstr(m_ElementDataFileName, "%"))
       // compressed & !slice/file
       {
-      M_WriteElements(m_WriteStream,
-                      compressedElementData,
-                      m_CompressedDataSize);
+      if(m_CompressedElementData != NULL)
+        {
+        M_WriteElements(m_WriteStream,
+                        m_CompressedElementData,
+                        m_CompressedDataSize);
+        }
+      else
+        {
+        M_WriteElements(m_WriteStream,
+                        compressedElementData,
+                        m_CompressedDataSize);
+        }
 
       delete [] compressedElementData;
       m_CompressedDataSize = 0;
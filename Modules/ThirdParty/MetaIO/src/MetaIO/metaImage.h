@@ -221,6 +221,14 @@ class METAIO_EXPORT MetaImage : public MetaObject
     bool   ElementData(METAIO_STL::streamoff _i, double _v);
     void   ElementData(void * _data, bool _autoFreeElementData=false);
 
+    //    CompressedElementData(...)
+    //       Compressed element data that the next Write() stores
+    //       instead of compressing the element data itself.  The data
+    //       must decode with inflate() and remain owned by the caller;
+    //       NULL restores the default compression.
+    void   CompressedElementData(const void * _compressedData,
+                                 METAIO_STL::streamoff _compressedDataSize);
+
     //    ConverTo(...)
     //       Converts to a new data type
     //       Rescales using Min and Max (see above)
@@ -326,6 +334,9 @@ class METAIO_EXPORT MetaImage : public MetaObject
 
     char               m_ElementDataFileName[255];
 
+    const void *       m_CompressedElementData;
+    METAIO_STL::streamoff m_CompressedElementDataSize;
+
 
     void  M_Destroy(void);
 